@@ -49,6 +49,28 @@
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpException.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Fixed-size element and row pointer buffers embedded in the vpArray2D
+  derived classes whose dimensions never change (vpHomogeneousMatrix,
+  vpRotationMatrix, vpTranslationVector...). See vpArray2D::attach().
+
+  Copying a buffer does nothing: the values are copied by vpArray2D and the
+  row pointers of an object must keep pointing to its own buffer.
+*/
+template<class Type, unsigned int R, unsigned int C>
+class vpArray2DStorage
+{
+public:
+  vpArray2DStorage() {}
+  vpArray2DStorage(const vpArray2DStorage &) {}
+  vpArray2DStorage &operator=(const vpArray2DStorage &) { return *this; }
+
+  Type data[R*C];
+  Type *rows[R];
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   \class vpArray2D
   \ingroup group_core_matrices
@@ -78,6 +100,8 @@ protected:
   Type **rowPtrs;
   //! Current array size (rowNum * colNum)
   unsigned int dsize;
+  //! True when data and rowPtrs point to a vpArray2DStorage buffer of the derived class
+  bool inlineStorage;
 
 public:
   //! Address of the first element of the data array
@@ -89,13 +113,13 @@ public:
   Number of columns and rows are set to zero.
   */
   vpArray2D<Type>()
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), inlineStorage(false), data(NULL)
   {}
   /*!
   Copy constructor of a 2D array.
   */
   vpArray2D<Type>(const vpArray2D<Type> & A)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), inlineStorage(false), data(NULL)
   {
     resize(A.rowNum, A.colNum);
     memcpy(data, A.data, rowNum*colNum*sizeof(Type));
@@ -107,7 +131,7 @@ public:
   \param c : Array number of columns.
   */
   vpArray2D<Type>(unsigned int r, unsigned int c)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), inlineStorage(false), data(NULL)
   {
     resize(r, c);
   }
@@ -119,7 +143,7 @@ public:
   \param val : Each element of the array is set to \e val.
   */
   vpArray2D<Type>(unsigned int r, unsigned int c, Type val)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), inlineStorage(false), data(NULL)
   {
     resize(r, c);
     *this = val;
@@ -129,6 +153,11 @@ public:
   */
   virtual ~vpArray2D<Type>()
   {
+    if (inlineStorage) {
+      data = NULL;
+      rowPtrs = NULL;
+    }
+
     if (data != NULL ) {
       free(data);
       data=NULL;
@@ -173,6 +202,19 @@ public:
       }
     }
     else {
+      // An inline buffer has a fixed size: move the values on the heap first
+      if (this->inlineStorage) {
+        Type *heapData = (Type*)malloc(this->dsize*sizeof(Type));
+        if ((NULL == heapData) && (0 != this->dsize)) {
+          throw(vpException(vpException::memoryAllocationError,
+            "Memory allocation error when allocating 2D array data")) ;
+        }
+        memcpy(heapData, this->data, this->dsize*sizeof(Type));
+        this->data = heapData;
+        this->rowPtrs = NULL;
+        this->inlineStorage = false;
+      }
+
       const bool recopyNeeded = (ncols != this ->colNum);
       Type * copyTmp = NULL;
       unsigned int rowTmp = 0, colTmp=0;
@@ -250,8 +292,10 @@ public:
   */
   vpArray2D<Type> & operator=(const vpArray2D<Type> & A)
   {
-    resize(A.rowNum, A.colNum);
-    memcpy(data, A.data, rowNum*colNum*sizeof(Type));
+    if ((A.rowNum != rowNum) || (A.colNum != colNum))
+      resize(A.rowNum, A.colNum);
+    if (this != &A)
+      memcpy(data, A.data, rowNum*colNum*sizeof(Type));
     return *this;
   }
 
@@ -639,6 +683,41 @@ public:
     return true;
   }
   //@}
+
+protected:
+  /*!
+    Make the array use the fixed-size buffer \e storage of a derived class
+    instead of heap memory. All the elements are set to zero.
+    The array must be empty, which is the case right after vpArray2D().
+    If the array is later resized to other dimensions, its values are moved
+    on the heap.
+  */
+  template<unsigned int R, unsigned int C>
+  void attach(vpArray2DStorage<Type, R, C> &storage)
+  {
+    rowNum = R;
+    colNum = C;
+    dsize = R*C;
+    data = storage.data;
+    rowPtrs = storage.rows;
+    inlineStorage = true;
+    for (unsigned int i=0; i<R; i++)
+      rowPtrs[i] = data + i*C;
+    memset(data, 0, dsize*sizeof(Type));
+  }
+
+  /*!
+    Make the array use the fixed-size buffer \e storage of a derived class,
+    and copy the array \e A. As with the vpArray2D copy constructor, the
+    array gets the dimensions of \e A: if \e A was resized to other
+    dimensions than R x C, the values are copied on the heap.
+  */
+  template<unsigned int R, unsigned int C>
+  void attach(vpArray2DStorage<Type, R, C> &storage, const vpArray2D<Type> &A)
+  {
+    attach(storage);
+    vpArray2D<Type>::operator=(A);
+  }
 };
 
 /*!
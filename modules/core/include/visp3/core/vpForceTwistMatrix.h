@@ -169,6 +169,10 @@ class VISP_EXPORT vpForceTwistMatrix : public vpArray2D<double>
   vp_deprecated void setIdentity();
   //@}
 #endif
+
+private:
+  //! Inline storage of the 6x6 elements
+  vpArray2DStorage<double, 6, 6> storage;
 } ;
 
 #endif
@@ -134,158 +134,10 @@ inline void GEMMsize<7>(const vpArray2D<double> & A,const vpArray2D<double> & B,
   Bcols= B.getRows();
 }
 
-template<unsigned int>
-inline void GEMM1(const unsigned int &/*Arows*/,const unsigned int &/*Brows*/, const unsigned int &/*Bcols*/, const vpArray2D<double> & /*A*/, const vpArray2D<double> & /*B*/, const double & /*alpha*/,vpArray2D<double> &/*D*/){}
-
-template<>
-inline void GEMM1<0>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[n][c]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<>
-inline void GEMM1<1>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[n][c]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<>
-inline void GEMM1<2>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[c][n]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<>
-inline void GEMM1<3>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[c][n]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<unsigned int>
-inline void GEMM2(const unsigned int &/*Arows*/,const unsigned int &/*Brows*/, const unsigned int &/*Bcols*/, const vpArray2D<double> & /*A*/,const vpArray2D<double> & /*B*/, const double & /*alpha*/, const vpArray2D<double> & /*C*/ , const double &/*beta*/, vpArray2D<double> &/*D*/)
-{}
-
-template<>
-inline void GEMM2<0>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[n][c]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
-
-template<>
-inline void GEMM2<1>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[n][c]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
-
-template<>
-inline void GEMM2<2>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[c][n]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
-
-template<>
-inline void GEMM2<3>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[c][n]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
-
-
-template<>
-inline void GEMM2<4>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[n][c]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
-}
-
-template<>
-inline void GEMM2<5>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[n][c]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
-
-}
-
-template<>
-inline void GEMM2<6>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[c][n]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
-}
-
-template<>
-inline void GEMM2<7>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[c][n]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
-}
+VISP_EXPORT void vpGEMMKernel(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                              const double *A, unsigned int lda, bool transA,
+                              const double *B, unsigned int ldb, bool transB,
+                              double beta, double *C, unsigned int ldc);
 
 template<unsigned int T>
 inline void vpTGEMM(const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha ,const vpArray2D<double> & C, const double & beta, vpArray2D<double> & D)
@@ -297,31 +149,48 @@ inline void vpTGEMM(const vpArray2D<double> & A, const vpArray2D<double> & B, co
   
   GEMMsize<T>(A,B,Arows,Acols,Brows,Bcols);
   
-  try  {
-    if ((Arows != D.getRows()) || (Bcols != D.getCols())) D.resize(Arows,Bcols);
-  }
-  catch(...) {
-    throw ;
-  }
-  
   if (Acols != Brows) {
     throw(vpException(vpException::dimensionError,
                       "In vpGEMM, cannot multiply (%dx%d) matrix by (%dx%d) matrix",
                       Arows, Acols, Brows, Bcols)) ;
   }
   
-  if(C.getRows()!=0 && C.getCols()!=0){
-    if ((Arows != C.getRows()) || (Bcols != C.getCols())) {
+  const bool useC = (C.getRows()!=0 && C.getCols()!=0);
+  if (useC) {
+    unsigned int Crows = (T & VP_GEMM_C_T) ? C.getCols() : C.getRows();
+    unsigned int Ccols = (T & VP_GEMM_C_T) ? C.getRows() : C.getCols();
+    if ((Arows != Crows) || (Bcols != Ccols)) {
       throw(vpException(vpException::dimensionError,
                         "In vpGEMM, cannot add resulting (%dx%d) matrix to (%dx%d) matrix",
                         Arows, Bcols, C.getRows(), C.getCols())) ;
     }
-    
-    GEMM2<T>(Arows,Brows,Bcols,A,B,alpha,C,beta,D);
-  }else{
-    GEMM1<T>(Arows,Brows,Bcols,A,B,alpha,D);
   }
-  
+
+  // The kernel writes in place: use a temporary when D shares its memory with an operand
+  vpArray2D<double> tmp;
+  const bool aliased = (&D == &A || &D == &B || (useC && &D == &C));
+  vpArray2D<double> &R = aliased ? tmp : D;
+
+  try  {
+    if ((Arows != R.getRows()) || (Bcols != R.getCols())) R.resize(Arows,Bcols);
+  }
+  catch(...) {
+    throw ;
+  }
+
+  if (useC) {
+    for(unsigned int r=0;r<Arows;r++)
+      for(unsigned int c=0;c<Bcols;c++)
+        R[r][c] = (T & VP_GEMM_C_T) ? C[c][r] : C[r][c];
+  }
+
+  vpGEMMKernel(Arows, Bcols, Acols, alpha,
+               A.data, A.getCols(), (T & VP_GEMM_A_T) != 0,
+               B.data, B.getCols(), (T & VP_GEMM_B_T) != 0,
+               useC ? beta : 0., R.data, Bcols);
+
+  if (aliased)
+    D = R;
 }
 
 /*!
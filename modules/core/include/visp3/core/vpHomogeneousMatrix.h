@@ -194,6 +194,10 @@ class VISP_EXPORT vpHomogeneousMatrix : public vpArray2D<double>
   //@}
 #endif
 
+
+private:
+  //! Inline storage of the 4x4 elements
+  vpArray2DStorage<double, 4, 4> storage;
 } ;
 
 #endif
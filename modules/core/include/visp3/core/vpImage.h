@@ -50,9 +50,7 @@
 #include <visp3/core/vpImageException.h>
 #include <visp3/core/vpImagePoint.h>
 #include <visp3/core/vpRGBa.h>
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-#  include <visp3/core/vpThread.h>
-#endif
+#include <visp3/core/vpThreadPool.h>
 
 #include <fstream>
 #include <iostream>
@@ -321,147 +319,110 @@ private:
 };
 
 
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
 namespace {
-  struct ImageLut_Param_t {
-    unsigned int m_start_index;
-    unsigned int m_end_index;
-
-    unsigned char m_lut[256];
-    unsigned char *m_bitmap;
-
-    ImageLut_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_bitmap(NULL) {
-    }
-
-    ImageLut_Param_t(const unsigned int start_index, const unsigned int end_index,
-        unsigned char *bitmap) :
-      m_start_index(start_index), m_end_index(end_index), m_lut(), m_bitmap(bitmap) {
+  class vpImageLutTask : public vpThreadPool::vpRangeTask {
+  public:
+    vpImageLutTask(const unsigned char *lut, unsigned char *bitmap) : m_lut(lut), m_bitmap(bitmap) {
     }
-  };
-
-  vpThread::Return performLutThread(vpThread::Args args) {
-    ImageLut_Param_t *imageLut_param = ( (ImageLut_Param_t *) args );
-    unsigned int start_index = imageLut_param->m_start_index;
-    unsigned int end_index = imageLut_param->m_end_index;
-
-    unsigned char *bitmap = imageLut_param->m_bitmap;
-
-    unsigned char *ptrStart = bitmap + start_index;
-    unsigned char *ptrEnd = bitmap + end_index;
-    unsigned char *ptrCurrent = ptrStart;
 
+    void run(unsigned int start_index, unsigned int end_index) {
+      unsigned char *ptrEnd = m_bitmap + end_index;
+      unsigned char *ptrCurrent = m_bitmap + start_index;
 
-//    while(ptrCurrent != ptrEnd) {
-//      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-//      ++ptrCurrent;
-//    }
+      if(end_index - start_index >= 8) {
+        //Unroll loop version
+        for(; ptrCurrent <= ptrEnd - 8;) {
+          *ptrCurrent = m_lut[*ptrCurrent];
+          ++ptrCurrent;
 
-    if(end_index - start_index >= 8) {
-      //Unroll loop version
-      for(; ptrCurrent <= ptrEnd - 8;) {
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
+          *ptrCurrent = m_lut[*ptrCurrent];
+          ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
+          *ptrCurrent = m_lut[*ptrCurrent];
+          ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
+          *ptrCurrent = m_lut[*ptrCurrent];
+          ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
+          *ptrCurrent = m_lut[*ptrCurrent];
+          ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
+          *ptrCurrent = m_lut[*ptrCurrent];
+          ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
+          *ptrCurrent = m_lut[*ptrCurrent];
+          ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
-
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
+          *ptrCurrent = m_lut[*ptrCurrent];
+          ++ptrCurrent;
+        }
       }
-    }
 
-    for(; ptrCurrent != ptrEnd; ++ptrCurrent) {
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+      for(; ptrCurrent != ptrEnd; ++ptrCurrent) {
+        *ptrCurrent = m_lut[*ptrCurrent];
+      }
     }
 
-    return 0;
-  }
-
-
-  struct ImageLutRGBa_Param_t {
-    unsigned int m_start_index;
-    unsigned int m_end_index;
-
-    vpRGBa m_lut[256];
+  private:
+    const unsigned char *m_lut;
     unsigned char *m_bitmap;
-
-    ImageLutRGBa_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_bitmap(NULL) {
-    }
-
-    ImageLutRGBa_Param_t(const unsigned int start_index, const unsigned int end_index,
-        unsigned char *bitmap) :
-      m_start_index(start_index), m_end_index(end_index), m_lut(), m_bitmap(bitmap) {
-    }
   };
 
-  vpThread::Return performLutRGBaThread(vpThread::Args args) {
-    ImageLutRGBa_Param_t *imageLut_param = ( (ImageLutRGBa_Param_t *) args );
-    unsigned int start_index = imageLut_param->m_start_index;
-    unsigned int end_index = imageLut_param->m_end_index;
-
-    unsigned char *bitmap = imageLut_param->m_bitmap;
 
-    unsigned char *ptrStart = bitmap + start_index*4;
-    unsigned char *ptrEnd = bitmap + end_index*4;
-    unsigned char *ptrCurrent = ptrStart;
+  class vpImageLutRGBaTask : public vpThreadPool::vpRangeTask {
+  public:
+    vpImageLutRGBaTask(const vpRGBa *lut, unsigned char *bitmap) : m_lut(lut), m_bitmap(bitmap) {
+    }
 
+    void run(unsigned int start_index, unsigned int end_index) {
+      unsigned char *ptrEnd = m_bitmap + end_index*4;
+      unsigned char *ptrCurrent = m_bitmap + start_index*4;
+
+      if(end_index - start_index >= 4*2) {
+        //Unroll loop version
+        for(; ptrCurrent <= ptrEnd - 4*2;) {
+          *ptrCurrent = m_lut[*ptrCurrent].R;
+          ptrCurrent++;
+          *ptrCurrent = m_lut[*ptrCurrent].G;
+          ptrCurrent++;
+          *ptrCurrent = m_lut[*ptrCurrent].B;
+          ptrCurrent++;
+          *ptrCurrent = m_lut[*ptrCurrent].A;
+          ptrCurrent++;
+
+          *ptrCurrent = m_lut[*ptrCurrent].R;
+          ptrCurrent++;
+          *ptrCurrent = m_lut[*ptrCurrent].G;
+          ptrCurrent++;
+          *ptrCurrent = m_lut[*ptrCurrent].B;
+          ptrCurrent++;
+          *ptrCurrent = m_lut[*ptrCurrent].A;
+          ptrCurrent++;
+        }
+      }
 
-    if(end_index - start_index >= 4*2) {
-      //Unroll loop version
-      for(; ptrCurrent <= ptrEnd - 4*2;) {
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
+      while(ptrCurrent != ptrEnd) {
+        *ptrCurrent = m_lut[*ptrCurrent].R;
         ptrCurrent++;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
+        *ptrCurrent = m_lut[*ptrCurrent].G;
         ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
+
+        *ptrCurrent = m_lut[*ptrCurrent].B;
         ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
+
+        *ptrCurrent = m_lut[*ptrCurrent].A;
         ptrCurrent++;
       }
     }
 
-    while(ptrCurrent != ptrEnd) {
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
-      ptrCurrent++;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
-      ptrCurrent++;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
-      ptrCurrent++;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
-      ptrCurrent++;
-    }
-
-    return 0;
-  }
+  private:
+    const vpRGBa *m_lut;
+    unsigned char *m_bitmap;
+  };
 }
-#endif
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 
 /*!
@@ -1672,7 +1633,9 @@ void vpImage<Type>::performLut(const Type (&)[256], const unsigned int)
   Modify the intensities of a grayscale image using the look-up table passed in parameter.
 
   \param lut : Look-up table (unsigned char array of size=256) which maps each intensity to his new value.
-  \param nbThreads : Number of threads to use for the computation.
+  \param nbThreads : Number of sub-ranges the image is split in. When greater
+  than 1, the sub-ranges are processed by the threads of vpThreadPool, whose
+  number is set by vpThreadPool::setNumThreads().
 */
 template<>
 inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256], const unsigned int nbThreads) {
@@ -1700,52 +1663,10 @@ inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256],
       ++ptrCurrent;
     }
   } else {
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-    //Multi-threads
-
-    std::vector<vpThread *> threadpool;
-    std::vector<ImageLut_Param_t *> imageLutParams;
-
-    ImageLut_Param_t *imageLut_param = NULL;
-    vpThread *imageLut_thread = NULL;
-
+    //Multi-threads, using the threads of vpThreadPool
     unsigned int image_size = getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads-1);
-
-    for(unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index*step;
-      unsigned int end_index = (index+1)*step;
-
-      if(index == nbThreads-1) {
-        end_index = start_index+last_step;
-      }
-
-      imageLut_param = new ImageLut_Param_t(start_index, end_index, bitmap);
-      memcpy(imageLut_param->m_lut, lut, 256*sizeof(unsigned char));
-
-      imageLutParams.push_back(imageLut_param);
-
-      // Start the threads
-      imageLut_thread = new vpThread((vpThread::Fn) performLutThread, (vpThread::Args) imageLut_param);
-      threadpool.push_back(imageLut_thread);
-    }
-
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
-
-
-    //Delete
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for(size_t cpt = 0; cpt < imageLutParams.size(); cpt++) {
-      delete imageLutParams[cpt];
-    }
-#endif
+    vpImageLutTask task(lut, bitmap);
+    vpThreadPool::parallel_for(0, image_size, task, (image_size + nbThreads - 1) / nbThreads);
   }
 }
 
@@ -1753,7 +1674,9 @@ inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256],
   Modify the intensities of a color image using the look-up table passed in parameter.
 
   \param lut : Look-up table (vpRGBa array of size=256) which maps each intensity to his new value.
-  \param nbThreads : Number of threads to use for the computation.
+  \param nbThreads : Number of sub-ranges the image is split in. When greater
+  than 1, the sub-ranges are processed by the threads of vpThreadPool, whose
+  number is set by vpThreadPool::setNumThreads().
 */
 template<>
 inline void vpImage<vpRGBa>::performLut(const vpRGBa (&lut)[256], const unsigned int nbThreads) {
@@ -1789,51 +1712,10 @@ inline void vpImage<vpRGBa>::performLut(const vpRGBa (&lut)[256], const unsigned
       ++ptrCurrent;
     }
   } else {
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-    //Multi-threads
-    std::vector<vpThread *> threadpool;
-    std::vector<ImageLutRGBa_Param_t *> imageLutParams;
-
-    ImageLutRGBa_Param_t *imageLut_param = NULL;
-    vpThread *imageLut_thread = NULL;
-
+    //Multi-threads, using the threads of vpThreadPool
     unsigned int image_size = getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads-1);
-
-    for(unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index*step;
-      unsigned int end_index = (index+1)*step;
-
-      if(index == nbThreads-1) {
-        end_index = start_index+last_step;
-      }
-
-      imageLut_param = new ImageLutRGBa_Param_t(start_index, end_index, (unsigned char *) bitmap);
-      memcpy(imageLut_param->m_lut, lut, 256*sizeof(vpRGBa));
-
-      imageLutParams.push_back(imageLut_param);
-
-      // Start the threads
-      imageLut_thread = new vpThread((vpThread::Fn) performLutRGBaThread, (vpThread::Args) imageLut_param);
-      threadpool.push_back(imageLut_thread);
-    }
-
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
-
-
-    //Delete
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for(size_t cpt = 0; cpt < imageLutParams.size(); cpt++) {
-      delete imageLutParams[cpt];
-    }
-#endif
+    vpImageLutRGBaTask task(lut, (unsigned char *) bitmap);
+    vpThreadPool::parallel_for(0, image_size, task, (image_size + nbThreads - 1) / nbThreads);
   }
 }
 
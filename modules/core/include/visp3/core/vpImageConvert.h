@@ -196,27 +196,27 @@ public:
       b = (unsigned char) db;
     }
   static void YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
-      unsigned int width, unsigned int height);
+      unsigned int width, unsigned int height, unsigned int nbThreads=1);
   static void YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
-      unsigned int width, unsigned int height);
+      unsigned int width, unsigned int height, unsigned int nbThreads=1);
   static void YUYVToGrey(unsigned char* yuyv, unsigned char* grey,
       unsigned int size);
   static void YUV411ToRGBa(unsigned char* yuv,
-        unsigned char* rgba, unsigned int size);
+        unsigned char* rgba, unsigned int size, unsigned int nbThreads=1);
   static void YUV411ToRGB(unsigned char* yuv,
-        unsigned char* rgb, unsigned int size);
+        unsigned char* rgb, unsigned int size, unsigned int nbThreads=1);
   static void YUV411ToGrey(unsigned char* yuv,
         unsigned char* grey, unsigned int size);
   static void YUV422ToRGBa(unsigned char* yuv,
-        unsigned char* rgba, unsigned int size);
+        unsigned char* rgba, unsigned int size, unsigned int nbThreads=1);
   static void YUV422ToRGB(unsigned char* yuv,
-        unsigned char* rgb, unsigned int size);
+        unsigned char* rgb, unsigned int size, unsigned int nbThreads=1);
   static void YUV422ToGrey(unsigned char* yuv,
         unsigned char* grey, unsigned int size);
   static void YUV420ToRGBa(unsigned char* yuv,
-        unsigned char* rgba, unsigned int width, unsigned int height);
+        unsigned char* rgba, unsigned int width, unsigned int height, unsigned int nbThreads=1);
   static void YUV420ToRGB(unsigned char* yuv,
-        unsigned char* rgb, unsigned int width, unsigned int height);
+        unsigned char* rgb, unsigned int width, unsigned int height, unsigned int nbThreads=1);
   static void YUV420ToGrey(unsigned char* yuv,
         unsigned char* grey, unsigned int size);
 
@@ -228,9 +228,9 @@ public:
         unsigned char* grey, unsigned int size);
 
   static void YV12ToRGBa(unsigned char* yuv,
-        unsigned char* rgba, unsigned int width, unsigned int height);
+        unsigned char* rgba, unsigned int width, unsigned int height, unsigned int nbThreads=1);
   static void YV12ToRGB(unsigned char* yuv,
-        unsigned char* rgb, unsigned int width, unsigned int height);
+        unsigned char* rgb, unsigned int width, unsigned int height, unsigned int nbThreads=1);
   static void YVU9ToRGBa(unsigned char* yuv,
         unsigned char* rgba, unsigned int width, unsigned int height);
   static void YVU9ToRGB(unsigned char* yuv,
@@ -260,13 +260,13 @@ public:
       unsigned int width, unsigned int height, bool flip=false);
 
   static void YCbCrToRGB(unsigned char *ycbcr, unsigned char *rgb,
-      unsigned int size);
+      unsigned int size, unsigned int nbThreads=1);
   static void YCbCrToRGBa (unsigned char *ycbcr, unsigned char *rgb,
-        unsigned int size);
+        unsigned int size, unsigned int nbThreads=1);
   static void YCrCbToRGB(unsigned char *ycbcr, unsigned char *rgb,
-      unsigned int size);
+      unsigned int size, unsigned int nbThreads=1);
   static void YCrCbToRGBa(unsigned char *ycbcr, unsigned char *rgb,
-        unsigned int size);
+        unsigned int size, unsigned int nbThreads=1);
   static void YCbCrToGrey(unsigned char *ycbcr, unsigned char *grey,
       unsigned int size);
   static void MONO16ToGrey(unsigned char *grey16, unsigned char *grey,
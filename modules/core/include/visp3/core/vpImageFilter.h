@@ -54,6 +54,7 @@
 #include <fstream>
 #include <iostream>
 #include <math.h>
+#include <stdint.h>
 #include <string.h>
 
 /*!
@@ -68,13 +69,17 @@ class VISP_EXPORT vpImageFilter
 {
 
 public:
-#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
   static void canny(const vpImage<unsigned char>& I,
                     vpImage<unsigned char>& Ic,
                     const unsigned int gaussianFilterSize,
                     const double thresholdCanny,
                     const unsigned int apertureSobel);
-#endif
+  static void canny(const vpImage<unsigned char>& I,
+                    vpImage<unsigned char>& Ic,
+                    const unsigned int gaussianFilterSize,
+                    const double lowerThreshold,
+                    const double upperThreshold,
+                    const unsigned int apertureSobel);
 
   /*!
    Apply a 1x3 derivative filter to an image pixel.
@@ -394,6 +399,7 @@ public:
 
   static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
   static void gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
+  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<unsigned char>& GI, unsigned int size=7, double sigma=0.);
   /*!
    Apply a 5x5 Gaussian filter to an image pixel.
 
@@ -439,6 +445,10 @@ public:
   static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *gaussianKernel,
                               const double *gaussianDerivativeKernel,unsigned  int size);
 
+  static void sobel(const vpImage<unsigned char> &I, vpImage<int16_t> &dIx, vpImage<int16_t> &dIy,
+                    const unsigned int apertureSize=3);
+  static void sobel(const vpImage<unsigned char> &I, vpImage<float> &dIx, vpImage<float> &dIy,
+                    const unsigned int apertureSize=3);
 } ;
 
 
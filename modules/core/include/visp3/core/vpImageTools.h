@@ -48,10 +48,8 @@
 */
 
 #include <visp3/core/vpImage.h>
-
-#ifdef VISP_HAVE_PTHREAD
-#  include <pthread.h>
-#endif
+#include <visp3/core/vpRGBa.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <visp3/core/vpImageException.h>
 #include <visp3/core/vpMath.h>
@@ -62,6 +60,62 @@
 #include <iostream>
 #include <math.h>
 #include <string.h>
+#include <vector>
+
+/*!
+  \class vpUndistortMap
+
+  \ingroup group_core_image
+
+  \brief Undistortion map of an image, computed once from the camera
+  parameters and applied to each new image with vpImageTools::remap().
+
+  For each pixel of the undistorted image, the map stores the position of the
+  top-left neighbour of its source point in the distorted image, and the four
+  bilinear interpolation weights of the neighbours as 14 bits fixed-point
+  values (the sub-pixel position is rounded to 1/128 pixel). The pixels whose
+  source point is outside the image have null weights and are set to 0.
+
+  \code
+#include <visp3/core/vpImageTools.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640), Iundist;
+  vpCameraParameters cam;
+  cam.initPersProjWithDistortion(600, 600, 320, 240, -0.1, 0.1);
+
+  vpUndistortMap map(cam, I.getWidth(), I.getHeight());
+  for (unsigned int i = 0; i < 100; i++) {
+    // acquire I
+    vpImageTools::remap(I, map, Iundist);
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpUndistortMap
+{
+  friend class vpImageTools;
+
+public:
+  vpUndistortMap();
+  vpUndistortMap(const vpCameraParameters &cam, unsigned int width, unsigned int height);
+
+  //! Return the height of the images the map applies to.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Return the width of the images the map applies to.
+  inline unsigned int getWidth() const { return m_width; }
+
+  void init(const vpCameraParameters &cam, unsigned int width, unsigned int height);
+
+private:
+  unsigned int m_width;
+  unsigned int m_height;
+  //! Index of the top-left neighbour of the source point of each pixel.
+  std::vector<int> m_offsets;
+  //! Weights of the top-left, top-right, bottom-left and bottom-right neighbours of each pixel.
+  std::vector<short> m_weights;
+};
 
 /*!
   \class vpImageTools
@@ -103,6 +157,11 @@ public:
                         const vpCameraParameters &cam,
                         vpImage<Type> &newI);
 
+  static void remap(const vpImage<unsigned char> &I, const vpUndistortMap &map,
+                    vpImage<unsigned char> &Iundist);
+  static void remap(const vpImage<vpRGBa> &I, const vpUndistortMap &map,
+                    vpImage<vpRGBa> &Iundist);
+
   template<class Type>
   static void flip(const vpImage<Type> &I,
                    vpImage<Type> &newI);
@@ -130,6 +189,17 @@ public:
                             const bool saturate=false);
 } ;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template<>
+VISP_EXPORT void vpImageTools::undistort(const vpImage<unsigned char> &I,
+                                         const vpCameraParameters &cam,
+                                         vpImage<unsigned char> &undistI);
+template<>
+VISP_EXPORT void vpImageTools::undistort(const vpImage<vpRGBa> &I,
+                                         const vpCameraParameters &cam,
+                                         vpImage<vpRGBa> &undistI);
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Extract a sub part of an image
 
@@ -288,56 +358,37 @@ inline void vpImageTools::binarise(vpImage<unsigned char> &I,
   }
 }
 
-#ifdef VISP_HAVE_PTHREAD
-
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 template<class Type>
-class vpUndistortInternalType
+class vpUndistortInternalType : public vpThreadPool::vpRangeTask
 {
 public:
-  Type *src;
+  const Type *src;
   Type *dst;
   unsigned int width;
   unsigned int height;
   vpCameraParameters cam;
-  unsigned int nthreads;
-  unsigned int threadid;
 public:
-  vpUndistortInternalType()
-    : src(NULL), dst(NULL), width(0), height(0), cam(), nthreads(0), threadid(0)
+  vpUndistortInternalType(const Type *src_, Type *dst_, unsigned int width_, unsigned int height_,
+                          const vpCameraParameters &cam_)
+    : src(src_), dst(dst_), width(width_), height(height_), cam(cam_)
   {};
 
-  vpUndistortInternalType(const vpUndistortInternalType<Type> &u) {
-    *this = u;
-  };
-  vpUndistortInternalType &operator=(const vpUndistortInternalType<Type> &u) {
-    src = u.src;
-    dst = u.dst;
-    width = u.width;
-    height = u.height;
-    cam = u.cam;
-    nthreads = u.nthreads;
-    threadid = u.threadid;
-  }
-
-  static void *vpUndistort_threaded(void *arg);
+  void run(unsigned int start, unsigned int end);
 };
 
 
 template<class Type>
-void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
+void vpUndistortInternalType<Type>::run(unsigned int start, unsigned int end)
 {
-  vpUndistortInternalType<Type> *undistortSharedData = (vpUndistortInternalType<Type>*)arg;
-  int offset   = (int)undistortSharedData->threadid;
-  int width    = (int)undistortSharedData->width;
-  int height   = (int)undistortSharedData->height;
-  int nthreads = (int)undistortSharedData->nthreads;
-
-  double u0 = undistortSharedData->cam.get_u0();
-  double v0 = undistortSharedData->cam.get_v0();
-  double px = undistortSharedData->cam.get_px();
-  double py = undistortSharedData->cam.get_py();
-  double kud = undistortSharedData->cam.get_kud();
+  int width_   = (int)width;
+  int height_  = (int)height;
+
+  double u0 = cam.get_u0();
+  double v0 = cam.get_v0();
+  double px = cam.get_px();
+  double py = cam.get_py();
+  double kud = cam.get_kud();
 
   double invpx = 1.0/px;
   double invpy = 1.0/py;
@@ -345,15 +396,14 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
   double kud_px2 = kud * invpx * invpx;
   double kud_py2 = kud * invpy * invpy;
 
-  Type *dst = undistortSharedData->dst+(height/nthreads*offset)*width;
-  Type *src = undistortSharedData->src;
+  Type *dst_ = dst + start*width;
 
-  for (double v = height/nthreads*offset;v < height/nthreads*(offset+1) ; v++) {
+  for (double v = start; v < end ; v++) {
     double  deltav  = v - v0;
     //double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
     double fr1 = 1.0 + kud_py2 * deltav * deltav;
 
-    for (double u = 0 ; u < width ; u++) {
+    for (double u = 0 ; u < width_ ; u++) {
       //computation of u,v : corresponding pixel coordinates in I.
       double  deltau  = u - u0;
       //double fr2 = fr1 + kd * (vpMath::sqr(deltau * invpx));
@@ -374,26 +424,22 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
       Type v01;
       Type v23;
       if ( (0 <= u_round) && (0 <= v_round) &&
-           (u_round < ((width) - 1)) && (v_round < ((height) - 1)) ) {
+           (u_round < ((width_) - 1)) && (v_round < ((height_) - 1)) ) {
         //process interpolation
-        const Type* _mp = &src[v_round*width+u_round];
+        const Type* _mp = &src[v_round*width_+u_round];
         v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        _mp += width;
+        _mp += width_;
         v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        *dst = (Type)(v01 + ((v23 - v01) * dv_double));
+        *dst_ = (Type)(v01 + ((v23 - v01) * dv_double));
       }
       else {
-        *dst = 0;
+        *dst_ = 0;
       }
-      dst++;
+      dst_++;
     }
   }
-
-  pthread_exit((void*) 0);
-  return NULL;
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
-#endif // VISP_HAVE_PTHREAD
 
 /*!
   Undistort an image
@@ -413,15 +459,24 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
   \warning This function is time consuming :
     - On "Rhea"(Intel Core 2 Extreme X6800 2.93GHz, 2Go RAM)
       or "Charon"(Intel Xeon 3 GHz, 2Go RAM) : ~8 ms for a 640x480 image.
+
+  The rows of the image are processed by the threads of vpThreadPool; use
+  vpThreadPool::setNumThreads() to change their number.
+
+  For vpImage<unsigned char> and vpImage<vpRGBa>, this function applies a
+  vpUndistortMap with remap(). The map of the last call is kept and only
+  rebuilt when the camera parameters or the size of the image change. The
+  calls from several threads share this map and are serialized; build a
+  vpUndistortMap for each thread and call remap() to undistort images
+  concurrently.
 */
 template<class Type>
 void vpImageTools::undistort(const vpImage<Type> &I,
                              const vpCameraParameters &cam,
                              vpImage<Type> &undistI)
 {
-#ifdef VISP_HAVE_PTHREAD
   //
-  // Optimized version using pthreads
+  // Optimized version, the rows are shared among the threads of vpThreadPool
   //
   unsigned int width = I.getWidth();
   unsigned int height = I.getHeight();
@@ -437,112 +492,8 @@ void vpImageTools::undistort(const vpImage<Type> &I,
     return;
   }
 
-  unsigned int nthreads = 2;
-  pthread_attr_t attr;
-  pthread_t *callThd = new pthread_t [nthreads];
-  pthread_attr_init(&attr);
-  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-  vpUndistortInternalType<Type> *undistortSharedData;
-  undistortSharedData = new vpUndistortInternalType<Type> [nthreads];
-
-  for(unsigned int i=0;i<nthreads;i++) {
-    // Each thread works on a different set of data.
-    //    vpTRACE("create thread %d", i);
-    undistortSharedData[i].src      = I.bitmap;
-    undistortSharedData[i].dst      = undistI.bitmap;
-    undistortSharedData[i].width    = I.getWidth();
-    undistortSharedData[i].height   = I.getHeight();
-    undistortSharedData[i].cam      = cam;
-    undistortSharedData[i].nthreads = nthreads;
-    undistortSharedData[i].threadid = i;
-    pthread_create( &callThd[i], &attr,
-                    &vpUndistortInternalType<Type>::vpUndistort_threaded,
-                    &undistortSharedData[i]);
-  }
-  pthread_attr_destroy(&attr);
-  /* Wait on the other threads */
-
-  for(unsigned int i=0;i<nthreads;i++) {
-    //  vpTRACE("join thread %d", i);
-    pthread_join( callThd[i], NULL);
-  }
-
-  delete [] callThd;
-  delete [] undistortSharedData;
-#else // VISP_HAVE_PTHREAD
-  //
-  // optimized version without pthreads
-  //
-  unsigned int width = I.getWidth();
-  unsigned int height = I.getHeight();
-
-  undistI.resize(height, width);
-
-  double u0 = cam.get_u0();
-  double v0 = cam.get_v0();
-  double px = cam.get_px();
-  double py = cam.get_py();
-  double kud = cam.get_kud();
-
-  //if (kud == 0) {
-  if (std::fabs(kud) <= std::numeric_limits<double>::epsilon()) {
-    // There is no need to undistort the image
-    undistI = I;
-    return;
-  }
-
-  double invpx = 1.0/px;
-  double invpy = 1.0/py;
-
-  double kud_px2 = kud * invpx * invpx;
-  double kud_py2 = kud * invpy * invpy;
-
-  Type *dst = undistI.bitmap;
-  for (double v = 0;v < height ; v++) {
-    double  deltav  = v - v0;
-    //double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
-    double fr1 = 1.0 + kud_py2 * deltav * deltav;
-
-    for (double u = 0 ; u < width ; u++) {
-      //computation of u,v : corresponding pixel coordinates in I.
-      double  deltau  = u - u0;
-      //double fr2 = fr1 + kd * (vpMath::sqr(deltau * invpx));
-      double fr2 = fr1 + kud_px2 * deltau * deltau;
-
-      double u_double = deltau * fr2 + u0;
-      double v_double = deltav * fr2 + v0;
-
-      //printf("[%g][%g] %g %g : ", u, v, u_double, v_double );
-
-      //computation of the bilinear interpolation
-
-      //declarations
-      int u_round  = (int) (u_double);
-      int v_round  = (int) (v_double);
-      if (u_round < 0.f) u_round = -1;
-      if (v_round < 0.f) v_round = -1;
-      double  du_double  = (u_double) - (double) u_round;
-      double  dv_double  = (v_double) - (double) v_round;
-      Type  v01;
-      Type  v23;
-      if ( (0 <= u_round) && (0 <= v_round) &&
-           (u_round < (((int)width) - 1)) && (v_round < (((int)height) - 1)) ) {
-        //process interpolation
-        const Type* _mp = &I[(unsigned int)v_round][(unsigned int)u_round];
-        v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        _mp += width;
-        v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        *dst = (Type)(v01 + ((v23 - v01) * dv_double));
-        //printf("R %d G %d B %d\n", dst->R, dst->G, dst->B);
-      }
-      else {
-        *dst = 0;
-      }
-      dst++;
-    }
-  }
-#endif // VISP_HAVE_PTHREAD
+  vpUndistortInternalType<Type> task(I.bitmap, undistI.bitmap, width, height, cam);
+  vpThreadPool::parallel_for(0, height, task);
 
 
 
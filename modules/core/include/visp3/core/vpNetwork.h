@@ -40,6 +40,8 @@
 
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpRequest.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMatrix.h>
 
 #include <vector>
 #include <stdio.h>
@@ -49,6 +51,7 @@
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
 #  include <unistd.h> 
 #  include <sys/socket.h>
+#  include <sys/uio.h>
 #  include <netinet/in.h>
 #  include <arpa/inet.h>
 #  include <netdb.h>
@@ -76,6 +79,29 @@
   \warning This class shouldn't be used directly. You better use vpClient and
   vpServer to simulate your network. Some exemples are provided in these classes.
 
+  Besides raw objects and text requests, binary frames can be exchanged. A
+  frame is made of a small header that gives the size of the payload,
+  followed by the payload itself. Frames are sent with a single gather
+  operation from the memory of the data, and received in a buffer that is
+  reused from one frame to the next, or directly in the memory of an image or
+  a matrix. This avoids the conversions to strings of the request mode when
+  streaming images or poses between processes:
+  \code
+  // Emitter side
+  vpImage<unsigned char> I;
+  vpHomogeneousMatrix cMo;
+  client.sendImage(I);
+  client.sendMatrix(cMo);
+
+  // Receptor side
+  if (serv.receiveImage(I) > 0 && serv.receiveMatrix(cMo) > 0) {
+    ...
+  }
+  \endcode
+  As for send() and receive(), the emitter and the receptor should agree on
+  the sequence of frames, and the payload is sent in the byte order of the
+  emitter. Frames and requests should not be mixed on the same connection.
+
   \sa vpServer
   \sa vpNetwork
 */
@@ -143,6 +169,26 @@ protected:
   long                    tv_usec;
   
   bool                    verboseMode;
+
+  //Binary frames
+  std::vector<char>       recvBuffer;
+  std::vector<char>       frameBuffer;
+  unsigned int            frameSize;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  //! Type of the payload of a binary frame.
+  typedef enum {
+    FRAME_DATA,
+    FRAME_IMAGE,
+    FRAME_MATRIX
+  } vpFrameType;
+
+  //! Memory area gathered in a binary frame.
+  struct vpFramePart{
+    const void           *data;
+    unsigned int          size;
+  };
+#endif
   
 private:
   
@@ -153,6 +199,16 @@ private:
   void              _receiveRequestFrom(const unsigned int &receptorEmitting);
   int               _receiveRequestOnce();
   int               _receiveRequestOnceFrom(const unsigned int &receptorEmitting);
+
+  int               _receiveAll(const unsigned int &receptorEmitting, void *data, const unsigned int &size);
+  int               _receiveFrameBuffer(const unsigned int &receptorEmitting, const unsigned int &size);
+  int               _receiveFrameHeader(const int &receptorEmitting, const unsigned int &type, unsigned int &tag,
+                                        unsigned int &size, unsigned int &index);
+  template<class Type>
+  int               _receiveImage(vpImage<Type> &I, const int &receptorEmitting);
+  int               _receiveMatrix(vpArray2D<double> &M, const int &receptorEmitting);
+  int               _sendFrameTo(const unsigned int &type, const unsigned int &tag, const vpFramePart *parts,
+                                 const unsigned int &nbParts, const unsigned int &dest);
   
 public:
 
@@ -161,6 +217,23 @@ public:
   
   void              addDecodingRequest(vpRequest *);
   
+  /*!
+    Get the payload of the last frame received with receiveFrame() or receiveFrameFrom().
+
+    \warning The returned pointer is only valid until the next frame is received.
+
+    \sa vpNetwork::getFrameSize()
+  */
+  const char *      getFrameData() const { return frameSize ? &frameBuffer[0] : NULL; }
+
+  /*!
+    Get the size in bytes of the payload of the last frame received with receiveFrame() or
+    receiveFrameFrom().
+
+    \sa vpNetwork::getFrameData()
+  */
+  unsigned int      getFrameSize() const { return frameSize; }
+
   int               getReceptorIndex(const char *name);
   
   /*!
@@ -191,6 +264,15 @@ public:
   int               receive(T* object, const unsigned int &sizeOfObject = sizeof(T));
   template<typename T>
   int               receiveFrom(T* object, const unsigned int &receptorEmitting, const unsigned int &sizeOfObject = sizeof(T));
+
+  int               receiveFrame(unsigned int &tag);
+  int               receiveFrameFrom(unsigned int &tag, const unsigned int &receptorEmitting);
+  template<class Type>
+  int               receiveImage(vpImage<Type> &I);
+  template<class Type>
+  int               receiveImageFrom(vpImage<Type> &I, const unsigned int &receptorEmitting);
+  int               receiveMatrix(vpArray2D<double> &M);
+  int               receiveMatrixFrom(vpArray2D<double> &M, const unsigned int &receptorEmitting);
   
   std::vector<int>  receiveRequest();
   std::vector<int>  receiveRequestFrom(const unsigned int &receptorEmitting);
@@ -208,6 +290,15 @@ public:
   int               send(T* object, const int unsigned &sizeOfObject = sizeof(T));
   template<typename T>
   int               sendTo(T* object, const unsigned int &dest, const unsigned int &sizeOfObject = sizeof(T));
+
+  int               sendFrame(const unsigned int &tag, const void *data, const unsigned int &size);
+  int               sendFrameTo(const unsigned int &tag, const void *data, const unsigned int &size, const unsigned int &dest);
+  template<class Type>
+  int               sendImage(const vpImage<Type> &I);
+  template<class Type>
+  int               sendImageTo(const vpImage<Type> &I, const unsigned int &dest);
+  int               sendMatrix(const vpArray2D<double> &M);
+  int               sendMatrixTo(const vpArray2D<double> &M, const unsigned int &dest);
   
   int               sendRequest(vpRequest &req);
   int               sendRequestTo(vpRequest &req, const unsigned int &dest);
@@ -504,4 +595,131 @@ int vpNetwork::sendTo(T* object, const unsigned int &dest, const unsigned int &s
 #endif
 }
 
+/*!
+  Send an image in a binary frame to the first receptor in the list. The image
+  pixels are sent directly from the image memory.
+
+  \sa vpNetwork::sendImageTo()
+  \sa vpNetwork::receiveImage()
+
+  \param I : Image to send.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+template<class Type>
+int vpNetwork::sendImage(const vpImage<Type> &I)
+{
+  return sendImageTo(I, 0);
+}
+
+/*!
+  Send an image in a binary frame to a specific receptor. The image pixels are
+  sent directly from the image memory.
+
+  \sa vpNetwork::getReceptorIndex()
+  \sa vpNetwork::sendImage()
+  \sa vpNetwork::receiveImageFrom()
+
+  \param I : Image to send.
+  \param dest : Index of the receptor that you are sending the image.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+template<class Type>
+int vpNetwork::sendImageTo(const vpImage<Type> &I, const unsigned int &dest)
+{
+  unsigned int desc[3];
+  desc[0] = I.getHeight();
+  desc[1] = I.getWidth();
+  desc[2] = (unsigned int)sizeof(Type);
+
+  vpFramePart parts[2];
+  parts[0].data = desc;
+  parts[0].size = (unsigned int)sizeof(desc);
+  parts[1].data = I.bitmap;
+  parts[1].size = I.getSize() * (unsigned int)sizeof(Type);
+
+  return _sendFrameTo(FRAME_IMAGE, 0, parts, 2, dest);
+}
+
+/*!
+  Receive an image sent with sendImage() or sendImageTo() by any receptor. The
+  image is resized if needed, and the pixels are received directly in the
+  image memory.
+
+  \sa vpNetwork::receiveImageFrom()
+  \sa vpNetwork::sendImage()
+
+  \param I : Received image.
+
+  \return The number of bytes received, 0 if no frame was received before the timeout
+  (see setTimeoutSec() and setTimeoutUSec()), or -1 if an error occured, or if the
+  frame does not contain an image of the same type.
+*/
+template<class Type>
+int vpNetwork::receiveImage(vpImage<Type> &I)
+{
+  return _receiveImage(I, -1);
+}
+
+/*!
+  Receive an image sent with sendImage() or sendImageTo() by a specific
+  receptor. The image is resized if needed, and the pixels are received
+  directly in the image memory.
+
+  \sa vpNetwork::getReceptorIndex()
+  \sa vpNetwork::receiveImage()
+  \sa vpNetwork::sendImageTo()
+
+  \param I : Received image.
+  \param receptorEmitting : Index of the receptor emitting the image.
+
+  \return The number of bytes received, 0 if no frame was received before the timeout
+  (see setTimeoutSec() and setTimeoutUSec()), or -1 if an error occured, or if the
+  frame does not contain an image of the same type.
+*/
+template<class Type>
+int vpNetwork::receiveImageFrom(vpImage<Type> &I, const unsigned int &receptorEmitting)
+{
+  return _receiveImage(I, (int)receptorEmitting);
+}
+
+/*!
+  Receive an image frame from a receptor, or from any receptor if
+  \e receptorEmitting is negative.
+*/
+template<class Type>
+int vpNetwork::_receiveImage(vpImage<Type> &I, const int &receptorEmitting)
+{
+  unsigned int tag, size, index;
+  int res = _receiveFrameHeader(receptorEmitting, FRAME_IMAGE, tag, size, index);
+  if (res <= 0)
+    return res;
+
+  // Image height, width and size of a pixel
+  unsigned int desc[3];
+  if (size < sizeof(desc)) {
+    _receiveFrameBuffer(index, size);
+    return -1;
+  }
+  if (_receiveAll(index, desc, (unsigned int)sizeof(desc)) < 0)
+    return -1;
+
+  unsigned int bitmapSize = size - (unsigned int)sizeof(desc);
+  if (desc[2] != sizeof(Type) || (size_t)bitmapSize != (size_t)desc[0] * desc[1] * sizeof(Type)) {
+    if(verboseMode)
+      vpTRACE( "The frame does not contain an image of the expected type" );
+    _receiveFrameBuffer(index, bitmapSize);
+    return -1;
+  }
+
+  if (I.getHeight() != desc[0] || I.getWidth() != desc[1])
+    I.resize(desc[0], desc[1]);
+
+  if (_receiveAll(index, I.bitmap, bitmapSize) < 0)
+    return -1;
+
+  return res + (int)size;
+}
+
 #endif
@@ -0,0 +1,162 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Packed point cloud.
+ *
+ *****************************************************************************/
+
+#ifndef vpPointCloud_h
+#define vpPointCloud_h
+
+#include <float.h>
+#include <stdint.h>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpImage.h>
+
+/*!
+  \file vpPointCloud.h
+  \brief Packed point cloud.
+*/
+
+/*!
+  \class vpPointCloud
+  \ingroup group_core_geometry
+  \brief Point cloud stored as three contiguous arrays of float coordinates.
+
+  The X, Y and Z coordinates of the points are stored in three separate
+  arrays (structure of arrays) of size getHeight() x getWidth(). When the
+  cloud is built from a depth map, it is organized like the image: the point
+  deprojected from pixel \f$(i,j)\f$ has the index \f$ i \times width + j \f$.
+  Pixels without a valid depth lead to a point with null coordinates.
+
+  Contrary to a std::vector<vpColVector>, where each point is a separately
+  allocated vector, the memory is only reallocated when the size of the cloud
+  grows. The same vpPointCloud can thus be filled at each frame by an RGB-D
+  grabber like vpRealSense or vpKinect without any allocation.
+
+  The deprojection uses per-pixel maps of the normalized coordinates
+  \f$(x,y)\f$ that are computed once from the camera parameters. Each point is
+  then obtained with \f$ X = x Z \f$ and \f$ Y = y Z \f$, which is vectorized.
+
+  \code
+#include <visp3/core/vpPointCloud.h>
+
+int main()
+{
+  vpCameraParameters cam(600, 600, 320, 240);
+  vpImage<uint16_t> depth(480, 640, 1000); // Depth in mm
+  vpPointCloud pointcloud;
+
+  for (unsigned int i = 0; i < 10; i++) {
+    // Acquire a new depth map, then
+    pointcloud.deproject(depth, 0.001f, cam);
+  }
+
+  // Conversion to the vpColVector representation
+  std::vector<vpColVector> points;
+  pointcloud.convert(points);
+}
+  \endcode
+*/
+class VISP_EXPORT vpPointCloud
+{
+public:
+  vpPointCloud();
+  vpPointCloud(const unsigned int height, const unsigned int width);
+
+  void buildFrom(const std::vector<vpColVector> &points);
+  void clear();
+  void convert(std::vector<vpColVector> &points) const;
+
+  void deproject(const vpImage<uint16_t> &depth, const float depth_scale, const vpCameraParameters &cam, const float max_Z=FLT_MAX);
+  void deproject(const vpImage<float> &depth, const vpCameraParameters &cam, const float max_Z=FLT_MAX);
+  void deproject(const uint16_t *depth, const float *xmap, const float *ymap,
+                 const unsigned int height, const unsigned int width, const float depth_scale, const float max_Z=FLT_MAX);
+  void deproject(const float *depth, const float *xmap, const float *ymap,
+                 const unsigned int height, const unsigned int width, const float max_Z=FLT_MAX);
+
+  //! Return the number of rows of an organized cloud, 1 otherwise.
+  inline unsigned int getHeight() const { return m_height; }
+  /*!
+    Get the coordinates of a point.
+    \param index : Index of the point, \f$ i \times width + j \f$ for an organized cloud.
+    \param X, Y, Z : Coordinates of the point.
+  */
+  inline void getPoint(const unsigned int index, float &X, float &Y, float &Z) const {
+    X = m_X[index]; Y = m_Y[index]; Z = m_Z[index];
+  }
+  //! Return the number of columns of an organized cloud, the number of points otherwise.
+  inline unsigned int getWidth() const { return m_width; }
+  //! Return a pointer to the X coordinates.
+  inline float *getX() { return m_X.empty() ? NULL : &m_X[0]; }
+  //! Return a pointer to the X coordinates.
+  inline const float *getX() const { return m_X.empty() ? NULL : &m_X[0]; }
+  //! Return a pointer to the Y coordinates.
+  inline float *getY() { return m_Y.empty() ? NULL : &m_Y[0]; }
+  //! Return a pointer to the Y coordinates.
+  inline const float *getY() const { return m_Y.empty() ? NULL : &m_Y[0]; }
+  //! Return a pointer to the Z coordinates.
+  inline float *getZ() { return m_Z.empty() ? NULL : &m_Z[0]; }
+  //! Return a pointer to the Z coordinates.
+  inline const float *getZ() const { return m_Z.empty() ? NULL : &m_Z[0]; }
+
+  static void initDeprojectionMaps(const vpCameraParameters &cam, const unsigned int height, const unsigned int width,
+                                   std::vector<float> &xmap, std::vector<float> &ymap);
+
+  //! Return true when the cloud has the layout of the depth map it comes from.
+  inline bool isOrganized() const { return m_height > 1; }
+
+  void resize(const unsigned int height, const unsigned int width);
+
+  //! Return the number of points.
+  inline unsigned int size() const { return m_height * m_width; }
+
+private:
+  void updateDeprojectionMaps(const vpCameraParameters &cam, const unsigned int height, const unsigned int width);
+
+  std::vector<float> m_X;
+  std::vector<float> m_Y;
+  std::vector<float> m_Z;
+  unsigned int m_height;
+  unsigned int m_width;
+
+  //! Deprojection maps and the camera parameters and size they were computed for
+  std::vector<float> m_xmap;
+  std::vector<float> m_ymap;
+  vpCameraParameters m_map_cam;
+  unsigned int m_map_height;
+  unsigned int m_map_width;
+};
+
+#endif
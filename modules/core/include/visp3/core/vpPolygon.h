@@ -127,6 +127,9 @@ class VISP_EXPORT vpPolygon
     void initClick(const vpImage<unsigned char>& I);
     
     bool isInside(const vpImagePoint &iP);
+    void isInside(const std::vector<vpImagePoint> &ips, std::vector<bool> &inside) const;
+
+    void fillMask(vpImage<unsigned char> &mask, unsigned char value=255, unsigned int shiftBorder=0) const;
 
     void display(const vpImage<unsigned char>& I, const vpColor& color, unsigned int thickness=1) const;
     
@@ -186,6 +189,11 @@ class VISP_EXPORT vpPolygon
 
   public:
     static bool isInside(const std::vector<vpImagePoint>& roi, const double &i, const double  &j);
+    static void isInside(const std::vector<vpImagePoint> &roi, const std::vector<vpImagePoint> &ips,
+                         std::vector<bool> &inside);
+    static void fillMask(const std::vector<vpImagePoint> &roi, unsigned char *mask,
+                         unsigned int height, unsigned int width, unsigned int stride,
+                         unsigned char value=255, unsigned int shiftBorder=0);
   private:
     static bool intersect(const vpImagePoint& p1, const vpImagePoint& p2, const double  &i, const double  &j, const double  &i_test, const double  &j_test);
 };
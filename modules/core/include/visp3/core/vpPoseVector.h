@@ -95,6 +95,8 @@ class VISP_EXPORT vpPoseVector : public vpArray2D<double>
 public:
   // constructor
   vpPoseVector() ;
+  // copy constructor
+  vpPoseVector(const vpPoseVector &p) ;
   // constructor from 3 angles (in radian)
   vpPoseVector(const double tx, const double ty, const double tz,
                const double tux, const double tuy, const double tuz) ;
@@ -215,6 +217,10 @@ public:
   vp_deprecated void init() {};
   //@}
 #endif
+
+private:
+  //! Inline storage of the 6 elements
+  vpArray2DStorage<double, 6, 1> storage;
 } ;
 
 #endif
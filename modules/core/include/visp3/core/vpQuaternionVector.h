@@ -115,6 +115,10 @@ public:
   vpQuaternionVector inverse() const;
   double magnitude() const;
   void normalize();
+
+private:
+  //! Inline storage of the 4 elements
+  vpArray2DStorage<double, 4, 1> storage;
 } ;
 
 #endif
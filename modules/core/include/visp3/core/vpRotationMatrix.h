@@ -157,6 +157,8 @@ public:
 
 private:
   static const double threshold;
+  //! Inline storage of the 3x3 elements
+  vpArray2DStorage<double, 3, 3> storage;
 };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -135,6 +135,9 @@ public:
   */
   vpRotationVector &operator=(const vpRotationVector &v)
   {
+    // resize() sets the elements to zero, nothing to do in a self assignment
+    if (this == &v)
+      return *this;
     resize(v.size(), 1);
     for (unsigned int i=0; i<v.size(); i++)
     {
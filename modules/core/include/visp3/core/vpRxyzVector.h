@@ -178,6 +178,10 @@ class VISP_EXPORT vpRxyzVector : public vpRotationVector
 
   vpRxyzVector &operator=(const vpColVector &rxyz);
   vpRxyzVector &operator=(double x) ;
+
+private:
+  //! Inline storage of the 3 elements
+  vpArray2DStorage<double, 3, 1> storage;
 } ;
 
 #endif
@@ -176,6 +176,10 @@ public:
 
   vpRzyxVector &operator=(const vpColVector &rzyx);
   vpRzyxVector &operator=(double x) ;
+
+private:
+  //! Inline storage of the 3 elements
+  vpArray2DStorage<double, 3, 1> storage;
 } ;
 
 #endif
@@ -176,5 +176,9 @@ class VISP_EXPORT vpRzyzVector : public vpRotationVector
 
   vpRzyzVector &operator=(const vpColVector &rzyz);
   vpRzyzVector &operator=(double x);
+
+private:
+  //! Inline storage of the 3 elements
+  vpArray2DStorage<double, 3, 1> storage;
 } ;
 #endif
@@ -196,6 +196,10 @@ public:
 
   vpThetaUVector &operator=(const vpColVector &tu);
   vpThetaUVector &operator=(double x) ;
+
+private:
+  //! Inline storage of the 3 elements
+  vpArray2DStorage<double, 3, 1> storage;
 } ;
 
 #endif
@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Process-wide pool of worker threads.
+ *
+ *****************************************************************************/
+
+#ifndef __vpThreadPool_h_
+#define __vpThreadPool_h_
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \file vpThreadPool.h
+  \brief Process-wide pool of persistent worker threads.
+*/
+
+/*!
+   \class vpThreadPool
+
+   \ingroup group_core_threading
+
+   Process-wide pool of persistent worker threads that allows to split a range
+   of indexes, typically image rows, among the available cores.
+
+   Contrary to vpThread that creates a new thread of execution each time it is
+   used, the worker threads of the pool are created once, the first time they
+   are needed, and then wait for new work. This avoids paying thread creation
+   and destruction on each call of functions that are executed at video rate,
+   like vpImage::performLut(), vpHistogram::calculate() or vpImageTools::undistort().
+
+   The range passed to parallel_for() is cut in chunks that are dispatched on
+   per-thread queues. The calling thread takes part to the computation and a
+   thread that has emptied its queue steals chunks from the other queues, so
+   that the load stays balanced even if the chunks have different costs.
+
+   The work to execute is given by a class that inherits from vpThreadPool::vpRangeTask:
+   \code
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpThreadPool.h>
+
+class vpInvertTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpInvertTask(vpImage<unsigned char> &I) : m_I(I) {}
+  void run(unsigned int start, unsigned int end)
+  {
+    for (unsigned int i = start; i < end; i++)
+      for (unsigned int j = 0; j < m_I.getWidth(); j++)
+        m_I[i][j] = 255 - m_I[i][j];
+  }
+private:
+  vpImage<unsigned char> &m_I;
+};
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640, 0);
+  vpThreadPool::setNumThreads(4);
+
+  vpInvertTask task(I);
+  vpThreadPool::parallel_for(0, I.getHeight(), task);
+}
+   \endcode
+
+   When ViSP is built without pthread support (or outside Windows), or when
+   parallel_for() is called from a task that is already running in the pool,
+   the whole range is processed by the calling thread.
+ */
+class VISP_EXPORT vpThreadPool
+{
+public:
+  /*!
+    \class vpRangeTask
+
+    Interface of the work executed by vpThreadPool::parallel_for().
+    run() is called concurrently on disjoint sub-ranges and should only
+    modify data associated to the indexes it receives.
+  */
+  class VISP_EXPORT vpRangeTask
+  {
+  public:
+    virtual ~vpRangeTask() {};
+    /*!
+      Process the indexes in [start, end).
+    */
+    virtual void run(unsigned int start, unsigned int end) = 0;
+  };
+
+  static unsigned int getNumProcessors();
+  static unsigned int getNumThreads();
+  static void parallel_for(unsigned int begin, unsigned int end, vpRangeTask &task, unsigned int grainSize=0);
+  static void setNumThreads(unsigned int nbThreads);
+};
+
+#endif
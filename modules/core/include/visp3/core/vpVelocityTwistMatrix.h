@@ -179,6 +179,10 @@ class VISP_EXPORT vpVelocityTwistMatrix : public vpArray2D<double>
   vp_deprecated void setIdentity();
   //@}
 #endif
+
+private:
+  //! Inline storage of the 6x6 elements
+  vpArray2DStorage<double, 6, 6> storage;
 } ;
 
 #endif
@@ -45,9 +45,12 @@
 
 #include <sstream>
 #include <map>
+#include <string.h>
 
 // image
 #include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpThreadPool.h>
 
 #if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
 #  include <emmintrin.h>
@@ -1170,337 +1173,503 @@ void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelRgb > *sr
 
 #endif
 
-#define vpSAT(c) \
-        if (c & (~255)) { if (c < 0) c = 0; else c = 255; }
-/*!
-  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...) to RGB32.
-  Destination rgba memory area has to be allocated before.
-
-  \sa YUV422ToRGBa()
-*/
-void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
-                                unsigned int width, unsigned int height)
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
 {
-  unsigned char *s;
-  unsigned char *d;
-  int w, h;
-  int r, g, b, cr, cg, cb, y1, y2;
-
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgba;
-  while (h--) {
-    int c = w >> 1;
-    while (c--) {
-      y1 = *s++;
-      cb = ((*s - 128) * 454) >> 8;
-      cg = (*s++ - 128) * 88;
-      y2 = *s++;
-      cr = ((*s - 128) * 359) >> 8;
-      cg = (cg + (*s++ - 128) * 183) >> 8;
-
-      r = y1 + cr;
-      b = y1 + cb;
-      g = y1 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = 0;
-
-      r = y2 + cr;
-      b = y2 + cb;
-      g = y2 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = 0;
+/*
+  Chroma terms of the YUV conversions: the red, green and blue components of a
+  pixel are obtained by adding cr, cg and cb to its luminance and saturating the
+  sum to [0, 255]. The SSE2 versions work on 8 chroma samples stored as 16 bits
+  integers and give exactly the same terms as the scalar versions.
+*/
 
-    }
+// R = Y + 2V, G = Y - U - V, B = Y + 5U, with U = 0.354 (u-128) and V = 0.707 (v-128)
+class vpYUVChroma
+{
+public:
+  inline void compute(int u, int v, int &cr, int &cg, int &cb) const
+  {
+    int U = (int)((u - 128) * 0.354);
+    int V = (int)((v - 128) * 0.707);
+    cr = 2*V;
+    cg = - U - V;
+    cb = 5*U;
   }
-}
-/*!
 
-  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
-  to RGB24. Destination rgb memory area has to be allocated before.
+#if VISP_HAVE_SSE2
+  inline void compute(const __m128i &u, const __m128i &v, __m128i &cr, __m128i &cg, __m128i &cb) const
+  {
+    const __m128i du = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    const __m128i dv = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    // The high part of the products rounds toward minus infinity, 1 is added
+    // to the negative values to truncate toward zero like the scalar version
+    const __m128i U = _mm_sub_epi16(_mm_mulhi_epi16(du, _mm_set1_epi16(23199)), _mm_srai_epi16(du, 15));
+    const __m128i V = _mm_sub_epi16(_mm_mulhi_epi16(_mm_slli_epi16(dv, 1), _mm_set1_epi16(23164)),
+                                    _mm_srai_epi16(dv, 15));
+    cr = _mm_add_epi16(V, V);
+    cg = _mm_sub_epi16(_mm_setzero_si128(), _mm_add_epi16(U, V));
+    cb = _mm_add_epi16(_mm_slli_epi16(U, 2), U);
+  }
+#endif
+};
 
-  \sa YUV422ToRGB()
-*/
-void vpImageConvert::YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
-                               unsigned int width, unsigned int height)
+// Integer approximation used for YUYV: R = Y + 1.402 (v-128), G = Y - 0.344 (u-128) - 0.714 (v-128), B = Y + 1.772 (u-128)
+class vpYUYVChroma
 {
-  unsigned char *s;
-  unsigned char *d;
-  int h, w;
-  int r, g, b, cr, cg, cb, y1, y2;
-
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgb;
-  while (h--) {
-    int c = w >> 1;
-    while (c--) {
-      y1 = *s++;
-      cb = ((*s - 128) * 454) >> 8;
-      cg = (*s++ - 128) * 88;
-      y2 = *s++;
-      cr = ((*s - 128) * 359) >> 8;
-      cg = (cg + (*s++ - 128) * 183) >> 8;
-
-      r = y1 + cr;
-      b = y1 + cb;
-      g = y1 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-
-      r = y2 + cr;
-      b = y2 + cb;
-      g = y2 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-    }
+public:
+  inline void compute(int u, int v, int &cr, int &cg, int &cb) const
+  {
+    cr = ((v - 128) * 359) >> 8;
+    cg = - (((u - 128) * 88 + (v - 128) * 183) >> 8);
+    cb = ((u - 128) * 454) >> 8;
   }
-}
-/*!
 
-  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
-  to grey. Destination rgb memory area has to be allocated before.
+#if VISP_HAVE_SSE2
+  inline void compute(const __m128i &u, const __m128i &v, __m128i &cr, __m128i &cg, __m128i &cb) const
+  {
+    const __m128i du = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    const __m128i dv = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    const __m128i coef = _mm_set1_epi32((183 << 16) | 88);
+    const __m128i g_lo = _mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(du, dv), coef), 8);
+    const __m128i g_hi = _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(du, dv), coef), 8);
+    cr = _mm_mulhi_epi16(_mm_slli_epi16(dv, 8), _mm_set1_epi16(359));
+    cg = _mm_sub_epi16(_mm_setzero_si128(), _mm_packs_epi32(g_lo, g_hi));
+    cb = _mm_srai_epi16(_mm_mullo_epi16(du, _mm_set1_epi16(227)), 7);
+  }
+#endif
+};
 
-  \sa YUV422ToGrey()
-*/
-void vpImageConvert::YUYVToGrey(unsigned char* yuyv, unsigned char* grey, unsigned int size)
+// Look-up tables computed by vpImageConvert::computeYCbCrLUT(), u is Cb and v is Cr
+class vpYCbCrChroma
 {
-  unsigned int i=0,j=0;
-
-  while( j < size*2)
-    {
-      grey[i++] = yuyv[j];
-      grey[i++] = yuyv[j+2];
-      j+=4;
-    }
-}
+public:
+  vpYCbCrChroma(const int *crr, const int *cgb, const int *cgr, const int *cbb)
+    : m_crr(crr), m_cgb(cgb), m_cgr(cgr), m_cbb(cbb)
+  {
+  }
 
+  inline void compute(int u, int v, int &cr, int &cg, int &cb) const
+  {
+    cr = m_crr[v];
+    cg = m_cgb[u] + m_cgr[v];
+    cb = m_cbb[u];
+  }
 
-/*!
+#if VISP_HAVE_SSE2
+  inline void compute(const __m128i &u, const __m128i &v, __m128i &cr, __m128i &cg, __m128i &cb) const
+  {
+    // Multipliers checked against the tables for the 256 chroma values. The
+    // green terms are truncated before the shift, which differs from the
+    // rounding of the product for a single value of each table
+    const __m128i du = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    const __m128i dv = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    const __m128i gb = _mm_sub_epi16(_mm_mulhi_epi16(du, _mm_set1_epi16(-23026)),
+                                     _mm_cmpeq_epi16(du, _mm_set1_epi16(94)));
+    const __m128i gr = _mm_sub_epi16(_mm_mulhi_epi16(_mm_slli_epi16(dv, 1), _mm_set1_epi16(-23790)),
+                                     _mm_cmpeq_epi16(dv, _mm_set1_epi16(62)));
+    cr = _mm_mulhi_epi16(_mm_slli_epi16(dv, 2), _mm_set1_epi16(23335));
+    cg = _mm_add_epi16(gb, gr);
+    cb = _mm_mulhi_epi16(_mm_slli_epi16(du, 2), _mm_set1_epi16(29465));
+  }
+#endif
 
-Convert YUV411 into RGB32
-yuv411 : u y1 y2 v y3 y4
+private:
+  const int *m_crr;
+  const int *m_cgb;
+  const int *m_cgr;
+  const int *m_cbb;
+};
 
-*/
-void vpImageConvert::YUV411ToRGBa(unsigned char* yuv, unsigned char* rgba, unsigned int size)
+// Writes a RGB or RGBa pixel. With keepAlpha the alpha byte is left untouched, otherwise it is set to 0.
+inline void vpWritePixel(unsigned char *dst, int y, int cr, int cg, int cb, unsigned int nbChannels, bool keepAlpha)
 {
-#if 1
-  //  std::cout << "call optimized ConvertYUV411ToRGBa()" << std::endl;
-  for(unsigned int i = size / 4; i; i--) {
-    int U   = (int)((*yuv++ - 128) * 0.354);
-    int U5  = 5*U;
-    int Y0  = *yuv++;
-    int Y1  = *yuv++;
-    int V   = (int)((*yuv++ - 128) * 0.707);
-    int V2  = 2*V;
-    int Y2  = *yuv++;
-    int Y3  = *yuv++;
-    int UV  = - U - V;
+  dst[0] = vpMath::saturate<unsigned char>(y + cr);
+  dst[1] = vpMath::saturate<unsigned char>(y + cg);
+  dst[2] = vpMath::saturate<unsigned char>(y + cb);
+  if (nbChannels == 4 && !keepAlpha)
+    dst[3] = 0;
+}
 
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    int R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+#if VISP_HAVE_SSE2
+// True when 16 pixels with nbChannels channels can be stored with vpStorePixels()
+inline bool vpHaveSimdStore(unsigned int nbChannels)
+{
+#if VISP_HAVE_SSSE3
+  (void)nbChannels;
+  return true;
+#else
+  return nbChannels == 4;
+#endif
+}
 
-    int G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+// Saturated sums of 16 luminances and chroma terms, each given as two registers of 8 16 bits integers
+inline __m128i vpAddSaturate(const __m128i &y_lo, const __m128i &y_hi, const __m128i &c_lo, const __m128i &c_hi)
+{
+  return _mm_packus_epi16(_mm_add_epi16(y_lo, c_lo), _mm_add_epi16(y_hi, c_hi));
+}
 
-    int B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+// Interleaves the components of 16 pixels in RGBa or RGB (SSSE3 only) and stores them in dst
+inline void vpStorePixels(unsigned char *dst, const __m128i &r, const __m128i &g, const __m128i &b,
+                          unsigned int nbChannels, bool keepAlpha)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rg_lo = _mm_unpacklo_epi8(r, g);
+  const __m128i rg_hi = _mm_unpackhi_epi8(r, g);
+  const __m128i b_lo = _mm_unpacklo_epi8(b, zero);
+  const __m128i b_hi = _mm_unpackhi_epi8(b, zero);
+  __m128i p[4];
+  p[0] = _mm_unpacklo_epi16(rg_lo, b_lo);
+  p[1] = _mm_unpackhi_epi16(rg_lo, b_lo);
+  p[2] = _mm_unpacklo_epi16(rg_hi, b_hi);
+  p[3] = _mm_unpackhi_epi16(rg_hi, b_hi);
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
+  if (nbChannels == 4) {
+    if (keepAlpha) {
+      const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+      for (unsigned int k = 0; k < 4; k++)
+        p[k] = _mm_or_si128(p[k], _mm_and_si128(_mm_loadu_si128((const __m128i *)(dst + 16*k)), alpha));
+    }
+    for (unsigned int k = 0; k < 4; k++)
+      _mm_storeu_si128((__m128i *)(dst + 16*k), p[k]);
+  }
+#if VISP_HAVE_SSSE3
+  else {
+    const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for (unsigned int k = 0; k < 4; k++)
+      p[k] = _mm_shuffle_epi8(p[k], mask);
+    _mm_storeu_si128((__m128i *)dst, _mm_or_si128(p[0], _mm_slli_si128(p[1], 12)));
+    _mm_storeu_si128((__m128i *)(dst + 16), _mm_or_si128(_mm_srli_si128(p[1], 4), _mm_slli_si128(p[2], 8)));
+    _mm_storeu_si128((__m128i *)(dst + 32), _mm_or_si128(_mm_srli_si128(p[2], 8), _mm_slli_si128(p[3], 4)));
+  }
+#endif
+}
 
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+// Computes and stores 16 pixels sharing their chroma samples by pairs (4:2:2 and 4:2:0)
+template <class Chroma>
+inline void vpConvertPixels422(unsigned char *dst, const __m128i &y_lo, const __m128i &y_hi, const __m128i &u,
+                               const __m128i &v, const Chroma &chroma, unsigned int nbChannels, bool keepAlpha)
+{
+  __m128i cr, cg, cb;
+  chroma.compute(u, v, cr, cg, cb);
+  vpStorePixels(dst, vpAddSaturate(y_lo, y_hi, _mm_unpacklo_epi16(cr, cr), _mm_unpackhi_epi16(cr, cr)),
+                vpAddSaturate(y_lo, y_hi, _mm_unpacklo_epi16(cg, cg), _mm_unpackhi_epi16(cg, cg)),
+                vpAddSaturate(y_lo, y_hi, _mm_unpacklo_epi16(cb, cb), _mm_unpackhi_epi16(cb, cb)),
+                nbChannels, keepAlpha);
+}
+#endif
 
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+#if VISP_HAVE_SSSE3
+// Loads 24 bytes of YUV 4:1:1 (u y0 y1 v y2 y3 ...), that is 16 luminances and 4 chroma samples of each kind
+inline void vpLoadYUV411(const unsigned char *src, __m128i &y_lo, __m128i &y_hi, __m128i &u, __m128i &v)
+{
+  const __m128i a = _mm_loadu_si128((const __m128i *)src);
+  const __m128i b = _mm_alignr_epi8(_mm_loadl_epi64((const __m128i *)(src + 16)), a, 8); // bytes 8 to 23
+  y_lo = _mm_shuffle_epi8(a, _mm_setr_epi8(1, -1, 2, -1, 4, -1, 5, -1, 7, -1, 8, -1, 10, -1, 11, -1));
+  y_hi = _mm_shuffle_epi8(b, _mm_setr_epi8(5, -1, 6, -1, 8, -1, 9, -1, 11, -1, 12, -1, 14, -1, 15, -1));
+  u = _mm_or_si128(_mm_shuffle_epi8(a, _mm_setr_epi8(0, -1, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                   _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, 4, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1)));
+  v = _mm_or_si128(_mm_shuffle_epi8(a, _mm_setr_epi8(3, -1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                   _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, 7, -1, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1)));
+}
+#endif
 
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+// Converts the ranges of an image with nbThreads threads of vpThreadPool
+void vpRunConversion(vpThreadPool::vpRangeTask &task, unsigned int n, unsigned int nbThreads)
+{
+  bool use_single_thread = (nbThreads == 0 || nbThreads == 1);
+#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
+  use_single_thread = true;
+#endif
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
+  if (use_single_thread || n <= nbThreads)
+    task.run(0, n);
+  else
+    vpThreadPool::parallel_for(0, n, task, (n + nbThreads - 1) / nbThreads);
+}
 
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+/*
+  Packed 4:2:2 formats, two pixels are coded on 4 bytes with their own
+  luminances and shared chroma samples: Y0 U Y1 V when lumaFirst is true,
+  U Y0 V Y1 otherwise. When uFirst is false U and V are swapped.
+  The range processed by run() is a range of pairs of pixels.
+*/
+template <class Chroma>
+class vpPacked422Task : public vpThreadPool::vpRangeTask
+{
+public:
+  vpPacked422Task(const unsigned char *src, unsigned char *dst, unsigned int nbChannels, bool keepAlpha,
+                  bool lumaFirst, bool uFirst, const Chroma &chroma)
+    : m_src(src), m_dst(dst), m_nbChannels(nbChannels), m_keepAlpha(keepAlpha), m_lumaFirst(lumaFirst),
+      m_uFirst(uFirst), m_chroma(chroma)
+  {
+  }
 
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  void run(unsigned int start, unsigned int end)
+  {
+    const unsigned char *s = m_src + 4*(size_t)start;
+    unsigned char *d = m_dst + 2*m_nbChannels*(size_t)start;
+    unsigned int i = start;
+
+#if VISP_HAVE_SSE2
+    if (vpHaveSimdStore(m_nbChannels)) {
+      const __m128i mask = _mm_set1_epi16(0x00FF);
+      for (; i + 8 <= end; i += 8, s += 32, d += 16*m_nbChannels) {
+        const __m128i a = _mm_loadu_si128((const __m128i *)s);
+        const __m128i b = _mm_loadu_si128((const __m128i *)(s + 16));
+        __m128i y_lo, y_hi, c;
+        if (m_lumaFirst) {
+          y_lo = _mm_and_si128(a, mask);
+          y_hi = _mm_and_si128(b, mask);
+          c = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        }
+        else {
+          y_lo = _mm_srli_epi16(a, 8);
+          y_hi = _mm_srli_epi16(b, 8);
+          c = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+        }
+        const __m128i c0 = _mm_and_si128(c, mask);
+        const __m128i c1 = _mm_srli_epi16(c, 8);
+        vpConvertPixels422(d, y_lo, y_hi, m_uFirst ? c0 : c1, m_uFirst ? c1 : c0, m_chroma, m_nbChannels, m_keepAlpha);
+      }
+    }
+#endif
 
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+    const unsigned int y_off = m_lumaFirst ? 0 : 1;
+    const unsigned int u_off = (1 - y_off) + (m_uFirst ? 0 : 2);
+    const unsigned int v_off = (1 - y_off) + (m_uFirst ? 2 : 0);
+    for (; i < end; i++, s += 4, d += 2*m_nbChannels) {
+      int cr, cg, cb;
+      m_chroma.compute(s[u_off], s[v_off], cr, cg, cb);
+      vpWritePixel(d, s[y_off], cr, cg, cb, m_nbChannels, m_keepAlpha);
+      vpWritePixel(d + m_nbChannels, s[y_off + 2], cr, cg, cb, m_nbChannels, m_keepAlpha);
+    }
+  }
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
+private:
+  const unsigned char *m_src;
+  unsigned char *m_dst;
+  unsigned int m_nbChannels;
+  bool m_keepAlpha;
+  bool m_lumaFirst;
+  bool m_uFirst;
+  Chroma m_chroma;
+};
 
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+/*
+  YUV 4:1:1 format, four pixels are coded on 6 bytes: U Y0 Y1 V Y2 Y3.
+  The range processed by run() is a range of groups of four pixels.
+*/
+class vpYUV411Task : public vpThreadPool::vpRangeTask
+{
+public:
+  vpYUV411Task(const unsigned char *src, unsigned char *dst, unsigned int nbChannels, bool keepAlpha)
+    : m_src(src), m_dst(dst), m_nbChannels(nbChannels), m_keepAlpha(keepAlpha), m_chroma()
+  {
+  }
 
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  void run(unsigned int start, unsigned int end)
+  {
+    const unsigned char *s = m_src + 6*(size_t)start;
+    unsigned char *d = m_dst + 4*m_nbChannels*(size_t)start;
+    unsigned int i = start;
 
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+#if VISP_HAVE_SSSE3
+    for (; i + 4 <= end; i += 4, s += 24, d += 16*m_nbChannels) {
+      __m128i y_lo, y_hi, u, v, cr, cg, cb;
+      vpLoadYUV411(s, y_lo, y_hi, u, v);
+      m_chroma.compute(u, v, cr, cg, cb);
+      // Each chroma term is shared by four pixels
+      cr = _mm_unpacklo_epi16(cr, cr);
+      cg = _mm_unpacklo_epi16(cg, cg);
+      cb = _mm_unpacklo_epi16(cb, cb);
+      vpStorePixels(d, vpAddSaturate(y_lo, y_hi, _mm_unpacklo_epi32(cr, cr), _mm_unpackhi_epi32(cr, cr)),
+                    vpAddSaturate(y_lo, y_hi, _mm_unpacklo_epi32(cg, cg), _mm_unpackhi_epi32(cg, cg)),
+                    vpAddSaturate(y_lo, y_hi, _mm_unpacklo_epi32(cb, cb), _mm_unpackhi_epi32(cb, cb)),
+                    m_nbChannels, m_keepAlpha);
+    }
+#endif
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
+    for (; i < end; i++, s += 6, d += 4*m_nbChannels) {
+      int cr, cg, cb;
+      m_chroma.compute(s[0], s[3], cr, cg, cb);
+      vpWritePixel(d, s[1], cr, cg, cb, m_nbChannels, m_keepAlpha);
+      vpWritePixel(d + m_nbChannels, s[2], cr, cg, cb, m_nbChannels, m_keepAlpha);
+      vpWritePixel(d + 2*m_nbChannels, s[4], cr, cg, cb, m_nbChannels, m_keepAlpha);
+      vpWritePixel(d + 3*m_nbChannels, s[5], cr, cg, cb, m_nbChannels, m_keepAlpha);
+    }
   }
-#else
-  // tres tres lent ....
-  unsigned int i=0,j=0;
-  unsigned char r, g, b;
-  while( j < numpixels*3/2)
+
+private:
+  const unsigned char *m_src;
+  unsigned char *m_dst;
+  unsigned int m_nbChannels;
+  bool m_keepAlpha;
+  vpYUVChroma m_chroma;
+};
+
+/*
+  Planar 4:2:0 formats (YUV420 and YV12): a plane of luminances followed by
+  two planes of chroma samples subsampled by 2 in both directions.
+  The range processed by run() is a range of pairs of rows.
+*/
+class vpYUV420Task : public vpThreadPool::vpRangeTask
+{
+public:
+  vpYUV420Task(const unsigned char *y, const unsigned char *u, const unsigned char *v, unsigned char *dst,
+               unsigned int width, unsigned int nbChannels)
+    : m_y(y), m_u(u), m_v(v), m_dst(dst), m_width(width), m_nbChannels(nbChannels), m_chroma()
   {
+  }
 
-    YUVToRGB (yuv[j+1], yuv[j], yuv[j+3], r, g, b);
-    rgba[i]   = r;
-    rgba[i+1] = g;
-    rgba[i+2] = b;
-    rgba[i+3] = 0;
-    i+=4;
+  void run(unsigned int start, unsigned int end)
+  {
+    const unsigned int half_width = m_width / 2;
+    for (unsigned int i = start; i < end; i++) {
+      const unsigned char *y0 = m_y + 2*(size_t)i*m_width;
+      const unsigned char *y1 = y0 + m_width;
+      const unsigned char *u = m_u + (size_t)i*half_width;
+      const unsigned char *v = m_v + (size_t)i*half_width;
+      unsigned char *d0 = m_dst + 2*(size_t)i*m_width*m_nbChannels;
+      unsigned char *d1 = d0 + m_width*m_nbChannels;
+      unsigned int j = 0;
 
-    YUVToRGB (yuv[j+2], yuv[j], yuv[j+3], r, g, b);
-    rgba[i]   = r;
-    rgba[i+1] = g;
-    rgba[i+2] = b;
-    rgba[i+3] = 0;
-    i+=4;
+#if VISP_HAVE_SSE2
+      if (vpHaveSimdStore(m_nbChannels)) {
+        const __m128i zero = _mm_setzero_si128();
+        for (; j + 8 <= half_width; j += 8) {
+          const __m128i u8 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(u + j)), zero);
+          const __m128i v8 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(v + j)), zero);
+          const __m128i a = _mm_loadu_si128((const __m128i *)(y0 + 2*j));
+          const __m128i b = _mm_loadu_si128((const __m128i *)(y1 + 2*j));
+          vpConvertPixels422(d0 + 2*j*m_nbChannels, _mm_unpacklo_epi8(a, zero), _mm_unpackhi_epi8(a, zero),
+                             u8, v8, m_chroma, m_nbChannels, false);
+          vpConvertPixels422(d1 + 2*j*m_nbChannels, _mm_unpacklo_epi8(b, zero), _mm_unpackhi_epi8(b, zero),
+                             u8, v8, m_chroma, m_nbChannels, false);
+        }
+      }
+#endif
 
-    YUVToRGB (yuv[j+4], yuv[j], yuv[j+3], r, g, b);
-    rgba[i]   = r;
-    rgba[i+1] = g;
-    rgba[i+2] = b;
-    rgba[i+3] = 0;
-    i+=4;
+      for (; j < half_width; j++) {
+        int cr, cg, cb;
+        m_chroma.compute(u[j], v[j], cr, cg, cb);
+        vpWritePixel(d0 + 2*j*m_nbChannels, y0[2*j], cr, cg, cb, m_nbChannels, false);
+        vpWritePixel(d0 + (2*j+1)*m_nbChannels, y0[2*j+1], cr, cg, cb, m_nbChannels, false);
+        vpWritePixel(d1 + 2*j*m_nbChannels, y1[2*j], cr, cg, cb, m_nbChannels, false);
+        vpWritePixel(d1 + (2*j+1)*m_nbChannels, y1[2*j+1], cr, cg, cb, m_nbChannels, false);
+      }
+    }
+  }
 
-    YUVToRGB (yuv[j+5], yuv[j], yuv[j+3], r, g, b);
-    rgba[i]   = r;
-    rgba[i+1] = g;
-    rgba[i+2] = b;
-    rgba[i+3] = 0;
-    i+=4;
+private:
+  const unsigned char *m_y;
+  const unsigned char *m_u;
+  const unsigned char *m_v;
+  unsigned char *m_dst;
+  unsigned int m_width;
+  unsigned int m_nbChannels;
+  vpYUVChroma m_chroma;
+};
 
-    j+=6;
+// Copies the n bytes found at the even (offset = 0) or odd (offset = 1) positions of src
+void vpExtractBytes(const unsigned char *src, unsigned char *dst, unsigned int n, unsigned int offset)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  const __m128i mask = _mm_set1_epi16(0x00FF);
+  for (; i + 16 <= n; i += 16, src += 32, dst += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i *)src);
+    __m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+    if (offset) {
+      a = _mm_srli_epi16(a, 8);
+      b = _mm_srli_epi16(b, 8);
+    }
+    else {
+      a = _mm_and_si128(a, mask);
+      b = _mm_and_si128(b, mask);
+    }
+    _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(a, b));
   }
 #endif
-
+  for (; i < n; i++, src += 2)
+    *dst++ = src[offset];
 }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /*!
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB32 images.
+  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...) to RGB32.
   Destination rgba memory area has to be allocated before.
 
-  \sa YUYVToRGBa()
+  \sa YUV422ToRGBa()
+
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
 */
-void vpImageConvert::YUV422ToRGBa(unsigned char* yuv, unsigned char* rgba, unsigned int size)
+void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
+                                unsigned int width, unsigned int height, unsigned int nbThreads)
 {
+  vpPacked422Task<vpYUYVChroma> task(yuyv, rgba, 4, false, true, true, vpYUYVChroma());
+  vpRunConversion(task, height*(width >> 1), nbThreads);
+}
+/*!
 
-#if 1
-  //  std::cout << "call optimized convertYUV422ToRGBa()" << std::endl;
-  for( unsigned int i = size / 2; i; i-- ) {
-    int U   = (int)((*yuv++ - 128) * 0.354);
-    int U5  = 5*U;
-    int Y0  = *yuv++;
-    int V   = (int)((*yuv++ - 128) * 0.707);
-    int V2  = 2*V;
-    int Y1  = *yuv++;
-    int UV  = - U - V;
+  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
+  to RGB24. Destination rgb memory area has to be allocated before.
 
-    //---
-    int R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  \sa YUV422ToRGB()
 
-    int G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
+*/
+void vpImageConvert::YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
+                               unsigned int width, unsigned int height, unsigned int nbThreads)
+{
+  vpPacked422Task<vpYUYVChroma> task(yuyv, rgb, 3, false, true, true, vpYUYVChroma());
+  vpRunConversion(task, height*(width >> 1), nbThreads);
+}
+/*!
 
-    int B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
+  to grey. Destination rgb memory area has to be allocated before.
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
+  \sa YUV422ToGrey()
+*/
+void vpImageConvert::YUYVToGrey(unsigned char* yuyv, unsigned char* grey, unsigned int size)
+{
+  vpExtractBytes(yuyv, grey, size, 0);
+}
 
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
 
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+/*!
 
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+Convert YUV411 into RGB32
+yuv411 : u y1 y2 v y3 y4
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
-  }
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
 
-#else
-  // tres tres lent ....
- unsigned int i=0,j=0;
- unsigned char r, g, b;
-
- while( j < size*2)
- {
-
-   YUVToRGB (yuv[j+1], yuv[j], yuv[j+2], r, g, b);
-   rgba[i]   = r;
-   rgba[i+1] = g;
-   rgba[i+2] = b;
-   rgba[i+3] = 0;
-   i+=4;
-
-   YUVToRGB (yuv[j+3], yuv[j], yuv[j+2], r, g, b);
-   rgba[i]   = r;
-   rgba[i+1] = g;
-   rgba[i+2] = b;
-   rgba[i+3] = 0;
-   i+=4;
-   j+=4;
-
- }
-#endif
+*/
+void vpImageConvert::YUV411ToRGBa(unsigned char* yuv, unsigned char* rgba, unsigned int size,
+                                  unsigned int nbThreads)
+{
+  vpYUV411Task task(yuv, rgba, 4, true);
+  vpRunConversion(task, size / 4, nbThreads);
+}
+
+/*!
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB32 images.
+  Destination rgba memory area has to be allocated before.
+
+  \sa YUYVToRGBa()
+
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
+*/
+void vpImageConvert::YUV422ToRGBa(unsigned char* yuv, unsigned char* rgba, unsigned int size,
+                                  unsigned int nbThreads)
+{
+  vpPacked422Task<vpYUVChroma> task(yuv, rgba, 4, true, false, true, vpYUVChroma());
+  vpRunConversion(task, size / 2, nbThreads);
 }
 
 /*!
@@ -1512,6 +1681,13 @@ yuv411 : u y1 y2 v y3 y4
 void vpImageConvert::YUV411ToGrey(unsigned char* yuv, unsigned char* grey, unsigned int size)
 {
   unsigned int i=0,j=0;
+#if VISP_HAVE_SSSE3
+  for (; i + 16 <= size; i += 16, j += 24) {
+    __m128i y_lo, y_hi, u, v;
+    vpLoadYUV411(yuv + j, y_lo, y_hi, u, v);
+    _mm_storeu_si128((__m128i *)(grey + i), _mm_packus_epi16(y_lo, y_hi));
+  }
+#endif
   while( j < size*3/2)
   {
 
@@ -1533,73 +1709,15 @@ void vpImageConvert::YUV411ToGrey(unsigned char* yuv, unsigned char* grey, unsig
 
   \sa YUYVToRGB()
 
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
+
 */
-void vpImageConvert::YUV422ToRGB(unsigned char* yuv, unsigned char* rgb, unsigned int size)
+void vpImageConvert::YUV422ToRGB(unsigned char* yuv, unsigned char* rgb, unsigned int size,
+                                 unsigned int nbThreads)
 {
-#if 1
-  //  std::cout << "call optimized convertYUV422ToRGB()" << std::endl;
-  for( unsigned int i = size / 2; i; i-- ) {
-    int U   = (int)((*yuv++ - 128) * 0.354);
-    int U5  = 5*U;
-    int Y0  = *yuv++;
-    int V   = (int)((*yuv++ - 128) * 0.707);
-    int V2  = 2*V;
-    int Y1  = *yuv++;
-    int UV  = - U - V;
-
-    //---
-    int R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    int G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    int B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-  }
-
-#else
-  // tres tres lent ....
- unsigned int i=0,j=0;
- unsigned char r, g, b;
-
- while( j < size*2)
- {
-
-   YUVToRGB (yuv[j+1], yuv[j], yuv[j+2], r, g, b);
-   rgb[i]   = r;
-   rgb[i+1] = g;
-   rgb[i+2] = b;
-   i+=3;
-
-   YUVToRGB (yuv[j+3], yuv[j], yuv[j+2], r, g, b);
-   rgb[i]   = r;
-   rgb[i+1] = g;
-   rgb[i+2] = b;
-   i+=3;
-   j+=4;
-
- }
-#endif
+  vpPacked422Task<vpYUVChroma> task(yuv, rgb, 3, false, false, true, vpYUVChroma());
+  vpRunConversion(task, size / 2, nbThreads);
 }
 
 /*!
@@ -1612,14 +1730,7 @@ void vpImageConvert::YUV422ToRGB(unsigned char* yuv, unsigned char* rgb, unsigne
 */
 void vpImageConvert::YUV422ToGrey(unsigned char* yuv, unsigned char* grey, unsigned int size)
 {
- unsigned int i=0,j=0;
-
- while( j < size*2)
- {
-   grey[i++] = yuv[j+1];
-   grey[i++] = yuv[j+3];
-   j+=4;
- }
+  vpExtractBytes(yuv, grey, size, 1);
 }
 
 /*!
@@ -1627,318 +1738,51 @@ void vpImageConvert::YUV422ToGrey(unsigned char* yuv, unsigned char* grey, unsig
 Convert YUV411 into RGB
 yuv411 : u y1 y2 v y3 y4
 
-*/
-void vpImageConvert::YUV411ToRGB(unsigned char* yuv, unsigned char* rgb, unsigned int size)
-{
-#if 1
-  //  std::cout << "call optimized ConvertYUV411ToRGB()" << std::endl;
-  for(unsigned int i = size / 4; i; i--) {
-    int U   = (int)((*yuv++ - 128) * 0.354);
-    int U5  = 5*U;
-    int Y0  = *yuv++;
-    int Y1  = *yuv++;
-    int V   = (int)((*yuv++ - 128) * 0.707);
-    int V2  = 2*V;
-    int Y2  = *yuv++;
-    int Y3  = *yuv++;
-    int UV  = - U - V;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    int R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    int G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    int B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-  }
-#else
-  // tres tres lent ....
-
-  unsigned int i=0,j=0;
-  unsigned char r, g, b;
-
-  while( j < size*3/2)
-  {
-    YUVToRGB (yuv[j+1], yuv[j], yuv[j+3], r, g, b);
-    rgb[i]   = r;
-    rgb[i+1] = g;
-    rgb[i+2] = b;
-    i+=3;
-
-    YUVToRGB (yuv[j+2], yuv[j], yuv[j+3], r, g, b);
-    rgb[i]   = r;
-    rgb[i+1] = g;
-    rgb[i+2] = b;
-    i+=3;
-
-    YUVToRGB (yuv[j+4], yuv[j], yuv[j+3], r, g, b);
-    rgb[i]   = r;
-    rgb[i+1] = g;
-    rgb[i+2] = b;
-    i+=3;
-
-    YUVToRGB (yuv[j+5], yuv[j], yuv[j+3], r, g, b);
-    rgb[i]   = r;
-    rgb[i+1] = g;
-    rgb[i+2] = b;
-    i+=3;
-    //TRACE("r= %d g=%d b=%d", r, g, b);
-
-    j+=6;
-  }
-#endif
-
-}
-
-
-
-/*!
-
-  Convert YUV420 into RGBa
-  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
 
 */
-void vpImageConvert::YUV420ToRGBa(unsigned char* yuv, unsigned char* rgba,
-                                  unsigned int width, unsigned int height)
+void vpImageConvert::YUV411ToRGB(unsigned char* yuv, unsigned char* rgb, unsigned int size,
+                                 unsigned int nbThreads)
 {
-  //  std::cout << "call optimized ConvertYUV420ToRGBa()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width*height;
-  unsigned char* iU = yuv + size;
-  unsigned char* iV = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba + 4*width-7;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba -4*width+1;
-    }
-  yuv+=width;
-  rgba+=4*width;
-  }
+  vpYUV411Task task(yuv, rgb, 3, false);
+  vpRunConversion(task, size / 4, nbThreads);
 }
-/*!
 
-  Convert YUV420 into RGB
-  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
 
-*/
-void vpImageConvert::YUV420ToRGB(unsigned char* yuv,
-                                 unsigned char* rgb,
-                                 unsigned int width, unsigned int height)
-{
-  //  std::cout << "call optimized ConvertYUV420ToRGB()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width*height;
-  unsigned char* iU = yuv + size;
-  unsigned char* iV = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
 
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb + 3*width-5;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+/*!
 
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  Convert YUV420 into RGBa
+  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
 
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+*/
+void vpImageConvert::YUV420ToRGBa(unsigned char* yuv, unsigned char* rgba,
+                                  unsigned int width, unsigned int height, unsigned int nbThreads)
+{
+  unsigned int size = width*height;
+  vpYUV420Task task(yuv, yuv + size, yuv + 5*size/4, rgba, width, 4);
+  vpRunConversion(task, height / 2, nbThreads);
+}
+/*!
 
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  Convert YUV420 into RGB
+  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
 
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb -3*width+1;
-    }
-  yuv+=width;
-  rgb+=3*width;
-  }
+*/
+void vpImageConvert::YUV420ToRGB(unsigned char* yuv,
+                                 unsigned char* rgb,
+                                 unsigned int width, unsigned int height, unsigned int nbThreads)
+{
+  unsigned int size = width*height;
+  vpYUV420Task task(yuv, yuv + size, yuv + 5*size/4, rgb, width, 3);
+  vpRunConversion(task, height / 2, nbThreads);
 }
 
 /*!
@@ -1949,11 +1793,7 @@ void vpImageConvert::YUV420ToRGB(unsigned char* yuv,
 */
 void vpImageConvert::YUV420ToGrey(unsigned char* yuv, unsigned char* grey, unsigned int size)
 {
-  for(unsigned int i=0 ; i < size ; i++)
-  {
-    *grey++ = *yuv++;
-  }
-
+  memcpy(grey, yuv, size);
 }
 /*!
 
@@ -2048,196 +1888,32 @@ void vpImageConvert::YUV444ToGrey(unsigned char* yuv, unsigned char* grey, unsig
   Convert YV12 into RGBa
   yuv420 : Y(NxM), V(N/2xM/2), U(N/2xM/2)
 
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
+
 */
 void vpImageConvert::YV12ToRGBa(unsigned char* yuv, unsigned char* rgba,
-                                unsigned int width, unsigned int height)
+                                unsigned int width, unsigned int height, unsigned int nbThreads)
 {
-  //  std::cout << "call optimized ConvertYV12ToRGBa()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
   unsigned int size = width*height;
-  unsigned char* iV = yuv + size;
-  unsigned char* iU = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba + 4*width-7;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba -4*width+1;
-    }
-  yuv+=width;
-  rgba+=4*width;
-  }
+  vpYUV420Task task(yuv, yuv + 5*size/4, yuv + size, rgba, width, 4);
+  vpRunConversion(task, height / 2, nbThreads);
 }
 /*!
 
   Convert YV12 into RGB
   yuv420 : Y(NxM),  V(N/2xM/2), U(N/2xM/2)
 
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
+
 */
 void vpImageConvert::YV12ToRGB(unsigned char* yuv, unsigned char* rgb,
-                               unsigned int height, unsigned int width)
+                               unsigned int width, unsigned int height, unsigned int nbThreads)
 {
-  //  std::cout << "call optimized ConvertYV12ToRGB()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
   unsigned int size = width*height;
-  unsigned char* iV = yuv + size;
-  unsigned char* iU = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb + 3*width-5;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb -3*width+1;
-    }
-  yuv+=width;
-  rgb+=3*width;
-  }
+  vpYUV420Task task(yuv, yuv + 5*size/4, yuv + size, rgb, width, 3);
+  vpRunConversion(task, height / 2, nbThreads);
 }
 
 /*!
@@ -2813,11 +2489,45 @@ void vpImageConvert::YVU9ToRGB(unsigned char* yuv, unsigned char* rgb,
 
 /*!
 
-  Convert RGB into RGBa
+  Convert RGB into RGBa. The alpha channel is set to 0.
+
+  The conversion can be done in place when \e rgb points to the last
+  3*\e size bytes of the \e rgba buffer, i.e. \e rgb = \e rgba + \e size.
+  This allows to read a RGB raster directly in the memory of a vpImage<vpRGBa>.
 
 */
 void vpImageConvert::RGBToRGBa(unsigned char* rgb, unsigned char* rgba, unsigned int size)
 {
+#if VISP_HAVE_SSSE3
+  unsigned int i = 0;
+
+  if(size >= 16) {
+    //Mask to insert a null alpha after each RGB triplet
+    const __m128i mask = _mm_set_epi8(
+          -1, 11, 10, 9, -1, 8, 7, 6, -1, 5, 4, 3, -1, 2, 1, 0
+          );
+
+    //Process 16 pixels per iteration. The 48 input bytes are loaded before
+    //writing the 64 output bytes, that ends where the next input bytes start
+    //in the in place case.
+    for(; i <= size - 16; i+=16) {
+      const __m128i data1 = _mm_loadu_si128((const __m128i*) rgb);
+      const __m128i data2 = _mm_loadu_si128((const __m128i*) (rgb + 16));
+      const __m128i data3 = _mm_loadu_si128((const __m128i*) (rgb + 32));
+
+      _mm_storeu_si128((__m128i*) rgba, _mm_shuffle_epi8(data1, mask));
+      _mm_storeu_si128((__m128i*) (rgba + 16), _mm_shuffle_epi8(_mm_alignr_epi8(data2, data1, 12), mask));
+      _mm_storeu_si128((__m128i*) (rgba + 32), _mm_shuffle_epi8(_mm_alignr_epi8(data3, data2, 8), mask));
+      _mm_storeu_si128((__m128i*) (rgba + 48), _mm_shuffle_epi8(_mm_srli_si128(data3, 4), mask));
+
+      rgb += 48;
+      rgba += 64;
+    }
+  }
+
+  size -= i;
+#endif
+
   unsigned char *pt_input = rgb;
   unsigned char *pt_end = rgb + 3*size;
   unsigned char *pt_output = rgba;
@@ -3102,12 +2812,38 @@ void vpImageConvert::RGBaToGrey(unsigned char* rgba, unsigned char* grey, unsign
 }
 
 /*!
-  Convert from grey to linear RGBa.
+  Convert from grey to linear RGBa. The grey level is copied in the four channels.
+
+  The conversion can be done in place when \e grey points to the last
+  \e size bytes of the \e rgba buffer, i.e. \e grey = \e rgba + 3*\e size.
 
 */
 void
 vpImageConvert::GreyToRGBa(unsigned char* grey, unsigned char* rgba, unsigned int size)
 {
+#if VISP_HAVE_SSE2
+  unsigned int i = 0;
+
+  if(size >= 16) {
+    //Process 16 pixels per iteration, the input is loaded before writing the output
+    for(; i <= size - 16; i+=16) {
+      const __m128i data = _mm_loadu_si128((const __m128i*) grey);
+      const __m128i data_lo = _mm_unpacklo_epi8(data, data);
+      const __m128i data_hi = _mm_unpackhi_epi8(data, data);
+
+      _mm_storeu_si128((__m128i*) rgba, _mm_unpacklo_epi16(data_lo, data_lo));
+      _mm_storeu_si128((__m128i*) (rgba + 16), _mm_unpackhi_epi16(data_lo, data_lo));
+      _mm_storeu_si128((__m128i*) (rgba + 32), _mm_unpacklo_epi16(data_hi, data_hi));
+      _mm_storeu_si128((__m128i*) (rgba + 48), _mm_unpackhi_epi16(data_hi, data_hi));
+
+      grey += 16;
+      rgba += 64;
+    }
+  }
+
+  size -= i;
+#endif
+
   unsigned char *pt_input = grey;
   unsigned char *pt_end = grey + size;
   unsigned char *pt_output = rgba;
@@ -3668,43 +3404,26 @@ void vpImageConvert::computeYCbCrLUT()
     Byte 1: Green
     Byte 2: Blue
 
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
 
 */
-void vpImageConvert::YCbCrToRGB(unsigned char *ycbcr, unsigned char *rgb, unsigned int size)
+void vpImageConvert::YCbCrToRGB(unsigned char *ycbcr, unsigned char *rgb, unsigned int size,
+                                unsigned int nbThreads)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycbcr;
-  unsigned char *pt_rgb = rgb;
-  cbv = pt_ycbcr + 1;
-  crv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
 
-  int col = 0;
-
-	while (size--) {
-    int val_r, val_g, val_b;
-		if (!(col++ % 2)) {
-			cbv = pt_ycbcr + 1;
-			crv = pt_ycbcr + 3;
-		}
-
-		val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
-
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
-
-    *pt_rgb++ = (val_r < 0) ? 0u :
-      ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgb++ = (val_g < 0) ? 0u :
-      ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgb++ = (val_b < 0) ? 0u :
-      ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
+  vpYCbCrChroma chroma(vpImageConvert::vpCrr, vpImageConvert::vpCgb, vpImageConvert::vpCgr, vpImageConvert::vpCbb);
+  vpPacked422Task<vpYCbCrChroma> task(ycbcr, rgb, 3, false, true, true, chroma);
+  vpRunConversion(task, size / 2, nbThreads);
 
-    pt_ycbcr += 2;
-	}
+  if (size % 2) {
+    // The last pixel uses the chroma samples of its pair
+    const unsigned char *s = ycbcr + 2*(size-1);
+    int cr, cg, cb;
+    chroma.compute(s[1], s[3], cr, cg, cb);
+    vpWritePixel(rgb + 3*(size-1), s[0], cr, cg, cb, 3, false);
+  }
 }
 
 /*!
@@ -3726,43 +3445,25 @@ void vpImageConvert::YCbCrToRGB(unsigned char *ycbcr, unsigned char *rgb, unsign
     Byte 2: Blue
     Byte 3: -
 
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
 
 */
-void vpImageConvert::YCbCrToRGBa(unsigned char *ycbcr, unsigned char *rgba, unsigned int size)
+void vpImageConvert::YCbCrToRGBa(unsigned char *ycbcr, unsigned char *rgba, unsigned int size,
+                                 unsigned int nbThreads)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycbcr;
-  unsigned char *pt_rgba = rgba;
-  cbv = pt_ycbcr + 1;
-  crv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
 
-  int col = 0;
-
-  while (size--) {
-    int val_r, val_g, val_b;
-    if (!(col++ % 2)) {
-      cbv = pt_ycbcr + 1;
-      crv = pt_ycbcr + 3;
-    }
-
-    val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
-
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
+  vpYCbCrChroma chroma(vpImageConvert::vpCrr, vpImageConvert::vpCgb, vpImageConvert::vpCgr, vpImageConvert::vpCbb);
+  vpPacked422Task<vpYCbCrChroma> task(ycbcr, rgba, 4, false, true, true, chroma);
+  vpRunConversion(task, size / 2, nbThreads);
 
-    *pt_rgba++ = (val_r < 0) ? 0u :
-      ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgba++ = (val_g < 0) ? 0u :
-      ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgba++ = (val_b < 0) ? 0u :
-      ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
-    *pt_rgba++ = 0;
-
-    pt_ycbcr += 2;
+  if (size % 2) {
+    // The last pixel uses the chroma samples of its pair
+    const unsigned char *s = ycbcr + 2*(size-1);
+    int cr, cg, cb;
+    chroma.compute(s[1], s[3], cr, cg, cb);
+    vpWritePixel(rgba + 4*(size-1), s[0], cr, cg, cb, 4, false);
   }
 }
 
@@ -3785,14 +3486,7 @@ void vpImageConvert::YCbCrToRGBa(unsigned char *ycbcr, unsigned char *rgba, unsi
 */
 void vpImageConvert::YCbCrToGrey(unsigned char* yuv, unsigned char* grey, unsigned int size)
 {
- unsigned int i=0,j=0;
-
- while( j < size*2)
- {
-   grey[i++] = yuv[j];
-   grey[i++] = yuv[j+2];
-   j+=4;
- }
+  vpExtractBytes(yuv, grey, size, 0);
 }
 
 /*!
@@ -3812,41 +3506,25 @@ void vpImageConvert::YCbCrToGrey(unsigned char* yuv, unsigned char* grey, unsign
     Byte 1: Green
     Byte 2: Blue
 
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
+
 */
-void vpImageConvert::YCrCbToRGB(unsigned char *ycrcb, unsigned char *rgb, unsigned int size)
+void vpImageConvert::YCrCbToRGB(unsigned char *ycrcb, unsigned char *rgb, unsigned int size,
+                                unsigned int nbThreads)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycrcb;
-  unsigned char *pt_rgb = rgb;
-  crv = pt_ycbcr + 1;
-  cbv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
 
-  int col = 0;
-
-  while (size--) {
-    int val_r, val_g, val_b;
-    if (!(col++ % 2)) {
-      crv = pt_ycbcr + 1;
-      cbv = pt_ycbcr + 3;
-    }
-
-    val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
+  vpYCbCrChroma chroma(vpImageConvert::vpCrr, vpImageConvert::vpCgb, vpImageConvert::vpCgr, vpImageConvert::vpCbb);
+  vpPacked422Task<vpYCbCrChroma> task(ycrcb, rgb, 3, false, true, false, chroma);
+  vpRunConversion(task, size / 2, nbThreads);
 
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
-
-    *pt_rgb++ = (val_r < 0) ? 0u :
-      ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgb++ = (val_g < 0) ? 0u :
-      ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgb++ = (val_b < 0) ? 0u :
-      ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
-
-    pt_ycbcr += 2;
+  if (size % 2) {
+    // The last pixel uses the chroma samples of its pair
+    const unsigned char *s = ycrcb + 2*(size-1);
+    int cr, cg, cb;
+    chroma.compute(s[3], s[1], cr, cg, cb);
+    vpWritePixel(rgb + 3*(size-1), s[0], cr, cg, cb, 3, false);
   }
 }
 /*!
@@ -3867,43 +3545,25 @@ void vpImageConvert::YCrCbToRGB(unsigned char *ycrcb, unsigned char *rgb, unsign
     Byte 2: Blue
     Byte 3: -
 
+  \param nbThreads : Number of bands the image is split in. When greater than 1,
+  the bands are converted in parallel by the threads of vpThreadPool.
 
 */
-void vpImageConvert::YCrCbToRGBa(unsigned char *ycrcb, unsigned char *rgba, unsigned int size)
+void vpImageConvert::YCrCbToRGBa(unsigned char *ycrcb, unsigned char *rgba, unsigned int size,
+                                 unsigned int nbThreads)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycrcb;
-  unsigned char *pt_rgba = rgba;
-  crv = pt_ycbcr + 1;
-  cbv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
 
-  int col = 0;
-
-  while (size--) {
-    int val_r, val_g, val_b;
-    if (!(col++ % 2)) {
-      crv = pt_ycbcr + 1;
-      cbv = pt_ycbcr + 3;
-    }
-
-    val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
-
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
-
-    *pt_rgba++ = (val_r < 0) ? 0u :
-      ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgba++ = (val_g < 0) ? 0u :
-      ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgba++ = (val_b < 0) ? 0u :
-      ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
-    *pt_rgba++ = 0;
+  vpYCbCrChroma chroma(vpImageConvert::vpCrr, vpImageConvert::vpCgb, vpImageConvert::vpCgr, vpImageConvert::vpCbb);
+  vpPacked422Task<vpYCbCrChroma> task(ycrcb, rgba, 4, false, true, false, chroma);
+  vpRunConversion(task, size / 2, nbThreads);
 
-    pt_ycbcr += 2;
+  if (size % 2) {
+    // The last pixel uses the chroma samples of its pair
+    const unsigned char *s = ycrcb + 2*(size-1);
+    int cr, cg, cb;
+    chroma.compute(s[3], s[1], cr, cg, cb);
+    vpWritePixel(rgba + 4*(size-1), s[0], cr, cg, cb, 4, false);
   }
 }
 
@@ -4073,13 +3733,8 @@ void vpImageConvert::merge(const vpImage<unsigned char> *R,
 */
 void vpImageConvert::MONO16ToGrey(unsigned char *grey16, unsigned char *grey, unsigned int size)
 {
-  int i = (((int)size)<<1)-1;
-  int j = (int)size-1;
-
-  while (i >= 0) {
-    int y = grey16[i--];
-    grey[j--] = static_cast<unsigned char>( (y+(grey16[i--]<<8))>>8 );
-  }
+  // The most significant byte of each pixel is the first one
+  vpExtractBytes(grey16, grey, size, 0);
 }
 
 /*!
@@ -4094,17 +3749,28 @@ void vpImageConvert::MONO16ToGrey(unsigned char *grey16, unsigned char *grey, un
 */
 void vpImageConvert::MONO16ToRGBa(unsigned char *grey16, unsigned char *rgba, unsigned int size)
 {
-  int i = (((int)size)<<1)-1;
-  int j = (int)(size*4-1);
-
-  while (i >= 0) {
-    int y = grey16[i--];
-    unsigned char v = static_cast<unsigned char>( (y+(grey16[i--]<<8))>>8 );
-    rgba[j--] = 0;
-    rgba[j--] = v;
-    rgba[j--] = v;
-    rgba[j--] = v;
+  // Pixels are converted from the last one, which allows an in place conversion
+  unsigned int i = size;
+#if VISP_HAVE_SSE2
+  const unsigned int nb_blocks = size / 16;
+  i = nb_blocks * 16;
+#endif
+  for (unsigned int k = size; k > i; k--) {
+    unsigned char v = grey16[2*(k-1)];
+    rgba[4*(k-1)] = v;
+    rgba[4*(k-1)+1] = v;
+    rgba[4*(k-1)+2] = v;
+    rgba[4*(k-1)+3] = 0;
+  }
+#if VISP_HAVE_SSE2
+  const __m128i mask = _mm_set1_epi16(0x00FF);
+  for (; i > 0; i -= 16) {
+    const __m128i a = _mm_loadu_si128((const __m128i *)(grey16 + 2*(i-16)));
+    const __m128i b = _mm_loadu_si128((const __m128i *)(grey16 + 2*(i-16) + 16));
+    const __m128i v = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+    vpStorePixels(rgba + 4*(i-16), v, v, v, 4, false);
   }
+#endif
 }
 
 void vpImageConvert::HSV2RGB(const double *hue_, const double *saturation_, const double *value_, unsigned char *rgb,
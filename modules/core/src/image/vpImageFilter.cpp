@@ -37,13 +37,172 @@
 
 #include <visp3/core/vpImageFilter.h>
 #include <visp3/core/vpImageConvert.h>
-#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-#  include <opencv2/imgproc/imgproc.hpp>
-#elif defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020101)
-#  include <opencv2/imgproc/imgproc_c.h>
-#elif defined(VISP_HAVE_OPENCV)
-#  include <cv.h>
+
+#include <cmath>
+#include <vector>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Index of the pixel used for coordinate i in [0, n). Outside, the border is
+    either replicated (aaa|abcd|ddd) or reflected without repeating the border
+    pixel (cb|abcd|cb).
+  */
+  inline unsigned int vpBorderIndex(int i, unsigned int n, bool reflect)
+  {
+    const int last = (int)n - 1;
+    if (reflect) {
+      if (i < 0) i = -i;
+      if (i > last) i = 2 * last - i;
+    }
+    if (i < 0) i = 0;
+    if (i > last) i = last;
+    return (unsigned int)i;
+  }
+
+  /*
+    Horizontal pass of an integer kernel of odd size on a row:
+    out[j] = (sum_k coeffs[k] * in[j+k-size/2] + rounding) >> shift.
+    The row is first copied with its borders so that the inner loop has no test.
+    The sums are computed on 16 bits: the caller ensures that they fit in an
+    int16_t, or in an uint16_t when shift is not null.
+  */
+  void vpFilterRowInt(const unsigned char *in, unsigned int width, const int *coeffs, unsigned int size,
+                      unsigned int shift, bool reflect, std::vector<unsigned char> &padded, int16_t *out)
+  {
+    const unsigned int half = size / 2;
+    padded.resize(width + 2 * half);
+    for (unsigned int j = 0; j < half; j++) {
+      padded[j] = in[vpBorderIndex((int)j - (int)half, width, reflect)];
+      padded[width + half + j] = in[vpBorderIndex((int)(width + j), width, reflect)];
+    }
+    memcpy(&padded[half], in, width);
+
+    const int rounding = shift ? (1 << (shift - 1)) : 0;
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16((short)rounding);
+    for (; j + 8 <= width; j += 8) {
+      __m128i acc = _mm_setzero_si128();
+      for (unsigned int k = 0; k < size; k++) {
+        if (coeffs[k] == 0)
+          continue;
+        const __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(&padded[j + k])), zero);
+        acc = _mm_add_epi16(acc, _mm_mullo_epi16(v, _mm_set1_epi16((short)coeffs[k])));
+      }
+      if (shift)
+        acc = _mm_srli_epi16(_mm_add_epi16(acc, round), (int)shift);
+      _mm_storeu_si128((__m128i *)(out + j), acc);
+    }
+#endif
+    for (; j < width; j++) {
+      const unsigned char *p = &padded[j];
+      int sum = 0;
+      for (unsigned int k = 0; k < size; k++)
+        sum += coeffs[k] * p[k];
+      out[j] = (int16_t)((sum + rounding) >> shift);
+    }
+  }
+
+  /*
+    Vertical pass of an integer kernel, out[j] = sum_k coeffs[k] * rows[k][j],
+    computed on 16 bits: the caller ensures that the sum cannot overflow.
+  */
+  void vpFilterColumnsInt16(const int16_t * const *rows, const int *coeffs, unsigned int size, unsigned int width,
+                            int16_t *out)
+  {
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    for (; j + 8 <= width; j += 8) {
+      __m128i acc = _mm_setzero_si128();
+      for (unsigned int k = 0; k < size; k++) {
+        if (coeffs[k] == 0)
+          continue;
+        const __m128i v = _mm_loadu_si128((const __m128i *)(rows[k] + j));
+        acc = _mm_add_epi16(acc, _mm_mullo_epi16(v, _mm_set1_epi16((short)coeffs[k])));
+      }
+      _mm_storeu_si128((__m128i *)(out + j), acc);
+    }
+#endif
+    for (; j < width; j++) {
+      int sum = 0;
+      for (unsigned int k = 0; k < size; k++)
+        sum += coeffs[k] * rows[k][j];
+      out[j] = (int16_t)sum;
+    }
+  }
+
+  /*
+    Vertical pass of the fixed-point Gaussian kernel. The rows are in Q7 and the
+    coefficients in Q8, the sum is computed on 32 bits and rounded to 8 bits.
+  */
+  void vpFilterColumnsGauss(const int16_t * const *rows, const int *coeffs, unsigned int size, unsigned int width,
+                            unsigned char *out)
+  {
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    const __m128i rounding = _mm_set1_epi32(1 << 14);
+    for (; j + 8 <= width; j += 8) {
+      __m128i acc_lo = rounding, acc_hi = rounding;
+      // Two rows at a time: _mm_madd_epi16 multiplies the interleaved rows by the
+      // interleaved coefficients and adds the pairs of products on 32 bits
+      for (unsigned int k = 0; k < size; k += 2) {
+        const __m128i a = _mm_loadu_si128((const __m128i *)(rows[k] + j));
+        __m128i b = _mm_setzero_si128();
+        int coeff_b = 0;
+        if (k + 1 < size) {
+          b = _mm_loadu_si128((const __m128i *)(rows[k + 1] + j));
+          coeff_b = coeffs[k + 1];
+        }
+        const __m128i c = _mm_set1_epi32((int)(((unsigned int)coeff_b << 16) | ((unsigned int)coeffs[k] & 0xffff)));
+        acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c));
+        acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c));
+      }
+      const __m128i res = _mm_packs_epi32(_mm_srai_epi32(acc_lo, 15), _mm_srai_epi32(acc_hi, 15));
+      _mm_storel_epi64((__m128i *)(out + j), _mm_packus_epi16(res, res));
+    }
 #endif
+    for (; j < width; j++) {
+      int sum = 1 << 14;
+      for (unsigned int k = 0; k < size; k++)
+        sum += coeffs[k] * rows[k][j];
+      sum >>= 15;
+      out[j] = (unsigned char)(sum < 0 ? 0 : (sum > 255 ? 255 : sum));
+    }
+  }
+
+  /*
+    Separable integer filter: horizontal kernel hcoeffs then vertical kernel
+    vcoeffs, both of the same odd size, with replicated borders.
+  */
+  void vpSeparableFilterInt16(const vpImage<unsigned char> &I, const int *hcoeffs, const int *vcoeffs, unsigned int size,
+                              std::vector<int16_t> &tmp, vpImage<int16_t> &dI)
+  {
+    const unsigned int height = I.getHeight(), width = I.getWidth(), half = size / 2;
+    dI.resize(height, width);
+    if (I.getSize() == 0)
+      return;
+
+    std::vector<unsigned char> padded;
+    tmp.resize(height * width);
+    for (unsigned int i = 0; i < height; i++)
+      vpFilterRowInt(I[i], width, hcoeffs, size, 0, false, padded, &tmp[i * width]);
+
+    std::vector<const int16_t *> rows(size);
+    for (unsigned int i = 0; i < height; i++) {
+      for (unsigned int k = 0; k < size; k++)
+        rows[k] = &tmp[vpBorderIndex((int)(i + k) - (int)half, height, false) * width];
+      vpFilterColumnsInt16(&rows[0], vcoeffs, size, width, dI[i]);
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /*!
   Apply a filter to an image.
@@ -129,7 +288,6 @@ vpImageFilter::filter(const vpImage<double> &I,
 
 }
 
-#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
 /*!
   Apply the Canny edge operator on the image \e Isrc and return the resulting
   image \e Ires.
@@ -143,7 +301,6 @@ vpImageFilter::filter(const vpImage<double> &I,
 
 int main()
 {
-#if VISP_HAVE_OPENCV_VERSION >= 0x020100 // Canny uses OpenCV >=2.1.0
   // Constants for the Canny operator.
   const unsigned int gaussianFilterSize = 5;
   const double thresholdCanny = 15;
@@ -157,47 +314,216 @@ int main()
 
   //Apply the Canny edge operator and set the Icanny image.
   vpImageFilter::canny(Isrc, Icanny, gaussianFilterSize, thresholdCanny, apertureSobel);
-#endif
   return (0);
 }
   \endcode
 
   \param Isrc : Image to apply the Canny edge detector to.
-  \param Ires : Filtered image (255 means an edge, 0 otherwise).
+  \param Ires : Filtered image (255 means an edge, 0 otherwise). It can be the
+  same image as \e Isrc.
   \param gaussianFilterSize : The size of the mask of the Gaussian filter to
   apply (an odd number).
   \param thresholdCanny : The threshold for the Canny operator. Only value
   greater than this value are marked as an edge).
-  \param apertureSobel : Size of the mask for the Sobel operator (odd number).
+  \param apertureSobel : Size of the mask for the Sobel operator (3 or 5).
+
+  \sa canny(const vpImage<unsigned char>&, vpImage<unsigned char>&, const unsigned int, const double, const double, const unsigned int)
 */
 void
-vpImageFilter:: canny(const vpImage<unsigned char>& Isrc,
-                      vpImage<unsigned char>& Ires,
-                      const unsigned int gaussianFilterSize,
-                      const double thresholdCanny,
-                      const unsigned int apertureSobel)
+vpImageFilter::canny(const vpImage<unsigned char>& Isrc,
+                     vpImage<unsigned char>& Ires,
+                     const unsigned int gaussianFilterSize,
+                     const double thresholdCanny,
+                     const unsigned int apertureSobel)
 {
-#if (VISP_HAVE_OPENCV_VERSION < 0x020408)
-  IplImage* img_ipl = NULL;
-  vpImageConvert::convert(Isrc, img_ipl);
-  IplImage* edges_ipl;
-  edges_ipl = cvCreateImage(cvSize(img_ipl->width, img_ipl->height), img_ipl->depth, img_ipl->nChannels);
-
-  cvSmooth(img_ipl, img_ipl, CV_GAUSSIAN, (int)gaussianFilterSize, (int)gaussianFilterSize, 0, 0);
-  cvCanny(img_ipl, edges_ipl, thresholdCanny, thresholdCanny, (int)apertureSobel);
-
-  vpImageConvert::convert(edges_ipl, Ires);
-  cvReleaseImage(&img_ipl);
-  cvReleaseImage(&edges_ipl);
-#else
-  cv::Mat img_cvmat, edges_cvmat;
-  vpImageConvert::convert(Isrc, img_cvmat);
-  cv::GaussianBlur(img_cvmat, img_cvmat, cv::Size((int)gaussianFilterSize, (int)gaussianFilterSize), 0, 0);
-  cv::Canny(img_cvmat, edges_cvmat, thresholdCanny, thresholdCanny, (int)apertureSobel);
-  vpImageConvert::convert(edges_cvmat, Ires);
-#endif
+  vpImageFilter::canny(Isrc, Ires, gaussianFilterSize, thresholdCanny, thresholdCanny, apertureSobel);
+}
+
+/*!
+  Apply the Canny edge operator with hysteresis on the image \e Isrc and
+  return the resulting image \e Ires.
+
+  The implementation doesn't need OpenCV. The image is smoothed with the
+  integer Gaussian filter of gaussianBlur(const vpImage<unsigned char> &, vpImage<unsigned char> &, unsigned int, double),
+  then the gradient is computed by sobel() on 16-bit integers. Its L1 norm
+  \f$|I_x|+|I_y|\f$ is kept where it is a local maximum along the gradient
+  direction (non-maximum suppression). Pixels whose norm is greater than
+  \e upperThreshold are edges, as well as the pixels whose norm is greater
+  than \e lowerThreshold and that are connected to an edge (hysteresis).
+
+  \param Isrc : Image to apply the Canny edge detector to.
+  \param Ires : Filtered image (255 means an edge, 0 otherwise). It can be the
+  same image as \e Isrc.
+  \param gaussianFilterSize : The size of the mask of the Gaussian filter to
+  apply (an odd number). Use 1 or 0 to skip the smoothing.
+  \param lowerThreshold : Gradient norm above which a pixel connected to an edge is also an edge.
+  \param upperThreshold : Gradient norm above which a pixel is an edge.
+  \param apertureSobel : Size of the mask for the Sobel operator (3 or 5).
+*/
+void
+vpImageFilter::canny(const vpImage<unsigned char>& Isrc,
+                     vpImage<unsigned char>& Ires,
+                     const unsigned int gaussianFilterSize,
+                     const double lowerThreshold,
+                     const double upperThreshold,
+                     const unsigned int apertureSobel)
+{
+  const unsigned int height = Isrc.getHeight(), width = Isrc.getWidth();
+
+  vpImage<unsigned char> Iblur;
+  const vpImage<unsigned char> *I = &Isrc;
+  if (gaussianFilterSize > 1) {
+    vpImageFilter::gaussianBlur(Isrc, Iblur, gaussianFilterSize);
+    I = &Iblur;
+  }
+  vpImage<int16_t> dIx, dIy;
+  vpImageFilter::sobel(*I, dIx, dIy, apertureSobel);
+
+  // Gradient norm with a null border of one pixel, so that the neighbours
+  // of the image pixels can be read without test
+  const unsigned int stride = width + 2;
+  std::vector<int> mag((height + 2) * stride, 0);
+  for (unsigned int i = 0; i < height; i++) {
+    const int16_t *gx = dIx[i], *gy = dIy[i];
+    int *m = &mag[(i + 1) * stride + 1];
+    for (unsigned int j = 0; j < width; j++)
+      m[j] = std::abs((int)gx[j]) + std::abs((int)gy[j]);
+  }
+
+  int low = (int)std::floor(lowerThreshold), high = (int)std::floor(upperThreshold);
+  if (low > high)
+    std::swap(low, high);
+
+  // Non-maximum suppression. The direction of the gradient is quantized in 4
+  // sectors using tan(22.5 deg) and tan(67.5 deg) in Q15 fixed point.
+  // map is 0 for non edges, 1 for weak edges and 2 for edges
+  const int tg22 = (int)(0.4142135623730950488016887242097 * (1 << 15) + 0.5);
+  std::vector<unsigned char> map((height + 2) * stride, 0);
+  std::vector<unsigned int> stack;
+  stack.reserve(width * height / 16);
+  for (unsigned int i = 0; i < height; i++) {
+    const int16_t *gx = dIx[i], *gy = dIy[i];
+    for (unsigned int j = 0; j < width; j++) {
+      const unsigned int p = (i + 1) * stride + j + 1;
+      const int m = mag[p];
+      if (m <= low)
+        continue;
+
+      const int xs = gx[j], ys = gy[j];
+      const int x = std::abs(xs);
+      const int y = std::abs(ys) << 15;
+      const int tg22x = x * tg22;
+      bool isMax;
+      if (y < tg22x) {
+        isMax = m > mag[p - 1] && m >= mag[p + 1];
+      }
+      else {
+        const int tg67x = tg22x + (x << 16);
+        if (y > tg67x) {
+          isMax = m > mag[p - stride] && m >= mag[p + stride];
+        }
+        else {
+          const int s = (xs ^ ys) < 0 ? -1 : 1;
+          isMax = m > mag[(unsigned int)((int)(p - stride) - s)] && m > mag[(unsigned int)((int)(p + stride) + s)];
+        }
+      }
+
+      if (isMax) {
+        if (m > high) {
+          map[p] = 2;
+          stack.push_back(p);
+        }
+        else {
+          map[p] = 1;
+        }
+      }
+    }
+  }
+
+  // Hysteresis: the weak edges connected to an edge become edges
+  const int offsets[8] = { -(int)stride - 1, -(int)stride, -(int)stride + 1, -1, 1,
+                           (int)stride - 1, (int)stride, (int)stride + 1 };
+  while (! stack.empty()) {
+    const unsigned int p = stack.back();
+    stack.pop_back();
+    for (unsigned int k = 0; k < 8; k++) {
+      const unsigned int q = (unsigned int)((int)p + offsets[k]);
+      if (map[q] == 1) {
+        map[q] = 2;
+        stack.push_back(q);
+      }
+    }
+  }
+
+  Ires.resize(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    const unsigned char *mp = &map[(i + 1) * stride + 1];
+    unsigned char *res = Ires[i];
+    for (unsigned int j = 0; j < width; j++)
+      res[j] = (mp[j] == 2) ? 255 : 0;
+  }
+}
+
+/*!
+  Compute the Sobel derivatives of an image on 16-bit integers.
+
+  The kernels are separable: the derivative along one axis is the product of
+  the derivative kernel [-1 0 1] (or [-1 -2 0 2 1]) along this axis and of the
+  smoothing kernel [1 2 1] (or [1 4 6 4 1]) along the other axis. The
+  results are not normalized, so that they are exact. The borders are replicated.
+
+  \param I : Input image.
+  \param dIx : Derivative along the columns (x axis).
+  \param dIy : Derivative along the rows (y axis).
+  \param apertureSize : Size of the kernels, 3 or 5.
+
+  \exception vpImageException::incorrectInitializationError : If the size is not 3 or 5.
+*/
+void vpImageFilter::sobel(const vpImage<unsigned char> &I, vpImage<int16_t> &dIx, vpImage<int16_t> &dIy,
+                          const unsigned int apertureSize)
+{
+  static const int smooth3[3] = { 1, 2, 1 };
+  static const int deriv3[3] = { -1, 0, 1 };
+  static const int smooth5[5] = { 1, 4, 6, 4, 1 };
+  static const int deriv5[5] = { -1, -2, 0, 2, 1 };
+
+  const int *smooth, *deriv;
+  if (apertureSize == 3) {
+    smooth = smooth3;
+    deriv = deriv3;
+  }
+  else if (apertureSize == 5) {
+    smooth = smooth5;
+    deriv = deriv5;
+  }
+  else {
+    throw (vpImageException(vpImageException::incorrectInitializationError,
+                            "Bad Sobel aperture size %d: only 3 and 5 are supported", apertureSize));
+  }
+
+  // With a kernel of size 5 and 8-bit pixels the values are below 255*16*3 = 12240
+  std::vector<int16_t> tmp;
+  vpSeparableFilterInt16(I, deriv, smooth, apertureSize, tmp, dIx);
+  vpSeparableFilterInt16(I, smooth, deriv, apertureSize, tmp, dIy);
+}
+
+/*!
+  Compute the Sobel derivatives of an image as float values.
+
+  \sa sobel(const vpImage<unsigned char> &, vpImage<int16_t> &, vpImage<int16_t> &, const unsigned int)
+*/
+void vpImageFilter::sobel(const vpImage<unsigned char> &I, vpImage<float> &dIx, vpImage<float> &dIy,
+                          const unsigned int apertureSize)
+{
+  vpImage<int16_t> dIx16, dIy16;
+  vpImageFilter::sobel(I, dIx16, dIy16, apertureSize);
+  dIx.resize(I.getHeight(), I.getWidth());
+  dIy.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    dIx.bitmap[i] = dIx16.bitmap[i];
+    dIy.bitmap[i] = dIy16.bitmap[i];
+  }
 }
-#endif
 
 /*!
   Apply a separable filter.
@@ -334,6 +660,58 @@ void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<double
   delete[] fg;
 }
 
+/*!
+  Apply a Gaussian blur to an image, computed with integers.
+
+  The normalized kernel of getGaussianKernel() is converted to 8-bit fixed
+  point coefficients and applied along the rows, then along the columns, with
+  intermediate values kept on 16 bits. The borders are reflected without
+  repeating the border pixel (cb|abcd|cb). Compared to
+  gaussianBlur(const vpImage<unsigned char> &, vpImage<double>&, unsigned int, double, bool),
+  the result is rounded to the nearest integer, with an error of at most one gray level
+  away from the borders.
+
+  \param I : Input image.
+  \param GI : Filtered image. It can be the same image as \e I.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+*/
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<unsigned char>& GI, unsigned int size, double sigma)
+{
+  std::vector<double> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, true);
+
+  // Coefficients in Q8 whose sum is exactly 256
+  const unsigned int half = size / 2;
+  std::vector<int> coeffs(size);
+  int sum = 0;
+  for (unsigned int k = 0; k < size; k++) {
+    coeffs[k] = vpMath::round(fg[k > half ? k - half : half - k] * 256.);
+    sum += coeffs[k];
+  }
+  coeffs[half] += 256 - sum;
+
+  const unsigned int height = I.getHeight(), width = I.getWidth();
+  if (I.getSize() == 0) {
+    GI.resize(height, width);
+    return;
+  }
+
+  // Horizontal pass in Q7: 255*256/2 fits in 16 bits
+  std::vector<int16_t> tmp(height * width);
+  std::vector<unsigned char> padded;
+  for (unsigned int i = 0; i < height; i++)
+    vpFilterRowInt(I[i], width, &coeffs[0], size, 1, true, padded, &tmp[i * width]);
+
+  GI.resize(height, width);
+  std::vector<const int16_t *> rows(size);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int k = 0; k < size; k++)
+      rows[k] = &tmp[vpBorderIndex((int)(i + k) - (int)half, height, true) * width];
+    vpFilterColumnsGauss(&rows[0], &coeffs[0], size, width, GI[i]);
+  }
+}
+
 /*!
   Apply a Gaussian blur to a double image.
   \param I : Input double image.
@@ -37,11 +37,252 @@
 
 #include <visp3/core/vpImageTools.h>
 
+#include <algorithm>
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+#  include <visp3/core/vpMutex.h>
+#endif
+
 #if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
 #  include <emmintrin.h>
 #  define VISP_HAVE_SSE2 1
 #endif
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Number of bits of the sub-pixel position of the source points, and of the
+// interpolation weights (their sum is 1 << vpRemapWeightBits).
+const int vpRemapCoordBits = 7;
+const int vpRemapWeightBits = 2*vpRemapCoordBits;
+
+// Compute the rows [start, end) of an undistortion map, with the same
+// distortion model as vpImageTools::undistort().
+class vpUndistortMapTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpUndistortMapTask(const vpCameraParameters &cam, unsigned int width, unsigned int height,
+                     int *offsets, short *weights)
+    : m_cam(cam), m_width(width), m_height(height), m_offsets(offsets), m_weights(weights)
+  {}
+
+  void run(unsigned int start, unsigned int end)
+  {
+    const int width = (int)m_width;
+    const int height = (int)m_height;
+    const int one = 1 << vpRemapCoordBits;
+
+    double u0 = m_cam.get_u0();
+    double v0 = m_cam.get_v0();
+    double invpx = 1.0/m_cam.get_px();
+    double invpy = 1.0/m_cam.get_py();
+    double kud = m_cam.get_kud();
+
+    double kud_px2 = kud * invpx * invpx;
+    double kud_py2 = kud * invpy * invpy;
+
+    for (unsigned int v = start; v < end; v++) {
+      double deltav = v - v0;
+      double fr1 = 1.0 + kud_py2 * deltav * deltav;
+      int *offsets = m_offsets + v*m_width;
+      short *weights = m_weights + 4*v*m_width;
+
+      for (int u = 0; u < width; u++, offsets++, weights += 4) {
+        double deltau = u - u0;
+        double fr2 = fr1 + kud_px2 * deltau * deltau;
+
+        double u_double = deltau * fr2 + u0;
+        double v_double = deltav * fr2 + v0;
+
+        // Same neighbourhood as undistort(): the source points in ]-1, 0[
+        // use the first row or column
+        int u_round = (int)u_double;
+        int v_round = (int)v_double;
+        if ((-1 < u_double) && (-1 < v_double) && (u_round < width - 1) && (v_round < height - 1)) {
+          int du = (std::max)(0, (int)((u_double - u_round) * one + 0.5));
+          int dv = (std::max)(0, (int)((v_double - v_round) * one + 0.5));
+          *offsets = v_round*width + u_round;
+          weights[0] = (short)((one - du) * (one - dv));
+          weights[1] = (short)(du * (one - dv));
+          weights[2] = (short)((one - du) * dv);
+          weights[3] = (short)(du * dv);
+        }
+        else {
+          // Null weights on the 2x2 block at the origin, which is only read
+          // when the image has at least 2 rows and 2 columns (see remap())
+          *offsets = 0;
+          weights[0] = weights[1] = weights[2] = weights[3] = 0;
+        }
+      }
+    }
+  }
+
+private:
+  const vpCameraParameters &m_cam;
+  unsigned int m_width;
+  unsigned int m_height;
+  int *m_offsets;
+  short *m_weights;
+};
+
+// Apply an undistortion map to the rows [start, end) of a grey level image.
+class vpRemapGreyTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpRemapGreyTask(const unsigned char *src, unsigned char *dst, unsigned int width,
+                  const int *offsets, const short *weights)
+    : m_src(src), m_dst(dst), m_width(width), m_offsets(offsets), m_weights(weights)
+  {}
+
+  void run(unsigned int start, unsigned int end)
+  {
+    const unsigned int width = m_width;
+    for (unsigned int i = start; i < end; i++) {
+      const int *offsets = m_offsets + i*width;
+      const short *weights = m_weights + 4*i*width;
+      unsigned char *dst = m_dst + i*width;
+      unsigned int j = 0;
+
+#if VISP_HAVE_SSE2
+      // 4 pixels per iteration: the 2x2 neighbourhoods are gathered in the
+      // order of the weights, so that _mm_madd_epi16 gives the sums of the
+      // top and bottom rows of each pixel
+      const __m128i round = _mm_set1_epi32(1 << (vpRemapWeightBits - 1));
+      for (; j + 4 <= width; j += 4, offsets += 4, weights += 16) {
+        const unsigned char *p0 = m_src + offsets[0];
+        const unsigned char *p1 = m_src + offsets[1];
+        const unsigned char *p2 = m_src + offsets[2];
+        const unsigned char *p3 = m_src + offsets[3];
+        const __m128i a = _mm_setr_epi16(p0[0], p0[1], p0[width], p0[width+1],
+                                         p1[0], p1[1], p1[width], p1[width+1]);
+        const __m128i b = _mm_setr_epi16(p2[0], p2[1], p2[width], p2[width+1],
+                                         p3[0], p3[1], p3[width], p3[width+1]);
+        const __m128i sa = _mm_madd_epi16(a, _mm_loadu_si128((const __m128i*) weights));
+        const __m128i sb = _mm_madd_epi16(b, _mm_loadu_si128((const __m128i*) (weights + 8)));
+        const __m128i top = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(sa), _mm_castsi128_ps(sb), _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m128i bottom = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(sa), _mm_castsi128_ps(sb), _MM_SHUFFLE(3, 1, 3, 1)));
+        __m128i res = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(top, bottom), round), vpRemapWeightBits);
+        res = _mm_packs_epi32(res, res);
+        res = _mm_packus_epi16(res, res);
+        const int pixels = _mm_cvtsi128_si32(res);
+        memcpy(dst + j, &pixels, 4);
+      }
+#endif
+
+      for (; j < width; j++, offsets++, weights += 4) {
+        const unsigned char *p = m_src + *offsets;
+        int sum = p[0]*weights[0] + p[1]*weights[1] + p[width]*weights[2] + p[width+1]*weights[3];
+        dst[j] = (unsigned char)((sum + (1 << (vpRemapWeightBits - 1))) >> vpRemapWeightBits);
+      }
+    }
+  }
+
+private:
+  const unsigned char *m_src;
+  unsigned char *m_dst;
+  unsigned int m_width;
+  const int *m_offsets;
+  const short *m_weights;
+};
+
+// Apply an undistortion map to the rows [start, end) of a color image, the
+// four components being interpolated with the same weights.
+class vpRemapRGBaTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpRemapRGBaTask(const vpRGBa *src, vpRGBa *dst, unsigned int width,
+                  const int *offsets, const short *weights)
+    : m_src(src), m_dst(dst), m_width(width), m_offsets(offsets), m_weights(weights)
+  {}
+
+  void run(unsigned int start, unsigned int end)
+  {
+    const unsigned int width = m_width;
+    for (unsigned int i = start; i < end; i++) {
+      const int *offsets = m_offsets + i*width;
+      const short *weights = m_weights + 4*i*width;
+      vpRGBa *dst = m_dst + i*width;
+
+#if VISP_HAVE_SSE2
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i round = _mm_set1_epi32(1 << (vpRemapWeightBits - 1));
+      for (unsigned int j = 0; j < width; j++, offsets++, weights += 4) {
+        const vpRGBa *p = m_src + *offsets;
+        int p00, p01, p10, p11;
+        memcpy(&p00, p, 4);
+        memcpy(&p01, p + 1, 4);
+        memcpy(&p10, p + width, 4);
+        memcpy(&p11, p + width + 1, 4);
+        // R0 R1 G0 G1 B0 B1 A0 A1 on 16 bits for each row
+        const __m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p00), _mm_cvtsi32_si128(p01)), zero);
+        const __m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p10), _mm_cvtsi32_si128(p11)), zero);
+        const __m128i wtop = _mm_set1_epi32((int)(((unsigned int)(unsigned short)weights[1] << 16) | (unsigned short)weights[0]));
+        const __m128i wbottom = _mm_set1_epi32((int)(((unsigned int)(unsigned short)weights[3] << 16) | (unsigned short)weights[2]));
+        __m128i res = _mm_add_epi32(_mm_madd_epi16(top, wtop), _mm_madd_epi16(bottom, wbottom));
+        res = _mm_srai_epi32(_mm_add_epi32(res, round), vpRemapWeightBits);
+        res = _mm_packs_epi32(res, res);
+        res = _mm_packus_epi16(res, res);
+        const int pixel = _mm_cvtsi128_si32(res);
+        memcpy((unsigned char *) (dst + j), &pixel, 4);
+      }
+#else
+      for (unsigned int j = 0; j < width; j++, offsets++, weights += 4) {
+        const unsigned char *p0 = (const unsigned char *) (m_src + *offsets);
+        const unsigned char *p1 = (const unsigned char *) (m_src + *offsets + width);
+        unsigned char *d = (unsigned char *) (dst + j);
+        for (unsigned int c = 0; c < 4; c++) {
+          int sum = p0[c]*weights[0] + p0[c+4]*weights[1] + p1[c]*weights[2] + p1[c+4]*weights[3];
+          d[c] = (unsigned char)((sum + (1 << (vpRemapWeightBits - 1))) >> vpRemapWeightBits);
+        }
+      }
+#endif
+    }
+  }
+
+private:
+  const vpRGBa *m_src;
+  vpRGBa *m_dst;
+  unsigned int m_width;
+  const int *m_offsets;
+  const short *m_weights;
+};
+
+// Undistortion map of the last call to vpImageTools::undistort(), rebuilt
+// when the camera parameters or the size of the images change. The map only
+// depends on px, py, u0, v0 and kud.
+class vpUndistortMapCache
+{
+public:
+  vpUndistortMapCache() : m_map(), m_cam(), m_valid(false) {}
+
+  const vpUndistortMap &get(const vpCameraParameters &cam, unsigned int width, unsigned int height)
+  {
+    if (! m_valid || (m_map.getWidth() != width) || (m_map.getHeight() != height)
+        || (cam.get_px() != m_cam.get_px()) || (cam.get_py() != m_cam.get_py())
+        || (cam.get_u0() != m_cam.get_u0()) || (cam.get_v0() != m_cam.get_v0())
+        || (cam.get_kud() != m_cam.get_kud())) {
+      m_map.init(cam, width, height);
+      m_cam = cam;
+      m_valid = true;
+    }
+    return m_map;
+  }
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  //! Held while the map is built and applied, the calls are serialized.
+  vpMutex m_mutex;
+#endif
+
+private:
+  vpUndistortMap m_map;
+  vpCameraParameters m_cam;
+  bool m_valid;
+};
+
+vpUndistortMapCache undistortMapCache;
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 /*!
   Change the look up table (LUT) of an image. Considering pixel gray
@@ -279,3 +520,156 @@ vpImageTools::imageSubtract(const vpImage<unsigned char> &I1,
     *ptr_Ires = saturate ? vpMath::saturate<unsigned char>( (short int) *ptr_I1 - (short int) *ptr_I2 ) : *ptr_I1 - *ptr_I2;
   }
 }
+
+
+/*!
+  Default constructor. The map is empty, use init() to compute it.
+*/
+vpUndistortMap::vpUndistortMap()
+  : m_width(0), m_height(0), m_offsets(), m_weights()
+{
+}
+
+/*!
+  Compute the undistortion map of the images of size \e width x \e height
+  acquired with the camera \e cam.
+
+  \param cam : Parameters of the camera causing distortion.
+  \param width : Width of the images.
+  \param height : Height of the images.
+*/
+vpUndistortMap::vpUndistortMap(const vpCameraParameters &cam, unsigned int width, unsigned int height)
+  : m_width(0), m_height(0), m_offsets(), m_weights()
+{
+  init(cam, width, height);
+}
+
+/*!
+  Compute the undistortion map of the images of size \e width x \e height
+  acquired with the camera \e cam. The source point of each pixel is
+  computed with the same model as vpImageTools::undistort().
+
+  \param cam : Parameters of the camera causing distortion.
+  \param width : Width of the images.
+  \param height : Height of the images.
+*/
+void vpUndistortMap::init(const vpCameraParameters &cam, unsigned int width, unsigned int height)
+{
+  m_width = width;
+  m_height = height;
+  m_offsets.resize(width*height);
+  m_weights.resize(4*width*height);
+
+  if (width*height == 0)
+    return;
+
+  vpUndistortMapTask task(cam, width, height, &m_offsets[0], &m_weights[0]);
+  vpThreadPool::parallel_for(0, height, task);
+}
+
+/*!
+  Undistort an image with an undistortion map. The rows of the image are
+  processed by the threads of vpThreadPool.
+
+  \param I : Input image to undistort.
+  \param map : Undistortion map computed for the size of \e I.
+  \param Iundist : Undistorted image, of the same size as \e I.
+
+  \exception vpException::dimensionError If the size of the map is not the
+  size of \e I.
+
+  \sa vpUndistortMap
+*/
+void vpImageTools::remap(const vpImage<unsigned char> &I, const vpUndistortMap &map,
+                         vpImage<unsigned char> &Iundist)
+{
+  if ((I.getHeight() != map.getHeight()) || (I.getWidth() != map.getWidth())) {
+    throw (vpException(vpException::dimensionError, "The undistortion map does not have the size of the image"));
+  }
+
+  Iundist.resize(I.getHeight(), I.getWidth());
+  if (I.getSize() == 0)
+    return;
+
+  // No source point has a 2x2 neighbourhood in the image, all the pixels are
+  // invalid and the kernels would read past the end of the image
+  if ((I.getWidth() < 2) || (I.getHeight() < 2)) {
+    Iundist = 0;
+    return;
+  }
+
+  vpRemapGreyTask task(I.bitmap, Iundist.bitmap, I.getWidth(), &map.m_offsets[0], &map.m_weights[0]);
+  vpThreadPool::parallel_for(0, I.getHeight(), task);
+}
+
+/*!
+  Undistort a color image with an undistortion map. The four components of
+  the pixels are interpolated, and the rows of the image are processed by the
+  threads of vpThreadPool.
+
+  \param I : Input image to undistort.
+  \param map : Undistortion map computed for the size of \e I.
+  \param Iundist : Undistorted image, of the same size as \e I.
+
+  \exception vpException::dimensionError If the size of the map is not the
+  size of \e I.
+
+  \sa vpUndistortMap
+*/
+void vpImageTools::remap(const vpImage<vpRGBa> &I, const vpUndistortMap &map,
+                         vpImage<vpRGBa> &Iundist)
+{
+  if ((I.getHeight() != map.getHeight()) || (I.getWidth() != map.getWidth())) {
+    throw (vpException(vpException::dimensionError, "The undistortion map does not have the size of the image"));
+  }
+
+  Iundist.resize(I.getHeight(), I.getWidth());
+  if (I.getSize() == 0)
+    return;
+
+  // No source point has a 2x2 neighbourhood in the image, all the pixels are
+  // invalid and the kernels would read past the end of the image
+  if ((I.getWidth() < 2) || (I.getHeight() < 2)) {
+    Iundist = vpRGBa(0, 0, 0, 0);
+    return;
+  }
+
+  vpRemapRGBaTask task(I.bitmap, Iundist.bitmap, I.getWidth(), &map.m_offsets[0], &map.m_weights[0]);
+  vpThreadPool::parallel_for(0, I.getHeight(), task);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template<>
+void vpImageTools::undistort(const vpImage<unsigned char> &I,
+                             const vpCameraParameters &cam,
+                             vpImage<unsigned char> &undistI)
+{
+  if (std::fabs(cam.get_kud()) <= std::numeric_limits<double>::epsilon()) {
+    // There is no need to undistort the image
+    undistI = I;
+    return;
+  }
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  vpMutex::vpScopedLock lock(undistortMapCache.m_mutex);
+#endif
+  remap(I, undistortMapCache.get(cam, I.getWidth(), I.getHeight()), undistI);
+}
+
+template<>
+void vpImageTools::undistort(const vpImage<vpRGBa> &I,
+                             const vpCameraParameters &cam,
+                             vpImage<vpRGBa> &undistI)
+{
+  if (std::fabs(cam.get_kud()) <= std::numeric_limits<double>::epsilon()) {
+    // There is no need to undistort the image
+    undistI = I;
+    return;
+  }
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  vpMutex::vpScopedLock lock(undistortMapCache.m_mutex);
+#endif
+  remap(I, undistortMapCache.get(cam, I.getWidth(), I.getHeight()), undistI);
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
@@ -0,0 +1,403 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Cache-blocked matrix multiplication kernel.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpGEMM.cpp
+  \brief Cache-blocked, vectorized kernel behind vpMatrix products and vpGEMM().
+*/
+
+#include <string.h>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpGEMM.h>
+
+#ifdef VISP_HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#if defined __AVX__
+#  include <immintrin.h>
+#  define VISP_HAVE_AVX 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Register blocking: the micro-kernel updates a MR x NR tile of C.
+  const unsigned int vpGEMM_MR = 4;
+  const unsigned int vpGEMM_NR = 4;
+  // Cache blocking: a packed MC x KC block of op(A) is kept in L2 while a
+  // KC x NR sliver of the packed op(B) panel is streamed from L1.
+  const unsigned int vpGEMM_MC = 96;
+  const unsigned int vpGEMM_KC = 256;
+  const unsigned int vpGEMM_NC = 2048;
+  // Under this number of multiply-adds packing costs more than it saves.
+  const double vpGEMM_PACKING_THRESHOLD = 32768.;
+  // Over this number of multiply-adds the row blocks are shared among threads.
+  const double vpGEMM_PARALLEL_THRESHOLD = 4.e6;
+
+  inline unsigned int vpGEMMmin(unsigned int a, unsigned int b) { return (a < b) ? a : b; }
+
+  double vpGEMMDot(const double *a, const double *b, unsigned int n)
+  {
+    unsigned int k = 0;
+    double s = 0.;
+#if VISP_HAVE_SSE2
+    if (n >= 4) {
+      __m128d v_sum0 = _mm_setzero_pd();
+      __m128d v_sum1 = _mm_setzero_pd();
+      for (; k <= n - 4; k += 4) {
+        v_sum0 = _mm_add_pd(v_sum0, _mm_mul_pd(_mm_loadu_pd(a + k), _mm_loadu_pd(b + k)));
+        v_sum1 = _mm_add_pd(v_sum1, _mm_mul_pd(_mm_loadu_pd(a + k + 2), _mm_loadu_pd(b + k + 2)));
+      }
+      double res[2];
+      _mm_storeu_pd(res, _mm_add_pd(v_sum0, v_sum1));
+      s = res[0] + res[1];
+    }
+#endif
+    for (; k < n; k++)
+      s += a[k] * b[k];
+    return s;
+  }
+
+  /*
+    Multiply-add used when the operands are too small to amortize packing:
+    C += alpha * op(A) * op(B), choosing the loop order that keeps the innermost
+    accesses contiguous.
+  */
+  void vpGEMMSmall(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                   const double *A, unsigned int lda, bool transA,
+                   const double *B, unsigned int ldb, bool transB,
+                   double *C, unsigned int ldc)
+  {
+    if (! transB) {
+      if (! transA) {
+        for (unsigned int i = 0; i < M; i++) {
+          const double *a = A + (size_t)i*lda;
+          double *c = C + (size_t)i*ldc;
+          for (unsigned int k = 0; k < K; k++) {
+            const double aik = alpha * a[k];
+            const double *b = B + (size_t)k*ldb;
+            for (unsigned int j = 0; j < N; j++)
+              c[j] += aik * b[j];
+          }
+        }
+      }
+      else {
+        // op(A)(i,k) = A[k][i]: stream once over the rows of A and B
+        for (unsigned int k = 0; k < K; k++) {
+          const double *a = A + (size_t)k*lda;
+          const double *b = B + (size_t)k*ldb;
+          for (unsigned int i = 0; i < M; i++) {
+            const double aik = alpha * a[i];
+            double *c = C + (size_t)i*ldc;
+            for (unsigned int j = 0; j < N; j++)
+              c[j] += aik * b[j];
+          }
+        }
+      }
+    }
+    else if (! transA) {
+      // Rows of A against rows of B: contiguous dot products
+      for (unsigned int i = 0; i < M; i++) {
+        const double *a = A + (size_t)i*lda;
+        double *c = C + (size_t)i*ldc;
+        for (unsigned int j = 0; j < N; j++)
+          c[j] += alpha * vpGEMMDot(a, B + (size_t)j*ldb, K);
+      }
+    }
+    else {
+      for (unsigned int i = 0; i < M; i++) {
+        double *c = C + (size_t)i*ldc;
+        for (unsigned int j = 0; j < N; j++) {
+          const double *b = B + (size_t)j*ldb;
+          double s = 0.;
+          for (unsigned int k = 0; k < K; k++)
+            s += A[(size_t)k*lda + i] * b[k];
+          c[j] += alpha * s;
+        }
+      }
+    }
+  }
+
+  /*
+    Copy the mc x kc block of op(A) starting at (i0, k0) into row panels of
+    height MR. Inside a panel the MR values of a column are contiguous, and
+    the last panel is padded with zeros.
+  */
+  void vpGEMMPackA(unsigned int mc, unsigned int kc, const double *A, unsigned int lda, bool transA,
+                   unsigned int i0, unsigned int k0, double *buf)
+  {
+    for (unsigned int ip = 0; ip < mc; ip += vpGEMM_MR) {
+      const unsigned int mr = vpGEMMmin(vpGEMM_MR, mc - ip);
+      if (! transA) {
+        const double *a = A + (size_t)(i0 + ip)*lda + k0;
+        for (unsigned int k = 0; k < kc; k++) {
+          unsigned int r = 0;
+          for (; r < mr; r++)
+            *buf++ = a[(size_t)r*lda + k];
+          for (; r < vpGEMM_MR; r++)
+            *buf++ = 0.;
+        }
+      }
+      else {
+        const double *a = A + (size_t)k0*lda + i0 + ip;
+        for (unsigned int k = 0; k < kc; k++, a += lda) {
+          unsigned int r = 0;
+          for (; r < mr; r++)
+            *buf++ = a[r];
+          for (; r < vpGEMM_MR; r++)
+            *buf++ = 0.;
+        }
+      }
+    }
+  }
+
+  /*
+    Copy the kc x nc block of op(B) starting at (k0, j0) into column panels of
+    width NR. Inside a panel the NR values of a row are contiguous, and the
+    last panel is padded with zeros.
+  */
+  void vpGEMMPackB(unsigned int kc, unsigned int nc, const double *B, unsigned int ldb, bool transB,
+                   unsigned int k0, unsigned int j0, double *buf)
+  {
+    for (unsigned int jp = 0; jp < nc; jp += vpGEMM_NR) {
+      const unsigned int nr = vpGEMMmin(vpGEMM_NR, nc - jp);
+      if (! transB) {
+        const double *b = B + (size_t)k0*ldb + j0 + jp;
+        for (unsigned int k = 0; k < kc; k++, b += ldb) {
+          unsigned int c = 0;
+          for (; c < nr; c++)
+            *buf++ = b[c];
+          for (; c < vpGEMM_NR; c++)
+            *buf++ = 0.;
+        }
+      }
+      else {
+        const double *b = B + (size_t)(j0 + jp)*ldb + k0;
+        for (unsigned int k = 0; k < kc; k++) {
+          unsigned int c = 0;
+          for (; c < nr; c++)
+            *buf++ = b[(size_t)c*ldb + k];
+          for (; c < vpGEMM_NR; c++)
+            *buf++ = 0.;
+        }
+      }
+    }
+  }
+
+  /*
+    Micro-kernel: ab = a * b where a is a packed MR x kc panel and b a packed
+    kc x NR panel. The MR x NR result is stored row-major in ab.
+  */
+  void vpGEMMMicroKernel(unsigned int kc, const double *a, const double *b, double *ab)
+  {
+#if VISP_HAVE_AVX
+    __m256d v_c0 = _mm256_setzero_pd();
+    __m256d v_c1 = _mm256_setzero_pd();
+    __m256d v_c2 = _mm256_setzero_pd();
+    __m256d v_c3 = _mm256_setzero_pd();
+    for (unsigned int k = 0; k < kc; k++, a += vpGEMM_MR, b += vpGEMM_NR) {
+      const __m256d v_b = _mm256_loadu_pd(b);
+      v_c0 = _mm256_add_pd(v_c0, _mm256_mul_pd(_mm256_broadcast_sd(a), v_b));
+      v_c1 = _mm256_add_pd(v_c1, _mm256_mul_pd(_mm256_broadcast_sd(a + 1), v_b));
+      v_c2 = _mm256_add_pd(v_c2, _mm256_mul_pd(_mm256_broadcast_sd(a + 2), v_b));
+      v_c3 = _mm256_add_pd(v_c3, _mm256_mul_pd(_mm256_broadcast_sd(a + 3), v_b));
+    }
+    _mm256_storeu_pd(ab, v_c0);
+    _mm256_storeu_pd(ab + 4, v_c1);
+    _mm256_storeu_pd(ab + 8, v_c2);
+    _mm256_storeu_pd(ab + 12, v_c3);
+#elif VISP_HAVE_SSE2
+    __m128d v_c00 = _mm_setzero_pd(), v_c01 = _mm_setzero_pd();
+    __m128d v_c10 = _mm_setzero_pd(), v_c11 = _mm_setzero_pd();
+    __m128d v_c20 = _mm_setzero_pd(), v_c21 = _mm_setzero_pd();
+    __m128d v_c30 = _mm_setzero_pd(), v_c31 = _mm_setzero_pd();
+    for (unsigned int k = 0; k < kc; k++, a += vpGEMM_MR, b += vpGEMM_NR) {
+      const __m128d v_b0 = _mm_loadu_pd(b);
+      const __m128d v_b1 = _mm_loadu_pd(b + 2);
+      __m128d v_a = _mm_set1_pd(a[0]);
+      v_c00 = _mm_add_pd(v_c00, _mm_mul_pd(v_a, v_b0));
+      v_c01 = _mm_add_pd(v_c01, _mm_mul_pd(v_a, v_b1));
+      v_a = _mm_set1_pd(a[1]);
+      v_c10 = _mm_add_pd(v_c10, _mm_mul_pd(v_a, v_b0));
+      v_c11 = _mm_add_pd(v_c11, _mm_mul_pd(v_a, v_b1));
+      v_a = _mm_set1_pd(a[2]);
+      v_c20 = _mm_add_pd(v_c20, _mm_mul_pd(v_a, v_b0));
+      v_c21 = _mm_add_pd(v_c21, _mm_mul_pd(v_a, v_b1));
+      v_a = _mm_set1_pd(a[3]);
+      v_c30 = _mm_add_pd(v_c30, _mm_mul_pd(v_a, v_b0));
+      v_c31 = _mm_add_pd(v_c31, _mm_mul_pd(v_a, v_b1));
+    }
+    _mm_storeu_pd(ab, v_c00);      _mm_storeu_pd(ab + 2, v_c01);
+    _mm_storeu_pd(ab + 4, v_c10);  _mm_storeu_pd(ab + 6, v_c11);
+    _mm_storeu_pd(ab + 8, v_c20);  _mm_storeu_pd(ab + 10, v_c21);
+    _mm_storeu_pd(ab + 12, v_c30); _mm_storeu_pd(ab + 14, v_c31);
+#else
+    for (unsigned int i = 0; i < vpGEMM_MR*vpGEMM_NR; i++)
+      ab[i] = 0.;
+    for (unsigned int k = 0; k < kc; k++, a += vpGEMM_MR, b += vpGEMM_NR) {
+      for (unsigned int r = 0; r < vpGEMM_MR; r++)
+        for (unsigned int c = 0; c < vpGEMM_NR; c++)
+          ab[r*vpGEMM_NR + c] += a[r] * b[c];
+    }
+#endif
+  }
+
+  /*
+    Macro-kernel: C[i0:i0+mc, j0:j0+nc] += alpha * Apack * Bpack.
+  */
+  void vpGEMMMacroKernel(unsigned int mc, unsigned int nc, unsigned int kc, double alpha,
+                         const double *Apack, const double *Bpack, double *C, unsigned int ldc)
+  {
+    double ab[vpGEMM_MR*vpGEMM_NR];
+    for (unsigned int jr = 0; jr < nc; jr += vpGEMM_NR) {
+      const unsigned int nr = vpGEMMmin(vpGEMM_NR, nc - jr);
+      for (unsigned int ir = 0; ir < mc; ir += vpGEMM_MR) {
+        const unsigned int mr = vpGEMMmin(vpGEMM_MR, mc - ir);
+        vpGEMMMicroKernel(kc, Apack + (size_t)ir*kc, Bpack + (size_t)jr*kc, ab);
+        for (unsigned int r = 0; r < mr; r++) {
+          double *c = C + (size_t)(ir + r)*ldc + jr;
+          const double *abr = ab + r*vpGEMM_NR;
+          for (unsigned int j = 0; j < nr; j++)
+            c[j] += alpha * abr[j];
+        }
+      }
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Low level kernel that computes \f$ C = \alpha \; op(A) \; op(B) + \beta \; C \f$
+  where \f$ op(X) \f$ is \f$ X \f$ or \f$ X^T \f$, all the matrices being stored
+  row-major.
+
+  Small products are computed directly with contiguous inner loops. Bigger ones
+  are decomposed in blocks that fit the caches: op(A) and op(B) blocks are packed
+  in contiguous panels and multiplied by a 4x4 register-blocked micro-kernel
+  that uses AVX or SSE2 instructions when the compiler enables them. When ViSP is
+  build with OpenMP, large products are shared among the available threads.
+
+  \param M : Number of rows of op(A) and C.
+  \param N : Number of columns of op(B) and C.
+  \param K : Number of columns of op(A) and rows of op(B).
+  \param alpha : Scalar applied to the product.
+  \param A : Pointer to the first element of A.
+  \param lda : Distance between two consecutive rows of A.
+  \param transA : If true, op(A) = \f$ A^T \f$ and A is a K-by-M matrix.
+  \param B : Pointer to the first element of B.
+  \param ldb : Distance between two consecutive rows of B.
+  \param transB : If true, op(B) = \f$ B^T \f$ and B is a N-by-K matrix.
+  \param beta : Scalar applied to C before the product is accumulated. When
+  beta is 0, C does not need to be initialized.
+  \param C : Pointer to the first element of the M-by-N result, that must not
+  overlap A or B.
+  \param ldc : Distance between two consecutive rows of C.
+
+  \sa vpGEMM(), vpMatrix::mult2Matrices()
+*/
+void vpGEMMKernel(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                  const double *A, unsigned int lda, bool transA,
+                  const double *B, unsigned int ldb, bool transB,
+                  double beta, double *C, unsigned int ldc)
+{
+  if (M == 0 || N == 0)
+    return;
+
+  // As in the reference BLAS, only the exact values 0 and 1 of alpha and beta
+  // are special cases: a tiny scale factor still has to be applied
+  if (beta == 0.) {
+    for (unsigned int i = 0; i < M; i++)
+      memset(C + (size_t)i*ldc, 0, N*sizeof(double));
+  }
+  else if (beta != 1.) {
+    for (unsigned int i = 0; i < M; i++) {
+      double *c = C + (size_t)i*ldc;
+      for (unsigned int j = 0; j < N; j++)
+        c[j] *= beta;
+    }
+  }
+
+  if (K == 0 || alpha == 0.)
+    return;
+
+  const double nbMultAdd = (double)M * (double)N * (double)K;
+  if (M < vpGEMM_MR || N < vpGEMM_NR || nbMultAdd < vpGEMM_PACKING_THRESHOLD) {
+    vpGEMMSmall(M, N, K, alpha, A, lda, transA, B, ldb, transB, C, ldc);
+    return;
+  }
+
+  int nbThreads = 1;
+#ifdef VISP_HAVE_OPENMP
+  if (nbMultAdd >= vpGEMM_PARALLEL_THRESHOLD && M > vpGEMM_MC)
+    nbThreads = omp_get_max_threads();
+#endif
+
+  const unsigned int nbBlocksM = (M + vpGEMM_MC - 1) / vpGEMM_MC;
+  const unsigned int ncMax = vpGEMMmin(N, vpGEMM_NC);
+  const unsigned int kcMax = vpGEMMmin(K, vpGEMM_KC);
+  std::vector<double> Bpack((size_t)kcMax * (ncMax + vpGEMM_NR));
+  std::vector<double> Apack((size_t)nbThreads * kcMax * (vpGEMM_MC + vpGEMM_MR));
+  const size_t ApackStride = (size_t)kcMax * (vpGEMM_MC + vpGEMM_MR);
+
+  for (unsigned int jc = 0; jc < N; jc += vpGEMM_NC) {
+    const unsigned int nc = vpGEMMmin(vpGEMM_NC, N - jc);
+    for (unsigned int pc = 0; pc < K; pc += vpGEMM_KC) {
+      const unsigned int kc = vpGEMMmin(vpGEMM_KC, K - pc);
+      vpGEMMPackB(kc, nc, B, ldb, transB, pc, jc, &Bpack[0]);
+
+      int ib;
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for num_threads(nbThreads) if(nbThreads > 1) schedule(static)
+#endif
+      for (ib = 0; ib < (int)nbBlocksM; ib++) {
+        int tid = 0;
+#ifdef VISP_HAVE_OPENMP
+        tid = omp_get_thread_num();
+#endif
+        double *Ap = &Apack[(size_t)tid * ApackStride];
+        const unsigned int ic = (unsigned int)ib * vpGEMM_MC;
+        const unsigned int mc = vpGEMMmin(vpGEMM_MC, M - ic);
+        vpGEMMPackA(mc, kc, A, lda, transA, ic, pc, Ap);
+        vpGEMMMacroKernel(mc, nc, kc, alpha, Ap, &Bpack[0], C + (size_t)ic*ldc + jc, ldc);
+      }
+    }
+  }
+}
@@ -91,8 +91,9 @@ vpForceTwistMatrix::eye()
   Initialize a force/torque twist transformation matrix to identity.
 */
 vpForceTwistMatrix::vpForceTwistMatrix()
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   eye() ;
 }
 
@@ -104,8 +105,9 @@ vpForceTwistMatrix::vpForceTwistMatrix()
   \param F : Force/torque twist matrix used as initializer.
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   *this = F ;
 }
 
@@ -134,8 +136,9 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F)
 
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(M);
 }
 
@@ -151,8 +154,9 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M)
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
                                        const vpThetaUVector &thetau)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(t, thetau) ;
 }
 
@@ -168,8 +172,9 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
                                        const vpRotationMatrix &R)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(t, R) ;
 }
 
@@ -184,8 +189,9 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const double tx, const double ty, const double tz,
                                        const double tux, const double tuy, const double tuz)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   vpTranslationVector T(tx,ty,tz) ;
   vpThetaUVector tu(tux,tuy,tuz) ;
   buildFrom(T,tu) ;  
@@ -337,11 +343,16 @@ vpForceTwistMatrix
 vpForceTwistMatrix::buildFrom(const vpTranslationVector &t,
                               const vpRotationMatrix &R)
 {
-  unsigned int i, j;
-  vpMatrix skewaR = t.skew(t)*R ;
-  
-  for (i=0 ; i < 3 ; i++) {
-    for (j=0 ; j < 3 ; j++)	{
+  // [t]_x R computed in place, without the intermediate skew matrix
+  double skewaR[3][3];
+  for (unsigned int j=0 ; j < 3 ; j++) {
+    skewaR[0][j] = t[1]*R[2][j] - t[2]*R[1][j] ;
+    skewaR[1][j] = t[2]*R[0][j] - t[0]*R[2][j] ;
+    skewaR[2][j] = t[0]*R[1][j] - t[1]*R[0][j] ;
+  }
+
+  for (unsigned int i=0 ; i < 3 ; i++) {
+    for (unsigned int j=0 ; j < 3 ; j++) {
       (*this)[i][j] = R[i][j] ;
       (*this)[i+3][j+3] = R[i][j] ;
       (*this)[i+3][j] = skewaR[i][j] ;
@@ -54,8 +54,9 @@
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpQuaternionVector &q)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(t,q);
   (*this)[3][3] = 1.;
 }
@@ -64,8 +65,9 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
   Default constructor that initialize an homogeneous matrix as identity.
 */
 vpHomogeneousMatrix::vpHomogeneousMatrix()
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   eye() ;
 }
 
@@ -73,8 +75,9 @@ vpHomogeneousMatrix::vpHomogeneousMatrix()
   Copy constructor that initialize an homogeneous matrix from another homogeneous matrix.
 */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   *this = M;
 }
 
@@ -83,8 +86,9 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M)
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpThetaUVector &tu)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(t, tu);
   (*this)[3][3] = 1.;
 }
@@ -94,8 +98,9 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpRotationMatrix &R)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   insert(R);
   insert(t);
   (*this)[3][3] = 1.;
@@ -105,8 +110,9 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
   Construct an homogeneous matrix from a pose vector.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpPoseVector &p)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(p[0], p[1], p[2], p[3], p[4], p[5]) ;
   (*this)[3][3] = 1.;
 }
@@ -150,8 +156,9 @@ M:
   \endcode
   */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<float> &v)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(v) ;
   (*this)[3][3] = 1.;
 }
@@ -195,8 +202,9 @@ M:
   \endcode
   */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(v) ;
   (*this)[3][3] = 1.;
 }
@@ -211,8 +219,9 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const double tx,
                                          const double tux,
                                          const double tuy,
                                          const double tuz)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(tx, ty, tz, tux, tuy, tuz);
   (*this)[3][3] = 1.;
 }
@@ -392,11 +401,8 @@ vpHomogeneousMatrix::buildFrom(const std::vector<double> &v)
 vpHomogeneousMatrix &
 vpHomogeneousMatrix::operator=(const vpHomogeneousMatrix &M)
 {
-  for (int i=0; i<4; i++) {
-    for (int j=0; j<4; j++) {
-      rowPtrs[i][j] = M.rowPtrs[i][j];
-    }
-  }
+  if (this != &M)
+    memcpy(data, M.data, 16*sizeof(double));
   return *this;
 }
 
@@ -422,21 +428,16 @@ vpHomogeneousMatrix::operator*(const vpHomogeneousMatrix &M) const
 {
   vpHomogeneousMatrix p;
 
-  vpRotationMatrix R1, R2, R ;
-  vpTranslationVector T1, T2 , T;
-
-  extract(T1) ;
-  M.extract(T2) ;
-
-  extract (R1) ;
-  M.extract (R2) ;
-
-  R = R1*R2 ;
-
-  T = R1*T2 + T1 ;
-
-  p.insert(T) ;
-  p.insert(R) ;
+  // [R1 T1] [R2 T2] = [R1*R2 R1*T2+T1]; the last row stays [0 0 0 1]
+  const double *a = data;
+  const double *b = M.data;
+  double *c = p.data;
+  for (unsigned int i=0; i<3; i++, a+=4, c+=4) {
+    c[0] = a[0]*b[0] + a[1]*b[4] + a[2]*b[8];
+    c[1] = a[0]*b[1] + a[1]*b[5] + a[2]*b[9];
+    c[2] = a[0]*b[2] + a[1]*b[6] + a[2]*b[10];
+    c[3] = a[0]*b[3] + a[1]*b[7] + a[2]*b[11] + a[3];
+  }
 
   return p;
 }
@@ -480,12 +481,9 @@ vpHomogeneousMatrix::operator*(const vpColVector &v) const
   }
   vpColVector p(rowNum);
 
-  p = 0.0;
-
-  for (unsigned int j=0;j<4;j++) {
-    for (unsigned int i=0;i<4;i++) {
-      p[i]+=rowPtrs[i][j] * v[j];
-    }
+  const double *a = data;
+  for (unsigned int i=0; i<4; i++, a+=4) {
+    p[i] = a[0]*v[0] + a[1]*v[1] + a[2]*v[2] + a[3]*v[3];
   }
 
   return p;
@@ -504,19 +502,21 @@ vpPoint vpHomogeneousMatrix::operator*(const vpPoint& bP) const
 {
   vpPoint aP ;
 
-  vpColVector v(4),v1(4) ;
+  double v[4], v1[4] ;
 
   v[0] = bP.get_X() ;
   v[1] = bP.get_Y() ;
   v[2] = bP.get_Z() ;
   v[3] = bP.get_W() ;
 
-  v1[0] = (*this)[0][0]*v[0] + (*this)[0][1]*v[1]+ (*this)[0][2]*v[2]+ (*this)[0][3]*v[3] ;
-  v1[1] = (*this)[1][0]*v[0] + (*this)[1][1]*v[1]+ (*this)[1][2]*v[2]+ (*this)[1][3]*v[3] ;
-  v1[2] = (*this)[2][0]*v[0] + (*this)[2][1]*v[1]+ (*this)[2][2]*v[2]+ (*this)[2][3]*v[3] ;
-  v1[3] = (*this)[3][0]*v[0] + (*this)[3][1]*v[1]+ (*this)[3][2]*v[2]+ (*this)[3][3]*v[3] ;
+  const double *a = data;
+  v1[0] = a[0]*v[0] + a[1]*v[1] + a[2]*v[2] + a[3]*v[3] ;
+  v1[1] = a[4]*v[0] + a[5]*v[1] + a[6]*v[2] + a[7]*v[3] ;
+  v1[2] = a[8]*v[0] + a[9]*v[1] + a[10]*v[2] + a[11]*v[3] ;
+  v1[3] = a[12]*v[0] + a[13]*v[1] + a[14]*v[2] + a[15]*v[3] ;
 
-  v1 /= v1[3] ;
+  for (unsigned int i=0; i<4; i++)
+    v1[i] /= v1[3] ;
 
   //  v1 = M*v ;
   aP.set_X(v1[0]) ;
@@ -543,9 +543,10 @@ vpPoint vpHomogeneousMatrix::operator*(const vpPoint& bP) const
 vpTranslationVector vpHomogeneousMatrix::operator*(const vpTranslationVector &t) const
 {
   vpTranslationVector t_out;
-  t_out[0] = (*this)[0][0]*t[0] + (*this)[0][1]*t[1]+ (*this)[0][2]*t[2]+ (*this)[0][3];
-  t_out[1] = (*this)[1][0]*t[0] + (*this)[1][1]*t[1]+ (*this)[1][2]*t[2]+ (*this)[1][3];
-  t_out[2] = (*this)[2][0]*t[0] + (*this)[2][1]*t[1]+ (*this)[2][2]*t[2]+ (*this)[2][3];
+  const double *a = data;
+  t_out[0] = a[0]*t[0] + a[1]*t[1] + a[2]*t[2] + a[3];
+  t_out[1] = a[4]*t[0] + a[5]*t[1] + a[6]*t[2] + a[7];
+  t_out[2] = a[8]*t[0] + a[9]*t[1] + a[10]*t[2] + a[11];
 
   return t_out ;
 }
@@ -674,14 +675,16 @@ vpHomogeneousMatrix::inverse() const
 {
   vpHomogeneousMatrix Mi ;
 
-  vpRotationMatrix R ;      extract(R) ;
-  vpTranslationVector T ;   extract(T) ;
-
-  vpTranslationVector RtT ; RtT = -(R.t()*T) ;
-
-
-  Mi.insert(R.t()) ;
-  Mi.insert(RtT) ;
+  const double *a = data;
+  double *b = Mi.data;
+  // Rotational part R^T
+  b[0] = a[0]; b[1] = a[4]; b[2]  = a[8];
+  b[4] = a[1]; b[5] = a[5]; b[6]  = a[9];
+  b[8] = a[2]; b[9] = a[6]; b[10] = a[10];
+  // Translational part -R^T t
+  b[3]  = -(a[0]*a[3] + a[4]*a[7] + a[8]*a[11]);
+  b[7]  = -(a[1]*a[3] + a[5]*a[7] + a[9]*a[11]);
+  b[11] = -(a[2]*a[3] + a[6]*a[7] + a[10]*a[11]);
 
   return Mi ;
 }
@@ -65,10 +65,23 @@
 
 */
 vpPoseVector::vpPoseVector()
-  : vpArray2D<double>(6, 1)
-{}
+  : vpArray2D<double>(), storage()
+{
+  attach(storage);
+}
 
-/*!  
+/*!
+  Copy constructor.
+
+  \param p : Pose vector to copy.
+*/
+vpPoseVector::vpPoseVector(const vpPoseVector &p)
+  : vpArray2D<double>(), storage()
+{
+  attach(storage, p);
+}
+
+/*!
 
   Construct a 6 dimension pose vector \f$ [\bf{t}, \theta
   \bf{u}]^\top\f$ from 3 translations and 3 \f$ \theta \bf{u}\f$
@@ -89,8 +102,9 @@ vpPoseVector::vpPoseVector(const double tx,
                            const double tux,
                            const double tuy,
                            const double tuz)
-  : vpArray2D<double>(6, 1)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   (*this)[0] = tx;
   (*this)[1] = ty;
   (*this)[2] = tz;
@@ -112,8 +126,9 @@ vpPoseVector::vpPoseVector(const double tx,
 */
 vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
                            const vpThetaUVector& tu)
-  : vpArray2D<double>(6, 1)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(tv, tu) ;
 }
 
@@ -131,8 +146,9 @@ vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
 */
 vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
                            const vpRotationMatrix& R)
-  : vpArray2D<double>(6, 1)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(tv, R) ;
 }
 
@@ -147,8 +163,9 @@ vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
 
 */
 vpPoseVector::vpPoseVector(const vpHomogeneousMatrix& M)
-  : vpArray2D<double>(6, 1)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(M) ;
 }
 
@@ -53,26 +53,32 @@ const double vpQuaternionVector::minimum = 0.0001;
 
 /*! Default constructor that initialize all the 4 angles to zero. */
 vpQuaternionVector::vpQuaternionVector()
-  : vpRotationVector(4)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage);
+}
 
 /*! Copy constructor. */
 vpQuaternionVector::vpQuaternionVector(const vpQuaternionVector &q)
-  : vpRotationVector(q)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage, q);
+}
 
 //! Constructor from doubles.
 vpQuaternionVector::vpQuaternionVector(const double x_, const double y_,
                                        const double z_,const double w_)
-  : vpRotationVector(4) 
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   set(x_, y_, z_, w_);
 }
 
 //! Constructor from a 4-dimension vector of doubles.
 vpQuaternionVector::vpQuaternionVector(const vpColVector &q)
-  : vpRotationVector(4)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   if (q.size() != 4) {
     throw(vpException(vpException::dimensionError, "Cannot construct a quaternion vector from a %d-dimension col vector", q.size()));
   }
@@ -86,8 +92,9 @@ vpQuaternionVector::vpQuaternionVector(const vpColVector &q)
   \param R : Matrix containing a rotation.
 */
 vpQuaternionVector::vpQuaternionVector(const vpRotationMatrix &R)  
-  : vpRotationVector(4) 
-{	
+  : vpRotationVector(), storage()
+{
+  attach(storage);
   buildFrom(R);
 }
 
@@ -98,8 +105,9 @@ vpQuaternionVector::vpQuaternionVector(const vpRotationMatrix &R)
   input to initialize the Euler angles.
 */
 vpQuaternionVector::vpQuaternionVector(const vpThetaUVector& tu)
-  : vpRotationVector (4)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(tu) ;
 }
 
@@ -49,13 +49,17 @@
 
 /*! Default constructor that initialize all the 3 angles to zero. */
 vpRxyzVector::vpRxyzVector()
-  : vpRotationVector(3)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage);
+}
 
 /*! Copy constructor. */
 vpRxyzVector::vpRxyzVector(const vpRxyzVector &rxyz)
-  : vpRotationVector(rxyz)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage, rxyz);
+}
 
 /*!
   Constructor from 3 angles (in radian).
@@ -64,8 +68,9 @@ vpRxyzVector::vpRxyzVector(const vpRxyzVector &rxyz)
   \param psi : \f$\psi\f$ angle around the \f$z\f$ axis.
 */
 vpRxyzVector::vpRxyzVector(const double phi, const double theta, const double psi)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(phi, theta, psi);
 }
 
@@ -75,8 +80,9 @@ vpRxyzVector::vpRxyzVector(const double phi, const double theta, const double ps
   \param R : Rotation matrix used to initialize the Euler angles.
 */
 vpRxyzVector::vpRxyzVector(const vpRotationMatrix& R)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(R) ;
 }
 
@@ -87,15 +93,17 @@ vpRxyzVector::vpRxyzVector(const vpRotationMatrix& R)
   input to initialize the Euler angles.
 */
 vpRxyzVector::vpRxyzVector(const vpThetaUVector& tu)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(tu) ;
 }
 
 /*! Copy constructor from a 3-dimension vector. */
 vpRxyzVector::vpRxyzVector(const vpColVector &rxyz)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   if (rxyz.size() != 3) {
     throw(vpException(vpException::dimensionError, "Cannot construct a R-xyz vector from a %d-dimension col vector", rxyz.size()));
   }
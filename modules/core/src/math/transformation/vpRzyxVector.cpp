@@ -49,13 +49,17 @@
 
 /*! Default constructor that initialize all the 3 angles to zero. */
 vpRzyxVector::vpRzyxVector()
-  : vpRotationVector(3)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage);
+}
 
 /*! Copy constructor. */
 vpRzyxVector::vpRzyxVector(const vpRzyxVector &rzyx)
-  : vpRotationVector(rzyx)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage, rzyx);
+}
 
 /*!
   Constructor from 3 angles (in radian).
@@ -64,8 +68,9 @@ vpRzyxVector::vpRzyxVector(const vpRzyxVector &rzyx)
   \param psi : \f$\psi\f$ angle around the \f$x\f$ axis.
 */
 vpRzyxVector::vpRzyxVector(const double phi, const double theta, const double psi)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(phi, theta, psi);
 }
 
@@ -75,8 +80,9 @@ vpRzyxVector::vpRzyxVector(const double phi, const double theta, const double ps
   \param R : Rotation matrix used to initialize the Euler angles.
 */
 vpRzyxVector::vpRzyxVector(const vpRotationMatrix& R)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(R) ;
 }
 
@@ -87,15 +93,17 @@ vpRzyxVector::vpRzyxVector(const vpRotationMatrix& R)
   input to initialize the Euler angles.
 */
 vpRzyxVector::vpRzyxVector(const vpThetaUVector& tu)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(tu) ;
 }
 
 /*! Copy constructor from a 3-dimension vector. */
 vpRzyxVector::vpRzyxVector(const vpColVector &rzyx)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   if (rzyx.size() != 3) {
     throw(vpException(vpException::dimensionError, "Cannot construct a R-zyx vector from a %d-dimension col vector", rzyx.size()));
   }
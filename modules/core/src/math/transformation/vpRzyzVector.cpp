@@ -49,12 +49,16 @@
 
 /*! Default constructor that initialize all the 3 angles to zero. */
 vpRzyzVector::vpRzyzVector()
-  : vpRotationVector (3)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage);
+}
 /*! Copy constructor. */
 vpRzyzVector::vpRzyzVector(const vpRzyzVector &rzyz)
-  : vpRotationVector(rzyz)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage, rzyz);
+}
 
 /*!
   Constructor from 3 angles (in radian).
@@ -63,8 +67,9 @@ vpRzyzVector::vpRzyzVector(const vpRzyzVector &rzyz)
   \param psi : \f$\psi\f$ angle around the \f$z\f$ axis.
 */
 vpRzyzVector::vpRzyzVector(const double phi, const double theta, const double psi)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(phi, theta, psi);
 }
 
@@ -74,8 +79,9 @@ vpRzyzVector::vpRzyzVector(const double phi, const double theta, const double ps
   \param R : Rotation matrix used to initialize the Euler angles.
 */
 vpRzyzVector::vpRzyzVector(const vpRotationMatrix& R)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(R) ;
 }
 
@@ -86,15 +92,17 @@ vpRzyzVector::vpRzyzVector(const vpRotationMatrix& R)
   input to initialize the Euler angles.
 */
 vpRzyzVector::vpRzyzVector(const vpThetaUVector& tu)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(tu) ;
 }
 
 /*! Copy constructor from a 3-dimension vector. */
 vpRzyzVector::vpRzyzVector(const vpColVector &rzyz)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   if (rzyz.size() != 3) {
     throw(vpException(vpException::dimensionError, "Cannot construct a R-zyz vector from a %d-dimension col vector", rzyz.size()));
   }
@@ -50,16 +50,21 @@ const double vpThetaUVector::minimum = 0.0001;
 
 /*! Default constructor that initialize all the 3 angles to zero. */
 vpThetaUVector::vpThetaUVector()
-  : vpRotationVector(3)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage);
+}
 /*! Copy constructor. */
 vpThetaUVector::vpThetaUVector(const vpThetaUVector &tu)
-  : vpRotationVector(tu)
-{}
+  : vpRotationVector(), storage()
+{
+  attach(storage, tu);
+}
 /*! Copy constructor from a 3-dimension vector. */
 vpThetaUVector::vpThetaUVector(const vpColVector &tu)
-  : vpRotationVector(3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   if (tu.size() != 3) {
     throw(vpException(vpException::dimensionError, "Cannot construct a theta-u vector from a %d-dimension col vector", tu.size()));
   }
@@ -71,24 +76,27 @@ vpThetaUVector::vpThetaUVector(const vpColVector &tu)
 Initialize a \f$\theta {\bf u}\f$ vector from an homogeneous matrix.
 */
 vpThetaUVector::vpThetaUVector(const vpHomogeneousMatrix& M)
-  : vpRotationVector(3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(M) ;
 }
 /*!
 Initialize a \f$\theta {\bf u}\f$ vector from a pose vector.
 */
 vpThetaUVector::vpThetaUVector(const vpPoseVector& p)
-  : vpRotationVector(3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(p) ;
 }
 /*!
 Initialize a \f$\theta {\bf u}\f$ vector from a rotation matrix.
 */
 vpThetaUVector::vpThetaUVector(const vpRotationMatrix& R)
-  : vpRotationVector(3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(R) ;
 }
 
@@ -97,8 +105,9 @@ Initialize a \f$\theta {\bf u}\f$ vector from an Euler z-y-x
 representation vector.
 */
 vpThetaUVector::vpThetaUVector(const vpRzyxVector& rzyx)
-  : vpRotationVector(3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(rzyx) ;
 } 
 /*!  
@@ -106,8 +115,9 @@ Initialize a \f$\theta {\bf u}\f$ vector from an Euler z-y-z
 representation vector.
 */
 vpThetaUVector::vpThetaUVector(const vpRzyzVector& rzyz)
-  : vpRotationVector(3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(rzyz) ;
 }
 /*!  
@@ -115,8 +125,9 @@ Initialize a \f$\theta {\bf u}\f$ vector from an Euler x-y-z
 representation vector.
 */
 vpThetaUVector::vpThetaUVector(const vpRxyzVector& rxyz)
-  : vpRotationVector(3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(rxyz) ;
 }
 /*!
@@ -124,8 +135,9 @@ Initialize a \f$\theta {\bf u}\f$ vector from a quaternion
 representation vector.
 */
 vpThetaUVector::vpThetaUVector(const vpQuaternionVector& q)
-  : vpRotationVector(4)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(q) ;
 }
 
@@ -133,8 +145,9 @@ vpThetaUVector::vpThetaUVector(const vpQuaternionVector& q)
   Build a \f$\theta {\bf u}\f$ vector from 3 angles in radian.
 */
 vpThetaUVector::vpThetaUVector(const double tux, const double tuy, const double tuz)
-  : vpRotationVector (3)
+  : vpRotationVector(), storage()
 {
+  attach(storage);
   buildFrom(tux, tuy, tuz);
 }
 
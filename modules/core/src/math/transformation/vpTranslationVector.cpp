@@ -54,8 +54,9 @@
 
 */
 vpTranslationVector::vpTranslationVector(const double tx, const double ty, const double tz)
-  : vpArray2D<double>(3, 1)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   (*this)[0] = tx;
   (*this)[1] = ty;
   (*this)[2] = tz;
@@ -69,8 +70,9 @@ vpTranslationVector::vpTranslationVector(const double tx, const double ty, const
 
 */
 vpTranslationVector::vpTranslationVector(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(3, 1)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   M.extract( *this );
 }
 
@@ -82,8 +84,9 @@ vpTranslationVector::vpTranslationVector(const vpHomogeneousMatrix &M)
 
 */
 vpTranslationVector::vpTranslationVector(const vpPoseVector &p)
-  : vpArray2D<double>(3, 1)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   (*this)[0] = p[0];
   (*this)[1] = p[1];
   (*this)[2] = p[2];
@@ -100,8 +103,9 @@ vpTranslationVector::vpTranslationVector(const vpPoseVector &p)
   \endcode
 */
 vpTranslationVector::vpTranslationVector (const vpTranslationVector &tv)
-  : vpArray2D<double>(tv)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage, tv);
 }
 
 /*!
@@ -118,12 +122,14 @@ vpTranslationVector::vpTranslationVector (const vpTranslationVector &tv)
 
 */
 vpTranslationVector::vpTranslationVector (const vpColVector &v)
-  : vpArray2D<double>(v)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   if (v.size() != 3) {
     throw(vpException(vpException::dimensionError,
                       "Cannot construct a translation vector from a %d-dimension column vector", v.size()));
   }
+  memcpy(data, v.data, 3*sizeof(double));
 }
 
 /*!
@@ -89,8 +89,9 @@ vpVelocityTwistMatrix::eye()
   Initialize a velocity twist transformation matrix as identity.
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix()
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   eye() ;
 }
 
@@ -100,8 +101,9 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix()
   \param V : Velocity twist matrix used as initializer.
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   *this = V;
 }
 
@@ -116,8 +118,9 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V)
 
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(M);
 }
 
@@ -133,8 +136,9 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M)
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
                                              const vpThetaUVector &thetau)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(t, thetau) ;
 }
 
@@ -150,8 +154,9 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
                                              const vpRotationMatrix &R)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   buildFrom(t,R) ;
 }
 
@@ -171,8 +176,9 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const double tx,
 					     const double tux,
 					     const double tuy,
                const double tuz)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(), storage()
 {
+  attach(storage);
   vpTranslationVector T(tx,ty,tz) ;
   vpThetaUVector tu(tux,tuy,tuz) ;
   buildFrom(T,tu) ;  
@@ -307,17 +313,21 @@ vpVelocityTwistMatrix
 vpVelocityTwistMatrix::buildFrom(const vpTranslationVector &t,
                                  const vpRotationMatrix &R)
 {
-  unsigned int i, j;
-  vpMatrix skewaR = t.skew(t)*R ;
+  // [t]_x R computed in place, without the intermediate skew matrix
+  double skewaR[3][3];
+  for (unsigned int j=0 ; j < 3 ; j++) {
+    skewaR[0][j] = t[1]*R[2][j] - t[2]*R[1][j] ;
+    skewaR[1][j] = t[2]*R[0][j] - t[0]*R[2][j] ;
+    skewaR[2][j] = t[0]*R[1][j] - t[1]*R[0][j] ;
+  }
 
-  for (i=0 ; i < 3 ; i++)
-    for (j=0 ; j < 3 ; j++)
-    {
+  for (unsigned int i=0 ; i < 3 ; i++) {
+    for (unsigned int j=0 ; j < 3 ; j++) {
       (*this)[i][j] = R[i][j] ;
       (*this)[i+3][j+3] = R[i][j] ;
       (*this)[i][j+3] = skewaR[i][j] ;
-
     }
+  }
   return (*this) ;
 }
 
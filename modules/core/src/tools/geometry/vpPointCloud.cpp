@@ -0,0 +1,329 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Packed point cloud.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPointCloud.cpp
+  \brief Packed point cloud.
+*/
+
+#include <cmath>
+#include <limits>
+
+#include <visp3/core/vpPointCloud.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  bool sameParameters(const vpCameraParameters &cam1, const vpCameraParameters &cam2)
+  {
+    const double eps = std::numeric_limits<double>::epsilon();
+    return (cam1.get_projModel() == cam2.get_projModel())
+        && (std::fabs(cam1.get_px() - cam2.get_px()) <= eps) && (std::fabs(cam1.get_py() - cam2.get_py()) <= eps)
+        && (std::fabs(cam1.get_u0() - cam2.get_u0()) <= eps) && (std::fabs(cam1.get_v0() - cam2.get_v0()) <= eps)
+        && (std::fabs(cam1.get_kud() - cam2.get_kud()) <= eps)
+        && (std::fabs(cam1.get_kdu() - cam2.get_kdu()) <= eps);
+  }
+
+  // Deproject n contiguous pixels. Z is kept if 0 < Z <= max_Z and set to 0 otherwise,
+  // so that invalid pixels get null coordinates. NaN depths are also rejected.
+  void deprojectPoints(const float *depth, const float *xmap, const float *ymap, unsigned int n, float max_Z,
+                    float *X, float *Y, float *Z)
+  {
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxZ = _mm_set1_ps(max_Z);
+    for (; j + 4 <= n; j += 4) {
+      __m128 z = _mm_loadu_ps(depth + j);
+      const __m128 valid = _mm_and_ps(_mm_cmpgt_ps(z, zero), _mm_cmple_ps(z, maxZ));
+      z = _mm_and_ps(z, valid);
+      _mm_storeu_ps(X + j, _mm_mul_ps(_mm_loadu_ps(xmap + j), z));
+      _mm_storeu_ps(Y + j, _mm_mul_ps(_mm_loadu_ps(ymap + j), z));
+      _mm_storeu_ps(Z + j, z);
+    }
+#endif
+    for (; j < n; j++) {
+      float z = depth[j];
+      if (! (z > 0.f && z <= max_Z))
+        z = 0.f;
+      X[j] = xmap[j] * z;
+      Y[j] = ymap[j] * z;
+      Z[j] = z;
+    }
+  }
+
+  void deprojectPoints(const uint16_t *depth, const float *xmap, const float *ymap, unsigned int n, float depth_scale, float max_Z,
+                    float *X, float *Y, float *Z)
+  {
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    const __m128i zeroi = _mm_setzero_si128();
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxZ = _mm_set1_ps(max_Z);
+    const __m128 scale = _mm_set1_ps(depth_scale);
+    for (; j + 8 <= n; j += 8) {
+      const __m128i d = _mm_loadu_si128((const __m128i *)(depth + j));
+      __m128 z[2];
+      z[0] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(d, zeroi)), scale);
+      z[1] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(d, zeroi)), scale);
+      for (unsigned int k = 0; k < 2; k++) {
+        const unsigned int jk = j + 4*k;
+        const __m128 valid = _mm_and_ps(_mm_cmpgt_ps(z[k], zero), _mm_cmple_ps(z[k], maxZ));
+        z[k] = _mm_and_ps(z[k], valid);
+        _mm_storeu_ps(X + jk, _mm_mul_ps(_mm_loadu_ps(xmap + jk), z[k]));
+        _mm_storeu_ps(Y + jk, _mm_mul_ps(_mm_loadu_ps(ymap + jk), z[k]));
+        _mm_storeu_ps(Z + jk, z[k]);
+      }
+    }
+#endif
+    for (; j < n; j++) {
+      float z = depth[j] * depth_scale;
+      if (! (z > 0.f && z <= max_Z))
+        z = 0.f;
+      X[j] = xmap[j] * z;
+      Y[j] = ymap[j] * z;
+      Z[j] = z;
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor that builds an empty point cloud.
+*/
+vpPointCloud::vpPointCloud()
+  : m_X(), m_Y(), m_Z(), m_height(0), m_width(0),
+    m_xmap(), m_ymap(), m_map_cam(), m_map_height(0), m_map_width(0)
+{
+}
+
+/*!
+  Build an organized point cloud of \e height x \e width points with null coordinates.
+*/
+vpPointCloud::vpPointCloud(const unsigned int height, const unsigned int width)
+  : m_X(), m_Y(), m_Z(), m_height(0), m_width(0),
+    m_xmap(), m_ymap(), m_map_cam(), m_map_height(0), m_map_width(0)
+{
+  resize(height, width);
+}
+
+/*!
+  Build an unorganized point cloud from points given as column vectors.
+
+  \param points : Points with at least 3 coordinates X, Y, Z. When a point has a
+  fourth homogeneous coordinate different from 1, X, Y, Z are divided by it.
+
+  \exception vpException::dimensionError : If a point has less than 3 coordinates.
+*/
+void vpPointCloud::buildFrom(const std::vector<vpColVector> &points)
+{
+  resize(1, (unsigned int)points.size());
+  for (unsigned int i = 0; i < m_width; i++) {
+    const vpColVector &p = points[i];
+    if (p.size() < 3)
+      throw vpException(vpException::dimensionError, "Cannot build a point cloud from a %d-dimension vector", p.size());
+    double w = 1.;
+    if (p.size() > 3 && std::fabs(p[3]) > std::numeric_limits<double>::epsilon())
+      w = p[3];
+    m_X[i] = (float)(p[0] / w);
+    m_Y[i] = (float)(p[1] / w);
+    m_Z[i] = (float)(p[2] / w);
+  }
+}
+
+/*!
+  Remove all the points. The memory is kept to be reused.
+*/
+void vpPointCloud::clear()
+{
+  m_height = m_width = 0;
+  m_X.clear();
+  m_Y.clear();
+  m_Z.clear();
+}
+
+/*!
+  Convert the point cloud into a vector of 4-dimension column vectors that
+  contain X, Y, Z, 1 coordinates, as returned by vpRealSense::acquire().
+
+  The column vectors already present in \e points are reused, so that a
+  conversion at each frame into the same vector doesn't allocate memory.
+*/
+void vpPointCloud::convert(std::vector<vpColVector> &points) const
+{
+  const unsigned int n = size();
+  points.resize(n);
+  for (unsigned int i = 0; i < n; i++) {
+    vpColVector &p = points[i];
+    if (p.size() != 4)
+      p.resize(4, false);
+    p[0] = m_X[i];
+    p[1] = m_Y[i];
+    p[2] = m_Z[i];
+    p[3] = 1.;
+  }
+}
+
+/*!
+  Build the point cloud from a depth map given in raw units.
+
+  \param depth : Depth map. The depth in meter is \e depth_scale times the raw value.
+  \param depth_scale : Scale from the depth unit to meter.
+  \param cam : Intrinsic parameters of the depth camera. With a model with
+  distortion, the normalized coordinates are computed by vpPixelMeterConversion.
+  \param max_Z : Depth above which a pixel is considered as invalid.
+
+  The cloud is organized like \e depth. Pixels with a null depth or a depth
+  greater than \e max_Z lead to points with null coordinates. The deprojection
+  maps are only computed when the camera parameters or the size change.
+*/
+void vpPointCloud::deproject(const vpImage<uint16_t> &depth, const float depth_scale, const vpCameraParameters &cam, const float max_Z)
+{
+  if (depth.getSize() == 0) {
+    clear();
+    return;
+  }
+  updateDeprojectionMaps(cam, depth.getHeight(), depth.getWidth());
+  deproject(depth.bitmap, &m_xmap[0], &m_ymap[0], depth.getHeight(), depth.getWidth(), depth_scale, max_Z);
+}
+
+/*!
+  Build the point cloud from a metric depth map.
+
+  \param depth : Depth map in meter. Negative or NaN values denote invalid pixels.
+  \param cam : Intrinsic parameters of the depth camera.
+  \param max_Z : Depth above which a pixel is considered as invalid.
+
+  \sa deproject(const vpImage<uint16_t> &, const float, const vpCameraParameters &, const float)
+*/
+void vpPointCloud::deproject(const vpImage<float> &depth, const vpCameraParameters &cam, const float max_Z)
+{
+  if (depth.getSize() == 0) {
+    clear();
+    return;
+  }
+  updateDeprojectionMaps(cam, depth.getHeight(), depth.getWidth());
+  deproject(depth.bitmap, &m_xmap[0], &m_ymap[0], depth.getHeight(), depth.getWidth(), max_Z);
+}
+
+/*!
+  Build the point cloud from a raw depth buffer and user deprojection maps.
+
+  \param depth : Depth buffer of \e height x \e width raw values.
+  \param xmap, ymap : Normalized coordinates (at a depth of 1 meter) of each
+  pixel, as computed by initDeprojectionMaps() or from the SDK of the sensor.
+  \param height, width : Size of the depth buffer.
+  \param depth_scale : Scale from the depth unit to meter.
+  \param max_Z : Depth above which a pixel is considered as invalid.
+*/
+void vpPointCloud::deproject(const uint16_t *depth, const float *xmap, const float *ymap,
+                             const unsigned int height, const unsigned int width, const float depth_scale, const float max_Z)
+{
+  resize(height, width);
+  if (size() == 0)
+    return;
+  deprojectPoints(depth, xmap, ymap, size(), depth_scale, max_Z, &m_X[0], &m_Y[0], &m_Z[0]);
+}
+
+/*!
+  Build the point cloud from a metric depth buffer and user deprojection maps.
+
+  \param depth : Depth buffer of \e height x \e width values in meter.
+  \param xmap, ymap : Normalized coordinates (at a depth of 1 meter) of each pixel.
+  \param height, width : Size of the depth buffer.
+  \param max_Z : Depth above which a pixel is considered as invalid.
+*/
+void vpPointCloud::deproject(const float *depth, const float *xmap, const float *ymap,
+                             const unsigned int height, const unsigned int width, const float max_Z)
+{
+  resize(height, width);
+  if (size() == 0)
+    return;
+  deprojectPoints(depth, xmap, ymap, size(), max_Z, &m_X[0], &m_Y[0], &m_Z[0]);
+}
+
+/*!
+  Compute the normalized coordinates \f$(x,y)\f$ of each pixel of an image of
+  size \e height x \e width. The point deprojected from pixel \f$(i,j)\f$ at
+  depth \f$Z\f$ is then \f$(x Z, y Z, Z)\f$ with \f$ x = xmap[i \times width + j] \f$.
+
+  \param cam : Camera parameters.
+  \param height, width : Image size.
+  \param xmap, ymap : Deprojection maps.
+*/
+void vpPointCloud::initDeprojectionMaps(const vpCameraParameters &cam, const unsigned int height, const unsigned int width,
+                                        std::vector<float> &xmap, std::vector<float> &ymap)
+{
+  xmap.resize(height*width);
+  ymap.resize(height*width);
+  double x = 0, y = 0;
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      vpPixelMeterConversion::convertPoint(cam, (double)j, (double)i, x, y);
+      xmap[i*width + j] = (float)x;
+      ymap[i*width + j] = (float)y;
+    }
+  }
+}
+
+/*!
+  Resize the point cloud. The memory is only reallocated when the number of
+  points grows. The coordinates are not initialized.
+
+  \param height, width : Number of rows and columns. Use a height of 1 for an
+  unorganized point cloud.
+*/
+void vpPointCloud::resize(const unsigned int height, const unsigned int width)
+{
+  m_height = height;
+  m_width = width;
+  m_X.resize(height*width);
+  m_Y.resize(height*width);
+  m_Z.resize(height*width);
+}
+
+void vpPointCloud::updateDeprojectionMaps(const vpCameraParameters &cam, const unsigned int height, const unsigned int width)
+{
+  if (height == m_map_height && width == m_map_width && sameParameters(cam, m_map_cam) && ! m_xmap.empty())
+    return;
+  initDeprojectionMaps(cam, height, width, m_xmap, m_ymap);
+  m_map_cam = cam;
+  m_map_height = height;
+  m_map_width = width;
+}
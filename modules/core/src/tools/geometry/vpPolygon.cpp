@@ -46,6 +46,83 @@
 #include <visp3/core/vpUniRand.h>
 #include <set>
 #include <limits>
+#include <algorithm>
+#include <string.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+/*
+  Edges are crossed by the horizontal line of ordinate i - eps, eps > 0 being
+  infinitely small, when one of their end points is strictly above i and the
+  other is on or below: a vertex shared by two edges is counted once and
+  horizontal edges are ignored. An edge of slope m = dj/di crossing the line at
+  abscissa x is on the right of the point (i - eps, j - eps) when j < x, or
+  when j == x and m < 1. This is how isInside(const vpImagePoint &), whose
+  ray goes towards the bottom right, classifies points lying on an edge.
+*/
+inline bool crossingOnTheRight(const double j, const double x, const double m)
+{
+  return j < x || (j == x && m < 1.);
+}
+
+/*
+  First pixel on the left of which the crossing (x, m) lies, following the
+  rule of crossingOnTheRight().
+*/
+inline double firstPixelAfter(const double x, const double m)
+{
+  return (m < 1.) ? floor(x) + 1. : ceil(x);
+}
+
+/*
+  Spans of pixels of row i that are inside the polygon, as a sorted list of
+  pixel indices [xs[0], xs[1]), [xs[2], xs[3])...
+*/
+void scanLineCrossings(const std::vector<vpImagePoint> &roi, const double i, std::vector<double> &xs)
+{
+  // Crossings sorted along the line i - eps: by abscissa, then by decreasing slope
+  std::vector< std::pair<double, double> > crossings;
+  const size_t n = roi.size();
+  for (size_t k = 0, l = n-1; k < n; l = k++) {
+    const double i1 = roi[l].get_i(), i2 = roi[k].get_i();
+    if ((i1 < i) != (i2 < i)) {
+      const double j1 = roi[l].get_j(), j2 = roi[k].get_j();
+      const double m = (j2 - j1) / (i2 - i1);
+      crossings.push_back(std::make_pair(j1 + (i - i1) * m, -m));
+    }
+  }
+  std::sort(crossings.begin(), crossings.end());
+
+  xs.clear();
+  for (size_t k = 0; k < crossings.size(); k++)
+    xs.push_back(firstPixelAfter(crossings[k].first, -crossings[k].second));
+}
+
+/*
+  Intersection of the spans a and b+shift, where a span list is a sorted list
+  of [start, end) pairs as given by scanLineCrossings().
+*/
+void intersectSpans(const std::vector<double> &a, const std::vector<double> &b, const double shift,
+                    std::vector<double> &out)
+{
+  out.clear();
+  size_t ka = 0, kb = 0;
+  while (ka+1 < a.size() && kb+1 < b.size()) {
+    const double start = std::max(a[ka], b[kb]+shift);
+    const double end = std::min(a[ka+1], b[kb+1]+shift);
+    if (start < end) {
+      out.push_back(start);
+      out.push_back(end);
+    }
+    if (a[ka+1] < b[kb+1]+shift)
+      ka += 2;
+    else
+      kb += 2;
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Basic constructor.
   
@@ -496,6 +573,138 @@ vpPolygon::isInside(const std::vector<vpImagePoint>& roi, const double &i, const
   return poly.isInside(vpImagePoint(i, j));
 }
 
+/*!
+  Test if image points are inside the polygon.
+
+  Contrary to isInside(const vpImagePoint &), the test does not rely on a
+  random ray and does not throw: a point is inside when the horizontal ray
+  starting from it crosses an odd number of edges. A point lying on an edge is
+  inside when the polygon is on its top left side, as with
+  isInside(const vpImagePoint &) whose ray goes towards the bottom right. This
+  is the rule used by fillMask().
+
+  \param ips : Image points to test.
+  \param inside : For each point of \e ips, true if the point is inside the polygon.
+*/
+void
+vpPolygon::isInside(const std::vector<vpImagePoint> &ips, std::vector<bool> &inside) const
+{
+  vpPolygon::isInside(_corners, ips, inside);
+}
+
+/*!
+  Test if image points are inside a 2D polygon.
+
+  \param roi : List of the polygon corners.
+  \param ips : Image points to test.
+  \param inside : For each point of \e ips, true if the point is inside the polygon.
+
+  \sa isInside(const std::vector<vpImagePoint> &, std::vector<bool> &) const
+*/
+void
+vpPolygon::isInside(const std::vector<vpImagePoint> &roi, const std::vector<vpImagePoint> &ips,
+                    std::vector<bool> &inside)
+{
+  inside.assign(ips.size(), false);
+  const size_t n = roi.size();
+  if (n < 3)
+    return;
+
+  for (size_t p = 0; p < ips.size(); p++) {
+    const double i = ips[p].get_i();
+    const double j = ips[p].get_j();
+    bool odd = false;
+    for (size_t k = 0, l = n-1; k < n; l = k++) {
+      const double i1 = roi[l].get_i(), i2 = roi[k].get_i();
+      if ((i1 < i) != (i2 < i)) {
+        const double j1 = roi[l].get_j(), j2 = roi[k].get_j();
+        const double m = (j2 - j1) / (i2 - i1);
+        if (crossingOnTheRight(j, j1 + (i - i1) * m, m))
+          odd = !odd;
+      }
+    }
+    inside[p] = odd;
+  }
+}
+
+/*!
+  Set to \e value the pixels of \e mask that are inside the polygon.
+  Other pixels are left unchanged.
+
+  \param mask : Image to update. Its size is not modified.
+  \param value : Value of the pixels inside the polygon.
+  \param shiftBorder : Erosion in pixels. When not zero, a pixel \f$(i,j)\f$
+  is set only if the four pixels \f$(i \pm shiftBorder, j \pm shiftBorder)\f$
+  are also inside the polygon.
+
+  \sa fillMask(const std::vector<vpImagePoint> &, unsigned char *, unsigned int, unsigned int, unsigned int, unsigned char, unsigned int)
+*/
+void
+vpPolygon::fillMask(vpImage<unsigned char> &mask, unsigned char value, unsigned int shiftBorder) const
+{
+  vpPolygon::fillMask(_corners, mask.bitmap, mask.getHeight(), mask.getWidth(), mask.getWidth(), value, shiftBorder);
+}
+
+/*!
+  Set to \e value the pixels of a mask that are inside a 2D polygon.
+
+  The polygon is rasterised scan line by scan line: for each row, the
+  crossings with the edges give the spans of pixels that are inside the
+  polygon, so the cost depends on the number of rows and edges rather than
+  on the number of pixels. A pixel is inside under the same rule as
+  isInside(const std::vector<vpImagePoint> &, const std::vector<vpImagePoint> &, std::vector<bool> &).
+
+  \param roi : List of the polygon corners.
+  \param mask : Address of the first pixel of the mask. Pixels outside the
+  polygon are left unchanged.
+  \param height, width : Size of the mask.
+  \param stride : Number of bytes between two rows of the mask.
+  \param value : Value of the pixels inside the polygon.
+  \param shiftBorder : Erosion in pixels. When not zero, a pixel \f$(i,j)\f$
+  is set only if the four pixels \f$(i \pm shiftBorder, j \pm shiftBorder)\f$
+  are also inside the polygon.
+*/
+void
+vpPolygon::fillMask(const std::vector<vpImagePoint> &roi, unsigned char *mask,
+                    unsigned int height, unsigned int width, unsigned int stride,
+                    unsigned char value, unsigned int shiftBorder)
+{
+  if (roi.size() < 3 || height == 0 || width == 0)
+    return;
+
+  double i_min = roi[0].get_i(), i_max = roi[0].get_i();
+  for (size_t k = 1; k < roi.size(); k++) {
+    i_min = std::min(i_min, roi[k].get_i());
+    i_max = std::max(i_max, roi[k].get_i());
+  }
+
+  const double s = (double)shiftBorder;
+  int first = std::max(0, (int)floor(i_min + s) + 1);
+  int last = std::min((int)height - 1, (int)floor(i_max - s));
+
+  std::vector<double> spans, above, below, tmp;
+  for (int i = first; i <= last; i++) {
+    scanLineCrossings(roi, i, spans);
+    if (shiftBorder != 0) {
+      scanLineCrossings(roi, i - s, above);
+      scanLineCrossings(roi, i + s, below);
+      intersectSpans(spans, above, -s, tmp);
+      intersectSpans(tmp, above, s, spans);
+      intersectSpans(spans, below, -s, tmp);
+      intersectSpans(tmp, below, s, spans);
+    }
+
+    unsigned char *row = mask + (size_t)i * stride;
+    for (size_t k = 0; k+1 < spans.size(); k += 2) {
+      // Pixels j such that spans[k] <= j < spans[k+1]
+      int j_start = (int)std::max(0., spans[k]);
+      int j_end = (int)std::min((double)width, spans[k+1]);
+      if (j_start < j_end)
+        memset(row + j_start, value, (size_t)(j_end - j_start));
+    }
+  }
+}
+
 /*!
   Return number of corners belonging to the polygon.
  */
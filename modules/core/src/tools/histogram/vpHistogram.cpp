@@ -45,92 +45,77 @@
 */
 
 #include <stdlib.h>
+#include <vector>
 #include <visp3/core/vpHistogram.h>
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/core/vpDisplay.h>
+#include <visp3/core/vpThreadPool.h>
 
 
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-#include <visp3/core/vpThread.h>
-
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
 namespace {
-  struct Histogram_Param_t {
-    unsigned int m_start_index;
-    unsigned int m_end_index;
-
-    unsigned int m_lut[256];
-    unsigned int *m_histogram;
-    const vpImage<unsigned char> *m_I;
-
-    Histogram_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_histogram(NULL), m_I(NULL) {
-    }
-
-    Histogram_Param_t(const unsigned int start_index, const unsigned int end_index,
-        const vpImage<unsigned char> * const I) :
-      m_start_index(start_index), m_end_index(end_index), m_lut(), m_histogram(NULL), m_I(I) {
+  /*
+    Each sub-range of pixels is accumulated in its own histogram, the
+    sub-range size being the grain size given to vpThreadPool::parallel_for().
+  */
+  class vpHistogramTask : public vpThreadPool::vpRangeTask {
+  public:
+    vpHistogramTask(const vpImage<unsigned char> &I, const unsigned int *lut, unsigned int *histograms,
+                    unsigned int size, unsigned int step) :
+      m_I(I), m_lut(lut), m_histograms(histograms), m_size(size), m_step(step) {
     }
 
-    ~Histogram_Param_t() {
-      if(m_histogram != NULL) {
-        delete []m_histogram;
-      }
-    }
-  };
-
-  vpThread::Return computeHistogramThread(vpThread::Args args) {
-    Histogram_Param_t *histogram_param = ( (Histogram_Param_t *) args );
-    unsigned int start_index = histogram_param->m_start_index;
-    unsigned int end_index = histogram_param->m_end_index;
+    void run(unsigned int start_index, unsigned int end_index) {
+      unsigned int *histogram = m_histograms + (start_index / m_step) * m_size;
 
-    const vpImage<unsigned char> *I = histogram_param->m_I;
+      unsigned char *ptrEnd = (unsigned char*) (m_I.bitmap) + end_index;
+      unsigned char *ptrCurrent = (unsigned char*) (m_I.bitmap) + start_index;
 
-    unsigned char *ptrStart = (unsigned char*) (I->bitmap) + start_index;
-    unsigned char *ptrEnd = (unsigned char*) (I->bitmap) + end_index;
-    unsigned char *ptrCurrent = ptrStart;
-
-
-//    while(ptrCurrent != ptrEnd) {
-//      histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-//      ++ptrCurrent;
-//    }
+      if(end_index - start_index >= 8) {
+        //Unroll loop version
+        for(; ptrCurrent <= ptrEnd - 8;) {
+          histogram[ m_lut[ *ptrCurrent ] ] ++;
+          ++ptrCurrent;
 
-    if(end_index - start_index >= 8) {
-      //Unroll loop version
-      for(; ptrCurrent <= ptrEnd - 8;) {
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
+          histogram[ m_lut[ *ptrCurrent ] ] ++;
+          ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
+          histogram[ m_lut[ *ptrCurrent ] ] ++;
+          ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
+          histogram[ m_lut[ *ptrCurrent ] ] ++;
+          ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
+          histogram[ m_lut[ *ptrCurrent ] ] ++;
+          ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
+          histogram[ m_lut[ *ptrCurrent ] ] ++;
+          ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
+          histogram[ m_lut[ *ptrCurrent ] ] ++;
+          ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
+          histogram[ m_lut[ *ptrCurrent ] ] ++;
+          ++ptrCurrent;
+        }
+      }
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
+      for(; ptrCurrent != ptrEnd; ++ptrCurrent) {
+        histogram[ m_lut[ *ptrCurrent ] ] ++;
       }
     }
 
-    for(; ptrCurrent != ptrEnd; ++ptrCurrent) {
-      histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-    }
+  private:
+    const vpImage<unsigned char> &m_I;
+    const unsigned int *m_lut;
+    unsigned int *m_histograms;
+    unsigned int m_size;
+    unsigned int m_step;
 
-    return 0;
-  }
+    vpHistogramTask &operator=(const vpHistogramTask &);
+  };
 }
-#endif
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 bool compare_vpHistogramPeak (vpHistogramPeak first, vpHistogramPeak second);
 
@@ -238,7 +223,9 @@ vpHistogram::init(unsigned size_)
 
   \param I : Gray level image.
   \param nbins : Number of bins to compute the histogram.
-  \param nbThreads : Number of threads to use for the computation.
+  \param nbThreads : Number of sub-ranges the image is split in. When greater
+  than 1, the sub-ranges are processed by the threads of vpThreadPool, whose
+  number is set by vpThreadPool::setNumThreads().
 */
 void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int nbins, const unsigned int nbThreads)
 {
@@ -288,63 +275,24 @@ void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int
       ++ptrCurrent;
     }
   } else {
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-    //Multi-threads
-
-    std::vector<vpThread *> threadpool;
-    std::vector<Histogram_Param_t *> histogramParams;
-
-    Histogram_Param_t *histogram_param = NULL;
-    vpThread *histogram_thread = NULL;
-
+    //Multi-threads, using the threads of vpThreadPool
     unsigned int image_size = I.getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads-1);
+    unsigned int step = (image_size + nbThreads - 1) / nbThreads;
+    unsigned int nbSteps = (image_size + step - 1) / step;
 
-    for(unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index*step;
-      unsigned int end_index = (index+1)*step;
-
-      if(index == nbThreads-1) {
-        end_index = start_index+last_step;
-      }
-
-      histogram_param = new Histogram_Param_t(start_index, end_index, &I);
-      histogram_param->m_histogram = new unsigned int[size];
-      memset(histogram_param->m_histogram, 0, size * sizeof(unsigned int));
-      memcpy(histogram_param->m_lut, lut, 256*sizeof(unsigned int));
-
-      histogramParams.push_back(histogram_param);
-
-      // Start the threads
-      histogram_thread = new vpThread((vpThread::Fn) computeHistogramThread, (vpThread::Args) histogram_param);
-      threadpool.push_back(histogram_thread);
-    }
-
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
+    std::vector<unsigned int> histograms(nbSteps * size, 0);
+    vpHistogramTask task(I, lut, &histograms[0], size, step);
+    vpThreadPool::parallel_for(0, image_size, task, step);
 
     for(unsigned int cpt1 = 0; cpt1 < size; cpt1++) {
       unsigned int sum = 0;
 
-      for(size_t cpt2 = 0; cpt2 < histogramParams.size(); cpt2++) {
-        sum += histogramParams[cpt2]->m_histogram[cpt1];
+      for(unsigned int cpt2 = 0; cpt2 < nbSteps; cpt2++) {
+        sum += histograms[cpt2 * size + cpt1];
       }
 
       histogram[cpt1] = sum;
     }
-
-    //Delete
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for(size_t cpt = 0; cpt < histogramParams.size(); cpt++) {
-      delete histogramParams[cpt];
-    }
-#endif
   }
 }
 
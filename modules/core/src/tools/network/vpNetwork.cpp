@@ -38,11 +38,25 @@
 
 #include <visp3/core/vpNetwork.h>
 
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+#  include <errno.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  //! Marker at the beginning of each binary frame, used to detect a desynchronized stream.
+  const unsigned int vpFrameMagic = 0x56504652; // "VPFR"
+
+  //! Binary frame header: magic, payload type, user tag, payload size.
+  const unsigned int vpFrameHeaderSize = 4 * sizeof(unsigned int);
+}
+#endif
+
 vpNetwork::vpNetwork()
   : emitter(), receptor_list(), readFileDescriptor(), socketMax(0), request_list(),
     max_size_message(999999), separator("[*@*]"), beginning("[*start*]"), end("[*end*]"),
     param_sep("[*|*]"), currentMessageReceived(), tv(), tv_sec(0), tv_usec(10),
-    verboseMode(false)
+    verboseMode(false), recvBuffer(), frameBuffer(), frameSize(0)
 { 
   tv.tv_sec = tv_sec;
 #if TARGET_OS_IPHONE
@@ -467,7 +481,198 @@ int vpNetwork::receiveAndDecodeRequestOnceFrom(const unsigned int &receptorEmitt
   
   return res;
 }
-  
+
+
+/*!
+  Send a binary frame to the first receptor in the list. The frame is made of
+  a header that contains the tag and the size of the data, followed by the
+  data that are sent directly from their memory.
+
+  \sa vpNetwork::sendFrameTo()
+  \sa vpNetwork::sendImage()
+  \sa vpNetwork::sendMatrix()
+  \sa vpNetwork::receiveFrame()
+
+  \param tag : Value given back to the receptor by receiveFrame(), that can be
+  used to identify the content of the frame.
+  \param data : Data to send.
+  \param size : Size of the data in bytes.
+
+  \return The number of bytes sent, header included, or -1 if an error happened.
+*/
+int vpNetwork::sendFrame(const unsigned int &tag, const void *data, const unsigned int &size)
+{
+  return sendFrameTo(tag, data, size, 0);
+}
+
+/*!
+  Send a binary frame to a specific receptor. The frame is made of a header
+  that contains the tag and the size of the data, followed by the data that are
+  sent directly from their memory.
+
+  \sa vpNetwork::getReceptorIndex()
+  \sa vpNetwork::sendFrame()
+  \sa vpNetwork::receiveFrameFrom()
+
+  \param tag : Value given back to the receptor by receiveFrameFrom(), that can
+  be used to identify the content of the frame.
+  \param data : Data to send.
+  \param size : Size of the data in bytes.
+  \param dest : Index of the receptor receiving the frame.
+
+  \return The number of bytes sent, header included, or -1 if an error happened.
+*/
+int vpNetwork::sendFrameTo(const unsigned int &tag, const void *data, const unsigned int &size, const unsigned int &dest)
+{
+  vpFramePart part;
+  part.data = data;
+  part.size = size;
+  return _sendFrameTo(FRAME_DATA, tag, &part, 1, dest);
+}
+
+/*!
+  Send a matrix in a binary frame to the first receptor in the list. The
+  elements of the matrix are sent directly from its memory, without
+  conversion. This function can be used for any matrix that inherits from
+  vpArray2D<double>, like vpMatrix, vpHomogeneousMatrix or vpColVector.
+
+  \sa vpNetwork::sendMatrixTo()
+  \sa vpNetwork::receiveMatrix()
+
+  \param M : Matrix to send.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+int vpNetwork::sendMatrix(const vpArray2D<double> &M)
+{
+  return sendMatrixTo(M, 0);
+}
+
+/*!
+  Send a matrix in a binary frame to a specific receptor. The elements of the
+  matrix are sent directly from its memory, without conversion.
+
+  \sa vpNetwork::getReceptorIndex()
+  \sa vpNetwork::sendMatrix()
+  \sa vpNetwork::receiveMatrixFrom()
+
+  \param M : Matrix to send.
+  \param dest : Index of the receptor that you are sending the matrix.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+int vpNetwork::sendMatrixTo(const vpArray2D<double> &M, const unsigned int &dest)
+{
+  unsigned int desc[2];
+  desc[0] = M.getRows();
+  desc[1] = M.getCols();
+
+  vpFramePart parts[2];
+  parts[0].data = desc;
+  parts[0].size = (unsigned int)sizeof(desc);
+  parts[1].data = M.data;
+  parts[1].size = M.size() * (unsigned int)sizeof(double);
+
+  return _sendFrameTo(FRAME_MATRIX, 0, parts, 2, dest);
+}
+
+/*!
+  Receive a binary frame sent with sendFrame() or sendFrameTo() by any
+  receptor. The data of the frame are received in a buffer that is kept from
+  one frame to the next, and that can be accessed with getFrameData() and
+  getFrameSize().
+
+  \sa vpNetwork::receiveFrameFrom()
+  \sa vpNetwork::sendFrame()
+
+  \param tag : Tag of the received frame.
+
+  \return The number of bytes received, header included, 0 if no frame was
+  received before the timeout (see setTimeoutSec() and setTimeoutUSec()), or -1
+  if an error occured, or if the frame is an image or a matrix frame.
+*/
+int vpNetwork::receiveFrame(unsigned int &tag)
+{
+  unsigned int size, index;
+  int res = _receiveFrameHeader(-1, FRAME_DATA, tag, size, index);
+  if (res <= 0)
+    return res;
+
+  if (_receiveFrameBuffer(index, size) < 0)
+    return -1;
+
+  return res + (int)size;
+}
+
+/*!
+  Receive a binary frame sent with sendFrame() or sendFrameTo() by a specific
+  receptor. The data of the frame are received in a buffer that is kept from
+  one frame to the next, and that can be accessed with getFrameData() and
+  getFrameSize().
+
+  \sa vpNetwork::getReceptorIndex()
+  \sa vpNetwork::receiveFrame()
+  \sa vpNetwork::sendFrameTo()
+
+  \param tag : Tag of the received frame.
+  \param receptorEmitting : Index of the receptor emitting the frame.
+
+  \return The number of bytes received, header included, 0 if no frame was
+  received before the timeout (see setTimeoutSec() and setTimeoutUSec()), or -1
+  if an error occured, or if the frame is an image or a matrix frame.
+*/
+int vpNetwork::receiveFrameFrom(unsigned int &tag, const unsigned int &receptorEmitting)
+{
+  unsigned int size, index;
+  int res = _receiveFrameHeader((int)receptorEmitting, FRAME_DATA, tag, size, index);
+  if (res <= 0)
+    return res;
+
+  if (_receiveFrameBuffer(index, size) < 0)
+    return -1;
+
+  return res + (int)size;
+}
+
+/*!
+  Receive a matrix sent with sendMatrix() or sendMatrixTo() by any receptor.
+  The matrix is resized if needed, and its elements are received directly in
+  its memory.
+
+  \sa vpNetwork::receiveMatrixFrom()
+  \sa vpNetwork::sendMatrix()
+
+  \param M : Received matrix.
+
+  \return The number of bytes received, 0 if no frame was received before the
+  timeout (see setTimeoutSec() and setTimeoutUSec()), or -1 if an error occured,
+  or if the frame does not contain a matrix.
+*/
+int vpNetwork::receiveMatrix(vpArray2D<double> &M)
+{
+  return _receiveMatrix(M, -1);
+}
+
+/*!
+  Receive a matrix sent with sendMatrix() or sendMatrixTo() by a specific
+  receptor. The matrix is resized if needed, and its elements are received
+  directly in its memory.
+
+  \sa vpNetwork::getReceptorIndex()
+  \sa vpNetwork::receiveMatrix()
+  \sa vpNetwork::sendMatrixTo()
+
+  \param M : Received matrix.
+  \param receptorEmitting : Index of the receptor emitting the matrix.
+
+  \return The number of bytes received, 0 if no frame was received before the
+  timeout (see setTimeoutSec() and setTimeoutUSec()), or -1 if an error occured,
+  or if the frame does not contain a matrix.
+*/
+int vpNetwork::receiveMatrixFrom(vpArray2D<double> &M, const unsigned int &receptorEmitting)
+{
+  return _receiveMatrix(M, (int)receptorEmitting);
+}  
 
 //######## Definition of Template Functions ########
 //#                                                #
@@ -690,7 +895,9 @@ int vpNetwork::_receiveRequestOnce()
   else{
     for(unsigned int i=0; i<receptor_list.size(); i++){
       if(FD_ISSET((unsigned int)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor)){
-        char *buf = new char [max_size_message];
+        if(recvBuffer.size() < max_size_message)
+          recvBuffer.resize(max_size_message);
+        char *buf = &recvBuffer[0];
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
         numbytes=(int)recv(receptor_list[i].socketFileDescriptorReceptor, buf, max_size_message, 0);
 #else
@@ -701,14 +908,11 @@ int vpNetwork::_receiveRequestOnce()
         {
           std::cout << "Disconnected : " << inet_ntoa(receptor_list[i].receptorAddress.sin_addr) << std::endl;
           receptor_list.erase(receptor_list.begin()+(int)i);
-          delete [] buf;
           return numbytes;
         }
         else if(numbytes > 0){
-          std::string returnVal(buf, (unsigned int)numbytes);
-          currentMessageReceived.append(returnVal);
+          currentMessageReceived.append(buf, (unsigned int)numbytes);
         }
-        delete [] buf;
         break;
       }
     }
@@ -773,7 +977,9 @@ int vpNetwork::_receiveRequestOnceFrom(const unsigned int &receptorEmitting)
   }
   else{
     if(FD_ISSET((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor,&readFileDescriptor)){
-      char *buf = new char [max_size_message];
+      if(recvBuffer.size() < max_size_message)
+        recvBuffer.resize(max_size_message);
+      char *buf = &recvBuffer[0];
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
       numbytes=(int)recv(receptor_list[receptorEmitting].socketFileDescriptorReceptor, buf, max_size_message, 0);
 #else
@@ -783,14 +989,11 @@ int vpNetwork::_receiveRequestOnceFrom(const unsigned int &receptorEmitting)
       {
         std::cout << "Disconnected : " << inet_ntoa(receptor_list[receptorEmitting].receptorAddress.sin_addr) << std::endl;
         receptor_list.erase(receptor_list.begin()+(int)receptorEmitting);
-        delete [] buf;
         return numbytes;
       }
       else if(numbytes > 0){
-        std::string returnVal(buf, (unsigned int)numbytes);
-        currentMessageReceived.append(returnVal);
+        currentMessageReceived.append(buf, (unsigned int)numbytes);
       }
-      delete [] buf;
     }
   }
   
@@ -798,4 +1001,296 @@ int vpNetwork::_receiveRequestOnceFrom(const unsigned int &receptorEmitting)
 }
 
 
+/*!
+  Receive exactly \e size bytes from a receptor.
+
+  \param receptorEmitting : Index of the receptor emitting the message.
+  \param data : Memory where the bytes are written.
+  \param size : Number of bytes to receive.
+
+  \return The number of bytes received, or -1 if an error occured or if the
+  receptor is disconnected.
+*/
+int vpNetwork::_receiveAll(const unsigned int &receptorEmitting, void *data, const unsigned int &size)
+{
+  char *ptr = (char *)data;
+  unsigned int received = 0;
+  while (received < size) {
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+    int numbytes = (int)recv(receptor_list[receptorEmitting].socketFileDescriptorReceptor, ptr + received, size - received, MSG_WAITALL);
+    if (numbytes < 0 && errno == EINTR)
+      continue;
+#else
+    int numbytes = recv((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor, ptr + received, (int)(size - received), 0);
+#endif
+    if (numbytes <= 0)
+    {
+      std::cout << "Disconnected : " << inet_ntoa(receptor_list[receptorEmitting].receptorAddress.sin_addr) << std::endl;
+      receptor_list.erase(receptor_list.begin()+(int)receptorEmitting);
+      return -1;
+    }
+    received += (unsigned int)numbytes;
+  }
+
+  return (int)size;
+}
+
+/*!
+  Receive the payload of a binary frame in the frame buffer. The buffer only
+  grows, so that no allocation is done once it is large enough.
+
+  \param receptorEmitting : Index of the receptor emitting the message.
+  \param size : Size of the payload.
+
+  \return The number of bytes received, or -1 if an error occured.
+*/
+int vpNetwork::_receiveFrameBuffer(const unsigned int &receptorEmitting, const unsigned int &size)
+{
+  frameSize = 0;
+  if (frameBuffer.size() < size)
+    frameBuffer.resize(size);
+
+  if (size == 0)
+    return 0;
+
+  if (_receiveAll(receptorEmitting, &frameBuffer[0], size) < 0)
+    return -1;
 
+  frameSize = size;
+  return (int)size;
+}
+
+/*!
+  Wait for a binary frame and receive its header.
+
+  \param receptorEmitting : Index of the receptor emitting the frame, or -1 to
+  receive the frame from the first receptor that emits one.
+  \param type : Expected type of frame. If the received frame has another
+  type, its payload is dropped.
+  \param tag : Tag of the frame.
+  \param size : Size of the payload of the frame.
+  \param index : Index of the receptor emitting the frame.
+
+  \return The size of the header, 0 if no frame was received before the
+  timeout, or -1 if an error occured.
+*/
+int vpNetwork::_receiveFrameHeader(const int &receptorEmitting, const unsigned int &type, unsigned int &tag,
+                                   unsigned int &size, unsigned int &index)
+{
+  if(receptor_list.size() == 0 || (receptorEmitting >= 0 && (unsigned int)receptorEmitting > (unsigned int)receptor_list.size()-1))
+  {
+    if(verboseMode)
+      vpTRACE( "No receptor at the specified index!" );
+    return -1;
+  }
+
+  tv.tv_sec = tv_sec;
+#if TARGET_OS_IPHONE
+  tv.tv_usec = (int)tv_usec;
+#else
+  tv.tv_usec = tv_usec;
+#endif
+
+  FD_ZERO(&readFileDescriptor);
+
+  unsigned int first = (receptorEmitting >= 0) ? (unsigned int)receptorEmitting : 0;
+  unsigned int last = (receptorEmitting >= 0) ? (unsigned int)receptorEmitting + 1 : (unsigned int)receptor_list.size();
+  socketMax = receptor_list[first].socketFileDescriptorReceptor;
+  for(unsigned int i = first; i < last; i++){
+    FD_SET((unsigned int)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor);
+    if(socketMax < receptor_list[i].socketFileDescriptorReceptor) socketMax = receptor_list[i].socketFileDescriptorReceptor;
+  }
+
+  int value = select((int)socketMax+1,&readFileDescriptor,NULL,NULL,&tv);
+  if(value == -1){
+    if(verboseMode)
+      vpERROR_TRACE( "Select error" );
+    return -1;
+  }
+  else if(value == 0){
+    //Timeout
+    return 0;
+  }
+
+  index = first;
+  while(index < last && ! FD_ISSET((unsigned int)receptor_list[index].socketFileDescriptorReceptor,&readFileDescriptor))
+    index++;
+  if(index == last)
+    return -1;
+
+  unsigned int header[4];
+  if(_receiveAll(index, header, vpFrameHeaderSize) < 0)
+    return -1;
+
+  if(header[0] != vpFrameMagic){
+    if(verboseMode)
+      vpTRACE( "Incorrect frame" );
+    return -1;
+  }
+
+  tag = header[2];
+  size = header[3];
+
+  if(header[1] != type){
+    if(verboseMode)
+      vpTRACE( "The received frame is not of the expected type" );
+    _receiveFrameBuffer(index, size);
+    return -1;
+  }
+
+  return (int)vpFrameHeaderSize;
+}
+
+/*!
+  Receive a matrix frame from a receptor, or from any receptor if
+  \e receptorEmitting is negative.
+*/
+int vpNetwork::_receiveMatrix(vpArray2D<double> &M, const int &receptorEmitting)
+{
+  unsigned int tag, size, index;
+  int res = _receiveFrameHeader(receptorEmitting, FRAME_MATRIX, tag, size, index);
+  if (res <= 0)
+    return res;
+
+  // Number of rows and columns
+  unsigned int desc[2];
+  if (size < sizeof(desc)) {
+    _receiveFrameBuffer(index, size);
+    return -1;
+  }
+  if (_receiveAll(index, desc, (unsigned int)sizeof(desc)) < 0)
+    return -1;
+
+  unsigned int dataSize = size - (unsigned int)sizeof(desc);
+  if ((size_t)dataSize != (size_t)desc[0] * desc[1] * sizeof(double)) {
+    if(verboseMode)
+      vpTRACE( "Incorrect matrix frame" );
+    _receiveFrameBuffer(index, dataSize);
+    return -1;
+  }
+
+  if (M.getRows() != desc[0] || M.getCols() != desc[1])
+    M.resize(desc[0], desc[1], false);
+
+  if (_receiveAll(index, M.data, dataSize) < 0)
+    return -1;
+
+  return res + (int)size;
+}
+
+/*!
+  Send a binary frame, made of a header followed by the memory areas given in
+  \e parts, with a single gather operation when possible.
+
+  \param type : Type of the payload.
+  \param tag : Tag of the frame.
+  \param parts : Memory areas that make the payload (3 at most).
+  \param nbParts : Number of memory areas.
+  \param dest : Index of the receptor receiving the frame.
+
+  \return The number of bytes sent, or -1 if an error occured.
+*/
+int vpNetwork::_sendFrameTo(const unsigned int &type, const unsigned int &tag, const vpFramePart *parts,
+                            const unsigned int &nbParts, const unsigned int &dest)
+{
+  if(receptor_list.size() == 0 || dest > (unsigned int)receptor_list.size()-1 )
+  {
+    if(verboseMode)
+      vpTRACE( "Cannot send frame! Bad Index" );
+    return 0;
+  }
+  if(nbParts > 3)
+  {
+    if(verboseMode)
+      vpTRACE( "Too many parts in the frame" );
+    return -1;
+  }
+
+  unsigned int header[4];
+  header[0] = vpFrameMagic;
+  header[1] = type;
+  header[2] = tag;
+  header[3] = 0;
+  for(unsigned int i = 0; i < nbParts; i++)
+    header[3] += parts[i].size;
+
+  size_t total = vpFrameHeaderSize + header[3];
+  size_t sent = 0;
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+  int flags = 0;
+#  if defined(__linux__)
+  flags = MSG_NOSIGNAL; // Only for Linux
+#  endif
+
+  struct iovec iov[4];
+  iov[0].iov_base = (void *)header;
+  iov[0].iov_len = vpFrameHeaderSize;
+  for(unsigned int i = 0; i < nbParts; i++){
+    iov[i+1].iov_base = const_cast<void *>(parts[i].data);
+    iov[i+1].iov_len = parts[i].size;
+  }
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = nbParts + 1;
+
+  while(sent < total){
+    ssize_t value = sendmsg(receptor_list[dest].socketFileDescriptorReceptor, &msg, flags);
+    if(value < 0 && errno == EINTR)
+      continue;
+    if(value <= 0)
+      return -1;
+    sent += (size_t)value;
+
+    // Skip what has been sent in case of partial send
+    size_t remaining = (size_t)value;
+    while(remaining > 0 && msg.msg_iovlen > 0){
+      if(remaining >= msg.msg_iov[0].iov_len){
+        remaining -= msg.msg_iov[0].iov_len;
+        msg.msg_iov++;
+        msg.msg_iovlen--;
+      }
+      else{
+        msg.msg_iov[0].iov_base = (char *)msg.msg_iov[0].iov_base + remaining;
+        msg.msg_iov[0].iov_len -= remaining;
+        remaining = 0;
+      }
+    }
+  }
+#else
+  WSABUF buf[4];
+  buf[0].buf = (char *)header;
+  buf[0].len = vpFrameHeaderSize;
+  for(unsigned int i = 0; i < nbParts; i++){
+    buf[i+1].buf = (char *)const_cast<void *>(parts[i].data);
+    buf[i+1].len = parts[i].size;
+  }
+
+  WSABUF *first = buf;
+  DWORD count = nbParts + 1;
+  while(sent < total){
+    DWORD value = 0;
+    if(WSASend(receptor_list[dest].socketFileDescriptorReceptor, first, count, &value, 0, NULL, NULL) == SOCKET_ERROR || value == 0)
+      return -1;
+    sent += value;
+
+    // Skip what has been sent in case of partial send
+    while(value > 0 && count > 0){
+      if(value >= first->len){
+        value -= first->len;
+        first++;
+        count--;
+      }
+      else{
+        first->buf += value;
+        first->len -= value;
+        value = 0;
+      }
+    }
+  }
+#endif
+
+  return (int)total;
+}
@@ -0,0 +1,610 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Process-wide pool of worker threads.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpThreadPool.cpp
+  \brief Process-wide pool of persistent worker threads.
+*/
+
+#include <string>
+#include <deque>
+#include <vector>
+
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpDisplayException.h>
+#include <visp3/core/vpFrameGrabberException.h>
+#include <visp3/core/vpImageException.h>
+#include <visp3/core/vpIoException.h>
+#include <visp3/core/vpMatrixException.h>
+#include <visp3/core/vpTrackingException.h>
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+#  include <visp3/core/vpThread.h>
+#  include <visp3/core/vpMutex.h>
+#  define VISP_HAVE_THREAD_POOL 1
+#endif
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <unistd.h>
+#endif
+
+#if VISP_HAVE_THREAD_POOL
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+
+  /*
+    Lock and condition variables shared by the workers. vpMutex cannot be
+    used with a condition variable, so native primitives are used here.
+  */
+  class vpPoolMonitor
+  {
+  public:
+    vpPoolMonitor()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_mutex_init(&m_mutex, NULL);
+      pthread_cond_init(&m_wake, NULL);
+      pthread_cond_init(&m_done, NULL);
+#else
+      InitializeCriticalSection(&m_mutex);
+      InitializeConditionVariable(&m_wake);
+      InitializeConditionVariable(&m_done);
+#endif
+    }
+    ~vpPoolMonitor()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_cond_destroy(&m_done);
+      pthread_cond_destroy(&m_wake);
+      pthread_mutex_destroy(&m_mutex);
+#else
+      DeleteCriticalSection(&m_mutex);
+#endif
+    }
+    void lock()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_mutex_lock(&m_mutex);
+#else
+      EnterCriticalSection(&m_mutex);
+#endif
+    }
+    void unlock()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_mutex_unlock(&m_mutex);
+#else
+      LeaveCriticalSection(&m_mutex);
+#endif
+    }
+    void waitWake()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_cond_wait(&m_wake, &m_mutex);
+#else
+      SleepConditionVariableCS(&m_wake, &m_mutex, INFINITE);
+#endif
+    }
+    void waitDone()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_cond_wait(&m_done, &m_mutex);
+#else
+      SleepConditionVariableCS(&m_done, &m_mutex, INFINITE);
+#endif
+    }
+    void notifyWake()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_cond_broadcast(&m_wake);
+#else
+      WakeAllConditionVariable(&m_wake);
+#endif
+    }
+    void notifyDone()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_cond_broadcast(&m_done);
+#else
+      WakeAllConditionVariable(&m_done);
+#endif
+    }
+
+  private:
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_wake;
+    pthread_cond_t m_done;
+#else
+    CRITICAL_SECTION m_mutex;
+    CONDITION_VARIABLE m_wake;
+    CONDITION_VARIABLE m_done;
+#endif
+  };
+
+  /*
+    Non blocking lock used to detect that the pool is already busy, either
+    because of a nested call from a task or a call from another user thread.
+  */
+  class vpPoolSubmitLock
+  {
+  public:
+    vpPoolSubmitLock()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_mutex_init(&m_mutex, NULL);
+#else
+      m_busy = 0;
+#endif
+    }
+    ~vpPoolSubmitLock()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_mutex_destroy(&m_mutex);
+#endif
+    }
+    bool tryLock()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      return (pthread_mutex_trylock(&m_mutex) == 0);
+#else
+      return (InterlockedCompareExchange(&m_busy, 1, 0) == 0);
+#endif
+    }
+    void lock()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_mutex_lock(&m_mutex);
+#else
+      while (! tryLock())
+        Sleep(0);
+#endif
+    }
+    void unlock()
+    {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_mutex_unlock(&m_mutex);
+#else
+      InterlockedExchange(&m_busy, 0);
+#endif
+    }
+
+  private:
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_t m_mutex;
+#else
+    volatile LONG m_busy;
+#endif
+  };
+
+  /*
+    Copy of an exception thrown by a task. The exceptions of the core module
+    keep their type, the other ones are copied as a vpException with the
+    same code and message.
+  */
+  vpException *vpPoolCopyException(const vpException &e)
+  {
+    if (const vpTrackingException *ex = dynamic_cast<const vpTrackingException *>(&e))
+      return new vpTrackingException(*ex);
+    if (const vpMatrixException *ex = dynamic_cast<const vpMatrixException *>(&e))
+      return new vpMatrixException(*ex);
+    if (const vpImageException *ex = dynamic_cast<const vpImageException *>(&e))
+      return new vpImageException(*ex);
+    if (const vpIoException *ex = dynamic_cast<const vpIoException *>(&e))
+      return new vpIoException(*ex);
+    if (const vpDisplayException *ex = dynamic_cast<const vpDisplayException *>(&e))
+      return new vpDisplayException(*ex);
+    if (const vpFrameGrabberException *ex = dynamic_cast<const vpFrameGrabberException *>(&e))
+      return new vpFrameGrabberException(*ex);
+    return new vpException(e);
+  }
+
+  // Throw the copy made by vpPoolCopyException() with its type
+  void vpPoolThrowException(const vpException &e)
+  {
+    if (const vpTrackingException *ex = dynamic_cast<const vpTrackingException *>(&e))
+      throw *ex;
+    if (const vpMatrixException *ex = dynamic_cast<const vpMatrixException *>(&e))
+      throw *ex;
+    if (const vpImageException *ex = dynamic_cast<const vpImageException *>(&e))
+      throw *ex;
+    if (const vpIoException *ex = dynamic_cast<const vpIoException *>(&e))
+      throw *ex;
+    if (const vpDisplayException *ex = dynamic_cast<const vpDisplayException *>(&e))
+      throw *ex;
+    if (const vpFrameGrabberException *ex = dynamic_cast<const vpFrameGrabberException *>(&e))
+      throw *ex;
+    throw e;
+  }
+
+  struct vpPoolChunk
+  {
+    vpThreadPool::vpRangeTask *m_task;
+    unsigned int m_start;
+    unsigned int m_end;
+  };
+
+  struct vpPoolQueue
+  {
+    vpMutex m_mutex;
+    std::deque<vpPoolChunk> m_chunks;
+  };
+
+  class vpPool;
+
+  struct vpPoolWorkerArgs
+  {
+    vpPool *m_pool;
+    unsigned int m_index;
+    unsigned long m_generation;
+  };
+
+  vpThread::Return vpPoolWorkerMain(vpThread::Args args);
+
+  class vpPool
+  {
+  public:
+    vpPool()
+      : m_nbThreads(vpThreadPool::getNumProcessors()), m_queues(), m_threads(), m_workerArgs(),
+        m_monitor(), m_submit(), m_generation(0), m_pending(0), m_stop(false), m_error(NULL)
+    {
+    }
+
+    ~vpPool()
+    {
+      stopWorkers();
+    }
+
+    unsigned int getNumThreads() const { return m_nbThreads; }
+
+    void setNumThreads(unsigned int nbThreads)
+    {
+      m_submit.lock();
+      stopWorkers();
+      m_nbThreads = (nbThreads == 0) ? vpThreadPool::getNumProcessors() : nbThreads;
+      m_submit.unlock();
+    }
+
+    void parallel_for(unsigned int begin, unsigned int end, vpThreadPool::vpRangeTask &task,
+                      unsigned int grainSize)
+    {
+      unsigned int range = end - begin;
+      if (range <= 1 || (grainSize != 0 && range <= grainSize) || ! m_submit.tryLock()) {
+        task.run(begin, end);
+        return;
+      }
+      if (m_nbThreads <= 1) {
+        m_submit.unlock();
+        task.run(begin, end);
+        return;
+      }
+
+      try {
+        startWorkers();
+      }
+      catch(...) {
+        m_submit.unlock();
+        throw;
+      }
+
+      // By default cut the range so that each thread gets several chunks to balance the load
+      unsigned int chunk = grainSize;
+      if (chunk == 0) {
+        unsigned int nbChunks = 4 * m_nbThreads;
+        chunk = (range + nbChunks - 1) / nbChunks;
+      }
+      unsigned int nbChunks = (range + chunk - 1) / chunk;
+
+      m_monitor.lock();
+      m_pending = nbChunks;
+      m_monitor.unlock();
+
+      // Contiguous chunks go to the same queue to keep memory accesses local
+      for (unsigned int i = 0; i < nbChunks; i++) {
+        vpPoolChunk c;
+        c.m_task = &task;
+        c.m_start = begin + i * chunk;
+        c.m_end = (range - i * chunk > chunk) ? c.m_start + chunk : end;
+        vpPoolQueue *q = m_queues[(size_t)i * m_nbThreads / nbChunks];
+        q->m_mutex.lock();
+        q->m_chunks.push_back(c);
+        q->m_mutex.unlock();
+      }
+
+      m_monitor.lock();
+      m_generation++;
+      m_monitor.notifyWake();
+      m_monitor.unlock();
+
+      // The calling thread uses the first queue
+      runChunks(0);
+
+      m_monitor.lock();
+      while (m_pending > 0)
+        m_monitor.waitDone();
+      vpException *error = m_error;
+      m_error = NULL;
+      m_monitor.unlock();
+
+      m_submit.unlock();
+
+      if (error != NULL) {
+        try {
+          vpPoolThrowException(*error);
+        }
+        catch(...) {
+          delete error;
+          throw;
+        }
+      }
+    }
+
+    void workerLoop(unsigned int index, unsigned long generation)
+    {
+      m_monitor.lock();
+      while (true) {
+        while (! m_stop && generation == m_generation)
+          m_monitor.waitWake();
+        if (m_stop)
+          break;
+        generation = m_generation;
+        m_monitor.unlock();
+
+        runChunks(index);
+
+        m_monitor.lock();
+      }
+      m_monitor.unlock();
+    }
+
+  private:
+    bool popChunk(unsigned int index, vpPoolChunk &c)
+    {
+      vpPoolQueue *q = m_queues[index];
+      bool found = false;
+      q->m_mutex.lock();
+      if (! q->m_chunks.empty()) {
+        c = q->m_chunks.front();
+        q->m_chunks.pop_front();
+        found = true;
+      }
+      q->m_mutex.unlock();
+      return found;
+    }
+
+    bool stealChunk(unsigned int index, vpPoolChunk &c)
+    {
+      for (unsigned int i = 1; i < m_queues.size(); i++) {
+        vpPoolQueue *q = m_queues[(index + i) % m_queues.size()];
+        bool found = false;
+        q->m_mutex.lock();
+        if (! q->m_chunks.empty()) {
+          // Steal from the back, far from the chunks the owner is working on
+          c = q->m_chunks.back();
+          q->m_chunks.pop_back();
+          found = true;
+        }
+        q->m_mutex.unlock();
+        if (found)
+          return true;
+      }
+      return false;
+    }
+
+    void runChunks(unsigned int index)
+    {
+      vpPoolChunk c;
+      while (popChunk(index, c) || stealChunk(index, c)) {
+        vpException *error = NULL;
+        try {
+          c.m_task->run(c.m_start, c.m_end);
+        }
+        catch(const vpException &e) {
+          error = vpPoolCopyException(e);
+        }
+        catch(const std::exception &e) {
+          error = new vpException(vpException::fatalError, std::string(e.what()));
+        }
+        catch(...) {
+          error = new vpException(vpException::fatalError, "Unknown exception in a parallel_for() task");
+        }
+
+        m_monitor.lock();
+        if (error != NULL && m_error == NULL) {
+          m_error = error;
+          error = NULL;
+        }
+        m_pending--;
+        if (m_pending == 0)
+          m_monitor.notifyDone();
+        m_monitor.unlock();
+        delete error;
+      }
+    }
+
+    void startWorkers()
+    {
+      if (! m_queues.empty())
+        return;
+
+      for (unsigned int i = 0; i < m_nbThreads; i++)
+        m_queues.push_back(new vpPoolQueue);
+
+      // Queue 0 belongs to the thread that calls parallel_for()
+      m_workerArgs.resize(m_nbThreads);
+      for (unsigned int i = 1; i < m_nbThreads; i++) {
+        m_workerArgs[i].m_pool = this;
+        m_workerArgs[i].m_index = i;
+        m_workerArgs[i].m_generation = m_generation;
+        m_threads.push_back(new vpThread((vpThread::Fn) vpPoolWorkerMain, (vpThread::Args) &m_workerArgs[i]));
+      }
+    }
+
+    void stopWorkers()
+    {
+      m_monitor.lock();
+      m_stop = true;
+      m_monitor.notifyWake();
+      m_monitor.unlock();
+
+      for (size_t i = 0; i < m_threads.size(); i++) {
+        m_threads[i]->join();
+        delete m_threads[i];
+      }
+      m_threads.clear();
+
+      for (size_t i = 0; i < m_queues.size(); i++)
+        delete m_queues[i];
+      m_queues.clear();
+
+      m_monitor.lock();
+      m_stop = false;
+      m_monitor.unlock();
+    }
+
+    unsigned int m_nbThreads;
+    std::vector<vpPoolQueue *> m_queues;
+    std::vector<vpThread *> m_threads;
+    std::vector<vpPoolWorkerArgs> m_workerArgs;
+    vpPoolMonitor m_monitor;
+    vpPoolSubmitLock m_submit;
+    unsigned long m_generation;
+    unsigned int m_pending;
+    bool m_stop;
+    vpException *m_error;
+  };
+
+  vpThread::Return vpPoolWorkerMain(vpThread::Args args)
+  {
+    vpPoolWorkerArgs *workerArgs = (vpPoolWorkerArgs *) args;
+    workerArgs->m_pool->workerLoop(workerArgs->m_index, workerArgs->m_generation);
+    return 0;
+  }
+
+  vpPool &vpGetPool()
+  {
+    static vpPool pool;
+    return pool;
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif // VISP_HAVE_THREAD_POOL
+
+/*!
+  Return the number of processors available on the system, or 1 if it cannot
+  be determined.
+*/
+unsigned int vpThreadPool::getNumProcessors()
+{
+#if defined(_WIN32)
+  SYSTEM_INFO sysinfo;
+  GetSystemInfo(&sysinfo);
+  return (sysinfo.dwNumberOfProcessors > 0) ? (unsigned int) sysinfo.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  long nb = sysconf(_SC_NPROCESSORS_ONLN);
+  return (nb > 0) ? (unsigned int) nb : 1;
+#else
+  return 1;
+#endif
+}
+
+/*!
+  Return the number of threads, including the calling one, that share the work
+  of parallel_for(). By default it is equal to getNumProcessors(). Without
+  threading support, it is always 1.
+
+  \sa setNumThreads()
+*/
+unsigned int vpThreadPool::getNumThreads()
+{
+#if VISP_HAVE_THREAD_POOL
+  return vpGetPool().getNumThreads();
+#else
+  return 1;
+#endif
+}
+
+/*!
+  Set the number of threads, including the calling one, that share the work of
+  parallel_for(). The worker threads are created the next time they are needed.
+
+  \param nbThreads : Number of threads. 1 processes everything in the calling
+  thread, 0 restores the default value given by getNumProcessors().
+
+  \sa getNumThreads()
+*/
+void vpThreadPool::setNumThreads(unsigned int nbThreads)
+{
+#if VISP_HAVE_THREAD_POOL
+  vpGetPool().setNumThreads(nbThreads);
+#else
+  (void)nbThreads;
+#endif
+}
+
+/*!
+  Call \e task.run() on sub-ranges of [\e begin, \e end) using the pool threads
+  and the calling thread, and return when the whole range is processed.
+
+  \param begin : First index of the range.
+  \param end : Index after the last one of the range.
+  \param task : Work to execute on each sub-range.
+  \param grainSize : Size of the sub-ranges. Sub-range \e i is
+  [begin + i*grainSize, begin + (i+1)*grainSize), the last one being truncated
+  at \e end. When 0, the range is cut in about four sub-ranges per thread.
+
+  \exception vpException : If run() throws an exception, the first one is
+  thrown again by parallel_for() with its code and message, once the other
+  sub-ranges are processed. The exceptions defined in the core module, such
+  as vpTrackingException or vpMatrixException, keep their type; the other
+  ones derived from vpException are thrown as a vpException. Exceptions that
+  do not derive from vpException become a vpException::fatalError.
+*/
+void vpThreadPool::parallel_for(unsigned int begin, unsigned int end, vpRangeTask &task, unsigned int grainSize)
+{
+  if (end <= begin)
+    return;
+
+#if VISP_HAVE_THREAD_POOL
+  vpGetPool().parallel_for(begin, end, task, grainSize);
+#else
+  (void)grainSize;
+  task.run(begin, end);
+#endif
+}
@@ -40,16 +40,179 @@
 #include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/core/vpConfig.h>
+#include <visp3/core/vpThreadPool.h>
 #include <stdexcept>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
-#ifdef VISP_HAVE_OPENMP
-#include <omp.h>
-#endif
 #include <cassert>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Accumulates the moments of blocks of image rows, each pixel contributing
+    w(I) x^l y^k to m_lk. Without distortion, the pixel to meter conversion
+    is separable: x only depends on the column and y on the row. For each row,
+    the power sums S_l = sum_i w_i x_i^l are accumulated with the powers of x
+    precomputed per column, then m_lk += y^k S_l. This costs order operations
+    per pixel instead of order^2/2.
+    Each block of rows is accumulated in its own slot of the partial sums.
+    They are added in the block order, so that the result doesn't depend on the
+    number of threads.
+  */
+  class vpMomentImageTask : public vpThreadPool::vpRangeTask {
+  public:
+    typedef enum {
+      THRESHOLD,        // w = 1 if I > threshold, 0 otherwise
+      INTENSITY,        // w = I * scale
+      INVERSE_INTENSITY // w = 1 - I * scale
+    } vpWeightType;
+
+    vpMomentImageTask(const vpImage<unsigned char> &I, const vpCameraParameters &cam, unsigned int order,
+                      vpWeightType weightType, unsigned char threshold, double scale,
+                      const double *xpow, double *partials, unsigned int blockSize) :
+      m_I(I), m_cam(cam), m_order(order), m_weightType(weightType), m_threshold(threshold),
+      m_scale(scale), m_xpow(xpow), m_partials(partials), m_blockSize(blockSize) {
+    }
+
+    void run(unsigned int start, unsigned int end) {
+      std::vector<double> sums(m_order);
+      for (unsigned int b = start; b < end; b++) {
+        double *values = m_partials + b * m_order * m_order;
+        for (unsigned int k = 0; k < m_order * m_order; k++)
+          values[k] = 0.;
+
+        unsigned int rowEnd = std::min((b+1) * m_blockSize, m_I.getHeight());
+        for (unsigned int j = b * m_blockSize; j < rowEnd; j++) {
+          if (m_xpow != NULL)
+            accumulateRow(j, &sums[0], values);
+          else
+            accumulatePixels(j, values);
+        }
+      }
+    }
+
+  private:
+    inline double weight(unsigned char I) const {
+      switch (m_weightType) {
+      case THRESHOLD: return (I > m_threshold) ? 1. : 0.;
+      case INTENSITY: return I * m_scale;
+      default: return 1. - I * m_scale;
+      }
+    }
+
+    void accumulateRow(unsigned int j, double *sums, double *values) const {
+      const unsigned char *row = m_I[j];
+      const unsigned int width = m_I.getWidth();
+      for (unsigned int l = 0; l < m_order; l++)
+        sums[l] = 0.;
+
+      if (m_weightType == THRESHOLD) {
+        for (unsigned int i = 0; i < width; i++) {
+          if (row[i] > m_threshold) {
+            const double *xpow = m_xpow + i * m_order;
+            for (unsigned int l = 0; l < m_order; l++)
+              sums[l] += xpow[l];
+          }
+        }
+      }
+      else {
+        for (unsigned int i = 0; i < width; i++) {
+          const double w = weight(row[i]);
+          const double *xpow = m_xpow + i * m_order;
+          for (unsigned int l = 0; l < m_order; l++)
+            sums[l] += w * xpow[l];
+        }
+      }
+
+      double y = 0, x;
+      vpPixelMeterConversion::convertPoint(m_cam, 0., (double)j, x, y);
+      double yval = 1.;
+      for (unsigned int k = 0; k < m_order; k++) {
+        for (unsigned int l = 0; l < m_order - k; l++)
+          values[k * m_order + l] += yval * sums[l];
+        yval *= y;
+      }
+    }
+
+    void accumulatePixels(unsigned int j, double *values) const {
+      const unsigned char *row = m_I[j];
+      for (unsigned int i = 0; i < m_I.getWidth(); i++) {
+        if (m_weightType == THRESHOLD && row[i] <= m_threshold)
+          continue;
+        double x = 0, y = 0;
+        vpPixelMeterConversion::convertPoint(m_cam, (double)i, (double)j, x, y);
+        double yval = weight(row[i]);
+        for (unsigned int k = 0; k < m_order; k++) {
+          double xval = yval;
+          for (unsigned int l = 0; l < m_order - k; l++) {
+            values[k * m_order + l] += xval;
+            xval *= x;
+          }
+          yval *= y;
+        }
+      }
+    }
+
+    const vpImage<unsigned char> &m_I;
+    const vpCameraParameters &m_cam;
+    unsigned int m_order;
+    vpWeightType m_weightType;
+    unsigned char m_threshold;
+    double m_scale;
+    const double *m_xpow;
+    double *m_partials;
+    unsigned int m_blockSize;
+
+    vpMomentImageTask &operator=(const vpMomentImageTask &);
+  };
+
+  /*
+    Computes the moments of an image with vpMomentImageTask, using the
+    threads of vpThreadPool.
+  */
+  void vpComputeImageMoments(const vpImage<unsigned char> &I, const vpCameraParameters &cam, unsigned int order,
+                             vpMomentImageTask::vpWeightType weightType, unsigned char threshold, double scale,
+                             std::vector<double> &values)
+  {
+    values.assign(order*order, 0.);
+    if (I.getSize() == 0)
+      return;
+
+    // Powers of x for each column, when x doesn't depend on the row
+    std::vector<double> xpow;
+    if (cam.get_projModel() == vpCameraParameters::perspectiveProjWithoutDistortion) {
+      xpow.resize(I.getWidth() * order);
+      for (unsigned int i = 0; i < I.getWidth(); i++) {
+        double x = 0, y;
+        vpPixelMeterConversion::convertPoint(cam, (double)i, 0., x, y);
+        double xval = 1.;
+        for (unsigned int l = 0; l < order; l++) {
+          xpow[i * order + l] = xval;
+          xval *= x;
+        }
+      }
+    }
+
+    const unsigned int blockSize = 16;
+    const unsigned int nbBlocks = (I.getHeight() + blockSize - 1) / blockSize;
+    std::vector<double> partials(nbBlocks * order * order);
+    vpMomentImageTask task(I, cam, order, weightType, threshold, scale,
+                           xpow.empty() ? NULL : &xpow[0], &partials[0], blockSize);
+    vpThreadPool::parallel_for(0, nbBlocks, task, 1);
+
+    for (unsigned int b = 0; b < nbBlocks; b++) {
+      const double *partial = &partials[b * order * order];
+      for (unsigned int k = 0; k < order; k++)
+        for (unsigned int l = 0; l < order - k; l++)
+          values[k * order + l] += partial[k * order + l];
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Computes moments from a vector of points describing a polygon.
   The points must be stored in a clockwise order. Used internally.
@@ -262,9 +425,13 @@ void vpMomentObject::fromVector(std::vector<vpPoint>& points){
   There is no assumption made about whether the input is dense or discrete but it's more common to use vpMomentObject::DENSE_FULL_OBJECT with this method.
 
   \param image : Image to consider.
-  \param threshold : Pixels with a luminance lower than this threshold will be considered.
+  \param threshold : Pixels with a luminance greater than this threshold will be considered.
   \param cam : Camera parameters used to convert pixels coordinates in meters in the image plane.
 
+  The image is processed row by row. Without distortion, the pixel to meter conversion
+  is separable and each pixel only costs order additions. The rows are shared among the
+  threads of vpThreadPool and the result doesn't depend on their number.
+
   The code below shows how to use this function.
   \code
 #include <visp3/core/vpMomentObject.h>
@@ -287,70 +454,7 @@ int main()
 */
 
 void vpMomentObject::fromImage(const vpImage<unsigned char>& image, unsigned char threshold, const vpCameraParameters& cam){
-#ifdef VISP_HAVE_OPENMP
-  #pragma omp parallel shared(threshold)
-  {
-    std::vector<double> curvals(order*order);
-    curvals.assign(order*order,0.);
-    unsigned int i_, j_;
-
-    #pragma omp for nowait//automatically organize loop counter between threads
-    for(int i=0;i<(int)image.getCols();i++){
-      for(int j=0;j<(int)image.getRows();j++){
-        i_ = static_cast<unsigned int>(i);
-        j_ = static_cast<unsigned int>(j);
-        if(image[j_][i_]>threshold){
-          double x=0;
-          double y=0;
-          vpPixelMeterConversion::convertPoint(cam,i_,j_,x,y);
-
-          double yval=1.;
-          for(unsigned int k=0;k<order;k++){
-            double xval=1.;
-            for(unsigned int l=0;l<order-k;l++){
-              curvals[(k*order+l)]+=(xval*yval);
-              xval*=x;
-            }
-            yval*=y;
-          }
-        }
-      }
-    }
-
-    #pragma omp master //only set this variable in master thread
-    {
-      values.assign(order*order, 0.);
-    }
-
-    #pragma omp barrier
-
-    for(unsigned int k=0;k<order;k++){
-      for(unsigned int l=0;l<order-k;l++){
-        //#pragma omp atomic // Removed since causes a build issue with msvc14 2015
-        values[k*order+l]+= curvals[k*order+l];
-      }
-    }
-
-  }
-#else
-    std::vector<double> cache(order*order,0.);
-    values.assign(order*order,0);
-    for(unsigned int i=0;i<image.getCols();i++){
-        for(unsigned int j=0;j<image.getRows();j++){
-            if(image[j][i]>threshold){
-                double x=0;
-                double y=0;
-                vpPixelMeterConversion::convertPoint(cam,i,j,x,y);
-                cacheValues(cache,x,y);
-                for(unsigned int k=0;k<order;k++){
-                    for(unsigned int l=0;l<order-k;l++){
-                        values[k*order+l]+=cache[k*order+l];
-                    }
-                }
-            }
-        }
-    }
-#endif
+    vpComputeImageMoments(image, cam, order, vpMomentImageTask::THRESHOLD, threshold, 1., values);
 
     //Normalisation equivalent to sampling interval/pixel size delX x delY
     double norm_factor = 1./(cam.get_px()*cam.get_py());
@@ -372,20 +476,6 @@ void vpMomentObject::fromImage(const vpImage<unsigned char>& image, unsigned cha
 void vpMomentObject::fromImage(const vpImage<unsigned char>& image, const vpCameraParameters& cam,
     vpCameraImgBckGrndType bg_type, bool normalize_with_pix_size)
 {
-  std::vector<double> cache(order*order,0.);
-  values.assign(order*order,0);
-
-  // (x,y) - Pixel co-ordinates in metres
-  double x=0;
-  double y=0;
-  //for indexing into cache[] and values[]
-  unsigned int idx = 0;
-  unsigned int kidx = 0;
-
-  double intensity = 0;
-
-  //double Imax = static_cast<double>(image.getMaxValue());
-
   double iscale = 1.0;
   if (flg_normalize_intensity) {                                            // This makes the image a probability density function
     double Imax = 255.;                                                     // To check the effect of gray level change. ISR Coimbra
@@ -393,51 +483,12 @@ void vpMomentObject::fromImage(const vpImage<unsigned char>& image, const vpCame
   }
 
   if (bg_type == vpMomentObject::WHITE) {
-      /////////// WHITE BACKGROUND ///////////
-      for(unsigned int j=0;j<image.getRows();j++){
-          for(unsigned int i=0;i<image.getCols();i++){
-              x = 0;
-              y = 0;
-              intensity = (double)(image[j][i])*iscale;
-              double intensity_white = 1. - intensity;
-
-              vpPixelMeterConversion::convertPoint(cam,i,j,x,y);
-              cacheValues(cache,x,y, intensity_white);			// Modify 'cache' which has x^p*y^q to x^p*y^q*(1 - I(x,y))
-
-              // Copy to "values"
-              for(unsigned int k=0;k<order;k++){
-                  kidx = k*order;
-                  for(unsigned int l=0;l<order-k;l++){
-                      idx = kidx+l;
-                      values[idx]+= cache[idx];
-                  }
-              }
-          }
-      }
+    // Each pixel contributes x^p*y^q*(1 - I(x,y))
+    vpComputeImageMoments(image, cam, order, vpMomentImageTask::INVERSE_INTENSITY, 0, iscale, values);
   }
   else {
-      /////////// BLACK BACKGROUND	///////////
-      for(unsigned int j=0;j<image.getRows();j++){
-          for(unsigned int i=0;i<image.getCols();i++){
-              x = 0;
-              y = 0;
-              intensity = (double)(image[j][i])*iscale;
-              vpPixelMeterConversion::convertPoint(cam,i,j,x,y);
-
-              // Cache values for fast moment calculation
-              cacheValues(cache,x,y, intensity);					// Modify 'cache' which has x^p*y^q to x^p*y^q*I(x,y)
-
-              // Copy to moments array 'values'
-              for(unsigned int k=0;k<order;k++){
-                  kidx = k*order;
-                  for(unsigned int l=0;l<order-k;l++){
-                      idx = kidx+l;
-                      values[idx]+= cache[idx];
-                  }
-              }
-
-          }
-      }
+    // Each pixel contributes x^p*y^q*I(x,y)
+    vpComputeImageMoments(image, cam, order, vpMomentImageTask::INTENSITY, 0, iscale, values);
   }
 
   if (normalize_with_pix_size){
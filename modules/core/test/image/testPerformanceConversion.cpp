@@ -0,0 +1,329 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the YUV to RGB and grey conversions.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceConversion.cpp
+
+  \brief Check the YUV, YCbCr and MONO16 conversions of vpImageConvert against
+  per pixel implementations of the conversion formulas, and time them for
+  common resolutions with one thread and with the threads of vpThreadPool.
+*/
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Benchmark the YUV to RGB and grey conversions.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Number of times each conversion is timed.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+enum vpInputFormat { YUYV, YUV422, YUV411, YUV420, YV12, YCbCr, YCrCb, MONO16, NB_INPUT_FORMATS };
+const char *formatNames[NB_INPUT_FORMATS] = { "YUYV", "YUV422", "YUV411", "YUV420", "YV12", "YCbCr", "YCrCb", "MONO16" };
+
+unsigned char clamp(int v)
+{
+  return (unsigned char)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// Expected pixel p of an image of size width x height, converted with nbChannels channels
+void expectedPixel(vpInputFormat format, const unsigned char *src, unsigned int p, unsigned int width,
+                   unsigned int height, unsigned int nbChannels, unsigned char *rgb)
+{
+  const unsigned int size = width * height;
+  const unsigned int pair = p / 2, k = p % 2;
+  int y = 0, u = 128, v = 128;
+  switch (format) {
+  case YUYV: case YCbCr: y = src[4*pair + 2*k]; u = src[4*pair + 1]; v = src[4*pair + 3]; break;
+  case YCrCb: y = src[4*pair + 2*k]; u = src[4*pair + 3]; v = src[4*pair + 1]; break;
+  case YUV422: y = src[4*pair + 1 + 2*k]; u = src[4*pair]; v = src[4*pair + 2]; break;
+  case YUV411: {
+    const unsigned int offsets[4] = { 1, 2, 4, 5 };
+    y = src[6*(p/4) + offsets[p%4]]; u = src[6*(p/4)]; v = src[6*(p/4) + 3];
+    break;
+  }
+  case YUV420: case YV12: {
+    unsigned int c = (p / width / 2) * (width / 2) + (p % width) / 2;
+    y = src[p];
+    u = src[(format == YUV420 ? size : 5*size/4) + c];
+    v = src[(format == YUV420 ? 5*size/4 : size) + c];
+    break;
+  }
+  case MONO16: y = src[2*p]; break;
+  default: break;
+  }
+  (void)height;
+
+  if (nbChannels == 1) {
+    rgb[0] = (unsigned char)y;
+    return;
+  }
+
+  int r = y, g = y, b = y;
+  if (format == YUYV) {
+    r = y + (((v - 128) * 359) >> 8);
+    g = y - (((u - 128) * 88 + (v - 128) * 183) >> 8);
+    b = y + (((u - 128) * 454) >> 8);
+  }
+  else if (format == YCbCr || format == YCrCb) {
+    r = y + ((int)(364.6610 * (v - 128)) >> 8);
+    g = y + ((int)(-89.8779 * (u - 128)) >> 8) + ((int)(-185.8154 * (v - 128)) >> 8);
+    b = y + ((int)(460.5724 * (u - 128)) >> 8);
+  }
+  else if (format != MONO16) {
+    int U = (int)((u - 128) * 0.354);
+    int V = (int)((v - 128) * 0.707);
+    r = y + 2*V;
+    g = y - U - V;
+    b = y + 5*U;
+  }
+  rgb[0] = clamp(r);
+  rgb[1] = clamp(g);
+  rgb[2] = clamp(b);
+  if (nbChannels == 4)
+    rgb[3] = 0; // the alpha of YUV411 and YUV422 is checked apart
+}
+
+// Converts src with the vpImageConvert function of the format, returns false if it does not exist
+bool convert(vpInputFormat format, unsigned char *src, unsigned char *dst, unsigned int width, unsigned int height,
+             unsigned int nbChannels, unsigned int nbThreads)
+{
+  const unsigned int size = width * height;
+  switch (format) {
+  case YUYV:
+    if (nbChannels == 4) vpImageConvert::YUYVToRGBa(src, dst, width, height, nbThreads);
+    else if (nbChannels == 3) vpImageConvert::YUYVToRGB(src, dst, width, height, nbThreads);
+    else vpImageConvert::YUYVToGrey(src, dst, size);
+    return true;
+  case YUV422:
+    if (nbChannels == 4) vpImageConvert::YUV422ToRGBa(src, dst, size, nbThreads);
+    else if (nbChannels == 3) vpImageConvert::YUV422ToRGB(src, dst, size, nbThreads);
+    else vpImageConvert::YUV422ToGrey(src, dst, size);
+    return true;
+  case YUV411:
+    if (nbChannels == 4) vpImageConvert::YUV411ToRGBa(src, dst, size, nbThreads);
+    else if (nbChannels == 3) vpImageConvert::YUV411ToRGB(src, dst, size, nbThreads);
+    else vpImageConvert::YUV411ToGrey(src, dst, size);
+    return true;
+  case YUV420:
+    if (nbChannels == 4) vpImageConvert::YUV420ToRGBa(src, dst, width, height, nbThreads);
+    else if (nbChannels == 3) vpImageConvert::YUV420ToRGB(src, dst, width, height, nbThreads);
+    else vpImageConvert::YUV420ToGrey(src, dst, size);
+    return true;
+  case YV12:
+    if (nbChannels == 4) vpImageConvert::YV12ToRGBa(src, dst, width, height, nbThreads);
+    else if (nbChannels == 3) vpImageConvert::YV12ToRGB(src, dst, width, height, nbThreads);
+    else return false;
+    return true;
+  case YCbCr:
+    if (nbChannels == 4) vpImageConvert::YCbCrToRGBa(src, dst, size, nbThreads);
+    else if (nbChannels == 3) vpImageConvert::YCbCrToRGB(src, dst, size, nbThreads);
+    else vpImageConvert::YCbCrToGrey(src, dst, size);
+    return true;
+  case YCrCb:
+    if (nbChannels == 4) vpImageConvert::YCrCbToRGBa(src, dst, size, nbThreads);
+    else if (nbChannels == 3) vpImageConvert::YCrCbToRGB(src, dst, size, nbThreads);
+    else return false;
+    return true;
+  case MONO16:
+    if (nbChannels == 4) vpImageConvert::MONO16ToRGBa(src, dst, size);
+    else if (nbChannels == 1) vpImageConvert::MONO16ToGrey(src, dst, size);
+    else return false;
+    return true;
+  default:
+    return false;
+  }
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 10;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    // The first resolution exercises the scalar tails of the SIMD loops
+    const unsigned int nb_resolutions = 5;
+    const unsigned int widths[nb_resolutions] = { 38, 320, 640, 1280, 1920 };
+    const unsigned int heights[nb_resolutions] = { 6, 240, 480, 720, 1080 };
+    // At least two threads, to check the parallel conversions on a single core
+    const unsigned int nb_threads = std::max(2u, vpThreadPool::getNumThreads());
+    vpThreadPool::setNumThreads(nb_threads);
+    const unsigned char alpha = 0xA5;
+    const char *outputNames[5] = { "", "grey", "", "RGB", "RGBa" };
+
+    srand(0);
+    std::cout << "Conversion times (ms) with 1 and " << nb_threads << " threads" << std::endl;
+    for (unsigned int r = 0; r < nb_resolutions; r++) {
+      const unsigned int width = widths[r], height = heights[r], size = width * height;
+      std::vector<unsigned char> src(2*size), dst(4*size);
+      for (size_t i = 0; i < src.size(); i++)
+        src[i] = (unsigned char)(rand() % 256);
+
+      for (int f = 0; f < NB_INPUT_FORMATS; f++) {
+        vpInputFormat format = (vpInputFormat)f;
+        for (unsigned int nbChannels = 4; nbChannels >= 1; nbChannels--) {
+          if (nbChannels == 2)
+            continue;
+
+          // Check the result with one and several threads
+          for (unsigned int nbThreads = 1; nbThreads <= nb_threads; nbThreads += nb_threads - 1) {
+            memset(&dst[0], alpha, dst.size());
+            if (! convert(format, &src[0], &dst[0], width, height, nbChannels, nbThreads))
+              break;
+            for (unsigned int p = 0; p < size; p++) {
+              unsigned char expected[4];
+              expectedPixel(format, &src[0], p, width, height, nbChannels, expected);
+              if (nbChannels == 4 && (format == YUV411 || format == YUV422))
+                expected[3] = alpha;
+              if (memcmp(expected, &dst[nbChannels*p], nbChannels) != 0) {
+                std::cerr << formatNames[f] << " to " << outputNames[nbChannels] << " conversion of a " << width
+                          << "x" << height << " image with " << nbThreads << " threads differs at pixel " << p
+                          << std::endl;
+                return EXIT_FAILURE;
+              }
+            }
+          }
+
+          if (! convert(format, &src[0], &dst[0], width, height, nbChannels, 1) || r == 0)
+            continue;
+
+          double t1 = vpTime::measureTimeMs();
+          for (unsigned int i = 0; i < nb_iterations; i++)
+            convert(format, &src[0], &dst[0], width, height, nbChannels, 1);
+          t1 = (vpTime::measureTimeMs() - t1) / nb_iterations;
+
+          double tn = vpTime::measureTimeMs();
+          for (unsigned int i = 0; i < nb_iterations; i++)
+            convert(format, &src[0], &dst[0], width, height, nbChannels, nb_threads);
+          tn = (vpTime::measureTimeMs() - tn) / nb_iterations;
+
+          std::cout << "  " << width << "x" << height << " " << formatNames[f] << " to "
+                    << outputNames[nbChannels] << ": " << t1 << " / " << tn << std::endl;
+        }
+      }
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,307 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the integer Gaussian, Sobel and Canny filters.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceImageFilter.cpp
+
+  \brief Check the integer vpImageFilter::gaussianBlur() and vpImageFilter::sobel()
+  against straightforward double precision implementations, check vpImageFilter::canny()
+  on a synthetic image and compare the timings with the double precision filters and,
+  when available, with OpenCV.
+*/
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#  include <opencv2/imgproc/imgproc.hpp>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Benchmark the integer Gaussian, Sobel and Canny filters.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Number of times each filter is timed.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Pixel (i,j) of I with replicated borders
+double pixel(const vpImage<unsigned char> &I, int i, int j)
+{
+  i = std::min(std::max(i, 0), (int)I.getHeight() - 1);
+  j = std::min(std::max(j, 0), (int)I.getWidth() - 1);
+  return I[(unsigned int)i][(unsigned int)j];
+}
+
+// 2D convolution with the Sobel kernels of size 3
+void sobelNaive(const vpImage<unsigned char> &I, vpImage<double> &dIx, vpImage<double> &dIy)
+{
+  const double smooth[3] = { 1, 2, 1 }, deriv[3] = { -1, 0, 1 };
+  dIx.resize(I.getHeight(), I.getWidth());
+  dIy.resize(I.getHeight(), I.getWidth());
+  for (int i = 0; i < (int)I.getHeight(); i++) {
+    for (int j = 0; j < (int)I.getWidth(); j++) {
+      double gx = 0, gy = 0;
+      for (int a = -1; a <= 1; a++) {
+        for (int b = -1; b <= 1; b++) {
+          gx += smooth[a+1] * deriv[b+1] * pixel(I, i+a, j+b);
+          gy += deriv[a+1] * smooth[b+1] * pixel(I, i+a, j+b);
+        }
+      }
+      dIx[(unsigned int)i][(unsigned int)j] = gx;
+      dIy[(unsigned int)i][(unsigned int)j] = gy;
+    }
+  }
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 10;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    // Noisy bright disk on a dark background, with an odd width to exercise the scalar tails
+    srand(0);
+    const double radius = 150.;
+    vpImage<unsigned char> I(480, 643);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        double r = sqrt(vpMath::sqr((double)i - 240.) + vpMath::sqr((double)j - 320.));
+        I[i][j] = (unsigned char)((r < radius ? 180 : 60) + rand() % 16);
+      }
+    }
+
+    // Gaussian blur compared with the double precision implementation, that handles the borders differently
+    vpImage<unsigned char> Iblur;
+    vpImage<double> Iblur_d;
+    for (unsigned int size = 3; size <= 9; size += 2) {
+      vpImageFilter::gaussianBlur(I, Iblur, size);
+      vpImageFilter::gaussianBlur(I, Iblur_d, size);
+      double err = 0;
+      for (unsigned int i = size/2; i < I.getHeight() - size/2; i++)
+        for (unsigned int j = size/2; j < I.getWidth() - size/2; j++)
+          err = std::max(err, std::fabs(Iblur[i][j] - Iblur_d[i][j]));
+      if (err > 1.) {
+        std::cerr << "Integer Gaussian blur of size " << size << " differs by " << err << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Sobel compared with the 2D convolution
+    vpImage<int16_t> dIx, dIy;
+    vpImage<float> dIx_f, dIy_f;
+    vpImage<double> dIx_d, dIy_d;
+    vpImageFilter::sobel(I, dIx, dIy);
+    vpImageFilter::sobel(I, dIx_f, dIy_f);
+    sobelNaive(I, dIx_d, dIy_d);
+    for (unsigned int i = 0; i < I.getSize(); i++) {
+      if (std::fabs(dIx.bitmap[i] - dIx_d.bitmap[i]) > 0 || std::fabs(dIy.bitmap[i] - dIy_d.bitmap[i]) > 0
+          || std::fabs(dIx_f.bitmap[i] - dIx_d.bitmap[i]) > 0 || std::fabs(dIy_f.bitmap[i] - dIy_d.bitmap[i]) > 0) {
+        std::cerr << "Sobel differs from the 2D convolution at pixel " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Canny: the edges should lie on the circle, and most of the circle should be found
+    vpImage<unsigned char> Icanny = I;
+    vpImageFilter::canny(Icanny, Icanny, 5, 60, 3); // In place
+    unsigned int nb_edges = 0;
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        if (Icanny[i][j] == 0)
+          continue;
+        if (Icanny[i][j] != 255) {
+          std::cerr << "Canny image should only contain 0 and 255" << std::endl;
+          return EXIT_FAILURE;
+        }
+        double r = sqrt(vpMath::sqr((double)i - 240.) + vpMath::sqr((double)j - 320.));
+        if (std::fabs(r - radius) > 2.) {
+          std::cerr << "Canny edge at (" << i << "," << j << ") is not on the circle" << std::endl;
+          return EXIT_FAILURE;
+        }
+        nb_edges++;
+      }
+    }
+    std::cout << "Canny: " << nb_edges << " edge pixels for a circle of perimeter "
+              << 2. * M_PI * radius << " pixels" << std::endl;
+    if (nb_edges < 4. * radius) {
+      std::cerr << "Canny misses the circle" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Timings
+    double t_d = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nb_iterations; i++)
+      vpImageFilter::gaussianBlur(I, Iblur_d, 7);
+    t_d = vpTime::measureTimeMs() - t_d;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nb_iterations; i++)
+      vpImageFilter::gaussianBlur(I, Iblur, 7);
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "Gaussian blur 7x7: double " << t_d / nb_iterations << " ms, integer "
+              << t / nb_iterations << " ms, speed-up " << (t > 0. ? t_d / t : 0.) << std::endl;
+
+    t_d = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nb_iterations; i++) {
+      vpImageFilter::getGradX(I, dIx_d);
+      vpImageFilter::getGradY(I, dIy_d);
+    }
+    t_d = vpTime::measureTimeMs() - t_d;
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nb_iterations; i++)
+      vpImageFilter::sobel(I, dIx, dIy);
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "Gradient: getGradX()+getGradY() " << t_d / nb_iterations << " ms, sobel() "
+              << t / nb_iterations << " ms, speed-up " << (t > 0. ? t_d / t : 0.) << std::endl;
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nb_iterations; i++)
+      vpImageFilter::canny(I, Icanny, 5, 30, 60, 3);
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "Canny: " << t / nb_iterations << " ms" << std::endl;
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+    cv::Mat img_cvmat, edges_cvmat;
+    vpImageConvert::convert(I, img_cvmat);
+    double t_cv = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nb_iterations; i++) {
+      cv::Mat blur_cvmat;
+      cv::GaussianBlur(img_cvmat, blur_cvmat, cv::Size(5, 5), 0, 0);
+      cv::Canny(blur_cvmat, edges_cvmat, 30, 60, 3);
+    }
+    t_cv = vpTime::measureTimeMs() - t_cv;
+    vpImage<unsigned char> Icanny_cv;
+    vpImageConvert::convert(edges_cvmat, Icanny_cv);
+    unsigned int nb_same = 0, nb_cv = 0;
+    for (unsigned int i = 0; i < I.getSize(); i++) {
+      if (Icanny_cv.bitmap[i]) {
+        nb_cv++;
+        if (Icanny.bitmap[i])
+          nb_same++;
+      }
+    }
+    std::cout << "Canny with OpenCV: " << t_cv / nb_iterations << " ms, " << nb_same << " of the "
+              << nb_cv << " OpenCV edge pixels are found" << std::endl;
+#endif
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,298 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the PGM and PPM readers.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpImageIo.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+
+/*!
+  \example testPerformanceIoPPM.cpp
+
+  \brief Compare vpImageIo::readPPM() and vpImageIo::readPGM() with a reader
+  that fetches the pixels one by one, as it was done before the raster was read
+  in a single call, and check that both give the same images.
+*/
+
+// List of allowed command line options
+#define GETOPTARGS  "cdi:o:h"
+
+void usage(const char *name, const char *badparam, const std::string &opath, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, std::string &opath, unsigned int &nb_iterations);
+
+/*
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param opath : Output image path.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, const std::string &opath, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Benchmark the PGM and PPM readers.\n\
+\n\
+SYNOPSIS\n\
+  %s [-o <output image path>] [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -o <output image path>                               %s\n\
+     Set image output path where the images read by the\n\
+     benchmark are written.\n\
+\n\
+  -i <number of iterations>                            %u\n\
+     Number of times each image is read.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", opath.c_str(), nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param opath : Output image path.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, std::string &opath, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'o': opath = optarg_; break;
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, opath, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, opath, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, opath, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Reader of the files written by vpImageIo that fetches the pixels one by one
+bool readPNMPixelByPixel(vpImage<vpRGBa> &I, const std::string &filename, bool color)
+{
+  FILE *fd = fopen(filename.c_str(), "rb");
+  if (fd == NULL)
+    return false;
+
+  unsigned int magic, w, h, maxval;
+  if (fscanf(fd, "P%u %u %u %u", &magic, &w, &h, &maxval) != 4 || fgetc(fd) == EOF) {
+    fclose(fd);
+    return false;
+  }
+  if ((h != I.getHeight()) || (w != I.getWidth()))
+    I.resize(h, w);
+
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      vpRGBa v;
+      size_t res = fread(&v.R, sizeof(v.R), 1, fd);
+      if (color) {
+        res |= fread(&v.G, sizeof(v.G), 1, fd);
+        res |= fread(&v.B, sizeof(v.B), 1, fd);
+      }
+      else {
+        v.G = v.B = v.A = v.R;
+      }
+      if (res == 0) {
+        fclose(fd);
+        return false;
+      }
+      I[i][j] = v;
+    }
+  }
+
+  fclose(fd);
+  return true;
+}
+
+template<class Type>
+bool sameImages(const vpImage<Type> &I1, const vpImage<Type> &I2)
+{
+  if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth())
+    return false;
+  for (unsigned int i = 0; i < I1.getHeight() * I1.getWidth(); i++)
+    if (! (I1.bitmap[i] == I2.bitmap[i]))
+      return false;
+  return true;
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    std::string opath;
+    unsigned int nb_iterations = 20;
+
+#if defined(_WIN32)
+    opath = "C:/temp";
+#else
+    opath = "/tmp";
+#endif
+
+    // Read the command line options
+    if (getOptions(argc, argv, opath, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    // Synthetic image with an odd width to exercise the scalar tails
+    vpImage<vpRGBa> I(481, 643);
+    srand(0);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        I[i][j] = vpRGBa((unsigned char)(i + j), (unsigned char)(rand() % 256), (unsigned char)(3*i), 0);
+      }
+    }
+    vpImage<unsigned char> Igrey;
+    vpImageConvert::convert(I, Igrey);
+
+    std::string ppmname = vpIoTools::createFilePath(opath, "testPerformanceIoPPM.ppm");
+    std::string pgmname = vpIoTools::createFilePath(opath, "testPerformanceIoPPM.pgm");
+    vpImageIo::writePPM(I, ppmname);
+    vpImageIo::writePGM(Igrey, pgmname);
+
+    // The images are read again and again in the same instances, as when a
+    // sequence is replayed
+    vpImage<vpRGBa> I_ref, I_ppm, I_pgm, Igrey_ref;
+    vpImage<unsigned char> Igrey_ppm, Igrey_pgm, Igrey_conv;
+
+    double t_ref = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nb_iterations; n++) {
+      if (! readPNMPixelByPixel(I_ref, ppmname, true)) {
+        std::cerr << "Cannot read " << ppmname << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    t_ref = vpTime::measureTimeMs() - t_ref;
+
+    double t_ppm = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nb_iterations; n++)
+      vpImageIo::readPPM(I_ppm, ppmname);
+    t_ppm = vpTime::measureTimeMs() - t_ppm;
+
+    std::cout << "PPM to vpRGBa: pixel by pixel " << t_ref / nb_iterations << " ms, readPPM() "
+              << t_ppm / nb_iterations << " ms" << std::endl;
+
+    double t_ref_grey = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nb_iterations; n++) {
+      readPNMPixelByPixel(I_ref, ppmname, true);
+      vpImageConvert::convert(I_ref, Igrey_conv);
+    }
+    t_ref_grey = vpTime::measureTimeMs() - t_ref_grey;
+
+    double t_ppm_grey = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nb_iterations; n++)
+      vpImageIo::readPPM(Igrey_ppm, ppmname);
+    t_ppm_grey = vpTime::measureTimeMs() - t_ppm_grey;
+
+    std::cout << "PPM to grey: pixel by pixel " << t_ref_grey / nb_iterations << " ms, readPPM() "
+              << t_ppm_grey / nb_iterations << " ms" << std::endl;
+
+    double t_ref_pgm = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nb_iterations; n++)
+      readPNMPixelByPixel(Igrey_ref, pgmname, false);
+    t_ref_pgm = vpTime::measureTimeMs() - t_ref_pgm;
+
+    double t_pgm = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nb_iterations; n++)
+      vpImageIo::readPGM(I_pgm, pgmname);
+    t_pgm = vpTime::measureTimeMs() - t_pgm;
+
+    std::cout << "PGM to vpRGBa: pixel by pixel " << t_ref_pgm / nb_iterations << " ms, readPGM() "
+              << t_pgm / nb_iterations << " ms" << std::endl;
+
+    vpImageIo::readPGM(Igrey_pgm, pgmname);
+
+    bool ok = true;
+    if (! sameImages(I_ref, I) || ! sameImages(I_ppm, I)) {
+      std::cerr << "readPPM() does not give the written vpRGBa image" << std::endl;
+      ok = false;
+    }
+    if (! sameImages(Igrey_ppm, Igrey_conv)) {
+      std::cerr << "readPPM() does not give the same grey image than the conversion of the vpRGBa image" << std::endl;
+      ok = false;
+    }
+    if (! sameImages(Igrey_pgm, Igrey) || ! sameImages(I_pgm, Igrey_ref)) {
+      std::cerr << "readPGM() does not give the written image" << std::endl;
+      ok = false;
+    }
+
+    remove(ppmname.c_str());
+    remove(pgmname.c_str());
+
+    if (! ok)
+      return EXIT_FAILURE;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
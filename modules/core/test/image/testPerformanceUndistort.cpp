@@ -0,0 +1,293 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the image undistortion.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceUndistort.cpp
+
+  \brief Check the undistortion of grey level and color images with
+  vpImageTools::undistort() and vpImageTools::remap() against a per pixel
+  bilinear interpolation, also when the camera parameters change between two
+  calls to undistort(), and time them for common resolutions.
+*/
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Benchmark the undistortion of grey level and color images.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Number of times each undistortion is timed.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/*
+  Undistortion of the component c of the pixels of an image of nbChannels
+  bytes per pixel, computed in double precision for each pixel as
+  vpImageTools::undistort() did before the undistortion maps.
+*/
+void undistortPerPixel(const unsigned char *src, unsigned char *dst, unsigned int width, unsigned int height,
+                       unsigned int nbChannels, const vpCameraParameters &cam, std::vector<double> &expected)
+{
+  double u0 = cam.get_u0(), v0 = cam.get_v0();
+  double kud_px2 = cam.get_kud() / (cam.get_px() * cam.get_px());
+  double kud_py2 = cam.get_kud() / (cam.get_py() * cam.get_py());
+  expected.resize(width*height*nbChannels);
+
+  for (unsigned int v = 0; v < height; v++) {
+    double deltav = v - v0;
+    double fr1 = 1.0 + kud_py2 * deltav * deltav;
+    for (unsigned int u = 0; u < width; u++) {
+      double deltau = u - u0;
+      double fr2 = fr1 + kud_px2 * deltau * deltau;
+      double u_double = deltau * fr2 + u0;
+      double v_double = deltav * fr2 + v0;
+      int u_round = (int)u_double;
+      int v_round = (int)v_double;
+      for (unsigned int c = 0; c < nbChannels; c++) {
+        double value = 0;
+        if (u_double > -1 && v_double > -1 && u_round < (int)width - 1 && v_round < (int)height - 1) {
+          double du = std::max(0., u_double - u_round), dv = std::max(0., v_double - v_round);
+          const unsigned char *p = src + (v_round*width + u_round)*nbChannels + c;
+          double top = p[0] + (p[nbChannels] - p[0]) * du;
+          p += width*nbChannels;
+          double bottom = p[0] + (p[nbChannels] - p[0]) * du;
+          value = top + (bottom - top) * dv;
+        }
+        expected[(v*width + u)*nbChannels + c] = value;
+        dst[(v*width + u)*nbChannels + c] = (unsigned char)value;
+      }
+    }
+  }
+}
+
+/*
+  Check that the undistorted image is close to the exact interpolation: the
+  sub-pixel positions of the maps are rounded to 1/128 pixel in both
+  directions, which gives an error up to 2 * 255/256 plus the rounding of the
+  result.
+*/
+bool check(const unsigned char *dst, const std::vector<double> &expected, const char *name,
+           unsigned int width, unsigned int height)
+{
+  for (size_t i = 0; i < expected.size(); i++) {
+    if (fabs(dst[i] - expected[i]) > 2.5) {
+      std::cerr << name << " of a " << width << "x" << height << " image differs at byte " << i
+                << ": " << (int)dst[i] << " instead of " << expected[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 10;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    // The first resolutions are only checked: the single row and single
+    // column images have no valid source point, the third one exercises the
+    // scalar tails of the SIMD loops
+    const unsigned int nb_checked_resolutions = 3;
+    const unsigned int nb_resolutions = 6;
+    const unsigned int widths[nb_resolutions] = { 37, 1, 38, 640, 1280, 1920 };
+    const unsigned int heights[nb_resolutions] = { 1, 29, 6, 480, 720, 1080 };
+
+    srand(0);
+    std::cout << "Undistortion times (ms): per pixel / undistort() / remap()" << std::endl;
+    for (unsigned int r = 0; r < nb_resolutions; r++) {
+      const unsigned int width = widths[r], height = heights[r];
+      vpCameraParameters cam;
+      cam.initPersProjWithDistortion(0.9*width, 0.9*width, width/2., height/2., -0.2, 0.2);
+
+      vpImage<unsigned char> I(height, width), Iundist, Iref(height, width);
+      vpImage<vpRGBa> C(height, width), Cundist, Cref(height, width);
+      for (unsigned int i = 0; i < I.getSize(); i++) {
+        I.bitmap[i] = (unsigned char)(rand() % 256);
+        C.bitmap[i] = vpRGBa((unsigned char)(rand() % 256), (unsigned char)(rand() % 256),
+                             (unsigned char)(rand() % 256), (unsigned char)(rand() % 256));
+      }
+
+      std::vector<double> expected;
+      vpUndistortMap map(cam, width, height);
+
+      double t0 = vpTime::measureTimeMs();
+      undistortPerPixel(I.bitmap, Iref.bitmap, width, height, 1, cam, expected);
+      t0 = vpTime::measureTimeMs() - t0;
+      vpImageTools::undistort(I, cam, Iundist);
+      if (! check(Iundist.bitmap, expected, "Grey undistort()", width, height))
+        return EXIT_FAILURE;
+      vpImageTools::remap(I, map, Iundist);
+      if (! check(Iundist.bitmap, expected, "Grey remap()", width, height))
+        return EXIT_FAILURE;
+
+      double c0 = vpTime::measureTimeMs();
+      undistortPerPixel((unsigned char *)C.bitmap, (unsigned char *)Cref.bitmap, width, height, 4, cam, expected);
+      c0 = vpTime::measureTimeMs() - c0;
+      vpImageTools::undistort(C, cam, Cundist);
+      if (! check((unsigned char *)Cundist.bitmap, expected, "Color undistort()", width, height))
+        return EXIT_FAILURE;
+      vpImageTools::remap(C, map, Cundist);
+      if (! check((unsigned char *)Cundist.bitmap, expected, "Color remap()", width, height))
+        return EXIT_FAILURE;
+
+      // undistort() keeps the map of its last call, it has to be rebuilt
+      // when only the camera parameters change
+      vpCameraParameters cam2;
+      cam2.initPersProjWithDistortion(0.8*width, 0.85*width, width/2. + 1, height/2. - 1, 0.1, -0.1);
+      undistortPerPixel(I.bitmap, Iref.bitmap, width, height, 1, cam2, expected);
+      vpImageTools::undistort(I, cam2, Iundist);
+      if (! check(Iundist.bitmap, expected, "Grey undistort() with other parameters", width, height))
+        return EXIT_FAILURE;
+      undistortPerPixel((unsigned char *)C.bitmap, (unsigned char *)Cref.bitmap, width, height, 4, cam, expected);
+      vpImageTools::undistort(C, cam, Cundist);
+      if (! check((unsigned char *)Cundist.bitmap, expected, "Color undistort() with the first parameters", width, height))
+        return EXIT_FAILURE;
+
+      if (r < nb_checked_resolutions)
+        continue;
+
+      double t1 = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_iterations; i++)
+        vpImageTools::undistort(I, cam, Iundist);
+      t1 = (vpTime::measureTimeMs() - t1) / nb_iterations;
+      double t2 = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_iterations; i++)
+        vpImageTools::remap(I, map, Iundist);
+      t2 = (vpTime::measureTimeMs() - t2) / nb_iterations;
+
+      double c1 = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_iterations; i++)
+        vpImageTools::undistort(C, cam, Cundist);
+      c1 = (vpTime::measureTimeMs() - c1) / nb_iterations;
+      double c2 = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_iterations; i++)
+        vpImageTools::remap(C, map, Cundist);
+      c2 = (vpTime::measureTimeMs() - c2) / nb_iterations;
+
+      std::cout << "  " << width << "x" << height << " grey: " << t0 << " / " << t1 << " / " << t2 << std::endl;
+      std::cout << "  " << width << "x" << height << " color: " << c0 << " / " << c1 << " / " << c2 << std::endl;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,307 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the fixed-size geometry types stored inline in the objects.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testInlineStorage.cpp
+
+  \brief Check the copy and the assignment of the geometry types that store
+  their elements inline, their resizing through vpArray2D, their
+  reallocation in a std::vector, and compare the unrolled products and
+  inverse of the homogeneous, rotation and twist matrices with the generic
+  vpMatrix product.
+*/
+
+#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpForceTwistMatrix.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/core/vpPoseVector.h>
+#include <visp3/core/vpQuaternionVector.h>
+#include <visp3/core/vpRotationMatrix.h>
+#include <visp3/core/vpRxyzVector.h>
+#include <visp3/core/vpRzyxVector.h>
+#include <visp3/core/vpRzyzVector.h>
+#include <visp3/core/vpThetaUVector.h>
+#include <visp3/core/vpTranslationVector.h>
+#include <visp3/core/vpVelocityTwistMatrix.h>
+
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <cmath>
+
+namespace {
+// Check that the elements of an object are in its own memory, not on the heap
+template<class Type>
+bool isInline(const Type &A)
+{
+  const char *p = (const char *)A.data;
+  return (p >= (const char *)&A) && (p < (const char *)&A + sizeof(Type));
+}
+
+// Check that the row pointers of an array point to its elements
+bool rowsValid(const vpArray2D<double> &A)
+{
+  for (unsigned int i = 0; i < A.getRows(); i++) {
+    if (A[i] != A.data + i*A.getCols())
+      return false;
+  }
+  return true;
+}
+
+// Largest difference between two arrays, infinite if their sizes differ
+double maxDifference(const vpArray2D<double> &A, const vpArray2D<double> &B)
+{
+  if ((A.getRows() != B.getRows()) || (A.getCols() != B.getCols()))
+    return std::numeric_limits<double>::infinity();
+  double diff = 0;
+  for (unsigned int i = 0; i < A.size(); i++)
+    diff = std::max(diff, std::fabs(A.data[i] - B.data[i]));
+  return diff;
+}
+
+// Copy and assign an object with non zero elements, and check that the
+// copies are inline and independent of the source
+template<class Type>
+bool checkCopy(const std::string &name, const Type &A)
+{
+  Type B(A);
+  Type C;
+  C = A;
+  Type D(A);
+  const Type &Dref = D;
+  D = Dref;
+
+  if (! isInline(A) || ! isInline(B) || ! isInline(C) || ! isInline(D)
+      || ! rowsValid(B) || ! rowsValid(C) || ! rowsValid(D)) {
+    std::cerr << name << ": the copies are not stored inline" << std::endl;
+    return false;
+  }
+  if (maxDifference(A, B) != 0 || maxDifference(A, C) != 0 || maxDifference(A, D) != 0) {
+    std::cerr << name << ": the copies differ from the source" << std::endl;
+    return false;
+  }
+  double a0 = A.data[0];
+  B.data[0] += 1;
+  C.data[0] += 1;
+  if (A.data[0] != a0) {
+    std::cerr << name << ": the copies share the elements of the source" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+vpHomogeneousMatrix pose(unsigned int k)
+{
+  return vpHomogeneousMatrix(0.3 * sin(0.7*k), -0.2 * cos(1.3*k), 0.5 + 0.1 * k,
+                             vpMath::rad(40 * sin(0.9*k + 1)), vpMath::rad(30 * cos(1.1*k)), vpMath::rad(5. * k));
+}
+
+// Twist matrix [A, [t]x B; 0, B] or [A, 0; [t]x B, B] built with vpMatrix
+vpMatrix twist(const vpTranslationVector &t, const vpRotationMatrix &R, bool velocity)
+{
+  vpMatrix tR = vpTranslationVector::skew(t) * vpMatrix(R);
+  vpMatrix T(6, 6);
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 3; j++) {
+      T[i][j] = T[i+3][j+3] = R[i][j];
+      if (velocity)
+        T[i][j+3] = tR[i][j];
+      else
+        T[i+3][j] = tR[i][j];
+    }
+  }
+  return T;
+}
+}
+
+int main()
+{
+  try {
+    // Copy and assignment of each type
+    vpHomogeneousMatrix M = pose(3);
+    vpRotationMatrix R(M);
+    vpTranslationVector t(M);
+    if (! checkCopy("vpHomogeneousMatrix", M) || ! checkCopy("vpRotationMatrix", R)
+        || ! checkCopy("vpTranslationVector", t)
+        || ! checkCopy("vpVelocityTwistMatrix", vpVelocityTwistMatrix(M))
+        || ! checkCopy("vpForceTwistMatrix", vpForceTwistMatrix(M))
+        || ! checkCopy("vpPoseVector", vpPoseVector(M))
+        || ! checkCopy("vpThetaUVector", vpThetaUVector(0.1, -0.2, 0.3))
+        || ! checkCopy("vpRxyzVector", vpRxyzVector(0.1, -0.2, 0.3))
+        || ! checkCopy("vpRzyxVector", vpRzyxVector(0.1, -0.2, 0.3))
+        || ! checkCopy("vpRzyzVector", vpRzyzVector(0.1, -0.2, 0.3))
+        || ! checkCopy("vpQuaternionVector", vpQuaternionVector(0.1, -0.2, 0.3, 0.9)))
+      return EXIT_FAILURE;
+
+    // Resizing through vpArray2D moves the elements on the heap and keeps
+    // them, the copies have the size of the source as before the inline storage
+    {
+      vpTranslationVector t1(1, 2, 3);
+      vpArray2D<double> &A = t1;
+      A.resize(3, 1, false);
+      if (! isInline(t1) || t1[0] != 1 || t1[2] != 3) {
+        std::cerr << "Resizing a translation vector to its size changed it" << std::endl;
+        return EXIT_FAILURE;
+      }
+      A.resize(5, 1, false);
+      t1[3] = 4;
+      t1[4] = 5;
+      vpTranslationVector t2(t1);
+      for (unsigned int k = 0; k < 5; k++) {
+        if (t1.getRows() != 5 || t2.getRows() != 5 || t1[k] != k+1 || t2[k] != k+1
+            || ! rowsValid(t1) || ! rowsValid(t2)) {
+          std::cerr << "A translation vector resized to 5 rows is not copied with its 5 elements" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      vpTranslationVector t4(1, 2, 3);
+      vpArray2D<double> &A4 = t4;
+      A4.resize(2, 1, false);
+      vpTranslationVector t5(t4);
+      if (t5.getRows() != 2 || t5[0] != 1 || t5[1] != 2) {
+        std::cerr << "A translation vector resized to 2 rows is not copied with its 2 elements" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vpThetaUVector tu(0.1, 0.2, 0.3);
+      vpArray2D<double> &Atu = tu;
+      Atu.resize(4, 1, false);
+      vpThetaUVector tu2(tu);
+      if (tu2.getRows() != 4 || tu2[0] != 0.1 || tu2[2] != 0.3 || ! rowsValid(tu2)) {
+        std::cerr << "A resized theta-u vector is not copied with its 4 elements" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vpHomogeneousMatrix M1 = pose(5), M1_ref = M1;
+      vpArray2D<double> &AM = M1;
+      AM.resize(6, 4, false);
+      if (isInline(M1) || ! rowsValid(M1) || M1.getRows() != 6) {
+        std::cerr << "A homogeneous matrix resized to 6 rows is still inline" << std::endl;
+        return EXIT_FAILURE;
+      }
+      for (unsigned int i = 0; i < 4; i++) {
+        for (unsigned int j = 0; j < 4; j++) {
+          if (M1[i][j] != M1_ref[i][j]) {
+            std::cerr << "A homogeneous matrix resized to 6 rows lost its elements" << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+
+      vpRotationMatrix R1(M1_ref), R1_ref(M1_ref);
+      vpArray2D<double> &AR = R1;
+      AR.resize(3, 4, false);
+      for (unsigned int i = 0; i < 3; i++) {
+        for (unsigned int j = 0; j < 4; j++) {
+          if (R1[i][j] != ((j < 3) ? R1_ref[i][j] : 0)) {
+            std::cerr << "A rotation matrix resized to 4 columns lost its elements" << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+    // Reallocation of the elements of a std::vector
+    {
+      std::vector<vpHomogeneousMatrix> poses;
+      for (unsigned int k = 0; k < 100; k++)
+        poses.push_back(pose(k));
+      poses.insert(poses.begin(), pose(100));
+      poses.erase(poses.begin() + 50);
+      for (size_t k = 0; k < poses.size(); k++) {
+        unsigned int expected = (k == 0) ? 100 : ((k < 50) ? (unsigned int)k - 1 : (unsigned int)k);
+        if (! isInline(poses[k]) || ! rowsValid(poses[k]) || maxDifference(poses[k], pose(expected)) != 0) {
+          std::cerr << "The homogeneous matrix " << k << " of the vector is wrong after its reallocation" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Unrolled kernels against the generic vpMatrix product
+    double diff = 0;
+    for (unsigned int k = 0; k < 50; k++) {
+      vpHomogeneousMatrix M1 = pose(k), M2 = pose(k + 17);
+      vpRotationMatrix R1(M1), R2(M2);
+      vpTranslationVector t1(M1), t2(M2);
+      vpMatrix G1(M1), G2(M2);
+
+      diff = std::max(diff, maxDifference(M1 * M2, G1 * G2));
+      diff = std::max(diff, maxDifference(M1.inverse(), G1.pseudoInverse()));
+      vpHomogeneousMatrix M1inv;
+      M1.inverse(M1inv);
+      diff = std::max(diff, maxDifference(M1inv, G1.pseudoInverse()));
+
+      vpColVector v(4);
+      v[0] = t2[0]; v[1] = t2[1]; v[2] = t2[2]; v[3] = 1;
+      vpColVector Gv = G1 * v;
+      diff = std::max(diff, maxDifference(M1 * v, Gv));
+      vpTranslationVector Mt = M1 * t2;
+      for (unsigned int i = 0; i < 3; i++)
+        diff = std::max(diff, std::fabs(Mt[i] - Gv[i]));
+      vpPoint P;
+      P.set_X(t2[0]); P.set_Y(t2[1]); P.set_Z(t2[2]); P.set_W(1);
+      vpPoint MP = M1 * P;
+      diff = std::max(diff, std::max(std::fabs(MP.get_X() - Gv[0]), std::fabs(MP.get_Y() - Gv[1])));
+      diff = std::max(diff, std::max(std::fabs(MP.get_Z() - Gv[2]), std::fabs(MP.get_W() - 1)));
+
+      diff = std::max(diff, maxDifference(R1 * R2, vpMatrix(R1) * vpMatrix(R2)));
+      diff = std::max(diff, maxDifference(R1.t(), vpMatrix(R1).t()));
+      vpColVector c2(3);
+      c2[0] = t2[0]; c2[1] = t2[1]; c2[2] = t2[2];
+      diff = std::max(diff, maxDifference(R1 * t2, vpMatrix(R1) * c2));
+
+      diff = std::max(diff, maxDifference(vpVelocityTwistMatrix(t1, R1), twist(t1, R1, true)));
+      diff = std::max(diff, maxDifference(vpForceTwistMatrix(t1, R1), twist(t1, R1, false)));
+    }
+    std::cout << "Largest difference with the generic product: " << diff << std::endl;
+    if (diff > 1e-10) {
+      std::cerr << "The unrolled kernels differ from the generic product" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
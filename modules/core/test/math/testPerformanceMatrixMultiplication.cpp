@@ -0,0 +1,345 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the matrix multiplication kernel.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceMatrixMultiplication.cpp
+
+  \brief Compare the blocked matrix multiplication behind vpMatrix::mult2Matrices(),
+  vpMatrix::AtA(), vpMatrix::AAt(), vpMatrix::multMatrixVector() and vpGEMM() with
+  the textbook triple loop, from 6x6 up to 4000x6 matrices.
+*/
+
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpGEMM.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Benchmark the matrix multiplication kernel against the textbook\n\
+triple loop.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Scale factor on the number of products timed for\n\
+     each size.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+vpMatrix makeRandomMatrix(unsigned int nbrows, unsigned int nbcols)
+{
+  vpMatrix A(nbrows, nbcols);
+  for (unsigned int i = 0; i < nbrows; i++)
+    for (unsigned int j = 0; j < nbcols; j++)
+      A[i][j] = (double)rand() / (double)RAND_MAX - 0.5;
+  return A;
+}
+
+// Textbook i-j-k product as implemented before the blocked kernel
+void multNaive(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
+{
+  if ((A.getRows() != C.getRows()) || (B.getCols() != C.getCols())) C.resize(A.getRows(), B.getCols());
+  for (unsigned int i = 0; i < A.getRows(); i++) {
+    const double *a = A[i];
+    double *c = C[i];
+    for (unsigned int j = 0; j < B.getCols(); j++) {
+      double s = 0;
+      for (unsigned int k = 0; k < B.getRows(); k++) s += a[k] * B[k][j];
+      c[j] = s;
+    }
+  }
+}
+
+// Textbook A^T A as implemented before the blocked kernel
+void AtANaive(const vpMatrix &A, vpMatrix &B)
+{
+  if ((B.getRows() != A.getCols()) || (B.getCols() != A.getCols())) B.resize(A.getCols(), A.getCols());
+  for (unsigned int i = 0; i < A.getCols(); i++) {
+    for (unsigned int j = 0; j <= i; j++) {
+      double s = 0;
+      for (unsigned int k = 0; k < A.getRows(); k++) s += A[k][i] * A[k][j];
+      B[i][j] = B[j][i] = s;
+    }
+  }
+}
+
+// Textbook A v as implemented before the blocked kernel
+void multMatrixVectorNaive(const vpMatrix &A, const vpColVector &v, vpColVector &w)
+{
+  if (A.getRows() != w.getRows()) w.resize(A.getRows());
+  w = 0.0;
+  for (unsigned int j = 0; j < A.getCols(); j++) {
+    double vj = v[j];
+    for (unsigned int i = 0; i < A.getRows(); i++) w[i] += A[i][j] * vj;
+  }
+}
+
+double maxError(const vpArray2D<double> &A, const vpArray2D<double> &B)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols())
+    return 1e10;
+  double err = 0.;
+  for (unsigned int i = 0; i < A.getRows(); i++)
+    for (unsigned int j = 0; j < A.getCols(); j++)
+      err = std::max(err, std::fabs(A[i][j] - B[i][j]));
+  return err;
+}
+
+void printTimes(const std::string &what, double t_naive, double t_new)
+{
+  std::cout << what << ": naive " << t_naive << " ms, blocked " << t_new << " ms, speed-up "
+            << (t_new > 0. ? t_naive / t_new : 0.) << std::endl;
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 1;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    srand(0);
+    const double tolerance = 1e-9;
+
+    // (rows of A, cols of A = rows of B, cols of B)
+    const unsigned int nb_sizes = 9;
+    unsigned int sizes[nb_sizes][3] = {
+      {6, 6, 6}, {12, 6, 6}, {60, 6, 6}, {600, 6, 6}, {4000, 6, 6},
+      {6, 4000, 6}, {64, 64, 64}, {200, 200, 200}, {4000, 6, 256}
+    };
+
+    for (unsigned int s = 0; s < nb_sizes; s++) {
+      unsigned int m = sizes[s][0], k = sizes[s][1], n = sizes[s][2];
+      vpMatrix A = makeRandomMatrix(m, k);
+      vpMatrix B = makeRandomMatrix(k, n);
+      vpMatrix C_naive, C;
+
+      // Aim at roughly the same amount of work for each size
+      unsigned int nb_products = nb_iterations * std::max(1u, (unsigned int)(4e6 / ((double)m*n*k)));
+
+      double t_naive = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_products; i++)
+        multNaive(A, B, C_naive);
+      t_naive = vpTime::measureTimeMs() - t_naive;
+
+      double t = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_products; i++)
+        vpMatrix::mult2Matrices(A, B, C);
+      t = vpTime::measureTimeMs() - t;
+
+      std::ostringstream os;
+      os << "(" << m << "x" << k << ")*(" << k << "x" << n << ") x" << nb_products;
+      printTimes(os.str(), t_naive, t);
+
+      if (maxError(C, C_naive) > tolerance) {
+        std::cerr << "mult2Matrices() differs from the naive product for " << os.str() << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // Check also the other operations that rely on the kernel
+      vpMatrix Ct_naive;
+      multNaive(B.t(), A.t(), Ct_naive);
+      vpMatrix D;
+      vpGEMM(B, A, 1.0, null, 0., D, VP_GEMM_A_T + VP_GEMM_B_T);
+      if (maxError(D, Ct_naive) > tolerance) {
+        std::cerr << "vpGEMM() differs from the naive product for " << os.str() << std::endl;
+        return EXIT_FAILURE;
+      }
+      vpGEMM(A, B, 2.0, C_naive, -1.0, D);
+      if (maxError(D, C_naive) > tolerance) {
+        std::cerr << "vpGEMM() with C differs from the naive product for " << os.str() << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (m <= 1000) {
+        vpMatrix AAt, AAt_naive;
+        A.AAt(AAt);
+        multNaive(A, A.t(), AAt_naive);
+        if (maxError(AAt, AAt_naive) > tolerance) {
+          std::cerr << "AAt() differs from the naive product for " << os.str() << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Tiny scale factors are applied, only the exact values 0 and 1 are special cases
+    {
+      vpMatrix A = makeRandomMatrix(64, 64), B = makeRandomMatrix(64, 64), C = makeRandomMatrix(64, 64);
+      vpMatrix AB, D;
+      multNaive(A, B, AB);
+      const double scale = 1e-17;
+      vpGEMM(A, B, scale, C, scale, D);
+      if (maxError(D, scale * (AB + C)) > scale * tolerance) {
+        std::cerr << "vpGEMM() does not apply tiny alpha and beta" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Normal equations of a VVS problem: J^T J and J^T e
+    unsigned int nb_rows[4] = {6, 60, 600, 4000};
+    for (unsigned int s = 0; s < 4; s++) {
+      vpMatrix J = makeRandomMatrix(nb_rows[s], 6);
+      vpColVector e(nb_rows[s]);
+      for (unsigned int i = 0; i < e.getRows(); i++)
+        e[i] = (double)rand() / (double)RAND_MAX;
+      vpMatrix JtJ_naive, JtJ;
+      vpColVector Jte_naive, Jte;
+      vpMatrix Jt = J.t();
+
+      unsigned int nb_products = nb_iterations * std::max(1u, (unsigned int)(4e6 / (36. * nb_rows[s])));
+
+      double t_naive = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_products; i++)
+        AtANaive(J, JtJ_naive);
+      t_naive = vpTime::measureTimeMs() - t_naive;
+
+      double t = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_products; i++)
+        J.AtA(JtJ);
+      t = vpTime::measureTimeMs() - t;
+
+      std::ostringstream os;
+      os << "AtA (" << nb_rows[s] << "x6) x" << nb_products;
+      printTimes(os.str(), t_naive, t);
+
+      if (maxError(JtJ, JtJ_naive) > tolerance) {
+        std::cerr << "AtA() differs from the naive product for " << os.str() << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      t_naive = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_products; i++)
+        multMatrixVectorNaive(Jt, e, Jte_naive);
+      t_naive = vpTime::measureTimeMs() - t_naive;
+
+      t = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_products; i++)
+        vpMatrix::multMatrixVector(Jt, e, Jte);
+      t = vpTime::measureTimeMs() - t;
+
+      std::ostringstream os2;
+      os2 << "multMatrixVector (6x" << nb_rows[s] << ") x" << nb_products;
+      printTimes(os2.str(), t_naive, t);
+
+      if (maxError(Jte, Jte_naive) > tolerance) {
+        std::cerr << "multMatrixVector() differs from the naive product for " << os2.str() << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,307 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the binary frames exchanged between vpServer and vpClient.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceNetwork.cpp
+
+  \brief Measure on the loopback interface the latency of a pose and the
+  throughput of grey level and color images exchanged as binary frames
+  between a vpServer and a vpClient running in two threads. The client sends
+  back each frame it receives, and the server checks that the echoed data are
+  unchanged.
+*/
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpClient.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpServer.h>
+#include <visp3/core/vpThread.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:p:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations, int port);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations, int &port);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+  \param port : Port of the server.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations, int port)
+{
+  fprintf(stdout, "\n\
+Benchmark the binary frames exchanged between a server and a client\n\
+on the loopback interface.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-p <port>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Number of round trips for each kind of frame.\n\
+\n\
+  -p <port>                                            %d\n\
+     Port of the server.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations, port);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \param port : Port of the server.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations, int &port)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'p': port = atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations, port); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations, port); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations, port);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+struct vpEchoArgs
+{
+  int port;
+  unsigned int nb_iterations;
+  bool ok;
+};
+
+// Wait until a frame is received, the timeout of the network being short
+template<class Type>
+bool receiveImageBlocking(vpNetwork &net, vpImage<Type> &I)
+{
+  int res;
+  while ((res = net.receiveImage(I)) == 0) {};
+  return res > 0;
+}
+
+bool receiveMatrixBlocking(vpNetwork &net, vpArray2D<double> &M)
+{
+  int res;
+  while ((res = net.receiveMatrix(M)) == 0) {};
+  return res > 0;
+}
+
+// The client sends back each frame it receives
+vpThread::Return echoClient(vpThread::Args args)
+{
+  vpEchoArgs *echo = (vpEchoArgs *)args;
+  echo->ok = false;
+
+  vpClient client;
+  if (! client.connectToIP("127.0.0.1", (unsigned int)echo->port))
+    return 0;
+
+  vpHomogeneousMatrix M;
+  vpImage<unsigned char> I;
+  vpImage<vpRGBa> Irgba;
+
+  for (unsigned int i = 0; i < echo->nb_iterations; i++) {
+    if (! receiveMatrixBlocking(client, M) || client.sendMatrix(M) <= 0)
+      return 0;
+  }
+  for (unsigned int i = 0; i < echo->nb_iterations; i++) {
+    if (! receiveImageBlocking(client, I) || client.sendImage(I) <= 0)
+      return 0;
+  }
+  for (unsigned int i = 0; i < echo->nb_iterations; i++) {
+    if (! receiveImageBlocking(client, Irgba) || client.sendImage(Irgba) <= 0)
+      return 0;
+  }
+
+  echo->ok = true;
+  return 0;
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 100;
+    int port = 35010;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations, port) == false) {
+      exit (-1);
+    }
+
+    vpServer serv(port);
+    if (! serv.start()) {
+      std::cerr << "Cannot start the server on port " << port << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpEchoArgs echo;
+    echo.port = port;
+    echo.nb_iterations = nb_iterations;
+    echo.ok = false;
+    vpThread client_thread((vpThread::Fn)echoClient, (vpThread::Args)&echo);
+
+    double t_start = vpTime::measureTimeMs();
+    while (serv.getNumberOfClients() == 0) {
+      serv.checkForConnections();
+      if (vpTime::measureTimeMs() - t_start > 10000) {
+        std::cerr << "No client connected" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Pose latency
+    vpHomogeneousMatrix M(0.1, 0.2, 0.3, 0.4, 0.5, 0.6), M_echo;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nb_iterations; i++) {
+      if (serv.sendMatrix(M) <= 0 || ! receiveMatrixBlocking(serv, M_echo)) {
+        std::cerr << "Cannot exchange the pose" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    t = vpTime::measureTimeMs() - t;
+    for (unsigned int i = 0; i < 4; i++)
+      for (unsigned int j = 0; j < 4; j++)
+        if (M[i][j] != M_echo[i][j]) {
+          std::cerr << "The echoed pose differs" << std::endl;
+          return EXIT_FAILURE;
+        }
+    std::cout << "Pose: round trip " << 1000. * t / nb_iterations << " us" << std::endl;
+
+    // Grey level images
+    vpImage<unsigned char> I(480, 640), I_echo;
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned char)(i * 7);
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nb_iterations; i++) {
+      if (serv.sendImage(I) <= 0 || ! receiveImageBlocking(serv, I_echo)) {
+        std::cerr << "Cannot exchange the grey level image" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    t = vpTime::measureTimeMs() - t;
+    if (! (I == I_echo)) {
+      std::cerr << "The echoed grey level image differs" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "640x480 grey level image: round trip " << t / nb_iterations << " ms, throughput "
+              << (t > 0. ? 2. * nb_iterations * I.getSize() / (t * 1000.) : 0.) << " MB/s" << std::endl;
+
+    // Color images
+    vpImage<vpRGBa> Irgba(480, 640), Irgba_echo;
+    for (unsigned int i = 0; i < Irgba.getSize(); i++)
+      Irgba.bitmap[i] = vpRGBa((unsigned char)i, (unsigned char)(i * 3), (unsigned char)(i * 5), 255);
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nb_iterations; i++) {
+      if (serv.sendImage(Irgba) <= 0 || ! receiveImageBlocking(serv, Irgba_echo)) {
+        std::cerr << "Cannot exchange the color image" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    t = vpTime::measureTimeMs() - t;
+    if (! (Irgba == Irgba_echo)) {
+      std::cerr << "The echoed color image differs" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "640x480 color image: round trip " << t / nb_iterations << " ms, throughput "
+              << (t > 0. ? 2. * nb_iterations * Irgba.getSize() * sizeof(vpRGBa) / (t * 1000.) : 0.) << " MB/s" << std::endl;
+
+    client_thread.join();
+    if (! echo.ok) {
+      std::cerr << "The client failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+int main()
+{
+  std::cout << "You should enable pthread usage and rebuild ViSP..." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the deprojection of depth maps into a vpPointCloud.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPointCloud.cpp
+
+  \brief Check the point cloud built by vpPointCloud::deproject() against
+  vpPixelMeterConversion, the conversions from and to vectors of vpColVector,
+  and compare the timing with a cloud stored as a std::vector<vpColVector>.
+*/
+
+#include <visp3/core/vpPointCloud.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Test the deprojection of depth maps into a point cloud.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Number of depth maps deprojected for the timing.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Per pixel deprojection into a vector of vpColVector, as done by the grabbers before vpPointCloud
+void deprojectNaive(const vpImage<uint16_t> &depth, float depth_scale, const vpCameraParameters &cam, float max_Z,
+                    std::vector<vpColVector> &pointcloud)
+{
+  vpColVector p3d(4);
+  pointcloud.resize(depth.getSize());
+  for (unsigned int i = 0; i < depth.getHeight(); i++) {
+    for (unsigned int j = 0; j < depth.getWidth(); j++) {
+      double x = 0, y = 0;
+      vpPixelMeterConversion::convertPoint(cam, (double)j, (double)i, x, y);
+      float Z = depth[i][j] * depth_scale;
+      if (Z <= 0 || Z > max_Z)
+        Z = 0;
+      p3d[0] = x*Z;
+      p3d[1] = y*Z;
+      p3d[2] = Z;
+      p3d[3] = 1;
+      pointcloud[i*depth.getWidth() + j] = p3d;
+    }
+  }
+}
+
+// Maximal difference between a point cloud and its vpColVector representation
+double maxError(const vpPointCloud &pointcloud, const std::vector<vpColVector> &points)
+{
+  if (points.size() != pointcloud.size())
+    return 1e10;
+  double err = 0;
+  for (unsigned int i = 0; i < pointcloud.size(); i++) {
+    float X, Y, Z;
+    pointcloud.getPoint(i, X, Y, Z);
+    err = std::max(err, std::fabs(X - points[i][0]));
+    err = std::max(err, std::fabs(Y - points[i][1]));
+    err = std::max(err, std::fabs(Z - points[i][2]));
+  }
+  return err;
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 20;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    srand(0);
+    const float depth_scale = 0.001f, max_Z = 4.f;
+    // Odd width to exercise the tail of the vectorized loops
+    vpImage<uint16_t> depth(479, 641);
+    for (unsigned int i = 0; i < depth.getSize(); i++)
+      depth.bitmap[i] = (uint16_t)(rand() % 5000); // Up to 5m, with invalid pixels above max_Z
+    depth[10][10] = 0;
+
+    vpCameraParameters cams[2];
+    cams[0].initPersProjWithoutDistortion(600., 590., 320.5, 240.5);
+    cams[1].initPersProjWithDistortion(600., 590., 320.5, 240.5, -0.27, 0.29);
+
+    vpPointCloud pointcloud;
+    std::vector<vpColVector> points_naive, points;
+    for (unsigned int c = 0; c < 2; c++) {
+      std::cout << "Camera " << (c == 0 ? "without" : "with") << " distortion" << std::endl;
+
+      pointcloud.deproject(depth, depth_scale, cams[c], max_Z);
+      deprojectNaive(depth, depth_scale, cams[c], max_Z, points_naive);
+      if (! pointcloud.isOrganized() || pointcloud.getHeight() != depth.getHeight() || pointcloud.getWidth() != depth.getWidth()) {
+        std::cerr << "The point cloud is not organized like the depth map" << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (maxError(pointcloud, points_naive) > 1e-5) {
+        std::cerr << "Deprojection differs from vpPixelMeterConversion: " << maxError(pointcloud, points_naive) << std::endl;
+        return EXIT_FAILURE;
+      }
+      float X, Y, Z;
+      pointcloud.getPoint(10*depth.getWidth() + 10, X, Y, Z);
+      if (std::fabs(X) > 0 || std::fabs(Y) > 0 || std::fabs(Z) > 0) {
+        std::cerr << "A pixel without depth should lead to a null point" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // The same metric depth map as float gives the same cloud
+      vpImage<float> depth_m(depth.getHeight(), depth.getWidth());
+      for (unsigned int i = 0; i < depth.getSize(); i++)
+        depth_m.bitmap[i] = depth.bitmap[i] * depth_scale;
+      depth_m[0][0] = -1.f;
+      points_naive[0][0] = points_naive[0][1] = points_naive[0][2] = 0;
+      vpPointCloud pointcloud_m;
+      pointcloud_m.deproject(depth_m, cams[c], max_Z);
+      if (maxError(pointcloud_m, points_naive) > 1e-5) {
+        std::cerr << "Deprojection of a float depth map differs from vpPixelMeterConversion" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // Round trip through the vpColVector representation
+      pointcloud.convert(points);
+      vpPointCloud pointcloud2;
+      pointcloud2.buildFrom(points);
+      if (pointcloud2.isOrganized() || pointcloud2.size() != pointcloud.size() || maxError(pointcloud2, points) > 0) {
+        std::cerr << "Conversion from and to std::vector<vpColVector> failed" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // Timing
+      const float *ptr = pointcloud.getX();
+      double t_naive = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_iterations; i++)
+        deprojectNaive(depth, depth_scale, cams[c], max_Z, points_naive);
+      t_naive = vpTime::measureTimeMs() - t_naive;
+
+      double t = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_iterations; i++)
+        pointcloud.deproject(depth, depth_scale, cams[c], max_Z);
+      t = vpTime::measureTimeMs() - t;
+
+      double t_convert = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nb_iterations; i++)
+        pointcloud.convert(points);
+      t_convert = vpTime::measureTimeMs() - t_convert;
+
+      if (ptr != pointcloud.getX()) {
+        std::cerr << "The point cloud memory should be reused" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      std::cout << "  " << depth.getWidth() << "x" << depth.getHeight() << " x" << nb_iterations
+                << ": std::vector<vpColVector> " << t_naive << " ms, vpPointCloud " << t
+                << " ms, speed-up " << (t > 0. ? t_naive / t : 0.)
+                << ", conversion to std::vector<vpColVector> " << t_convert << " ms" << std::endl;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -131,6 +131,59 @@ bool getOptions(int argc, const char **argv, bool& opt_display, bool& opt_click)
 
 
 
+/*!
+  Check if the ray of vpPolygon::isInside(const vpImagePoint &) may go
+  through a vertex when starting from (i, j). Its random generator soon
+  returns identical values, so that the ray goes along the diagonal towards
+  the bottom right, and the result is then undefined.
+*/
+bool onVertexDiagonal(const std::vector<vpImagePoint> &corners, double i, double j)
+{
+  for (size_t k = 0; k < corners.size(); k++) {
+    if (i - corners[k].get_i() == j - corners[k].get_j())
+      return true;
+  }
+  return false;
+}
+
+/*!
+  Check that the mask filled by vpPolygon::fillMask() matches the per pixel
+  vpPolygon::isInside(corners, i, j) test previously used to build the KLT
+  masks, with and without border erosion. Pixels for which this test is
+  undefined (see onVertexDiagonal()) are skipped.
+
+  \return The number of pixels that differ.
+*/
+unsigned int checkMask(const vpPolygon &p, unsigned int height, unsigned int width, unsigned int shiftBorder)
+{
+  vpImage<unsigned char> mask(height, width, 0);
+  p.fillMask(mask, 255, shiftBorder);
+
+  const std::vector<vpImagePoint> &corners = p.getCorners();
+  double s = (double)shiftBorder;
+  unsigned int nbErrors = 0;
+  for (unsigned int i = 0; i < height; i++) {
+    double i_d = (double)i;
+    for (unsigned int j = 0; j < width; j++) {
+      double j_d = (double)j;
+      if (onVertexDiagonal(corners, i_d, j_d) || onVertexDiagonal(corners, i_d+s, j_d-s)
+          || onVertexDiagonal(corners, i_d-s, j_d+s))
+        continue;
+
+      bool in = vpPolygon::isInside(corners, i_d, j_d);
+      if (shiftBorder != 0) {
+        in = in && vpPolygon::isInside(corners, i_d+s, j_d+s)
+            && vpPolygon::isInside(corners, i_d-s, j_d+s)
+            && vpPolygon::isInside(corners, i_d+s, j_d-s)
+            && vpPolygon::isInside(corners, i_d-s, j_d-s);
+      }
+      if (in != (mask[i][j] == 255))
+        nbErrors++;
+    }
+  }
+  return nbErrors;
+}
+
 /* -------------------------------------------------------------------------- */
 /*                               MAIN FUNCTION                                */
 /* -------------------------------------------------------------------------- */
@@ -190,6 +243,26 @@ main(int argc, const char** argv)
     std::cout << " area : " << p3.getArea() << std::endl;
     std::cout << " center : " << p3.getCenter() << std::endl;
 
+    // A concave polygon partly outside the image
+    std::vector <vpImagePoint> vec5;
+    vec5.push_back(vpImagePoint(-30.5, 100.25));
+    vec5.push_back(vpImagePoint(150.75, 630.5));
+    vec5.push_back(vpImagePoint(470.25, 400.75));
+    vec5.push_back(vpImagePoint(250.5, 350.25));
+    vec5.push_back(vpImagePoint(420.75, 20.5));
+    vpPolygon p5(vec5);
+
+    unsigned int shifts[] = {0, 1, 3};
+    for (unsigned int k = 0; k < 3; k++) {
+      unsigned int nbErrors = checkMask(p1, I.getHeight(), I.getWidth(), shifts[k])
+          + checkMask(p2, I.getHeight(), I.getWidth(), shifts[k])
+          + checkMask(p5, I.getHeight(), I.getWidth(), shifts[k]);
+      std::cout << " Mask with a border of " << shifts[k] << " pixels: " << nbErrors << " wrong pixels" << std::endl;
+      if (nbErrors != 0) {
+        return 1;
+      }
+    }
+
 
     if(opt_display){
 #if (defined VISP_HAVE_X11) || (defined VISP_HAVE_GTK) || (defined VISP_HAVE_GDI)
@@ -0,0 +1,248 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the pool of worker threads.
+ *
+ *****************************************************************************/
+
+/*!
+
+  \example testThreadPool.cpp
+
+  \brief Test vpThreadPool and the functions that rely on it.
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpHistogram.h>
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpTrackingException.h>
+
+// Count how many times each index is visited
+class vpCountTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpCountTask(std::vector<unsigned int> &counts) : m_counts(counts) {}
+  void run(unsigned int start, unsigned int end)
+  {
+    for (unsigned int i = start; i < end; i++)
+      m_counts[i]++;
+  }
+private:
+  std::vector<unsigned int> &m_counts;
+};
+
+// Call parallel_for() from a task
+class vpNestedTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpNestedTask(std::vector<unsigned int> &counts, unsigned int width) : m_counts(counts), m_width(width) {}
+  void run(unsigned int start, unsigned int end)
+  {
+    for (unsigned int i = start; i < end; i++) {
+      std::vector<unsigned int> row(m_width, 0);
+      vpCountTask task(row);
+      vpThreadPool::parallel_for(0, m_width, task);
+      for (unsigned int j = 0; j < m_width; j++)
+        m_counts[i*m_width + j] += row[j];
+    }
+  }
+private:
+  std::vector<unsigned int> &m_counts;
+  unsigned int m_width;
+};
+
+class vpThrowTask : public vpThreadPool::vpRangeTask
+{
+public:
+  void run(unsigned int start, unsigned int end)
+  {
+    if (start <= 50 && 50 < end)
+      throw(vpException(vpException::badValue, "Bad index"));
+  }
+};
+
+class vpThrowTrackingTask : public vpThreadPool::vpRangeTask
+{
+public:
+  void run(unsigned int start, unsigned int end)
+  {
+    if (start <= 50 && 50 < end)
+      throw(vpTrackingException(vpTrackingException::notEnoughPointError, "Not enough points"));
+  }
+};
+
+bool checkCounts(const std::vector<unsigned int> &counts, unsigned int begin, unsigned int end)
+{
+  for (unsigned int i = 0; i < counts.size(); i++) {
+    unsigned int expected = (i >= begin && i < end) ? 1 : 0;
+    if (counts[i] != expected) {
+      std::cerr << "Index " << i << " processed " << counts[i] << " times instead of " << expected << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  try {
+    std::cout << "Number of processors: " << vpThreadPool::getNumProcessors() << std::endl;
+
+    unsigned int nbThreads[4] = {1, 2, 3, 8};
+    unsigned int grainSizes[4] = {0, 1, 7, 1000};
+
+    for (unsigned int t = 0; t < 4; t++) {
+      vpThreadPool::setNumThreads(nbThreads[t]);
+      std::cout << "Test with " << vpThreadPool::getNumThreads() << " thread(s)" << std::endl;
+
+      // Each index of the range is processed exactly once
+      for (unsigned int g = 0; g < 4; g++) {
+        for (unsigned int iter = 0; iter < 100; iter++) {
+          std::vector<unsigned int> counts(1000, 0);
+          unsigned int begin = iter, end = 1000 - 3*iter;
+          vpCountTask task(counts);
+          vpThreadPool::parallel_for(begin, end, task, grainSizes[g]);
+          if (! checkCounts(counts, begin, end))
+            return EXIT_FAILURE;
+        }
+      }
+
+      // Nested calls are processed by the calling thread
+      std::vector<unsigned int> counts(64*32, 0);
+      vpNestedTask nested(counts, 32);
+      vpThreadPool::parallel_for(0, 64, nested);
+      if (! checkCounts(counts, 0, (unsigned int)counts.size()))
+        return EXIT_FAILURE;
+
+      // Exceptions are forwarded to the caller with their code and message
+      bool caught = false;
+      try {
+        vpThrowTask throwing;
+        vpThreadPool::parallel_for(0, 100, throwing, 10);
+      }
+      catch(vpException &e) {
+        std::cout << "Exception forwarded: " << e.getStringMessage() << std::endl;
+        caught = (e.getCode() == vpException::badValue && e.getStringMessage() == "Bad index");
+      }
+      if (! caught) {
+        std::cerr << "The exception thrown in the task was not forwarded with its code" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // and with their type for the exceptions of the core module
+      caught = false;
+      try {
+        vpThrowTrackingTask throwing;
+        vpThreadPool::parallel_for(0, 100, throwing, 10);
+      }
+      catch(vpTrackingException &e) {
+        caught = (e.getCode() == vpTrackingException::notEnoughPointError
+                  && e.getStringMessage() == "Not enough points");
+      }
+      catch(vpException &) {
+      }
+      if (! caught) {
+        std::cerr << "The vpTrackingException thrown in the task was not forwarded with its type" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // Functions using the pool give the same result than the serial version
+      vpImage<unsigned char> I(241, 321);
+      vpImage<vpRGBa> I_color(241, 321);
+      for (unsigned int i = 0; i < I.getSize(); i++) {
+        I.bitmap[i] = (unsigned char)(rand() % 256);
+        I_color.bitmap[i] = vpRGBa((unsigned char)(rand() % 256), (unsigned char)(rand() % 256),
+                                   (unsigned char)(rand() % 256), (unsigned char)(rand() % 256));
+      }
+
+      unsigned char lut[256];
+      vpRGBa lut_color[256];
+      for (unsigned int i = 0; i < 256; i++) {
+        lut[i] = (unsigned char)(255 - i);
+        lut_color[i] = vpRGBa((unsigned char)(i/2), (unsigned char)(255 - i), (unsigned char)i, (unsigned char)(i/3));
+      }
+
+      vpImage<unsigned char> I_lut1 = I, I_lut2 = I;
+      I_lut1.performLut(lut, 1);
+      I_lut2.performLut(lut, 5);
+      vpImage<vpRGBa> I_color_lut1 = I_color, I_color_lut2 = I_color;
+      I_color_lut1.performLut(lut_color, 1);
+      I_color_lut2.performLut(lut_color, 5);
+      if (I_lut1 != I_lut2 || I_color_lut1 != I_color_lut2) {
+        std::cerr << "performLut() differs with several threads" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vpHistogram histogram1, histogram2;
+      histogram1.calculate(I, 64, 1);
+      histogram2.calculate(I, 64, 5);
+      for (unsigned int i = 0; i < 64; i++) {
+        if (histogram1[(unsigned char)i] != histogram2[(unsigned char)i]) {
+          std::cerr << "vpHistogram::calculate() differs with several threads" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      vpCameraParameters cam;
+      cam.initPersProjWithDistortion(400, 410, 160, 120, -0.2, 0.2);
+      vpImage<unsigned char> I_undist;
+      vpImage<unsigned char> I_undist_ref(I.getHeight(), I.getWidth());
+      vpImageTools::undistort(I, cam, I_undist);
+      vpThreadPool::setNumThreads(1);
+      vpImageTools::undistort(I, cam, I_undist_ref);
+      vpThreadPool::setNumThreads(nbThreads[t]);
+      if (I_undist != I_undist_ref) {
+        std::cerr << "vpImageTools::undistort() differs with several threads" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Restore the default number of threads
+    vpThreadPool::setNumThreads(0);
+    if (vpThreadPool::getNumThreads() != vpThreadPool::getNumProcessors()) {
+      std::cerr << "Default number of threads not restored" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getStringMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
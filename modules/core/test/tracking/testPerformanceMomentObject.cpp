@@ -0,0 +1,274 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the computation of image moments.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceMomentObject.cpp
+
+  \brief Compare vpMomentObject::fromImage() with the previous per-pixel
+  implementation for orders 3 to 8 on a 1280x1024 binary mask, with and
+  without distortion, and for the photometric moments.
+*/
+
+#include <visp3/core/vpMomentObject.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Benchmark the computation of image moments against the previous\n\
+per-pixel implementation.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Number of computations timed for each order.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Column by column accumulation of x^l*y^k per pixel, as implemented before the row engine.
+// A null threshold with weighted set to true gives the photometric moments on a black background.
+void fromImageNaive(const vpImage<unsigned char> &image, unsigned char threshold, bool weighted,
+                    const vpCameraParameters &cam, unsigned int order, std::vector<double> &values)
+{
+  std::vector<double> cache(order*order, 0.);
+  values.assign(order*order, 0.);
+  for (unsigned int i = 0; i < image.getCols(); i++) {
+    for (unsigned int j = 0; j < image.getRows(); j++) {
+      if (weighted || image[j][i] > threshold) {
+        double x = 0, y = 0;
+        vpPixelMeterConversion::convertPoint(cam, i, j, x, y);
+        double w = weighted ? image[j][i] / 255. : 1.;
+        double yval = w;
+        for (unsigned int k = 0; k < order; k++) {
+          double xval = yval;
+          for (unsigned int l = 0; l < order - k; l++) {
+            cache[k*order + l] = xval;
+            xval *= x;
+          }
+          yval *= y;
+        }
+        for (unsigned int k = 0; k < order; k++)
+          for (unsigned int l = 0; l < order - k; l++)
+            values[k*order + l] += cache[k*order + l];
+      }
+    }
+  }
+  if (! weighted) {
+    double norm_factor = 1. / (cam.get_px() * cam.get_py());
+    for (unsigned int k = 0; k < values.size(); k++)
+      values[k] *= norm_factor;
+  }
+}
+
+// Maximal relative difference between the moments
+double maxError(const vpMomentObject &obj, const std::vector<double> &values)
+{
+  unsigned int order = obj.getOrder() + 1;
+  double err = 0;
+  for (unsigned int k = 0; k < order; k++) {
+    for (unsigned int l = 0; l < order - k; l++) {
+      double ref = values[k*order + l];
+      err = std::max(err, std::fabs(obj.get(l, k) - ref) / std::max(1e-12, std::fabs(ref)));
+    }
+  }
+  return err;
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 3;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    // Elliptic mask with a hole, and a textured image for the photometric moments
+    vpImage<unsigned char> I(1024, 1280, 0), Itex(1024, 1280);
+    for (unsigned int j = 0; j < I.getHeight(); j++) {
+      for (unsigned int i = 0; i < I.getWidth(); i++) {
+        double u = ((double)i - 700.) / 400., v = ((double)j - 480.) / 300.;
+        double r2 = u*u + v*v;
+        if (r2 < 1. && r2 > 0.04)
+          I[j][i] = 255;
+        Itex[j][i] = (unsigned char)((i*7 + j*13) % 256);
+      }
+    }
+
+    vpCameraParameters cams[2];
+    cams[0].initPersProjWithoutDistortion(1200., 1210., 640., 512.);
+    cams[1].initPersProjWithDistortion(1200., 1210., 640., 512., -0.2, 0.21);
+
+    const double tolerance = 1e-9;
+    std::vector<double> values;
+
+    for (unsigned int c = 0; c < 2; c++) {
+      std::cout << "Binary moments, camera " << (c == 0 ? "without" : "with") << " distortion" << std::endl;
+      for (unsigned int order = 3; order <= 8; order++) {
+        vpMomentObject obj(order);
+
+        double t_naive = vpTime::measureTimeMs();
+        for (unsigned int it = 0; it < nb_iterations; it++)
+          fromImageNaive(I, 128, false, cams[c], order + 1, values);
+        t_naive = vpTime::measureTimeMs() - t_naive;
+
+        double t = vpTime::measureTimeMs();
+        for (unsigned int it = 0; it < nb_iterations; it++)
+          obj.fromImage(I, 128, cams[c]);
+        t = vpTime::measureTimeMs() - t;
+
+        std::cout << "  order " << order << ": previous " << t_naive / nb_iterations << " ms, row engine "
+                  << t / nb_iterations << " ms, speed-up " << (t > 0. ? t_naive / t : 0.) << std::endl;
+
+        if (maxError(obj, values) > tolerance) {
+          std::cerr << "Moments of order " << order << " differ: " << maxError(obj, values) << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        // The result doesn't depend on the number of threads
+        unsigned int nbThreads = vpThreadPool::getNumThreads();
+        vpThreadPool::setNumThreads(1);
+        vpMomentObject obj1(order);
+        obj1.fromImage(I, 128, cams[c]);
+        vpThreadPool::setNumThreads(nbThreads);
+        if (obj1.get() != obj.get()) {
+          std::cerr << "Moments of order " << order << " depend on the number of threads" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    std::cout << "Photometric moments" << std::endl;
+    for (unsigned int order = 3; order <= 8; order += 5) {
+      vpMomentObject obj(order);
+      double t_naive = vpTime::measureTimeMs();
+      fromImageNaive(Itex, 0, true, cams[0], order + 1, values);
+      t_naive = vpTime::measureTimeMs() - t_naive;
+
+      double t = vpTime::measureTimeMs();
+      obj.fromImage(Itex, cams[0], vpMomentObject::BLACK, false);
+      t = vpTime::measureTimeMs() - t;
+
+      std::cout << "  order " << order << ": previous " << t_naive << " ms, row engine "
+                << t << " ms, speed-up " << (t > 0. ? t_naive / t : 0.) << std::endl;
+      if (maxError(obj, values) > tolerance) {
+        std::cerr << "Photometric moments of order " << order << " differ: " << maxError(obj, values) << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
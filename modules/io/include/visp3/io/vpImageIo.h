@@ -133,6 +133,8 @@ private:
 
   static vpImageFormatType getFormat(const char *filename) ;
   static std::string getExtension(const std::string &filename);
+  static void readPNMHeader(FILE *fd, const char *filename, const unsigned int magic_expected,
+                            unsigned int &w, unsigned int &h);
 
 public:
 
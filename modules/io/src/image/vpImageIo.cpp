@@ -45,6 +45,8 @@
 #include <visp3/core/vpImageConvert.h> //image  conversion
 #include <visp3/core/vpIoTools.h>
 
+#include <algorithm>
+
 const int vpImageIo::vpMAX_LEN = 100;
 
 /*!
@@ -994,26 +996,26 @@ vpImageIo::readPFM(vpImage<float> &I, const char *filename)
 
 */
 
+/*!
+  Read the header of a portable gray pixmap (PGM P5) or of a portable pixmap
+  (PPM P6) file. On return, \e fd is positioned at the beginning of the raster.
+
+  \param fd : File descriptor opened with read access. It is closed if an
+  exception is thrown.
+  \param filename : Name of the file, used in error messages.
+  \param magic_expected : 5 for a PGM P5 file, 6 for a PPM P6 file.
+  \param w, h : Size of the image.
+*/
 void
-vpImageIo::readPGM(vpImage<unsigned char> &I, const char *filename)
+vpImageIo::readPNMHeader(FILE *fd, const char *filename, const unsigned int magic_expected,
+                         unsigned int &w, unsigned int &h)
 {
-  FILE* fd = NULL; // File descriptor
   int   ierr;
   char* err ;
   char  str[vpMAX_LEN];
-  unsigned int magic=5, w=0, h=0, maxval=255;
-
-  // Test the filename
-  if (!filename || *filename == '\0') {
-    throw (vpImageException(vpImageException::ioError,
-          "No filename")) ;
-  }
-
-  // Open the filename
-  if ((fd = fopen(filename, "rb")) == NULL) {
-    throw (vpImageException(vpImageException::ioError,
-          "Cannot read file \"%s\"", filename)) ;
-  }
+  unsigned int magic=magic_expected, maxval=255;
+  w = 0;
+  h = 0;
 
   while ((err = fgets(str, vpMAX_LEN - 1, fd)) != NULL && ((str[0] == '#') || (str[0] == '\n'))) {};
   if (err == NULL) {
@@ -1027,17 +1029,17 @@ vpImageIo::readPGM(vpImage<unsigned char> &I, const char *filename)
           "Cannot read header of file \"%s\"",  filename));
   }
 
-  if (magic != 5) {
+  if (magic != magic_expected) {
     fclose (fd);
     throw (vpImageException(vpImageException::ioError,
-                            "\"%s\" is not a PGM P5 file", filename));
+                            "\"%s\" is not a %s P%u file", filename, (magic_expected == 5 ? "PGM" : "PPM"), magic_expected));
   }
 
   // Depending on ierr the line may contain:
-  // 1 : P5
-  // 2 : P5 w
-  // 3 : P5 w h
-  // 4 : P5 w h maxval
+  // 1 : P5 or P6
+  // 2 : P5 or P6 w
+  // 3 : P5 or P6 w h
+  // 4 : P5 or P6 w h maxval
 
   if (ierr == 1) {
 //    std::cout << "magic: " << magic << std::endl;
@@ -1168,6 +1170,27 @@ vpImageIo::readPGM(vpImage<unsigned char> &I, const char *filename)
     throw (vpImageException(vpImageException::ioError,
           "Bad maxval in \"%s\"",  filename));
   }
+}
+
+void
+vpImageIo::readPGM(vpImage<unsigned char> &I, const char *filename)
+{
+  FILE* fd = NULL; // File descriptor
+  unsigned int w=0, h=0;
+
+  // Test the filename
+  if (!filename || *filename == '\0') {
+    throw (vpImageException(vpImageException::ioError,
+          "No filename")) ;
+  }
+
+  // Open the filename
+  if ((fd = fopen(filename, "rb")) == NULL) {
+    throw (vpImageException(vpImageException::ioError,
+          "Cannot read file \"%s\"", filename)) ;
+  }
+
+  readPNMHeader(fd, filename, 5, w, h);
 
   if ((h != I.getHeight())||( w != I.getWidth())) {
     I.resize(h,w) ;
@@ -1206,20 +1229,41 @@ vpImageIo::readPGM(vpImage<unsigned char> &I, const char *filename)
 void
 vpImageIo::readPGM(vpImage<vpRGBa> &I, const char *filename)
 {
-  try
-  {
-    vpImage<unsigned char> Itmp ;
+  FILE* fd = NULL; // File descriptor
+  unsigned int w=0, h=0;
 
-    vpImageIo::readPGM(Itmp, filename) ;
+  // Test the filename
+  if (!filename || *filename == '\0') {
+    throw (vpImageException(vpImageException::ioError,
+          "No filename")) ;
+  }
+
+  // Open the filename
+  if ((fd = fopen(filename, "rb")) == NULL) {
+    throw (vpImageException(vpImageException::ioError,
+          "Cannot read file \"%s\"", filename)) ;
+  }
 
-    vpImageConvert::convert(Itmp, I) ;
+  readPNMHeader(fd, filename, 5, w, h);
 
+  if ((h != I.getHeight())||( w != I.getWidth())) {
+    I.resize(h,w) ;
   }
-  catch(...)
-  {
-    vpERROR_TRACE(" ") ;
-    throw ;
+
+  // Read the gray levels at the end of the bitmap and expand them in place
+  unsigned int npixels = I.getHeight()*I.getWidth();
+  unsigned char *rgba = (unsigned char *)I.bitmap;
+  unsigned char *grey = rgba + 3*npixels;
+  size_t n;
+  if ((n = fread (grey, sizeof(unsigned char), npixels, fd)) != npixels) {
+    fclose (fd);
+    throw (vpImageException(vpImageException::ioError,
+          "Read only %d of %d bytes in file \"%s\"", n, npixels, filename));
   }
+
+  fclose (fd);
+
+  vpImageConvert::GreyToRGBa(grey, rgba, npixels);
 }
 
 
@@ -1246,20 +1290,44 @@ vpImageIo::readPGM(vpImage<vpRGBa> &I, const char *filename)
 void
 vpImageIo::readPPM(vpImage<unsigned char> &I, const char *filename)
 {
+  FILE* fd = NULL; // File descriptor
+  unsigned int w=0, h=0;
 
-  try
-  {
-    vpImage<vpRGBa> Itmp ;
+  // Test the filename
+  if (!filename || *filename == '\0') {
+    throw (vpImageException(vpImageException::ioError,
+          "No filename")) ;
+  }
+
+  // Open the filename
+  if ((fd = fopen(filename, "rb")) == NULL) {
+    throw (vpImageException(vpImageException::ioError,
+          "Cannot read file \"%s\"", filename)) ;
+  }
 
-    vpImageIo::readPPM(Itmp, filename) ;
+  readPNMHeader(fd, filename, 6, w, h);
 
-    vpImageConvert::convert(Itmp, I) ;
+  if ((h != I.getHeight())||( w != I.getWidth())) {
+    I.resize(h,w) ;
   }
-  catch(...)
-  {
-    vpERROR_TRACE(" ") ;
-    throw ;
+
+  // Read the raster by chunks in a buffer on the stack. The chunk size is a
+  // multiple of 16 pixels so that the conversion gives the same result than
+  // vpImageConvert::convert() from a vpImage<vpRGBa>.
+  const unsigned int chunk = 4096;
+  unsigned char rgb[3*chunk];
+  unsigned int npixels = I.getHeight()*I.getWidth();
+  for (unsigned int i = 0; i < npixels; i += chunk) {
+    unsigned int nb = std::min(chunk, npixels - i);
+    if (fread (rgb, sizeof(unsigned char), 3*nb, fd) != 3*nb) {
+      fclose (fd);
+      throw (vpImageException(vpImageException::ioError,
+            "Cannot read bytes in file \"%s\"\n", filename));
+    }
+    vpImageConvert::RGBToGrey(rgb, I.bitmap + i, nb);
   }
+
+  fclose (fd);
 }
 
 
@@ -1278,10 +1346,7 @@ void
 vpImageIo::readPPM(vpImage<vpRGBa> &I, const char *filename)
 {
   FILE* fd = NULL; // File descriptor
-  int   ierr;
-  char* err ;
-  char  str[vpMAX_LEN];
-  unsigned int magic=5, w=0, h=0, maxval=255;
+  unsigned int w=0, h=0;
 
   // Test the filename
   if (!filename || *filename == '\0') {
@@ -1295,183 +1360,25 @@ vpImageIo::readPPM(vpImage<vpRGBa> &I, const char *filename)
           "Cannot read file \"%s\"", filename)) ;
   }
 
-  while ((err = fgets(str, vpMAX_LEN - 1, fd)) != NULL && ((str[0] == '#') || (str[0] == '\n'))) {};
-  if (err == NULL) {
-    fclose (fd);
-    throw (vpImageException(vpImageException::ioError,
-          "Cannot read header of file \"%s\"",  filename));
-  }
-  if ((ierr = sscanf(str, "P%u %u %u %u", &magic, &w, &h, &maxval)) == 0) {
-    fclose (fd);
-    throw (vpImageException(vpImageException::ioError,
-          "Cannot read header of file \"%s\"",  filename));
-  }
-
-  if (magic != 6) {
-    fclose (fd);
-    throw (vpImageException(vpImageException::ioError,
-                            "\"%s\" is not a PGM P6 file", filename));
-  }
-
-  // Depending on ierr the line may contain:
-  // 1 : P6
-  // 2 : P6 w
-  // 3 : P6 w h
-  // 4 : P6 w h maxval
-
-  if (ierr == 1) {
-//    std::cout << "magic: " << magic << std::endl;
-    while ((err = fgets(str, vpMAX_LEN - 1, fd)) != NULL && ((str[0] == '#') || (str[0] == '\n'))) {};
-    if (err == NULL) {
-      fclose (fd);
-      throw (vpImageException(vpImageException::ioError,
-            "Cannot read header of file \"%s\"",  filename));
-    }
-    if (((ierr = sscanf(str, "%u %u %u", &w, &h, &maxval)) == 0) || (ierr != 1 && ierr != 2 && ierr != 3)) {
-      fclose (fd);
-      throw (vpImageException(vpImageException::ioError,
-            "Cannot read header of file \"%s\"",  filename));
-    }
-    // Depending on ierr the line may contain:
-    // 1 : w
-    // 2 : w h
-    // 3 : w h maxval
-    if (ierr == 1) {
-//      std::cout << "w: " << w << std::endl;
-      while ((err = fgets(str, vpMAX_LEN - 1, fd)) != NULL && ((str[0] == '#') || (str[0] == '\n'))) {};
-      if (err == NULL) {
-        fclose (fd);
-        throw (vpImageException(vpImageException::ioError,
-              "Cannot read header of file \"%s\"",  filename));
-      }
-      if (((ierr = sscanf(str, "%u %u", &h, &maxval)) == 0) || (ierr != 1 && ierr != 2)) {
-        fclose (fd);
-        throw (vpImageException(vpImageException::ioError,
-              "Cannot read header of file \"%s\"",  filename));
-      }
-      if (ierr == 1) {
-//        std::cout << "h: " << h << std::endl;
-        while ((err = fgets(str, vpMAX_LEN - 1, fd)) != NULL && ((str[0] == '#') || (str[0] == '\n'))) {};
-        if (err == NULL) {
-          fclose (fd);
-          throw (vpImageException(vpImageException::ioError,
-                "Cannot read header of file \"%s\"",  filename));
-        }
-        if ((ierr = sscanf(str, "%u", &maxval)) != 1) {
-          fclose (fd);
-          throw (vpImageException(vpImageException::ioError,
-                "Cannot read header of file \"%s\"",  filename));
-        }
-      }
-//      else {
-//        std::cout << "h: " << h << " maxval: " << maxval << std::endl;
-//      }
-    }
-    else if (ierr == 2) {
-//      std::cout << "w: " << w << " h: " << h << std::endl;
-
-      while ((err = fgets(str, vpMAX_LEN - 1, fd)) != NULL && ((str[0] == '#') || (str[0] == '\n'))) {};
-      if (err == NULL) {
-        fclose (fd);
-        throw (vpImageException(vpImageException::ioError,
-              "Cannot read header of file \"%s\"",  filename));
-      }
-      if ((ierr = sscanf(str, "%u", &maxval)) != 1)  {
-        fclose (fd);
-        throw (vpImageException(vpImageException::ioError,
-              "Cannot read header of file \"%s\"",  filename));
-      }
-//      std::cout << "maxval: " << maxval << std::endl;
-    }
-//    else {
-//      std::cout << "w: " << w << " h: " << h << " maxval: " << maxval << std::endl;
-//    }
-  }
-  else if (ierr == 2) {
-//    std::cout << "magic: " << magic << " w: " << w << std::endl;
-    while ((err = fgets(str, vpMAX_LEN - 1, fd)) != NULL && ((str[0] == '#') || (str[0] == '\n'))) {};
-    if (err == NULL) {
-      fclose (fd);
-      throw (vpImageException(vpImageException::ioError,
-            "Cannot read header of file \"%s\"",  filename));
-    }
-    if (((ierr = sscanf(str, "%u %u", &h, &maxval)) == 0) || (ierr != 1 && ierr != 2)) {
-      fclose (fd);
-      throw (vpImageException(vpImageException::ioError,
-            "Cannot read header of file \"%s\"",  filename));
-    }
-    if (ierr == 1) {
-//      std::cout << "h: " << h << std::endl;
-      while ((err = fgets(str, vpMAX_LEN - 1, fd)) != NULL && ((str[0] == '#') || (str[0] == '\n'))) {};
-      if (err == NULL) {
-        fclose (fd);
-        throw (vpImageException(vpImageException::ioError,
-              "Cannot read header of file \"%s\"",  filename));
-      }
-      if ((ierr = sscanf(str, "%u", &maxval)) != 1) {
-        fclose (fd);
-        throw (vpImageException(vpImageException::ioError,
-              "Cannot read header of file \"%s\"",  filename));
-      }
-//      std::cout << "maxval: " << maxval << std::endl;
-    }
-//    else {
-//      std::cout << "h: " << h << " maxval: " << maxval << std::endl;
-//    }
-  }
-  else if (ierr == 3) {
-//    std::cout << "magic: " << magic << " w: " << w << " h: " << h << std::endl;
-    while ((err = fgets(str, vpMAX_LEN - 1, fd)) != NULL && ((str[0] == '#') || (str[0] == '\n'))) {};
-    if (err == NULL) {
-      fclose (fd);
-      throw (vpImageException(vpImageException::ioError,
-            "Cannot read header of file \"%s\"",  filename));
-    }
-    if ((sscanf(str, "%u", &maxval)) != 1)  {
-      fclose (fd);
-      throw (vpImageException(vpImageException::ioError,
-            "Cannot read header of file \"%s\"",  filename));
-    }
-//    std::cout << "maxval: " << maxval << std::endl;
-  }
-//  else if (ierr == 4) {
-//    std::cout << "magic: " << magic << " w: " << w << " h: " << h << " maxval: " << maxval << std::endl;
-//  }
-
-  if (w > 100000 || h>100000) {
-    fclose (fd);
-    throw(vpException(vpException::badValue, "Bad image size in \"%s\"",  filename));
-  }
-  if (maxval != 255)
-  {
-    fclose (fd);
-    throw (vpImageException(vpImageException::ioError,
-          "Bad maxval in \"%s\"",  filename));
-  }
+  readPNMHeader(fd, filename, 6, w, h);
 
   if ((h != I.getHeight())||( w != I.getWidth())) {
     I.resize(h,w) ;
   }
 
-  for(unsigned int i=0;i<I.getHeight();i++)
-  {
-    for(unsigned int j=0;j<I.getWidth();j++)
-    {
-      vpRGBa v ;
-      size_t res = fread(&v.R,sizeof(v.R),1,fd) ;
-      res |= fread(&v.G,sizeof(v.G),1,fd) ;
-      res |= fread(&v.B,sizeof(v.B),1,fd) ;
-      if (res==0)
-      {
-        fclose (fd);
-        throw (vpImageException(vpImageException::ioError,
-              "Cannot read bytes in file \"%s\"\n", filename));
-      }
-      I[i][j] = v ;
-    }
+  // Read the whole raster at the end of the bitmap and expand it in place
+  unsigned int npixels = I.getHeight()*I.getWidth();
+  unsigned char *rgba = (unsigned char *)I.bitmap;
+  unsigned char *rgb = rgba + npixels;
+  if (fread (rgb, sizeof(unsigned char), 3*npixels, fd) != 3*npixels) {
+    fclose (fd);
+    throw (vpImageException(vpImageException::ioError,
+          "Cannot read bytes in file \"%s\"\n", filename));
   }
 
   fclose (fd);
+
+  vpImageConvert::RGBToRGBa(rgb, rgba, npixels);
 }
 
 /*!
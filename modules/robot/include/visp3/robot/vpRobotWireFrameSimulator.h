@@ -167,6 +167,8 @@ class VISP_EXPORT vpRobotWireFrameSimulator : protected vpWireFrameSimulator, pu
 
     //! Flag used to specify to the thread managing the robot displacements that the setVelocity() method has been called.
     bool setVelocityCalled;
+    //! Flag used to move the robot synchronously with the setVelocity() calls, using a simulated clock instead of a thread. False by default.
+    bool simulatedTimeMode;
 
     bool verbose_;
     
@@ -266,6 +268,8 @@ class VISP_EXPORT vpRobotWireFrameSimulator : protected vpWireFrameSimulator, pu
       constantSamplingTimeMode = _constantSamplingTimeMode;
     }
 
+    void setSimulatedTimeMode(const bool simulated);
+
     /*!
       Set the color used to display the object at the current position in the robot's camera view.
 
@@ -330,6 +334,11 @@ class VISP_EXPORT vpRobotWireFrameSimulator : protected vpWireFrameSimulator, pu
         this->delta_t_ = delta_t;
       }
     }
+    /*!
+      Return true if the robot is moved with a simulated clock; see setSimulatedTimeMode().
+    */
+    bool getSimulatedTimeMode() const {return simulatedTimeMode;}
+
     /*! Set the parameter which enable or disable the singularity mangement */
     void setSingularityManagement (const bool sm) {singularityManagement = sm;}
               
@@ -374,6 +383,16 @@ class VISP_EXPORT vpRobotWireFrameSimulator : protected vpWireFrameSimulator, pu
     void init() {;}
     /*! Method lauched by the thread to compute the position of the robot in the articular frame. */
     virtual void updateArticularPosition() = 0;
+    /*! Move the robot with the current articular velocity during \e ellapsedTime seconds and update the external view. */
+    virtual void integrateArticularPosition(double ellapsedTime) = 0;
+    void stepSimulatedTime(bool computeVelocity);
+    /*!
+      Return the time in second used to stamp the measures: the simulated
+      clock in simulated time mode, the Unix time otherwise.
+    */
+    double getTimestamp() const {
+      return simulatedTimeMode ? tcur * 1e-3 : vpTime::measureTimeSecond();
+    }
     /*! Method used to check if the robot reached a joint limit. */
     virtual int isInJointLimit () = 0;
     /*! Compute the articular velocity relative to the velocity in another frame. */
@@ -301,6 +301,7 @@ protected:
     int isInJointLimit (void);
     bool singularityTest(const vpColVector q, vpMatrix &J);
     void updateArticularPosition();
+    void integrateArticularPosition(double ellapsedTime);
     //@}
       
 private:
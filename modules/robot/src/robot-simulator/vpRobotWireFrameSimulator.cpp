@@ -62,7 +62,7 @@ vpRobotWireFrameSimulator::vpRobotWireFrameSimulator()
     display(),
 #endif
     displayType(MODEL_3D), displayAllowed(true), constantSamplingTimeMode(false),
-    setVelocityCalled(false), verbose_(false)
+    setVelocityCalled(false), simulatedTimeMode(false), verbose_(false)
 {
   setSamplingTime(0.010);
   velocity.resize(6);
@@ -94,7 +94,7 @@ vpRobotWireFrameSimulator::vpRobotWireFrameSimulator(bool do_display)
     display(),
 #endif
     displayType(MODEL_3D), displayAllowed(do_display), constantSamplingTimeMode(false),
-    setVelocityCalled(false), verbose_(false)
+    setVelocityCalled(false), simulatedTimeMode(false), verbose_(false)
 {
   setSamplingTime(0.010);
   velocity.resize(6);
@@ -119,6 +119,76 @@ vpRobotWireFrameSimulator::~vpRobotWireFrameSimulator()
 {
 }
 
+/*!
+  Enable or disable the simulated time mode.
+
+  By default the robot is moved by a thread that integrates the velocity
+  applied with setVelocity() during the time measured by the wall clock, so
+  that the simulation runs in real time and the resulting trajectory depends on
+  the scheduling of the threads.
+
+  In simulated time mode the thread is stopped. The robot is then moved
+  synchronously by each setVelocity() call that applies the velocity during one
+  sampling time (see setSamplingTime()), and by setPosition() that steps the
+  robot to the desired position without waiting. The time stamps returned by
+  getPosition() and getVelocity() come from a simulated clock that starts at 0
+  and is advanced by one sampling time at each step. A scenario is thus run as
+  fast as the CPU allows and always leads to the same trajectory.
+
+  \param simulated : When true, enable the simulated time mode. When false,
+  restart the thread that moves the robot in real time.
+*/
+void
+vpRobotWireFrameSimulator::setSimulatedTimeMode(const bool simulated)
+{
+  if (simulated == simulatedTimeMode)
+    return;
+
+  if (simulated) {
+    robotStop = true;
+#if defined(_WIN32)
+    WaitForSingleObject(hThread,INFINITE);
+    CloseHandle(hThread);
+#elif defined(VISP_HAVE_PTHREAD)
+    pthread_join(thread, NULL);
+#endif
+    robotStop = false;
+    setVelocityCalled = false;
+    tcur = tprev = 0;
+    simulatedTimeMode = true;
+  }
+  else {
+    simulatedTimeMode = false;
+    tcur = vpTime::measureTimeMs();
+#if defined(_WIN32)
+    DWORD dwThreadIdArray;
+    hThread = CreateThread(NULL, 0, launcher, this, 0, &dwThreadIdArray);
+#elif defined(VISP_HAVE_PTHREAD)
+    pthread_create(&thread, NULL, launcher, (void *)this);
+#endif
+  }
+}
+
+/*!
+  Advance the simulated clock by one sampling time and move the robot
+  accordingly. Used in simulated time mode in place of the thread.
+
+  \param computeVelocity : When true, the articular velocity is first computed
+  from the velocity set with setVelocity(). When false, the articular velocity
+  set by the caller is applied as is.
+*/
+void
+vpRobotWireFrameSimulator::stepSimulatedTime(bool computeVelocity)
+{
+  setVelocityCalled = false;
+  tprev = tcur;
+  tcur += 1000 * getSamplingTime();
+
+  if (computeVelocity)
+    computeArticularVelocity();
+  integrateArticularPosition(getSamplingTime());
+}
+
 /*!
   Initialize the display. It enables to choose the type of scene which will be used to display the object
   at the current position and at the desired position.
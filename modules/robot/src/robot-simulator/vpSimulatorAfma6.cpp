@@ -158,8 +158,10 @@ vpSimulatorAfma6::~vpSimulatorAfma6()
   robotStop = true;
   
   #if defined(_WIN32)
-  WaitForSingleObject(hThread,INFINITE);
-  CloseHandle(hThread);
+  if (!simulatedTimeMode) {
+    WaitForSingleObject(hThread,INFINITE);
+    CloseHandle(hThread);
+  }
   CloseHandle(mutex_fMi);
   CloseHandle(mutex_artVel);
   CloseHandle(mutex_artCoord);
@@ -167,7 +169,8 @@ vpSimulatorAfma6::~vpSimulatorAfma6()
   CloseHandle(mutex_display);
   #elif defined(VISP_HAVE_PTHREAD)
   pthread_attr_destroy(&attr);
-  pthread_join(thread, NULL);
+  if (!simulatedTimeMode)
+    pthread_join(thread, NULL);
   pthread_mutex_destroy(&mutex_fMi);
   pthread_mutex_destroy(&mutex_artVel);
   pthread_mutex_destroy(&mutex_artCoord);
@@ -520,106 +523,117 @@ vpSimulatorAfma6::updateArticularPosition()
         ellapsedTime = getSamplingTime(); // in second
       }
     
-      vpColVector articularCoordinates = get_artCoord();
-      articularCoordinates = get_artCoord();
-      vpColVector articularVelocities = get_artVel();
-    
-      if (jointLimit)
-      {
-        double art = articularCoordinates[jointLimitArt-1] + ellapsedTime*articularVelocities[jointLimitArt-1];
-        if (art <= _joint_min[jointLimitArt-1] || art >= _joint_max[jointLimitArt-1]) {
-          if (verbose_) {
-            std::cout << "Joint " << jointLimitArt-1
-                    << " reaches a limit: " << vpMath::deg(_joint_min[jointLimitArt-1]) << " < "
-                    << vpMath::deg(art) << " < " << vpMath::deg(_joint_max[jointLimitArt-1]) << std::endl;
-          }
+      integrateArticularPosition(ellapsedTime);
 
-          articularVelocities = 0.0;
-        }
-        else
-          jointLimit = false;
-      }
-    
-      articularCoordinates[0] = articularCoordinates[0] + ellapsedTime*articularVelocities[0];
-      articularCoordinates[1] = articularCoordinates[1] + ellapsedTime*articularVelocities[1];
-      articularCoordinates[2] = articularCoordinates[2] + ellapsedTime*articularVelocities[2];
-      articularCoordinates[3] = articularCoordinates[3] + ellapsedTime*articularVelocities[3];
-      articularCoordinates[4] = articularCoordinates[4] + ellapsedTime*articularVelocities[4];
-      articularCoordinates[5] = articularCoordinates[5] + ellapsedTime*articularVelocities[5];
-      
-      int jl = isInJointLimit();
-      
-      if (jl != 0 && jointLimit == false)
-      {
-        if (jl < 0)
-          ellapsedTime = (_joint_min[(unsigned int)(-jl-1)] - articularCoordinates[(unsigned int)(-jl-1)])/(articularVelocities[(unsigned int)(-jl-1)]);
-        else
-          ellapsedTime = (_joint_max[(unsigned int)(jl-1)] - articularCoordinates[(unsigned int)(jl-1)])/(articularVelocities[(unsigned int)(jl-1)]);
-      
-        for (unsigned int i = 0; i < 6; i++)
-          articularCoordinates[i] = articularCoordinates[i] + ellapsedTime*articularVelocities[i];
-      
-        jointLimit = true;
-        jointLimitArt = (unsigned int)fabs((double)jl);
-      }
+      vpTime::wait( tcur, 1000*getSamplingTime() );
+      tcur_1 = tcur;
+    }else{
+      vpTime::wait(tcur, vpTime::getMinTimeForUsleepCall());
+    }
+  }
+}
 
-      set_artCoord(articularCoordinates);
-      set_artVel(articularVelocities);
-    
-      compute_fMi();
-   
-      if (displayAllowed)
-      {
-        vpDisplay::display(I);
-        vpDisplay::displayFrame(I,getExternalCameraPosition (),cameraParam,0.2,vpColor::none, thickness_);
-        vpDisplay::displayFrame(I,getExternalCameraPosition ()*fMi[7],cameraParam,0.1,vpColor::none, thickness_);
-      }
-    
-      if (displayType == MODEL_3D && displayAllowed)
-      {
-        while (get_displayBusy()) vpTime::wait(2);
-        vpSimulatorAfma6::getExternalImage(I);
-        set_displayBusy(false);
+/*!
+  Move the robot with the current articular velocity during \e ellapsedTime
+  seconds, taking the joint limits into account, and update the external view.
+
+  \param ellapsedTime : Integration time in second.
+*/
+void
+vpSimulatorAfma6::integrateArticularPosition(double ellapsedTime)
+{
+  vpColVector articularCoordinates = get_artCoord();
+  articularCoordinates = get_artCoord();
+  vpColVector articularVelocities = get_artVel();
+
+  if (jointLimit)
+  {
+    double art = articularCoordinates[jointLimitArt-1] + ellapsedTime*articularVelocities[jointLimitArt-1];
+    if (art <= _joint_min[jointLimitArt-1] || art >= _joint_max[jointLimitArt-1]) {
+      if (verbose_) {
+        std::cout << "Joint " << jointLimitArt-1
+                << " reaches a limit: " << vpMath::deg(_joint_min[jointLimitArt-1]) << " < "
+                << vpMath::deg(art) << " < " << vpMath::deg(_joint_max[jointLimitArt-1]) << std::endl;
       }
-        
+
+      articularVelocities = 0.0;
+    }
+    else
+      jointLimit = false;
+  }
+
+  articularCoordinates[0] = articularCoordinates[0] + ellapsedTime*articularVelocities[0];
+  articularCoordinates[1] = articularCoordinates[1] + ellapsedTime*articularVelocities[1];
+  articularCoordinates[2] = articularCoordinates[2] + ellapsedTime*articularVelocities[2];
+  articularCoordinates[3] = articularCoordinates[3] + ellapsedTime*articularVelocities[3];
+  articularCoordinates[4] = articularCoordinates[4] + ellapsedTime*articularVelocities[4];
+  articularCoordinates[5] = articularCoordinates[5] + ellapsedTime*articularVelocities[5];
+  
+  int jl = isInJointLimit();
+  
+  if (jl != 0 && jointLimit == false)
+  {
+    if (jl < 0)
+      ellapsedTime = (_joint_min[(unsigned int)(-jl-1)] - articularCoordinates[(unsigned int)(-jl-1)])/(articularVelocities[(unsigned int)(-jl-1)]);
+    else
+      ellapsedTime = (_joint_max[(unsigned int)(jl-1)] - articularCoordinates[(unsigned int)(jl-1)])/(articularVelocities[(unsigned int)(jl-1)]);
+  
+    for (unsigned int i = 0; i < 6; i++)
+      articularCoordinates[i] = articularCoordinates[i] + ellapsedTime*articularVelocities[i];
+  
+    jointLimit = true;
+    jointLimitArt = (unsigned int)fabs((double)jl);
+  }
+
+  set_artCoord(articularCoordinates);
+  set_artVel(articularVelocities);
+
+  compute_fMi();
+
+  if (displayAllowed)
+  {
+    vpDisplay::display(I);
+    vpDisplay::displayFrame(I,getExternalCameraPosition (),cameraParam,0.2,vpColor::none, thickness_);
+    vpDisplay::displayFrame(I,getExternalCameraPosition ()*fMi[7],cameraParam,0.1,vpColor::none, thickness_);
+  }
+
+  if (displayType == MODEL_3D && displayAllowed)
+  {
+    while (get_displayBusy()) vpTime::wait(2);
+    vpSimulatorAfma6::getExternalImage(I);
+    set_displayBusy(false);
+  }
     
-      if (0/*displayType == MODEL_DH && displayAllowed*/)
-      {
-        vpHomogeneousMatrix fMit[8];
-        get_fMi(fMit);
-      
-      //vpDisplay::displayFrame(I,getExternalCameraPosition ()*fMi[6],cameraParam,0.2,vpColor::none);
 
-        vpImagePoint iP, iP_1;
-        vpPoint pt(0,0,0);
-      
-        pt.track(getExternalCameraPosition ());
-        vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP_1);
-        pt.track(getExternalCameraPosition ()*fMit[0]);
-        vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP);
-        vpDisplay::displayLine(I,iP_1,iP,vpColor::green, thickness_);
-        for (unsigned int k = 1; k < 7; k++)
-        {
-          pt.track(getExternalCameraPosition ()*fMit[k-1]);
-          vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP_1);
-        
-          pt.track(getExternalCameraPosition ()*fMit[k]);
-          vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP);
-        
-          vpDisplay::displayLine(I,iP_1,iP,vpColor::green, thickness_);
-        }
-        vpDisplay::displayCamera(I,getExternalCameraPosition ()*fMit[7],cameraParam,0.1,vpColor::green, thickness_);
-      }
+  if (0/*displayType == MODEL_DH && displayAllowed*/)
+  {
+    vpHomogeneousMatrix fMit[8];
+    get_fMi(fMit);
+  
+  //vpDisplay::displayFrame(I,getExternalCameraPosition ()*fMi[6],cameraParam,0.2,vpColor::none);
+
+    vpImagePoint iP, iP_1;
+    vpPoint pt(0,0,0);
+  
+    pt.track(getExternalCameraPosition ());
+    vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP_1);
+    pt.track(getExternalCameraPosition ()*fMit[0]);
+    vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP);
+    vpDisplay::displayLine(I,iP_1,iP,vpColor::green, thickness_);
+    for (unsigned int k = 1; k < 7; k++)
+    {
+      pt.track(getExternalCameraPosition ()*fMit[k-1]);
+      vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP_1);
     
-      vpDisplay::flush(I);
+      pt.track(getExternalCameraPosition ()*fMit[k]);
+      vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP);
     
-      
-      vpTime::wait( tcur, 1000*getSamplingTime() );
-      tcur_1 = tcur;
-    }else{
-      vpTime::wait(tcur, vpTime::getMinTimeForUsleepCall());
+      vpDisplay::displayLine(I,iP_1,iP,vpColor::green, thickness_);
     }
+    vpDisplay::displayCamera(I,getExternalCameraPosition ()*fMit[7],cameraParam,0.1,vpColor::green, thickness_);
   }
+
+  vpDisplay::flush(I);
 }
 
 /*!
@@ -973,6 +987,9 @@ vpSimulatorAfma6::setVelocity (const vpRobot::vpControlFrameType frame, const vp
   set_velocity (vel * scale_sat);
   setRobotFrame (frame);
   setVelocityCalled = true;
+
+  if (simulatedTimeMode)
+    stepSimulatedTime(true);
 }
 
 
@@ -1161,7 +1178,8 @@ vpSimulatorAfma6::getVelocity (const vpRobot::vpControlFrameType frame, vpColVec
   \param vel : Measured velocities. Translations are expressed in m/s
   and rotations in rad/s.
 
-  \param timestamp : Unix time in second since January 1st 1970.
+  \param timestamp : Unix time in second since January 1st 1970, or
+  simulated time in second in simulated time mode (see setSimulatedTimeMode()).
 
   \warning In camera frame, reference frame and mixt frame, the representation
   of the rotation is ThetaU. In that cases, \f$velocity = [\dot x, \dot y, \dot
@@ -1172,7 +1190,7 @@ vpSimulatorAfma6::getVelocity (const vpRobot::vpControlFrameType frame, vpColVec
 void
 vpSimulatorAfma6::getVelocity (const vpRobot::vpControlFrameType frame, vpColVector & vel, double &timestamp)
 {
-  timestamp = vpTime::measureTimeSecond();
+  timestamp = getTimestamp();
   getVelocity(frame, vel);
 }
 
@@ -1232,7 +1250,8 @@ vpSimulatorAfma6::getVelocity (vpRobot::vpControlFrameType frame)
 
   \param frame : Frame in wich velocities are mesured.
 
-  \param timestamp : Unix time in second since January 1st 1970.
+  \param timestamp : Unix time in second since January 1st 1970, or
+  simulated time in second in simulated time mode (see setSimulatedTimeMode()).
 
   \return Measured velocities. Translations are expressed in m/s
   and rotations in rad/s.
@@ -1242,7 +1261,7 @@ vpSimulatorAfma6::getVelocity (vpRobot::vpControlFrameType frame)
 vpColVector
 vpSimulatorAfma6::getVelocity (vpRobot::vpControlFrameType frame, double &timestamp)
 {
-  timestamp = vpTime::measureTimeSecond();
+  timestamp = getTimestamp();
   vpColVector vel(6);
   getVelocity (frame, vel);
 
@@ -1395,6 +1414,8 @@ vpSimulatorAfma6::setPosition(const vpRobot::vpControlFrameType frame,const vpCo
             set_velocity(error);
             break;
           }
+          if (simulatedTimeMode)
+            stepSimulatedTime(false);
         }
         else
         {
@@ -1425,6 +1446,8 @@ vpSimulatorAfma6::setPosition(const vpRobot::vpControlFrameType frame,const vpCo
           set_velocity(error);
           break;
         }
+        if (simulatedTimeMode)
+          stepSimulatedTime(false);
       }while (errsqr > 1e-8);
       break ;
     }
@@ -1465,6 +1488,8 @@ vpSimulatorAfma6::setPosition(const vpRobot::vpControlFrameType frame,const vpCo
             set_velocity(error);
             break;
           }
+          if (simulatedTimeMode)
+            stepSimulatedTime(false);
         }
         else
           vpERROR_TRACE ("Positionning error. Position unreachable");
@@ -1753,14 +1778,15 @@ vpSimulatorAfma6::getPosition(const vpRobot::vpControlFrameType frame, vpColVect
   last 3 values to the rx, ry, rz rotation (like a vpRxyzVector). The code
   below show how to convert this position into a vpHomogeneousMatrix:
 
-  \param timestamp : Unix time in second since January 1st 1970.
+  \param timestamp : Unix time in second since January 1st 1970, or
+  simulated time in second in simulated time mode (see setSimulatedTimeMode()).
 
   \sa getPosition(const vpRobot::vpControlFrameType frame, vpColVector &q)
  */
 void
 vpSimulatorAfma6::getPosition(const vpRobot::vpControlFrameType frame, vpColVector &q, double &timestamp)
 {
-  timestamp = vpTime::measureTimeSecond();
+  timestamp = getTimestamp();
   getPosition(frame, q);
 }
 
@@ -1807,7 +1833,7 @@ void
 vpSimulatorAfma6::getPosition(const vpRobot::vpControlFrameType frame,
                                  vpPoseVector &position, double &timestamp)
 {
-  timestamp = vpTime::measureTimeSecond();
+  timestamp = getTimestamp();
   getPosition(frame, position);
 }
 
@@ -2619,7 +2645,8 @@ vpSimulatorAfma6::setPosition(const vpHomogeneousMatrix &cdMo_, vpImage<unsigned
 		setVelocity(vpRobot::CAMERA_FRAME,vel);
 
 		// wait for it
-		vpTime::wait(t,10);
+		if (!simulatedTimeMode)
+			vpTime::wait(t,10);
 		}
 	vel=0.;
 	set_velocity(vel);
@@ -158,8 +158,10 @@ vpSimulatorViper850::~vpSimulatorViper850()
   robotStop = true;
   
   #if defined(_WIN32)
-  WaitForSingleObject(hThread,INFINITE);
-  CloseHandle(hThread);
+  if (!simulatedTimeMode) {
+    WaitForSingleObject(hThread,INFINITE);
+    CloseHandle(hThread);
+  }
   CloseHandle(mutex_fMi);
   CloseHandle(mutex_artVel);
   CloseHandle(mutex_artCoord);
@@ -167,7 +169,8 @@ vpSimulatorViper850::~vpSimulatorViper850()
   CloseHandle(mutex_display);
   #elif defined(VISP_HAVE_PTHREAD)
   pthread_attr_destroy(&attr);
-  pthread_join(thread, NULL);
+  if (!simulatedTimeMode)
+    pthread_join(thread, NULL);
   pthread_mutex_destroy(&mutex_fMi);
   pthread_mutex_destroy(&mutex_artVel);
   pthread_mutex_destroy(&mutex_artCoord);
@@ -466,97 +469,8 @@ vpSimulatorViper850::updateArticularPosition()
         ellapsedTime = getSamplingTime(); // in second
       }
       
-      vpColVector articularCoordinates = get_artCoord();
-      articularCoordinates = get_artCoord();
-      vpColVector articularVelocities = get_artVel();
-      
-      if (jointLimit)
-      {
-        double art = articularCoordinates[jointLimitArt-1] + ellapsedTime*articularVelocities[jointLimitArt-1];
-        if (art <= joint_min[jointLimitArt-1] || art >= joint_max[jointLimitArt-1]) {
-          if (verbose_) {
-            std::cout << "Joint " << jointLimitArt-1
-                    << " reaches a limit: " << vpMath::deg(joint_min[jointLimitArt-1]) << " < " << vpMath::deg(art) << " < " << vpMath::deg(joint_max[jointLimitArt-1]) << std::endl;
-          }
-          articularVelocities = 0.0;
-        }
-        else
-          jointLimit = false;
-      }
-      
-      articularCoordinates[0] = articularCoordinates[0] + ellapsedTime*articularVelocities[0];
-      articularCoordinates[1] = articularCoordinates[1] + ellapsedTime*articularVelocities[1];
-      articularCoordinates[2] = articularCoordinates[2] + ellapsedTime*articularVelocities[2];
-      articularCoordinates[3] = articularCoordinates[3] + ellapsedTime*articularVelocities[3];
-      articularCoordinates[4] = articularCoordinates[4] + ellapsedTime*articularVelocities[4];
-      articularCoordinates[5] = articularCoordinates[5] + ellapsedTime*articularVelocities[5];
-      
-      int jl = isInJointLimit();
-      
-      if (jl != 0 && jointLimit == false)
-      {
-        if (jl < 0)
-          ellapsedTime = (joint_min[(unsigned int)(-jl-1)] - articularCoordinates[(unsigned int)(-jl-1)])/(articularVelocities[(unsigned int)(-jl-1)]);
-        else
-          ellapsedTime = (joint_max[(unsigned int)(jl-1)] - articularCoordinates[(unsigned int)(jl-1)])/(articularVelocities[(unsigned int)(jl-1)]);
-        
-        for (unsigned int i = 0; i < 6; i++)
-          articularCoordinates[i] = articularCoordinates[i] + ellapsedTime*articularVelocities[i];
-        
-        jointLimit = true;
-        jointLimitArt = (unsigned int)fabs((double)jl);
-      }
-
-      set_artCoord(articularCoordinates);
-      set_artVel(articularVelocities);
-      
-      compute_fMi();
-     
-      if (displayAllowed)
-      {
-        vpDisplay::display(I);
-        vpDisplay::displayFrame(I,getExternalCameraPosition (),cameraParam,0.2,vpColor::none, thickness_);
-        vpDisplay::displayFrame(I,getExternalCameraPosition ()*fMi[7],cameraParam,0.1,vpColor::none, thickness_);
-      }
-      
-      if (displayType == MODEL_3D && displayAllowed)
-      {
-        while (get_displayBusy()) vpTime::wait(2);
-        vpSimulatorViper850::getExternalImage(I);
-        set_displayBusy(false);
-      }
-        
-      
-      if (displayType == MODEL_DH && displayAllowed)
-      {
-        vpHomogeneousMatrix fMit[8];
-        get_fMi(fMit);
-      
-      //vpDisplay::displayFrame(I,getExternalCameraPosition ()*fMi[6],cameraParam,0.2,vpColor::none);
+      integrateArticularPosition(ellapsedTime);
 
-        vpImagePoint iP, iP_1;
-        vpPoint pt(0,0,0);
-      
-        pt.track(getExternalCameraPosition ());
-        vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP_1);
-        pt.track(getExternalCameraPosition ()*fMit[0]);
-        vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP);
-        vpDisplay::displayLine(I, iP_1, iP, vpColor::green, thickness_);
-        for (int k = 1; k < 7; k++)
-        {
-          pt.track(getExternalCameraPosition ()*fMit[k-1]);
-          vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP_1);
-        
-          pt.track(getExternalCameraPosition ()*fMit[k]);
-          vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP);
-        
-          vpDisplay::displayLine(I,iP_1,iP,vpColor::green, thickness_);
-        }
-        vpDisplay::displayCamera(I,getExternalCameraPosition ()*fMit[7],cameraParam,0.1,vpColor::green, thickness_);
-      }
-      
-      vpDisplay::flush(I);      
-      
       vpTime::wait( tcur, 1000 * getSamplingTime() );
       tcur_1 = tcur;
     }else{
@@ -565,6 +479,107 @@ vpSimulatorViper850::updateArticularPosition()
   }
 }
 
+/*!
+  Move the robot with the current articular velocity during \e ellapsedTime
+  seconds, taking the joint limits into account, and update the external view.
+
+  \param ellapsedTime : Integration time in second.
+*/
+void
+vpSimulatorViper850::integrateArticularPosition(double ellapsedTime)
+{
+  vpColVector articularCoordinates = get_artCoord();
+  articularCoordinates = get_artCoord();
+  vpColVector articularVelocities = get_artVel();
+  
+  if (jointLimit)
+  {
+    double art = articularCoordinates[jointLimitArt-1] + ellapsedTime*articularVelocities[jointLimitArt-1];
+    if (art <= joint_min[jointLimitArt-1] || art >= joint_max[jointLimitArt-1]) {
+      if (verbose_) {
+        std::cout << "Joint " << jointLimitArt-1
+                << " reaches a limit: " << vpMath::deg(joint_min[jointLimitArt-1]) << " < " << vpMath::deg(art) << " < " << vpMath::deg(joint_max[jointLimitArt-1]) << std::endl;
+      }
+      articularVelocities = 0.0;
+    }
+    else
+      jointLimit = false;
+  }
+  
+  articularCoordinates[0] = articularCoordinates[0] + ellapsedTime*articularVelocities[0];
+  articularCoordinates[1] = articularCoordinates[1] + ellapsedTime*articularVelocities[1];
+  articularCoordinates[2] = articularCoordinates[2] + ellapsedTime*articularVelocities[2];
+  articularCoordinates[3] = articularCoordinates[3] + ellapsedTime*articularVelocities[3];
+  articularCoordinates[4] = articularCoordinates[4] + ellapsedTime*articularVelocities[4];
+  articularCoordinates[5] = articularCoordinates[5] + ellapsedTime*articularVelocities[5];
+  
+  int jl = isInJointLimit();
+  
+  if (jl != 0 && jointLimit == false)
+  {
+    if (jl < 0)
+      ellapsedTime = (joint_min[(unsigned int)(-jl-1)] - articularCoordinates[(unsigned int)(-jl-1)])/(articularVelocities[(unsigned int)(-jl-1)]);
+    else
+      ellapsedTime = (joint_max[(unsigned int)(jl-1)] - articularCoordinates[(unsigned int)(jl-1)])/(articularVelocities[(unsigned int)(jl-1)]);
+    
+    for (unsigned int i = 0; i < 6; i++)
+      articularCoordinates[i] = articularCoordinates[i] + ellapsedTime*articularVelocities[i];
+    
+    jointLimit = true;
+    jointLimitArt = (unsigned int)fabs((double)jl);
+  }
+
+  set_artCoord(articularCoordinates);
+  set_artVel(articularVelocities);
+  
+  compute_fMi();
+
+  if (displayAllowed)
+  {
+    vpDisplay::display(I);
+    vpDisplay::displayFrame(I,getExternalCameraPosition (),cameraParam,0.2,vpColor::none, thickness_);
+    vpDisplay::displayFrame(I,getExternalCameraPosition ()*fMi[7],cameraParam,0.1,vpColor::none, thickness_);
+  }
+  
+  if (displayType == MODEL_3D && displayAllowed)
+  {
+    while (get_displayBusy()) vpTime::wait(2);
+    vpSimulatorViper850::getExternalImage(I);
+    set_displayBusy(false);
+  }
+    
+  
+  if (displayType == MODEL_DH && displayAllowed)
+  {
+    vpHomogeneousMatrix fMit[8];
+    get_fMi(fMit);
+  
+  //vpDisplay::displayFrame(I,getExternalCameraPosition ()*fMi[6],cameraParam,0.2,vpColor::none);
+
+    vpImagePoint iP, iP_1;
+    vpPoint pt(0,0,0);
+  
+    pt.track(getExternalCameraPosition ());
+    vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP_1);
+    pt.track(getExternalCameraPosition ()*fMit[0]);
+    vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP);
+    vpDisplay::displayLine(I, iP_1, iP, vpColor::green, thickness_);
+    for (int k = 1; k < 7; k++)
+    {
+      pt.track(getExternalCameraPosition ()*fMit[k-1]);
+      vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP_1);
+    
+      pt.track(getExternalCameraPosition ()*fMit[k]);
+      vpMeterPixelConversion::convertPoint (cameraParam, pt.get_x(), pt.get_y(), iP);
+    
+      vpDisplay::displayLine(I,iP_1,iP,vpColor::green, thickness_);
+    }
+    vpDisplay::displayCamera(I,getExternalCameraPosition ()*fMit[7],cameraParam,0.1,vpColor::green, thickness_);
+  }
+  
+  vpDisplay::flush(I);
+}
+
 /*!
   Compute the pose between the robot reference frame and the frames used to compute the Denavit-Hartenberg
   representation. The last element of the table corresponds to the pose between the reference frame and
@@ -930,6 +945,9 @@ vpSimulatorViper850::setVelocity (const vpRobot::vpControlFrameType frame, const
   set_velocity (vel * scale_sat);
   setRobotFrame (frame);
   setVelocityCalled = true;
+
+  if (simulatedTimeMode)
+    stepSimulatedTime(true);
 }
 
 
@@ -1118,7 +1136,8 @@ vpSimulatorViper850::getVelocity (const vpRobot::vpControlFrameType frame, vpCol
   \param vel : Measured velocities. Translations are expressed in m/s
   and rotations in rad/s.
 
-  \param timestamp : Unix time in second since January 1st 1970.
+  \param timestamp : Unix time in second since January 1st 1970, or
+  simulated time in second in simulated time mode (see setSimulatedTimeMode()).
 
   \warning In camera frame, reference frame and mixt frame, the representation
   of the rotation is ThetaU. In that cases, \f$velocity = [\dot x, \dot y, \dot
@@ -1129,7 +1148,7 @@ vpSimulatorViper850::getVelocity (const vpRobot::vpControlFrameType frame, vpCol
 void
 vpSimulatorViper850::getVelocity (const vpRobot::vpControlFrameType frame, vpColVector & vel, double &timestamp)
 {
-  timestamp = vpTime::measureTimeSecond();
+  timestamp = getTimestamp();
   getVelocity(frame, vel);
 }
 
@@ -1189,7 +1208,8 @@ vpSimulatorViper850::getVelocity (vpRobot::vpControlFrameType frame)
 
   \param frame : Frame in wich velocities are mesured.
 
-  \param timestamp : Unix time in second since January 1st 1970.
+  \param timestamp : Unix time in second since January 1st 1970, or
+  simulated time in second in simulated time mode (see setSimulatedTimeMode()).
 
   \return Measured velocities. Translations are expressed in m/s
   and rotations in rad/s.
@@ -1199,7 +1219,7 @@ vpSimulatorViper850::getVelocity (vpRobot::vpControlFrameType frame)
 vpColVector
 vpSimulatorViper850::getVelocity (vpRobot::vpControlFrameType frame, double &timestamp)
 {
-  timestamp = vpTime::measureTimeSecond();
+  timestamp = getTimestamp();
   vpColVector vel(6);
   getVelocity (frame, vel);
 
@@ -1352,6 +1372,8 @@ vpSimulatorViper850::setPosition(const vpRobot::vpControlFrameType frame,const v
             set_velocity(error);
             break;
           }
+          if (simulatedTimeMode)
+            stepSimulatedTime(false);
         }
         else
         {
@@ -1382,6 +1404,8 @@ vpSimulatorViper850::setPosition(const vpRobot::vpControlFrameType frame,const v
           set_velocity(error);
           break;
         }
+        if (simulatedTimeMode)
+          stepSimulatedTime(false);
       }while (errsqr > 1e-8);
       break ;
     }
@@ -1422,6 +1446,8 @@ vpSimulatorViper850::setPosition(const vpRobot::vpControlFrameType frame,const v
             set_velocity(error);
             break;
           }
+          if (simulatedTimeMode)
+            stepSimulatedTime(false);
         }
         else
           vpERROR_TRACE ("Positionning error. Position unreachable");
@@ -1710,14 +1736,15 @@ vpSimulatorViper850::getPosition(const vpRobot::vpControlFrameType frame, vpColV
   last 3 values to the rx, ry, rz rotation (like a vpRxyzVector). The code
   below show how to convert this position into a vpHomogeneousMatrix:
 
-  \param timestamp : Unix time in second since January 1st 1970.
+  \param timestamp : Unix time in second since January 1st 1970, or
+  simulated time in second in simulated time mode (see setSimulatedTimeMode()).
 
   \sa getPosition(const vpRobot::vpControlFrameType frame, vpColVector &q)
  */
 void
 vpSimulatorViper850::getPosition(const vpRobot::vpControlFrameType frame, vpColVector &q, double &timestamp)
 {
-  timestamp = vpTime::measureTimeSecond();
+  timestamp = getTimestamp();
   getPosition(frame, q);
 }
 
@@ -1765,7 +1792,7 @@ void
 vpSimulatorViper850::getPosition(const vpRobot::vpControlFrameType frame,
                                  vpPoseVector &position, double &timestamp)
 {
-  timestamp = vpTime::measureTimeSecond();
+  timestamp = getTimestamp();
   getPosition(frame, position);
 }
 
@@ -0,0 +1,220 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the robot simulators in simulated time mode.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceRobotSimulator.cpp
+
+  \brief Run a velocity scenario on the Viper 850 and Afma 6 simulators in
+  simulated time mode (see vpRobotWireFrameSimulator::setSimulatedTimeMode()),
+  measure how much faster than real time it runs and check that two runs lead
+  to exactly the same trajectory.
+*/
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+#include <visp3/robot/vpSimulatorAfma6.h>
+#include <visp3/robot/vpSimulatorViper850.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#if defined(VISP_HAVE_MODULE_GUI) && (defined(_WIN32) || defined(VISP_HAVE_PTHREAD))
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Benchmark the robot simulators in simulated time mode.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Number of velocities sent to each robot.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Move the robot to its initial position, then apply a smooth camera velocity
+// and return the final joint position
+template<class Robot>
+vpColVector scenario(unsigned int nb_iterations, double &wall_time, double &simulated_time)
+{
+  Robot robot(false);
+  robot.setSimulatedTimeMode(true);
+
+  double t = vpTime::measureTimeMs();
+
+  vpColVector q;
+  robot.getPosition(vpRobot::ARTICULAR_FRAME, q);
+  q[3] += vpMath::rad(10); q[4] += vpMath::rad(5); q[5] += vpMath::rad(-10);
+  robot.setRobotState(vpRobot::STATE_POSITION_CONTROL);
+  robot.setPosition(vpRobot::ARTICULAR_FRAME, q);
+
+  robot.setRobotState(vpRobot::STATE_VELOCITY_CONTROL);
+  vpColVector v(6), pose;
+  for (unsigned int k = 0; k < nb_iterations; k++) {
+    robot.getPosition(vpRobot::REFERENCE_FRAME, pose, simulated_time);
+    double s = 0.01 * k;
+    v[0] = 0.05 * sin(s); v[1] = 0.05 * cos(1.3 * s); v[2] = 0.02 * sin(0.7 * s);
+    v[3] = 0.1 * cos(s); v[4] = 0.1 * sin(0.9 * s); v[5] = 0.2 * sin(1.1 * s);
+    robot.setVelocity(vpRobot::CAMERA_FRAME, v);
+  }
+  robot.getPosition(vpRobot::ARTICULAR_FRAME, q, simulated_time);
+  robot.setRobotState(vpRobot::STATE_STOP);
+
+  wall_time = vpTime::measureTimeMs() - t;
+  return q;
+}
+
+// Run the scenario twice and check that both runs give the same joint position
+template<class Robot>
+bool benchmark(const std::string &name, unsigned int nb_iterations)
+{
+  double wall_time[2], simulated_time[2];
+  vpColVector q1 = scenario<Robot>(nb_iterations, wall_time[0], simulated_time[0]);
+  vpColVector q2 = scenario<Robot>(nb_iterations, wall_time[1], simulated_time[1]);
+
+  double wall = 0.5 * (wall_time[0] + wall_time[1]);
+  std::cout << name << ": " << simulated_time[0] << " s simulated in " << wall << " ms, "
+            << (wall > 0. ? 1000. * simulated_time[0] / wall : 0.) << " times faster than real time" << std::endl;
+
+  for (unsigned int i = 0; i < 6; i++) {
+    if (q1[i] != q2[i] || simulated_time[0] != simulated_time[1]) {
+      std::cerr << "Two runs of the " << name << " simulator lead to different trajectories" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 1000;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    if (! benchmark<vpSimulatorViper850>("Viper 850", nb_iterations))
+      return EXIT_FAILURE;
+    if (! benchmark<vpSimulatorAfma6>("Afma 6", nb_iterations))
+      return EXIT_FAILURE;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+int main()
+{
+  std::cout << "You do not have the gui module or the threading capabilities required by the robot simulators..." << std::endl;
+  return 0;
+}
+#endif
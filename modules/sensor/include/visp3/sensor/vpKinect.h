@@ -53,6 +53,7 @@
 #include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/core/vpMeterPixelConversion.h>
+#include <visp3/core/vpPointCloud.h>
 
 /*!
 
@@ -132,6 +133,7 @@ public:
 
   bool getDepthMap(vpImage<float>& map);
   bool getDepthMap(vpImage<float>& map, vpImage<unsigned char>& Imap);
+  bool getPointCloud(vpPointCloud &pointcloud);
   bool getRGB(vpImage<vpRGBa>& IRGB);
 
 
@@ -175,6 +177,8 @@ public:
   bool m_new_rgb_frame;
   bool m_new_depth_map;
   bool m_new_depth_image;
+  bool m_new_point_cloud;
+  vpImage<float> m_pc_dmap;//depth map at the resolution of the IR camera used to build the point cloud
   unsigned int height;//height of the rgb image
   unsigned int width;//width of the rgb image
 
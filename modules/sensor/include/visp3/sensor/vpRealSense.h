@@ -46,6 +46,7 @@
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpPointCloud.h>
 
 #if defined(VISP_HAVE_REALSENSE) && defined(VISP_HAVE_CPP11_COMPATIBILITY)
 
@@ -128,6 +129,18 @@ int main()
   vpImage<vpRGBa> I(rs.getIntrinsics(rs::stream::color).height, rs.getIntrinsics(rs::stream::color).width);
   \endcode
 
+  The point cloud can be retrieved in a vpPointCloud that stores the coordinates in contiguous
+  arrays and is organized like the depth image. Its memory is allocated once and reused at each
+  acquisition, contrary to the std::vector<vpColVector> variants that are kept for compatibility:
+  \code
+  vpPointCloud pointcloud;
+  while (1) {
+    rs.acquire(I, pointcloud);
+    const float *Z = pointcloud.getZ();
+    // Z[i*pointcloud.getWidth() + j] is the depth of pixel (i,j), or 0 if not valid
+  }
+  \endcode
+
   If you are interested in the point cloud and if ViSP is build with PCL support, you can start from the
   following example where we use PCL library to visualize the point cloud:
   \code
@@ -178,6 +191,7 @@ public:
   virtual ~vpRealSense();
 
   void acquire(std::vector<vpColVector> &pointcloud);
+  void acquire(vpPointCloud &pointcloud);
 #ifdef VISP_HAVE_PCL
 	void acquire(pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud);
   void acquire(pcl::PointCloud<pcl::PointXYZRGB>::Ptr &pointcloud);
@@ -185,6 +199,8 @@ public:
   void acquire(vpImage<unsigned char> &grey); // tested
   void acquire(vpImage<unsigned char> &grey, std::vector<vpColVector> &pointcloud);
   void acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, std::vector<vpColVector> &pointcloud);
+  void acquire(vpImage<unsigned char> &grey, vpPointCloud &pointcloud);
+  void acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, vpPointCloud &pointcloud);
 #ifdef VISP_HAVE_PCL
   void acquire(vpImage<unsigned char> &grey, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud);
   void acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud);
@@ -194,6 +210,8 @@ public:
   void acquire(vpImage<vpRGBa> &color);  // tested
   void acquire(vpImage<vpRGBa> &color, std::vector<vpColVector> &pointcloud);
   void acquire(vpImage<vpRGBa> &color, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, std::vector<vpColVector> &pointcloud);
+  void acquire(vpImage<vpRGBa> &color, vpPointCloud &pointcloud);
+  void acquire(vpImage<vpRGBa> &color, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, vpPointCloud &pointcloud);
 
 #ifdef VISP_HAVE_PCL
   void acquire(vpImage<vpRGBa> &color, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud);
@@ -238,6 +256,9 @@ protected:
   float m_max_Z; //!< Maximal Z depth in meter
   bool m_enable_color;
   bool m_enable_depth;
+  std::vector<float> m_depth_xmap; //!< Normalized x coordinates of the depth pixels
+  std::vector<float> m_depth_ymap; //!< Normalized y coordinates of the depth pixels
+  vpPointCloud m_pointcloud; //!< Buffer of the acquisitions as vectors of vpColVector
 };
 
 #endif
@@ -42,6 +42,7 @@
 #if defined(VISP_HAVE_LIBFREENECT_AND_DEPENDENCIES)
 
 #include <limits>   // numeric_limits
+#include <string.h> // memcpy
 
 #include <visp3/sensor/vpKinect.h>
 #include <visp3/core/vpXmlParserCamera.h>
@@ -58,6 +59,7 @@ vpKinect::vpKinect(freenect_context *ctx, int index)
     m_new_rgb_frame(false),
     m_new_depth_map(false),
     m_new_depth_image(false),
+    m_new_point_cloud(false), m_pc_dmap(),
     height(480), width(640)
 {
   dmap.resize(height, width);
@@ -169,6 +171,7 @@ void vpKinect::DepthCallback(void* depth, uint32_t /* timestamp */)
   }
   m_new_depth_map = true;
   m_new_depth_image = true;
+  m_new_point_cloud = true;
 }
 
 
@@ -235,6 +238,38 @@ bool vpKinect::getDepthMap(vpImage<float>& map,vpImage<unsigned char>& Imap)
 }
 
 
+/*!
+  Get the point cloud corresponding to the last depth map, expressed in the IR
+  camera frame. The cloud is organized like the depth map at the resolution
+  chosen in start(). Pixels where the depth cannot be computed lead to points
+  with null coordinates.
+
+  \param pointcloud : Point cloud. Its memory is reused from one call to the other.
+  \return false if no new depth map was received since the last call.
+*/
+bool vpKinect::getPointCloud(vpPointCloud &pointcloud)
+{
+  {
+    vpMutex::vpScopedLock lock(m_depth_mutex);
+    if (!m_new_point_cloud)
+      return false;
+    if (DMres == DMAP_LOW_RES) {
+      m_pc_dmap.resize(hd, wd);
+      for (unsigned int i = 0; i < hd; i++)
+        for (unsigned int j = 0; j < wd; j++)
+          m_pc_dmap[i][j] = dmap[i<<1][j<<1];
+    }
+    else {
+      m_pc_dmap.resize(height, width);
+      memcpy(m_pc_dmap.bitmap, dmap.bitmap, height*width*sizeof(float));
+    }
+    m_new_point_cloud = false;
+  }
+
+  pointcloud.deproject(m_pc_dmap, IRcam);
+  return true;
+}
+
 /*!
   Get RGB image
 */
@@ -49,7 +49,8 @@
  * Default constructor.
  */
 vpRealSense::vpRealSense()
-  : m_context(), m_device(NULL), m_num_devices(0), m_serial_no(), m_intrinsics(), m_max_Z(8), m_enable_color(true), m_enable_depth(true)
+  : m_context(), m_device(NULL), m_num_devices(0), m_serial_no(), m_intrinsics(), m_max_Z(8), m_enable_color(true), m_enable_depth(true),
+    m_depth_xmap(), m_depth_ymap(), m_pointcloud()
 {
 
 }
@@ -118,6 +119,9 @@ void vpRealSense::open()
     m_intrinsics.push_back(intrin);
   }
 
+  // Deprojection maps used to build the point clouds
+  vp_rs_get_deprojection_maps_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap);
+
   // Start device
   m_device->start();
 }
@@ -281,7 +285,7 @@ void vpRealSense::acquire(vpImage<unsigned char> &grey, std::vector<vpColVector>
   vp_rs_get_grey_impl(m_device, m_intrinsics, grey);
 
   // Retrieve point cloud
-  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud);
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, m_pointcloud, pointcloud);
 }
 
 /*!
@@ -300,7 +304,7 @@ void vpRealSense::acquire(std::vector<vpColVector> &pointcloud)
   m_device->wait_for_frames();
 
   // Retrieve point cloud
-  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud);
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, m_pointcloud, pointcloud);
 }
 
 /*!
@@ -350,7 +354,7 @@ void vpRealSense::acquire(vpImage<vpRGBa> &color, vpImage<uint16_t> &infrared, v
   vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::depth, depth);
 
   // Retrieve point cloud
-  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud);
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, m_pointcloud, pointcloud);
 }
 
 /*!
@@ -381,7 +385,7 @@ void vpRealSense::acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infra
   vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::depth, depth);
 
   // Retrieve point cloud
-  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud);
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, m_pointcloud, pointcloud);
 }
 
 /*!
@@ -404,7 +408,134 @@ void vpRealSense::acquire(vpImage<vpRGBa> &color, std::vector<vpColVector> &poin
   vp_rs_get_color_impl(m_device, m_intrinsics, color);
 
   // Retrieve point cloud
-  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud);
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, m_pointcloud, pointcloud);
+}
+
+/*!
+  Acquire data from RealSense device.
+  \param pointcloud : Point cloud organized like the depth image. Its memory is reused from one call to the other.
+ */
+void vpRealSense::acquire(vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, pointcloud);
+}
+
+/*!
+  Acquire data from RealSense device.
+  \param grey : Grey level image.
+  \param pointcloud : Point cloud organized like the depth image. Its memory is reused from one call to the other.
+ */
+void vpRealSense::acquire(vpImage<unsigned char> &grey, vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve grey image
+  vp_rs_get_grey_impl(m_device, m_intrinsics, grey);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, pointcloud);
+}
+
+/*!
+  Acquire data from RealSense device.
+  \param color : Color image.
+  \param pointcloud : Point cloud organized like the depth image. Its memory is reused from one call to the other.
+ */
+void vpRealSense::acquire(vpImage<vpRGBa> &color, vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve color image
+  vp_rs_get_color_impl(m_device, m_intrinsics, color);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, pointcloud);
+}
+
+/*!
+  Acquire data from RealSense device.
+  \param grey : Grey level image.
+  \param infrared : Infrared image.
+  \param depth : Depth image.
+  \param pointcloud : Point cloud organized like the depth image. Its memory is reused from one call to the other.
+ */
+void vpRealSense::acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve grey image
+  vp_rs_get_grey_impl(m_device, m_intrinsics, grey);
+
+  // Retrieve infrared image
+  vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::infrared, infrared);
+
+  // Retrieve depth image
+  vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::depth, depth);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, pointcloud);
+}
+
+/*!
+  Acquire data from RealSense device.
+  \param color : Color image.
+  \param infrared : Infrared image.
+  \param depth : Depth image.
+  \param pointcloud : Point cloud organized like the depth image. Its memory is reused from one call to the other.
+ */
+void vpRealSense::acquire(vpImage<vpRGBa> &color, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve color image
+  vp_rs_get_color_impl(m_device, m_intrinsics, color);
+
+  // Retrieve infrared image
+  vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::infrared, infrared);
+
+  // Retrieve depth image
+  vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::depth, depth);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_depth_xmap, m_depth_ymap, m_max_Z, pointcloud);
 }
 
 #ifdef VISP_HAVE_PCL
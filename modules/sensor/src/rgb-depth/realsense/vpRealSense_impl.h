@@ -38,6 +38,7 @@
 #include <librealsense/rs.hpp>
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpPointCloud.h>
 
 template <class Type>
 void vp_rs_get_frame_data_impl(const rs::device *m_device, const std::vector <rs::intrinsics> &m_intrinsics, const rs::stream &stream, vpImage<Type> &data)
@@ -91,43 +92,59 @@ void vp_rs_get_grey_impl(const rs::device *m_device, const std::vector <rs::intr
   }
 }
 
-// Retrieve point cloud
-void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::vector <rs::intrinsics> &m_intrinsics, float max_Z, std::vector<vpColVector> &pointcloud)
+// Compute the normalized coordinates of the depth pixels. Since the deprojection
+// of the depth stream is linear in the depth, the points are then obtained by a
+// multiplication of these maps with the depth
+void vp_rs_get_deprojection_maps_impl(const rs::device *m_device, const std::vector <rs::intrinsics> &m_intrinsics, std::vector<float> &xmap, std::vector<float> &ymap)
 {
   if (m_device->is_stream_enabled(rs::stream::depth)) {
-    const float depth_scale = m_device->get_depth_scale();
-
-    vpColVector p3d(4); // X,Y,Z coordinates
-    rs::float3 depth_point;
-    uint16_t * depth = (uint16_t *)m_device->get_frame_data(rs::stream::depth);
     int width = m_intrinsics[RS_STREAM_DEPTH].width;
     int height = m_intrinsics[RS_STREAM_DEPTH].height;
-    pointcloud.resize(width*height);
+    xmap.resize(width*height);
+    ymap.resize(width*height);
 
     for (int i = 0; i < height; i++) {
       for (int j = 0; j < width; j++) {
-        float scaled_depth = depth[i*width + j] * depth_scale;
-
         rs::float2 depth_pixel = { (float) j, (float) i};
-        depth_point = m_intrinsics[RS_STREAM_DEPTH].deproject(depth_pixel, scaled_depth);
-
-        if (depth_point.z <= 0 || depth_point.z > max_Z) {
-          depth_point.x = depth_point.y = depth_point.z = 0;
-        }
-        p3d[0] = depth_point.x;
-        p3d[1] = depth_point.y;
-        p3d[2] = depth_point.z;
-        p3d[3] = 1;
-
-        pointcloud[i*width + j] = p3d;
+        rs::float3 depth_point = m_intrinsics[RS_STREAM_DEPTH].deproject(depth_pixel, 1.f);
+        xmap[i*width + j] = depth_point.x;
+        ymap[i*width + j] = depth_point.y;
       }
     }
   }
+  else {
+    xmap.clear();
+    ymap.clear();
+  }
+}
+
+// Retrieve point cloud
+void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::vector <rs::intrinsics> &m_intrinsics,
+                               const std::vector<float> &xmap, const std::vector<float> &ymap, float max_Z, vpPointCloud &pointcloud)
+{
+  if (m_device->is_stream_enabled(rs::stream::depth)) {
+    const float depth_scale = m_device->get_depth_scale();
+    unsigned int width = (unsigned int)m_intrinsics[RS_STREAM_DEPTH].width;
+    unsigned int height = (unsigned int)m_intrinsics[RS_STREAM_DEPTH].height;
+    if (xmap.size() != width*height)
+      throw vpException(vpException::fatalError, "RealSense Camera - depth stream changed since open()!");
+
+    pointcloud.deproject((const uint16_t *)m_device->get_frame_data(rs::stream::depth), &xmap[0], &ymap[0], height, width, depth_scale, max_Z);
+  }
   else {
     pointcloud.clear();
   }
 }
 
+// Retrieve point cloud as a vector of column vectors
+void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::vector <rs::intrinsics> &m_intrinsics,
+                               const std::vector<float> &xmap, const std::vector<float> &ymap, float max_Z,
+                               vpPointCloud &buffer, std::vector<vpColVector> &pointcloud)
+{
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, xmap, ymap, max_Z, buffer);
+  buffer.convert(pointcloud);
+}
+
 #ifdef VISP_HAVE_PCL
 // Retrieve point cloud
 void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::vector <rs::intrinsics> &m_intrinsics, float max_Z, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud)
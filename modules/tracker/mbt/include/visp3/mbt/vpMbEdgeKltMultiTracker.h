@@ -128,6 +128,8 @@ public:
 
   virtual std::vector<std::string> getCameraNames() const;
 
+  virtual void getCameraTrackingTimes(std::map<std::string, double> &mapOfTimes) const;
+
   virtual void getCameraParameters(vpCameraParameters &camera) const;
   virtual void getCameraParameters(vpCameraParameters &cam1, vpCameraParameters &cam2) const;
   virtual void getCameraParameters(const std::string &cameraName, vpCameraParameters &camera) const;
@@ -179,6 +181,8 @@ public:
   virtual void getPose(const std::string &cameraName, vpHomogeneousMatrix &cMo_) const;
   virtual void getPose(std::map<std::string, vpHomogeneousMatrix> &mapOfCameraPoses) const;
 
+  virtual double getScanLineRenderingTime() const;
+
   virtual void init(const vpImage<unsigned char>& I);
 
 #ifdef VISP_HAVE_MODULE_GUI
@@ -237,6 +241,10 @@ public:
 
   virtual void resetTracker();
 
+  virtual void saveCompiledModel(const std::string &compiledModelFile) const;
+
+  virtual void resetScanLineRenderingTime();
+
   virtual void setAngleAppear(const double &a);
   virtual void setAngleDisappear(const double &a);
 
@@ -259,6 +267,8 @@ public:
 
   virtual void setCovarianceComputation(const bool& flag);
 
+  virtual void setDepthBufferVisibilityTest(const bool &v);
+
   virtual void setDisplayFeatures(const bool displayF);
 
   virtual void setFarClippingDistance(const double &dist);
@@ -338,10 +348,16 @@ public:
 
   virtual void setReferenceCameraName(const std::string &referenceCameraName);
 
+  virtual void setScanLineParallelRendering(const bool &v);
+
+  virtual void setScanLineReuseThreshold(const double &threshold);
+
   virtual void setScanLineVisibilityTest(const bool &v);
 
   virtual void setThresholdAcceptation(const double th);
 
+  virtual void setUseParallelCameraTracking(const bool use);
+
   virtual void testTracking();
 
   virtual void track(const vpImage<unsigned char> &I);
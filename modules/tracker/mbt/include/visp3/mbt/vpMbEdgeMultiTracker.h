@@ -74,11 +74,17 @@ protected:
   std::map<std::string, vpMbEdgeTracker*> m_mapOfEdgeTrackers;
 
   //! Map of pyramidal images for each camera
-  std::map<std::string, std::vector<const vpImage<unsigned char>* > > m_mapOfPyramidalImages;
+  std::map<std::string, vpMbtImagePyramid> m_mapOfPyramidalImages;
 
   //! Name of the reference camera
   std::string m_referenceCameraName;
 
+  //! If true, the per-camera stages of track() are run concurrently
+  bool m_useParallelCameraTracking;
+
+  //! Map of the time in ms spent by each camera in the per-camera stages of the last call to track()
+  std::map<std::string, double> m_mapOfCameraTrackingTimes;
+
 
 public:
   // Default constructor <==> equivalent to vpMbEdgeTracker
@@ -118,6 +124,8 @@ public:
 
   virtual std::vector<std::string> getCameraNames() const;
 
+  virtual void getCameraTrackingTimes(std::map<std::string, double> &mapOfTimes) const;
+
   virtual void getCameraParameters(vpCameraParameters &camera) const;
   virtual void getCameraParameters(vpCameraParameters &cam1, vpCameraParameters &cam2) const;
   virtual void getCameraParameters(const std::string &cameraName, vpCameraParameters &camera) const;
@@ -169,6 +177,8 @@ public:
   virtual void getPose(const std::string &cameraName, vpHomogeneousMatrix &cMo_) const;
   virtual void getPose(std::map<std::string, vpHomogeneousMatrix> &mapOfCameraPoses) const;
 
+  virtual double getScanLineRenderingTime() const;
+
   void init(const vpImage<unsigned char>& I);
 
 #ifdef VISP_HAVE_MODULE_GUI
@@ -219,6 +229,10 @@ public:
 
   virtual void resetTracker();
 
+  virtual void saveCompiledModel(const std::string &compiledModelFile) const;
+
+  virtual void resetScanLineRenderingTime();
+
   virtual void setAngleAppear(const double &a);
   virtual void setAngleDisappear(const double &a);
 
@@ -241,6 +255,8 @@ public:
 
   virtual void setCovarianceComputation(const bool& flag);
 
+  virtual void setDepthBufferVisibilityTest(const bool &v);
+
   virtual void setDisplayFeatures(const bool displayF);
 
   virtual void setFarClippingDistance(const double &dist);
@@ -315,14 +331,24 @@ public:
 
   virtual void setProjectionErrorComputation(const bool &flag);
 
+  virtual void setPyramidFilter(const vpMbtImagePyramid::vpPyramidFilterType filter);
+
   virtual void setReferenceCameraName(const std::string &referenceCameraName);
 
   virtual void setScales(const std::vector<bool>& scales);
 
+  virtual void setScanLineParallelRendering(const bool &v);
+
+  virtual void setScanLineReuseThreshold(const double &threshold);
+
   virtual void setScanLineVisibilityTest(const bool &v);
 
   virtual void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
 
+  virtual void setUseParallelCameraTracking(const bool use);
+
+  virtual void setUseParallelMovingEdge(const bool use);
+
   virtual void track(const vpImage<unsigned char> &I);
   virtual void track(const vpImage<unsigned char> &I1, const vpImage<unsigned char> &I2);
   virtual void track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages);
@@ -333,9 +359,48 @@ protected:
     LINE, CYLINDER, CIRCLE
   } FeatureType;
 
+  //! Per-camera stages of track() that can be run concurrently.
+  typedef enum CameraStage {
+    TRACK_MOVING_EDGE,  //!< Moving-edge tracking.
+    VVS_FIRST_PHASE,    //!< Interaction matrix and error of the first phase of the VVS.
+    VVS_SECOND_PHASE,   //!< Interaction matrix and errors of the second phase of the VVS.
+    UPDATE_MOVING_EDGE  //!< Visibility, update and reinitialisation of the moving edges.
+  } CameraStage;
+
+  //! Input and output of a per-camera stage of track().
+  struct vpCameraStageData {
+    vpCameraStageData() : name(), tracker(NULL), image(NULL), nbRows(0), nbLines(0), nbCylinders(0), nbCircles(0),
+      L(), error(), errorLines(), errorCylinders(), errorCircles(), factor(NULL), count(0.), time(0.) {}
+
+    std::string name;
+    vpMbEdgeTracker *tracker;
+    const vpImage<unsigned char> *image;
+    unsigned int nbRows;
+    unsigned int nbLines;
+    unsigned int nbCylinders;
+    unsigned int nbCircles;
+    vpMatrix L;
+    vpColVector error;
+    vpColVector errorLines;
+    vpColVector errorCylinders;
+    vpColVector errorCircles;
+    vpColVector *factor;
+    double count;
+    double time;
+  };
+
+  //! Data of each camera for the current stage
+  std::vector<vpCameraStageData> m_cameraStages;
+  //! Current stage
+  CameraStage m_cameraStage;
+  //! Pyramid level of the current stage
+  unsigned int m_cameraStageLevel;
+  //! VVS iteration of the current stage
+  unsigned int m_cameraStageIteration;
+
   /** @name Protected Member Functions Inherited from vpMbEdgeMultiTracker */
   //@{
-  virtual void cleanPyramid(std::map<std::string, std::vector<const vpImage<unsigned char>* > >& pyramid);
+  virtual void cleanPyramid(std::map<std::string, vpMbtImagePyramid>& pyramid);
 
   virtual void computeProjectionError();
 
@@ -352,9 +417,18 @@ protected:
       std::map<std::string, vpRobust> &mapOfRobustLines, std::map<std::string, vpRobust> &mapOfRobustCylinders,
       std::map<std::string, vpRobust> &mapOfRobustCircles, double threshold);
 
+  virtual void initCameraStages(const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages);
+
   virtual void initPyramid(const std::map<std::string, const vpImage<unsigned char> * >& mapOfImages,
-      std::map<std::string, std::vector<const vpImage<unsigned char>* > >& pyramid);
+      std::map<std::string, vpMbtImagePyramid>& pyramid);
+
+  void runCameraStage(const unsigned int index);
+
+  virtual void runCameraStages(const CameraStage stage, const unsigned int lvl, const unsigned int iter=0);
   //@}
+
+private:
+  friend class vpMbEdgeMultiTrackerCameraTask;
 };
 
 #endif
@@ -52,6 +52,7 @@
 #include <visp3/mbt/vpMbtDistanceLine.h>
 #include <visp3/mbt/vpMbtDistanceCircle.h>
 #include <visp3/mbt/vpMbtDistanceCylinder.h>
+#include <visp3/mbt/vpMbtImagePyramid.h>
 #include <visp3/core/vpXmlParser.h>
 #include <visp3/core/vpRobust.h>
 
@@ -59,6 +60,7 @@
 #include <fstream>
 #include <vector>
 #include <list>
+#include <map>
 
 #if defined(VISP_HAVE_COIN3D)
 //Inventor includes
@@ -302,8 +304,14 @@ class VISP_EXPORT vpMbEdgeTracker: virtual public vpMbTracker
     //! Vector of scale level to use for the multi-scale tracking.
     std::vector<bool> scales;
     
-    //! Pyramid of image associated to the current image. This pyramid is computed in the init() and in the track() methods.
-    std::vector< const vpImage<unsigned char>* > Ipyramid;
+    //! Pyramid of image associated to the current image. This pyramid is computed in the init() and in the track() methods. Its images are kept from one frame to the next.
+    vpMbtImagePyramid Ipyramid;
+
+    //! Filter used to compute the levels of the pyramid.
+    vpMbtImagePyramid::vpPyramidFilterType pyramidFilter;
+
+    //! If true, the moving edges of the visible lines, cylinders and circles are tracked in parallel.
+    bool useParallelMovingEdge;
     
     //! Current scale level used. This attribute must not be modified outside of the downScale() and upScale() methods, as it used to specify to some methods which set of distanceLine use. 
     unsigned int scaleLevel;
@@ -311,6 +319,13 @@ class VISP_EXPORT vpMbEdgeTracker: virtual public vpMbTracker
     //! Number of features used in the computation of the projection error
     unsigned int nbFeaturesForProjErrorComputation;
 
+    //! Cell of the grid used to index the extremities of the lines.
+    typedef std::pair<double, std::pair<double, double> > vpLineCell;
+    //! Lines of each scale indexed by the cells of their extremities, used by addLine() to find the lines already in the model.
+    std::vector< std::map<vpLineCell, std::vector<vpMbtDistanceLine*> > > lineIndex;
+    //! Flag to know if lineIndex is up to date with the lines of each scale.
+    std::vector<bool> lineIndexUpToDate;
+
 public:
   
   vpMbEdgeTracker(); 
@@ -356,6 +371,13 @@ public:
     \return The scales levels used for the tracking. 
   */
   std::vector<bool> getScales() const {return scales;}
+
+  /*!
+    \return True if the moving edges of the different features are tracked in parallel.
+
+    \sa setUseParallelMovingEdge()
+  */
+  inline bool getUseParallelMovingEdge() const { return useParallelMovingEdge; }
   /*!
      \return The threshold value between 0 and 1 over good moving edges ratio. It allows to
      decide if the tracker has enough valid moving edges to compute a pose. 1 means that all
@@ -366,6 +388,13 @@ public:
    */
   inline double getGoodMovingEdgesRatioThreshold() const { return percentageGdPt;}
 
+  /*!
+    \return The filter used to compute the levels of the pyramid used for the multi-scale tracking.
+
+    \sa setPyramidFilter()
+  */
+  inline vpMbtImagePyramid::vpPyramidFilterType getPyramidFilter() const { return pyramidFilter;}
+
   void loadConfigFile(const std::string &configFile);
   void loadConfigFile(const char* configFile);
   virtual void reInitModel(const vpImage<unsigned char>& I, const std::string &cad_name, const vpHomogeneousMatrix& cMo_,
@@ -460,11 +489,40 @@ public:
   void setMovingEdge(const vpMe &me);
 
   virtual void setPose(const vpImage<unsigned char> &I, const vpHomogeneousMatrix& cdMo);
+
+  /*!
+    Set the filter used to compute the levels of the pyramid when several scales
+    are used (see setScales()). vpMbtImagePyramid::NEAREST_FILTER, the default,
+    subsamples the image while vpMbtImagePyramid::GAUSSIAN_FILTER smoothes it
+    before each 2x decimation.
+
+    \param filter : Filter used to compute the pyramid.
+
+    \sa getPyramidFilter()
+  */
+  inline void setPyramidFilter(const vpMbtImagePyramid::vpPyramidFilterType filter) {pyramidFilter = filter;}
   
   void setScales(const std::vector<bool>& _scales);
 
   void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
 
+  /*!
+    Enable or disable the parallel tracking of the moving edges.
+
+    When enabled, the visible lines, cylinders and circles of the CAD model
+    are distributed over the threads of vpThreadPool (see
+    vpThreadPool::setNumThreads()). Each feature only reads the image and
+    updates its own moving edges, so that the pose estimation gets exactly
+    the same input as with the sequential tracking. This is interesting for
+    models with many visible edges.
+
+    \param use : True to track the features in parallel. By default the
+    moving edges are tracked sequentially.
+
+    \sa getUseParallelMovingEdge()
+  */
+  inline void setUseParallelMovingEdge(const bool use) { useParallelMovingEdge = use; }
+
   void track(const vpImage<unsigned char> &I);
   //@}
 
@@ -475,9 +533,12 @@ protected:
   void addCircle(const vpPoint &P1, const vpPoint &P2, const vpPoint &P3, const double r, int idFace = -1, const std::string& name = "");
   void addCylinder(const vpPoint &P1, const vpPoint &P2, const double r, int idFace = -1, const std::string& name = "");
   void addLine(vpPoint &p1, vpPoint &p2, int polygon = -1, std::string name = "");
+  void indexLine(const unsigned int scale, vpMbtDistanceLine *l);
+  void invalidateLineIndex(const unsigned int scale);
+  void updateLineIndex(const unsigned int scale);
   void addPolygon(vpMbtPolygon &p) ;
 
-  void cleanPyramid(std::vector<const vpImage<unsigned char>* >& _pyramid);
+  void cleanPyramid(vpMbtImagePyramid& _pyramid);
   void computeProjectionError(const vpImage<unsigned char>& _I);
 
   void computeVVS(const vpImage<unsigned char>& _I, const unsigned int lvl);
@@ -513,7 +574,7 @@ protected:
   virtual void initFaceFromLines(vpMbtPolygon &polygon);
   unsigned int initMbtTracking(unsigned int &nberrors_lines, unsigned int &nberrors_cylinders, unsigned int &nberrors_circles);
   void initMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo) ;
-  void initPyramid(const vpImage<unsigned char>& _I, std::vector<const vpImage<unsigned char>* >& _pyramid);
+  void initPyramid(const vpImage<unsigned char>& _I, vpMbtImagePyramid& _pyramid);
   void reInitLevel(const unsigned int _lvl);
   void reinitMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo);
   void removeCircle(const std::string& name);
@@ -46,6 +46,8 @@
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 #include <visp3/mbt/vpMbScanLine.h>
+#include <visp3/mbt/vpMbtBoundingVolumeHierarchy.h>
+#include <visp3/mbt/vpMbtDepthBuffer.h>
 
 #ifdef VISP_HAVE_OGRE
   #include <visp3/ar/vpAROgre.h>
@@ -61,6 +63,12 @@
 
   \ingroup group_mbt_faces
 
+  Besides the test on the orientation of the faces, the visibility can be
+  refined on the CPU with setDepthBufferVisibilityTest(). The faces whose
+  bounding box is outside the field of view are then found with a
+  vpMbtBoundingVolumeHierarchy, and the faces hidden by other faces with a
+  low resolution vpMbtDepthBuffer. This test is only done when the image
+  and the camera parameters are given to setVisible().
  */
 template<class PolygonType = vpMbtPolygon>
 class vpMbHiddenFaces
@@ -71,6 +79,18 @@ class vpMbHiddenFaces
   //! Number of visible polygon
   unsigned int nbVisiblePolygon;
   vpMbScanLine scanlineRender;
+  //! Hierarchy of the bounding boxes of the polygons used for the frustum culling
+  vpMbtBoundingVolumeHierarchy boundingVolumes;
+  //! Low resolution depth buffer used for the occlusion culling
+  vpMbtDepthBuffer depthBuffer;
+  //! Use the depth buffer for the visibility test
+  bool useDepthBuffer;
+  //! True while the depth buffer corresponds to the pose of setVisible()
+  bool depthBufferRendered;
+  //! Flag to know if a polygon intersects the field of view
+  std::vector<bool> polygonsInFrustum;
+  //! Indexes of the polygons that intersect the field of view
+  std::vector<unsigned int> frustumIndexes;
   
 #ifdef VISP_HAVE_OGRE
   vpImage<unsigned char> ogreBackground;
@@ -82,6 +102,9 @@ class vpMbHiddenFaces
   bool ogreShowConfigDialog;
 #endif
   
+  void          renderDepthBuffer(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                                    const unsigned int width, const unsigned int height);
+
   unsigned int  setVisiblePrivate(const vpHomogeneousMatrix &cMo, const double &angleAppears, const double &angleDisappears,
                            bool &changed, 
                            bool useOgre = false, bool not_used = false,
@@ -110,6 +133,15 @@ class vpMbHiddenFaces
                               std::vector<std::pair<vpPoint, vpPoint> > &lines, const bool &displayResults = false);
 
     vpMbScanLine& getMbScanLineRenderer() { return scanlineRender; }
+    const vpMbScanLine& getMbScanLineRenderer() const { return scanlineRender; }
+
+    /*!
+      Get the depth buffer used by the visibility test, to modify its
+      settings or to read the depth of the last pose.
+
+      \sa setDepthBufferVisibilityTest()
+    */
+    vpMbtDepthBuffer& getDepthBuffer() { return depthBuffer; }
 
 #ifdef VISP_HAVE_OGRE
     void          displayOgre(const vpHomogeneousMatrix &cMo);
@@ -182,6 +214,8 @@ class vpMbHiddenFaces
   */
     bool          isVisible(const unsigned int i){ return Lpol[i]->isVisible(); }
     
+    bool          isVisibleDepthBuffer(const unsigned int &index);
+
 #ifdef VISP_HAVE_OGRE
     bool          isVisibleOgre(const vpTranslationVector &cameraPos, const unsigned int &index);
 #endif
@@ -192,6 +226,15 @@ class vpMbHiddenFaces
     inline const PolygonType*  operator[](const unsigned int i) const { return Lpol[i];}
 
     void          reset();
+
+    /*!
+      Enable or disable the visibility test based on a bounding volume
+      hierarchy and a low resolution depth buffer. It is only used when Ogre
+      is not.
+
+      \param v : True to use it, false otherwise.
+    */
+    void          setDepthBufferVisibilityTest(const bool &v) { useDepthBuffer = v; }
     
 #ifdef VISP_HAVE_OGRE
     /*!
@@ -259,7 +302,8 @@ class vpMbHiddenFaces
 */
 template<class PolygonType>
 vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces()
-  : Lpol(), nbVisiblePolygon(0), scanlineRender()
+  : Lpol(), nbVisiblePolygon(0), scanlineRender(), boundingVolumes(), depthBuffer(),
+    useDepthBuffer(false), depthBufferRendered(false), polygonsInFrustum(), frustumIndexes()
 {
 #ifdef VISP_HAVE_OGRE
   ogreInitialised = false;
@@ -325,6 +369,7 @@ vpMbHiddenFaces<PolygonType>::addPolygon(PolygonType *p)
   for(unsigned int i = 0; i < p->nbpt; i++)
     p_new->p[i]= p->p[i];
   Lpol.push_back(p_new);
+  boundingVolumes.addVolume(p_new->p, p_new->nbpt);
 }
 
 /*!
@@ -342,6 +387,7 @@ vpMbHiddenFaces<PolygonType>::reset()
     Lpol[i] = NULL ;
   }
   Lpol.resize(0);
+  boundingVolumes.reset();
 
 #ifdef VISP_HAVE_OGRE
   if(ogre != NULL){
@@ -474,15 +520,70 @@ vpMbHiddenFaces<PolygonType>::setVisiblePrivate(const vpHomogeneousMatrix &cMo,
     vpTRACE("ViSP doesn't have Ogre3D, simple visibility test used");
 #endif
   }
+  else if(useDepthBuffer && I.getWidth() != 0 && I.getHeight() != 0){
+    renderDepthBuffer(cMo, cam, I.getWidth(), I.getHeight());
+  }
   
   for (unsigned int i = 0; i < Lpol.size(); i++){
     //std::cout << "Calling poly: " << i << std::endl;
     if (computeVisibility(cMo, angleAppears, angleDisappears, changed, useOgre, not_used, I, cam, cameraPos, i))
       nbVisiblePolygon ++;
   }
+  depthBufferRendered = false;
   return nbVisiblePolygon;
 }
 
+/*!
+  Find the polygons that intersect the field of view with the bounding volume
+  hierarchy, and draw them in the depth buffer.
+
+  \param cMo : The pose of the camera.
+  \param cam : Camera parameters.
+  \param width : Width of the image.
+  \param height : Height of the image.
+*/
+template<class PolygonType>
+void
+vpMbHiddenFaces<PolygonType>::renderDepthBuffer(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                                                const unsigned int width, const unsigned int height)
+{
+  // A volume is added with each polygon in addPolygon() and removed by reset()
+  if(!boundingVolumes.isBuilt())
+    boundingVolumes.build();
+  boundingVolumes.computeVisibleVolumes(cMo, cam, width, height, depthBuffer.getNearClippingDistance(), frustumIndexes);
+
+  polygonsInFrustum.assign(Lpol.size(), false);
+  depthBuffer.clear(cam, width, height);
+  for (unsigned int k = 0; k < frustumIndexes.size(); k++){
+    unsigned int i = frustumIndexes[k];
+    polygonsInFrustum[i] = true;
+    Lpol[i]->changeFrame(cMo);
+    depthBuffer.drawPolygon(Lpol[i]->p, Lpol[i]->nbpt);
+  }
+  depthBuffer.buildHierarchy();
+  depthBufferRendered = true;
+}
+
+/*!
+  Test if a polygon is in the field of view and not hidden by the other
+  polygons, using the depth buffer rendered by setVisible().
+
+  \param index : Index of the polygon.
+
+  \return false if the polygon is out of the field of view or hidden, true
+  otherwise or if the depth buffer is not used.
+*/
+template<class PolygonType>
+bool
+vpMbHiddenFaces<PolygonType>::isVisibleDepthBuffer(const unsigned int &index)
+{
+  if(!depthBufferRendered)
+    return true;
+  if(!polygonsInFrustum[index])
+    return false;
+  return depthBuffer.isVisible(Lpol[index]->p, Lpol[index]->nbpt);
+}
+
 /*!
   Compute the visibility of a given face index.
 
@@ -538,7 +639,7 @@ vpMbHiddenFaces<PolygonType>::computeVisibility(const vpHomogeneousMatrix &cMo,
       }
 #endif
       else
-        testDisappear = (!Lpol[i]->isVisible(cMo, angleDisappears, false, cam, I));
+        testDisappear = ((!Lpol[i]->isVisible(cMo, angleDisappears, false, cam, I)) || !isVisibleDepthBuffer(i));
     }
 
     // test if the face is still visible
@@ -567,7 +668,7 @@ vpMbHiddenFaces<PolygonType>::computeVisibility(const vpHomogeneousMatrix &cMo,
         testAppear = (Lpol[i]->isVisible(cMo, angleAppears, false, cam, I));
 #endif
       else
-        testAppear = (Lpol[i]->isVisible(cMo, angleAppears, false, cam, I));
+        testAppear = ((Lpol[i]->isVisible(cMo, angleAppears, false, cam, I)) && isVisibleDepthBuffer(i));
     }
 
     if(testAppear){
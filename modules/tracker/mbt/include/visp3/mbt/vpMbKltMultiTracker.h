@@ -81,6 +81,12 @@ protected:
   //! Name of the reference camera
   std::string m_referenceCameraName;
 
+  //! If true, the per-camera stages of track() are run concurrently
+  bool m_useParallelCameraTracking;
+
+  //! Map of the time in ms spent by each camera in the per-camera stages of the last call to track()
+  std::map<std::string, double> m_mapOfCameraTrackingTimes;
+
 public:
   vpMbKltMultiTracker();
   vpMbKltMultiTracker(const unsigned int nbCameras);
@@ -118,6 +124,8 @@ public:
 
   virtual std::vector<std::string> getCameraNames() const;
 
+  virtual void getCameraTrackingTimes(std::map<std::string, double> &mapOfTimes) const;
+
   virtual void getCameraParameters(vpCameraParameters &camera) const;
   virtual void getCameraParameters(vpCameraParameters &cam1, vpCameraParameters &cam2) const;
   virtual void getCameraParameters(const std::string &cameraName, vpCameraParameters &camera) const;
@@ -170,6 +178,8 @@ public:
   virtual void getPose(const std::string &cameraName, vpHomogeneousMatrix &cMo_) const;
   virtual void getPose(std::map<std::string, vpHomogeneousMatrix> &mapOfCameraPoses) const;
 
+  virtual double getScanLineRenderingTime() const;
+
   virtual void init(const vpImage<unsigned char>& I);
 
 #ifdef VISP_HAVE_MODULE_GUI
@@ -220,6 +230,10 @@ public:
 
   virtual void resetTracker();
 
+  virtual void saveCompiledModel(const std::string &compiledModelFile) const;
+
+  virtual void resetScanLineRenderingTime();
+
   virtual void setAngleAppear(const double &a);
   virtual void setAngleDisappear(const double &a);
 
@@ -242,6 +256,8 @@ public:
 
   virtual void setCovarianceComputation(const bool& flag);
 
+  virtual void setDepthBufferVisibilityTest(const bool &v);
+
   virtual void setDisplayFeatures(const bool displayF);
 
   virtual void setFarClippingDistance(const double &dist);
@@ -289,18 +305,52 @@ public:
 
   virtual void setReferenceCameraName(const std::string &referenceCameraName);
 
+  virtual void setScanLineParallelRendering(const bool &v);
+
+  virtual void setScanLineReuseThreshold(const double &threshold);
+
   virtual void setScanLineVisibilityTest(const bool &v);
 
   virtual void setThresholdAcceptation(const double th);
 
   virtual void setUseKltTracking(const std::string &name, const bool &useKltTracking);
 
+  virtual void setUseParallelCameraTracking(const bool use);
+
   virtual void track(const vpImage<unsigned char> &I);
   virtual void track(const vpImage<unsigned char>& I1, const vpImage<unsigned char>& I2);
   virtual void track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages);
   //@}
 
 protected:
+  //! Per-camera stages of track() that can be run concurrently.
+  typedef enum KltCameraStage {
+    KLT_PRE_TRACKING, //!< KLT tracking and count of the tracked points.
+    KLT_POST_TRACKING //!< Outlier removal, visibility and reinitialisation of the KLT points.
+  } KltCameraStage;
+
+  //! Input and output of a per-camera stage of track().
+  struct vpKltCameraStageData {
+    vpKltCameraStageData() : name(), tracker(NULL), image(NULL), nbInfos(0), nbFaceUsed(0), shift(0),
+      reinitialised(false), time(0.) {}
+
+    std::string name;
+    vpMbKltTracker *tracker;
+    const vpImage<unsigned char> *image;
+    unsigned int nbInfos;
+    unsigned int nbFaceUsed;
+    unsigned int shift;
+    bool reinitialised;
+    double time;
+  };
+
+  //! Data of each camera for the current stage
+  std::vector<vpKltCameraStageData> m_kltCameraStages;
+  //! Current stage
+  KltCameraStage m_kltCameraStage;
+  //! Weights of the KLT points used by the post-tracking stage
+  vpColVector *m_kltCameraStageWeights;
+
   /** @name Protected Member Functions Inherited from vpMbKltMultiTracker */
   //@{
   virtual void computeVVS(std::map<std::string, unsigned int> &mapOfNbInfos, vpColVector &w);
@@ -308,6 +358,8 @@ protected:
       std::map<std::string, unsigned int> &mapOfNbInfos, vpColVector &R, vpColVector &w_true, vpColVector &w,
       std::map<std::string, vpRobust> &mapOfRobusts, double threshold);
 
+  virtual void initKltCameraStages(const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages);
+
   virtual void preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
       std::map<std::string, unsigned int> &mapOfNbInfos,
       std::map<std::string, unsigned int> &mapOfNbFaceUsed);
@@ -316,7 +368,14 @@ protected:
       std::map<std::string, unsigned int> &mapOfNbInfos, vpColVector &w_klt);
   using vpMbKltTracker::reinit;
   virtual void reinit(/* const vpImage<unsigned char>& I */);
+
+  void runKltCameraStage(const unsigned int index);
+
+  virtual void runKltCameraStages(const KltCameraStage stage);
   //@}
+
+private:
+  friend class vpMbKltMultiTrackerCameraTask;
 };
 
 #endif // VISP_HAVE_OPENCV
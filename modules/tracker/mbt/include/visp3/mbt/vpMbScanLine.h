@@ -65,6 +65,16 @@
 
   \ingroup group_mbt_faces
 
+  The scene is rendered by bands of scanlines: the rows of the image for the
+  Y-axis scanlines and the columns for the X-axis ones. Each band owns its
+  buffers, which are kept from one call of drawScene() to the next one, so
+  that the bands can be rendered in parallel with vpThreadPool when
+  setParallelRendering() is enabled.
+
+  The projection of the scene is also kept, so that only the bands covered by
+  the polygons that moved by more than getReuseThreshold() pixels are
+  rendered again. With the default threshold, a band is only reused if the
+  scene did not change, as when the same pose is rendered several times.
  */
 class VISP_EXPORT vpMbScanLine
 {
@@ -83,9 +93,9 @@ public:
   //! Structure to define a scanline intersection.
   struct vpMbScanLineSegment
   {
-    vpMbScanLineSegment() : type(START), edge(), p(0), P1(0), P2(0), Z1(0), Z2(0), ID(0), b_sample_Y(false) {};
+    vpMbScanLineSegment() : type(START), edge(-1), p(0), P1(0), P2(0), Z1(0), Z2(0), ID(0), b_sample_Y(false) {};
     vpMbScanLineType type;
-    vpMbScanLineEdge edge;
+    int edge; // Index of the edge in the edges of the scene.
     double p; // This value can be either x or y-coordinate value depending if the structure is used in X or Y-axis scanlines computation.
     double P1, P2; // Same comment as previous value.
     double Z1, Z2;
@@ -127,15 +137,63 @@ public:
     }
   };
 
+  //! Buffers of a band of scanlines, kept from one rendering to the next one.
+  struct vpMbScanLineBand
+  {
+    vpMbScanLineBand() : scanlines(), localScanlines(), stack(), samples() {};
+    //! Intersections of the scanlines of the band.
+    std::vector<std::vector<vpMbScanLineSegment> > scanlines;
+    //! Intersections of the polygon being drawn.
+    std::vector<std::vector<vpMbScanLineSegment> > localScanlines;
+    //! Polygons crossing the current position of the scanline.
+    std::vector<std::pair<double, vpMbScanLineSegment> > stack;
+    //! Visible samples of the edges found in the band, as pairs of edge index and sample.
+    std::vector<std::pair<int, int> > samples;
+  };
+
 private:
   unsigned int            w, h;
   vpCameraParameters      K;
   unsigned int            maskBorder;
   vpImage<unsigned char>  mask;
   vpImage<int>            primitive_ids;
-  std::map<vpMbScanLineEdge, std::set<int>, vpMbScanLineEdgeComparator> visibility_samples;
   double                  depthTreshold;
 
+  //! Edges of the scene.
+  std::map<vpMbScanLineEdge, int, vpMbScanLineEdgeComparator> edgeIndexes;
+  //! Visible samples of each edge, sorted.
+  std::vector<std::vector<int> > visibility_samples;
+  //! Projection of the vertices of the scene, as triplets (u*Z, v*Z, Z).
+  std::vector<double> vertices;
+  //! Projection of the vertices used for the current rendering of the bands.
+  std::vector<double> renderedVertices;
+  //! Index of the first vertex of each polygon, followed by the number of vertices.
+  std::vector<unsigned int> polygonOffsets;
+  //! ID of each polygon.
+  std::vector<int> polygonIDs;
+  //! Index of the edge that starts at each vertex.
+  std::vector<int> vertexEdges;
+  //! Same as polygonOffsets, polygonIDs and vertexEdges for the current rendering.
+  std::vector<unsigned int> renderedOffsets;
+  std::vector<int> renderedIDs;
+  std::vector<int> renderedEdges;
+  //! Bands of the Y-axis scanlines followed by the bands of the X-axis scanlines.
+  std::vector<vpMbScanLineBand> bands;
+  //! Bands to render.
+  std::vector<unsigned int> dirtyBands;
+  //! Masks of the Y-axis and X-axis scanlines, used with a mask border.
+  vpImage<unsigned char>  maskY, maskX;
+  //! Mask border and depth threshold of the current rendering.
+  unsigned int            renderedMaskBorder;
+  double                  renderedDepthTreshold;
+  bool                    useParallelRendering;
+  double                  reuseThreshold;
+  //! Rendering statistics.
+  double                  renderingTime;
+  unsigned int            nbRenderings;
+  unsigned int            nbRenderedBands;
+  unsigned int            nbReusedBands;
+
 public:
 #if defined(DEBUG_DISP)
   vpDisplay *dispMaskDebug;
@@ -159,12 +217,26 @@ public:
   double                        getDepthTreshold() { return depthTreshold; }
   unsigned int                  getMaskBorder() { return maskBorder; }
   const vpImage<unsigned char>& getMask() const  { return mask; }
+  //! Return the number of bands rendered since the last call of resetRenderingStatistics().
+  unsigned int                  getNbRenderedBands() const { return nbRenderedBands; }
+  //! Return the number of calls of drawScene() since the last call of resetRenderingStatistics().
+  unsigned int                  getNbRenderings() const { return nbRenderings; }
+  //! Return the number of bands reused since the last call of resetRenderingStatistics().
+  unsigned int                  getNbReusedBands() const { return nbReusedBands; }
+  //! Return true if the bands are rendered in parallel.
+  bool                          getParallelRendering() const { return useParallelRendering; }
   const vpImage<int>&           getPrimitiveIDs() const  { return primitive_ids; }
+  //! Return the time in ms spent in drawScene() since the last call of resetRenderingStatistics().
+  double                        getRenderingTime() const { return renderingTime; }
+  //! Return the displacement in pixel under which a polygon is not rendered again.
+  double                        getReuseThreshold() const { return reuseThreshold; }
 
   void                          queryLineVisibility(const vpPoint &a, const vpPoint &b,
                                                     std::vector<std::pair<vpPoint, vpPoint> > &lines,
                                                     const bool &displayResults = false);
 
+  void                          resetRenderingStatistics();
+
   /*!
     If there is one polygon behind another,
     this threshold defines the minimum distance between both polygons to still consider the one behind as visible.
@@ -173,32 +245,46 @@ public:
   */
   void                          setDepthTreshold(const double &treshold) { depthTreshold = treshold; }
   void                          setMaskBorder(const unsigned int &mb){ maskBorder = mb; }
-
+  //! Render the bands in parallel with vpThreadPool.
+  void                          setParallelRendering(const bool use) { useParallelRendering = use; }
+  void                          setReuseThreshold(const double threshold);
 
 private:
+  friend class vpMbScanLineBandTask;
+
+  void buildScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > * > &polygons,
+                  const std::vector<int> &listPolyIndices);
+
   void createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
                                  std::vector<std::vector<vpMbScanLineSegment> > &localScanlines,
-                                 const unsigned int &size);
+                                 const unsigned int &first, const unsigned int &last);
 
-  void drawLineY(const vpColVector &a,
-                 const vpColVector &b,
-                 const vpMbScanLineEdge &line_ID,
+  void drawLineY(const double *a,
+                 const double *b,
+                 const int edge,
                  const int ID,
+                 const unsigned int &first, const unsigned int &last,
                  std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
 
-  void drawLineX(const vpColVector &a,
-                 const vpColVector &b,
-                 const vpMbScanLineEdge &line_ID,
+  void drawLineX(const double *a,
+                 const double *b,
+                 const int edge,
                  const int ID,
+                 const unsigned int &first, const unsigned int &last,
                  std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
 
-  void drawPolygonY(const std::vector<std::pair<vpPoint, unsigned int> > &polygon,
-                    const int ID,
-                    std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  void drawPolygonY(const unsigned int &polygon, const unsigned int &first, const unsigned int &last,
+                    vpMbScanLineBand &band);
+
+  void drawPolygonX(const unsigned int &polygon, const unsigned int &first, const unsigned int &last,
+                    vpMbScanLineBand &band);
+
+  void findDirtyBands(const bool fullRendering);
+
+  void renderBand(const unsigned int &index);
 
-  void drawPolygonX(const std::vector<std::pair<vpPoint, unsigned int> > &polygon,
-                    const int ID,
-                    std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  void sweepScanLine(const unsigned int &index, const bool &axisY, vpMbScanLineBand &band,
+                     std::vector<vpMbScanLineSegment> &scanline);
 
   // Static functions
   static vpMbScanLineEdge makeMbScanLineEdge(const vpPoint &a, const vpPoint &b);
@@ -65,6 +65,7 @@
 #include <visp3/core/vpPoint.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 #include <visp3/mbt/vpMbHiddenFaces.h>
+#include <visp3/mbt/vpMbtCompiledModel.h>
 #include <visp3/core/vpPolygon.h>
 
 #ifdef VISP_HAVE_COIN3D
@@ -179,6 +180,10 @@ protected:
   double minPolygonAreaThresholdGeneral;
   //! Map with [map.first]=parameter_names and [map.second]=type (string, number or boolean)
   std::map<std::string, std::string> mapOfParameterNames;
+  //! Primitives of the model loaded by the last call to loadModel()
+  vpMbtCompiledModel m_compiledModel;
+  //! Id of the first face of the model loaded by the last call to loadModel()
+  int m_compiledModelFirstIdFace;
 
 public:
   vpMbTracker();
@@ -341,6 +346,14 @@ public:
   */
   virtual inline vpHomogeneousMatrix getPose() const {return this->cMo;}
 
+  /*!
+    Get the time in ms spent to render the scene of the scanline visibility
+    test since the last call of resetScanLineRenderingTime().
+
+    \sa setScanLineVisibilityTest()
+  */
+  virtual double getScanLineRenderingTime() const { return faces.getMbScanLineRenderer().getRenderingTime(); }
+
   // Intializer
 
 #ifdef VISP_HAVE_MODULE_GUI
@@ -359,6 +372,8 @@ public:
   virtual void loadModel(const char *modelFile, const bool verbose=false);
   virtual void loadModel(const std::string &modelFile, const bool verbose=false);
 
+  virtual void saveCompiledModel(const std::string &compiledModelFile) const;
+
   /*!
     Set the angle used to test polygons appearance.
     If the angle between the normal of the polygon and the line going
@@ -397,6 +412,17 @@ public:
   */
   virtual void setCovarianceComputation(const bool& flag) { computeCovariance = flag; }
 
+  /*!
+    Use a bounding volume hierarchy and a low resolution depth buffer computed on the CPU to
+    remove the faces that are out of the field of view or hidden by other faces. This test
+    is not used when the visibility is computed with Ogre3D.
+
+    \param v : True to use it, False otherwise
+
+    \sa setOgreVisibilityTest(), setScanLineVisibilityTest()
+  */
+  virtual void setDepthBufferVisibilityTest(const bool &v) { faces.setDepthBufferVisibilityTest(v); }
+
   /*!
     Enable to display the features. By features, we meant the moving edges (ME) and the klt points if used.
 
@@ -436,6 +462,28 @@ public:
   */
   virtual void setProjectionErrorComputation(const bool &flag) { computeProjError = flag; }
 
+  /*!
+    Render the bands of scanlines of the scanline visibility test in parallel
+    with vpThreadPool.
+
+    \param v : True to render the bands in parallel, False otherwise.
+
+    \sa setScanLineVisibilityTest()
+  */
+  virtual void setScanLineParallelRendering(const bool &v) { faces.getMbScanLineRenderer().setParallelRendering(v); }
+
+  /*!
+    Set the displacement in pixel under which a face is not rendered again by
+    the scanline visibility test. The bands of scanlines that only contain
+    faces that moved less than this threshold keep their previous result.
+
+    \param threshold : Displacement in pixel. With the default value 0, only
+    the faces that did not move at all are not rendered again.
+
+    \sa setScanLineVisibilityTest()
+  */
+  virtual void setScanLineReuseThreshold(const double &threshold) { faces.getMbScanLineRenderer().setReuseThreshold(threshold); }
+
   virtual void setScanLineVisibilityTest(const bool &v){ useScanLine = v; }
 
   virtual void setOgreVisibilityTest(const bool &v);
@@ -543,6 +591,11 @@ public:
   */
   virtual void resetTracker() = 0;
 
+  /*!
+    Reset the rendering time returned by getScanLineRenderingTime().
+  */
+  virtual void resetScanLineRenderingTime() { faces.getMbScanLineRenderer().resetRenderingStatistics(); }
+
   /*!
     Set the pose to be used in entry of the next call to the track() function.
     This pose will be just used once.
@@ -581,6 +634,12 @@ protected:
   void addPolygon(const std::vector<std::vector<vpPoint> > &listFaces, const int idFace=-1, const std::string &polygonName="",
       const bool useLod=false, const double minLineLengthThreshold=50);
 
+  void addModelPrimitive(const vpMbtCompiledModel::vpPrimitiveType type, const std::vector<vpPoint> &points,
+      const int idFace, const std::string &name, const unsigned int flags, const double radius=0.,
+      const double minPolygonAreaThreshold=0., const double minLineLengthThreshold=0.);
+  void initModelPrimitive(const vpMbtCompiledModel::vpPrimitive &primitive, const std::vector<vpPoint> &points,
+      const std::string &name, const int firstIdFace);
+
   void createCylinderBBox(const vpPoint& p1, const vpPoint &p2, const double &radius, std::vector<std::vector<vpPoint> > &listFaces);
 
   void computeJTR(const vpMatrix& J, const vpColVector& R, vpColVector& JTR) const;
@@ -634,6 +693,7 @@ protected:
   virtual void initFaceFromCorners(vpMbtPolygon &polygon)=0;
   virtual void initFaceFromLines(vpMbtPolygon &polygon)=0;
 
+  virtual void loadCompiledModel(const std::string& modelFile, const bool verbose=false);
   virtual void loadVRMLModel(const std::string& modelFile);
   virtual void loadCAOModel(const std::string& modelFile, std::vector<std::string>& vectorOfModelFilename, int& startIdFace,
                             const bool verbose=false, const bool parent=true);
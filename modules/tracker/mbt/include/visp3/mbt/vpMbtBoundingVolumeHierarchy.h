@@ -0,0 +1,125 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Bounding volume hierarchy used for the frustum culling of the faces of the
+ * model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+ \file vpMbtBoundingVolumeHierarchy.h
+ \brief Bounding volume hierarchy used for the frustum culling of the faces
+ of the model-based trackers.
+*/
+
+#ifndef vpMbtBoundingVolumeHierarchy_HH
+#define vpMbtBoundingVolumeHierarchy_HH
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpPoint.h>
+
+#include <vector>
+
+/*!
+  \class vpMbtBoundingVolumeHierarchy
+
+  \brief Binary tree of axis aligned bounding boxes used to find the faces of
+  a model that are inside the field of view of the camera.
+
+  \ingroup group_mbt_faces
+
+  A volume is added for each face with addVolume(), from the coordinates of
+  its vertices in the object frame. Once build() is called, the tree is
+  traversed by computeVisibleVolumes() that only tests the boxes of the nodes
+  that cross the border of the view frustum: a node that is outside the
+  frustum is skipped and a node that is inside is accepted with all its
+  faces. The cost of the culling thus grows with the number of faces that
+  are close to the border of the image rather than with the size of the
+  model.
+
+  The test is conservative: a face whose box crosses the frustum is returned
+  even if the face itself is outside the image.
+*/
+class VISP_EXPORT vpMbtBoundingVolumeHierarchy
+{
+public:
+  vpMbtBoundingVolumeHierarchy();
+
+  void addVolume(const vpPoint *points, const unsigned int nbPoints);
+  void build();
+  void computeVisibleVolumes(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                             const unsigned int width, const unsigned int height, const double nearDistance,
+                             std::vector<unsigned int> &indexes) const;
+  //! Return the number of nodes of the tree.
+  inline unsigned int getNbNodes() const { return (unsigned int)m_nodes.size(); }
+  //! Return the number of volumes added with addVolume().
+  inline unsigned int getNbVolumes() const { return (unsigned int)m_volumes.size(); }
+  //! Return true if build() has been called since the last volume was added.
+  inline bool isBuilt() const { return m_built; }
+  void reset();
+
+private:
+  //! Axis aligned box of a face or of a node of the tree.
+  struct vpBox {
+    double min[3];
+    double max[3];
+  };
+  //! Node of the tree. The left child follows its parent in the list of nodes.
+  struct vpNode {
+    vpBox box;
+    //! First volume of the node in m_order.
+    unsigned int first;
+    //! Number of volumes of the node.
+    unsigned int count;
+    //! Index of the right child, 0 for a leaf.
+    unsigned int right;
+  };
+
+  unsigned int buildNode(const unsigned int first, const unsigned int count);
+
+  //! Boxes of the volumes in the order they have been added.
+  std::vector<vpBox> m_volumes;
+  //! Flag to know if a volume has at least one vertex.
+  std::vector<bool> m_bounded;
+  //! Centers of the boxes of the volumes, used to split the nodes.
+  std::vector<double> m_centers;
+  //! Volumes sorted so that the volumes of a node are contiguous.
+  std::vector<unsigned int> m_order;
+  //! Nodes in depth first order, the root first.
+  std::vector<vpNode> m_nodes;
+  //! Volumes without vertex, always considered as visible.
+  std::vector<unsigned int> m_unbounded;
+  //! Flag to know if the tree is up to date with the volumes.
+  bool m_built;
+};
+
+#endif
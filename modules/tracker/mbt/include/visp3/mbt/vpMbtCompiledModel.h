@@ -0,0 +1,180 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compiled binary representation of the 3D models of the model-based
+ * trackers.
+ *
+ *****************************************************************************/
+
+/*!
+ \file vpMbtCompiledModel.h
+ \brief Compiled binary representation of the 3D models of the model-based
+ trackers.
+*/
+
+#ifndef vpMbtCompiledModel_HH
+#define vpMbtCompiledModel_HH
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpPoint.h>
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+  \class vpMbtCompiledModel
+
+  \brief Flat list of the primitives (faces, lines, cylinders and circles)
+  extracted from a cao or wrl model, that can be saved in a binary file and
+  loaded back without parsing the original model.
+
+  \ingroup group_mbt_faces
+
+  The primitives are stored in the order they are added to the tracker, with
+  the coordinates of their points in a single array and their names in a
+  string table. The optional parameters of the cao format (useLod,
+  minPolygonAreaThreshold and minLineLengthThreshold) are kept as they are
+  written in the model, so that the LOD settings of the tracker are applied
+  when the model is loaded, as with the original file.
+
+  The binary file is little endian. It contains the size and a 64 bits FNV-1a
+  hash of each source file (the main model and the included ones), used by
+  isUpToDate() to detect a compiled model older than its sources, and a hash
+  of its own content checked by load().
+
+  This class is used by vpMbTracker::loadModel() and
+  vpMbTracker::saveCompiledModel():
+  \code
+  vpMbEdgeTracker tracker;
+  tracker.loadModel("plant.cao");
+  tracker.saveCompiledModel("plant.bin");
+  ...
+  vpMbEdgeTracker tracker2;
+  tracker2.loadModel("plant.bin"); // No parsing of plant.cao
+  \endcode
+*/
+class VISP_EXPORT vpMbtCompiledModel
+{
+public:
+  //! Type of the primitives of a model.
+  typedef enum {
+    POLYGON_FROM_LINES = 0, /*!< Face defined by the lines of a cao model. */
+    POLYGON_FROM_POINTS,    /*!< Face or line defined by its corners. */
+    SEGMENT,                /*!< Line of a cao model that does not belong to a face. */
+    CYLINDER,               /*!< Cylinder defined by two points on its axis and its radius. */
+    CIRCLE                  /*!< Circle defined by its center, two points on its plane and its radius. */
+  } vpPrimitiveType;
+
+  //! Parameters of a primitive that are explicitly set in the model.
+  typedef enum {
+    HAS_USE_LOD = 0x01,          /*!< The useLod parameter is set. */
+    USE_LOD = 0x02,              /*!< Value of the useLod parameter. */
+    HAS_MIN_POLYGON_AREA = 0x04, /*!< The minPolygonAreaThreshold parameter is set. */
+    HAS_MIN_LINE_LENGTH = 0x08   /*!< The minLineLengthThreshold parameter is set. */
+  } vpPrimitiveFlag;
+
+  //! Description of a primitive.
+  struct vpPrimitive {
+    //! Type of the primitive (see vpPrimitiveType).
+    unsigned int type;
+    //! Combination of vpPrimitiveFlag.
+    unsigned int flags;
+    //! Id of the first face of the primitive, relatively to the first face of the model.
+    int idFace;
+    //! Index of the first point in the point array.
+    unsigned int firstPoint;
+    //! Number of points.
+    unsigned int nbPoints;
+    //! Index of the name in the string table.
+    unsigned int name;
+    //! Radius of the cylinders and circles.
+    double radius;
+    //! Value of the minPolygonAreaThreshold parameter when it is set.
+    double minPolygonArea;
+    //! Value of the minLineLengthThreshold parameter when it is set.
+    double minLineLength;
+  };
+
+  vpMbtCompiledModel();
+
+  void addPrimitive(const vpPrimitiveType type, const std::vector<vpPoint> &points, const int idFace,
+                    const std::string &name, const unsigned int flags=0, const double radius=0.,
+                    const double minPolygonArea=0., const double minLineLength=0.);
+  void addSource(const std::string &filename);
+  void clear();
+
+  //! Return the name of the primitive \e primitive.
+  inline const std::string &getName(const vpPrimitive &primitive) const { return m_names[primitive.name]; }
+  //! Return the number of faces created by the primitives.
+  inline unsigned int getNbFaces() const { return m_nbFaces; }
+  //! Return the number of primitives.
+  inline unsigned int getNbPrimitives() const { return (unsigned int)m_primitives.size(); }
+  void getPoints(const vpPrimitive &primitive, std::vector<vpPoint> &points) const;
+  //! Return the primitive of index \e i.
+  inline const vpPrimitive &getPrimitive(const unsigned int i) const { return m_primitives[i]; }
+  //! Return the files from which the model was extracted, the main model first.
+  inline const std::vector<std::string> &getSources() const { return m_sources; }
+  void getStatistics(unsigned int &nbPoints, unsigned int &nbLines, unsigned int &nbPolygonLines,
+                     unsigned int &nbPolygonPoints, unsigned int &nbCylinders, unsigned int &nbCircles) const;
+
+  static bool isCompiledModel(const std::string &filename);
+  bool isUpToDate() const;
+
+  void load(const std::string &filename);
+  void save(const std::string &filename) const;
+
+  void setStatistics(const unsigned int nbPoints, const unsigned int nbLines, const unsigned int nbPolygonLines,
+                     const unsigned int nbPolygonPoints, const unsigned int nbCylinders, const unsigned int nbCircles);
+
+private:
+  //! Primitives, in the order they are added to the tracker.
+  std::vector<vpPrimitive> m_primitives;
+  //! Object frame coordinates of the points of the primitives (X, Y, Z).
+  std::vector<double> m_points;
+  //! String table of the names of the primitives.
+  std::vector<std::string> m_names;
+  //! Index of the names in the string table.
+  std::map<std::string, unsigned int> m_nameIndex;
+  //! Source files of the model.
+  std::vector<std::string> m_sources;
+  //! Size in bytes of the source files.
+  std::vector<uint64_t> m_sourceSizes;
+  //! Hash of the source files.
+  std::vector<uint64_t> m_sourceHashes;
+  //! Number of faces created by the primitives.
+  unsigned int m_nbFaces;
+  //! Number of points, lines, polygon lines, polygon points, cylinders and circles declared in the model.
+  unsigned int m_statistics[6];
+};
+
+#endif
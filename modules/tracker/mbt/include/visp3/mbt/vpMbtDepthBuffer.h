@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Low resolution hierarchical depth buffer used for the occlusion culling of
+ * the faces of the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+ \file vpMbtDepthBuffer.h
+ \brief Low resolution hierarchical depth buffer used for the occlusion
+ culling of the faces of the model-based trackers.
+*/
+
+#ifndef vpMbtDepthBuffer_HH
+#define vpMbtDepthBuffer_HH
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpPoint.h>
+
+#include <vector>
+
+/*!
+  \class vpMbtDepthBuffer
+
+  \brief Low resolution hierarchical depth buffer used to test on the CPU if
+  the faces of a model are hidden by other faces.
+
+  \ingroup group_mbt_faces
+
+  The buffer has the size of the image divided by the subsampling factor
+  (4 by default). Each cell stores the inverse of the depth of the farthest
+  point of the nearest face that entirely covers it, or 0 when no face
+  covers it entirely. The coarse levels of the hierarchy store the farthest
+  value of the cells they contain.
+
+  Both the rendering and the query are conservative: the rendering only
+  writes the cells that are fully covered by a polygon, and a polygon is said
+  hidden only if, in every cell of its bounding box, its nearest point is
+  behind the depth stored in the buffer. A face can thus be reported visible
+  while it is hidden, never the opposite.
+
+  The points given to drawPolygon() and isVisible() have to be expressed in
+  the camera frame, i.e. vpPoint::changeFrame() has to be called before.
+
+  \code
+  vpMbtDepthBuffer buffer;
+  buffer.clear(cam, I.getWidth(), I.getHeight());
+  for (unsigned int i = 0; i < polygons.size(); i++) {
+    polygons[i]->changeFrame(cMo);
+    buffer.drawPolygon(polygons[i]->p, polygons[i]->nbpt);
+  }
+  buffer.buildHierarchy();
+  bool visible = buffer.isVisible(polygons[0]->p, polygons[0]->nbpt);
+  \endcode
+*/
+class VISP_EXPORT vpMbtDepthBuffer
+{
+public:
+  vpMbtDepthBuffer();
+
+  void buildHierarchy();
+  void clear(const vpCameraParameters &cam, const unsigned int width, const unsigned int height);
+  void drawPolygon(const vpPoint *points, const unsigned int nbPoints);
+
+  double getDepth(const unsigned int i, const unsigned int j) const;
+  /*!
+    Return the tolerance on the depth, relative to the depth of the faces.
+  */
+  inline double getDepthTolerance() const { return m_tolerance; }
+  //! Return the height of the buffer.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Return the distance of the near clipping plane in meter.
+  inline double getNearClippingDistance() const { return m_near; }
+  //! Return the subsampling factor between the image and the buffer.
+  inline unsigned int getSubsampling() const { return m_subsampling; }
+  //! Return the width of the buffer.
+  inline unsigned int getWidth() const { return m_width; }
+
+  bool isVisible(const vpPoint *points, const unsigned int nbPoints);
+
+  void setDepthTolerance(const double tolerance);
+  void setNearClippingDistance(const double dist);
+  void setSubsampling(const unsigned int subsampling);
+
+private:
+  bool computePlane(double &A, double &B, double &C) const;
+  unsigned int projectPolygon(const vpPoint *points, const unsigned int nbPoints);
+
+  //! Subsampling factor between the image and the buffer.
+  unsigned int m_subsampling;
+  //! Distance of the near clipping plane.
+  double m_near;
+  //! Relative tolerance on the depth used by the visibility test.
+  double m_tolerance;
+  //! Camera parameters expressed in cells of the buffer.
+  double m_px, m_py, m_u0, m_v0;
+  //! Size of the finest level.
+  unsigned int m_width, m_height;
+  //! Number of floats between two rows of the finest level.
+  unsigned int m_stride;
+  //! Inverse depths of the levels, the finest first.
+  std::vector< std::vector<float> > m_levels;
+  //! Size of the levels.
+  std::vector<unsigned int> m_levelWidth, m_levelHeight;
+  //! Flag to know if the coarse levels are up to date with the finest one.
+  bool m_hierarchyBuilt;
+  //! Projection of the last polygon clipped by the near plane.
+  std::vector<double> m_u, m_v, m_w;
+  //! Coefficients of the edges of the last polygon.
+  std::vector<float> m_edges;
+};
+
+#endif
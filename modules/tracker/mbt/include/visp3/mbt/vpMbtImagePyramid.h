@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pyramid of images used by the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+ \file vpMbtImagePyramid.h
+ \brief Pyramid of images used by the model-based trackers.
+*/
+
+#ifndef vpMbtImagePyramid_HH
+#define vpMbtImagePyramid_HH
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+
+#include <vector>
+
+/*!
+  \class vpMbtImagePyramid
+
+  \brief Pyramid of images used by the model-based trackers for the multi-scale
+  tracking.
+
+  \ingroup group_mbt_features
+
+  Level 0 is the input image itself, level \e i is the input image decimated
+  by a factor \f$2^i\f$. Only the levels that are enabled in the vector of
+  scales passed to build() are accessible.
+
+  The images of the levels are kept from one call of build() to the next one,
+  so that building the pyramid of a new frame of the same size does not
+  allocate memory. The decimation is either a nearest neighbour subsampling or
+  a Gaussian 2x decimation computed level after level with a 5 taps binomial
+  kernel.
+
+  \code
+  vpMbtImagePyramid pyramid;
+  std::vector<bool> scales(3, true);
+  pyramid.build(I, scales, vpMbtImagePyramid::GAUSSIAN_FILTER);
+  const vpImage<unsigned char> &I2 = *pyramid[2]; // Image with quarter resolution
+  \endcode
+*/
+class VISP_EXPORT vpMbtImagePyramid
+{
+public:
+  /*!
+    Filter used to compute a level from the previous one.
+  */
+  typedef enum {
+    NEAREST_FILTER,  /*!< Subsampling without smoothing. */
+    GAUSSIAN_FILTER  /*!< Gaussian smoothing before subsampling. */
+  } vpPyramidFilterType;
+
+  vpMbtImagePyramid();
+
+  void build(const vpImage<unsigned char> &I, const std::vector<bool> &scales,
+             const vpPyramidFilterType filter=NEAREST_FILTER);
+  void clear();
+
+  static void decimateGaussian(const vpImage<unsigned char> &I, vpImage<unsigned char> &Id,
+                               std::vector<unsigned short> &buffer);
+
+  /*!
+    Return the number of levels of the pyramid, enabled or not.
+  */
+  inline unsigned int size() const { return (unsigned int)m_enabled.size(); }
+
+  /*!
+    Return a pointer to the image of the level \e level, or NULL if the level
+    is not enabled.
+  */
+  inline const vpImage<unsigned char>* operator[](const unsigned int level) const
+  {
+    if (level >= m_enabled.size() || ! m_enabled[level])
+      return NULL;
+    return (level == 0) ? m_I : &m_levels[level];
+  }
+
+private:
+  //! Input image, level 0 of the pyramid.
+  const vpImage<unsigned char> *m_I;
+  //! Flag to know if a level is enabled.
+  std::vector<bool> m_enabled;
+  //! Images of the levels. The first one is not used.
+  std::vector< vpImage<unsigned char> > m_levels;
+  //! Intermediate result of the Gaussian filter.
+  std::vector<unsigned short> m_buffer;
+};
+
+#endif
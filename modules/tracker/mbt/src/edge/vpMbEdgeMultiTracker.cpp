@@ -45,15 +45,41 @@
 #include <visp3/core/vpDebug.h>
 #include <visp3/mbt/vpMbEdgeMultiTracker.h>
 #include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// Run the current per-camera stage of a vpMbEdgeMultiTracker for a range of cameras
+class vpMbEdgeMultiTrackerCameraTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpMbEdgeMultiTrackerCameraTask(vpMbEdgeMultiTracker &tracker) : m_tracker(tracker) {}
+
+  void run(unsigned int start, unsigned int end)
+  {
+    for (unsigned int i = start; i < end; i++)
+      m_tracker.runCameraStage(i);
+  }
+
+private:
+  vpMbEdgeMultiTracker &m_tracker;
+
+  vpMbEdgeMultiTrackerCameraTask &operator=(const vpMbEdgeMultiTrackerCameraTask &);
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 /*!
   Basic constructor
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker() : m_mapOfCameraTransformationMatrix(), m_mapOfEdgeTrackers(),
-    m_mapOfPyramidalImages(), m_referenceCameraName("Camera") {
+    m_mapOfPyramidalImages(), m_referenceCameraName("Camera"), m_useParallelCameraTracking(false),
+    m_mapOfCameraTrackingTimes(), m_cameraStages(), m_cameraStage(TRACK_MOVING_EDGE), m_cameraStageLevel(0),
+    m_cameraStageIteration(0) {
   m_mapOfEdgeTrackers["Camera"] = new vpMbEdgeTracker();
 
   //Add default camera transformation matrix
@@ -66,7 +92,9 @@ vpMbEdgeMultiTracker::vpMbEdgeMultiTracker() : m_mapOfCameraTransformationMatrix
   \param nbCameras : Number of cameras to use.
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const unsigned int nbCameras) : m_mapOfCameraTransformationMatrix(),
-    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_referenceCameraName("Camera") {
+    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_referenceCameraName("Camera"), m_useParallelCameraTracking(false),
+    m_mapOfCameraTrackingTimes(), m_cameraStages(), m_cameraStage(TRACK_MOVING_EDGE), m_cameraStageLevel(0),
+    m_cameraStageIteration(0) {
 
   if(nbCameras == 0) {
     throw vpException(vpTrackingException::fatalError, "Cannot construct a vpMbEdgeMultiTracker with no camera !");
@@ -107,7 +135,9 @@ vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const unsigned int nbCameras) : m_map
   \param cameraNames : List of camera names.
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const std::vector<std::string> &cameraNames) : m_mapOfCameraTransformationMatrix(),
-    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_referenceCameraName("Camera") {
+    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_referenceCameraName("Camera"), m_useParallelCameraTracking(false),
+    m_mapOfCameraTrackingTimes(), m_cameraStages(), m_cameraStage(TRACK_MOVING_EDGE), m_cameraStageLevel(0),
+    m_cameraStageIteration(0) {
 
   if(cameraNames.empty()) {
     throw vpException(vpTrackingException::fatalError, "Cannot construct a vpMbEdgeMultiTracker with no camera !");
@@ -135,19 +165,9 @@ vpMbEdgeMultiTracker::~vpMbEdgeMultiTracker() {
   cleanPyramid(m_mapOfPyramidalImages);
 }
 
-void vpMbEdgeMultiTracker::cleanPyramid(std::map<std::string, std::vector<const vpImage<unsigned char>* > >& pyramid) {
-  for(std::map<std::string, std::vector<const vpImage<unsigned char>* > >::iterator it1 = pyramid.begin();
-      it1 != pyramid.end(); ++it1) {
-    if(it1->second.size() > 0){
-      it1->second[0] = NULL;
-      for(size_t i = 1; i < it1->second.size(); i++) {
-        if(it1->second[i] != NULL) {
-          delete it1->second[i];
-          it1->second[i] = NULL;
-        }
-      }
-      it1->second.clear();
-    }
+void vpMbEdgeMultiTracker::cleanPyramid(std::map<std::string, vpMbtImagePyramid>& pyramid) {
+  for(std::map<std::string, vpMbtImagePyramid>::iterator it1 = pyramid.begin(); it1 != pyramid.end(); ++it1) {
+    vpMbEdgeTracker::cleanPyramid(it1->second);
   }
 }
 
@@ -225,6 +245,15 @@ void vpMbEdgeMultiTracker::computeVVS(std::map<std::string, const vpImage<unsign
     throw vpTrackingException(vpTrackingException::notEnoughPointError, "No data found to compute the interaction matrix...");
   }
 
+  initCameraStages(mapOfImages);
+  for(size_t i = 0; i < m_cameraStages.size(); i++) {
+    vpCameraStageData &data = m_cameraStages[i];
+    data.nbRows = mapOfNumberOfRows[data.name];
+    data.nbLines = mapOfNumberOfLines[data.name];
+    data.nbCylinders = mapOfNumberOfCylinders[data.name];
+    data.nbCircles = mapOfNumberOfCircles[data.name];
+  }
+
   vpMatrix L;
 
   // compute the error vector
@@ -289,21 +318,22 @@ void vpMbEdgeMultiTracker::computeVVS(std::map<std::string, const vpImage<unsign
     factor = vpColVector();
 
 
-    for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
-        it != m_mapOfEdgeTrackers.end(); ++it) {
-      vpMatrix L_tmp(mapOfNumberOfRows[it->first], 6);
+    for(size_t i = 0; i < m_cameraStages.size(); i++) {
+      m_cameraStages[i].factor = &mapOfFactors[m_cameraStages[i].name];
+    }
+
+    runCameraStages(VVS_FIRST_PHASE, lvl, iter);
 
-      double count_tmp = 0.0;
-      it->second->computeVVSFirstPhase(*mapOfImages[it->first], iter, L_tmp, mapOfFactors[it->first], count_tmp,
-          it->second->m_error, it->second->m_w, lvl);
-      count += count_tmp;
+    for(size_t i = 0; i < m_cameraStages.size(); i++) {
+      vpCameraStageData &data = m_cameraStages[i];
+      count += data.count;
 
-      L_tmp = L_tmp*mapOfVelocityTwist[it->first];
+      data.L = data.L*mapOfVelocityTwist[data.name];
 
-      L.stack(L_tmp);
-      factor.stack(mapOfFactors[it->first]);
-      m_w.stack(it->second->m_w);
-      m_error.stack(it->second->m_error);
+      L.stack(data.L);
+      factor.stack(*data.factor);
+      m_w.stack(data.tracker->m_w);
+      m_error.stack(data.tracker->m_error);
     }
 
     count = count / (double) nbrow;
@@ -379,32 +409,26 @@ void vpMbEdgeMultiTracker::computeVVS(std::map<std::string, const vpImage<unsign
     std::map<std::string, vpColVector> mapOfErrorCylinders;
     std::map<std::string, vpColVector> mapOfErrorCircles;
 
-    for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
-        it != m_mapOfEdgeTrackers.end(); ++it) {
-      vpMatrix L_tmp(mapOfNumberOfRows[it->first], 6);
-      vpColVector error_lines_tmp(mapOfNumberOfLines[it->first]);
-      vpColVector error_cylinders_tmp(mapOfNumberOfCylinders[it->first]);
-      vpColVector error_circles_tmp(mapOfNumberOfCircles[it->first]);
-
-      it->second->cMo = m_mapOfCameraTransformationMatrix[it->first]*cMo;
+    for(size_t i = 0; i < m_cameraStages.size(); i++) {
+      m_cameraStages[i].tracker->cMo = m_mapOfCameraTransformationMatrix[m_cameraStages[i].name]*cMo;
+    }
 
-      vpColVector error_tmp;
-      error_tmp.resize(mapOfNumberOfRows[it->first]);
+    runCameraStages(VVS_SECOND_PHASE, lvl);
 
-      it->second->computeVVSSecondPhase(*mapOfImages[it->first], L_tmp, error_lines_tmp,
-          error_cylinders_tmp, error_circles_tmp, error_tmp, lvl);
-      L_tmp = L_tmp*mapOfVelocityTwist[it->first];
+    for(size_t i = 0; i < m_cameraStages.size(); i++) {
+      vpCameraStageData &data = m_cameraStages[i];
+      data.L = data.L*mapOfVelocityTwist[data.name];
 
-      L.stack(L_tmp);
-      m_error.stack(error_tmp);
+      L.stack(data.L);
+      m_error.stack(data.error);
 
-      error_lines.stack(error_lines_tmp);
-      error_cylinders.stack(error_cylinders_tmp);
-      error_circles.stack(error_circles_tmp);
+      error_lines.stack(data.errorLines);
+      error_cylinders.stack(data.errorCylinders);
+      error_circles.stack(data.errorCircles);
 
-      mapOfErrorLines[it->first] = error_lines_tmp;
-      mapOfErrorCylinders[it->first] = error_cylinders_tmp;
-      mapOfErrorCircles[it->first] = error_circles_tmp;
+      mapOfErrorLines[data.name] = data.errorLines;
+      mapOfErrorCylinders[data.name] = data.errorCylinders;
+      mapOfErrorCircles[data.name] = data.errorCircles;
     }
 
     bool reStartFromLastIncrement = false;
@@ -780,6 +804,19 @@ std::vector<std::string> vpMbEdgeMultiTracker::getCameraNames() const {
   return cameraNames;
 }
 
+/*!
+  Get the time spent by each camera in the per-camera stages of the last call
+  to track(): moving-edge tracking, interaction matrix construction, visibility
+  and update of the moving edges.
+
+  \param mapOfTimes : Map of the times in ms.
+
+  \sa setUseParallelCameraTracking()
+*/
+void vpMbEdgeMultiTracker::getCameraTrackingTimes(std::map<std::string, double> &mapOfTimes) const {
+  mapOfTimes = m_mapOfCameraTrackingTimes;
+}
+
 /*!
   Get the camera parameters for the mono/reference camera.
 
@@ -1243,6 +1280,22 @@ void vpMbEdgeMultiTracker::getPose(std::map<std::string, vpHomogeneousMatrix> &m
   }
 }
 
+/*!
+  Get the time in ms spent to render the scene of the scanline visibility test
+  by all the cameras since the last call of resetScanLineRenderingTime().
+
+  \return The rendering time in ms.
+*/
+double vpMbEdgeMultiTracker::getScanLineRenderingTime() const {
+  double time = 0.0;
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    time += it->second->getScanLineRenderingTime();
+  }
+
+  return time;
+}
+
 void vpMbEdgeMultiTracker::init(const vpImage<unsigned char>& /*I*/) {
 }
 
@@ -1643,13 +1696,30 @@ void vpMbEdgeMultiTracker::initFromPose(const std::map<std::string, const vpImag
   vpMbEdgeMultiTracker::setPose(mapOfImages, mapOfCameraPoses);
 }
 
+/*!
+  Set the trackers and the images used by the per-camera stages.
+
+  \param mapOfImages : Map of images.
+*/
+void vpMbEdgeMultiTracker::initCameraStages(const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages) {
+  m_cameraStages.resize(m_mapOfEdgeTrackers.size());
+
+  size_t i = 0;
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it, ++i) {
+    std::map<std::string, const vpImage<unsigned char> *>::const_iterator it_img = mapOfImages.find(it->first);
+
+    m_cameraStages[i].name = it->first;
+    m_cameraStages[i].tracker = it->second;
+    m_cameraStages[i].image = it_img != mapOfImages.end() ? it_img->second : NULL;
+  }
+}
+
 void vpMbEdgeMultiTracker::initPyramid(const std::map<std::string, const vpImage<unsigned char> * >& mapOfImages,
-    std::map<std::string, std::vector<const vpImage<unsigned char>* > >& pyramid)
+    std::map<std::string, vpMbtImagePyramid>& pyramid)
 {
   for(std::map<std::string, const vpImage<unsigned char> * >::const_iterator it = mapOfImages.begin();
       it != mapOfImages.end(); ++it) {
-    pyramid[it->first].resize(scales.size());
-
     vpMbEdgeTracker::initPyramid(*it->second, pyramid[it->first]);
   }
 }
@@ -1976,6 +2046,22 @@ void vpMbEdgeMultiTracker::reInitModel(const std::map<std::string, const vpImage
   }
 }
 
+/*!
+  Save in a binary file the model loaded by the tracker of the reference
+  camera, see vpMbTracker::saveCompiledModel().
+
+  \param compiledModelFile : Name of the compiled model file.
+*/
+void vpMbEdgeMultiTracker::saveCompiledModel(const std::string &compiledModelFile) const {
+  std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.find(m_referenceCameraName);
+  if(it != m_mapOfEdgeTrackers.end()) {
+    it->second->saveCompiledModel(compiledModelFile);
+  } else {
+    throw vpException(vpTrackingException::fatalError, "Cannot find the reference camera: %s !",
+                      m_referenceCameraName.c_str());
+  }
+}
+
 /*!
   Reset the tracker. The model is removed and the pose is set to identity.
   The tracker needs to be initialized with a new model and a new pose.
@@ -2012,6 +2098,122 @@ void vpMbEdgeMultiTracker::resetTracker() {
   this->setScales(scales);
 }
 
+/*!
+  Reset the rendering time of the scanline visibility test of all the cameras.
+*/
+void vpMbEdgeMultiTracker::resetScanLineRenderingTime() {
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->resetScanLineRenderingTime();
+  }
+}
+
+/*!
+  Run the current stage for one camera.
+
+  \param index : Index of the camera in the per-camera stage data.
+*/
+void vpMbEdgeMultiTracker::runCameraStage(const unsigned int index) {
+  double t = vpTime::measureTimeMs();
+
+  vpCameraStageData &data = m_cameraStages[index];
+  vpMbEdgeTracker *tracker = data.tracker;
+
+  switch(m_cameraStage) {
+  case TRACK_MOVING_EDGE:
+    tracker->trackMovingEdge(*data.image);
+    break;
+
+  case VVS_FIRST_PHASE:
+    data.L.resize(data.nbRows, 6);
+    data.count = 0.0;
+    tracker->computeVVSFirstPhase(*data.image, m_cameraStageIteration, data.L, *data.factor, data.count,
+        tracker->m_error, tracker->m_w, m_cameraStageLevel);
+    break;
+
+  case VVS_SECOND_PHASE:
+    data.L.resize(data.nbRows, 6);
+    data.error.resize(data.nbRows);
+    data.errorLines.resize(data.nbLines);
+    data.errorCylinders.resize(data.nbCylinders);
+    data.errorCircles.resize(data.nbCircles);
+    tracker->computeVVSSecondPhase(*data.image, data.L, data.errorLines, data.errorCylinders, data.errorCircles,
+        data.error, m_cameraStageLevel);
+    break;
+
+  case UPDATE_MOVING_EDGE: {
+    bool newvisibleface = false;
+    tracker->visibleFace(*data.image, tracker->cMo, newvisibleface);
+
+    if(useScanLine) {
+      tracker->faces.computeClippedPolygons(tracker->cMo, tracker->cam);
+      tracker->faces.computeScanLineRender(tracker->cam, data.image->getWidth(), data.image->getHeight());
+    }
+
+    tracker->updateMovingEdge(*data.image);
+
+    tracker->initMovingEdge(*data.image, tracker->cMo);
+
+    // Reinit the moving edge for the lines which need it.
+    tracker->reinitMovingEdge(*data.image, tracker->cMo);
+
+    if(computeProjError) {
+      //Compute the projection error
+      tracker->computeProjectionError(*data.image);
+    }
+    break;
+  }
+
+  default:
+    break;
+  }
+
+  data.time = vpTime::measureTimeMs() - t;
+}
+
+/*!
+  Run a stage for all the cameras, concurrently if setUseParallelCameraTracking()
+  is enabled. The trackers and the images must have been set with initCameraStages().
+
+  The update of the moving edges is run serially when the visibility test uses
+  Ogre or when the features are displayed. When the cameras are run
+  concurrently, an exception thrown for a camera is forwarded by
+  vpThreadPool::parallel_for() with its type and code.
+
+  \param stage : Stage to run.
+  \param lvl : Level of the pyramid.
+  \param iter : Iteration of the virtual visual servoing.
+*/
+void vpMbEdgeMultiTracker::runCameraStages(const CameraStage stage, const unsigned int lvl, const unsigned int iter) {
+  m_cameraStage = stage;
+  m_cameraStageLevel = lvl;
+  m_cameraStageIteration = iter;
+
+  bool parallel = m_useParallelCameraTracking && m_cameraStages.size() > 1;
+  if(parallel && stage == UPDATE_MOVING_EDGE) {
+    // The visibility test with Ogre and the displays are not thread-safe
+    for(size_t i = 0; i < m_cameraStages.size(); i++) {
+      if(m_cameraStages[i].tracker->useOgre || m_cameraStages[i].tracker->displayFeatures) {
+        parallel = false;
+        break;
+      }
+    }
+  }
+
+  if(parallel) {
+    vpMbEdgeMultiTrackerCameraTask task(*this);
+    vpThreadPool::parallel_for(0, (unsigned int) m_cameraStages.size(), task, 1);
+  } else {
+    for(unsigned int i = 0; i < m_cameraStages.size(); i++) {
+      runCameraStage(i);
+    }
+  }
+
+  for(size_t i = 0; i < m_cameraStages.size(); i++) {
+    m_mapOfCameraTrackingTimes[m_cameraStages[i].name] += m_cameraStages[i].time;
+  }
+}
+
 /*!
   Set the angle used to test polygons appearance.
   If the angle between the normal of the polygon and the line going
@@ -2235,6 +2437,21 @@ void vpMbEdgeMultiTracker::setCovarianceComputation(const bool& flag) {
   }
 }
 
+/*!
+  Use a bounding volume hierarchy and a low resolution depth buffer to remove
+  the faces that are out of the field of view or hidden by other faces.
+
+  \param v : True to use it, False otherwise
+*/
+void vpMbEdgeMultiTracker::setDepthBufferVisibilityTest(const bool &v) {
+  vpMbTracker::setDepthBufferVisibilityTest(v);
+
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->setDepthBufferVisibilityTest(v);
+  }
+}
+
 /*!
   Enable to display the features. By features, we mean the moving edges (ME) and the klt points if used.
 
@@ -2730,6 +2947,21 @@ void vpMbEdgeMultiTracker::setProjectionErrorComputation(const bool &flag) {
   }
 }
 
+/*!
+  Set the filter used to compute the levels of the pyramid for all the cameras.
+
+  \param filter : Filter used to compute the pyramid.
+
+  \sa vpMbEdgeTracker::getPyramidFilter()
+*/
+void vpMbEdgeMultiTracker::setPyramidFilter(const vpMbtImagePyramid::vpPyramidFilterType filter) {
+  vpMbEdgeTracker::setPyramidFilter(filter);
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->setPyramidFilter(filter);
+  }
+}
+
 /*!
   Set the reference camera name.
 
@@ -2774,6 +3006,35 @@ void vpMbEdgeMultiTracker::setScales(const std::vector<bool>& scale) {
   }
 }
 
+/*!
+  Render the bands of scanlines of the scanline visibility test in parallel.
+
+  \param v : True to render the bands in parallel, False otherwise
+*/
+void vpMbEdgeMultiTracker::setScanLineParallelRendering(const bool &v) {
+  vpMbTracker::setScanLineParallelRendering(v);
+
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->setScanLineParallelRendering(v);
+  }
+}
+
+/*!
+  Set the displacement in pixel under which a face is not rendered again by
+  the scanline visibility test.
+
+  \param threshold : Displacement in pixel.
+*/
+void vpMbEdgeMultiTracker::setScanLineReuseThreshold(const double &threshold) {
+  vpMbTracker::setScanLineReuseThreshold(threshold);
+
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->setScanLineReuseThreshold(threshold);
+  }
+}
+
 /*!
   Use Scanline algorithm for visibility tests
 
@@ -2802,6 +3063,37 @@ void vpMbEdgeMultiTracker::setUseEdgeTracking(const std::string &name, const boo
   }
 }
 
+/*!
+  Enable or disable the concurrent execution of the per-camera stages of track():
+  moving-edge tracking, interaction matrix construction, visibility and update of
+  the moving edges. The cameras are only synchronised for the joint pose update.
+  The result is the same as with the sequential execution. Since Ogre and the
+  displays are not thread-safe, the visibility and update of the moving edges
+  stay sequential when setOgreVisibilityTest() or setDisplayFeatures() is enabled.
+
+  \param use : True to run the stages of each camera in parallel with vpThreadPool.
+
+  \sa getCameraTrackingTimes()
+*/
+void vpMbEdgeMultiTracker::setUseParallelCameraTracking(const bool use) {
+  m_useParallelCameraTracking = use;
+}
+
+/*!
+  Enable or disable the parallel tracking of the moving edges for all the cameras.
+
+  \param use : True to track the features of each camera in parallel.
+
+  \sa vpMbEdgeTracker::setUseParallelMovingEdge()
+*/
+void vpMbEdgeMultiTracker::setUseParallelMovingEdge(const bool use) {
+  vpMbEdgeTracker::setUseParallelMovingEdge(use);
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->setUseParallelMovingEdge(use);
+  }
+}
+
 /*!
   Compute each state of the tracking procedure for all the feature sets.
 
@@ -2875,6 +3167,12 @@ void vpMbEdgeMultiTracker::track(std::map<std::string, const vpImage<unsigned ch
 
   initPyramid(mapOfImages, m_mapOfPyramidalImages);
 
+  m_mapOfCameraTrackingTimes.clear();
+  for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    m_mapOfCameraTrackingTimes[it->first] = 0.0;
+  }
+
   unsigned int lvl = (unsigned int) scales.size();
   do {
     lvl--;
@@ -2885,28 +3183,29 @@ void vpMbEdgeMultiTracker::track(std::map<std::string, const vpImage<unsigned ch
       vpHomogeneousMatrix cMo_1 = cMo;
       try
       {
+        std::map<std::string, const vpImage<unsigned char> *> mapOfPyramidImages;
+        for(std::map<std::string, vpMbtImagePyramid>::const_iterator
+            it = m_mapOfPyramidalImages.begin(); it != m_mapOfPyramidalImages.end(); ++it) {
+          mapOfPyramidImages[it->first] = it->second[lvl];
+        }
+
         downScale(lvl);
         for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it1 = m_mapOfEdgeTrackers.begin();
             it1 != m_mapOfEdgeTrackers.end(); ++it1) {
           //Downscale for each camera
           it1->second->downScale(lvl);
-
-          //Track moving edges
-          try {
-            it1->second->trackMovingEdge(*m_mapOfPyramidalImages[it1->first][lvl]);
-          } catch(...) {
-            vpTRACE("Error in moving edge tracking") ;
-            throw ;
-          }
         }
 
+        //Track moving edges
         try {
-          std::map<std::string, const vpImage<unsigned char> *> mapOfPyramidImages;
-          for(std::map<std::string, std::vector<const vpImage<unsigned char>* > >::const_iterator
-              it = m_mapOfPyramidalImages.begin(); it != m_mapOfPyramidalImages.end(); ++it) {
-            mapOfPyramidImages[it->first] = it->second[lvl];
-          }
+          initCameraStages(mapOfPyramidImages);
+          runCameraStages(TRACK_MOVING_EDGE, lvl);
+        } catch(...) {
+          vpTRACE("Error in moving edge tracking") ;
+          throw ;
+        }
 
+        try {
           computeVVS(mapOfPyramidImages, lvl);
         } catch(...) {
           covarianceMatrix = -1;
@@ -2944,43 +3243,9 @@ void vpMbEdgeMultiTracker::track(std::map<std::string, const vpImage<unsigned ch
           }
         }
 
-        // Looking for new visible face
-        bool newvisibleface = false;
-        for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-            it != m_mapOfEdgeTrackers.end(); ++it) {
-          it->second->visibleFace(*mapOfImages[it->first], it->second->cMo, newvisibleface);
-        }
-
-        if(useScanLine) {
-          for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-                      it != m_mapOfEdgeTrackers.end(); ++it) {
-            it->second->faces.computeClippedPolygons(it->second->cMo, it->second->cam);
-            it->second->faces.computeScanLineRender(it->second->cam, mapOfImages[it->first]->getWidth(),
-                mapOfImages[it->first]->getHeight());
-          }
-        }
-
-        try {
-          for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-                      it != m_mapOfEdgeTrackers.end(); ++it) {
-            it->second->updateMovingEdge(*mapOfImages[it->first]);
-          }
-        } catch(...) {
-          throw; // throw the original exception
-        }
-
-        for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-            it != m_mapOfEdgeTrackers.end(); ++it) {
-          it->second->initMovingEdge(*mapOfImages[it->first], it->second->cMo);
-
-          // Reinit the moving edge for the lines which need it.
-          it->second->reinitMovingEdge(*mapOfImages[it->first], it->second->cMo);
-
-          if(computeProjError) {
-            //Compute the projection error
-            it->second->computeProjectionError(*mapOfImages[it->first]);
-          }
-        }
+        // Looking for new visible face, update and reinit the moving edges
+        initCameraStages(mapOfImages);
+        runCameraStages(UPDATE_MOVING_EDGE, lvl);
 
         computeProjectionError();
 
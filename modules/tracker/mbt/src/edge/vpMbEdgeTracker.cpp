@@ -56,13 +56,62 @@
 #include <visp3/mbt/vpMbtXmlParser.h>
 #include <visp3/core/vpPolygon3D.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
+#include <visp3/core/vpThreadPool.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <string>
 #include <sstream>
 #include <float.h>
 #include <map>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Size of the cells of the grid used to index the extremities of the lines in
+// addLine().
+const double vpLineCellSize = 1e-4;
+
+// Track the moving edges of a range of features. Each feature only reads the
+// image and modifies its own moving edges, so that the features can be
+// processed in any order and by any thread.
+class vpMbtMovingEdgeTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpMbtMovingEdgeTask(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo,
+                      const std::vector<vpMbtDistanceLine *> &lines,
+                      const std::vector<vpMbtDistanceCylinder *> &cylinders,
+                      const std::vector<vpMbtDistanceCircle *> &circles)
+    : m_I(I), m_cMo(cMo), m_lines(lines), m_cylinders(cylinders), m_circles(circles)
+  {}
+
+  void run(unsigned int start, unsigned int end)
+  {
+    const unsigned int nbLines = (unsigned int)m_lines.size();
+    const unsigned int nbCylinders = (unsigned int)m_cylinders.size();
+    for (unsigned int k = start; k < end; k++) {
+      if (k < nbLines)
+        m_lines[k]->trackMovingEdge(m_I, m_cMo);
+      else if (k < nbLines + nbCylinders)
+        m_cylinders[k - nbLines]->trackMovingEdge(m_I, m_cMo);
+      else
+        m_circles[k - nbLines - nbCylinders]->trackMovingEdge(m_I, m_cMo);
+    }
+  }
+
+private:
+  const vpImage<unsigned char> &m_I;
+  const vpHomogeneousMatrix &m_cMo;
+  const std::vector<vpMbtDistanceLine *> &m_lines;
+  const std::vector<vpMbtDistanceCylinder *> &m_cylinders;
+  const std::vector<vpMbtDistanceCircle *> &m_circles;
+
+  vpMbtMovingEdgeTask &operator=(const vpMbtMovingEdgeTask &);
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 /*!
   Basic constructor
@@ -70,7 +119,8 @@
 vpMbEdgeTracker::vpMbEdgeTracker()
   : compute_interaction(1), lambda(1), me(), lines(1), circles(1), cylinders(1), nline(0), ncircle(0), ncylinder(0),
     nbvisiblepolygone(0), percentageGdPt(0.4), scales(1),
-    Ipyramid(0), scaleLevel(0), nbFeaturesForProjErrorComputation(0)
+    Ipyramid(), pyramidFilter(vpMbtImagePyramid::NEAREST_FILTER), useParallelMovingEdge(false), scaleLevel(0),
+    nbFeaturesForProjErrorComputation(0), lineIndex(), lineIndexUpToDate()
 {
   angleAppears = vpMath::rad(89);
   angleDisappears = vpMath::rad(89);
@@ -110,6 +160,7 @@ vpMbEdgeTracker::~vpMbEdgeTracker()
       }
 
       lines[i].clear();
+      invalidateLineIndex(i);
       cylinders[i].clear();
     }
   }
@@ -1720,12 +1771,58 @@ vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHomogen
 
 /*!
   Track the moving edges in the image.
+
+  When setUseParallelMovingEdge() is enabled, the moving edges that have to
+  be initialized are first created sequentially, since the initialization
+  modifies temporarily the moving edges parameters shared by all the
+  features. The features are then tracked in parallel.
   
   \param I : the image.
 */
 void
 vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 {
+  if (useParallelMovingEdge) {
+    std::vector<vpMbtDistanceLine *> trackedLines;
+    std::vector<vpMbtDistanceCylinder *> trackedCylinders;
+    std::vector<vpMbtDistanceCircle *> trackedCircles;
+
+    for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
+      vpMbtDistanceLine *l = *it;
+      if(l->isVisible() && l->isTracked()){
+        if(l->meline.size() == 0){
+          l->initMovingEdge(I, cMo);
+        }
+        trackedLines.push_back(l);
+      }
+    }
+
+    for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[scaleLevel].begin(); it!=cylinders[scaleLevel].end(); ++it){
+      vpMbtDistanceCylinder *cy = *it;
+      if(cy->isVisible() && cy->isTracked()) {
+        if(cy->meline1 == NULL || cy->meline2 == NULL){
+          cy->initMovingEdge(I, cMo);
+        }
+        trackedCylinders.push_back(cy);
+      }
+    }
+
+    for(std::list<vpMbtDistanceCircle*>::const_iterator it=circles[scaleLevel].begin(); it!=circles[scaleLevel].end(); ++it){
+      vpMbtDistanceCircle *ci = *it;
+      if(ci->isVisible() && ci->isTracked()){
+        if(ci->meEllipse == NULL){
+          ci->initMovingEdge(I, cMo);
+        }
+        trackedCircles.push_back(ci);
+      }
+    }
+
+    vpMbtMovingEdgeTask task(I, cMo, trackedLines, trackedCylinders, trackedCircles);
+    vpThreadPool::parallel_for(0, (unsigned int)(trackedLines.size() + trackedCylinders.size() + trackedCircles.size()),
+                               task, 1);
+    return;
+  }
+
   for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
     vpMbtDistanceLine *l = *it;
     if(l->isVisible() && l->isTracked()){
@@ -2073,7 +2170,30 @@ vpMbEdgeTracker::addLine(vpPoint &P1, vpPoint &P2, int polygon, std::string name
   for (unsigned int i = 0; i < scales.size(); i += 1){
     if(scales[i]){
       downScale(i);
-      for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[i].begin(); it!=lines[i].end(); ++it){
+
+      // A line already in the model has an extremity similar to P1 (see samePoint()), look for it in the
+      // cells of the index that P1 can fall in.
+      updateLineIndex(i);
+      const double eps = std::numeric_limits<double>::epsilon();
+      const double X[2] = { std::floor((P1.get_oX()-eps) / vpLineCellSize), std::floor((P1.get_oX()+eps) / vpLineCellSize) };
+      const double Y[2] = { std::floor((P1.get_oY()-eps) / vpLineCellSize), std::floor((P1.get_oY()+eps) / vpLineCellSize) };
+      const double Z[2] = { std::floor((P1.get_oZ()-eps) / vpLineCellSize), std::floor((P1.get_oZ()+eps) / vpLineCellSize) };
+      std::vector<vpMbtDistanceLine*> candidates;
+      for (double cx = X[0]; cx <= X[1]; cx += 1.) {
+        for (double cy = Y[0]; cy <= Y[1]; cy += 1.) {
+          for (double cz = Z[0]; cz <= Z[1]; cz += 1.) {
+            std::map<vpLineCell, std::vector<vpMbtDistanceLine*> >::const_iterator it_cell =
+                lineIndex[i].find(vpLineCell(cx, std::pair<double, double>(cy, cz)));
+            if (it_cell != lineIndex[i].end()) {
+              candidates.insert(candidates.end(), it_cell->second.begin(), it_cell->second.end());
+            }
+          }
+        }
+      }
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+      for(std::vector<vpMbtDistanceLine*>::const_iterator it=candidates.begin(); it!=candidates.end(); ++it){
         l = *it;
         if((samePoint(*(l->p1),P1) && samePoint(*(l->p2),P2)) ||
            (samePoint(*(l->p1),P2) && samePoint(*(l->p2),P1)) ){
@@ -2107,12 +2227,72 @@ vpMbEdgeTracker::addLine(vpPoint &P1, vpPoint &P2, int polygon, std::string name
         
         nline +=1 ;
         lines[i].push_back(l);
+        indexLine(i, l);
       }
       upScale(i);
     }
   }
 }
 
+/*!
+  Add the line \e l of the scale level \e scale to the cells of the index that
+  contain its extremities.
+
+  \param scale : Scale level of the line.
+  \param l : The line to index.
+*/
+void
+vpMbEdgeTracker::indexLine(const unsigned int scale, vpMbtDistanceLine *l)
+{
+  const vpPoint *P[2] = { l->p1, l->p2 };
+  for (unsigned int j = 0; j < 2; j++) {
+    vpLineCell cell(std::floor(P[j]->get_oX() / vpLineCellSize),
+                    std::pair<double, double>(std::floor(P[j]->get_oY() / vpLineCellSize),
+                                              std::floor(P[j]->get_oZ() / vpLineCellSize)));
+    std::vector<vpMbtDistanceLine*> &cellLines = lineIndex[scale][cell];
+    if (cellLines.empty() || cellLines.back() != l)
+      cellLines.push_back(l);
+  }
+}
+
+/*!
+  Mark the index of the lines of the scale level \e scale as out of date. It
+  has to be called each time lines are removed from lines[scale].
+
+  \param scale : Scale level of the lines.
+*/
+void
+vpMbEdgeTracker::invalidateLineIndex(const unsigned int scale)
+{
+  if (scale < lineIndex.size()) {
+    lineIndex[scale].clear();
+    lineIndexUpToDate[scale] = false;
+  }
+}
+
+/*!
+  Rebuild the index of the lines of the scale level \e scale if it has been
+  invalidated with invalidateLineIndex().
+
+  \param scale : Scale level of the lines.
+*/
+void
+vpMbEdgeTracker::updateLineIndex(const unsigned int scale)
+{
+  if (lineIndex.size() != scales.size()) {
+    lineIndex.resize(scales.size());
+    lineIndexUpToDate.resize(scales.size(), false);
+  }
+
+  if (lineIndexUpToDate[scale])
+    return;
+
+  lineIndex[scale].clear();
+  for (std::list<vpMbtDistanceLine*>::const_iterator it = lines[scale].begin(); it != lines[scale].end(); ++it)
+    indexLine(scale, *it);
+  lineIndexUpToDate[scale] = true;
+}
+
 /*!
   Remove a line using its name. 
   
@@ -2129,6 +2309,7 @@ vpMbEdgeTracker::removeLine(const std::string& name)
         l = *it;
         if (name.compare(l->getName()) == 0){
           lines[i].erase(it);
+          invalidateLineIndex(i);
           break;
         }
       }
@@ -2494,6 +2675,7 @@ vpMbEdgeTracker::resetTracker()
         ci = NULL;
       }
       lines[i].clear();
+      invalidateLineIndex(i);
       cylinders[i].clear();
       circles[i].clear();
     }
@@ -2579,6 +2761,7 @@ vpMbEdgeTracker::reInitModel(const vpImage<unsigned char>& I, const char* cad_na
       }
 
       lines[i].clear();
+      invalidateLineIndex(i);
       cylinders[i].clear();
       circles[i].clear();
     }
@@ -2692,6 +2875,7 @@ vpMbEdgeTracker::setScales(const std::vector<bool>& scale)
     this->scales.push_back(true);
     lines.resize(1);
     lines[0].clear();
+    invalidateLineIndex(0);
     cylinders.resize(1);
     cylinders[0].clear();
   }
@@ -2701,6 +2885,7 @@ vpMbEdgeTracker::setScales(const std::vector<bool>& scale)
     cylinders.resize(scale.size());
     for (unsigned int i = 0; i < lines.size(); i += 1){
       lines[i].clear();
+      invalidateLineIndex(i);
       cylinders[i].clear();
     }
   }
@@ -2785,78 +2970,33 @@ vpMbEdgeTracker::setClipping(const unsigned int &flags)
 }
 
 /*!
-  Compute the pyramid of image associated to the image in parameter. The scales 
-  computed are the ones corresponding to the scales  attribute of the class. If 
-  OpenCV is detected, the functions used to computed a smoothed pyramid come 
-  from OpenCV, otherwise a simple subsampling (no smoothing, no interpolation) 
-  is realized. 
-  
-  \warning The pyramid contains pointers to vpImage. To properly deallocate the
-  pyramid. All the element but the first (which is a pointer to the input image)
-  must be freed. A proper cleaning is implemented in the cleanPyramid() method. 
-  
+  Compute the pyramid of image associated to the image in parameter. The scales
+  computed are the ones corresponding to the scales attribute of the class. The
+  filter used for the decimation is given by setPyramidFilter().
+
+  The images of the pyramid are kept from one call to the next one and are only
+  reallocated when the size of the input image or the scales change.
+
   \param _I : The input image.
   \param _pyramid : The pyramid of image to build from the input image.
 */
 void 
-vpMbEdgeTracker::initPyramid(const vpImage<unsigned char>& _I, std::vector< const vpImage<unsigned char>* >& _pyramid)
+vpMbEdgeTracker::initPyramid(const vpImage<unsigned char>& _I, vpMbtImagePyramid& _pyramid)
 {
-  _pyramid.resize(scales.size());
-  
-  if(scales[0]){
-    _pyramid[0] = &_I;
-  }
-  else{
-    _pyramid[0] = NULL;
-  }
-  
-  for(unsigned int i=1; i<_pyramid.size(); i += 1){
-    if(scales[i]){
-      unsigned int cScale = static_cast<unsigned int>(pow(2., (int)i));
-      vpImage<unsigned char>* I = new vpImage<unsigned char>(_I.getHeight() / cScale, _I.getWidth() / cScale);
-#if (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408))
-      IplImage* vpI0 = cvCreateImageHeader(cvSize((int)_I.getWidth(), (int)_I.getHeight()), IPL_DEPTH_8U, 1);
-      vpI0->imageData = (char*)(_I.bitmap);
-      IplImage* vpI = cvCreateImage(cvSize((int)(_I.getWidth() / cScale), (int)(_I.getHeight() / cScale)), IPL_DEPTH_8U, 1);
-      cvResize(vpI0, vpI, CV_INTER_NN);
-      vpImageConvert::convert(vpI, *I);
-      cvReleaseImage(&vpI);  
-      vpI0->imageData = NULL;
-      cvReleaseImageHeader(&vpI0);    
-#else
-      for (unsigned int k = 0, ii = 0; k < I->getHeight(); k += 1, ii += cScale){
-        for (unsigned int l = 0, jj = 0; l < I->getWidth(); l += 1, jj += cScale){
-          (*I)[k][l] = _I[ii][jj];
-        }
-      }
-#endif   
-      _pyramid[i] = I;
-    }
-    else{
-      _pyramid[i] = NULL;
-    }
-  }
+  _pyramid.build(_I, scales, pyramidFilter);
 }
 
 /*!
-  Clean the pyramid of image allocated with the initPyramid() method. The vector
-  has a size equal to zero at the end of the method. 
+  Release the input image referenced by a pyramid built with the initPyramid()
+  method. The memory of the other levels is kept to be reused with the next
+  image.
   
   \param _pyramid : The pyramid of image to clean.
 */
 void 
-vpMbEdgeTracker::cleanPyramid(std::vector< const vpImage<unsigned char>* >& _pyramid)
+vpMbEdgeTracker::cleanPyramid(vpMbtImagePyramid& _pyramid)
 {
-  if(_pyramid.size() > 0){
-    _pyramid[0] = NULL;
-    for (unsigned int i = 1; i < _pyramid.size(); i += 1){
-      if(_pyramid[i] != NULL){
-        delete _pyramid[i];
-        _pyramid[i] = NULL;
-      }
-    }
-    _pyramid.resize(0);
-  }
+  _pyramid.clear();
 }
 
 /*!
@@ -817,6 +817,24 @@ std::vector<std::string> vpMbEdgeKltMultiTracker::getCameraNames() const {
   return vpMbEdgeMultiTracker::getCameraNames();
 }
 
+/*!
+  Get the time spent by each camera in the per-camera stages of the last call
+  to track(), for the moving edges and the KLT points.
+
+  \param mapOfTimes : Map of the times in ms.
+
+  \sa setUseParallelCameraTracking()
+*/
+void vpMbEdgeKltMultiTracker::getCameraTrackingTimes(std::map<std::string, double> &mapOfTimes) const {
+  vpMbEdgeMultiTracker::getCameraTrackingTimes(mapOfTimes);
+
+  std::map<std::string, double> mapOfKltTimes;
+  vpMbKltMultiTracker::getCameraTrackingTimes(mapOfKltTimes);
+  for(std::map<std::string, double>::const_iterator it = mapOfKltTimes.begin(); it != mapOfKltTimes.end(); ++it) {
+    mapOfTimes[it->first] += it->second;
+  }
+}
+
 /*!
   Get the camera parameters for the reference camera.
 
@@ -985,6 +1003,16 @@ void vpMbEdgeKltMultiTracker::getPose(std::map<std::string, vpHomogeneousMatrix>
   vpMbEdgeMultiTracker::getPose(mapOfCameraPoses);
 }
 
+/*!
+  Get the time in ms spent to render the scene of the scanline visibility test
+  by all the cameras since the last call of resetScanLineRenderingTime().
+
+  \return The rendering time in ms.
+*/
+double vpMbEdgeKltMultiTracker::getScanLineRenderingTime() const {
+  return vpMbEdgeMultiTracker::getScanLineRenderingTime() + vpMbKltMultiTracker::getScanLineRenderingTime();
+}
+
 void vpMbEdgeKltMultiTracker::init(const vpImage<unsigned char>& /*I*/) {
   if(!modelInitialised){
     throw vpException(vpTrackingException::initializationError, "model not initialized");
@@ -1478,42 +1506,9 @@ void vpMbEdgeKltMultiTracker::postTracking(std::map<std::string, const vpImage<u
   //KLT
   vpMbKltMultiTracker::postTracking(mapOfImages, mapOfNbInfos, w_klt);
 
-  // Looking for new visible face
-  bool newvisibleface = false;
-  for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-      it != m_mapOfEdgeTrackers.end(); ++it) {
-    it->second->visibleFace(*mapOfImages[it->first], it->second->cMo, newvisibleface);
-  }
-
-  if(useScanLine) {
-    for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-                it != m_mapOfEdgeTrackers.end(); ++it) {
-      it->second->faces.computeClippedPolygons(it->second->cMo, it->second->cam);
-      it->second->faces.computeScanLineRender(it->second->cam, mapOfImages[it->first]->getWidth(),
-          mapOfImages[it->first]->getHeight());
-    }
-  }
-
-  try {
-    for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-                it != m_mapOfEdgeTrackers.end(); ++it) {
-      it->second->updateMovingEdge(*mapOfImages[it->first]);
-    }
-  } catch(vpException &e) {
-    throw e;
-  }
-
-  for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-      it != m_mapOfEdgeTrackers.end(); ++it) {
-    it->second->initMovingEdge(*mapOfImages[it->first], it->second->cMo);
-
-    // Reinit the moving edge for the lines which need it.
-    it->second->reinitMovingEdge(*mapOfImages[it->first], it->second->cMo);
-
-    if(computeProjError) {
-      it->second->computeProjectionError(*mapOfImages[it->first]);
-    }
-  }
+  // Looking for new visible face, update and reinit the moving edges
+  initCameraStages(mapOfImages);
+  runCameraStages(UPDATE_MOVING_EDGE, lvl);
 }
 
 void vpMbEdgeKltMultiTracker::reinit(/*const vpImage<unsigned char>& I */) {
@@ -1580,6 +1575,24 @@ void vpMbEdgeKltMultiTracker::resetTracker() {
   vpMbKltMultiTracker::resetTracker();
 }
 
+/*!
+  Reset the rendering time of the scanline visibility test of all the cameras.
+*/
+void vpMbEdgeKltMultiTracker::resetScanLineRenderingTime() {
+  vpMbEdgeMultiTracker::resetScanLineRenderingTime();
+  vpMbKltMultiTracker::resetScanLineRenderingTime();
+}
+
+/*!
+  Save in a binary file the model loaded by the trackers of the reference
+  camera, see vpMbTracker::saveCompiledModel().
+
+  \param compiledModelFile : Name of the compiled model file.
+*/
+void vpMbEdgeKltMultiTracker::saveCompiledModel(const std::string &compiledModelFile) const {
+  vpMbEdgeMultiTracker::saveCompiledModel(compiledModelFile);
+}
+
 /*!
   Set the angle used to test polygons appearance.
   If the angle between the normal of the polygon and the line going
@@ -1740,6 +1753,28 @@ void vpMbEdgeKltMultiTracker::setCovarianceComputation(const bool& flag) {
   vpMbKltMultiTracker::setCovarianceComputation(flag);
 }
 
+/*!
+  Use a bounding volume hierarchy and a low resolution depth buffer to remove
+  the faces that are out of the field of view or hidden by other faces.
+
+  \param v : True to use it, False otherwise
+*/
+void vpMbEdgeKltMultiTracker::setDepthBufferVisibilityTest(const bool &v) {
+  vpMbTracker::setDepthBufferVisibilityTest(v);
+
+  //Edge
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->setDepthBufferVisibilityTest(v);
+  }
+
+  //KLT
+  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it) {
+    it->second->setDepthBufferVisibilityTest(v);
+  }
+}
+
 /*!
   Enable to display the moving edges (ME) and the klt features.
 
@@ -2069,6 +2104,27 @@ void vpMbEdgeKltMultiTracker::setReferenceCameraName(const std::string &referenc
   m_referenceCameraName = referenceCameraName;
 }
 
+/*!
+  Render the bands of scanlines of the scanline visibility test in parallel.
+
+  \param v : True to render the bands in parallel, False otherwise
+*/
+void vpMbEdgeKltMultiTracker::setScanLineParallelRendering(const bool &v) {
+  vpMbEdgeMultiTracker::setScanLineParallelRendering(v);
+  vpMbKltMultiTracker::setScanLineParallelRendering(v);
+}
+
+/*!
+  Set the displacement in pixel under which a face is not rendered again by
+  the scanline visibility test.
+
+  \param threshold : Displacement in pixel.
+*/
+void vpMbEdgeKltMultiTracker::setScanLineReuseThreshold(const double &threshold) {
+  vpMbEdgeMultiTracker::setScanLineReuseThreshold(threshold);
+  vpMbKltMultiTracker::setScanLineReuseThreshold(threshold);
+}
+
 /*!
   Use Scanline algorithm for visibility tests
 
@@ -2088,6 +2144,20 @@ void vpMbEdgeKltMultiTracker::setThresholdAcceptation(const double th) {
   vpMbKltMultiTracker::setThresholdAcceptation(th);
 }
 
+/*!
+  Enable or disable the concurrent execution of the per-camera stages of track()
+  for the moving edges and the KLT points. The cameras are only synchronised for
+  the joint pose update.
+
+  \param use : True to run the stages of each camera in parallel with vpThreadPool.
+
+  \sa getCameraTrackingTimes()
+*/
+void vpMbEdgeKltMultiTracker::setUseParallelCameraTracking(const bool use) {
+  vpMbEdgeMultiTracker::setUseParallelCameraTracking(use);
+  vpMbKltMultiTracker::setUseParallelCameraTracking(use);
+}
+
 void vpMbEdgeKltMultiTracker::testTracking() {
   std::cerr << "The method vpMbEdgeKltMultiTracker::testTracking is not used !" << std::endl;
 }
@@ -2181,6 +2251,9 @@ void vpMbEdgeKltMultiTracker::track(std::map<std::string, const vpImage<unsigned
   std::map<std::string, unsigned int> mapOfNbInfos;
   std::map<std::string, unsigned int> mapOfNbFaceUsed;
 
+  vpMbEdgeMultiTracker::m_mapOfCameraTrackingTimes.clear();
+  vpMbKltMultiTracker::m_mapOfCameraTrackingTimes.clear();
+
   try {
     vpMbKltMultiTracker::preTracking(mapOfImages, mapOfNbInfos, mapOfNbFaceUsed);
   } catch(/*vpException &e*/...) {
@@ -2237,15 +2310,13 @@ unsigned int vpMbEdgeKltMultiTracker::trackFirstLoop(std::map<std::string, const
 }
 
 void vpMbEdgeKltMultiTracker::trackMovingEdges(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages) {
-  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it1 = m_mapOfEdgeTrackers.begin();
-      it1 != m_mapOfEdgeTrackers.end(); ++it1) {
-    //Track moving edges
-    try {
-      it1->second->trackMovingEdge(*mapOfImages[it1->first]);
-    } catch(...) {
-      std::cerr << "Error in moving edge tracking" << std::endl;
-      throw ;
-    }
+  //Track moving edges
+  try {
+    initCameraStages(mapOfImages);
+    runCameraStages(TRACK_MOVING_EDGE, 0);
+  } catch(...) {
+    std::cerr << "Error in moving edge tracking" << std::endl;
+    throw ;
   }
 }
 
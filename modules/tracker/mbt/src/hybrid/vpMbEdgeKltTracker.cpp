@@ -1371,6 +1371,7 @@ vpMbEdgeKltTracker::reInitModel(const vpImage<unsigned char>& I, const char* cad
       }
 
       lines[i].clear();
+      invalidateLineIndex(i);
       cylinders[i].clear();
       circles[i].clear();
     }
@@ -46,16 +46,41 @@
 
 #if (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
 #include <visp3/mbt/vpMbKltMultiTracker.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// Run the current per-camera stage of a vpMbKltMultiTracker for a range of cameras
+class vpMbKltMultiTrackerCameraTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpMbKltMultiTrackerCameraTask(vpMbKltMultiTracker &tracker) : m_tracker(tracker) {}
+
+  void run(unsigned int start, unsigned int end)
+  {
+    for (unsigned int i = start; i < end; i++)
+      m_tracker.runKltCameraStage(i);
+  }
+
+private:
+  vpMbKltMultiTracker &m_tracker;
+
+  vpMbKltMultiTrackerCameraTask &operator=(const vpMbKltMultiTrackerCameraTask &);
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 /*!
   Basic constructor
 */
 vpMbKltMultiTracker::vpMbKltMultiTracker() : m_mapOfCameraTransformationMatrix(), m_mapOfKltTrackers(),
-    m_referenceCameraName("Camera") {
+    m_referenceCameraName("Camera"), m_useParallelCameraTracking(false), m_mapOfCameraTrackingTimes(),
+    m_kltCameraStages(), m_kltCameraStage(KLT_PRE_TRACKING), m_kltCameraStageWeights(NULL) {
   m_mapOfKltTrackers["Camera"] = new vpMbKltTracker();
 
   //Add default camera transformation matrix
@@ -68,7 +93,9 @@ vpMbKltMultiTracker::vpMbKltMultiTracker() : m_mapOfCameraTransformationMatrix()
   \param nbCameras : Number of cameras to use.
 */
 vpMbKltMultiTracker::vpMbKltMultiTracker(const unsigned int nbCameras) : m_mapOfCameraTransformationMatrix(),
-    m_mapOfKltTrackers(), m_referenceCameraName("Camera") {
+    m_mapOfKltTrackers(), m_referenceCameraName("Camera"), m_useParallelCameraTracking(false),
+    m_mapOfCameraTrackingTimes(), m_kltCameraStages(), m_kltCameraStage(KLT_PRE_TRACKING),
+    m_kltCameraStageWeights(NULL) {
 
   if(nbCameras == 0) {
     throw vpException(vpTrackingException::fatalError, "Cannot construct a vpMbkltMultiTracker with no camera !");
@@ -108,7 +135,9 @@ vpMbKltMultiTracker::vpMbKltMultiTracker(const unsigned int nbCameras) : m_mapOf
   \param cameraNames : List of camera names.
 */
 vpMbKltMultiTracker::vpMbKltMultiTracker(const std::vector<std::string> &cameraNames) : m_mapOfCameraTransformationMatrix(),
-    m_mapOfKltTrackers(), m_referenceCameraName("Camera") {
+    m_mapOfKltTrackers(), m_referenceCameraName("Camera"), m_useParallelCameraTracking(false),
+    m_mapOfCameraTrackingTimes(), m_kltCameraStages(), m_kltCameraStage(KLT_PRE_TRACKING),
+    m_kltCameraStageWeights(NULL) {
   if(cameraNames.empty()) {
     throw vpException(vpTrackingException::fatalError, "Cannot construct a vpMbKltMultiTracker with no camera !");
   }
@@ -444,6 +473,18 @@ std::vector<std::string> vpMbKltMultiTracker::getCameraNames() const {
   return cameraNames;
 }
 
+/*!
+  Get the time spent by each camera in the per-camera stages of the last call
+  to track(): KLT tracking, outlier removal and visibility of the KLT points.
+
+  \param mapOfTimes : Map of the times in ms.
+
+  \sa setUseParallelCameraTracking()
+*/
+void vpMbKltMultiTracker::getCameraTrackingTimes(std::map<std::string, double> &mapOfTimes) const {
+  mapOfTimes = m_mapOfCameraTrackingTimes;
+}
+
 /*!
   Get the camera parameters for the reference camera.
 
@@ -861,6 +902,22 @@ void vpMbKltMultiTracker::getPose(std::map<std::string, vpHomogeneousMatrix> &ma
   }
 }
 
+/*!
+  Get the time in ms spent to render the scene of the scanline visibility test
+  by all the cameras since the last call of resetScanLineRenderingTime().
+
+  \return The rendering time in ms.
+*/
+double vpMbKltMultiTracker::getScanLineRenderingTime() const {
+  double time = 0.0;
+  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it) {
+    time += it->second->getScanLineRenderingTime();
+  }
+
+  return time;
+}
+
 void vpMbKltMultiTracker::init(const vpImage<unsigned char>& /*I*/) {
 }
 
@@ -1556,44 +1613,60 @@ void vpMbKltMultiTracker::loadModel(const std::string &modelFile, const bool ver
   modelInitialised = true;
 }
 
+/*!
+  Set the trackers and the images used by the per-camera stages.
+
+  \param mapOfImages : Map of images.
+*/
+void vpMbKltMultiTracker::initKltCameraStages(const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages) {
+  m_kltCameraStages.resize(m_mapOfKltTrackers.size());
+
+  size_t i = 0;
+  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it, ++i) {
+    std::map<std::string, const vpImage<unsigned char> *>::const_iterator it_img = mapOfImages.find(it->first);
+
+    m_kltCameraStages[i].name = it->first;
+    m_kltCameraStages[i].tracker = it->second;
+    m_kltCameraStages[i].image = it_img != mapOfImages.end() ? it_img->second : NULL;
+  }
+}
+
 void vpMbKltMultiTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
     std::map<std::string, unsigned int> &mapOfNbInfos,
     std::map<std::string, unsigned int> &mapOfNbFaceUsed) {
-  for(std::map<std::string, vpMbKltTracker*>::const_iterator it = m_mapOfKltTrackers.begin();
-      it != m_mapOfKltTrackers.end(); ++it) {
-    mapOfNbInfos[it->first] = 0;
-    mapOfNbFaceUsed[it->first] = 0;
-  }
+  initKltCameraStages(mapOfImages);
+  runKltCameraStages(KLT_PRE_TRACKING);
 
-  for (std::map<std::string, vpMbKltTracker*>::const_iterator it =
-      m_mapOfKltTrackers.begin(); it != m_mapOfKltTrackers.end(); ++it) {
-    try {
-      it->second->preTracking(*mapOfImages[it->first], mapOfNbInfos[it->first], mapOfNbFaceUsed[it->first]);
-    } catch (/*vpException &e*/...) {
-//      throw e;
-    }
+  for(size_t i = 0; i < m_kltCameraStages.size(); i++) {
+    mapOfNbInfos[m_kltCameraStages[i].name] = m_kltCameraStages[i].nbInfos;
+    mapOfNbFaceUsed[m_kltCameraStages[i].name] = m_kltCameraStages[i].nbFaceUsed;
   }
 }
 
 void vpMbKltMultiTracker::postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
     std::map<std::string, unsigned int> &mapOfNbInfos, vpColVector &w_klt) {
+  initKltCameraStages(mapOfImages);
+
   unsigned int shift = 0;
-  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
-      it != m_mapOfKltTrackers.end(); ++it) {
+  for(size_t i = 0; i < m_kltCameraStages.size(); i++) {
+    vpKltCameraStageData &data = m_kltCameraStages[i];
     //Set the camera pose
-    it->second->cMo = m_mapOfCameraTransformationMatrix[it->first]*cMo;
+    data.tracker->cMo = m_mapOfCameraTransformationMatrix[data.name]*cMo;
 
-    if(mapOfNbInfos[it->first] > 0) {
-      vpSubColVector sub_w(w_klt, shift, 2*mapOfNbInfos[it->first]);
-      shift += 2*mapOfNbInfos[it->first];
-      if(it->second->postTracking(*mapOfImages[it->first], sub_w)) {
-        it->second->reinit(*mapOfImages[it->first]);
+    data.nbInfos = mapOfNbInfos[data.name];
+    data.shift = shift;
+    shift += 2*data.nbInfos;
+  }
 
-        //set ctTc0 to identity
-        if(it->first == m_referenceCameraName) {
-          reinit(/*mapOfImages[it->first]*/);
-        }
-      }
+  m_kltCameraStageWeights = &w_klt;
+  runKltCameraStages(KLT_POST_TRACKING);
+  m_kltCameraStageWeights = NULL;
+
+  for(size_t i = 0; i < m_kltCameraStages.size(); i++) {
+    //set ctTc0 to identity
+    if(m_kltCameraStages[i].reinitialised && m_kltCameraStages[i].name == m_referenceCameraName) {
+      reinit(/*mapOfImages[it->first]*/);
     }
   }
 }
@@ -1606,6 +1679,83 @@ void vpMbKltMultiTracker::reinit(/* const vpImage<unsigned char>& I*/) {
   ctTc0.eye();
 }
 
+/*!
+  Run the current stage for one camera.
+
+  \param index : Index of the camera in the per-camera stage data.
+*/
+void vpMbKltMultiTracker::runKltCameraStage(const unsigned int index) {
+  double t = vpTime::measureTimeMs();
+
+  vpKltCameraStageData &data = m_kltCameraStages[index];
+
+  switch(m_kltCameraStage) {
+  case KLT_PRE_TRACKING:
+    data.nbInfos = 0;
+    data.nbFaceUsed = 0;
+    try {
+      data.tracker->preTracking(*data.image, data.nbInfos, data.nbFaceUsed);
+    } catch (/*vpException &e*/...) {
+//      throw e;
+    }
+    break;
+
+  case KLT_POST_TRACKING:
+    data.reinitialised = false;
+    if(data.nbInfos > 0) {
+      vpSubColVector sub_w(*m_kltCameraStageWeights, data.shift, 2*data.nbInfos);
+      if(data.tracker->postTracking(*data.image, sub_w)) {
+        data.tracker->reinit(*data.image);
+        data.reinitialised = true;
+      }
+    }
+    break;
+
+  default:
+    break;
+  }
+
+  data.time = vpTime::measureTimeMs() - t;
+}
+
+/*!
+  Run a stage for all the cameras, concurrently if setUseParallelCameraTracking()
+  is enabled. The trackers and the images must have been set with initKltCameraStages().
+
+  The post-tracking stage is run serially when the visibility test uses Ogre.
+  When the cameras are run concurrently, an exception thrown for a camera is
+  forwarded by vpThreadPool::parallel_for() with its type and code.
+
+  \param stage : Stage to run.
+*/
+void vpMbKltMultiTracker::runKltCameraStages(const KltCameraStage stage) {
+  m_kltCameraStage = stage;
+
+  bool parallel = m_useParallelCameraTracking && m_kltCameraStages.size() > 1;
+  if(parallel && stage == KLT_POST_TRACKING) {
+    // The visibility test with Ogre is not thread-safe
+    for(size_t i = 0; i < m_kltCameraStages.size(); i++) {
+      if(m_kltCameraStages[i].tracker->useOgre) {
+        parallel = false;
+        break;
+      }
+    }
+  }
+
+  if(parallel) {
+    vpMbKltMultiTrackerCameraTask task(*this);
+    vpThreadPool::parallel_for(0, (unsigned int) m_kltCameraStages.size(), task, 1);
+  } else {
+    for(unsigned int i = 0; i < m_kltCameraStages.size(); i++) {
+      runKltCameraStage(i);
+    }
+  }
+
+  for(size_t i = 0; i < m_kltCameraStages.size(); i++) {
+    m_mapOfCameraTrackingTimes[m_kltCameraStages[i].name] += m_kltCameraStages[i].time;
+  }
+}
+
 /*!
   Re-initialize the model used by the tracker.
 
@@ -1736,6 +1886,22 @@ void vpMbKltMultiTracker::reInitModel(const std::map<std::string, const vpImage<
   }
 }
 
+/*!
+  Save in a binary file the model loaded by the tracker of the reference
+  camera, see vpMbTracker::saveCompiledModel().
+
+  \param compiledModelFile : Name of the compiled model file.
+*/
+void vpMbKltMultiTracker::saveCompiledModel(const std::string &compiledModelFile) const {
+  std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.find(m_referenceCameraName);
+  if(it != m_mapOfKltTrackers.end()) {
+    it->second->saveCompiledModel(compiledModelFile);
+  } else {
+    throw vpException(vpTrackingException::fatalError, "Cannot find the reference camera: %s !",
+                      m_referenceCameraName.c_str());
+  }
+}
+
 /*!
   Reset the tracker. The model is removed and the pose is set to identity.
   The tracker needs to be initialized with a new model and a new pose.
@@ -1775,6 +1941,16 @@ void vpMbKltMultiTracker::resetTracker() {
 #endif
 }
 
+/*!
+  Reset the rendering time of the scanline visibility test of all the cameras.
+*/
+void vpMbKltMultiTracker::resetScanLineRenderingTime() {
+  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it) {
+    it->second->resetScanLineRenderingTime();
+  }
+}
+
 /*!
   Set the angle used to test polygons appearance.
   If the angle between the normal of the polygon and the line going
@@ -1996,6 +2172,21 @@ void vpMbKltMultiTracker::setCovarianceComputation(const bool& flag) {
   }
 }
 
+/*!
+  Use a bounding volume hierarchy and a low resolution depth buffer to remove
+  the faces that are out of the field of view or hidden by other faces.
+
+  \param v : True to use it, False otherwise
+*/
+void vpMbKltMultiTracker::setDepthBufferVisibilityTest(const bool &v) {
+  vpMbTracker::setDepthBufferVisibilityTest(v);
+
+  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it) {
+    it->second->setDepthBufferVisibilityTest(v);
+  }
+}
+
 /*!
   Enable to display the KLT features.
 
@@ -2465,6 +2656,35 @@ void vpMbKltMultiTracker::setReferenceCameraName(const std::string &referenceCam
   }
 }
 
+/*!
+  Render the bands of scanlines of the scanline visibility test in parallel.
+
+  \param v : True to render the bands in parallel, False otherwise
+*/
+void vpMbKltMultiTracker::setScanLineParallelRendering(const bool &v) {
+  vpMbTracker::setScanLineParallelRendering(v);
+
+  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it) {
+    it->second->setScanLineParallelRendering(v);
+  }
+}
+
+/*!
+  Set the displacement in pixel under which a face is not rendered again by
+  the scanline visibility test.
+
+  \param threshold : Displacement in pixel.
+*/
+void vpMbKltMultiTracker::setScanLineReuseThreshold(const double &threshold) {
+  vpMbTracker::setScanLineReuseThreshold(threshold);
+
+  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it) {
+    it->second->setScanLineReuseThreshold(threshold);
+  }
+}
+
 /*!
   Use Scanline algorithm for visibility tests
 
@@ -2507,6 +2727,21 @@ void vpMbKltMultiTracker::setUseKltTracking(const std::string &name, const bool
   }
 }
 
+/*!
+  Enable or disable the concurrent execution of the per-camera stages of track():
+  KLT tracking, outlier removal and visibility of the KLT points. The cameras are
+  only synchronised for the joint pose update. The result is the same as with the
+  sequential execution. Since Ogre is not thread-safe, the visibility of the KLT
+  points stays sequential when setOgreVisibilityTest() is enabled.
+
+  \param use : True to run the stages of each camera in parallel with vpThreadPool.
+
+  \sa getCameraTrackingTimes()
+*/
+void vpMbKltMultiTracker::setUseParallelCameraTracking(const bool use) {
+  m_useParallelCameraTracking = use;
+}
+
 /*!
   Realize the tracking of the object in the image
 
@@ -2574,6 +2809,12 @@ void vpMbKltMultiTracker::track(std::map<std::string, const vpImage<unsigned cha
   std::map<std::string, unsigned int> mapOfNbInfos;
   std::map<std::string, unsigned int> mapOfNbFaceUsed;
 
+  m_mapOfCameraTrackingTimes.clear();
+  for(std::map<std::string, vpMbKltTracker*>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it) {
+    m_mapOfCameraTrackingTimes[it->first] = 0.0;
+  }
+
   preTracking(mapOfImages, mapOfNbInfos, mapOfNbFaceUsed);
 
   bool atLeastOneTrackerOk = false;
@@ -117,6 +117,27 @@ vpMbtDistanceKltCylinder::init(const vpKltOpencv& _tracker, const vpHomogeneousM
   curPoints = std::map<int, vpImagePoint>();
   curPointsInd = std::map<int, int>();
 
+  // Test all the features against the faces of the cylinder bounding box at once
+  std::vector<std::vector<bool> > inside;
+  if(!useScanLine)
+  {
+    std::vector<vpImagePoint> features((size_t)_tracker.getNbFeatures());
+    for (unsigned int i = 0; i < static_cast<unsigned int>(_tracker.getNbFeatures()); i ++){
+      long id;
+      float x_tmp, y_tmp;
+      _tracker.getFeature((int)i, id, x_tmp, y_tmp);
+      features[i].set_ij(y_tmp, x_tmp);
+    }
+
+    inside.resize(listIndicesCylinderBBox.size());
+    for(unsigned int kc = 0 ; kc < listIndicesCylinderBBox.size() ; kc++)
+    {
+      std::vector<vpImagePoint> roi;
+      hiddenface->getPolygon()[(size_t) listIndicesCylinderBBox[kc]]->getRoiClipped(cam, roi);
+      vpPolygon::isInside(roi, features, inside[kc]);
+    }
+  }
+
   for (unsigned int i = 0; i < static_cast<unsigned int>(_tracker.getNbFeatures()); i ++){
     long id;
     float x_tmp, y_tmp;
@@ -139,16 +160,13 @@ vpMbtDistanceKltCylinder::init(const vpKltOpencv& _tracker, const vpHomogeneousM
     }
     else
     {
-      std::vector<vpImagePoint> roi;
       for(unsigned int kc = 0 ; kc < listIndicesCylinderBBox.size() ; kc++)
       {
-        hiddenface->getPolygon()[(size_t) listIndicesCylinderBBox[kc]]->getRoiClipped(cam, roi);
-        if(vpPolygon::isInside(roi, y_tmp, x_tmp))
+        if(inside[kc][i])
         {
           add = true;
           break;
         }
-        roi.clear();
       }
     }
 
@@ -382,90 +400,21 @@ vpMbtDistanceKltCylinder::updateMask(
 #endif
     unsigned char nb, unsigned int shiftBorder)
 {
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-  int width  = mask.cols;
-  int height = mask.rows;
-#else
-  int width  = mask->width;
-  int height = mask->height;
-#endif
-
   for(unsigned int kc = 0 ; kc < listIndicesCylinderBBox.size() ; kc++)
   {
-      if((*hiddenface)[(unsigned int) listIndicesCylinderBBox[kc]]->isVisible() &&
-          (*hiddenface)[(unsigned int) listIndicesCylinderBBox[kc]]->getNbPoint() > 2)
-      {
-          int i_min, i_max, j_min, j_max;
-          std::vector<vpImagePoint> roi;
-          (*hiddenface)[(unsigned int) listIndicesCylinderBBox[kc]]->getRoiClipped(cam, roi);
-          vpPolygon3D::getMinMaxRoi(roi, i_min, i_max, j_min,j_max);
-
-          /* check image boundaries */
-          if(i_min > height){ //underflow
-            i_min = 0;
-          }
-          if(i_max > height){
-            i_max = height;
-          }
-          if(j_min > width){ //underflow
-            j_min = 0;
-          }
-          if(j_max > width){
-            j_max = width;
-          }
+    if((*hiddenface)[(unsigned int) listIndicesCylinderBBox[kc]]->isVisible() &&
+        (*hiddenface)[(unsigned int) listIndicesCylinderBBox[kc]]->getNbPoint() > 2)
+    {
+      std::vector<vpImagePoint> roi;
+      (*hiddenface)[(unsigned int) listIndicesCylinderBBox[kc]]->getRoiClipped(cam, roi);
 
-          double shiftBorder_d = (double) shiftBorder;
-        #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-          for(int i=i_min; i< i_max; i++){
-            double i_d = (double) i;
-            for(int j=j_min; j< j_max; j++){
-              double j_d = (double) j;
-              if(shiftBorder != 0){
-                if( vpPolygon::isInside(roi, i_d, j_d)
-                    && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d+shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d+shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d-shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d-shiftBorder_d) ){
-                  mask.at<unsigned char>(i,j) = nb;
-                }
-              }
-              else{
-                if(vpPolygon::isInside(roi, i, j)){
-                  mask.at<unsigned char>(i,j) = nb;
-                }
-              }
-            }
-          }
-        #else
-          unsigned char* ptrData = (unsigned char*)mask->imageData + i_min*mask->widthStep+j_min;
-          for(int i=i_min; i< i_max; i++){
-            double i_d = (double) i;
-            for(int j=j_min; j< j_max; j++){
-              double j_d = (double) j;
-              if(shiftBorder != 0){
-                if( vpPolygon::isInside(roi, i_d, j_d)
-                    && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d+shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d+shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d-shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d-shiftBorder_d) ){
-                  *(ptrData++) = nb;
-                }
-                else{
-                  ptrData++;
-                }
-              }
-              else{
-                if(vpPolygon::isInside(roi, i, j)){
-                  *(ptrData++) = nb;
-                }
-                else{
-                  ptrData++;
-                }
-              }
-            }
-            ptrData += mask->widthStep - j_max + j_min;
-          }
-        #endif
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+      vpPolygon::fillMask(roi, mask.data, (unsigned int)mask.rows, (unsigned int)mask.cols,
+                          (unsigned int)mask.step[0], nb, shiftBorder);
+#else
+      vpPolygon::fillMask(roi, (unsigned char*)mask->imageData, (unsigned int)mask->height, (unsigned int)mask->width,
+                          (unsigned int)mask->widthStep, nb, shiftBorder);
+#endif
     }
   }
 }
@@ -82,8 +82,23 @@ vpMbtDistanceKltPoints::init(const vpKltOpencv& _tracker)
   initPoints = std::map<int, vpImagePoint>();
   curPoints = std::map<int, vpImagePoint>();
   curPointsInd = std::map<int, int>();
-  std::vector<vpImagePoint> roi;
-  polygon->getRoiClipped(cam, roi);
+
+  // Test all the features against the face polygon at once
+  std::vector<bool> inside;
+  if(!useScanLine)
+  {
+    std::vector<vpImagePoint> roi;
+    polygon->getRoiClipped(cam, roi);
+
+    std::vector<vpImagePoint> features((size_t)_tracker.getNbFeatures());
+    for (unsigned int i = 0; i < static_cast<unsigned int>(_tracker.getNbFeatures()); i ++){
+      long id;
+      float x_tmp, y_tmp;
+      _tracker.getFeature((int)i, id, x_tmp, y_tmp);
+      features[i].set_ij(y_tmp, x_tmp);
+    }
+    vpPolygon::isInside(roi, features, inside);
+  }
 
   for (unsigned int i = 0; i < static_cast<unsigned int>(_tracker.getNbFeatures()); i ++){
     long id;
@@ -99,7 +114,7 @@ vpMbtDistanceKltPoints::init(const vpKltOpencv& _tracker)
          hiddenface->getMbScanLineRenderer().getPrimitiveIDs()[(unsigned int)y_tmp][(unsigned int)x_tmp] == polygon->getIndex())
         add = true;
     }
-    else if(vpPolygon::isInside(roi, y_tmp, x_tmp))
+    else if(inside[i])
     {
       add = true;
     }
@@ -349,84 +364,15 @@ vpMbtDistanceKltPoints::updateMask(
 #endif
     unsigned char nb, unsigned int shiftBorder)
 {
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-  int width  = mask.cols;
-  int height = mask.rows;
-#else
-  int width  = mask->width;
-  int height = mask->height;
-#endif
-
-  int i_min, i_max, j_min, j_max;
   std::vector<vpImagePoint> roi;
   polygon->getRoiClipped(cam, roi);
-  vpPolygon3D::getMinMaxRoi(roi, i_min, i_max, j_min,j_max);
-
-  /* check image boundaries */
-  if(i_min > height){ //underflow
-    i_min = 0;
-  }
-  if(i_max > height){
-    i_max = height;
-  }
-  if(j_min > width){ //underflow
-    j_min = 0;
-  }
-  if(j_max > width){
-    j_max = width;
-  }
 
-  double shiftBorder_d = (double) shiftBorder;
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-  for(int i=i_min; i< i_max; i++){
-    double i_d = (double) i;
-    for(int j=j_min; j< j_max; j++){
-      double j_d = (double) j;
-      if(shiftBorder != 0){
-        if( vpPolygon::isInside(roi, i_d, j_d)
-            && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d+shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d+shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d-shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d-shiftBorder_d) ){
-          mask.at<unsigned char>(i,j) = nb;
-        }
-      }
-      else{
-        if(vpPolygon::isInside(roi, i, j)){
-          mask.at<unsigned char>(i,j) = nb;
-        }
-      }
-    }
-  }
+  vpPolygon::fillMask(roi, mask.data, (unsigned int)mask.rows, (unsigned int)mask.cols,
+                      (unsigned int)mask.step[0], nb, shiftBorder);
 #else
-  unsigned char* ptrData = (unsigned char*)mask->imageData + i_min*mask->widthStep+j_min;
-  for(int i=i_min; i< i_max; i++){
-    double i_d = (double) i;
-    for(int j=j_min; j< j_max; j++){
-      double j_d = (double) j;
-      if(shiftBorder != 0){
-        if( vpPolygon::isInside(roi, i_d, j_d)
-            && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d+shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d+shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d-shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d-shiftBorder_d) ){
-          *(ptrData++) = nb;
-        }
-        else{
-          ptrData++;
-        }
-      }
-      else{
-        if(vpPolygon::isInside(roi, i, j)){
-          *(ptrData++) = nb;
-        }
-        else{
-          ptrData++;
-        }
-      }
-    }
-    ptrData += mask->widthStep - j_max + j_min;
-  }
+  vpPolygon::fillMask(roi, (unsigned char*)mask->imageData, (unsigned int)mask->height, (unsigned int)mask->width,
+                      (unsigned int)mask->widthStep, nb, shiftBorder);
 #endif
 }
 
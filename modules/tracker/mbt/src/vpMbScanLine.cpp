@@ -50,6 +50,8 @@
 #include <visp3/mbt/vpMbScanLine.h>
 #include <visp3/core/vpMeterPixelConversion.h>
 
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
 #if defined(DEBUG_DISP)
 #include <visp3/gui/vpDisplayGDI.h>
 #include <visp3/gui/vpDisplayX.h>
@@ -58,9 +60,35 @@
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
+namespace {
+  // Number of scanlines of a band
+  const unsigned int vpBandSize = 16;
+}
+
+// Render the bands of a vpMbScanLine whose index is in a range of its dirty bands
+class vpMbScanLineBandTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpMbScanLineBandTask(vpMbScanLine &scanline) : m_scanline(scanline) {}
+
+  void run(unsigned int start, unsigned int end)
+  {
+    for (unsigned int k = start; k < end; k++)
+      m_scanline.renderBand(m_scanline.dirtyBands[k]);
+  }
+
+private:
+  vpMbScanLine &m_scanline;
+
+  vpMbScanLineBandTask &operator=(const vpMbScanLineBandTask &);
+};
+
 vpMbScanLine::vpMbScanLine()
-  : w(0), h(0), K(), maskBorder(0), mask(), primitive_ids(),
-    visibility_samples(), depthTreshold(1e-06)
+  : w(0), h(0), K(), maskBorder(0), mask(), primitive_ids(), depthTreshold(1e-06),
+    edgeIndexes(), visibility_samples(), vertices(), renderedVertices(), polygonOffsets(), polygonIDs(),
+    vertexEdges(), renderedOffsets(), renderedIDs(), renderedEdges(), bands(), dirtyBands(), maskY(), maskX(),
+    renderedMaskBorder(0), renderedDepthTreshold(1e-06), useParallelRendering(false), reuseThreshold(0.),
+    renderingTime(0.), nbRenderings(0), nbRenderedBands(0), nbReusedBands(0)
 #if defined(DEBUG_DISP)
   ,dispMaskDebug(NULL), dispLineDebug(NULL), linedebugImg()
 #endif
@@ -84,16 +112,19 @@ vpMbScanLine::~vpMbScanLine()
 /*!
   Compute the intersections between Y-axis scanlines and a given line (two points polygon).
 
-  \param a : First point of the line.
-  \param b : Second point of the line.
-  \param edge : Pair with the two points of the line.
+  \param a : First point of the line, projected as (u*Z, v*Z, Z).
+  \param b : Second point of the line, projected as (u*Z, v*Z, Z).
+  \param edge : Index of the edge of the line.
   \param ID : Id of the given line (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+  \param first : First scanline of the band.
+  \param last : Scanline following the last one of the band.
+  \param scanlines : Resulting intersections, indexed from the first scanline of the band.
 */
-void vpMbScanLine::drawLineY(const vpColVector &a,
-               const vpColVector &b,
-               const vpMbScanLineEdge &edge,
+void vpMbScanLine::drawLineY(const double *a,
+               const double *b,
+               const int edge,
                const int ID,
+               const unsigned int &first, const unsigned int &last,
                std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
 {
   double x0 = a[0] / a[2];
@@ -113,12 +144,12 @@ void vpMbScanLine::drawLineY(const vpColVector &a,
   if (y0 >= h - 1 || y1 < 0 || std::fabs(y1 - y0) <= std::numeric_limits<double>::epsilon())
       return;
 
-  const unsigned int _y0 = std::max<unsigned int>(0, (unsigned int)(std::ceil(y0)));
-  const double _y1 = std::min<double>(h, y1);
+  const double _y0 = std::max<double>(first, std::ceil(y0));
+  const double _y1 = std::min<double>(std::min(h, last), y1);
 
   const bool b_sample_Y = (std::fabs(y0 - y1) > std::fabs(x0 - x1));
 
-  for(unsigned int y = _y0 ; y < _y1 ; ++y)
+  for(unsigned int y = (unsigned int)_y0 ; y < _y1 ; ++y)
   {
       const double x = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
       const double alpha = getAlpha(y, y0 * z0, z0, y1 * z1, z1);
@@ -130,23 +161,26 @@ void vpMbScanLine::drawLineY(const vpColVector &a,
       s.ID = ID;
       s.edge = edge;
       s.b_sample_Y = b_sample_Y;
-      scanlines[y].push_back(s);
+      scanlines[y - first].push_back(s);
   }
 }
 
 /*!
   Compute the intersections between X-axis scanlines and a given line (two points polygon).
 
-  \param a : First point of the line.
-  \param b : Second point of the line.
-  \param edge : Pair with the two points of the line.
+  \param a : First point of the line, projected as (u*Z, v*Z, Z).
+  \param b : Second point of the line, projected as (u*Z, v*Z, Z).
+  \param edge : Index of the edge of the line.
   \param ID : Id of the given line (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+  \param first : First scanline of the band.
+  \param last : Scanline following the last one of the band.
+  \param scanlines : Resulting intersections, indexed from the first scanline of the band.
 */
-void vpMbScanLine::drawLineX(const vpColVector &a,
-               const vpColVector &b,
-               const vpMbScanLineEdge &edge,
+void vpMbScanLine::drawLineX(const double *a,
+               const double *b,
+               const int edge,
                const int ID,
+               const unsigned int &first, const unsigned int &last,
                std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
 {
   double x0 = a[0] / a[2];
@@ -166,12 +200,12 @@ void vpMbScanLine::drawLineX(const vpColVector &a,
   if (x0 >= w - 1 || x1 < 0 || std::fabs(x1 - x0) <= std::numeric_limits<double>::epsilon())
       return;
 
-  const unsigned int _x0 = std::max<unsigned int>(0, (unsigned int)(std::ceil(x0)));
-  const double _x1 = std::min<double>(w, x1);
+  const double _x0 = std::max<double>(first, std::ceil(x0));
+  const double _x1 = std::min<double>(std::min(w, last), x1);
 
   const bool b_sample_Y = (std::fabs(y0 - y1) > std::fabs(x0 - x1));
 
-  for(unsigned int x = _x0 ; x < _x1 ; ++x)
+  for(unsigned int x = (unsigned int)_x0 ; x < _x1 ; ++x)
   {
       const double y = y0 + (y1 - y0) * (x - x0) / (x1 - x0);
       const double alpha = getAlpha(x, x0 * z0, z0, x1 * z1, z1);
@@ -183,114 +217,126 @@ void vpMbScanLine::drawLineX(const vpColVector &a,
       s.ID = ID;
       s.edge = edge;
       s.b_sample_Y = b_sample_Y;
-      scanlines[x].push_back(s);
+      scanlines[x - first].push_back(s);
   }
 }
 
 
 /*!
-  Compute the Y-axis scanlines intersections of a polygon.
+  Compute the Y-axis scanlines intersections of a polygon in a band.
 
-  \param polygon : Polygon composed by an array of lines.
-  \param ID : ID of the polygon (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+  \param polygon : Index of the polygon in the scene.
+  \param first : First scanline of the band.
+  \param last : Scanline following the last one of the band.
+  \param band : Band where the intersections are added.
 */
 void
-vpMbScanLine::drawPolygonY(const std::vector<std::pair<vpPoint, unsigned int> > &polygon,
-                  const int ID,
-                  std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+vpMbScanLine::drawPolygonY(const unsigned int &polygon, const unsigned int &first, const unsigned int &last,
+                           vpMbScanLineBand &band)
 {
-  if (polygon.size() < 2)
+  const unsigned int begin = polygonOffsets[polygon];
+  const unsigned int n = polygonOffsets[polygon + 1] - begin;
+  const double *v = &vertices[0] + 3 * begin;
+
+  if (n < 2)
     return;
 
-  if (polygon.size() == 2)
+  if (n == 2)
   {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon.front().first, p1, K);
-    createVectorFromPoint(polygon.back().first, p2, K);
-
-    drawLineY(p1,
-              p2,
-              makeMbScanLineEdge(polygon.front().first, polygon.back().first),
-              ID,
-              scanlines);
+    drawLineY(v, v + 3, vertexEdges[begin], polygonIDs[polygon], first, last, band.scanlines);
     return;
   }
 
-  std::vector<std::vector<vpMbScanLineSegment> > local_scanlines;
-  local_scanlines.resize(h);
-
-  for(size_t i = 0 ; i < polygon.size() ; ++i)
+  // Scanlines of the band crossed by the polygon
+  double ymin = std::numeric_limits<double>::max(), ymax = -std::numeric_limits<double>::max();
+  for(unsigned int i = 0 ; i < n ; ++i)
   {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon[i].first, p1, K);
-    createVectorFromPoint(polygon[(i + 1) % polygon.size()].first, p2, K);
-
-    drawLineY(p1, p2, makeMbScanLineEdge(polygon[i].first, polygon[(i + 1) % polygon.size()].first), ID, local_scanlines);
+    if (v[3*i + 2] <= 0.)
+    {
+      ymin = 0.;
+      ymax = h;
+      break;
+    }
+    ymin = std::min(ymin, v[3*i + 1] / v[3*i + 2]);
+    ymax = std::max(ymax, v[3*i + 1] / v[3*i + 2]);
   }
+  const double lo = std::max<double>(first, std::ceil(ymin));
+  const double hi = std::min<double>(last, std::ceil(ymax));
+  if (lo >= hi)
+    return;
+
+  for(unsigned int i = 0 ; i < n ; ++i)
+    drawLineY(v + 3*i, v + 3*((i + 1) % n), vertexEdges[begin + i], polygonIDs[polygon], first, last, band.localScanlines);
 
-  createScanLinesFromLocals(scanlines,local_scanlines,h);
+  createScanLinesFromLocals(band.scanlines, band.localScanlines, (unsigned int)lo - first, (unsigned int)hi - first);
 }
 
 /*!
-  Compute the X-axis scanlines intersections of a polygon.
+  Compute the X-axis scanlines intersections of a polygon in a band.
 
-  \param polygon : Polygon composed by an array of lines.
-  \param ID : ID of the polygon (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+  \param polygon : Index of the polygon in the scene.
+  \param first : First scanline of the band.
+  \param last : Scanline following the last one of the band.
+  \param band : Band where the intersections are added.
 */
 void
-vpMbScanLine::drawPolygonX(const std::vector<std::pair<vpPoint, unsigned int> > &polygon,
-                  const int ID,
-                  std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+vpMbScanLine::drawPolygonX(const unsigned int &polygon, const unsigned int &first, const unsigned int &last,
+                           vpMbScanLineBand &band)
 {
-  if (polygon.size() < 2)
-      return;
+  const unsigned int begin = polygonOffsets[polygon];
+  const unsigned int n = polygonOffsets[polygon + 1] - begin;
+  const double *v = &vertices[0] + 3 * begin;
+
+  if (n < 2)
+    return;
 
-  if (polygon.size() == 2)
+  if (n == 2)
   {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon.front().first, p1, K);
-    createVectorFromPoint(polygon.back().first, p2, K);
-
-    drawLineX(p1,
-              p2,
-              makeMbScanLineEdge(polygon.front().first, polygon.back().first),
-              ID,
-              scanlines);
+    drawLineX(v, v + 3, vertexEdges[begin], polygonIDs[polygon], first, last, band.scanlines);
     return;
   }
 
-  std::vector<std::vector<vpMbScanLineSegment> > local_scanlines;
-  local_scanlines.resize(w);
-
-  for(size_t i = 0 ; i < polygon.size() ; ++i)
+  // Scanlines of the band crossed by the polygon
+  double xmin = std::numeric_limits<double>::max(), xmax = -std::numeric_limits<double>::max();
+  for(unsigned int i = 0 ; i < n ; ++i)
   {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon[i].first, p1, K);
-    createVectorFromPoint(polygon[(i + 1) % polygon.size()].first, p2, K);
-
-    drawLineX(p1, p2, makeMbScanLineEdge(polygon[i].first, polygon[(i + 1) % polygon.size()].first), ID, local_scanlines);
+    if (v[3*i + 2] <= 0.)
+    {
+      xmin = 0.;
+      xmax = w;
+      break;
+    }
+    xmin = std::min(xmin, v[3*i] / v[3*i + 2]);
+    xmax = std::max(xmax, v[3*i] / v[3*i + 2]);
   }
+  const double lo = std::max<double>(first, std::ceil(xmin));
+  const double hi = std::min<double>(last, std::ceil(xmax));
+  if (lo >= hi)
+    return;
+
+  for(unsigned int i = 0 ; i < n ; ++i)
+    drawLineX(v + 3*i, v + 3*((i + 1) % n), vertexEdges[begin + i], polygonIDs[polygon], first, last, band.localScanlines);
 
-  createScanLinesFromLocals(scanlines,local_scanlines,w);
+  createScanLinesFromLocals(band.scanlines, band.localScanlines, (unsigned int)lo - first, (unsigned int)hi - first);
 }
 
 /*!
   Organise local scanlines in a global scanline vector.
   It also marks the computed intersections as starting or ending points.
   This function will only be called by the drawPolygons functions.
+  The local scanlines are emptied.
 
   \param scanlines : Global scanline vector.
   \param localScanlines : Local scanline vector (X or Y-axis).
-  \param size : Corresponding size (typically the width or the height).
+  \param first : First scanline to organise.
+  \param last : Scanline following the last one to organise.
 */
 void
 vpMbScanLine::createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
                                         std::vector<std::vector<vpMbScanLineSegment> > &localScanlines,
-                                        const unsigned int &size)
+                                        const unsigned int &first, const unsigned int &last)
 {
-  for(unsigned int j = 0 ; j < size ; ++j)
+  for(unsigned int j = first ; j < last ; ++j)
   {
       std::vector<vpMbScanLineSegment> &scanline = localScanlines[j];
       sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator()); // Not sure its necessary
@@ -318,217 +364,375 @@ vpMbScanLine::createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegm
           }
           scanlines[j].push_back(s);
       }
+      scanline.clear();
   }
 }
 
 /*!
-  Render a scene of polygons and compute scanlines intersections in order to use queries.
+  Project the vertices of the polygons and index their edges.
 
   \param polygons : List of polygons composed by arrays of lines.
-  \param listPolyIndices : List of polygons IDs (has to be know when using queries).
-  \param cam : Camera parameters.
-  \param width : Width of the image (render window).
-  \param height : Height of the image (render window).
+  \param listPolyIndices : List of polygons IDs.
 */
 void
-vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > * > &polygons,
-                        std::vector<int> listPolyIndices,
-                        const vpCameraParameters &cam, unsigned int width, unsigned int height)
+vpMbScanLine::buildScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > * > &polygons,
+                         const std::vector<int> &listPolyIndices)
 {
-  this->w = width;
-  this->h = height;
-  this->K = cam;
+  edgeIndexes.clear();
+  vertices.clear();
+  polygonOffsets.clear();
+  polygonIDs.clear();
+  vertexEdges.clear();
 
-  visibility_samples.clear();
+  for(unsigned int ID = 0 ; ID < polygons.size() ; ++ID)
+  {
+    const std::vector<std::pair<vpPoint, unsigned int> > &polygon = *(polygons[ID]);
+    const size_t n = polygon.size();
+    polygonOffsets.push_back((unsigned int)(vertices.size() / 3));
+    polygonIDs.push_back(listPolyIndices[ID]);
 
-  std::vector<std::vector<vpMbScanLineSegment> > scanlinesY;
-  scanlinesY.resize(h);
-  std::vector<std::vector<vpMbScanLineSegment> > scanlinesX;
-  scanlinesX.resize(w);
+    for(size_t i = 0 ; i < n ; ++i)
+    {
+      const vpPoint &p = polygon[i].first;
+      vertices.push_back(p.get_X() * K.get_px() + K.get_u0() * p.get_Z());
+      vertices.push_back(p.get_Y() * K.get_py() + K.get_v0() * p.get_Z());
+      vertices.push_back(p.get_Z());
 
-  mask.resize(h,w,0);
+      int edge = -1;
+      if (n > 2 || (n == 2 && i == 0))
+      {
+        const vpMbScanLineEdge key = makeMbScanLineEdge(p, polygon[(i + 1) % n].first);
+        edge = edgeIndexes.insert(std::make_pair(key, (int)edgeIndexes.size())).first->second;
+      }
+      vertexEdges.push_back(edge);
+    }
+  }
+  polygonOffsets.push_back((unsigned int)(vertices.size() / 3));
+}
 
-  vpImage<unsigned char> maskY(h,w,0);
-  vpImage<unsigned char> maskX(h,w,0);
+/*!
+  Find the bands that have to be rendered, from the polygons that moved since
+  their last rendering.
 
-  primitive_ids.resize(h, w, -1);
+  \param fullRendering : True if all the bands have to be rendered.
+*/
+void
+vpMbScanLine::findDirtyBands(const bool fullRendering)
+{
+  const unsigned int nbBandsY = (h + vpBandSize - 1) / vpBandSize;
+  const unsigned int nbBands = (unsigned int)bands.size();
+  dirtyBands.clear();
 
-  for(unsigned int ID = 0 ; ID < polygons.size() ; ++ID)
+  if (fullRendering)
   {
-      drawPolygonY(*(polygons[ID]), listPolyIndices[ID], scanlinesY);
-      drawPolygonX(*(polygons[ID]), listPolyIndices[ID], scanlinesX);
+    for(unsigned int i = 0 ; i < nbBands ; ++i)
+      dirtyBands.push_back(i);
+    renderedVertices = vertices;
+    return;
   }
 
-  // Y
-  int last_ID = -1;
-  vpMbScanLineSegment last_visible;
-  for(unsigned int y = 0 ; y < scanlinesY.size() ; ++y)
+  std::vector<bool> dirty(nbBands, false);
+  const double focal = std::max(K.get_px(), K.get_py());
+  for(unsigned int k = 0 ; k + 1 < polygonOffsets.size() ; ++k)
   {
-      std::vector<vpMbScanLineSegment> &scanline = scanlinesY[y];
-      sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
+    const unsigned int begin = 3 * polygonOffsets[k], end = 3 * polygonOffsets[k + 1];
+    bool moved = false;
+    for(unsigned int i = begin ; i < end && ! moved ; i += 3)
+    {
+      const double *v = &vertices[i], *r = &renderedVertices[i];
+      if (v[2] <= 0. || r[2] <= 0. || reuseThreshold <= 0.)
+        moved = (std::fabs(v[0] - r[0]) > 0. || std::fabs(v[1] - r[1]) > 0. || std::fabs(v[2] - r[2]) > 0.);
+      else
+        moved = (std::fabs(v[0] / v[2] - r[0] / r[2]) > reuseThreshold
+                 || std::fabs(v[1] / v[2] - r[1] / r[2]) > reuseThreshold
+                 || std::fabs(v[2] - r[2]) > reuseThreshold * v[2] / focal);
+    }
+    if (! moved)
+      continue;
 
-      std::vector<std::pair<double, vpMbScanLineSegment> > stack;
-      for(size_t i = 0 ; i < scanline.size() ; ++i)
+    // Bands covered by the polygon at its rendered and current positions
+    double umin = std::numeric_limits<double>::max(), umax = -umin, vmin = umin, vmax = -umin;
+    bool behind = false;
+    for(unsigned int i = begin ; i < end ; i += 3)
+    {
+      const double *v[2] = { &vertices[i], &renderedVertices[i] };
+      for(unsigned int j = 0 ; j < 2 ; ++j)
       {
-          const vpMbScanLineSegment &s = scanline[i];
+        if (v[j][2] <= 0.)
+          behind = true;
+        else
+        {
+          umin = std::min(umin, v[j][0] / v[j][2]);
+          umax = std::max(umax, v[j][0] / v[j][2]);
+          vmin = std::min(vmin, v[j][1] / v[j][2]);
+          vmax = std::max(vmax, v[j][1] / v[j][2]);
+        }
+      }
+      std::copy(&vertices[i], &vertices[i] + 3, &renderedVertices[i]);
+    }
+    if (behind)
+    {
+      umin = vmin = 0.;
+      umax = w;
+      vmax = h;
+    }
 
-          switch(s.type)
-          {
-          case START:
-              stack.push_back(std::make_pair(s.Z1, s));
-              break;
-          case END:
-              for(size_t j = 0 ; j < stack.size() ; ++j)
-                  if (stack[j].second.ID == s.ID)
-                  {
-                      stack[j] = stack.back();
-                      stack.pop_back();
-                      break;
-                  }
-              break;
-          case POINT:
-              break;
-          }
+    const double rowMin = std::max(std::floor(vmin), 0.), rowMax = std::min(std::ceil(vmax), (double)h - 1.);
+    for(double y = rowMin - std::fmod(rowMin, (double)vpBandSize) ; y <= rowMax ; y += vpBandSize)
+      dirty[(unsigned int)y / vpBandSize] = true;
+    const double colMin = std::max(std::floor(umin), 0.), colMax = std::min(std::ceil(umax), (double)w - 1.);
+    for(double x = colMin - std::fmod(colMin, (double)vpBandSize) ; x <= colMax ; x += vpBandSize)
+      dirty[nbBandsY + (unsigned int)x / vpBandSize] = true;
+  }
 
-          for(size_t j = 0 ; j < stack.size() ; ++j)
-          {
-              const vpMbScanLineSegment &s0 = stack[j].second;
-              stack[j].first = mix(s0.Z1, s0.Z2, getAlpha(s.type == POINT ? s.p : (s.p + 0.5), s0.P1, s0.Z1, s0.P2, s0.Z2));
-          }
-          sort(stack.begin(), stack.end(), vpMbScanLineSegmentComparator());
+  for(unsigned int i = 0 ; i < nbBands ; ++i)
+    if (dirty[i])
+      dirtyBands.push_back(i);
+}
 
-          int new_ID = stack.empty() ? -1 : stack.front().second.ID;
+/*!
+  Compute the intersections of the scanlines of a band and the resulting
+  visibility of the polygons and edges.
 
-          if (new_ID != last_ID || s.type == POINT)
-          {
-              if (s.b_sample_Y)
-                  switch(s.type)
-                  {
-                  case POINT:
-                      if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
-                          visibility_samples[s.edge].insert((int)y);
-                      break;
-                  case START:
-                      if (new_ID == s.ID)
-                          visibility_samples[s.edge].insert((int)y);
-                      break;
-                  case END:
-                      if (last_ID == s.ID)
-                          visibility_samples[s.edge].insert((int)y);
-                      break;
-                  }
+  \param index : Index of the band. The first ones are the bands of the
+  Y-axis scanlines, followed by the bands of the X-axis scanlines.
+*/
+void
+vpMbScanLine::renderBand(const unsigned int &index)
+{
+  const unsigned int nbBandsY = (h + vpBandSize - 1) / vpBandSize;
+  const bool axisY = (index < nbBandsY);
+  const unsigned int first = (axisY ? index : index - nbBandsY) * vpBandSize;
+  const unsigned int last = std::min(first + vpBandSize, axisY ? h : w);
+  vpMbScanLineBand &band = bands[index];
+
+  band.samples.clear();
+  band.scanlines.resize(vpBandSize);
+  band.localScanlines.resize(vpBandSize);
+  for(unsigned int i = 0 ; i < vpBandSize ; ++i)
+    band.scanlines[i].clear();
+
+  for(unsigned int ID = 0 ; ID + 1 < polygonOffsets.size() ; ++ID)
+  {
+    if (axisY)
+      drawPolygonY(ID, first, last, band);
+    else
+      drawPolygonX(ID, first, last, band);
+  }
 
-              // This part will only be used for MbKltTracking
-              if (last_ID != -1)
-              {
-                  const unsigned int x0 = std::max<unsigned int>(0, (unsigned int)(std::ceil(last_visible.p)));
-                  const double x1 = std::min<double>(w, s.p);
-                  for(unsigned int x = x0 + maskBorder ; x < x1 - maskBorder; ++x)
-                  {
-                      primitive_ids[(unsigned int)y][(unsigned int)x] = last_visible.ID;
+  if (axisY)
+  {
+    for(unsigned int y = first ; y < last ; ++y)
+    {
+      std::fill(primitive_ids[y], primitive_ids[y] + w, -1);
+      if (maskBorder != 0)
+        std::fill(maskY[y], maskY[y] + w, 0);
+      else
+        std::fill(mask[y], mask[y] + w, 0);
+    }
+  }
+  else if (maskBorder != 0)
+  {
+    for(unsigned int y = 0 ; y < h ; ++y)
+      std::fill(maskX[y] + first, maskX[y] + last, 0);
+  }
 
-                      if(maskBorder != 0)
-                        maskY[(unsigned int)y][(unsigned int)x] = 255;
-                      else
-                        mask[(unsigned int)y][(unsigned int)x] = 255;
-                  }
-              }
+  for(unsigned int i = first ; i < last ; ++i)
+    sweepScanLine(i, axisY, band, band.scanlines[i - first]);
+}
+
+/*!
+  Find the visible polygon along a scanline and the visible samples of the
+  edges.
+
+  \param index : Index of the scanline.
+  \param axisY : True for a Y-axis scanline (a row of the image), false for a
+  X-axis scanline (a column).
+  \param band : Band of the scanline, where the visible samples are added.
+  \param scanline : Intersections of the scanline.
+*/
+void
+vpMbScanLine::sweepScanLine(const unsigned int &index, const bool &axisY, vpMbScanLineBand &band,
+                            std::vector<vpMbScanLineSegment> &scanline)
+{
+  sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
 
-              last_ID = new_ID;
-              if (!stack.empty())
+  const double size = axisY ? w : h;
+  int last_ID = -1;
+  vpMbScanLineSegment last_visible;
+  std::vector<std::pair<double, vpMbScanLineSegment> > &stack = band.stack;
+  stack.clear();
+  for(size_t i = 0 ; i < scanline.size() ; ++i)
+  {
+      const vpMbScanLineSegment &s = scanline[i];
+
+      switch(s.type)
+      {
+      case START:
+          stack.push_back(std::make_pair(s.Z1, s));
+          break;
+      case END:
+          for(size_t j = 0 ; j < stack.size() ; ++j)
+              if (stack[j].second.ID == s.ID)
               {
-                  last_visible = stack.front().second;
-                  last_visible.p = s.p;
+                  stack[j] = stack.back();
+                  stack.pop_back();
+                  break;
               }
-          }
+          break;
+      case POINT:
+          break;
       }
-  }
 
-  // X
-  last_ID = -1;
-  for(unsigned int x = 0 ; x < scanlinesX.size() ; ++x)
-  {
-      std::vector<vpMbScanLineSegment> &scanline = scanlinesX[x];
-      sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
+      for(size_t j = 0 ; j < stack.size() ; ++j)
+      {
+          const vpMbScanLineSegment &s0 = stack[j].second;
+          stack[j].first = mix(s0.Z1, s0.Z2, getAlpha(s.type == POINT ? s.p : (s.p + 0.5), s0.P1, s0.Z1, s0.P2, s0.Z2));
+      }
+      sort(stack.begin(), stack.end(), vpMbScanLineSegmentComparator());
 
-      std::vector<std::pair<double, vpMbScanLineSegment> > stack;
-      for(size_t i = 0 ; i < scanline.size() ; ++i)
+      int new_ID = stack.empty() ? -1 : stack.front().second.ID;
+
+      if (new_ID != last_ID || s.type == POINT)
       {
-          const vpMbScanLineSegment &s = scanline[i];
+          if (s.b_sample_Y == axisY)
+              switch(s.type)
+              {
+              case POINT:
+                  if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
+                      band.samples.push_back(std::make_pair(s.edge, (int)index));
+                  break;
+              case START:
+                  if (new_ID == s.ID)
+                      band.samples.push_back(std::make_pair(s.edge, (int)index));
+                  break;
+              case END:
+                  if (last_ID == s.ID)
+                      band.samples.push_back(std::make_pair(s.edge, (int)index));
+                  break;
+              }
 
-          switch(s.type)
+          // This part will only be used for MbKltTracking
+          if (last_ID != -1 && (axisY || maskBorder != 0))
           {
-          case START:
-              stack.push_back(std::make_pair(s.Z1, s));
-              break;
-          case END:
-              for(size_t j = 0 ; j < stack.size() ; ++j)
-                  if (stack[j].second.ID == s.ID)
+              const double x0 = std::max(0., std::ceil(last_visible.p));
+              const double x1 = std::min(size, s.p);
+              for(unsigned int j = (unsigned int)x0 + maskBorder ; j < x1 - maskBorder; ++j)
+              {
+                  if (! axisY)
+                    maskX[j][index] = 255;
+                  else
                   {
-                      stack[j] = stack.back();
-                      stack.pop_back();
-                      break;
+                    primitive_ids[index][j] = last_visible.ID;
+
+                    if(maskBorder != 0)
+                      maskY[index][j] = 255;
+                    else
+                      mask[index][j] = 255;
                   }
-              break;
-          case POINT:
-              break;
+              }
           }
 
-          for(size_t j = 0 ; j < stack.size() ; ++j)
+          last_ID = new_ID;
+          if (!stack.empty())
           {
-              const vpMbScanLineSegment &s0 = stack[j].second;
-              stack[j].first = mix(s0.Z1, s0.Z2, getAlpha(s.type == POINT ? s.p : (s.p + 0.5), s0.P1, s0.Z1, s0.P2, s0.Z2));
+              last_visible = stack.front().second;
+              last_visible.p = s.p;
           }
-          sort(stack.begin(), stack.end(), vpMbScanLineSegmentComparator());
+      }
+  }
+}
 
-          int new_ID = stack.empty() ? -1 : stack.front().second.ID;
+/*!
+  Render a scene of polygons and compute scanlines intersections in order to use queries.
 
-          if (new_ID != last_ID || s.type == POINT)
-          {
-              if (!s.b_sample_Y)
-                  switch(s.type)
-                  {
-                  case POINT:
-                      if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
-                          visibility_samples[s.edge].insert((int)x);
-                      break;
-                  case START:
-                      if (new_ID == s.ID)
-                          visibility_samples[s.edge].insert((int)x);
-                      break;
-                  case END:
-                      if (last_ID == s.ID)
-                          visibility_samples[s.edge].insert((int)x);
-                      break;
-                  }
+  The bands of scanlines are only rendered if a polygon that covers them
+  moved by more than getReuseThreshold() pixels since their last rendering,
+  or if the list of polygons, the camera or the size of the image changed.
 
-              // This part will only be used for MbKltTracking
-              if (maskBorder != 0 && last_ID != -1)
-              {
-                  const unsigned int y0 = std::max<unsigned int>(0, (unsigned int)(std::ceil(last_visible.p)));
-                  const double y1 = std::min<double>(h, s.p);
-                  for(unsigned int y = y0 + maskBorder ; y < y1 - maskBorder; ++y)
-                  {
-                      //primitive_ids[(unsigned int)y][(unsigned int)x] = last_visible.ID;
-                      maskX[(unsigned int)y][(unsigned int)x] = 255;
-                  }
-              }
+  \param polygons : List of polygons composed by arrays of lines.
+  \param listPolyIndices : List of polygons IDs (has to be know when using queries).
+  \param cam : Camera parameters.
+  \param width : Width of the image (render window).
+  \param height : Height of the image (render window).
+*/
+void
+vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > * > &polygons,
+                        std::vector<int> listPolyIndices,
+                        const vpCameraParameters &cam, unsigned int width, unsigned int height)
+{
+  const double t0 = vpTime::measureTimeMs();
 
-              last_ID = new_ID;
-              if (!stack.empty())
-              {
-                  last_visible = stack.front().second;
-                  last_visible.p = s.p;
-              }
-          }
-      }
+  bool fullRendering = (width != w || height != h
+                        || std::fabs(cam.get_px() - K.get_px()) > 0. || std::fabs(cam.get_py() - K.get_py()) > 0.
+                        || std::fabs(cam.get_u0() - K.get_u0()) > 0. || std::fabs(cam.get_v0() - K.get_v0()) > 0.
+                        || maskBorder != renderedMaskBorder || std::fabs(depthTreshold - renderedDepthTreshold) > 0.);
+  this->w = width;
+  this->h = height;
+  this->K = cam;
+
+  buildScene(polygons, listPolyIndices);
+
+  const unsigned int nbBands = (h + vpBandSize - 1) / vpBandSize + (w + vpBandSize - 1) / vpBandSize;
+  fullRendering = fullRendering || bands.size() != nbBands || polygonOffsets != renderedOffsets
+      || polygonIDs != renderedIDs || vertexEdges != renderedEdges;
+
+  if (fullRendering)
+  {
+    bands.resize(nbBands);
+    mask.resize(h, w, 0);
+    primitive_ids.resize(h, w, -1);
+    if (maskBorder != 0)
+    {
+      maskY.resize(h, w, 0);
+      maskX.resize(h, w, 0);
+    }
+    renderedOffsets = polygonOffsets;
+    renderedIDs = polygonIDs;
+    renderedEdges = vertexEdges;
+    renderedMaskBorder = maskBorder;
+    renderedDepthTreshold = depthTreshold;
   }
 
-  if(maskBorder != 0)
-    for(unsigned int i = 0 ; i < h ; i++)
-      for(unsigned int j = 0 ; j < w ; j++)
-        if(maskX[i][j] == 255 && maskY[i][j] == 255)
-          mask[i][j] = 255;
+  findDirtyBands(fullRendering);
+
+  if (! dirtyBands.empty())
+  {
+    if (useParallelRendering && dirtyBands.size() > 1)
+    {
+      vpMbScanLineBandTask task(*this);
+      vpThreadPool::parallel_for(0, (unsigned int)dirtyBands.size(), task, 1);
+    }
+    else
+    {
+      for(unsigned int i = 0 ; i < dirtyBands.size() ; ++i)
+        renderBand(dirtyBands[i]);
+    }
+
+    // Gather the visible samples of the edges
+    visibility_samples.resize(edgeIndexes.size());
+    for(size_t i = 0 ; i < visibility_samples.size() ; ++i)
+      visibility_samples[i].clear();
+    for(size_t i = 0 ; i < bands.size() ; ++i)
+      for(size_t j = 0 ; j < bands[i].samples.size() ; ++j)
+        visibility_samples[(size_t)bands[i].samples[j].first].push_back(bands[i].samples[j].second);
+    for(size_t i = 0 ; i < visibility_samples.size() ; ++i)
+    {
+      std::vector<int> &samples = visibility_samples[i];
+      std::sort(samples.begin(), samples.end());
+      samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
+    }
+
+    if(maskBorder != 0)
+      for(unsigned int i = 0 ; i < h ; i++)
+        for(unsigned int j = 0 ; j < w ; j++)
+          mask[i][j] = (maskX[i][j] == 255 && maskY[i][j] == 255) ? 255 : 0;
+  }
+
+  renderingTime += vpTime::measureTimeMs() - t0;
+  nbRenderings++;
+  nbRenderedBands += (unsigned int)dirtyBands.size();
+  nbReusedBands += (unsigned int)(bands.size() - dirtyBands.size());
 
 #if (defined(VISP_HAVE_X11) || defined(VISP_HAVE_GDI)) && defined(DEBUG_DISP)
   if(!dispMaskDebug->isInitialised()){
@@ -564,6 +768,35 @@ vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigne
 
 }
 
+/*!
+  Reset the rendering time and the counters of rendered and reused bands.
+*/
+void
+vpMbScanLine::resetRenderingStatistics()
+{
+  renderingTime = 0.;
+  nbRenderings = 0;
+  nbRenderedBands = 0;
+  nbReusedBands = 0;
+}
+
+/*!
+  Set the displacement in pixel under which a polygon is not rendered again by
+  drawScene(). When all the polygons covering a band moved by less than this
+  threshold, the band is not rendered and its previous result is kept.
+
+  \param threshold : Displacement in pixel. The default value 0 renders all the
+  bands covered by a polygon that moved.
+*/
+void
+vpMbScanLine::setReuseThreshold(const double threshold)
+{
+  if (threshold < 0.)
+    throw vpException(vpException::badValue, "The reuse threshold must be positive");
+  reuseThreshold = threshold;
+}
+
+
 /*!
   Test the visibility of a line. As a result, a subsampled line of the given one with all its visible parts.
 
@@ -588,7 +821,7 @@ vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
   double y1 = _b[1] / _b[2];
   double z1 = _b[2];
 
-  vpMbScanLineEdge edge = makeMbScanLineEdge(a, b);
+  std::map<vpMbScanLineEdge, int, vpMbScanLineEdgeComparator>::const_iterator edge = edgeIndexes.find(makeMbScanLineEdge(a, b));
   lines.clear();
 
   if(displayResults){
@@ -604,7 +837,8 @@ vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
 #endif
   }
 
-  if (!visibility_samples.count(edge))
+  if (edge == edgeIndexes.end() || (size_t)edge->second >= visibility_samples.size()
+      || visibility_samples[(size_t)edge->second].empty())
       return;
 
   // Initialized as the biggest difference between the two points is on the X-axis
@@ -646,12 +880,12 @@ vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
   const int _v0 = std::max(0, int(std::ceil(*v0)));
   const int _v1 = std::min<int>((int)(size - 1), (int)(std::ceil(*v1) - 1));
 
-  const std::set<int> &visible_samples = visibility_samples[edge];
+  const std::vector<int> &visible_samples = visibility_samples[(size_t)edge->second];
   int last = _v0;
   vpPoint line_start;
   vpPoint line_end;
   bool b_line_started = false;
-  for(std::set<int>::const_iterator it = visible_samples.begin() ; it != visible_samples.end() ; ++it)
+  for(std::vector<int>::const_iterator it = visible_samples.begin() ; it != visible_samples.end() ; ++it)
   {
       const int v = *it;
       const double alpha = getAlpha(v, (*v0) * (*w0), (*w0), (*v1) * (*w1), (*w1));
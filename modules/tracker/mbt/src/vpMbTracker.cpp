@@ -91,15 +91,24 @@
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
+#ifdef VISP_HAVE_COIN3D
+/*!
+  The primitives of the vrml models use the default LOD parameters of
+  vpMbTracker::addPolygon() whatever the settings of the tracker.
+ */
+const unsigned int vrmlPrimitiveFlags = vpMbtCompiledModel::HAS_USE_LOD | vpMbtCompiledModel::HAS_MIN_POLYGON_AREA |
+    vpMbtCompiledModel::HAS_MIN_LINE_LENGTH;
+#endif
+
 /*!
   Structure to store info about segment in CAO model files.
  */
 struct SegmentInfo {
-  SegmentInfo() : extremities(), name(), useLod(false), minLineLengthThresh(0.) {}
+  SegmentInfo() : extremities(), name(), flags(0), minLineLengthThresh(0.) {}
 
   std::vector<vpPoint> extremities;
   std::string name;
-  bool useLod;
+  unsigned int flags;
   double minLineLengthThresh;
 };
 
@@ -134,7 +143,7 @@ vpMbTracker::vpMbTracker()
   distFarClip(100), clippingFlag(vpPolygon3D::NO_CLIPPING), useOgre(false), ogreShowConfigDialog(false), useScanLine(false),
   nbPoints(0), nbLines(0), nbPolygonLines(0), nbPolygonPoints(0), nbCylinders(0), nbCircles(0),
   useLodGeneral(false), applyLodSettingInConfig(false), minLineLengthThresholdGeneral(50.0),
-  minPolygonAreaThresholdGeneral(2500.0), mapOfParameterNames()
+  minPolygonAreaThresholdGeneral(2500.0), mapOfParameterNames(), m_compiledModel(), m_compiledModelFirstIdFace(0)
 {
     oJo.eye();
     //Map used to parse additional information in CAO model files,
@@ -985,10 +994,114 @@ void vpMbTracker::addPolygon(const std::vector<std::vector<vpPoint> > &listFaces
     }
 }
 
+/*!
+  Add a primitive extracted from a cao or vrml model to the tracker and
+  append it to the compiled model that can be saved with saveCompiledModel().
+
+  \param type : Type of the primitive.
+  \param points : Points of the primitive (see vpMbtCompiledModel::addPrimitive()).
+  \param idFace : Id of the (first) face of the primitive.
+  \param name : Name of the primitive.
+  \param flags : Parameters set in the model, combination of vpMbtCompiledModel::vpPrimitiveFlag.
+  \param radius : Radius of the cylinders and circles.
+  \param minPolygonAreaThreshold : Minimum polygon area threshold, used if it is set in \e flags.
+  \param minLineLengthThreshold : Minimum line length threshold, used if it is set in \e flags.
+*/
+void
+vpMbTracker::addModelPrimitive(const vpMbtCompiledModel::vpPrimitiveType type, const std::vector<vpPoint> &points,
+                               const int idFace, const std::string &name, const unsigned int flags, const double radius,
+                               const double minPolygonAreaThreshold, const double minLineLengthThreshold)
+{
+  m_compiledModel.addPrimitive(type, points, idFace - m_compiledModelFirstIdFace, name, flags, radius,
+                               minPolygonAreaThreshold, minLineLengthThreshold);
+  initModelPrimitive(m_compiledModel.getPrimitive(m_compiledModel.getNbPrimitives()-1), points, name,
+                     m_compiledModelFirstIdFace);
+}
+
+/*!
+  Add a primitive of a compiled model to the tracker : create its polygons and
+  call the corresponding initFaceFromLines(), initFaceFromCorners(),
+  initCylinder() or initCircle() method. The LOD parameters that are not set in
+  the model are taken from the general settings of the tracker, as when a cao
+  model is parsed.
+
+  \param primitive : Primitive to add.
+  \param points : Points of the primitive.
+  \param name : Name of the primitive.
+  \param firstIdFace : Id of the first face of the model.
+*/
+void
+vpMbTracker::initModelPrimitive(const vpMbtCompiledModel::vpPrimitive &primitive, const std::vector<vpPoint> &points,
+                                const std::string &name, const int firstIdFace)
+{
+  const int idFace = firstIdFace + primitive.idFace;
+  const bool hasMinPolygonArea = (primitive.flags & vpMbtCompiledModel::HAS_MIN_POLYGON_AREA) != 0;
+  const bool hasMinLineLength = (primitive.flags & vpMbtCompiledModel::HAS_MIN_LINE_LENGTH) != 0;
+  bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
+  if (primitive.flags & vpMbtCompiledModel::HAS_USE_LOD) {
+    useLod = (primitive.flags & vpMbtCompiledModel::USE_LOD) != 0;
+  }
+
+  switch (primitive.type) {
+  case vpMbtCompiledModel::POLYGON_FROM_LINES:
+  case vpMbtCompiledModel::POLYGON_FROM_POINTS: {
+    double minPolygonAreaThreshold = hasMinPolygonArea ? primitive.minPolygonArea :
+        (!applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0);
+    double minLineLengthThreshold = hasMinLineLength ? primitive.minLineLength : minLineLengthThresholdGeneral;
+
+    addPolygon(points, idFace, name, useLod, minPolygonAreaThreshold, minLineLengthThreshold);
+    if (primitive.type == vpMbtCompiledModel::POLYGON_FROM_LINES) {
+      initFaceFromLines(*(faces.getPolygon().back())); // Init from the last polygon that was added
+    }
+    else {
+      initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
+    }
+    break;
+  }
+
+  case vpMbtCompiledModel::SEGMENT: {
+    double minPolygonAreaThreshold = hasMinPolygonArea ? primitive.minPolygonArea : minPolygonAreaThresholdGeneral;
+    double minLineLengthThreshold = hasMinLineLength ? primitive.minLineLength :
+        (!applyLodSettingInConfig ? minLineLengthThresholdGeneral : 50.0);
+
+    addPolygon(points, idFace, name, useLod, minPolygonAreaThreshold, minLineLengthThreshold);
+    initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
+    break;
+  }
+
+  case vpMbtCompiledModel::CYLINDER: {
+    double minLineLengthThreshold = hasMinLineLength ? primitive.minLineLength :
+        (!applyLodSettingInConfig ? minLineLengthThresholdGeneral : 50.0);
+
+    addPolygon(points[0], points[1], idFace, name, useLod, minLineLengthThreshold);
+
+    std::vector<std::vector<vpPoint> > listFaces;
+    createCylinderBBox(points[0], points[1], primitive.radius, listFaces);
+    addPolygon(listFaces, idFace+1, name, useLod, minLineLengthThreshold);
+
+    initCylinder(points[0], points[1], primitive.radius, idFace, name);
+    break;
+  }
+
+  case vpMbtCompiledModel::CIRCLE: {
+    double minPolygonAreaThreshold = hasMinPolygonArea ? primitive.minPolygonArea :
+        (!applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0);
+
+    addPolygon(points[0], points[1], points[2], primitive.radius, idFace, name, useLod, minPolygonAreaThreshold);
+    initCircle(points[0], points[1], points[2], primitive.radius, idFace, name);
+    break;
+  }
+
+  default:
+    throw vpException(vpException::badValue, "Unknown type of model primitive");
+  }
+}
+
 /*!
   Load a 3D model from the file in parameter. This file must either be a vrml
-  file (.wrl) or a CAO file (.cao). CAO format is described in the 
-  loadCAOModel() method. 
+  file (.wrl), a CAO file (.cao) or a compiled model saved with
+  saveCompiledModel(). CAO format is described in the
+  loadCAOModel() method.
 
   \warning When this class is called to load a vrml model, remember that you
   have to call Call SoDD::finish() before ending the program.
@@ -1018,9 +1131,15 @@ vpMbTracker::loadModel(const char *modelFile, const bool verbose)
 
 /*!
   Load a 3D model from the file in parameter. This file must either be a vrml
-  file (.wrl) or a CAO file (.cao). CAO format is described in the
+  file (.wrl), a CAO file (.cao) or a compiled model saved with
+  saveCompiledModel(). CAO format is described in the
   loadCAOModel() method.
 
+  A compiled model is detected from the signature at the beginning of the
+  file, whatever its extension. It is loaded without parsing, unless one of
+  the model files it was built from has been modified since : the original
+  model is then loaded instead.
+
   \warning When this class is called to load a vrml model, remember that you
   have to call Call SoDD::finish() before ending the program.
   \code
@@ -1034,12 +1153,14 @@ int main()
   \endcode
 
   \throw vpException::ioError if the file cannot be open, or if its extension is
-  not wrl or cao.
+  not wrl or cao and it is not a compiled model.
 
   \param modelFile : the file containing the the 3D model description.
-  The extension of this file is either .wrl or .cao.
+  The extension of this file is either .wrl or .cao, or the file is a compiled model.
   \param verbose : verbose option to print additional information when loading CAO model files which include other
   CAO model files.
+
+  \sa saveCompiledModel()
 */
 void
 vpMbTracker::loadModel(const std::string& modelFile, const bool verbose)
@@ -1058,11 +1179,25 @@ vpMbTracker::loadModel(const std::string& modelFile, const bool verbose)
       nbPolygonPoints = 0;
       nbCylinders = 0;
       nbCircles = 0;
+      m_compiledModel.clear();
+      m_compiledModelFirstIdFace = startIdFace;
       loadCAOModel(modelFile, vectorOfModelFilename, startIdFace, verbose, true);
+
+      m_compiledModel.setStatistics(nbPoints, nbLines, nbPolygonLines, nbPolygonPoints, nbCylinders, nbCircles);
+      for (std::vector<std::string>::const_iterator it_file = vectorOfModelFilename.begin();
+           it_file != vectorOfModelFilename.end(); ++it_file) {
+        m_compiledModel.addSource(*it_file);
+      }
     }
     else if((*(it-1) == 'l' && *(it-2) == 'r' && *(it-3) == 'w' && *(it-4) == '.') ||
             (*(it-1) == 'L' && *(it-2) == 'R' && *(it-3) == 'W' && *(it-4) == '.') ){
+      m_compiledModel.clear();
+      m_compiledModelFirstIdFace = (int)faces.size();
       loadVRMLModel(modelFile);
+      m_compiledModel.addSource(modelFile);
+    }
+    else if(vpMbtCompiledModel::isCompiledModel(modelFile)) {
+      loadCompiledModel(modelFile, verbose);
     }
     else{
       throw vpException(vpException::ioError, "Error: File %s doesn't contain a cao or wrl model", modelFile.c_str());
@@ -1076,6 +1211,89 @@ vpMbTracker::loadModel(const std::string& modelFile, const bool verbose)
   this->modelFileName = modelFile;
 }
 
+/*!
+  Save the primitives of the model loaded by the last call to loadModel() in a
+  binary file. This file can then be given to loadModel() to load the model
+  without parsing the original cao or wrl files, which is much faster for large
+  models.
+
+  The compiled model stores the size and a hash of the files the model was
+  read from, so that it is not used anymore once they are modified. The LOD
+  parameters written in a cao file are stored as they are : the LOD settings
+  of the tracker are applied when the compiled model is loaded.
+
+  \code
+  vpMbEdgeTracker tracker;
+  if (! vpIoTools::checkFilename("model.bin")) {
+    tracker.loadModel("model.cao");
+    tracker.saveCompiledModel("model.bin");
+  }
+  else {
+    tracker.loadModel("model.bin");
+  }
+  \endcode
+
+  \throw vpException::notInitialized if no model was loaded.
+  \throw vpException::ioError if the file cannot be written.
+
+  \param compiledModelFile : Name of the compiled model file.
+
+  \sa loadModel()
+*/
+void
+vpMbTracker::saveCompiledModel(const std::string &compiledModelFile) const
+{
+  if (!modelInitialised) {
+    throw vpException(vpException::notInitialized, "No model loaded, cannot save the compiled model");
+  }
+
+  m_compiledModel.save(compiledModelFile);
+}
+
+/*!
+  Load a compiled model saved with saveCompiledModel(). If one of the files
+  the model was built from has been modified, the main one is loaded instead.
+
+  \param modelFile : Name of the compiled model file.
+  \param verbose : verbose option to print additional information.
+*/
+void
+vpMbTracker::loadCompiledModel(const std::string& modelFile, const bool verbose)
+{
+  m_compiledModel.load(modelFile);
+
+  const std::vector<std::string> &sources = m_compiledModel.getSources();
+  if (!m_compiledModel.isUpToDate() && !sources.empty() && vpIoTools::checkFilename(sources.front())) {
+    std::string source = sources.front();
+    std::cout << "WARNING The compiled model " << modelFile << " is out of date, loading "
+              << source << " instead" << std::endl;
+    vpMbTracker::loadModel(source, verbose);
+    return;
+  }
+
+  if(verbose) {
+    std::cout << "Compiled model file : " << modelFile << std::endl;
+  }
+
+  m_compiledModel.getStatistics(nbPoints, nbLines, nbPolygonLines, nbPolygonPoints, nbCylinders, nbCircles);
+  std::cout << "> " << nbPoints << " points" << std::endl;
+  std::cout << "> " << nbLines << " lines" << std::endl;
+  std::cout << "> " << nbPolygonLines << " polygon lines" << std::endl;
+  std::cout << "> " << nbPolygonPoints << " polygon points" << std::endl;
+  std::cout << "> " << nbCylinders << " cylinders" << std::endl;
+  std::cout << "> " << nbCircles << " circles" << std::endl;
+
+  m_compiledModelFirstIdFace = (int)faces.size();
+  faces.getPolygon().reserve(faces.size() + m_compiledModel.getNbFaces());
+
+  std::vector<vpPoint> points;
+  for (unsigned int i = 0; i < m_compiledModel.getNbPrimitives(); i++) {
+    const vpMbtCompiledModel::vpPrimitive &primitive = m_compiledModel.getPrimitive(i);
+    m_compiledModel.getPoints(primitive, points);
+    initModelPrimitive(primitive, points, m_compiledModel.getName(primitive), m_compiledModelFirstIdFace);
+  }
+}
+
 
 /*!
   Load the 3D model of the object from a vrml file. Only LineSet and FaceSet are
@@ -1457,21 +1675,25 @@ vpMbTracker::loadCAOModel(const std::string& modelFile,
       std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
 
       std::string segmentName = "";
-      double minLineLengthThresh = !applyLodSettingInConfig ? minLineLengthThresholdGeneral : 50.0;
-      bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
+      double minLineLengthThresh = 0.;
+      unsigned int flags = 0;
       if(mapOfParams.find("name") != mapOfParams.end()) {
         segmentName = mapOfParams["name"];
       }
       if(mapOfParams.find("minLineLengthThreshold") != mapOfParams.end()) {
         minLineLengthThresh = std::atof(mapOfParams["minLineLengthThreshold"].c_str());
+        flags |= vpMbtCompiledModel::HAS_MIN_LINE_LENGTH;
       }
       if(mapOfParams.find("useLod") != mapOfParams.end()) {
-        useLod = parseBoolean(mapOfParams["useLod"]);
+        flags |= vpMbtCompiledModel::HAS_USE_LOD;
+        if (parseBoolean(mapOfParams["useLod"])) {
+          flags |= vpMbtCompiledModel::USE_LOD;
+        }
       }
 
       SegmentInfo segmentInfo;
       segmentInfo.name = segmentName;
-      segmentInfo.useLod = useLod;
+      segmentInfo.flags = flags;
       segmentInfo.minLineLengthThresh = minLineLengthThresh;
 
       caoLinePoints[2 * k] = index1;
@@ -1547,29 +1769,32 @@ vpMbTracker::loadCAOModel(const std::string& modelFile,
       std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
 
       std::string polygonName = "";
-      bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
-      double minPolygonAreaThreshold = !applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0;
+      double minPolygonAreaThreshold = 0.;
+      unsigned int flags = 0;
       if(mapOfParams.find("name") != mapOfParams.end()) {
         polygonName = mapOfParams["name"];
       }
       if(mapOfParams.find("minPolygonAreaThreshold") != mapOfParams.end()) {
         minPolygonAreaThreshold = std::atof(mapOfParams["minPolygonAreaThreshold"].c_str());
+        flags |= vpMbtCompiledModel::HAS_MIN_POLYGON_AREA;
       }
       if(mapOfParams.find("useLod") != mapOfParams.end()) {
-        useLod = parseBoolean(mapOfParams["useLod"]);
+        flags |= vpMbtCompiledModel::HAS_USE_LOD;
+        if (parseBoolean(mapOfParams["useLod"])) {
+          flags |= vpMbtCompiledModel::USE_LOD;
+        }
       }
 
-      addPolygon(corners, idFace++, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
-      initFaceFromLines(*(faces.getPolygon().back())); // Init from the last polygon that was added
+      addModelPrimitive(vpMbtCompiledModel::POLYGON_FROM_LINES, corners, idFace++, polygonName, flags, 0.,
+                        minPolygonAreaThreshold);
     }
 
     //Add the segments which were not already added in the face segment case
     for(std::map<std::pair<unsigned int, unsigned int>, SegmentInfo >::const_iterator it =
         segmentTemporaryMap.begin(); it != segmentTemporaryMap.end(); ++it) {
       if(std::find(faceSegmentKeyVector.begin(), faceSegmentKeyVector.end(), it->first) == faceSegmentKeyVector.end()) {
-        addPolygon(it->second.extremities, idFace++, it->second.name, it->second.useLod, minPolygonAreaThresholdGeneral,
-                   it->second.minLineLengthThresh);
-        initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
+        addModelPrimitive(vpMbtCompiledModel::SEGMENT, it->second.extremities, idFace++, it->second.name,
+                          it->second.flags, 0., 0., it->second.minLineLengthThresh);
       }
     }
 
@@ -1621,21 +1846,24 @@ vpMbTracker::loadCAOModel(const std::string& modelFile,
       std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
 
       std::string polygonName = "";
-      bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
-      double minPolygonAreaThreshold = !applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0;
+      double minPolygonAreaThreshold = 0.;
+      unsigned int flags = 0;
       if(mapOfParams.find("name") != mapOfParams.end()) {
         polygonName = mapOfParams["name"];
       }
       if(mapOfParams.find("minPolygonAreaThreshold") != mapOfParams.end()) {
         minPolygonAreaThreshold = std::atof(mapOfParams["minPolygonAreaThreshold"].c_str());
+        flags |= vpMbtCompiledModel::HAS_MIN_POLYGON_AREA;
       }
       if(mapOfParams.find("useLod") != mapOfParams.end()) {
-        useLod = parseBoolean(mapOfParams["useLod"]);
+        flags |= vpMbtCompiledModel::HAS_USE_LOD;
+        if (parseBoolean(mapOfParams["useLod"])) {
+          flags |= vpMbtCompiledModel::USE_LOD;
+        }
       }
 
-
-      addPolygon(corners, idFace++, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
-      initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
+      addModelPrimitive(vpMbtCompiledModel::POLYGON_FROM_POINTS, corners, idFace++, polygonName, flags, 0.,
+                        minPolygonAreaThreshold);
     }
 
     //////////////////////////Read the cylinder declaration part//////////////////////////
@@ -1680,27 +1908,29 @@ vpMbTracker::loadCAOModel(const std::string& modelFile,
         std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
 
         std::string polygonName = "";
-        bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
-        double minLineLengthThreshold = !applyLodSettingInConfig ? minLineLengthThresholdGeneral : 50.0;
+        double minLineLengthThreshold = 0.;
+        unsigned int flags = 0;
         if(mapOfParams.find("name") != mapOfParams.end()) {
           polygonName = mapOfParams["name"];
         }
         if(mapOfParams.find("minLineLengthThreshold") != mapOfParams.end()) {
           minLineLengthThreshold = std::atof(mapOfParams["minLineLengthThreshold"].c_str());
+          flags |= vpMbtCompiledModel::HAS_MIN_LINE_LENGTH;
         }
         if(mapOfParams.find("useLod") != mapOfParams.end()) {
-          useLod = parseBoolean(mapOfParams["useLod"]);
+          flags |= vpMbtCompiledModel::HAS_USE_LOD;
+          if (parseBoolean(mapOfParams["useLod"])) {
+            flags |= vpMbtCompiledModel::USE_LOD;
+          }
         }
 
-        int idRevolutionAxis = idFace;
-        addPolygon(caoPoints[indexP1], caoPoints[indexP2], idFace++, polygonName, useLod, minLineLengthThreshold);
-
-        std::vector<std::vector<vpPoint> > listFaces;
-        createCylinderBBox(caoPoints[indexP1], caoPoints[indexP2], radius,listFaces);
-        addPolygon(listFaces, idFace, polygonName, useLod, minLineLengthThreshold);
-        idFace+=4;
-
-        initCylinder(caoPoints[indexP1], caoPoints[indexP2], radius, idRevolutionAxis, polygonName);
+        // Revolution axis and the four faces of the bounding box
+        std::vector<vpPoint> axis;
+        axis.push_back(caoPoints[indexP1]);
+        axis.push_back(caoPoints[indexP2]);
+        addModelPrimitive(vpMbtCompiledModel::CYLINDER, axis, idFace, polygonName, flags, radius, 0.,
+                          minLineLengthThreshold);
+        idFace+=5;
       }
 
     } catch (...) {
@@ -1753,23 +1983,28 @@ vpMbTracker::loadCAOModel(const std::string& modelFile,
         std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
 
         std::string polygonName = "";
-        bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
-        double minPolygonAreaThreshold = !applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0;
+        double minPolygonAreaThreshold = 0.;
+        unsigned int flags = 0;
         if(mapOfParams.find("name") != mapOfParams.end()) {
           polygonName = mapOfParams["name"];
         }
         if(mapOfParams.find("minPolygonAreaThreshold") != mapOfParams.end()) {
           minPolygonAreaThreshold = std::atof(mapOfParams["minPolygonAreaThreshold"].c_str());
+          flags |= vpMbtCompiledModel::HAS_MIN_POLYGON_AREA;
         }
         if(mapOfParams.find("useLod") != mapOfParams.end()) {
-          useLod = parseBoolean(mapOfParams["useLod"]);
+          flags |= vpMbtCompiledModel::HAS_USE_LOD;
+          if (parseBoolean(mapOfParams["useLod"])) {
+            flags |= vpMbtCompiledModel::USE_LOD;
+          }
         }
 
-        addPolygon(caoPoints[indexP1], caoPoints[indexP2],
-                   caoPoints[indexP3], radius, idFace, polygonName, useLod, minPolygonAreaThreshold);
-
-        initCircle(caoPoints[indexP1], caoPoints[indexP2],
-                   caoPoints[indexP3], radius, idFace++, polygonName);
+        std::vector<vpPoint> circlePoints;
+        circlePoints.push_back(caoPoints[indexP1]);
+        circlePoints.push_back(caoPoints[indexP2]);
+        circlePoints.push_back(caoPoints[indexP3]);
+        addModelPrimitive(vpMbtCompiledModel::CIRCLE, circlePoints, idFace++, polygonName, flags, radius,
+                          minPolygonAreaThreshold);
       }
 
     } catch (...) {
@@ -1925,8 +2160,8 @@ vpMbTracker::extractFaces(SoVRMLIndexedFaceSet* face_set, vpHomogeneousMatrix &t
     {
       if(corners.size() > 1)
       {
-        addPolygon(corners, idFace++, polygonName);
-        initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
+        addModelPrimitive(vpMbtCompiledModel::POLYGON_FROM_POINTS, corners, idFace++, polygonName,
+                          vrmlPrimitiveFlags, 0., 2500.0, 50.0);
         corners.resize(0);
       }
     }
@@ -2016,18 +2251,13 @@ vpMbTracker::extractCylinders(SoVRMLIndexedFaceSet* face_set, vpHomogeneousMatri
     throw vpException(vpException::badValue, "Radius from the two circles of the cylinders are different.");
   }
 
-  //addPolygon(p1, p2, idFace, polygonName);
-  //initCylinder(p1, p2, radius_c1, idFace++);
-
-  int idRevolutionAxis = idFace;
-  addPolygon(p1, p2, idFace++, polygonName);
-
-  std::vector<std::vector<vpPoint> > listFaces;
-  createCylinderBBox(p1, p2, radius_c1, listFaces);
-  addPolygon(listFaces, idFace, polygonName);
-  idFace+=4;
-
-  initCylinder(p1, p2, radius_c1, idRevolutionAxis, polygonName);
+  // Revolution axis and the four faces of the bounding box
+  std::vector<vpPoint> axis;
+  axis.push_back(p1);
+  axis.push_back(p2);
+  addModelPrimitive(vpMbtCompiledModel::CYLINDER, axis, idFace, polygonName, vrmlPrimitiveFlags, radius_c1,
+                    2500.0, 50.0);
+  idFace+=5;
 }
 
 /*!
@@ -2056,8 +2286,8 @@ vpMbTracker::extractLines(SoVRMLIndexedLineSet* line_set, int &idFace, const std
     {
       if(corners.size() > 1)
       {
-        addPolygon(corners, idFace++, polygonName);
-        initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
+        addModelPrimitive(vpMbtCompiledModel::POLYGON_FROM_POINTS, corners, idFace++, polygonName,
+                          vrmlPrimitiveFlags, 0., 2500.0, 50.0);
         corners.resize(0);
       }
     }
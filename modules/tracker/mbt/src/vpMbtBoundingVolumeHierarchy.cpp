@@ -0,0 +1,299 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Bounding volume hierarchy used for the frustum culling of the faces of the
+ * model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+ \file vpMbtBoundingVolumeHierarchy.cpp
+ \brief Bounding volume hierarchy used for the frustum culling of the faces
+ of the model-based trackers.
+*/
+
+#include <algorithm>
+#include <limits>
+
+#include <visp3/mbt/vpMbtBoundingVolumeHierarchy.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Maximal number of volumes in a leaf of the tree.
+  const unsigned int vpMaxLeafSize = 4;
+
+  // Number of planes of the frustum: near, left, right, top and bottom.
+  const unsigned int vpNbPlanes = 5;
+
+  struct vpCenterComparator {
+    vpCenterComparator(const std::vector<double> &centers, unsigned int axis) : m_centers(centers), m_axis(axis) {}
+    bool operator()(unsigned int a, unsigned int b) const {
+      return m_centers[3*a + m_axis] < m_centers[3*b + m_axis];
+    }
+    const std::vector<double> &m_centers;
+    unsigned int m_axis;
+  };
+
+  // Test a box against the planes n.X + d >= 0 whose bit is set in mask.
+  // Return false if the box is outside one plane, and clear the bits of the
+  // planes the box is entirely inside.
+  inline bool intersectFrustum(const double *min, const double *max,
+                               const double planes[][4], unsigned int &mask)
+  {
+    for (unsigned int p = 0; p < vpNbPlanes; p++) {
+      if (! (mask & (1u << p)))
+        continue;
+
+      double farthest = planes[p][3], nearest = planes[p][3];
+      for (unsigned int k = 0; k < 3; k++) {
+        if (planes[p][k] >= 0.) {
+          farthest += planes[p][k] * max[k];
+          nearest += planes[p][k] * min[k];
+        }
+        else {
+          farthest += planes[p][k] * min[k];
+          nearest += planes[p][k] * max[k];
+        }
+      }
+      if (farthest < 0.)
+        return false;
+      if (nearest >= 0.)
+        mask &= ~(1u << p);
+    }
+    return true;
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor of an empty hierarchy.
+*/
+vpMbtBoundingVolumeHierarchy::vpMbtBoundingVolumeHierarchy()
+  : m_volumes(), m_bounded(), m_centers(), m_order(), m_nodes(), m_unbounded(), m_built(false)
+{
+}
+
+/*!
+  Add the volume of a face. Its index is the number of volumes added before.
+
+  \param points : Vertices of the face. Their coordinates in the object frame
+  are used.
+  \param nbPoints : Number of vertices. A volume without vertex is always
+  considered as visible.
+*/
+void vpMbtBoundingVolumeHierarchy::addVolume(const vpPoint *points, const unsigned int nbPoints)
+{
+  vpBox box;
+  for (unsigned int k = 0; k < 3; k++) {
+    box.min[k] = std::numeric_limits<double>::max();
+    box.max[k] = -std::numeric_limits<double>::max();
+  }
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    const double P[3] = { points[i].get_oX(), points[i].get_oY(), points[i].get_oZ() };
+    for (unsigned int k = 0; k < 3; k++) {
+      box.min[k] = std::min(box.min[k], P[k]);
+      box.max[k] = std::max(box.max[k], P[k]);
+    }
+  }
+  m_volumes.push_back(box);
+  m_bounded.push_back(nbPoints > 0);
+  m_built = false;
+}
+
+/*!
+  Build the tree from the volumes added with addVolume(). The volumes of a
+  node are split at the median of the centers of their boxes, along the axis
+  where the centers are the most spread.
+*/
+void vpMbtBoundingVolumeHierarchy::build()
+{
+  m_order.clear();
+  m_unbounded.clear();
+  m_nodes.clear();
+  m_centers.resize(3 * m_volumes.size());
+  for (unsigned int i = 0; i < m_volumes.size(); i++) {
+    if (m_bounded[i]) {
+      m_order.push_back(i);
+      for (unsigned int k = 0; k < 3; k++)
+        m_centers[3*i + k] = 0.5 * (m_volumes[i].min[k] + m_volumes[i].max[k]);
+    }
+    else {
+      m_unbounded.push_back(i);
+    }
+  }
+
+  if (! m_order.empty()) {
+    m_nodes.reserve(2 * m_order.size());
+    buildNode(0, (unsigned int)m_order.size());
+  }
+  m_built = true;
+}
+
+/*!
+  Create the node of the volumes m_order[first] to m_order[first+count-1] and
+  its children.
+
+  \return Index of the node.
+*/
+unsigned int vpMbtBoundingVolumeHierarchy::buildNode(const unsigned int first, const unsigned int count)
+{
+  const unsigned int index = (unsigned int)m_nodes.size();
+  vpNode node;
+  node.first = first;
+  node.count = count;
+  node.right = 0;
+
+  double cmin[3], cmax[3];
+  for (unsigned int k = 0; k < 3; k++) {
+    node.box.min[k] = cmin[k] = std::numeric_limits<double>::max();
+    node.box.max[k] = cmax[k] = -std::numeric_limits<double>::max();
+  }
+  for (unsigned int i = first; i < first + count; i++) {
+    const unsigned int v = m_order[i];
+    for (unsigned int k = 0; k < 3; k++) {
+      node.box.min[k] = std::min(node.box.min[k], m_volumes[v].min[k]);
+      node.box.max[k] = std::max(node.box.max[k], m_volumes[v].max[k]);
+      cmin[k] = std::min(cmin[k], m_centers[3*v + k]);
+      cmax[k] = std::max(cmax[k], m_centers[3*v + k]);
+    }
+  }
+  m_nodes.push_back(node);
+
+  if (count <= vpMaxLeafSize)
+    return index;
+
+  unsigned int axis = 0;
+  for (unsigned int k = 1; k < 3; k++)
+    if (cmax[k] - cmin[k] > cmax[axis] - cmin[axis])
+      axis = k;
+
+  const unsigned int half = count / 2;
+  std::nth_element(m_order.begin() + first, m_order.begin() + first + half, m_order.begin() + first + count,
+                   vpCenterComparator(m_centers, axis));
+
+  buildNode(first, half);
+  const unsigned int right = buildNode(first + half, count - half);
+  m_nodes[index].right = right;
+  return index;
+}
+
+/*!
+  Find the volumes that may be seen by a camera.
+
+  \param cMo : Pose of the camera.
+  \param cam : Camera parameters.
+  \param width, height : Size of the image.
+  \param nearDistance : Distance of the near plane of the frustum.
+  \param indexes : Indexes of the volumes whose box intersects the frustum, in
+  no particular order. If build() has not been called since the last volume
+  was added, all the volumes are returned.
+*/
+void vpMbtBoundingVolumeHierarchy::computeVisibleVolumes(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                                                         const unsigned int width, const unsigned int height,
+                                                         const double nearDistance,
+                                                         std::vector<unsigned int> &indexes) const
+{
+  indexes.clear();
+  if (! m_built) {
+    for (unsigned int i = 0; i < m_volumes.size(); i++)
+      indexes.push_back(i);
+    return;
+  }
+
+  indexes = m_unbounded;
+  if (m_nodes.empty())
+    return;
+
+  // Planes of the frustum in the camera frame, the normal pointing inside
+  const double xmin = -cam.get_u0() / cam.get_px(), xmax = ((double)width - cam.get_u0()) / cam.get_px();
+  const double ymin = -cam.get_v0() / cam.get_py(), ymax = ((double)height - cam.get_v0()) / cam.get_py();
+  const double cPlanes[vpNbPlanes][4] = {
+    { 0., 0., 1., -nearDistance },
+    { 1., 0., -xmin, 0. },
+    { -1., 0., xmax, 0. },
+    { 0., 1., -ymin, 0. },
+    { 0., -1., ymax, 0. }
+  };
+
+  // Same planes in the object frame
+  double planes[vpNbPlanes][4];
+  for (unsigned int p = 0; p < vpNbPlanes; p++) {
+    planes[p][3] = cPlanes[p][3];
+    for (unsigned int j = 0; j < 3; j++) {
+      planes[p][j] = 0.;
+      for (unsigned int i = 0; i < 3; i++)
+        planes[p][j] += cMo[i][j] * cPlanes[p][i];
+      planes[p][3] += cPlanes[p][j] * cMo[j][3];
+    }
+  }
+
+  std::vector<std::pair<unsigned int, unsigned int> > stack;
+  stack.push_back(std::make_pair(0u, (1u << vpNbPlanes) - 1));
+  while (! stack.empty()) {
+    const unsigned int current = stack.back().first;
+    const vpNode &node = m_nodes[current];
+    unsigned int mask = stack.back().second;
+    stack.pop_back();
+
+    if (! intersectFrustum(node.box.min, node.box.max, planes, mask))
+      continue;
+
+    if (mask == 0) {
+      // Entirely inside the frustum
+      indexes.insert(indexes.end(), m_order.begin() + node.first, m_order.begin() + node.first + node.count);
+    }
+    else if (node.right == 0) {
+      for (unsigned int i = node.first; i < node.first + node.count; i++) {
+        unsigned int volumeMask = mask;
+        const vpBox &box = m_volumes[m_order[i]];
+        if (intersectFrustum(box.min, box.max, planes, volumeMask))
+          indexes.push_back(m_order[i]);
+      }
+    }
+    else {
+      stack.push_back(std::make_pair(node.right, mask));
+      stack.push_back(std::make_pair(current + 1, mask));
+    }
+  }
+}
+
+/*!
+  Remove all the volumes.
+*/
+void vpMbtBoundingVolumeHierarchy::reset()
+{
+  m_volumes.clear();
+  m_bounded.clear();
+  m_centers.clear();
+  m_order.clear();
+  m_nodes.clear();
+  m_unbounded.clear();
+  m_built = false;
+}
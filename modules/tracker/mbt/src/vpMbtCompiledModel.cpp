@@ -0,0 +1,538 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compiled binary representation of the 3D models of the model-based
+ * trackers.
+ *
+ *****************************************************************************/
+
+/*!
+ \file vpMbtCompiledModel.cpp
+ \brief Compiled binary representation of the 3D models of the model-based
+ trackers.
+*/
+
+#include <cstring>
+#include <fstream>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/mbt/vpMbtCompiledModel.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Signature at the beginning of the compiled model files.
+  const char vpCompiledModelMagic[8] = { 'V', 'P', 'M', 'B', 'T', 'B', 'I', 'N' };
+  // Version of the file format, to increase when the layout changes.
+  const unsigned int vpCompiledModelVersion = 1;
+
+  const uint64_t vpFnvOffsetBasis = 14695981039346656037ULL;
+  const uint64_t vpFnvPrime = 1099511628211ULL;
+
+  // 64 bits FNV-1a hash of a buffer.
+  uint64_t fnv1a(const unsigned char *data, const size_t size, uint64_t hash=vpFnvOffsetBasis) {
+    for (size_t i = 0; i < size; i++) {
+      hash ^= data[i];
+      hash *= vpFnvPrime;
+    }
+    return hash;
+  }
+
+  // Size and hash of a file, return false if it cannot be read.
+  bool hashFile(const std::string &filename, uint64_t &size, uint64_t &hash) {
+    std::ifstream file(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+    if (!file.is_open()) {
+      return false;
+    }
+
+    size = 0;
+    hash = vpFnvOffsetBasis;
+    char buffer[65536];
+    while (file) {
+      file.read(buffer, sizeof(buffer));
+      std::streamsize n = file.gcount();
+      hash = fnv1a((const unsigned char *)buffer, (size_t)n, hash);
+      size += (uint64_t)n;
+    }
+    return true;
+  }
+
+  // Little endian serialisation in a memory buffer, independent of the
+  // endianness of the host.
+  class vpBinaryWriter {
+  public:
+    std::vector<unsigned char> data;
+
+    void writeUInt64(const uint64_t value) {
+      for (unsigned int i = 0; i < 8; i++) {
+        data.push_back((unsigned char)((value >> (8*i)) & 0xFF));
+      }
+    }
+    void writeUInt(const unsigned int value) {
+      for (unsigned int i = 0; i < 4; i++) {
+        data.push_back((unsigned char)((value >> (8*i)) & 0xFF));
+      }
+    }
+    void writeInt(const int value) {
+      writeUInt((unsigned int)value);
+    }
+    void writeDouble(const double value) {
+      uint64_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      writeUInt64(bits);
+    }
+    void writeString(const std::string &value) {
+      writeUInt((unsigned int)value.size());
+      data.insert(data.end(), value.begin(), value.end());
+    }
+  };
+
+  // Little endian deserialisation from a memory buffer with bound checking.
+  class vpBinaryReader {
+  public:
+    vpBinaryReader(const std::vector<unsigned char> &buffer, const size_t end)
+      : m_data(buffer.empty() ? NULL : &buffer[0]), m_end(end), m_pos(0) {}
+
+    void skip(const size_t size) {
+      check(size);
+      m_pos += size;
+    }
+    uint64_t readUInt64() {
+      check(8);
+      uint64_t value = 0;
+      for (unsigned int i = 0; i < 8; i++) {
+        value |= ((uint64_t)m_data[m_pos+i]) << (8*i);
+      }
+      m_pos += 8;
+      return value;
+    }
+    unsigned int readUInt() {
+      check(4);
+      unsigned int value = (unsigned int)m_data[m_pos] | ((unsigned int)m_data[m_pos+1] << 8) |
+          ((unsigned int)m_data[m_pos+2] << 16) | ((unsigned int)m_data[m_pos+3] << 24);
+      m_pos += 4;
+      return value;
+    }
+    int readInt() {
+      return (int)readUInt();
+    }
+    double readDouble() {
+      uint64_t bits = readUInt64();
+      double value;
+      memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+    std::string readString() {
+      unsigned int size = readUInt();
+      check(size);
+      std::string value((const char *)m_data + m_pos, size);
+      m_pos += size;
+      return value;
+    }
+    //! Check that \e count elements of \e size bytes can still be read.
+    void checkArray(const unsigned int count, const size_t size) {
+      if (size != 0 && (size_t)count > (m_end - m_pos) / size) {
+        throw vpException(vpException::ioError, "Truncated compiled model file");
+      }
+    }
+
+  private:
+    void check(const size_t size) {
+      if (size > m_end - m_pos) {
+        throw vpException(vpException::ioError, "Truncated compiled model file");
+      }
+    }
+
+    const unsigned char *m_data;
+    size_t m_end;
+    size_t m_pos;
+  };
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor, the model is empty.
+*/
+vpMbtCompiledModel::vpMbtCompiledModel()
+  : m_primitives(), m_points(), m_names(), m_nameIndex(), m_sources(), m_sourceSizes(), m_sourceHashes(),
+    m_nbFaces(0)
+{
+  for (unsigned int i = 0; i < 6; i++) {
+    m_statistics[i] = 0;
+  }
+}
+
+/*!
+  Append a primitive to the model.
+
+  \param type : Type of the primitive.
+  \param points : Points of the primitive : the corners of the faces (two points per line for
+  POLYGON_FROM_LINES), the two points on the axis of the cylinders, the center and the two points
+  on the plane of the circles.
+  \param idFace : Id of the (first) face of the primitive, relatively to the first face of the model.
+  \param name : Name of the primitive.
+  \param flags : Combination of vpPrimitiveFlag telling which parameters are set in the model.
+  \param radius : Radius of the cylinders and circles.
+  \param minPolygonArea : Value of the minPolygonAreaThreshold parameter if HAS_MIN_POLYGON_AREA is set.
+  \param minLineLength : Value of the minLineLengthThreshold parameter if HAS_MIN_LINE_LENGTH is set.
+*/
+void vpMbtCompiledModel::addPrimitive(const vpPrimitiveType type, const std::vector<vpPoint> &points, const int idFace,
+                                      const std::string &name, const unsigned int flags, const double radius,
+                                      const double minPolygonArea, const double minLineLength)
+{
+  vpPrimitive primitive;
+  primitive.type = (unsigned int)type;
+  primitive.flags = flags;
+  primitive.idFace = idFace;
+  primitive.firstPoint = (unsigned int)(m_points.size() / 3);
+  primitive.nbPoints = (unsigned int)points.size();
+  primitive.radius = radius;
+  primitive.minPolygonArea = minPolygonArea;
+  primitive.minLineLength = minLineLength;
+
+  std::map<std::string, unsigned int>::const_iterator it = m_nameIndex.find(name);
+  if (it == m_nameIndex.end()) {
+    primitive.name = (unsigned int)m_names.size();
+    m_nameIndex[name] = primitive.name;
+    m_names.push_back(name);
+  }
+  else {
+    primitive.name = it->second;
+  }
+
+  for (std::vector<vpPoint>::const_iterator itp = points.begin(); itp != points.end(); ++itp) {
+    m_points.push_back(itp->get_oX());
+    m_points.push_back(itp->get_oY());
+    m_points.push_back(itp->get_oZ());
+  }
+
+  m_primitives.push_back(primitive);
+  // A cylinder is made of its revolution axis and the four faces of its bounding box
+  m_nbFaces += (type == CYLINDER) ? 5 : 1;
+}
+
+/*!
+  Add a file to the sources of the model. Its size and its hash are computed
+  to be able to detect later if the compiled model is out of date.
+
+  \param filename : Model file (cao, wrl) read to build the model.
+*/
+void vpMbtCompiledModel::addSource(const std::string &filename)
+{
+  uint64_t size = 0, hash = 0;
+  if (!hashFile(filename, size, hash)) {
+    throw vpException(vpException::ioError, "Cannot read the model file %s", filename.c_str());
+  }
+
+  m_sources.push_back(filename);
+  m_sourceSizes.push_back(size);
+  m_sourceHashes.push_back(hash);
+}
+
+/*!
+  Remove all the primitives and the sources of the model.
+*/
+void vpMbtCompiledModel::clear()
+{
+  m_primitives.clear();
+  m_points.clear();
+  m_names.clear();
+  m_nameIndex.clear();
+  m_sources.clear();
+  m_sourceSizes.clear();
+  m_sourceHashes.clear();
+  m_nbFaces = 0;
+  for (unsigned int i = 0; i < 6; i++) {
+    m_statistics[i] = 0;
+  }
+}
+
+/*!
+  Get the points of a primitive.
+
+  \param primitive : Primitive of the model.
+  \param points : Points of the primitive in the object frame.
+*/
+void vpMbtCompiledModel::getPoints(const vpPrimitive &primitive, std::vector<vpPoint> &points) const
+{
+  points.resize(primitive.nbPoints);
+  if (primitive.nbPoints == 0) {
+    return;
+  }
+
+  const double *coords = &m_points[3*primitive.firstPoint];
+  for (unsigned int i = 0; i < primitive.nbPoints; i++, coords += 3) {
+    points[i].setWorldCoordinates(coords[0], coords[1], coords[2]);
+  }
+}
+
+/*!
+  Get the number of elements declared in the model, as displayed when a cao
+  model is loaded.
+*/
+void vpMbtCompiledModel::getStatistics(unsigned int &nbPoints, unsigned int &nbLines, unsigned int &nbPolygonLines,
+                                       unsigned int &nbPolygonPoints, unsigned int &nbCylinders,
+                                       unsigned int &nbCircles) const
+{
+  nbPoints = m_statistics[0];
+  nbLines = m_statistics[1];
+  nbPolygonLines = m_statistics[2];
+  nbPolygonPoints = m_statistics[3];
+  nbCylinders = m_statistics[4];
+  nbCircles = m_statistics[5];
+}
+
+/*!
+  Check if a file is a compiled model by reading its signature.
+
+  \param filename : File to test.
+  \return true if the file starts with the signature of the compiled models.
+*/
+bool vpMbtCompiledModel::isCompiledModel(const std::string &filename)
+{
+  std::ifstream file(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  char magic[sizeof(vpCompiledModelMagic)];
+  file.read(magic, sizeof(magic));
+  return file.gcount() == (std::streamsize)sizeof(magic) && memcmp(magic, vpCompiledModelMagic, sizeof(magic)) == 0;
+}
+
+/*!
+  Check that the source files of the model have not been modified since it was
+  built. The sources that do not exist anymore are ignored, so that a compiled
+  model can be used without its sources.
+
+  \return false if a source file has a size or a hash different from the ones
+  computed when the model was built.
+*/
+bool vpMbtCompiledModel::isUpToDate() const
+{
+  for (size_t i = 0; i < m_sources.size(); i++) {
+    if (!vpIoTools::checkFilename(m_sources[i])) {
+      continue;
+    }
+
+    uint64_t size = 0, hash = 0;
+    if (!hashFile(m_sources[i], size, hash) || size != m_sourceSizes[i] || hash != m_sourceHashes[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*!
+  Load a model saved with save(). The whole file is read at once and its
+  content is checked with the hash stored at its end.
+
+  \throw vpException::ioError if the file cannot be read, is not a compiled
+  model, has an unsupported version or is corrupted.
+
+  \param filename : Compiled model file.
+*/
+void vpMbtCompiledModel::load(const std::string &filename)
+{
+  std::ifstream file(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+  if (!file.is_open()) {
+    throw vpException(vpException::ioError, "Cannot read the compiled model file %s", filename.c_str());
+  }
+
+  file.seekg(0, std::ifstream::end);
+  std::streamoff length = file.tellg();
+  file.seekg(0, std::ifstream::beg);
+  if (length < (std::streamoff)(sizeof(vpCompiledModelMagic) + 8)) {
+    throw vpException(vpException::ioError, "%s is not a compiled model file", filename.c_str());
+  }
+
+  std::vector<unsigned char> buffer((size_t)length);
+  file.read((char *)&buffer[0], length);
+  if (file.gcount() != length) {
+    throw vpException(vpException::ioError, "Cannot read the compiled model file %s", filename.c_str());
+  }
+
+  if (memcmp(&buffer[0], vpCompiledModelMagic, sizeof(vpCompiledModelMagic)) != 0) {
+    throw vpException(vpException::ioError, "%s is not a compiled model file", filename.c_str());
+  }
+
+  size_t end = buffer.size() - 8;
+  vpBinaryReader checksumReader(buffer, buffer.size());
+  checksumReader.skip(end);
+  if (checksumReader.readUInt64() != fnv1a(&buffer[0], end)) {
+    throw vpException(vpException::ioError, "The compiled model file %s is corrupted", filename.c_str());
+  }
+
+  vpBinaryReader reader(buffer, end);
+  reader.skip(sizeof(vpCompiledModelMagic));
+  unsigned int version = reader.readUInt();
+  if (version != vpCompiledModelVersion) {
+    throw vpException(vpException::ioError, "Unsupported version %u of the compiled model file %s",
+                      version, filename.c_str());
+  }
+
+  clear();
+
+  unsigned int nbSources = reader.readUInt();
+  reader.checkArray(nbSources, 20);
+  for (unsigned int i = 0; i < nbSources; i++) {
+    m_sources.push_back(reader.readString());
+    m_sourceSizes.push_back(reader.readUInt64());
+    m_sourceHashes.push_back(reader.readUInt64());
+  }
+
+  for (unsigned int i = 0; i < 6; i++) {
+    m_statistics[i] = reader.readUInt();
+  }
+  m_nbFaces = reader.readUInt();
+
+  unsigned int nbNames = reader.readUInt();
+  reader.checkArray(nbNames, 4);
+  m_names.resize(nbNames);
+  for (unsigned int i = 0; i < nbNames; i++) {
+    m_names[i] = reader.readString();
+    m_nameIndex[m_names[i]] = i;
+  }
+
+  unsigned int nbPrimitives = reader.readUInt();
+  reader.checkArray(nbPrimitives, 48);
+  m_primitives.resize(nbPrimitives);
+  for (unsigned int i = 0; i < nbPrimitives; i++) {
+    vpPrimitive &primitive = m_primitives[i];
+    primitive.type = reader.readUInt();
+    primitive.flags = reader.readUInt();
+    primitive.idFace = reader.readInt();
+    primitive.firstPoint = reader.readUInt();
+    primitive.nbPoints = reader.readUInt();
+    primitive.name = reader.readUInt();
+    primitive.radius = reader.readDouble();
+    primitive.minPolygonArea = reader.readDouble();
+    primitive.minLineLength = reader.readDouble();
+  }
+
+  unsigned int nbCoords = reader.readUInt();
+  reader.checkArray(nbCoords, 8);
+  m_points.resize(nbCoords);
+  for (unsigned int i = 0; i < nbCoords; i++) {
+    m_points[i] = reader.readDouble();
+  }
+
+  for (unsigned int i = 0; i < nbPrimitives; i++) {
+    const vpPrimitive &primitive = m_primitives[i];
+    if (primitive.type > CIRCLE || primitive.name >= nbNames ||
+        (uint64_t)primitive.firstPoint + primitive.nbPoints > nbCoords / 3 ||
+        (primitive.type == CYLINDER && primitive.nbPoints != 2) ||
+        (primitive.type == CIRCLE && primitive.nbPoints != 3)) {
+      clear();
+      throw vpException(vpException::ioError, "Invalid primitive in the compiled model file %s", filename.c_str());
+    }
+  }
+}
+
+/*!
+  Save the model in a binary file that can be loaded with load() or
+  vpMbTracker::loadModel().
+
+  \throw vpException::ioError if the file cannot be written.
+
+  \param filename : Compiled model file.
+*/
+void vpMbtCompiledModel::save(const std::string &filename) const
+{
+  vpBinaryWriter writer;
+  writer.data.reserve(64 + 48*m_primitives.size() + 8*m_points.size());
+
+  writer.data.insert(writer.data.end(), vpCompiledModelMagic, vpCompiledModelMagic + sizeof(vpCompiledModelMagic));
+  writer.writeUInt(vpCompiledModelVersion);
+
+  writer.writeUInt((unsigned int)m_sources.size());
+  for (size_t i = 0; i < m_sources.size(); i++) {
+    writer.writeString(m_sources[i]);
+    writer.writeUInt64(m_sourceSizes[i]);
+    writer.writeUInt64(m_sourceHashes[i]);
+  }
+
+  for (unsigned int i = 0; i < 6; i++) {
+    writer.writeUInt(m_statistics[i]);
+  }
+  writer.writeUInt(m_nbFaces);
+
+  writer.writeUInt((unsigned int)m_names.size());
+  for (size_t i = 0; i < m_names.size(); i++) {
+    writer.writeString(m_names[i]);
+  }
+
+  writer.writeUInt((unsigned int)m_primitives.size());
+  for (size_t i = 0; i < m_primitives.size(); i++) {
+    const vpPrimitive &primitive = m_primitives[i];
+    writer.writeUInt(primitive.type);
+    writer.writeUInt(primitive.flags);
+    writer.writeInt(primitive.idFace);
+    writer.writeUInt(primitive.firstPoint);
+    writer.writeUInt(primitive.nbPoints);
+    writer.writeUInt(primitive.name);
+    writer.writeDouble(primitive.radius);
+    writer.writeDouble(primitive.minPolygonArea);
+    writer.writeDouble(primitive.minLineLength);
+  }
+
+  writer.writeUInt((unsigned int)m_points.size());
+  for (size_t i = 0; i < m_points.size(); i++) {
+    writer.writeDouble(m_points[i]);
+  }
+
+  writer.writeUInt64(fnv1a(&writer.data[0], writer.data.size()));
+
+  std::ofstream file(filename.c_str(), std::ofstream::out | std::ofstream::binary);
+  if (!file.is_open()) {
+    throw vpException(vpException::ioError, "Cannot write the compiled model file %s", filename.c_str());
+  }
+  file.write((const char *)&writer.data[0], (std::streamsize)writer.data.size());
+  if (!file) {
+    throw vpException(vpException::ioError, "Cannot write the compiled model file %s", filename.c_str());
+  }
+}
+
+/*!
+  Set the number of elements declared in the model, as displayed when a cao
+  model is loaded.
+*/
+void vpMbtCompiledModel::setStatistics(const unsigned int nbPoints, const unsigned int nbLines,
+                                       const unsigned int nbPolygonLines, const unsigned int nbPolygonPoints,
+                                       const unsigned int nbCylinders, const unsigned int nbCircles)
+{
+  m_statistics[0] = nbPoints;
+  m_statistics[1] = nbLines;
+  m_statistics[2] = nbPolygonLines;
+  m_statistics[3] = nbPolygonPoints;
+  m_statistics[4] = nbCylinders;
+  m_statistics[5] = nbCircles;
+}
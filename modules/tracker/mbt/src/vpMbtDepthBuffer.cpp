@@ -0,0 +1,451 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Low resolution hierarchical depth buffer used for the occlusion culling of
+ * the faces of the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+ \file vpMbtDepthBuffer.cpp
+ \brief Low resolution hierarchical depth buffer used for the occlusion
+ culling of the faces of the model-based trackers.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <visp3/core/vpException.h>
+#include <visp3/mbt/vpMbtDepthBuffer.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Margin in cells that the edge functions have to respect, so that the
+  // rounding errors of the single precision rasterisation never write a cell
+  // that is not entirely covered.
+  const double vpEdgeMargin = 1e-3;
+
+  // Minimal area in square cells of the triangle used to compute the plane
+  // of the inverse depths of a polygon.
+  const double vpMinPlaneArea = 0.25;
+
+  inline void addVertex(double X, double Y, double Z,
+                        double px, double py, double u0, double v0,
+                        std::vector<double> &u, std::vector<double> &v, std::vector<double> &w)
+  {
+    u.push_back(u0 + px * X / Z);
+    v.push_back(v0 + py * Y / Z);
+    w.push_back(1.0 / Z);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The buffer is empty until clear() is called, the
+  subsampling factor is 4 and the near clipping distance 1 mm.
+*/
+vpMbtDepthBuffer::vpMbtDepthBuffer()
+  : m_subsampling(4), m_near(0.001), m_tolerance(1e-3), m_px(1.), m_py(1.), m_u0(0.), m_v0(0.),
+    m_width(0), m_height(0), m_stride(0), m_levels(), m_levelWidth(), m_levelHeight(),
+    m_hierarchyBuilt(false), m_u(), m_v(), m_w(), m_edges()
+{
+}
+
+/*!
+  Compute the coarse levels of the hierarchy from the finest one. It has to
+  be called once all the polygons are drawn, otherwise isVisible() only uses
+  the finest level.
+*/
+void vpMbtDepthBuffer::buildHierarchy()
+{
+  for (size_t l = 1; l < m_levels.size(); l++) {
+    const std::vector<float> &prev = m_levels[l-1];
+    const unsigned int prevStride = (l == 1) ? m_stride : m_levelWidth[l-1];
+    const unsigned int prevWidth = m_levelWidth[l-1], prevHeight = m_levelHeight[l-1];
+    std::vector<float> &level = m_levels[l];
+
+    for (unsigned int y = 0; y < m_levelHeight[l]; y++) {
+      const unsigned int y0 = 2*y, y1 = std::min(2*y+1, prevHeight-1);
+      for (unsigned int x = 0; x < m_levelWidth[l]; x++) {
+        const unsigned int x0 = 2*x, x1 = std::min(2*x+1, prevWidth-1);
+        float value = std::min(prev[y0*prevStride + x0], prev[y0*prevStride + x1]);
+        value = std::min(value, std::min(prev[y1*prevStride + x0], prev[y1*prevStride + x1]));
+        level[y*m_levelWidth[l] + x] = value;
+      }
+    }
+  }
+  m_hierarchyBuilt = true;
+}
+
+/*!
+  Empty the buffer and set its geometry.
+
+  \param cam : Camera parameters of the image.
+  \param width : Width of the image.
+  \param height : Height of the image.
+*/
+void vpMbtDepthBuffer::clear(const vpCameraParameters &cam, const unsigned int width, const unsigned int height)
+{
+  const double s = (double)m_subsampling;
+  m_px = cam.get_px() / s;
+  m_py = cam.get_py() / s;
+  m_u0 = cam.get_u0() / s;
+  m_v0 = cam.get_v0() / s;
+
+  unsigned int w = (width + m_subsampling - 1) / m_subsampling;
+  unsigned int h = (height + m_subsampling - 1) / m_subsampling;
+  if (w != m_width || h != m_height || m_levels.empty()) {
+    m_width = w;
+    m_height = h;
+    // The padding lets the vectorized rasterisation load 4 cells from any column
+    m_stride = w + 3;
+    m_levels.clear();
+    m_levelWidth.clear();
+    m_levelHeight.clear();
+    if (w == 0 || h == 0)
+      return;
+
+    m_levels.push_back(std::vector<float>(m_stride * h));
+    m_levelWidth.push_back(w);
+    m_levelHeight.push_back(h);
+    while (w > 1 || h > 1) {
+      w = (w + 1) / 2;
+      h = (h + 1) / 2;
+      m_levels.push_back(std::vector<float>(w * h));
+      m_levelWidth.push_back(w);
+      m_levelHeight.push_back(h);
+    }
+  }
+
+  if (! m_levels.empty())
+    std::fill(m_levels[0].begin(), m_levels[0].end(), 0.f);
+  m_hierarchyBuilt = false;
+}
+
+/*!
+  Compute the plane of the inverse depths of the last projected polygon
+  \f$ 1/Z = A u + B v + C \f$, where \f$(u, v)\f$ are coordinates in cells.
+  The plane is computed on the largest triangle of the fan of the polygon.
+
+  \return false if the polygon is too small or seen from the side.
+*/
+bool vpMbtDepthBuffer::computePlane(double &A, double &B, double &C) const
+{
+  const size_t n = m_u.size();
+  double bestDet = 0.;
+  size_t best = 0;
+  for (size_t i = 1; i + 1 < n; i++) {
+    const double det = (m_u[i] - m_u[0]) * (m_v[i+1] - m_v[0]) - (m_u[i+1] - m_u[0]) * (m_v[i] - m_v[0]);
+    if (std::fabs(det) > std::fabs(bestDet)) {
+      bestDet = det;
+      best = i;
+    }
+  }
+  if (std::fabs(bestDet) < 2. * vpMinPlaneArea)
+    return false;
+
+  const double du1 = m_u[best] - m_u[0], dv1 = m_v[best] - m_v[0], dw1 = m_w[best] - m_w[0];
+  const double du2 = m_u[best+1] - m_u[0], dv2 = m_v[best+1] - m_v[0], dw2 = m_w[best+1] - m_w[0];
+  A = (dw1 * dv2 - dw2 * dv1) / bestDet;
+  B = (du1 * dw2 - du2 * dw1) / bestDet;
+  C = m_w[0] - A * m_u[0] - B * m_v[0];
+  return true;
+}
+
+/*!
+  Draw a planar polygon in the buffer. Only the cells that are entirely
+  covered by the polygon are updated, with the farthest depth of the polygon
+  over the cell. Lines and polygons seen from the side are ignored.
+
+  \param points : Vertices of the polygon expressed in the camera frame.
+  \param nbPoints : Number of vertices.
+*/
+void vpMbtDepthBuffer::drawPolygon(const vpPoint *points, const unsigned int nbPoints)
+{
+  if (m_levels.empty() || nbPoints < 3)
+    return;
+
+  const unsigned int n = projectPolygon(points, nbPoints);
+  double A, B, C;
+  if (n < 3 || ! computePlane(A, B, C))
+    return;
+
+  double umin = m_u[0], umax = m_u[0], vmin = m_v[0], vmax = m_v[0], wmax = m_w[0], area = 0.;
+  for (unsigned int i = 0; i < n; i++) {
+    const unsigned int next = (i + 1) % n;
+    umin = std::min(umin, m_u[i]);
+    umax = std::max(umax, m_u[i]);
+    vmin = std::min(vmin, m_v[i]);
+    vmax = std::max(vmax, m_v[i]);
+    wmax = std::max(wmax, m_w[i]);
+    area += m_u[i] * m_v[next] - m_u[next] * m_v[i];
+  }
+
+  // Cells entirely inside the bounding box
+  const double xmin = std::max(std::ceil(umin), 0.), xmax = std::min(std::floor(umax) - 1., (double)m_width - 1.);
+  const double ymin = std::max(std::ceil(vmin), 0.), ymax = std::min(std::floor(vmax) - 1., (double)m_height - 1.);
+  if (xmin > xmax || ymin > ymax)
+    return;
+  const unsigned int x0 = (unsigned int)xmin, x1 = (unsigned int)xmax;
+  const unsigned int y0 = (unsigned int)ymin, y1 = (unsigned int)ymax;
+
+  // Edge functions a u + b v + c >= 0 inside the polygon, expressed in cells
+  // and shifted so that they are evaluated at the corner of the cell where
+  // they are the lowest.
+  const double sign = (area > 0.) ? 1. : -1.;
+  m_edges.resize(4 * n);
+  for (unsigned int i = 0; i < n; i++) {
+    const unsigned int next = (i + 1) % n;
+    const double du = m_u[next] - m_u[i], dv = m_v[next] - m_v[i];
+    const double norm = std::sqrt(du * du + dv * dv);
+    double a = 0., b = 0., c = 1.;
+    if (norm > 1e-9) {
+      a = -sign * dv / norm;
+      b = sign * du / norm;
+      c = -(a * m_u[i] + b * m_v[i]) + std::min(a, 0.) + std::min(b, 0.) - vpEdgeMargin;
+    }
+    m_edges[4*i] = (float)a;
+    m_edges[4*i+1] = (float)b;
+    m_edges[4*i+2] = (float)c;
+  }
+
+  // Farthest inverse depth of the polygon over a cell
+  const float wA = (float)A;
+  const double wCell = C + std::min(A, 0.) + std::min(B, 0.);
+  const float wLimit = (float)wmax;
+
+  for (unsigned int y = y0; y <= y1; y++) {
+    float *row = &m_levels[0][y * m_stride];
+    for (unsigned int i = 0; i < n; i++)
+      m_edges[4*i+3] = (float)(m_edges[4*i+1] * (double)y + m_edges[4*i+2]);
+    const float wRow = (float)(B * y + wCell);
+
+    unsigned int x = x0;
+#if VISP_HAVE_SSE2
+    const __m128 ramp = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+    const __m128 last = _mm_set1_ps((float)x1);
+    const __m128 zero = _mm_setzero_ps();
+    for (; x <= x1; x += 4) {
+      const __m128 xs = _mm_add_ps(_mm_set1_ps((float)x), ramp);
+      __m128 inside = _mm_cmple_ps(xs, last);
+      for (unsigned int i = 0; i < n; i++) {
+        const __m128 e = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m_edges[4*i]), xs), _mm_set1_ps(m_edges[4*i+3]));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(e, zero));
+      }
+      if (_mm_movemask_ps(inside) == 0)
+        continue;
+
+      const __m128 w = _mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(wA), xs), _mm_set1_ps(wRow)), _mm_set1_ps(wLimit));
+      const __m128 current = _mm_loadu_ps(row + x);
+      const __m128 nearest = _mm_max_ps(current, w);
+      _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+    }
+#else
+    for (; x <= x1; x++) {
+      const float xs = (float)x;
+      bool inside = true;
+      for (unsigned int i = 0; i < n && inside; i++)
+        inside = (m_edges[4*i] * xs + m_edges[4*i+3] >= 0.f);
+      if (inside)
+        row[x] = std::max(row[x], std::min(wA * xs + wRow, wLimit));
+    }
+#endif
+  }
+  m_hierarchyBuilt = false;
+}
+
+/*!
+  Return the depth in meter stored in a cell of the finest level, or 0 if the
+  cell is not covered by a polygon.
+
+  \param i : Row of the cell.
+  \param j : Column of the cell.
+*/
+double vpMbtDepthBuffer::getDepth(const unsigned int i, const unsigned int j) const
+{
+  if (i >= m_height || j >= m_width)
+    throw(vpException(vpException::dimensionError, "Cell (%d, %d) is outside the %dx%d depth buffer",
+                      i, j, m_height, m_width));
+  const float w = m_levels[0][i * m_stride + j];
+  return (w > 0.f) ? 1.0 / w : 0.;
+}
+
+/*!
+  Test if a polygon or a line may be seen by the camera.
+
+  \param points : Vertices of the polygon expressed in the camera frame.
+  \param nbPoints : Number of vertices.
+
+  \return false if the polygon is behind the camera, outside the image or
+  hidden by the polygons drawn in the buffer, true otherwise. If the buffer
+  is empty, the polygon is always visible.
+*/
+bool vpMbtDepthBuffer::isVisible(const vpPoint *points, const unsigned int nbPoints)
+{
+  if (m_levels.empty())
+    return true;
+
+  const unsigned int n = projectPolygon(points, nbPoints);
+  if (n == 0)
+    return false;
+
+  double umin = m_u[0], umax = m_u[0], vmin = m_v[0], vmax = m_v[0], wmin = m_w[0], wmax = m_w[0];
+  for (unsigned int i = 1; i < n; i++) {
+    umin = std::min(umin, m_u[i]);
+    umax = std::max(umax, m_u[i]);
+    vmin = std::min(vmin, m_v[i]);
+    vmax = std::max(vmax, m_v[i]);
+    wmin = std::min(wmin, m_w[i]);
+    wmax = std::max(wmax, m_w[i]);
+  }
+  if (umax < 0. || vmax < 0. || umin >= (double)m_width || vmin >= (double)m_height)
+    return false;
+
+  const unsigned int x0 = (unsigned int)std::max(std::floor(umin), 0.);
+  const unsigned int x1 = (unsigned int)std::min(std::floor(umax), (double)m_width - 1.);
+  const unsigned int y0 = (unsigned int)std::max(std::floor(vmin), 0.);
+  const unsigned int y1 = (unsigned int)std::min(std::floor(vmax), (double)m_height - 1.);
+  const double scale = 1. + m_tolerance;
+
+  // Coarse test with the level where the bounding box covers at most 2x2 cells
+  if (m_hierarchyBuilt) {
+    unsigned int l = 0;
+    while (l + 1 < m_levels.size() && ((x1 >> l) - (x0 >> l) > 1 || (y1 >> l) - (y0 >> l) > 1))
+      l++;
+    if (l > 0) {
+      const float limit = (float)(wmax * scale);
+      bool hidden = true;
+      for (unsigned int y = (y0 >> l); y <= (y1 >> l) && hidden; y++)
+        for (unsigned int x = (x0 >> l); x <= (x1 >> l) && hidden; x++)
+          hidden = (m_levels[l][y * m_levelWidth[l] + x] > limit);
+      if (hidden)
+        return false;
+    }
+  }
+
+  // Fine test with the nearest depth of the polygon over each cell
+  double A = 0., B = 0., C = wmax;
+  if (n < 3 || ! computePlane(A, B, C)) {
+    A = B = 0.;
+    C = wmax;
+  }
+  C += std::max(A, 0.) + std::max(B, 0.);
+  for (unsigned int y = y0; y <= y1; y++) {
+    const float *row = &m_levels[0][y * m_stride];
+    for (unsigned int x = x0; x <= x1; x++) {
+      const double w = std::min(std::max(A * x + B * y + C, wmin), wmax);
+      if (row[x] <= (float)(w * scale))
+        return true;
+    }
+  }
+  return false;
+}
+
+/*!
+  Clip a polygon by the near plane and project it in the buffer.
+
+  \return The number of vertices of the clipped polygon.
+*/
+unsigned int vpMbtDepthBuffer::projectPolygon(const vpPoint *points, const unsigned int nbPoints)
+{
+  m_u.clear();
+  m_v.clear();
+  m_w.clear();
+  if (nbPoints == 0)
+    return 0;
+
+  const unsigned int nbEdges = (nbPoints > 2) ? nbPoints : nbPoints - 1;
+  for (unsigned int i = 0; i < nbEdges; i++) {
+    const vpPoint &a = points[i];
+    const vpPoint &b = points[(i + 1) % nbPoints];
+    const bool aInside = (a.get_Z() >= m_near), bInside = (b.get_Z() >= m_near);
+    if (aInside)
+      addVertex(a.get_X(), a.get_Y(), a.get_Z(), m_px, m_py, m_u0, m_v0, m_u, m_v, m_w);
+    if (aInside != bInside) {
+      const double t = (m_near - a.get_Z()) / (b.get_Z() - a.get_Z());
+      addVertex(a.get_X() + t * (b.get_X() - a.get_X()), a.get_Y() + t * (b.get_Y() - a.get_Y()), m_near,
+                m_px, m_py, m_u0, m_v0, m_u, m_v, m_w);
+    }
+  }
+  if (nbPoints <= 2 && points[nbPoints-1].get_Z() >= m_near)
+    addVertex(points[nbPoints-1].get_X(), points[nbPoints-1].get_Y(), points[nbPoints-1].get_Z(),
+              m_px, m_py, m_u0, m_v0, m_u, m_v, m_w);
+
+  return (unsigned int)m_u.size();
+}
+
+/*!
+  Set the tolerance on the depth used by isVisible(), relative to the depth
+  of the tested polygon. The default value 0.001 only absorbs the rounding
+  errors.
+
+  \param tolerance : Positive relative tolerance.
+*/
+void vpMbtDepthBuffer::setDepthTolerance(const double tolerance)
+{
+  if (tolerance < 0.)
+    throw(vpException(vpException::badValue, "The depth tolerance %f must be positive", tolerance));
+  m_tolerance = tolerance;
+}
+
+/*!
+  Set the distance of the plane used to clip the polygons that cross the
+  image plane.
+
+  \param dist : Strictly positive distance in meter.
+*/
+void vpMbtDepthBuffer::setNearClippingDistance(const double dist)
+{
+  if (dist <= 0.)
+    throw(vpException(vpException::badValue, "The near clipping distance %f must be strictly positive", dist));
+  m_near = dist;
+}
+
+/*!
+  Set the subsampling factor between the image and the buffer. It is taken
+  into account at the next call of clear().
+
+  \param subsampling : Factor greater or equal to 1.
+*/
+void vpMbtDepthBuffer::setSubsampling(const unsigned int subsampling)
+{
+  if (subsampling == 0)
+    throw(vpException(vpException::badValue, "The subsampling factor of the depth buffer cannot be null"));
+  if (subsampling != m_subsampling) {
+    m_subsampling = subsampling;
+    m_levels.clear();
+    m_width = m_height = 0;
+  }
+}
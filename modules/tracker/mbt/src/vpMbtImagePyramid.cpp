@@ -0,0 +1,228 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pyramid of images used by the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+ \file vpMbtImagePyramid.cpp
+ \brief Pyramid of images used by the model-based trackers.
+*/
+
+#include <algorithm>
+
+#include <visp3/mbt/vpMbtImagePyramid.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  inline unsigned int clampIndex(int index, unsigned int size)
+  {
+    if (index < 0)
+      return 0;
+    if ((unsigned int)index >= size)
+      return size - 1;
+    return (unsigned int)index;
+  }
+
+  // Horizontal [1 4 6 4 1] filter evaluated at column 2*j, with replicated borders
+  inline unsigned short filterRowAt(const unsigned char *src, unsigned int width, unsigned int j)
+  {
+    int c = 2 * (int)j;
+    return (unsigned short)(src[clampIndex(c-2, width)] + src[clampIndex(c+2, width)]
+        + 4 * (src[clampIndex(c-1, width)] + src[clampIndex(c+1, width)]) + 6 * src[c]);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The pyramid is empty.
+*/
+vpMbtImagePyramid::vpMbtImagePyramid()
+  : m_I(NULL), m_enabled(), m_levels(), m_buffer()
+{
+}
+
+/*!
+  Build the pyramid of the image \e I.
+
+  The images of the levels are only reallocated if the size of \e I or the
+  number of levels changes.
+
+  \param I : Input image. Its address is kept as level 0 of the pyramid, so it
+  must remain valid while the pyramid is used.
+  \param scales : Vector of levels to compute. The size of the vector gives the
+  number of levels of the pyramid.
+  \param filter : Filter used for the decimation. With GAUSSIAN_FILTER the
+  intermediate levels are computed even if they are disabled.
+*/
+void
+vpMbtImagePyramid::build(const vpImage<unsigned char> &I, const std::vector<bool> &scales,
+                         const vpPyramidFilterType filter)
+{
+  m_I = &I;
+  m_enabled = scales;
+  if (m_levels.size() < scales.size())
+    m_levels.resize(scales.size());
+
+  if (filter == GAUSSIAN_FILTER) {
+    unsigned int lastLevel = 0;
+    for (unsigned int i = 1; i < scales.size(); i++) {
+      if (scales[i])
+        lastLevel = i;
+    }
+
+    const vpImage<unsigned char> *src = &I;
+    for (unsigned int i = 1; i <= lastLevel; i++) {
+      decimateGaussian(*src, m_levels[i], m_buffer);
+      src = &m_levels[i];
+    }
+  }
+  else {
+    for (unsigned int i = 1; i < scales.size(); i++) {
+      if (scales[i]) {
+        unsigned int cScale = 1u << i;
+        vpImage<unsigned char> &Ii = m_levels[i];
+        Ii.resize(I.getHeight() / cScale, I.getWidth() / cScale);
+        for (unsigned int k = 0; k < Ii.getHeight(); k++) {
+          const unsigned char *src = I[k * cScale];
+          unsigned char *dst = Ii[k];
+          for (unsigned int l = 0, ll = 0; l < Ii.getWidth(); l++, ll += cScale) {
+            dst[l] = src[ll];
+          }
+        }
+      }
+    }
+  }
+}
+
+/*!
+  Forget the input image and disable all the levels. The memory of the levels
+  is kept to be reused by the next call to build().
+*/
+void
+vpMbtImagePyramid::clear()
+{
+  m_I = NULL;
+  m_enabled.clear();
+}
+
+/*!
+  Smooth the image \e I with a 5x5 binomial kernel and keep one pixel over two
+  in each direction. Pixel \f$(i,j)\f$ of \e Id corresponds to pixel
+  \f$(2i,2j)\f$ of \e I and the borders are replicated.
+
+  \param I : Input image.
+  \param Id : Decimated image of size (I.getHeight()/2, I.getWidth()/2).
+  \param buffer : Intermediate result, kept by the caller to avoid an
+  allocation at each call.
+*/
+void
+vpMbtImagePyramid::decimateGaussian(const vpImage<unsigned char> &I, vpImage<unsigned char> &Id,
+                                    std::vector<unsigned short> &buffer)
+{
+  unsigned int height = I.getHeight(), width = I.getWidth();
+  unsigned int dheight = height / 2, dwidth = width / 2;
+  Id.resize(dheight, dwidth);
+  if (dheight == 0 || dwidth == 0)
+    return;
+
+  // Only the rows up to 2*dheight+2 are used by the vertical filter
+  unsigned int nbRows = std::min(height, 2 * dheight + 3);
+  if (buffer.size() < (size_t)nbRows * dwidth)
+    buffer.resize((size_t)nbRows * dwidth);
+
+  // Horizontal filter and decimation; the sums are at most 16*255 on 16 bits
+  for (unsigned int i = 0; i < nbRows; i++) {
+    const unsigned char *src = I[i];
+    unsigned short *dst = &buffer[(size_t)i * dwidth];
+    unsigned int j = 0;
+    dst[j] = filterRowAt(src, width, j);
+    j++;
+#if VISP_HAVE_SSE2
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+    for (; j + 8 <= dwidth && 2 * j + 18 <= width; j += 8) {
+      const unsigned char *p = src + 2 * j;
+      __m128i lm = _mm_loadu_si128((const __m128i *) (p - 2));
+      __m128i l0 = _mm_loadu_si128((const __m128i *) p);
+      __m128i lp = _mm_loadu_si128((const __m128i *) (p + 2));
+      // Even bytes are the low parts of the 16 bits words
+      __m128i sm2 = _mm_and_si128(lm, mask);
+      __m128i sm1 = _mm_srli_epi16(lm, 8);
+      __m128i s0 = _mm_and_si128(l0, mask);
+      __m128i sp1 = _mm_srli_epi16(l0, 8);
+      __m128i sp2 = _mm_and_si128(lp, mask);
+      __m128i sum = _mm_add_epi16(sm2, sp2);
+      sum = _mm_add_epi16(sum, _mm_slli_epi16(_mm_add_epi16(sm1, sp1), 2));
+      sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_slli_epi16(s0, 2), _mm_slli_epi16(s0, 1)));
+      _mm_storeu_si128((__m128i *) (dst + j), sum);
+    }
+#endif
+    for (; j < dwidth; j++) {
+      dst[j] = filterRowAt(src, width, j);
+    }
+  }
+
+  // Vertical filter and decimation; the sums are at most 256*255 on 16 bits
+  for (unsigned int i = 0; i < dheight; i++) {
+    int r = 2 * (int)i;
+    const unsigned short *rm2 = &buffer[(size_t)clampIndex(r-2, nbRows) * dwidth];
+    const unsigned short *rm1 = &buffer[(size_t)clampIndex(r-1, nbRows) * dwidth];
+    const unsigned short *r0  = &buffer[(size_t)r * dwidth];
+    const unsigned short *rp1 = &buffer[(size_t)clampIndex(r+1, nbRows) * dwidth];
+    const unsigned short *rp2 = &buffer[(size_t)clampIndex(r+2, nbRows) * dwidth];
+    unsigned char *dst = Id[i];
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    const __m128i round = _mm_set1_epi16(128);
+    for (; j + 8 <= dwidth; j += 8) {
+      __m128i vm2 = _mm_loadu_si128((const __m128i *) (rm2 + j));
+      __m128i vm1 = _mm_loadu_si128((const __m128i *) (rm1 + j));
+      __m128i v0  = _mm_loadu_si128((const __m128i *) (r0 + j));
+      __m128i vp1 = _mm_loadu_si128((const __m128i *) (rp1 + j));
+      __m128i vp2 = _mm_loadu_si128((const __m128i *) (rp2 + j));
+      __m128i sum = _mm_add_epi16(_mm_add_epi16(vm2, vp2), round);
+      sum = _mm_add_epi16(sum, _mm_slli_epi16(_mm_add_epi16(vm1, vp1), 2));
+      sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_slli_epi16(v0, 2), _mm_slli_epi16(v0, 1)));
+      sum = _mm_srli_epi16(sum, 8);
+      _mm_storel_epi64((__m128i *) (dst + j), _mm_packus_epi16(sum, sum));
+    }
+#endif
+    for (; j < dwidth; j++) {
+      unsigned int sum = rm2[j] + rp2[j] + 4u * (rm1[j] + rp1[j]) + 6u * r0[j] + 128u;
+      dst[j] = (unsigned char)(sum >> 8);
+    }
+  }
+}
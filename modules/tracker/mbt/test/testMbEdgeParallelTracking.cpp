@@ -0,0 +1,229 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the serial and the parallel moving-edge tracking of vpMbEdgeTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbEdgeParallelTracking.cpp
+
+  \brief Track a synthetic box with two vpMbEdgeTracker, one tracking the
+  moving edges serially and one with vpMbEdgeTracker::setUseParallelMovingEdge()
+  on several threads, and check that the moving-edge sites, their states and
+  the poses are identical at each frame.
+*/
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpPolygon.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/mbt/vpMbEdgeTracker.h>
+#include <visp3/me/vpMe.h>
+
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+namespace {
+// Corners and faces of the box, as in the teabox model of the tutorials
+const double boxPoints[8][3] = { {0, 0, 0}, {0, 0, -0.08}, {0.165, 0, -0.08}, {0.165, 0, 0},
+                                 {0.165, 0.068, 0}, {0.165, 0.068, -0.08}, {0, 0.068, -0.08}, {0, 0.068, 0} };
+const unsigned int boxFaces[6][4] = { {0, 1, 2, 3}, {1, 6, 5, 2}, {4, 5, 6, 7},
+                                      {0, 3, 4, 7}, {5, 4, 3, 2}, {0, 7, 6, 1} };
+
+void writeModel(const std::string &filename)
+{
+  std::ofstream file(filename.c_str());
+  file << "V1" << std::endl << "8" << std::endl;
+  for (unsigned int k = 0; k < 8; k++)
+    file << boxPoints[k][0] << " " << boxPoints[k][1] << " " << boxPoints[k][2] << std::endl;
+  file << "0" << std::endl << "0" << std::endl << "6" << std::endl;
+  for (unsigned int f = 0; f < 6; f++)
+    file << "4 " << boxFaces[f][0] << " " << boxFaces[f][1] << " " << boxFaces[f][2] << " " << boxFaces[f][3] << std::endl;
+  file << "0" << std::endl << "0" << std::endl;
+}
+
+// Draw the faces of the box that look towards the camera with a gray level per face
+void render(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, vpImage<unsigned char> &I)
+{
+  I = 30;
+  for (unsigned int k = 0; k < I.getSize(); k++)
+    I.bitmap[k] = (unsigned char)(I.bitmap[k] + rand() % 8);
+
+  vpColVector cP[8];
+  vpColVector center(3, 0);
+  for (unsigned int k = 0; k < 8; k++) {
+    vpColVector oP(4, 1);
+    for (unsigned int l = 0; l < 3; l++)
+      oP[l] = boxPoints[k][l];
+    cP[k] = (cMo * oP).extract(0, 3);
+    center += cP[k] / 8.;
+  }
+
+  for (unsigned int f = 0; f < 6; f++) {
+    vpColVector c = (cP[boxFaces[f][0]] + cP[boxFaces[f][2]]) / 2.;
+    vpColVector n = vpColVector::crossProd(cP[boxFaces[f][1]] - cP[boxFaces[f][0]], cP[boxFaces[f][2]] - cP[boxFaces[f][0]]);
+    if (vpColVector::dotProd(n, c - center) < 0)
+      n = -n;
+    if (vpColVector::dotProd(n, c) >= 0)
+      continue;
+
+    std::vector<vpImagePoint> corners;
+    for (unsigned int k = 0; k < 4; k++) {
+      const vpColVector &P = cP[boxFaces[f][k]];
+      corners.push_back(vpImagePoint(cam.get_v0() + cam.get_py() * P[1] / P[2], cam.get_u0() + cam.get_px() * P[0] / P[2]));
+    }
+    vpPolygon(corners).fillMask(I, (unsigned char)(120 + 25 * f));
+  }
+}
+
+bool sameSites(const vpMbEdgeTracker &serial, const vpMbEdgeTracker &parallel, unsigned int &nbSites)
+{
+  std::list<vpMbtDistanceLine *> lines_serial, lines_parallel;
+  serial.getLline(lines_serial);
+  parallel.getLline(lines_parallel);
+  if (lines_serial.size() != lines_parallel.size())
+    return false;
+
+  std::list<vpMbtDistanceLine *>::const_iterator it_p = lines_parallel.begin();
+  for (std::list<vpMbtDistanceLine *>::const_iterator it_s = lines_serial.begin(); it_s != lines_serial.end(); ++it_s, ++it_p) {
+    const vpMbtDistanceLine *ls = *it_s, *lp = *it_p;
+    if (ls->isVisible() != lp->isVisible() || ls->meline.size() != lp->meline.size())
+      return false;
+    for (size_t m = 0; m < ls->meline.size(); m++) {
+      std::list<vpMeSite> sites_serial = ls->meline[m]->getMeList(), sites_parallel = lp->meline[m]->getMeList();
+      if (sites_serial.size() != sites_parallel.size())
+        return false;
+      std::list<vpMeSite>::iterator s_p = sites_parallel.begin();
+      for (std::list<vpMeSite>::iterator s_s = sites_serial.begin(); s_s != sites_serial.end(); ++s_s, ++s_p) {
+        if (s_s->i != s_p->i || s_s->j != s_p->j || s_s->getState() != s_p->getState()
+            || std::fabs(s_s->ifloat - s_p->ifloat) > 0. || std::fabs(s_s->jfloat - s_p->jfloat) > 0.
+            || std::fabs(s_s->alpha - s_p->alpha) > 0. || std::fabs(s_s->convlt - s_p->convlt) > 0.)
+          return false;
+        nbSites++;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    std::string opath;
+#if defined(_WIN32)
+    opath = "C:/temp";
+#else
+    opath = "/tmp";
+#endif
+    if (vpIoTools::checkDirectory(opath) == false)
+      vpIoTools::makeDirectory(opath);
+    std::string model = opath + "/testMbEdgeParallelTracking.cao";
+    writeModel(model);
+
+    const unsigned int nbFrames = 20;
+    vpCameraParameters cam(600, 600, 320, 240);
+    vpImage<unsigned char> I(480, 640);
+
+    vpMe me;
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setRange(8);
+    me.setThreshold(10000);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+    me.setSampleStep(4);
+
+    vpMbEdgeTracker serial, parallel;
+    vpMbEdgeTracker *trackers[2] = { &serial, &parallel };
+    for (unsigned int t = 0; t < 2; t++) {
+      trackers[t]->setCameraParameters(cam);
+      trackers[t]->setMovingEdge(me);
+      // The planes that define the lines of the model are built with rand()
+      srand(0);
+      trackers[t]->loadModel(model);
+    }
+    parallel.setUseParallelMovingEdge(true);
+    vpThreadPool::setNumThreads(4);
+
+    unsigned int nbSites = 0;
+    for (unsigned int frame = 0; frame < nbFrames; frame++) {
+      double s = 0.05 * frame;
+      vpHomogeneousMatrix cMo(-0.08 + 0.01 * s, -0.03 + 0.005 * s, 0.45 - 0.02 * s,
+                              vpMath::rad(30 + 4 * s), vpMath::rad(-25 + 10 * s), vpMath::rad(5 * s));
+      render(cMo, cam, I);
+
+      for (unsigned int t = 0; t < 2; t++) {
+        if (frame == 0)
+          trackers[t]->initFromPose(I, cMo);
+        else
+          trackers[t]->track(I);
+      }
+
+      vpHomogeneousMatrix cMo_serial = serial.getPose(), cMo_parallel = parallel.getPose();
+      for (unsigned int i = 0; i < 3; i++) {
+        for (unsigned int j = 0; j < 4; j++) {
+          if (std::fabs(cMo_serial[i][j] - cMo_parallel[i][j]) > 0.) {
+            std::cerr << "The poses differ at frame " << frame << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+      if (! sameSites(serial, parallel, nbSites)) {
+        std::cerr << "The moving-edge sites differ at frame " << frame << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (frame == nbFrames - 1)
+        std::cout << "Translation error at the last frame: "
+                  << (cMo.getTranslationVector() - cMo_serial.getTranslationVector()).euclideanNorm() << " m" << std::endl;
+    }
+
+    std::cout << nbSites << " moving-edge sites compared" << std::endl;
+    if (nbSites == 0) {
+      std::cerr << "No moving edge tracked" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,280 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the visibility test of vpMbHiddenFaces based on the depth buffer.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbHiddenFacesDepthBuffer.cpp
+
+  \brief Check the visibility of the faces of boxes given by vpMbHiddenFaces
+  with setDepthBufferVisibilityTest(): a face entirely hidden by another box
+  is culled, a face is culled when it is behind the near plane or beyond a border of the
+  image but never when a part of it is in the view frustum, and along a sweep of poses
+  no face that passes the angle test is culled otherwise.
+*/
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/mbt/vpMbHiddenFaces.h>
+#include <visp3/mbt/vpMbtPolygon.h>
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <cmath>
+
+namespace {
+// Corners of the faces of a box whose vertex k is at the min or max coordinate
+// given by the bits of k, in the order that makes their normal point outside
+const unsigned int boxFaces[6][4] = { {0, 2, 3, 1}, {4, 5, 7, 6}, {0, 4, 6, 2},
+                                      {1, 3, 7, 5}, {0, 1, 5, 4}, {2, 6, 7, 3} };
+
+// Add the faces of the box [min, max] to both sets of faces
+void addBox(const double min[3], const double max[3], vpMbHiddenFaces<vpMbtPolygon> &faces_angle,
+            vpMbHiddenFaces<vpMbtPolygon> &faces_depth, std::vector<std::vector<vpPoint> > &corners)
+{
+  for (unsigned int f = 0; f < 6; f++) {
+    vpMbtPolygon polygon;
+    polygon.setNbPoint(4);
+    polygon.setIndex((int)corners.size());
+    std::vector<vpPoint> points;
+    for (unsigned int k = 0; k < 4; k++) {
+      unsigned int v = boxFaces[f][k];
+      vpPoint P;
+      P.setWorldCoordinates((v & 1) ? max[0] : min[0], (v & 2) ? max[1] : min[1], (v & 4) ? max[2] : min[2]);
+      polygon.addPoint(k, P);
+      points.push_back(P);
+    }
+    faces_angle.addPolygon(&polygon);
+    faces_depth.addPolygon(&polygon);
+    corners.push_back(points);
+  }
+}
+
+// Position of a face with respect to the view frustum. The culling is
+// conservative: a face outside the frustum is only sure to be culled when it
+// is entirely on the outer side of one of its planes.
+enum vpFrustumPosition { IN_FRUSTUM, BEHIND_NEAR_PLANE, BEYOND_BORDER, OUTSIDE_FRUSTUM };
+
+// Clip the face by the planes of the view frustum to know if a part of it can be seen
+vpFrustumPosition frustumPosition(const std::vector<vpPoint> &points, const vpHomogeneousMatrix &cMo,
+                                  const vpCameraParameters &cam, unsigned int width, unsigned int height,
+                                  double nearDistance)
+{
+  const double xmin = -cam.get_u0() / cam.get_px(), xmax = (width - cam.get_u0()) / cam.get_px();
+  const double ymin = -cam.get_v0() / cam.get_py(), ymax = (height - cam.get_v0()) / cam.get_py();
+  // Planes a.X + d >= 0 of the frustum in the camera frame
+  const double planes[5][4] = { {0, 0, 1, -nearDistance}, {1, 0, -xmin, 0}, {-1, 0, xmax, 0},
+                                {0, 1, -ymin, 0}, {0, -1, ymax, 0} };
+
+  std::vector<vpColVector> polygon;
+  unsigned int nbOutside[5] = {0, 0, 0, 0, 0};
+  for (size_t k = 0; k < points.size(); k++) {
+    vpPoint P(points[k].get_oX(), points[k].get_oY(), points[k].get_oZ());
+    P.changeFrame(cMo);
+    vpColVector cP(3);
+    cP[0] = P.get_X();
+    cP[1] = P.get_Y();
+    cP[2] = P.get_Z();
+    polygon.push_back(cP);
+    for (unsigned int p = 0; p < 5; p++)
+      if (planes[p][0] * cP[0] + planes[p][1] * cP[1] + planes[p][2] * cP[2] + planes[p][3] < 0)
+        nbOutside[p]++;
+  }
+  if (nbOutside[0] == points.size())
+    return BEHIND_NEAR_PLANE;
+  for (unsigned int p = 1; p < 5; p++)
+    if (nbOutside[p] == points.size())
+      return BEYOND_BORDER;
+
+  for (unsigned int p = 0; p < 5 && ! polygon.empty(); p++) {
+    std::vector<vpColVector> clipped;
+    for (size_t k = 0; k < polygon.size(); k++) {
+      const vpColVector &A = polygon[k], &B = polygon[(k + 1) % polygon.size()];
+      double dA = planes[p][0] * A[0] + planes[p][1] * A[1] + planes[p][2] * A[2] + planes[p][3];
+      double dB = planes[p][0] * B[0] + planes[p][1] * B[1] + planes[p][2] * B[2] + planes[p][3];
+      if (dA >= 0)
+        clipped.push_back(A);
+      if ((dA >= 0) != (dB >= 0))
+        clipped.push_back(A + (B - A) * (dA / (dA - dB)));
+    }
+    polygon = clipped;
+  }
+  return polygon.size() >= 3 ? IN_FRUSTUM : OUTSIDE_FRUSTUM;
+}
+}
+
+int main()
+{
+  try {
+    const unsigned int width = 640, height = 480;
+    vpCameraParameters cam(600, 600, width / 2., height / 2.);
+    vpImage<unsigned char> I(height, width);
+    const double angle = vpMath::rad(89);
+    bool changed = false;
+
+    // A small box entirely hidden by a larger box in front of it
+    {
+      vpMbHiddenFaces<vpMbtPolygon> faces_angle, faces_depth;
+      faces_depth.setDepthBufferVisibilityTest(true);
+      std::vector<std::vector<vpPoint> > corners;
+      const double front_min[3] = {-0.1, -0.1, 0.5}, front_max[3] = {0.1, 0.1, 0.6};
+      const double back_min[3] = {-0.03, -0.03, 1.}, back_max[3] = {0.03, 0.03, 1.06};
+      addBox(front_min, front_max, faces_angle, faces_depth, corners);
+      addBox(back_min, back_max, faces_angle, faces_depth, corners);
+
+      vpHomogeneousMatrix cMo;
+      faces_angle.setVisible(I, cam, cMo, angle, changed);
+      faces_depth.setVisible(I, cam, cMo, angle, changed);
+      // The face of each box that looks towards the camera
+      if (! faces_angle.isVisible(0) || ! faces_depth.isVisible(0)) {
+        std::cerr << "The front face of the first box should be visible" << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (! faces_angle.isVisible(6)) {
+        std::cerr << "The front face of the hidden box should pass the angle test" << std::endl;
+        return EXIT_FAILURE;
+      }
+      for (unsigned int i = 6; i < 12; i++) {
+        if (faces_depth.isVisible(i)) {
+          std::cerr << "Face " << i - 6 << " of the hidden box is not culled" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      // Once the front box moved aside, the face is visible again
+      vpHomogeneousMatrix cMo_aside(0.4, 0, 0, 0, 0, 0);
+      faces_depth.setVisible(I, cam, cMo_aside, angle, changed);
+      if (! faces_depth.isVisible(6)) {
+        std::cerr << "The front face of the box is culled while it is not hidden" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // Same number of faces once the polygons are replaced: the first box is
+      // now beyond the left border of the image and the second one in front
+      faces_angle.reset();
+      faces_depth.reset();
+      corners.clear();
+      const double left_min[3] = {-0.5, -0.05, 0.5}, left_max[3] = {-0.4, 0.05, 0.6};
+      addBox(left_min, left_max, faces_angle, faces_depth, corners);
+      addBox(back_min, back_max, faces_angle, faces_depth, corners);
+      faces_angle.setVisible(I, cam, cMo, angle, changed);
+      faces_depth.setVisible(I, cam, cMo, angle, changed);
+      if (! faces_angle.isVisible(3) || faces_depth.isVisible(3) || ! faces_depth.isVisible(6)) {
+        std::cerr << "The visibility does not follow the new polygons" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // A single box seen from many poses: as it is convex, a face passing the
+    // angle test can only be culled when it is outside the view frustum
+    {
+      vpMbHiddenFaces<vpMbtPolygon> faces_angle, faces_depth;
+      faces_depth.setDepthBufferVisibilityTest(true);
+      const double nearDistance = faces_depth.getDepthBuffer().getNearClippingDistance();
+      std::vector<std::vector<vpPoint> > corners;
+      const double box_min[3] = {-0.08, -0.05, -0.04}, box_max[3] = {0.08, 0.05, 0.04};
+      addBox(box_min, box_max, faces_angle, faces_depth, corners);
+
+      std::vector<vpHomogeneousMatrix> poses;
+      // Boxes beyond each border of the image and across it
+      const double z = 0.6;
+      const double xBorder = cam.get_u0() / cam.get_px() * z, yBorder = cam.get_v0() / cam.get_py() * z;
+      const double shifts[] = {0.081, 0.079, 0., -0.079, -0.081};
+      for (unsigned int s = 0; s < 5; s++) {
+        poses.push_back(vpHomogeneousMatrix(-xBorder - shifts[s], 0, z, 0, 0, 0));
+        poses.push_back(vpHomogeneousMatrix(xBorder + shifts[s], 0, z, 0, 0, 0));
+        poses.push_back(vpHomogeneousMatrix(0, -yBorder - shifts[s] + 0.03, z, 0, 0, 0));
+        poses.push_back(vpHomogeneousMatrix(0, yBorder + shifts[s] - 0.03, z, 0, 0, 0));
+      }
+      // Boxes behind the camera, and across the near plane
+      poses.push_back(vpHomogeneousMatrix(0, 0, -0.3, 0, 0, 0));
+      poses.push_back(vpHomogeneousMatrix(0, 0, -0.3, vpMath::rad(180), 0, 0));
+      poses.push_back(vpHomogeneousMatrix(0.01, 0, 0.02, 0, 0, 0));
+      poses.push_back(vpHomogeneousMatrix(0, 0.01, 0.03, vpMath::rad(20), 0, 0));
+      // Sweep of rotations and translations
+      for (unsigned int k = 0; k < 2000; k++) {
+        poses.push_back(vpHomogeneousMatrix(0.4 * sin(0.37 * k), 0.3 * cos(0.53 * k), 0.35 + 0.3 * sin(0.11 * k),
+                                            vpMath::rad(180 * sin(0.071 * k)), vpMath::rad(180 * cos(0.043 * k)),
+                                            vpMath::rad(7. * k)));
+      }
+
+      unsigned int nbVisible = 0, nbBehind = 0, nbBeyondBorder = 0;
+      for (size_t p = 0; p < poses.size(); p++) {
+        faces_angle.setVisible(I, cam, poses[p], angle, changed);
+        faces_depth.setVisible(I, cam, poses[p], angle, changed);
+        for (unsigned int i = 0; i < 6; i++) {
+          if (! faces_angle.isVisible(i)) {
+            if (faces_depth.isVisible(i)) {
+              std::cerr << "Face " << i << " fails the angle test but is visible with pose " << p << std::endl;
+              return EXIT_FAILURE;
+            }
+            continue;
+          }
+
+          vpFrustumPosition position = frustumPosition(corners[i], poses[p], cam, width, height, nearDistance);
+          if (position == IN_FRUSTUM && ! faces_depth.isVisible(i)) {
+            std::cerr << "Face " << i << " is culled with pose " << p << " while it is in the view frustum" << std::endl;
+            return EXIT_FAILURE;
+          }
+          if ((position == BEHIND_NEAR_PLANE || position == BEYOND_BORDER) && faces_depth.isVisible(i)) {
+            std::cerr << "Face " << i << " is not culled with pose " << p << " while it is "
+                      << (position == BEHIND_NEAR_PLANE ? "behind the near plane" : "beyond a border of the image")
+                      << std::endl;
+            return EXIT_FAILURE;
+          }
+          if (position == IN_FRUSTUM) nbVisible++;
+          else if (position == BEHIND_NEAR_PLANE) nbBehind++;
+          else if (position == BEYOND_BORDER) nbBeyondBorder++;
+        }
+      }
+
+      std::cout << poses.size() << " poses: " << nbVisible << " visible faces, " << nbBehind
+                << " faces culled behind the near plane and " << nbBeyondBorder
+                << " beyond a border of the image" << std::endl;
+      if (nbVisible == 0 || nbBehind == 0 || nbBeyondBorder == 0) {
+        std::cerr << "The poses do not cover all the cases" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,194 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the serial, the parallel and the from scratch rendering of vpMbScanLine.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbScanLine.cpp
+
+  \brief Render the same moving scene of cubes with vpMbScanLine on one thread
+  and with the bands rendered in parallel, and check that the primitive ids,
+  the masks and the visible parts of the edges are identical, and identical
+  to the ones of a vpMbScanLine constructed for each frame, that renders
+  the whole scene from scratch.
+*/
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/mbt/vpMbScanLine.h>
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <stdlib.h>
+#include <cmath>
+
+namespace {
+// Corners of the faces of a cube whose vertex k is at ((k&1), (k>>1)&1, (k>>2)&1)
+const unsigned int cubeFaces[6][4] = { {0, 1, 3, 2}, {4, 6, 7, 5}, {0, 2, 6, 4},
+                                       {1, 5, 7, 3}, {0, 4, 5, 1}, {2, 3, 7, 6} };
+
+// Vertices of the cubes in the camera frame at a given frame of the sequence.
+// Only one cube moves from one frame to the next, so that some bands are reused.
+void buildVertices(unsigned int frame, unsigned int nbCubes, std::vector<vpPoint> &vertices)
+{
+  const double size = 0.12;
+  vertices.resize(8*nbCubes);
+  for (unsigned int c = 0; c < nbCubes; c++) {
+    double t = 0.1 * (frame / nbCubes + ((c < frame % nbCubes) ? 1 : 0));
+    vpHomogeneousMatrix cMo(-0.45 + 0.2 * (c % 5) + 0.02 * sin(t), -0.3 + 0.25 * (c / 5), 0.6 + 0.1 * (c % 3),
+                            vpMath::rad(20 + 10 * c) + t, vpMath::rad(30 - 7 * c) + 0.5 * t, 0.3 * t);
+    for (unsigned int k = 0; k < 8; k++) {
+      vpPoint &P = vertices[8*c + k];
+      P.setWorldCoordinates(size * ((k & 1) - 0.5), size * (((k >> 1) & 1) - 0.5), size * (((k >> 2) & 1) - 0.5));
+      P.changeFrame(cMo);
+    }
+  }
+}
+
+bool sameLines(const std::vector<std::pair<vpPoint, vpPoint> > &a, const std::vector<std::pair<vpPoint, vpPoint> > &b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (size_t k = 0; k < a.size(); k++) {
+    const vpPoint *pa[2] = { &a[k].first, &a[k].second };
+    const vpPoint *pb[2] = { &b[k].first, &b[k].second };
+    for (unsigned int l = 0; l < 2; l++) {
+      if (std::fabs(pa[l]->get_X() - pb[l]->get_X()) > 0. || std::fabs(pa[l]->get_Y() - pb[l]->get_Y()) > 0.
+          || std::fabs(pa[l]->get_Z() - pb[l]->get_Z()) > 0.)
+        return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    const unsigned int nbCubes = 15, nbFrames = 30, nbThreads = 4;
+    const unsigned int width = 640, height = 480;
+    vpCameraParameters cam(600, 600, width / 2., height / 2.);
+    vpThreadPool::setNumThreads(nbThreads);
+
+    unsigned int maskBorders[] = {0, 5};
+    for (unsigned int m = 0; m < 2; m++) {
+      vpMbScanLine serial, parallel;
+      serial.setMaskBorder(maskBorders[m]);
+      parallel.setMaskBorder(maskBorders[m]);
+      parallel.setParallelRendering(true);
+
+      std::vector<vpPoint> vertices;
+      std::vector<std::vector<std::pair<vpPoint, unsigned int> > > faces(6*nbCubes);
+      std::vector<std::vector<std::pair<vpPoint, unsigned int> > *> polygons;
+      std::vector<int> indices;
+      for (unsigned int f = 0; f < faces.size(); f++) {
+        polygons.push_back(&faces[f]);
+        indices.push_back((int)f);
+      }
+
+      unsigned int nbVisible = 0;
+      for (unsigned int frame = 0; frame < nbFrames; frame++) {
+        buildVertices(frame, nbCubes, vertices);
+        for (unsigned int f = 0; f < faces.size(); f++) {
+          faces[f].clear();
+          for (unsigned int k = 0; k < 4; k++)
+            faces[f].push_back(std::make_pair(vertices[8*(f / 6) + cubeFaces[f % 6][k]], 0u));
+        }
+
+        serial.drawScene(polygons, indices, cam, width, height);
+        parallel.drawScene(polygons, indices, cam, width, height);
+        vpMbScanLine reference;
+        reference.setMaskBorder(maskBorders[m]);
+        reference.drawScene(polygons, indices, cam, width, height);
+
+        const vpImage<int> &ids_serial = serial.getPrimitiveIDs(), &ids_parallel = parallel.getPrimitiveIDs();
+        const vpImage<unsigned char> &mask_serial = serial.getMask(), &mask_parallel = parallel.getMask();
+        const vpImage<int> &ids_reference = reference.getPrimitiveIDs();
+        const vpImage<unsigned char> &mask_reference = reference.getMask();
+        for (unsigned int i = 0; i < height; i++) {
+          for (unsigned int j = 0; j < width; j++) {
+            if (ids_serial[i][j] != ids_parallel[i][j] || mask_serial[i][j] != mask_parallel[i][j]) {
+              std::cerr << "The parallel rendering differs at pixel (" << i << ", " << j << ") of frame "
+                        << frame << " with a mask border of " << maskBorders[m] << std::endl;
+              return EXIT_FAILURE;
+            }
+            if (ids_serial[i][j] != ids_reference[i][j] || mask_serial[i][j] != mask_reference[i][j]) {
+              std::cerr << "The rendering differs from the one from scratch at pixel (" << i << ", " << j
+                        << ") of frame " << frame << " with a mask border of " << maskBorders[m] << std::endl;
+              return EXIT_FAILURE;
+            }
+            if (ids_serial[i][j] != -1)
+              nbVisible++;
+          }
+        }
+
+        // Visible parts of the edges of the cubes
+        for (unsigned int c = 0; c < nbCubes; c++) {
+          for (unsigned int k = 0; k < 8; k++) {
+            for (unsigned int b = 1; b < 8; b <<= 1) {
+              if (k & b)
+                continue;
+              std::vector<std::pair<vpPoint, vpPoint> > lines_serial, lines_parallel, lines_reference;
+              serial.queryLineVisibility(vertices[8*c + k], vertices[8*c + (k | b)], lines_serial);
+              parallel.queryLineVisibility(vertices[8*c + k], vertices[8*c + (k | b)], lines_parallel);
+              reference.queryLineVisibility(vertices[8*c + k], vertices[8*c + (k | b)], lines_reference);
+              if (! sameLines(lines_serial, lines_parallel) || ! sameLines(lines_serial, lines_reference)) {
+                std::cerr << "The visible parts of an edge of cube " << c << " differ at frame " << frame
+                          << " with a mask border of " << maskBorders[m] << std::endl;
+                return EXIT_FAILURE;
+              }
+            }
+          }
+        }
+      }
+
+      std::cout << "Mask border " << maskBorders[m] << ": " << parallel.getNbRenderedBands() << " bands rendered, "
+                << parallel.getNbReusedBands() << " reused, serial " << serial.getRenderingTime()
+                << " ms, parallel " << parallel.getRenderingTime() << " ms" << std::endl;
+      if (nbVisible == 0) {
+        std::cerr << "No polygon rendered" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,319 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the compiled models of the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbtCompiledModel.cpp
+
+  \brief Save a cao model with vpMbTracker::saveCompiledModel() and check that
+  loading the compiled model gives the same faces, lines, cylinders and
+  circles, with the same names and LOD parameters, that the cao model is
+  loaded again once it is modified, and that truncated or corrupted compiled
+  models and compiled models of another version are rejected with a
+  vpException::ioError.
+*/
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/mbt/vpMbEdgeTracker.h>
+
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace {
+// Model with the primitives of each type, with and without name and LOD parameters
+void writeModel(const std::string &filename, const double height)
+{
+  std::ofstream file(filename.c_str());
+  file << "V1" << std::endl
+       << "# 3D points" << std::endl
+       << "13" << std::endl
+       << "0 0 0" << std::endl
+       << "0 0 -0.08" << std::endl
+       << "0.165 0 -0.08" << std::endl
+       << "0.165 0 0" << std::endl
+       << "0.165 " << height << " 0" << std::endl
+       << "0.165 " << height << " -0.08" << std::endl
+       << "0 " << height << " -0.08" << std::endl
+       << "0 " << height << " 0" << std::endl
+       << "0.05 0.2 0" << std::endl
+       << "0.05 0.3 0" << std::endl
+       << "0.1 0.2 -0.04" << std::endl
+       << "0.12 0.2 -0.04" << std::endl
+       << "0.1 0.2 -0.02" << std::endl
+       << "# 3D lines" << std::endl
+       << "5" << std::endl
+       << "0 1" << std::endl
+       << "1 2" << std::endl
+       << "2 3" << std::endl
+       << "3 0 name=\"front_bottom\"" << std::endl
+       << "4 7 name=\"edge\" useLod=true minLineLengthThreshold=35" << std::endl
+       << "# Faces from 3D lines" << std::endl
+       << "1" << std::endl
+       << "4 0 1 2 3 name=\"bottom\" useLod=true minPolygonAreaThreshold=1200" << std::endl
+       << "# Faces from 3D points" << std::endl
+       << "5" << std::endl
+       << "4 1 6 5 2 name=\"back\"" << std::endl
+       << "4 4 5 6 7 useLod=false" << std::endl
+       << "4 0 3 4 7 name=\"front\" minPolygonAreaThreshold=800" << std::endl
+       << "4 5 4 3 2" << std::endl
+       << "4 0 7 6 1 name=\"left\" useLod=true" << std::endl
+       << "# 3D cylinders" << std::endl
+       << "1" << std::endl
+       << "8 9 0.02 name=\"handle\" useLod=true minLineLengthThreshold=25" << std::endl
+       << "# 3D circles" << std::endl
+       << "1" << std::endl
+       << "0.01 10 11 12 name=\"hole\" minPolygonAreaThreshold=300" << std::endl;
+}
+
+bool samePoint(const vpPoint &a, const vpPoint &b)
+{
+  return a.get_oX() == b.get_oX() && a.get_oY() == b.get_oY() && a.get_oZ() == b.get_oZ();
+}
+
+// Check that two trackers have the same model
+bool sameModel(vpMbEdgeTracker &a, vpMbEdgeTracker &b)
+{
+  vpMbHiddenFaces<vpMbtPolygon> &faces_a = a.getFaces(), &faces_b = b.getFaces();
+  if (faces_a.size() != faces_b.size()) {
+    std::cerr << faces_a.size() << " faces instead of " << faces_b.size() << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < faces_a.size(); i++) {
+    const vpMbtPolygon *fa = faces_a[i], *fb = faces_b[i];
+    bool same = fa->getIndex() == fb->getIndex() && fa->getName() == fb->getName() && fa->nbpt == fb->nbpt
+        && fa->useLod == fb->useLod && fa->minLineLengthThresh == fb->minLineLengthThresh
+        && fa->minPolygonAreaThresh == fb->minPolygonAreaThresh && fa->hasOrientation == fb->hasOrientation;
+    for (unsigned int k = 0; same && k < fa->nbpt; k++)
+      same = samePoint(fa->p[k], fb->p[k]);
+    if (! same) {
+      std::cerr << "Face " << i << " (" << fa->getName() << ") differs" << std::endl;
+      return false;
+    }
+  }
+
+  std::list<vpMbtDistanceLine *> lines_a, lines_b;
+  a.getLline(lines_a);
+  b.getLline(lines_b);
+  if (lines_a.size() != lines_b.size()) {
+    std::cerr << lines_a.size() << " lines instead of " << lines_b.size() << std::endl;
+    return false;
+  }
+  std::list<vpMbtDistanceLine *>::const_iterator it_lb = lines_b.begin();
+  for (std::list<vpMbtDistanceLine *>::const_iterator it_la = lines_a.begin(); it_la != lines_a.end(); ++it_la, ++it_lb) {
+    if ((*it_la)->getName() != (*it_lb)->getName() || ! samePoint(*(*it_la)->p1, *(*it_lb)->p1)
+        || ! samePoint(*(*it_la)->p2, *(*it_lb)->p2) || (*it_la)->Lindex_polygon != (*it_lb)->Lindex_polygon) {
+      std::cerr << "Line " << (*it_la)->getName() << " differs" << std::endl;
+      return false;
+    }
+  }
+
+  std::list<vpMbtDistanceCylinder *> cylinders_a, cylinders_b;
+  a.getLcylinder(cylinders_a);
+  b.getLcylinder(cylinders_b);
+  if (cylinders_a.size() != cylinders_b.size()) {
+    std::cerr << cylinders_a.size() << " cylinders instead of " << cylinders_b.size() << std::endl;
+    return false;
+  }
+  std::list<vpMbtDistanceCylinder *>::const_iterator it_cb = cylinders_b.begin();
+  for (std::list<vpMbtDistanceCylinder *>::const_iterator it_ca = cylinders_a.begin(); it_ca != cylinders_a.end(); ++it_ca, ++it_cb) {
+    if ((*it_ca)->getName() != (*it_cb)->getName() || (*it_ca)->radius != (*it_cb)->radius
+        || ! samePoint(*(*it_ca)->p1, *(*it_cb)->p1) || ! samePoint(*(*it_ca)->p2, *(*it_cb)->p2)) {
+      std::cerr << "Cylinder " << (*it_ca)->getName() << " differs" << std::endl;
+      return false;
+    }
+  }
+
+  std::list<vpMbtDistanceCircle *> circles_a, circles_b;
+  a.getLcircle(circles_a);
+  b.getLcircle(circles_b);
+  if (circles_a.size() != circles_b.size()) {
+    std::cerr << circles_a.size() << " circles instead of " << circles_b.size() << std::endl;
+    return false;
+  }
+  std::list<vpMbtDistanceCircle *>::const_iterator it_ob = circles_b.begin();
+  for (std::list<vpMbtDistanceCircle *>::const_iterator it_oa = circles_a.begin(); it_oa != circles_a.end(); ++it_oa, ++it_ob) {
+    if ((*it_oa)->getName() != (*it_ob)->getName() || (*it_oa)->radius != (*it_ob)->radius
+        || ! samePoint(*(*it_oa)->p1, *(*it_ob)->p1) || ! samePoint(*(*it_oa)->p2, *(*it_ob)->p2)
+        || ! samePoint(*(*it_oa)->p3, *(*it_ob)->p3)) {
+      std::cerr << "Circle " << (*it_oa)->getName() << " differs" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<unsigned char> readFile(const std::string &filename)
+{
+  std::ifstream file(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+  return std::vector<unsigned char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &filename, const std::vector<unsigned char> &data, const size_t size)
+{
+  std::ofstream file(filename.c_str(), std::ofstream::out | std::ofstream::binary);
+  file.write((const char *)&data[0], (std::streamsize)size);
+}
+
+// Hash stored at the end of the compiled models (64 bits FNV-1a)
+void updateChecksum(std::vector<unsigned char> &data)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < data.size() - 8; i++) {
+    hash ^= data[i];
+    hash *= 1099511628211ULL;
+  }
+  for (unsigned int i = 0; i < 8; i++)
+    data[data.size() - 8 + i] = (unsigned char)((hash >> (8*i)) & 0xFF);
+}
+
+// Check that loading the model throws a vpException::ioError
+bool isRejected(const std::string &filename)
+{
+  vpMbEdgeTracker tracker;
+  try {
+    tracker.loadModel(filename);
+  }
+  catch(vpException &e) {
+    return e.getCode() == vpException::ioError;
+  }
+  return false;
+}
+}
+
+int main()
+{
+  try {
+    std::string opath;
+#if defined(_WIN32)
+    opath = "C:/temp";
+#else
+    opath = "/tmp";
+#endif
+    if (vpIoTools::checkDirectory(opath) == false)
+      vpIoTools::makeDirectory(opath);
+    const std::string cao = opath + "/testMbtCompiledModel.cao";
+    const std::string bin = opath + "/testMbtCompiledModel.bin";
+    const std::string corrupted = opath + "/testMbtCompiledModel_corrupted.bin";
+
+    // Same model from the cao and from the compiled model
+    writeModel(cao, 0.068);
+    {
+      vpMbEdgeTracker tracker_cao, tracker_bin;
+      tracker_cao.loadModel(cao);
+      tracker_cao.saveCompiledModel(bin);
+      tracker_bin.loadModel(bin);
+      if (! sameModel(tracker_bin, tracker_cao)) {
+        std::cerr << "The compiled model differs from the cao model" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      unsigned int nbNamed = 0, nbLod = 0;
+      for (unsigned int i = 0; i < tracker_bin.getFaces().size(); i++) {
+        if (! tracker_bin.getFaces()[i]->getName().empty()) nbNamed++;
+        if (tracker_bin.getFaces()[i]->useLod) nbLod++;
+      }
+      if (nbNamed == 0 || nbLod == 0) {
+        std::cerr << "The names and the LOD parameters of the model are not read" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Truncated files
+    std::vector<unsigned char> data = readFile(bin);
+    const size_t sizes[] = {4, 12, 20, data.size() / 2, data.size() - 8, data.size() - 1};
+    for (unsigned int k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+      writeFile(corrupted, data, sizes[k]);
+      if (! isRejected(corrupted)) {
+        std::cerr << "The compiled model truncated to " << sizes[k] << " bytes is not rejected" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Modified content or checksum
+    const size_t offsets[] = {20, data.size() / 2, data.size() - 9, data.size() - 1};
+    for (unsigned int k = 0; k < sizeof(offsets) / sizeof(offsets[0]); k++) {
+      std::vector<unsigned char> modified = data;
+      modified[offsets[k]] ^= 0x10;
+      writeFile(corrupted, modified, modified.size());
+      if (! isRejected(corrupted)) {
+        std::cerr << "The compiled model with a wrong checksum is not rejected" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Other version of the format, with a valid checksum. The version follows the 8 bytes signature.
+    {
+      std::vector<unsigned char> modified = data;
+      modified[8]++;
+      updateChecksum(modified);
+      writeFile(corrupted, modified, modified.size());
+      if (! isRejected(corrupted)) {
+        std::cerr << "The compiled model with another version is not rejected" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // The same file with the right version is accepted
+      modified[8]--;
+      updateChecksum(modified);
+      writeFile(corrupted, modified, modified.size());
+      if (isRejected(corrupted)) {
+        std::cerr << "The compiled model is rejected once its checksum is computed again" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Once the cao model is modified, it is loaded instead of the compiled model
+    writeModel(cao, 0.07);
+    {
+      vpMbEdgeTracker tracker_cao, tracker_bin;
+      tracker_cao.loadModel(cao);
+      tracker_bin.loadModel(bin);
+      if (! sameModel(tracker_bin, tracker_cao)) {
+        std::cerr << "The modified cao model is not loaded instead of the compiled model" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
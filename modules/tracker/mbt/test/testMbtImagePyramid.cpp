@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the Gaussian decimation of vpMbtImagePyramid with a scalar reference.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbtImagePyramid.cpp
+
+  \brief Check vpMbtImagePyramid::decimateGaussian(), whose inner loops may be
+  vectorized, against a straightforward 5x5 binomial filter with replicated
+  borders, for all the image sizes from 1x1 to 40x40 and some larger ones.
+*/
+
+#include <visp3/core/vpImage.h>
+#include <visp3/mbt/vpMbtImagePyramid.h>
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+
+namespace {
+int clampIndex(int index, int size)
+{
+  return (index < 0) ? 0 : ((index >= size) ? size - 1 : index);
+}
+
+// Pixel (i,j) of the decimated image is the 5x5 binomial filter at (2i,2j), rounded
+void decimateGaussianReference(const vpImage<unsigned char> &I, vpImage<unsigned char> &Id)
+{
+  const unsigned int w[5] = {1, 4, 6, 4, 1};
+  int height = (int)I.getHeight(), width = (int)I.getWidth();
+  Id.resize(I.getHeight() / 2, I.getWidth() / 2);
+  for (int i = 0; i < (int)Id.getHeight(); i++) {
+    for (int j = 0; j < (int)Id.getWidth(); j++) {
+      unsigned int sum = 0;
+      for (int a = -2; a <= 2; a++)
+        for (int b = -2; b <= 2; b++)
+          sum += w[a+2] * w[b+2] * I[clampIndex(2*i + a, height)][clampIndex(2*j + b, width)];
+      Id[i][j] = (unsigned char)((sum + 128) >> 8);
+    }
+  }
+}
+
+bool check(unsigned int height, unsigned int width, std::vector<unsigned short> &buffer)
+{
+  vpImage<unsigned char> I(height, width);
+  for (unsigned int k = 0; k < I.getSize(); k++)
+    I.bitmap[k] = (unsigned char)(rand() % 256);
+  // Saturated corners reach the largest intermediate sums
+  I[0][0] = I[height-1][width-1] = 255;
+
+  vpImage<unsigned char> Id, Id_ref;
+  vpMbtImagePyramid::decimateGaussian(I, Id, buffer);
+  decimateGaussianReference(I, Id_ref);
+  if (Id.getHeight() != Id_ref.getHeight() || Id.getWidth() != Id_ref.getWidth() || Id != Id_ref) {
+    std::cerr << "decimateGaussian() differs from the reference for a " << height << "x" << width
+              << " image" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  srand(0);
+  // The buffer is kept from one size to the next one, as in vpMbtImagePyramid::build()
+  std::vector<unsigned short> buffer;
+  for (unsigned int height = 1; height <= 40; height++) {
+    for (unsigned int width = 1; width <= 40; width++) {
+      if (! check(height, width, buffer))
+        return EXIT_FAILURE;
+    }
+  }
+
+  unsigned int sizes[][2] = { {480, 640}, {481, 641}, {3, 1001}, {1001, 3}, {75, 99} };
+  for (unsigned int k = 0; k < 5; k++) {
+    if (! check(sizes[k][0], sizes[k][1], buffer))
+      return EXIT_FAILURE;
+  }
+
+  // A white image stays white at all the levels of the pyramid
+  vpImage<unsigned char> I(480, 640, 255);
+  vpMbtImagePyramid pyramid;
+  std::vector<bool> scales(4, true);
+  pyramid.build(I, scales, vpMbtImagePyramid::GAUSSIAN_FILTER);
+  for (unsigned int l = 1; l < 4; l++) {
+    const vpImage<unsigned char> &Il = *pyramid[l];
+    for (unsigned int k = 0; k < Il.getSize(); k++) {
+      if (Il.bitmap[k] != 255) {
+        std::cerr << "Level " << l << " of a white image is not white" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "Test succeed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -85,6 +85,20 @@ private:
   //int graph ;
   vpMatrix *mask ; //! Array of matrices defining the different masks (one for every angle step).
 
+public:
+  /*!
+    Arithmetic used to convolve the image with the masks.
+  */
+  typedef enum {
+    DOUBLE_CONVOLUTION,     /*!< Use the double precision masks returned by getMask(). */
+    FIXED_POINT_CONVOLUTION /*!< Use the 16 bits integer masks returned by getFixedPointMask(). */
+  } vpMeConvolutionType;
+
+private:
+  short *fixed_mask ; //! Masks with 16 bits integer coefficients, one mask of mask_size x fixed_mask_stride after the other.
+  unsigned int fixed_mask_stride ; //! Number of coefficients of a mask row, padded with zeros to a multiple of 8.
+  vpMeConvolutionType convolution_type ;
+
 public:
   vpMe() ;
   vpMe(const vpMe &me) ;
@@ -104,6 +118,46 @@ public:
   */
   inline vpMatrix* getMask() const { return mask; }
 
+  /*!
+    Get the masks with 16 bits integer coefficients. The coefficients of the
+    masks returned by getMask() are integers, so both versions of the masks
+    lead to the same convolution results.
+
+    Row \e a of the mask of index \e i starts at
+    getFixedPointMask() + (i * getMaskSize() + a) * getFixedPointMaskStride()
+    and is padded with zeros after getMaskSize() coefficients.
+
+    \return the value of the integer masks.
+
+    \sa getFixedPointMaskStride()
+  */
+  inline const short* getFixedPointMask() const { return fixed_mask; }
+
+  /*!
+    Get the number of coefficients of a row of the masks returned by
+    getFixedPointMask(), that is the mask size rounded up to a multiple of 8.
+
+    \return the stride of the integer masks.
+  */
+  inline unsigned int getFixedPointMaskStride() const { return fixed_mask_stride; }
+
+  /*!
+    Set the arithmetic used to convolve the image with the masks.
+
+    \param type : FIXED_POINT_CONVOLUTION, the default, uses 16 bits integer
+    masks and SIMD instructions when available. DOUBLE_CONVOLUTION uses the
+    matrices returned by getMask() and should be chosen if these matrices are
+    modified by the user.
+  */
+  inline void setConvolutionType(const vpMeConvolutionType &type) { convolution_type = type; }
+
+  /*!
+    Get the arithmetic used to convolve the image with the masks.
+
+    \return the convolution type.
+  */
+  inline vpMeConvolutionType getConvolutionType() const { return convolution_type; }
+
   /*!
     Set the number of mask applied to determine the object contour. The number of mask determines the precision of
     the normal of the edge for every sample. If precision is 2deg, then there
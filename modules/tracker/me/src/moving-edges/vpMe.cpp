@@ -47,6 +47,7 @@
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpMath.h>
 #include <stdlib.h>
+#include <string.h>
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 
@@ -379,6 +380,18 @@ vpMe::initMask()
 
   calcul_masques(angle, mask_size, mask ) ;
 
+  // Same masks with 16 bits coefficients, rows padded to use SIMD loads
+  if (fixed_mask != NULL)
+    delete [] fixed_mask;
+
+  fixed_mask_stride = ((mask_size + 7) / 8) * 8 ;
+  fixed_mask = new short[n_mask * mask_size * fixed_mask_stride] ;
+  memset(fixed_mask, 0, n_mask * mask_size * fixed_mask_stride * sizeof(short)) ;
+
+  for (unsigned int m = 0 ; m < n_mask ; m++)
+    for (unsigned int a = 0 ; a < mask_size ; a++)
+      for (unsigned int b = 0 ; b < mask_size ; b++)
+        fixed_mask[(m * mask_size + a) * fixed_mask_stride + b] = (short)vpMath::round(mask[m][a][b]) ;
 }
 
 
@@ -403,7 +416,8 @@ vpMe::print( )
 vpMe::vpMe()
   : threshold(1500), mu1(0.5), mu2(0.5), min_samplestep(4), anglestep(1), mask_sign(0),
     range(4), sample_step(10), ntotal_sample(0), points_to_track(500), mask_size(5),
-    n_mask(180), strip(2), mask(NULL)
+    n_mask(180), strip(2), mask(NULL), fixed_mask(NULL), fixed_mask_stride(0),
+    convolution_type(FIXED_POINT_CONVOLUTION)
 {
   //ntotal_sample = 0; // not sure that it is used
   //points_to_track = 500; // not sure that it is used
@@ -415,7 +429,8 @@ vpMe::vpMe()
 vpMe::vpMe(const vpMe &me)
   : threshold(1500), mu1(0.5), mu2(0.5), min_samplestep(4), anglestep(1), mask_sign(0),
     range(4), sample_step(10), ntotal_sample(0), points_to_track(500), mask_size(5),
-    n_mask(180), strip(2), mask(NULL)
+    n_mask(180), strip(2), mask(NULL), fixed_mask(NULL), fixed_mask_stride(0),
+    convolution_type(FIXED_POINT_CONVOLUTION)
 {
   *this = me;
 }
@@ -440,6 +455,7 @@ vpMe& vpMe::operator=(const vpMe &me)
   ntotal_sample = me.ntotal_sample;
   points_to_track = me.points_to_track;
   strip = me.strip ;
+  convolution_type = me.convolution_type ;
   
   initMask() ;
   return *this;
@@ -452,6 +468,11 @@ vpMe::~vpMe()
     delete [] mask ;
     mask = NULL;
   }
+  if (fixed_mask != NULL)
+  {
+    delete [] fixed_mask ;
+    fixed_mask = NULL;
+  }
 }
 
 
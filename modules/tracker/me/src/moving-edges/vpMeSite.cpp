@@ -50,9 +50,15 @@
 #include <stdlib.h>
 #include <cmath>    // std::fabs
 #include <limits>   // numeric_limits
+#include <vector>
 #include <visp3/me/vpMeSite.h>
 
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 static
 bool horsImage(int i , int j, int half, int rows, int cols)
@@ -63,6 +69,97 @@ bool horsImage(int i , int j, int half, int rows, int cols)
   //return((i < half + 1) || ( i > (rows - half - 3) )||(j < half + 1) || (j > (cols - half - 3) )) ;
   return( (0 < (half_1 - i) ) || ( (i - rows + half_3) > 0 ) || ( 0 < (half_1 -j) ) || ( (j - cols + half_3)  > 0 ) ) ;
 }
+
+// Index of the mask corresponding to the normal direction alpha
+static
+unsigned int getMaskIndex(double alpha, const vpMe *me)
+{
+  // Calculate tangent angle from normal
+  double theta  = alpha+M_PI/2;
+  // Move tangent angle to within 0->M_PI for a positive
+  // mask index
+  while (theta<0) theta += M_PI;
+  while (theta>M_PI) theta -= M_PI;
+
+  // Convert radians to degrees
+  int thetadeg = vpMath::round(theta * 180 / M_PI) ;
+
+  if(abs(thetadeg) == 180 )
+  {
+    thetadeg= 0 ;
+  }
+
+  return (unsigned int)(thetadeg/(double)me->getAngleStep());
+}
+
+/*
+  Convolution of the mask index_mask with the image patch whose top left
+  corner is (ihalf, jhalf). The patch has to be inside the image.
+*/
+static
+double convolutionAt(const vpImage<unsigned char> &I, const vpMe *me, unsigned int index_mask,
+                     unsigned int ihalf, unsigned int jhalf)
+{
+  unsigned int msize = me->getMaskSize();
+
+  if (me->getConvolutionType() == vpMe::DOUBLE_CONVOLUTION) {
+    double conv = 0.0 ;
+    for(unsigned int a = 0 ; a < msize ; a++ )
+    {
+      unsigned int ihalfa = ihalf+a ;
+      for(unsigned int b = 0 ; b < msize ; b++ )
+      {
+        conv += me->getMask()[index_mask][a][b] *
+            //	  I(i-half+a,j-half+b) ;
+            I(ihalfa,jhalf+b) ;
+      }
+    }
+    return conv;
+  }
+
+  // The coefficients are at most 100 in absolute value, so the sum fits in 32 bits
+  unsigned int stride = me->getFixedPointMaskStride();
+  const short *mask = me->getFixedPointMask() + index_mask * msize * stride;
+  int conv = 0;
+#if VISP_HAVE_SSE2
+  if (jhalf + stride <= I.getWidth()) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    for (unsigned int a = 0; a < msize; a++) {
+      const unsigned char *src = I[ihalf+a] + jhalf;
+      const short *m = mask + a * stride;
+      for (unsigned int b = 0; b < stride; b += 8) {
+        // Pixels beyond the mask size are multiplied by the zero padding
+        __m128i pix = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (src + b)), zero);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(pix, _mm_loadu_si128((const __m128i *) (m + b))));
+      }
+    }
+    acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 4));
+    conv = _mm_cvtsi128_si32(acc);
+  }
+  else
+#endif
+  {
+    for (unsigned int a = 0; a < msize; a++) {
+      const unsigned char *src = I[ihalf+a] + jhalf;
+      const short *m = mask + a * stride;
+      for (unsigned int b = 0; b < msize; b++) {
+        conv += m[b] * src[b];
+      }
+    }
+  }
+  return (double)conv;
+}
+
+// Candidate position along the normal of a site
+struct vpMeQuerySite
+{
+  double ifloat;
+  double jfloat;
+  int i;
+  int j;
+};
 #endif
 
 void
@@ -321,41 +418,13 @@ vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me)
   }
   else
   {
-    // Calculate tangent angle from normal
-    double theta  = alpha+M_PI/2;
-    // Move tangent angle to within 0->M_PI for a positive
-    // mask index
-    while (theta<0) theta += M_PI;
-    while (theta>M_PI) theta -= M_PI;
-
-    // Convert radians to degrees
-    int thetadeg = vpMath::round(theta * 180 / M_PI) ;
-
-    if(abs(thetadeg) == 180 )
-    {
-      thetadeg= 0 ;
-    }
-
-    unsigned int index_mask = (unsigned int)(thetadeg/(double)me->getAngleStep());
+    unsigned int index_mask = getMaskIndex(alpha, me);
 
     unsigned int i_ = static_cast<unsigned int>(i);
     unsigned int j_ = static_cast<unsigned int>(j);
     unsigned int half_ = static_cast<unsigned int>(half);
 
-    unsigned int ihalf = i_-half_ ;
-    unsigned int jhalf = j_-half_ ;
-
-    for(unsigned int a = 0 ; a < msize ; a++ )
-    {
-      unsigned int ihalfa = ihalf+a ;
-      for(unsigned int b = 0 ; b < msize ; b++ )
-      {
-        conv += mask_sign* me->getMask()[index_mask][a][b] *
-            //	  I(i-half+a,j-half+b) ;
-            I(ihalfa,jhalf+b) ;
-      }
-    }
-
+    conv = mask_sign * convolutionAt(I, me, index_mask, i_-half_, j_-half_);
   }
 
   return(conv) ;
@@ -497,30 +566,72 @@ vpMeSite::track(const vpImage<unsigned char>& I,
   //       delete []likelihood; // modif portage
   //     }
 
-  vpMeSite  *list_query_pixels ;
   int  max_rank =-1 ;
   //   int max_rank1=-1 ;
   //   int max_rank2 = -1;
   double  max_convolution = 0 ;
   double max = 0 ;
   double contraste = 0;
-  //  vpDisplay::display(I) ;
-  //  vpERROR_TRACE("getclcik %d",me->range) ;
-  //  vpDisplay::getClick(I) ;
 
   // range = +/- range of pixels within which the correspondent
   // of the current pixel will be sought
   unsigned int range  = me->getRange() ;
+  unsigned int nb_query = 2 * range + 1 ;
+
+  // Candidates along the normal. They are kept on the stack for the usual
+  // ranges to avoid a heap allocation per site and per frame.
+  const unsigned int max_stack_query = 65 ;
+  vpMeQuerySite stack_query[max_stack_query] ;
+  double stack_convolution[max_stack_query] ;
+  std::vector<vpMeQuerySite> heap_query ;
+  std::vector<double> heap_convolution ;
+  vpMeQuerySite *query = stack_query ;
+  double *convolution_ = stack_convolution ;
+  if (nb_query > max_stack_query) {
+    heap_query.resize(nb_query) ;
+    heap_convolution.resize(nb_query) ;
+    query = &heap_query[0] ;
+    convolution_ = &heap_convolution[0] ;
+  }
 
-  //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  << std::endl ;
-  list_query_pixels = getQueryList(I, (int)range) ;
+  double salpha = sin(alpha);
+  double calpha = cos(alpha);
+  int k = -(int)range ;
+  for(unsigned int n = 0 ; n < nb_query ; n++, k++)
+  {
+    query[n].ifloat = ifloat+k*salpha ;
+    query[n].jfloat = jfloat+k*calpha ;
+    query[n].i = (int)query[n].ifloat ;
+    query[n].j = (int)query[n].jfloat ;
+
+    // Display
+    if    ((selectDisplay==RANGE_RESULT)||(selectDisplay==RANGE)) {
+      vpDisplay::displayCross(I, vpImagePoint(query[n].ifloat, query[n].jfloat), 1, vpColor::yellow) ;
+    }
+  }
+
+  // All the candidates share the same mask
+  int height_ = static_cast<int>(I.getHeight());
+  int width_  = static_cast<int>(I.getWidth());
+  int half = (static_cast<int>(me->getMaskSize()) - 1) >> 1 ;
+  unsigned int index_mask = getMaskIndex(alpha, me);
+  for(unsigned int n = 0 ; n < nb_query ; n++)
+  {
+    if(horsImage( query[n].i , query[n].j , half + me->getStrip() , height_, width_))
+    {
+      convolution_[n] = 0.0 ;
+      query[n].i = 0 ; query[n].j = 0 ;
+    }
+    else
+    {
+      convolution_[n] = mask_sign * convolutionAt(I, me, index_mask, (unsigned int)(query[n].i - half),
+                                                  (unsigned int)(query[n].j - half));
+    }
+  }
 
   double  contraste_max = 1 + me->getMu2();
   double  contraste_min = 1 - me->getMu1();
 
-  // array in which likelihood ratios will be stored
-  double  *likelihood= new double[ 2 * range + 1 ] ;
-
   int ii_1 = i ;
   int jj_1 = j ;
   i_1 = i ;
@@ -529,43 +640,35 @@ vpMeSite::track(const vpImage<unsigned char>& I,
   threshold = me->getThreshold() ;
   double diff = 1e6;
 
-  //    std::cout <<"---------------------"<<std::endl ;
-  for(unsigned int n = 0 ; n < 2 * range + 1 ; n++)
+  for(unsigned int n = 0 ; n < nb_query ; n++)
   {
-    //   convolution results
-    double convolution_ = list_query_pixels[n].convolution(I, me) ;
-
     // luminance ratio of reference pixel to potential correspondent pixel
     // the luminance must be similar, hence the ratio value should
     // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
     if( test_contraste )
     {
-      likelihood[n] = fabs(convolution_ + convlt );
-      if (likelihood[n]> threshold)
+      double likelihood = fabs(convolution_[n] + convlt );
+      if (likelihood > threshold)
       {
-        contraste = convolution_ / convlt;
+        contraste = convolution_[n] / convlt;
         if((contraste > contraste_min) && (contraste < contraste_max) && fabs(1-contraste) < diff)
         {
           diff = fabs(1-contraste);
-          max_convolution= convolution_;
-          max = likelihood[n] ;
+          max_convolution= convolution_[n];
+          max = likelihood ;
           max_rank = (int)n ;
-          // 	    max_rank2 = max_rank1;
-          // 	    max_rank1 = max_rank;
         }
       }
     }
 
     else
     {
-      likelihood[n] = fabs(2*convolution_) ;
-      if (likelihood[n] > max  && likelihood[n] > threshold)
+      double likelihood = fabs(2*convolution_[n]) ;
+      if (likelihood > max  && likelihood > threshold)
       {
-        max_convolution= convolution_;
-        max = likelihood[n] ;
+        max_convolution= convolution_[n];
+        max = likelihood ;
         max_rank = (int)n ;
-        //           max_rank2 = max_rank1;
-        //           max_rank1 = max_rank;
       }
     }
   }
@@ -578,28 +681,34 @@ vpMeSite::track(const vpImage<unsigned char>& I,
   //  if (test_contrast)
   if(max_rank >= 0)
   {
+    const vpMeQuerySite &best = query[max_rank] ;
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[max_rank].i );
-      ip.set_j( list_query_pixels[max_rank].j );
+      ip.set_i( best.i );
+      ip.set_j( best.j );
       vpDisplay::displayPoint(I, ip, vpColor::red);
     }
-		
-    *this = list_query_pixels[max_rank] ;//The vpMeSite2 is replaced by the vpMeSite2 of max likelihood
+
+    // The site is replaced by the candidate of max likelihood
+    ifloat = best.ifloat ;
+    jfloat = best.jfloat ;
+    i = best.i ;
+    j = best.j ;
+    v = 0 ;
+    weight = 1 ;
+    setState(NO_SUPPRESSION) ;
     normGradient =  vpMath::sqr(max_convolution);
 
     convlt = max_convolution;
     i_1 = ii_1; //list_query_pixels[max_rank].i ;
     j_1 = jj_1; //list_query_pixels[max_rank].j ;
-    delete []list_query_pixels ;
-    delete []likelihood;
   }
   else //none of the query sites is better than the threshold
   {
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[0].i );
-      ip.set_j( list_query_pixels[0].j );
+      ip.set_i( query[0].i );
+      ip.set_j( query[0].j );
       vpDisplay::displayPoint(I, ip, vpColor::green);
     }
     normGradient = 0 ;
@@ -608,9 +717,6 @@ vpMeSite::track(const vpImage<unsigned char>& I,
       state = CONSTRAST; // contrast suppression
     else
       state = THRESHOLD; // threshold suppression
-
-    delete []list_query_pixels ;
-    delete []likelihood; // modif portage
   }
 }
 
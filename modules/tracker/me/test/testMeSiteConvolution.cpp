@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the fixed-point and double precision moving-edge convolutions.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMeSiteConvolution.cpp
+
+  \brief Check that vpMeSite::track() gives the same result with the fixed-point
+  and the double precision masks of vpMe, and compare their computation time.
+*/
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/me/vpMe.h>
+#include <visp3/me/vpMeSite.h>
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <cmath>
+
+int main()
+{
+  // Image with a disk and some noise
+  vpImage<unsigned char> I(480, 640);
+  srand(0);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double r = sqrt(vpMath::sqr(i - 240.) + vpMath::sqr(j - 320.));
+      int val = (r < 150 ? 180 : 60) + rand() % 21 - 10;
+      I[i][j] = (unsigned char)val;
+    }
+  }
+
+  // Sites around the contour of the disk, with an offset along the normal
+  std::vector<vpMeSite> sites;
+  for (unsigned int k = 0; k < 2000; k++) {
+    double theta = 2 * M_PI * k / 2000.;
+    double offset = (rand() % 7) - 3;
+    double ip = 240. + (150. + offset) * sin(theta);
+    double jp = 320. + (150. + offset) * cos(theta);
+    vpMeSite s;
+    s.init(ip, jp, theta, 0, (k % 2) ? 1 : -1);
+    sites.push_back(s);
+  }
+  // Sites close to the image border
+  for (unsigned int k = 0; k < 20; k++) {
+    vpMeSite s;
+    s.init(3. + k / 4., 2. + k, M_PI / 4., 0, 1);
+    sites.push_back(s);
+  }
+
+  unsigned int mask_sizes[3] = {5, 7, 11};
+  for (unsigned int m = 0; m < 3; m++) {
+    vpMe me_fixed;
+    me_fixed.setMaskSize(mask_sizes[m]);
+    me_fixed.setRange(6);
+    me_fixed.setThreshold(5000);
+    me_fixed.setConvolutionType(vpMe::FIXED_POINT_CONVOLUTION);
+    vpMe me_double = me_fixed;
+    me_double.setConvolutionType(vpMe::DOUBLE_CONVOLUTION);
+
+    // Initial contrast of each site
+    std::vector<vpMeSite> sites_fixed = sites, sites_double = sites;
+    for (size_t k = 0; k < sites.size(); k++) {
+      sites_fixed[k].convlt = sites_fixed[k].convolution(I, &me_fixed);
+      sites_double[k].convlt = sites_double[k].convolution(I, &me_double);
+      if (std::fabs(sites_fixed[k].convlt - sites_double[k].convlt) > 0.) {
+        std::cerr << "vpMeSite::convolution() differs for site " << k << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    for (unsigned int iter = 0; iter < 2; iter++) {
+      bool test_contrast = (iter == 0);
+      std::vector<vpMeSite> tracked_fixed = sites_fixed, tracked_double = sites_double;
+
+      double t_double = vpTime::measureTimeMs();
+      for (size_t k = 0; k < tracked_double.size(); k++)
+        tracked_double[k].track(I, &me_double, test_contrast);
+      t_double = vpTime::measureTimeMs() - t_double;
+
+      double t_fixed = vpTime::measureTimeMs();
+      for (size_t k = 0; k < tracked_fixed.size(); k++)
+        tracked_fixed[k].track(I, &me_fixed, test_contrast);
+      t_fixed = vpTime::measureTimeMs() - t_fixed;
+
+      unsigned int nb_tracked = 0;
+      for (size_t k = 0; k < tracked_fixed.size(); k++) {
+        if (tracked_fixed[k].getState() == vpMeSite::NO_SUPPRESSION)
+          nb_tracked++;
+        const vpMeSite &sf = tracked_fixed[k], &sd = tracked_double[k];
+        if (sf.i != sd.i || sf.j != sd.j || sf.getState() != sd.getState()
+            || std::fabs(sf.convlt - sd.convlt) > 0. || std::fabs(sf.ifloat - sd.ifloat) > 0.) {
+          std::cerr << "vpMeSite::track() differs for site " << k << " with a mask size of "
+                    << mask_sizes[m] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      std::cout << "Mask size " << mask_sizes[m] << (test_contrast ? " with" : " without")
+                << " contrast test: " << nb_tracked << " sites tracked, double " << t_double
+                << " ms, fixed-point " << t_fixed << " ms" << std::endl;
+      if (nb_tracked == 0) {
+        std::cerr << "No site tracked" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "Test succeed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -45,6 +45,7 @@
 #define vpTemplateTracker_hh
 
 #include <math.h>
+#include <vector>
 
 #include <visp3/tt/vpTemplateTrackerHeader.h>
 #include <visp3/tt/vpTemplateTrackerZone.h>
@@ -130,6 +131,13 @@ class VISP_EXPORT vpTemplateTracker
     vpColVector                 X2;
     //temporary derivative matrix
     vpMatrix                    dW;
+    //template points warped all at once by warpTemplate()
+    std::vector<double>         ptTemplateU;
+    std::vector<double>         ptTemplateV;
+    std::vector<double>         ptWarpedU;
+    std::vector<double>         ptWarpedV;
+    std::vector<double>         ptWarpedValue;
+    std::vector<unsigned char>  ptWarpedIn;
 
     vpImage<double>             BI;
     vpImage<double>             dIx ;
@@ -172,7 +180,8 @@ class VISP_EXPORT vpTemplateTracker
         blur(false), useBrent(false), nbIterBrent(0), taillef(0), fgG(NULL), fgdG(NULL),
         ratioPixelIn(0), mod_i(0), mod_j(0), nbParam(), lambdaDep(0), iterationMax(0),
         iterationGlobale(0), diverge(false), nbIteration(0), useCompositionnal(false),
-        useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_()
+        useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), ptTemplateU(), ptTemplateV(),
+        ptWarpedU(), ptWarpedV(), ptWarpedValue(), ptWarpedIn(), BI(), dIx(), dIy(), zoneRef_()
     {}
     vpTemplateTracker(vpTemplateTrackerWarp *_warp);
     virtual        ~vpTemplateTracker();
@@ -259,6 +268,10 @@ class VISP_EXPORT vpTemplateTracker
 
     void            computeOptimalBrentGain(const vpImage<unsigned char> &I,vpColVector &tp,double tMI,vpColVector &direction,double &alpha);
     virtual double  getCost(const vpImage<unsigned char> &I, const vpColVector &tp) = 0;
+    static void     getBilinearValues(const vpImage<unsigned char> &I, const double *u, const double *v, unsigned int n,
+                                      double *val, unsigned char *in);
+    static void     getBilinearValues(const vpImage<double> &I, const double *u, const double *v, unsigned int n,
+                                      double *val, unsigned char *in);
     void            getGaussianBluredImage(const vpImage<unsigned char> &I){ vpImageFilter::filter(I, BI,fgG,taillef); }
     virtual void    initHessienDesired(const vpImage<unsigned char> &I)=0;
     virtual void    initHessienDesiredPyr(const vpImage<unsigned char> &I);
@@ -267,6 +280,7 @@ class VISP_EXPORT vpTemplateTracker
     virtual void    initTrackingPyr(const vpImage<unsigned char>& I,vpTemplateTrackerZone &zone);
     virtual void    trackNoPyr(const vpImage<unsigned char> &I) = 0;
     virtual void    trackPyr(const vpImage<unsigned char> &I);
+    void            warpTemplate(const vpImage<unsigned char> &I, const vpColVector &tp);
 };
 #endif
 
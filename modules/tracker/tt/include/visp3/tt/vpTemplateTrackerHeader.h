@@ -93,11 +93,12 @@ struct vpTemplateTrackerPointSuppMIInv {
     double *BtInit;
     double *Bt;
     double *dBt;
+    double *d2Bt;
     double *d2W;
     double *d2Wx;
     double *d2Wy;
     vpTemplateTrackerPointSuppMIInv() : et(0), ct(0), BtInit(NULL), Bt(NULL), dBt(NULL),
-      d2W(NULL), d2Wx(NULL), d2Wy(NULL) {}
+      d2Bt(NULL), d2W(NULL), d2Wx(NULL), d2Wy(NULL) {}
 };
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
@@ -168,6 +168,19 @@ class VISP_EXPORT vpTemplateTrackerWarpHomography: public vpTemplateTrackerWarp
     */
     void pRondp(const vpColVector &p1, const vpColVector &p2,vpColVector &pres) const ;
 
+    /*!
+      Warp a list of points. The parameters are only read once for the
+      whole list, which is much faster than calling warpX() on each point.
+
+      \param ut0 : List of u coordinates of the points.
+      \param vt0 : List of v coordinates of the points.
+      \param nb_pt : Number of points to consider.
+      \param p : Parameters of the warp.
+      \param u : Resulting u coordinates.
+      \param v : resulting v coordinates.
+    */
+    void warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v);
+
     /*!
       Warp a point.
 
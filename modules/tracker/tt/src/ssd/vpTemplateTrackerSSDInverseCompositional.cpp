@@ -115,8 +115,6 @@ void vpTemplateTrackerSSDInverseCompositional::trackNoPyr(const vpImage<unsigned
   double IW;
   double Tij;
   unsigned int iteration=0;
-  int i,j;
-  double i2,j2;
   double alpha=2.;
   //vpTemplateTrackerPointtest *pt;
   initPosEvalRMS(p);
@@ -127,27 +125,18 @@ void vpTemplateTrackerSSDInverseCompositional::trackNoPyr(const vpImage<unsigned
     unsigned int Nbpoint=0;
     double erreur=0;
     dp=0;
-    Warp->computeCoeff(p);
+    warpTemplate(I,p);
     for(unsigned int point=0;point<templateSize;point++)
     {
       if((!useTemplateSelect)||(ptTemplateSelect[point]))
       {
         //pt=&ptTemplatetest[point];
         pt=&ptTemplate[point];
-        i=pt->y;
-        j=pt->x;
-        X1[0]=j;X1[1]=i;
-        Warp->computeDenom(X1,p);
-        Warp->warpX(X1,X2,p);
-        j2=X2[0];i2=X2[1];
-
-        if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+
+        if(ptWarpedIn[point])
         {
           Tij=pt->val;
-          if(!blur)
-            IW=I.getValue(i2,j2);
-          else
-            IW=BI.getValue(i2,j2);
+          IW=ptWarpedValue[point];
           Nbpoint++;
           double er=(Tij-IW);
           for(unsigned int it=0;it<nbParam;it++)
@@ -39,6 +39,107 @@
 
 #include <visp3/tt/vpTemplateTracker.h>
 #include <visp3/tt/vpTemplateTrackerBSpline.h>
+#include <visp3/core/vpMath.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Same rounding as vpImage<Type>::getValue()
+inline double bilinearResult(double value, const unsigned char *) { return (double)(unsigned char)vpMath::round(value); }
+inline double bilinearResult(double value, const double *) { return value; }
+
+// Interpolation of a point known to be inside the image
+template<class Type>
+inline double bilinearValue(const Type *bitmap, unsigned int w, double i2, double j2)
+{
+  unsigned int iround = (unsigned int)i2;
+  unsigned int jround = (unsigned int)j2;
+  double rratio = i2 - (double)iround;
+  double cratio = j2 - (double)jround;
+  double rfrac = 1.0 - rratio;
+  double cfrac = 1.0 - cratio;
+  const Type *a = bitmap + (size_t)iround * w + jround;
+  double value = ((double)a[0] * rfrac + (double)a[w] * rratio)*cfrac
+      + ((double)a[1] * rfrac + (double)a[w+1] * rratio)*cratio;
+  return bilinearResult(value, bitmap);
+}
+
+/*
+  Bilinear interpolation of a list of sub-pixel positions with exactly the
+  arithmetic of vpImage<Type>::getValue(). A point is considered inside when
+  0 <= v < height-1 and 0 <= u < width-1, like in the template trackers; in
+  that case its four neighbours exist and floor() is a simple truncation.
+*/
+template<class Type>
+void bilinearGather(const vpImage<Type> &I, const double *u, const double *v, unsigned int n,
+                    double *val, unsigned char *in)
+{
+  const double imax = I.getHeight()-1;
+  const double jmax = I.getWidth()-1;
+  const unsigned int w = I.getWidth();
+  const Type *bitmap = I.bitmap;
+
+  unsigned int k = 0;
+#if VISP_HAVE_SSE2
+  const __m128d vzero = _mm_setzero_pd();
+  const __m128d vone = _mm_set1_pd(1.0);
+  const __m128d vimax = _mm_set1_pd(imax);
+  const __m128d vjmax = _mm_set1_pd(jmax);
+  double res[2];
+  for (; k + 2 <= n; k += 2) {
+    __m128d vi = _mm_loadu_pd(v + k);
+    __m128d vj = _mm_loadu_pd(u + k);
+    __m128d inside = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(vi, vzero), _mm_cmpge_pd(vj, vzero)),
+                                _mm_and_pd(_mm_cmplt_pd(vi, vimax), _mm_cmplt_pd(vj, vjmax)));
+    int mask = _mm_movemask_pd(inside);
+    if (mask != 3) {
+      // At least one of the two points is outside the image
+      for (unsigned int l = 0; l < 2; l++) {
+        in[k+l] = (unsigned char)((mask >> l) & 1);
+        if (in[k+l])
+          val[k+l] = bilinearValue(bitmap, w, v[k+l], u[k+l]);
+      }
+      continue;
+    }
+
+    __m128i ii = _mm_cvttpd_epi32(vi);
+    __m128i jj = _mm_cvttpd_epi32(vj);
+    __m128d rratio = _mm_sub_pd(vi, _mm_cvtepi32_pd(ii));
+    __m128d cratio = _mm_sub_pd(vj, _mm_cvtepi32_pd(jj));
+    __m128d rfrac = _mm_sub_pd(vone, rratio);
+    __m128d cfrac = _mm_sub_pd(vone, cratio);
+
+    const Type *a0 = bitmap + (size_t)_mm_cvtsi128_si32(ii) * w + (size_t)_mm_cvtsi128_si32(jj);
+    const Type *a1 = bitmap + (size_t)_mm_cvtsi128_si32(_mm_srli_si128(ii, 4)) * w
+        + (size_t)_mm_cvtsi128_si32(_mm_srli_si128(jj, 4));
+    __m128d p00 = _mm_set_pd((double)a1[0], (double)a0[0]);
+    __m128d p01 = _mm_set_pd((double)a1[1], (double)a0[1]);
+    __m128d p10 = _mm_set_pd((double)a1[w], (double)a0[w]);
+    __m128d p11 = _mm_set_pd((double)a1[w+1], (double)a0[w+1]);
+
+    __m128d value = _mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(p00, rfrac), _mm_mul_pd(p10, rratio)), cfrac),
+                               _mm_mul_pd(_mm_add_pd(_mm_mul_pd(p01, rfrac), _mm_mul_pd(p11, rratio)), cratio));
+    _mm_storeu_pd(res, value);
+    val[k] = bilinearResult(res[0], bitmap);
+    val[k+1] = bilinearResult(res[1], bitmap);
+    in[k] = in[k+1] = 1;
+  }
+#endif
+  for (; k < n; k++) {
+    double i2 = v[k];
+    double j2 = u[k];
+    in[k] = (unsigned char)((i2 >= 0) && (j2 >= 0) && (i2 < imax) && (j2 < jmax));
+    if (in[k])
+      val[k] = bilinearValue(bitmap, w, i2, j2);
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
   : nbLvlPyr(1), l0Pyr(0), pyrInitialised(false), ptTemplate(NULL), ptTemplatePyr(NULL),
@@ -52,7 +153,8 @@ vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
     taillef(7), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0),
     lambdaDep(0.001), iterationMax(30), iterationGlobale(0), diverge(false), nbIteration(0),
     useCompositionnal(true), useInverse(false), Warp(_warp), p(0), dp(), X1(), X2(),
-    dW(), BI(), dIx(), dIy(), zoneRef_()
+    dW(), ptTemplateU(), ptTemplateV(), ptWarpedU(), ptWarpedV(), ptWarpedValue(), ptWarpedIn(),
+    BI(), dIx(), dIy(), zoneRef_()
 {
   nbParam = Warp->getNbParam() ;
   p.resize(nbParam);
@@ -220,6 +322,7 @@ void vpTemplateTracker::resetTracker()
             delete[] ptTemplateSuppPyr[i][point].Bt;
             delete[] ptTemplateSuppPyr[i][point].BtInit;
             delete[] ptTemplateSuppPyr[i][point].dBt;
+            delete[] ptTemplateSuppPyr[i][point].d2Bt;
             delete[] ptTemplateSuppPyr[i][point].d2W;
             delete[] ptTemplateSuppPyr[i][point].d2Wx;
             delete[] ptTemplateSuppPyr[i][point].d2Wy;
@@ -297,6 +400,7 @@ void vpTemplateTracker::resetTracker()
         delete[] ptTemplateSupp[point].Bt;
         delete[] ptTemplateSupp[point].BtInit;
         delete[] ptTemplateSupp[point].dBt;
+        delete[] ptTemplateSupp[point].d2Bt;
         delete[] ptTemplateSupp[point].d2W;
         delete[] ptTemplateSupp[point].d2Wx;
         delete[] ptTemplateSupp[point].d2Wy;
@@ -945,3 +1049,74 @@ void vpTemplateTracker::trackRobust(const vpImage<unsigned char> &I)
   else
     trackNoPyr(I);
 }
+
+/*!
+  Interpolate an image at a list of sub-pixel positions.
+
+  \param I : Image to interpolate.
+  \param u : Coordinates along the columns.
+  \param v : Coordinates along the rows.
+  \param n : Number of positions.
+  \param val : Interpolated values, same as vpImage::getValue(v[k], u[k]). Only
+  set for the positions inside the image.
+  \param in : Set to 1 when 0 <= v[k] < height-1 and 0 <= u[k] < width-1, 0 otherwise.
+ */
+void vpTemplateTracker::getBilinearValues(const vpImage<unsigned char> &I, const double *u, const double *v,
+                                          unsigned int n, double *val, unsigned char *in)
+{
+  bilinearGather(I, u, v, n, val, in);
+}
+
+/*!
+  Interpolate an image of double at a list of sub-pixel positions.
+
+  \param I : Image to interpolate.
+  \param u : Coordinates along the columns.
+  \param v : Coordinates along the rows.
+  \param n : Number of positions.
+  \param val : Interpolated values, same as vpImage::getValue(v[k], u[k]). Only
+  set for the positions inside the image.
+  \param in : Set to 1 when 0 <= v[k] < height-1 and 0 <= u[k] < width-1, 0 otherwise.
+ */
+void vpTemplateTracker::getBilinearValues(const vpImage<double> &I, const double *u, const double *v,
+                                          unsigned int n, double *val, unsigned char *in)
+{
+  bilinearGather(I, u, v, n, val, in);
+}
+
+/*!
+  Warp all the points of the current template with a single call to
+  vpTemplateTrackerWarp::warp() and interpolate the image (or its blurred
+  version BI when blur is enabled) at the warped positions.
+
+  The results are stored in ptWarpedU, ptWarpedV (column and row coordinates),
+  ptWarpedIn (1 if the point falls inside the image) and ptWarpedValue.
+
+  \param I : Current image.
+  \param tp : Parameters of the warping function.
+ */
+void vpTemplateTracker::warpTemplate(const vpImage<unsigned char> &I, const vpColVector &tp)
+{
+  if (ptTemplateU.size() < templateSize) {
+    ptTemplateU.resize(templateSize);
+    ptTemplateV.resize(templateSize);
+    ptWarpedU.resize(templateSize);
+    ptWarpedV.resize(templateSize);
+    ptWarpedValue.resize(templateSize);
+    ptWarpedIn.resize(templateSize);
+  }
+  if (templateSize == 0)
+    return;
+
+  for (unsigned int point = 0; point < templateSize; point++) {
+    ptTemplateU[point] = ptTemplate[point].x;
+    ptTemplateV[point] = ptTemplate[point].y;
+  }
+
+  Warp->warp(&ptTemplateU[0], &ptTemplateV[0], (int)templateSize, tp, &ptWarpedU[0], &ptWarpedV[0]);
+
+  if (!blur)
+    getBilinearValues(I, &ptWarpedU[0], &ptWarpedV[0], templateSize, &ptWarpedValue[0], &ptWarpedIn[0]);
+  else
+    getBilinearValues(BI, &ptWarpedU[0], &ptWarpedV[0], templateSize, &ptWarpedValue[0], &ptWarpedIn[0]);
+}
@@ -102,6 +102,17 @@ void vpTemplateTrackerWarpAffine::warpX(const vpColVector &vX,vpColVector &vXres
   vXres[1]=ParamM[1]*vX[0]+(1.0+ParamM[3])*vX[1]+ParamM[5];
 }
 
+void vpTemplateTrackerWarpAffine::warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v)
+{
+  const double a00=1.0+p[0], a01=p[2], a02=p[4];
+  const double a10=p[1], a11=1.0+p[3], a12=p[5];
+  for(int i=0;i<nb_pt;i++)
+  {
+    u[i]=a00*ut0[i]+a01*vt0[i]+a02;
+    v[i]=a10*ut0[i]+a11*vt0[i]+a12;
+  }
+}
+
 void vpTemplateTrackerWarpAffine::dWarp(const vpColVector &X1,const vpColVector &/*X2*/,const vpColVector &/*ParamM*/,vpMatrix &dW_)
 {
   double j=X1[0];
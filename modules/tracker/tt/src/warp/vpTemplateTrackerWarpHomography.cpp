@@ -121,6 +121,24 @@ void vpTemplateTrackerWarpHomography::warpX(const vpColVector &vX,vpColVector &v
     throw(vpTrackingException(vpTrackingException::fatalError,"Division by zero in vpTemplateTrackerWarpHomography::warpX()"));
 }
 
+void vpTemplateTrackerWarpHomography::warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v)
+{
+  const double h00=1.+p[0], h01=p[3], h02=p[6];
+  const double h10=p[1], h11=1.+p[4], h12=p[7];
+  const double h20=p[2], h21=p[5];
+  for(int i=0;i<nb_pt;i++)
+  {
+    double d=(1./(h20*ut0[i]+h21*vt0[i]+1.));
+    if(d>0)
+    {
+      u[i]=(h00*ut0[i]+h01*vt0[i]+h02)*d;
+      v[i]=(h10*ut0[i]+h11*vt0[i]+h12)*d;
+    }
+    else
+      throw(vpTrackingException(vpTrackingException::fatalError,"Division by zero in vpTemplateTrackerWarpHomography::warp()"));
+  }
+}
+
 void vpTemplateTrackerWarpHomography::dWarp(const vpColVector &X1,const vpColVector &X2,const vpColVector &/*ParamM*/,vpMatrix &dW_)
 {
   double j=X1[0];
@@ -246,6 +246,20 @@ void vpTemplateTrackerWarpHomographySL3::warpX(const vpColVector &vX,vpColVector
   vXres[0]=(j*G[0][0]+i*G[0][1]+G[0][2])/denom;
   vXres[1]=(j*G[1][0]+i*G[1][1]+G[1][2])/denom;
 }
+
+void vpTemplateTrackerWarpHomographySL3::warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v)
+{
+  computeCoeff(p);
+  const double g00=G[0][0], g01=G[0][1], g02=G[0][2];
+  const double g10=G[1][0], g11=G[1][1], g12=G[1][2];
+  const double g20=G[2][0], g21=G[2][1], g22=G[2][2];
+  for(int i=0;i<nb_pt;i++)
+  {
+    double d=ut0[i]*g20+vt0[i]*g21+g22;
+    u[i]=(ut0[i]*g00+vt0[i]*g01+g02)/d;
+    v[i]=(ut0[i]*g10+vt0[i]*g11+g12)/d;
+  }
+}
 void vpTemplateTrackerWarpHomographySL3::warpX(const int &i,const int &j,double &i2,double &j2,const vpColVector &/*ParamM*/)
 {
   j2=(j*G[0][0]+i*G[0][1]+G[0][2])/denom;
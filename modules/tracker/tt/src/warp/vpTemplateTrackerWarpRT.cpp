@@ -94,6 +94,19 @@ void vpTemplateTrackerWarpRT::warpX(const vpColVector &vX,vpColVector &vXres,con
   vXres[1]=(sin(ParamM[0])*vX[0]) + (cos(ParamM[0])*vX[1]) + ParamM[2];
 }
 
+void vpTemplateTrackerWarpRT::warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v)
+{
+  const double c=cos(p[0]);
+  const double s=sin(p[0]);
+  const double tu=p[1];
+  const double tv=p[2];
+  for(int i=0;i<nb_pt;i++)
+  {
+    u[i]=(c*ut0[i]) - (s*vt0[i]) + tu;
+    v[i]=(s*ut0[i]) + (c*vt0[i]) + tv;
+  }
+}
+
 void vpTemplateTrackerWarpRT::dWarp(const vpColVector &X1,const vpColVector &/*X2*/,const vpColVector &ParamM,vpMatrix &dW_)
 {
   double j=X1[0];
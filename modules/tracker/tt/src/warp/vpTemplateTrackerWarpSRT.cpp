@@ -97,6 +97,19 @@ void vpTemplateTrackerWarpSRT::warpX(const vpColVector &vX,vpColVector &vXres,co
   vXres[1]=((1.0+ParamM[0])*sin(ParamM[1])*vX[0]) + ((1.0+ParamM[0])*cos(ParamM[1])*vX[1]) + ParamM[3];
 }
 
+void vpTemplateTrackerWarpSRT::warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v)
+{
+  const double c=(1.0+p[0])*cos(p[1]);
+  const double s=(1.0+p[0])*sin(p[1]);
+  const double tu=p[2];
+  const double tv=p[3];
+  for(int i=0;i<nb_pt;i++)
+  {
+    u[i]=(c*ut0[i]) - (s*vt0[i]) + tu;
+    v[i]=(s*ut0[i]) + (c*vt0[i]) + tv;
+  }
+}
+
 void vpTemplateTrackerWarpSRT::dWarp(const vpColVector &X1,const vpColVector &/*X2*/,const vpColVector &ParamM,vpMatrix &dW_)
 {
   double j=X1[0];
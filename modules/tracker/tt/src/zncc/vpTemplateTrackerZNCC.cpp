@@ -57,31 +57,18 @@ vpTemplateTrackerZNCC::vpTemplateTrackerZNCC(vpTemplateTrackerWarp *warp)
 double vpTemplateTrackerZNCC::getCost(const vpImage<unsigned char> &I, const vpColVector &tp)
 {
   double IW,Tij;
-  int i,j;
-  double i2,j2;
   int Nbpoint=0;
 
-  Warp->computeCoeff(tp);
+  warpTemplate(I,tp);
 
   double moyTij=0;
   double moyIW=0;
   for(unsigned int point=0;point<templateSize;point++)
   {
-    i=ptTemplate[point].y;
-    j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    Warp->computeDenom(X1,tp);
-    Warp->warpX(X1,X2,tp);
-
-    j2=X2[0];i2=X2[1];
-    if((j2<I.getWidth()-1)&&(i2<I.getHeight()-1)&&(i2>0)&&(j2>0))
+    if(ptWarpedIn[point]&&(ptWarpedV[point]>0)&&(ptWarpedU[point]>0))
     {
       Tij=ptTemplate[point].val;
-      if(!blur)
-        IW=I.getValue(i2,j2);
-      else
-        IW=BI.getValue(i2,j2);
-      //IW=getSubPixBspline4(I,i2,j2);
+      IW=ptWarpedValue[point];
       moyTij+=Tij;
       moyIW+=IW;
       Nbpoint++;
@@ -100,21 +87,10 @@ double vpTemplateTrackerZNCC::getCost(const vpImage<unsigned char> &I, const vpC
   double var1=0,var2=0;
   for(unsigned int point=0;point<templateSize;point++)
   {
-    i=ptTemplate[point].y;
-    j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    Warp->computeDenom(X1,tp);
-    Warp->warpX(X1,X2,tp);
-
-    j2=X2[0];i2=X2[1];
-    if((j2<I.getWidth()-1)&&(i2<I.getHeight()-1)&&(i2>0)&&(j2>0))
+    if(ptWarpedIn[point]&&(ptWarpedV[point]>0)&&(ptWarpedU[point]>0))
     {
       Tij=ptTemplate[point].val;
-      if(!blur)
-        IW=I.getValue(i2,j2);
-      else
-        IW=BI.getValue(i2,j2);
-      //IW=getSubPixBspline4(I,i2,j2);
+      IW=ptWarpedValue[point];
       nom+=(Tij-moyTij)*(IW-moyIW);
       //denom+=(Tij-moyTij)*(Tij-moyTij)*(IW-moyIW)*(IW-moyIW);
       var1+=(IW-moyIW)*(IW-moyIW);
@@ -250,35 +250,21 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
   double Ic;
   double Iref;
   unsigned int iteration=0;
-  int i,j;
-  double i2,j2;
   initPosEvalRMS(p);
   do
   {
     unsigned int Nbpoint=0;
     //erreur=0;
     G=0;
-    Warp->computeCoeff(p);
+    warpTemplate(I,p);
     double moyIref=0;
     double moyIc=0;
     for(unsigned int point=0;point<templateSize;point++)
     {
-      i=ptTemplate[point].y;
-      j=ptTemplate[point].x;
-      X1[0]=j;X1[1]=i;
-
-      Warp->computeDenom(X1,p);
-      Warp->warpX(X1,X2,p);
-
-      j2=X2[0];i2=X2[1];
-      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+      if(ptWarpedIn[point])
       {
         Iref=ptTemplate[point].val;
-
-        if(!blur)
-          Ic=I.getValue(i2,j2);
-        else
-          Ic=BI.getValue(i2,j2);
+        Ic=ptWarpedValue[point];
 
         Nbpoint++;
         moyIref+=Iref;
@@ -299,23 +285,10 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
 
       for(unsigned int point=0;point<templateSize;point++)
       {
-        i=ptTemplate[point].y;
-        j=ptTemplate[point].x;
-        X1[0]=j;X1[1]=i;
-
-        Warp->computeDenom(X1,p);
-        Warp->warpX(X1,X2,p);
-
-        j2=X2[0];i2=X2[1];
-        if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+        if(ptWarpedIn[point])
         {
           Iref=ptTemplate[point].val;
-
-          if(!blur)
-            Ic=I.getValue(i2,j2);
-          else
-            Ic=BI.getValue(i2,j2);
-
+          Ic=ptWarpedValue[point];
 
           double prod=(Ic-moyIc);
           for(unsigned int it=0;it<nbParam;it++)
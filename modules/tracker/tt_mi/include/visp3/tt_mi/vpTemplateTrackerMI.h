@@ -45,6 +45,8 @@
 #include <visp3/tt/vpTemplateTrackerHeader.h>
 #include <visp3/core/vpImageFilter.h>
 
+#include <vector>
+
 /*!
   \class vpTemplateTrackerMI
   \ingroup group_tt_mi_tracker
@@ -111,7 +113,18 @@ protected:
   vpMatrix    covarianceMatrix;
   bool        computeCovariance;
 
+  //! If true, the joint histogram and its derivatives are accumulated in parallel
+  bool        useParallelAccumulation;
+  //! Bins (cr, ct) of the samples added by addSample()
+  std::vector<int>    samplesBin;
+  //! Residuals (er, et) followed by the nbParam derivatives of the samples added by addSample()
+  std::vector<double> samplesValue;
+  //! One histogram per range of samples when the accumulation is done in parallel
+  std::vector<double> accumulationBuffers;
+
 protected:
+  void    accumulateSamples(bool secondOrder);
+  double *addSample(int cr, double er, int ct, double et);
   void    computeGradient();
   void    computeHessien(vpMatrix &H);
   void    computeHessienNormalized(vpMatrix &H);
@@ -125,6 +138,12 @@ protected:
   virtual void    trackNoPyr(const vpImage<unsigned char> &I)=0;
   void    zeroProbabilities();
 
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  class vpSamplesTask;
+#endif
+  void    putSamples(unsigned int start, unsigned int end, double *prtTout, bool secondOrder);
+
 //private:
 //#ifndef DOXYGEN_SHOULD_SKIP_THIS
 //  vpTemplateTrackerMI(const vpTemplateTrackerMI &)
@@ -150,7 +169,8 @@ public:
       temp(NULL), Prt(NULL), dPrt(NULL), Pt(NULL), Pr(NULL), d2Prt(NULL), PrtTout(NULL),
       dprtemp(NULL), PrtD(NULL), dPrtD(NULL), influBspline(0), bspline(0), Nc(0), Ncb(0),
       d2Ix(), d2Iy(), d2Ixy(), MI_preEstimation(0), MI_postEstimation(0),
-      NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false)
+      NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false),
+      useParallelAccumulation(false), samplesBin(), samplesValue(), accumulationBuffers()
   {}
   vpTemplateTrackerMI(vpTemplateTrackerWarp *_warp);
   ~vpTemplateTrackerMI();
@@ -159,6 +179,10 @@ public:
   double getMI(const vpImage<unsigned char> &I,int &nc, const int &bspline,vpColVector &tp);
   double getMI256(const vpImage<unsigned char> &I, const vpColVector &tp);
   double getNMI() const {return NMI_postEstimation;}
+  /*!
+    Return true if the joint histogram is accumulated in parallel, see setUseParallelAccumulation().
+  */
+  bool   getUseParallelAccumulation() const {return useParallelAccumulation;}
   //initialisation du Hessien en position desiree
   void setApprocHessian(vpHessienApproximationType approx){ApproxHessian=approx;}
   void setCovarianceComputation(const bool & flag){ computeCovariance = flag; }
@@ -166,6 +190,17 @@ public:
   void setBspline(const vpBsplineType &newbs);
   void setLambda(double _l) {lambda = _l ; }
   void setNc(int newNc);
+  /*!
+    Set if the joint histogram and its derivatives are accumulated in parallel
+    with the threads of vpThreadPool. The template points are split in one range
+    per thread, each range being accumulated in its own histogram, and the
+    histograms are summed in the range order at the end. The result is thus the
+    same from a run to another for a given number of threads, but may differ from
+    the sequential accumulation by rounding errors.
+
+    \param use : True to accumulate in parallel, false (the default) otherwise.
+  */
+  void setUseParallelAccumulation(bool use) {useParallelAccumulation = use;}
 };
 
 #endif
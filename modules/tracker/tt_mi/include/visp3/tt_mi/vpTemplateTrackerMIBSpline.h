@@ -85,6 +85,12 @@ public:
   static void PutTotPVBspline3PrtTout(double *Prt, int &cr, double &er, int &ct, double &et,int &Nc, unsigned int &NbParam);
   static void PutTotPVBspline4PrtTout(double *Prt, int &cr, double &er, int &ct, double &et,int &Nc, unsigned int &NbParam);
 
+  // Template weights precomputed by computeBsplineTable(), Ncb layout, dPrt or d2Prt can be NULL
+  static void computeBsplineTable(double et, int degree, double *Bt, double *dBt, double *d2Bt);
+  static void PutTotPVBsplineTable(double *Prt, double *dPrt, double *d2Prt, int cr, double er, int ct, double et,
+                                   const double *Bt, const double *dBt, const double *d2Bt, int Ncb,
+                                   const double *val, unsigned int NbParam, int degree);
+
   static void PutTotPVBsplinePrt(double *Prt, int &cr, double &er, int &ct, double &et,int &Ncb, unsigned int &NbParam, int &degree);
   static void PutTotPVBspline3Prt(double *Prt, int &cr, double &er, int &ct, double &et,int &Ncb);
   static void PutTotPVBspline4Prt(double *Prt, int &cr, double &er, int &ct, double &et,int &Ncb);
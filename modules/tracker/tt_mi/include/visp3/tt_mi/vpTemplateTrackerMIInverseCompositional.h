@@ -80,6 +80,12 @@ private:
 
   //bool    useAYOptim;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  class vpWarpedTemplateTask;
+#endif
+  int   accumulateWarpedTemplate();
+  int   putWarpedTemplate(unsigned int start, unsigned int end, double *prt, double *dprt, double *d2prt);
+
 public: // AY Optimisation
   void initTemplateRefBspline(unsigned int ptIndex, double &et);
 
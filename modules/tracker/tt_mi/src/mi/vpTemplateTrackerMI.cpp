@@ -37,9 +37,37 @@
  *
  *****************************************************************************/
 #include <visp3/core/vpException.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/tt_mi/vpTemplateTrackerMI.h>
 #include <visp3/tt_mi/vpTemplateTrackerMIBSpline.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Accumulate the samples of a sub-range in the histogram of the sub-range, the
+  sub-range size being the grain size given to vpThreadPool::parallel_for().
+*/
+class vpTemplateTrackerMI::vpSamplesTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpSamplesTask(vpTemplateTrackerMI &tracker, double *buffers, unsigned int size, unsigned int step, bool secondOrder)
+    : m_tracker(tracker), m_buffers(buffers), m_size(size), m_step(step), m_secondOrder(secondOrder) {}
+
+  void run(unsigned int start, unsigned int end) {
+    m_tracker.putSamples(start, end, m_buffers + (start / m_step) * m_size, m_secondOrder);
+  }
+
+private:
+  vpTemplateTrackerMI &m_tracker;
+  double *m_buffers;
+  unsigned int m_size;
+  unsigned int m_step;
+  bool m_secondOrder;
+
+  vpSamplesTask(const vpSamplesTask &);
+  vpSamplesTask &operator=(const vpSamplesTask &);
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 void vpTemplateTrackerMI::setBspline(const vpBsplineType &newbs)
 {
   bspline=(int)newbs;
@@ -75,7 +103,8 @@ vpTemplateTrackerMI::vpTemplateTrackerMI(vpTemplateTrackerWarp *_warp)
     temp(NULL), Prt(NULL), dPrt(NULL), Pt(NULL), Pr(NULL), d2Prt(NULL), PrtTout(NULL),
     dprtemp(NULL), PrtD(NULL), dPrtD(NULL), influBspline(0), bspline(3), Nc(8), Ncb(0),
     d2Ix(), d2Iy(), d2Ixy(), MI_preEstimation(0), MI_postEstimation(0),
-    NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false)
+    NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false),
+    useParallelAccumulation(false), samplesBin(), samplesValue(), accumulationBuffers()
 {
   Ncb=Nc+bspline;
   influBspline=bspline*bspline;
@@ -145,28 +174,16 @@ double vpTemplateTrackerMI::getCost(const vpImage<unsigned char> &I, const vpCol
   memset(PrtD, 0, Nc_*Nc_*influBspline_*sizeof(double));
 
   //Warp->ComputeMAtWarp(tp);
-  Warp->computeCoeff(tp);
+  warpTemplate(I,tp);
   for(unsigned int point=0;point<templateSize;point++)
   {
-    int i=ptTemplate[point].y;
-    int j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-
-    Warp->computeDenom(X1,tp);
-    Warp->warpX(X1,X2,tp);
-    double j2=X2[0];
-    double i2=X2[1];
-
     //Tij=Templ[i-(int)Triangle->GetMiny()][j-(int)Triangle->GetMinx()];
-    if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+    if(ptWarpedIn[point])
     {
       Nbpoint++;
 
       double Tij=ptTemplate[point].val;
-      if(!blur)
-        IW=I.getValue(i2,j2);
-      else
-        IW=BI.getValue(i2,j2);
+      IW=ptWarpedValue[point];
 
       int cr=(int)((IW*(Nc-1))/255.);
       int ct=(int)((Tij*(Nc-1))/255.);
@@ -651,6 +668,8 @@ void vpTemplateTrackerMI::zeroProbabilities()
   memset(dPrt, 0, Ncb_*Ncb_*nbParam*sizeof(double));
   memset(d2Prt, 0, Ncb_*Ncb_*nbParam*nbParam*sizeof(double));
   memset(PrtTout, 0, Nc_*Nc_*influBspline_*(1+nbParam+nbParam*nbParam)*sizeof(double));
+  samplesBin.clear();
+  samplesValue.clear();
 
   //    std::cout << Ncb*Ncb << std::endl;
   //    std::cout << Ncb*Ncb*nbParam << std::endl;
@@ -658,6 +677,72 @@ void vpTemplateTrackerMI::zeroProbabilities()
   //    std::cout << Ncb*Ncb*influBspline*(1+nbParam+nbParam*nbParam) << std::endl;
 }
 
+/*
+  Add a sample of the joint histogram, the reference value falling in the bin
+  cr with the residual er and the current value in the bin ct with the residual
+  et. Return where the nbParam derivatives of the sample have to be written.
+  The samples are accumulated in PrtTout by accumulateSamples().
+*/
+double *vpTemplateTrackerMI::addSample(int cr, double er, int ct, double et)
+{
+  samplesBin.push_back(cr);
+  samplesBin.push_back(ct);
+  samplesValue.push_back(er);
+  samplesValue.push_back(et);
+  samplesValue.resize(samplesValue.size() + nbParam);
+  return &samplesValue[samplesValue.size() - nbParam];
+}
+
+/*
+  Accumulate the samples added by addSample() in PrtTout, with their second
+  order derivatives if secondOrder is true, and remove them. When the parallel
+  accumulation is enabled, each thread accumulates a range of samples in its
+  own histogram and the histograms are summed in the range order.
+*/
+void vpTemplateTrackerMI::accumulateSamples(bool secondOrder)
+{
+  unsigned int nbSamples = (unsigned int)samplesBin.size() / 2;
+  unsigned int nbThreads = useParallelAccumulation ? vpThreadPool::getNumThreads() : 1;
+
+  if (nbThreads < 2 || nbSamples < 2*nbThreads) {
+    putSamples(0, nbSamples, PrtTout, secondOrder);
+  }
+  else {
+    unsigned int size = (unsigned int)(Nc*Nc*influBspline)*(1+nbParam+nbParam*nbParam);
+    unsigned int step = (nbSamples + nbThreads - 1) / nbThreads;
+    unsigned int nbSteps = (nbSamples + step - 1) / step;
+
+    accumulationBuffers.assign(nbSteps * size, 0.);
+    vpSamplesTask task(*this, &accumulationBuffers[0], size, step, secondOrder);
+    vpThreadPool::parallel_for(0, nbSamples, task, step);
+
+    for (unsigned int cpt = 0; cpt < nbSteps; cpt++) {
+      const double *buffer = &accumulationBuffers[cpt * size];
+      for (unsigned int i = 0; i < size; i++)
+        PrtTout[i] += buffer[i];
+    }
+  }
+
+  samplesBin.clear();
+  samplesValue.clear();
+}
+
+void vpTemplateTrackerMI::putSamples(unsigned int start, unsigned int end, double *prtTout, bool secondOrder)
+{
+  unsigned int stride = 2 + nbParam;
+  for (unsigned int i = start; i < end; i++) {
+    int cr = samplesBin[2*i];
+    int ct = samplesBin[2*i+1];
+    double er = samplesValue[i*stride];
+    double et = samplesValue[i*stride+1];
+    double *val = &samplesValue[i*stride+2];
+    if (secondOrder)
+      vpTemplateTrackerMIBSpline::PutTotPVBspline(prtTout, cr, er, ct, et, Nc, val, nbParam, bspline);
+    else
+      vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(prtTout, cr, er, ct, et, Nc, val, nbParam, bspline);
+  }
+}
+
 double vpTemplateTrackerMI::getMI(const vpImage<unsigned char> &I,int &nc, const int &bspline_,vpColVector &tp)
 {
   unsigned int tNcb = (unsigned int)(nc+bspline_);
@@ -39,10 +39,6 @@
 
 #include <visp3/tt_mi/vpTemplateTrackerMIForwardAdditional.h>
 
-#ifdef VISP_HAVE_OPENMP
-#include <omp.h>
-#endif
-
 vpTemplateTrackerMIForwardAdditional::vpTemplateTrackerMIForwardAdditional(vpTemplateTrackerWarp *_warp)
   : vpTemplateTrackerMI(_warp), minimizationMethod(USE_NEWTON), evolRMS(0), x_pos(NULL), y_pos(NULL),
     threshold_RMS(0), p_prec(), G_prec(), KQuasiNewton()
@@ -108,18 +104,15 @@ void vpTemplateTrackerMIForwardAdditional::initHessienDesired(const vpImage<unsi
       //std::cout<<"test"<<std::endl;
       Warp->dWarp(X1,X2,p,dW);
 
-      double *tptemp=new double[nbParam];
-      for(unsigned int it=0;it<nbParam;it++)
-        tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
-
-      if(ApproxHessian==HESSIAN_NONSECOND)
-        vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-      else if(ApproxHessian==HESSIAN_0 || ApproxHessian==HESSIAN_NEW)
-        vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-      delete[] tptemp;
+      if(ApproxHessian==HESSIAN_NONSECOND || ApproxHessian==HESSIAN_0 || ApproxHessian==HESSIAN_NEW)
+      {
+        double *tptemp=addSample(cr, er, ct, et);
+        for(unsigned int it=0;it<nbParam;it++)
+          tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
+      }
     }
   }
+  accumulateSamples(ApproxHessian!=HESSIAN_NONSECOND);
 
   if(Nbpoint>0)
   {
@@ -179,12 +172,7 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
     zeroProbabilities();
 
     Warp->computeCoeff(p);
-#ifdef VISP_HAVE_OPENMP
-    int nthreads = omp_get_num_procs() ;
-    //std::cout << "file: " __FILE__ << " line: " << __LINE__ << " function: " << __FUNCTION__ << " nthread: " << nthreads << std::endl;
-    omp_set_num_threads(nthreads);
-#pragma omp parallel for default(shared)
-#endif
+    bool noSecond=(ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE);
     for(int point=0;point<(int)templateSize;point++)
     {
       int i=ptTemplate[point].y;
@@ -221,20 +209,15 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
         //Calcul de l'histogramme joint par interpolation bilinÃaire (Bspline ordre 1)
         Warp->dWarp(X1,X2,p,dW);
 
-        //double *tptemp=temp;
-        double *tptemp=new double[nbParam];;
-        for(unsigned int it=0;it<nbParam;it++)
-          tptemp[it] =(dW[0][it]*dx+dW[1][it]*dy);
-        //*tptemp++ =dW[0][it]*dIWx+dW[1][it]*dIWy;
-        //std::cout<<cr<<"   "<<ct<<"  ; ";
-        if(ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
-          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-        else if(ApproxHessian==HESSIAN_0 || ApproxHessian==HESSIAN_NEW)
-          vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-        delete[] tptemp;
+        if(noSecond || ApproxHessian==HESSIAN_0 || ApproxHessian==HESSIAN_NEW)
+        {
+          double *tptemp=addSample(cr, er, ct, et);
+          for(unsigned int it=0;it<nbParam;it++)
+            tptemp[it] =(dW[0][it]*dx+dW[1][it]*dy);
+        }
       }
     }
+    accumulateSamples(!noSecond);
 
     if(Nbpoint==0)
     {
@@ -131,18 +131,15 @@ void vpTemplateTrackerMIForwardCompositional::initHessienDesired(const vpImage<u
 
       Warp->dWarpCompo(X1,X2,p,ptTemplate[point].dW,dW);
 
-      double *tptemp=new double[nbParam];
+      double *tptemp=addSample(cr, er, ct, et);
       for(unsigned int it=0;it<nbParam;it++)
         tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
 
       //calcul de l'erreur
       //erreur+=(Tij-IW)*(Tij-IW);
-
-      vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc,tptemp, nbParam, bspline);
-
-      delete[] tptemp;
     }
   }
+  accumulateSamples(true);
   double MI;
   computeProba(Nbpoint);
   computeMI(MI);
@@ -188,6 +185,7 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
 
   int i,j;
   unsigned int iteration=0;
+  bool noSecond=(ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE);
   do
   {
     int Nbpoint=0;
@@ -227,23 +225,18 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
 
         Warp->dWarpCompo(X1,X2,p,ptTemplate[point].dW,dW);
 
-        double *tptemp=new double[nbParam];
-        for(unsigned int it=0;it<nbParam;it++)
-          tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
-
-
         //calcul de l'erreur
         //erreur+=(Tij-IW)*(Tij-IW);
 
-        if(ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
-          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-        else if(ApproxHessian==HESSIAN_0|| ApproxHessian==HESSIAN_NEW)
-          vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-        delete[] tptemp;
-
+        if(noSecond || ApproxHessian==HESSIAN_0 || ApproxHessian==HESSIAN_NEW)
+        {
+          double *tptemp=addSample(cr, er, ct, et);
+          for(unsigned int it=0;it<nbParam;it++)
+            tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
+        }
       }
     }
+    accumulateSamples(!noSecond);
     if(Nbpoint==0)
     {
       //std::cout<<"plus de point dans template suivi"<<std::endl;
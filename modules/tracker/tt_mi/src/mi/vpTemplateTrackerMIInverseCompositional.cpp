@@ -38,9 +38,43 @@
  *****************************************************************************/
 #include <visp3/tt_mi/vpTemplateTrackerMIInverseCompositional.h>
 #include <visp3/core/vpTrackingException.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <memory>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Accumulate the warped template points of a sub-range in the histograms of the
+  sub-range, the sub-range size being the grain size given to
+  vpThreadPool::parallel_for().
+*/
+class vpTemplateTrackerMIInverseCompositional::vpWarpedTemplateTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpWarpedTemplateTask(vpTemplateTrackerMIInverseCompositional &tracker, double *buffers, unsigned int size,
+                       unsigned int step, std::vector<int> &nbPoints)
+    : m_tracker(tracker), m_buffers(buffers), m_size(size), m_step(step), m_nbPoints(nbPoints) {}
+
+  void run(unsigned int start, unsigned int end) {
+    unsigned int Ncb2 = (unsigned int)(m_tracker.Ncb*m_tracker.Ncb);
+    double *prt = m_buffers + (start / m_step) * m_size;
+    double *dprt = prt + Ncb2;
+    double *d2prt = dprt + Ncb2*m_tracker.nbParam;
+    m_nbPoints[start / m_step] = m_tracker.putWarpedTemplate(start, end, prt, dprt, d2prt);
+  }
+
+private:
+  vpTemplateTrackerMIInverseCompositional &m_tracker;
+  double *m_buffers;
+  unsigned int m_size;
+  unsigned int m_step;
+  std::vector<int> &m_nbPoints;
+
+  vpWarpedTemplateTask(const vpWarpedTemplateTask &);
+  vpWarpedTemplateTask &operator=(const vpWarpedTemplateTask &);
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTrackerMIInverseCompositional::vpTemplateTrackerMIInverseCompositional(vpTemplateTrackerWarp *_warp)
   : vpTemplateTrackerMI(_warp), minimizationMethod(USE_LMA), CompoInitialised(false), useTemplateSelect(false),
     evolRMS(0), x_pos(NULL), y_pos(NULL), threshold_RMS(1e-20), p_prec(), G_prec(), KQuasiNewton() //, useAYOptim(false)
@@ -121,6 +155,11 @@ void vpTemplateTrackerMIInverseCompositional::initCompInverse(const vpImage<unsi
 
     ptTemplateSupp[point].et=et;
     ptTemplateSupp[point].ct=ct;
+    ptTemplateSupp[point].Bt=new double[4];
+    ptTemplateSupp[point].dBt=new double[4];
+    ptTemplateSupp[point].d2Bt=new double[4];
+    vpTemplateTrackerMIBSpline::computeBsplineTable(et, bspline, ptTemplateSupp[point].Bt,
+                                                    ptTemplateSupp[point].dBt, ptTemplateSupp[point].d2Bt);
 
     // ###### AY Optim
     //        if(useAYOptim)
@@ -234,6 +273,74 @@ void vpTemplateTrackerMIInverseCompositional::initHessienDesired(const vpImage<u
   KQuasiNewton=HLMdesireInverse;
 }
 
+/*
+  Accumulate the template points warped by warpTemplate() in Prt, dPrt and
+  d2Prt, and return the number of points that are inside the image. When the
+  parallel accumulation is enabled, each thread accumulates a range of points
+  in its own histograms and the histograms are summed in the range order.
+*/
+int vpTemplateTrackerMIInverseCompositional::accumulateWarpedTemplate()
+{
+  unsigned int nbThreads = useParallelAccumulation ? vpThreadPool::getNumThreads() : 1;
+  if (nbThreads < 2 || templateSize < 2*nbThreads)
+    return putWarpedTemplate(0, templateSize, Prt, dPrt, d2Prt);
+
+  unsigned int Ncb2 = (unsigned int)(Ncb*Ncb);
+  unsigned int size = Ncb2*(1+nbParam+nbParam*nbParam);
+  unsigned int step = (templateSize + nbThreads - 1) / nbThreads;
+  unsigned int nbSteps = (templateSize + step - 1) / step;
+
+  accumulationBuffers.assign(nbSteps * size, 0.);
+  std::vector<int> nbPoints(nbSteps, 0);
+  vpWarpedTemplateTask task(*this, &accumulationBuffers[0], size, step, nbPoints);
+  vpThreadPool::parallel_for(0, templateSize, task, step);
+
+  int nbpoint = 0;
+  for (unsigned int cpt = 0; cpt < nbSteps; cpt++) {
+    nbpoint += nbPoints[cpt];
+    const double *buffer = &accumulationBuffers[cpt * size];
+    for (unsigned int i = 0; i < Ncb2; i++)
+      Prt[i] += *buffer++;
+    for (unsigned int i = 0; i < Ncb2*nbParam; i++)
+      dPrt[i] += *buffer++;
+    for (unsigned int i = 0; i < Ncb2*nbParam*nbParam; i++)
+      d2Prt[i] += *buffer++;
+  }
+  return nbpoint;
+}
+
+/*
+  Accumulate the warped template points of index in [start, end) in prt, dprt
+  and d2prt, the template side B-spline weights being the ones precomputed by
+  initCompInverse(). Return the number of points that are inside the image.
+*/
+int vpTemplateTrackerMIInverseCompositional::putWarpedTemplate(unsigned int start, unsigned int end,
+                                                                double *prt, double *dprt, double *d2prt)
+{
+  bool noSecond = (ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE);
+  double Nc_1 = ((double)Nc)-1.f;
+  int nbpoint = 0;
+  for(unsigned int point=start;point<end;point++)
+  {
+    if(ptWarpedIn[point])
+    {
+      nbpoint++;
+      const vpTemplateTrackerPointSuppMIInv &supp = ptTemplateSupp[point];
+      double tmp = ptWarpedValue[point]*Nc_1/255.f;
+      int cr=(int)tmp;
+      double er=tmp-(double)cr;
+
+      if (ptTemplateSelect[point] || !useTemplateSelect)
+        vpTemplateTrackerMIBSpline::PutTotPVBsplineTable(prt, dprt, noSecond ? NULL : d2prt, cr, er, supp.ct, supp.et,
+                                                         supp.Bt, supp.dBt, supp.d2Bt, Ncb, ptTemplate[point].dW, nbParam, bspline);
+      else
+        vpTemplateTrackerMIBSpline::PutTotPVBsplineTable(prt, NULL, NULL, cr, er, supp.ct, supp.et,
+                                                         supp.Bt, supp.dBt, supp.d2Bt, Ncb, ptTemplate[point].dW, nbParam, bspline);
+    }
+  }
+  return nbpoint;
+}
+
 void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if(!CompoInitialised)
@@ -273,61 +380,9 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
 
     zeroProbabilities();
 
-    Warp->computeCoeff(p);
-
-    {
-      for(int point=0;point<(int)templateSize;point++)
-      {
-        vpColVector x1(2),x2(2);
-        double i2,j2;
-
-        x1[0]=(double)ptTemplate[point].x;
-        x1[1]=(double)ptTemplate[point].y;
-
-        Warp->computeDenom(x1,p); // A modif pour parallelisation mais ne pose pas de pb avec warp utilises dans DECSA
-        Warp->warpX(x1,x2,p);
+    warpTemplate(I,p);
 
-        j2=x2[0];
-        i2=x2[1];
-
-        if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
-        {
-          //if(m_ptCurrentMask == NULL ||(m_ptCurrentMask->getWidth() == I.getWidth() && m_ptCurrentMask->getHeight() == I.getHeight() && (*m_ptCurrentMask)[(unsigned int)i2][(unsigned int)j2] > 128))
-          {
-            Nbpoint++;
-            double IW;
-            if(!blur)
-              IW=(double)I.getValue(i2,j2);
-            else
-              IW=BI.getValue(i2,j2);
-
-            int ct=ptTemplateSupp[point].ct;
-            double et=ptTemplateSupp[point].et;
-            double tmp = IW*(((double)Nc)-1.f)/255.f;
-            int cr=(int)tmp;
-            double er=tmp-(double)cr;
-
-            if( (ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE) && (ptTemplateSelect[point] || !useTemplateSelect) )
-            {
-              vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(Prt, dPrt, cr, er, ct, et, Ncb, ptTemplate[point].dW, nbParam, bspline);
-            }
-            else if (ptTemplateSelect[point] || !useTemplateSelect)
-            {
-              if(bspline==3){
-                vpTemplateTrackerMIBSpline::PutTotPVBspline3(Prt, dPrt, d2Prt, cr, er, ct, et, Ncb, ptTemplate[point].dW, nbParam);
-              }
-              else{
-                vpTemplateTrackerMIBSpline::PutTotPVBspline4(Prt, dPrt, d2Prt, cr, er, ct, et, Ncb, ptTemplate[point].dW, nbParam);
-              }
-            }
-            else{
-              vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(Prt, cr, er, ct, et, Ncb,nbParam, bspline);
-            }
-          }
-
-        }
-      }
-    }
+    Nbpoint = accumulateWarpedTemplate();
 
     if(Nbpoint==0)
     {
@@ -411,12 +411,12 @@ void vpTemplateTrackerMIBSpline::PutTotPVBspline4(double *Prt, double *dPrt, dou
 
     for(int it=-1;it<=2;it++)
     {
-      Prt[ind+it] += Br * *ptBti;
-      int ind1 = ((cr+irInd)*Ncb+(ct+it))*NbParam_;
+      Prt[ind+it+1] += Br * *ptBti;
+      int ind1 = ((cr+irInd)*Ncb+(ct+it+1))*NbParam_;
       for(int ip=0;ip<NbParam_;ip++)
       {
         dPrt[ind1+ip]-= Br**ptdBti*val[ip];
-        int ind2 = ((cr+irInd)*Ncb+(ct+it))*NbParam_*NbParam_+ip*NbParam_;
+        int ind2 = ((cr+irInd)*Ncb+(ct+it+1))*NbParam_*NbParam_+ip*NbParam_;
         for(int ip2=0;ip2<NbParam_;ip2++)
           d2Prt[ind2+ip2] += Br**ptd2Bti*val[ip]*val[ip2];
       }
@@ -556,8 +556,8 @@ void vpTemplateTrackerMIBSpline::PutTotPVBspline3NoSecond(double *Prt, double *d
     ptdBti=&dBti[0];
     for(char it=-1;it<=1;it++)
     {
-      Prt[ind+(ct+st+it)] += Br**ptBti;
-      int ind1 = ((cr+sr+irInd)*Ncb+(ct+st+it))*NbParam_;
+      Prt[ind+(ct+st+it+1)] += Br**ptBti;
+      int ind1 = ((cr+sr+irInd)*Ncb+(ct+st+it+1))*NbParam_;
       for(short int ip=0;ip<NbParam_;ip++)
       {
         dPrt[ind1+ip]-= Br**ptdBti*val[ip];
@@ -694,6 +694,106 @@ void vpTemplateTrackerMIBSpline::PutTotPVBspline4PrtTout(double *PrtTout, int &c
   }
 }
 
+namespace {
+/*
+  Accumulate the products of the degree row weights Br and template weights in
+  the Ncb layout, up to the derivatives of the given order.
+*/
+template <int degree, int order>
+void accumulateTable(double *Prt, double *dPrt, double *d2Prt, int cr, int ct, const double *Br,
+                     const double *Bt, const double *dBt, const double *d2Bt, int Ncb,
+                     const double *val, int NbParam)
+{
+  for(int ir=0;ir<degree;ir++)
+  {
+    for(int it=0;it<degree;it++)
+    {
+      int ind = (cr+ir)*Ncb+ct+it;
+      Prt[ind] += Br[ir] * Bt[it];
+      if(order > 0)
+      {
+        double v1 = Br[ir] * dBt[it];
+        double *pdPrt = &dPrt[ind*NbParam];
+        for(int ip=0;ip<NbParam;ip++)
+        {
+          pdPrt[ip] -= v1*val[ip];
+          if(order > 1)
+          {
+            double v2 = Br[ir] * d2Bt[it] * val[ip];
+            double *pd2Prt = &d2Prt[(ind*NbParam+ip)*NbParam];
+            for(int ip2=0;ip2<NbParam;ip2++)
+              pd2Prt[ip2] += v2*val[ip2];
+          }
+        }
+      }
+    }
+  }
+}
+}
+
+/*
+  Fill the template side weights Bt, dBt and d2Bt (degree values each) of a
+  template value whose residual is et, as used by PutTotPVBsplineTable().
+*/
+void vpTemplateTrackerMIBSpline::computeBsplineTable(double et, int degree, double *Bt, double *dBt, double *d2Bt)
+{
+  if(degree==4)
+  {
+    for(int it=-1;it<=2;it++)
+    {
+      Bt[it+1] =vpTemplateTrackerBSpline::Bspline4(-it+et);
+      dBt[it+1] =dBspline4(-it+et);
+      d2Bt[it+1] =d2Bspline4(-it+et);
+    }
+  }
+  else
+  {
+    if(et>0.5){et=et-1;}
+    for(int it=-1;it<=1;it++)
+    {
+      Bt[it+1] =Bspline3(-it+et);
+      dBt[it+1] =dBspline3(-it+et);
+      d2Bt[it+1] =d2Bspline3(-it+et);
+    }
+  }
+}
+
+/*
+  Same as PutTotPVBspline(), PutTotPVBsplineNoSecond() and PutTotPVBsplinePrt()
+  with the Ncb layout, the template side weights being read from the tables
+  filled by computeBsplineTable(). The derivatives are not accumulated when
+  dPrt is NULL and the second order ones when d2Prt is NULL.
+*/
+void vpTemplateTrackerMIBSpline::PutTotPVBsplineTable(double *Prt, double *dPrt, double *d2Prt, int cr, double er, int ct, double et,
+                                                      const double *Bt, const double *dBt, const double *d2Bt, int Ncb,
+                                                      const double *val, unsigned int NbParam, int degree)
+{
+  double Br[4];
+  if(degree==4)
+  {
+    for(int ir=-1;ir<=2;ir++)
+      Br[ir+1]=vpTemplateTrackerBSpline::Bspline4(-ir+er);
+  }
+  else
+  {
+    if(er>0.5){cr++;er=er-1;}
+    if(et>0.5){ct++;}
+    for(int ir=-1;ir<=1;ir++)
+      Br[ir+1]=Bspline3(-ir+er);
+  }
+
+  int order = (dPrt == NULL) ? 0 : ((d2Prt == NULL) ? 1 : 2);
+  switch(degree*3+order)
+  {
+  case 12: accumulateTable<4,0>(Prt, dPrt, d2Prt, cr, ct, Br, Bt, dBt, d2Bt, Ncb, val, (int)NbParam); break;
+  case 13: accumulateTable<4,1>(Prt, dPrt, d2Prt, cr, ct, Br, Bt, dBt, d2Bt, Ncb, val, (int)NbParam); break;
+  case 14: accumulateTable<4,2>(Prt, dPrt, d2Prt, cr, ct, Br, Bt, dBt, d2Bt, Ncb, val, (int)NbParam); break;
+  case 9:  accumulateTable<3,0>(Prt, dPrt, d2Prt, cr, ct, Br, Bt, dBt, d2Bt, Ncb, val, (int)NbParam); break;
+  case 10: accumulateTable<3,1>(Prt, dPrt, d2Prt, cr, ct, Br, Bt, dBt, d2Bt, Ncb, val, (int)NbParam); break;
+  default: accumulateTable<3,2>(Prt, dPrt, d2Prt, cr, ct, Br, Bt, dBt, d2Bt, Ncb, val, (int)NbParam);
+  }
+}
+
 void vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(double *Prt, int &cr, double &er, int &ct, double &et,int &Ncb, unsigned int &NbParam, int &degree)
 {
   switch(degree)
@@ -0,0 +1,230 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the mutual information template trackers.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceTemplateTrackerMI.cpp
+
+  \brief Measure the tracking time of the inverse compositional, forward
+  compositional and forward additional mutual information template trackers on
+  a synthetic sequence, with the joint histogram accumulated sequentially or in
+  parallel (see vpTemplateTrackerMI::setUseParallelAccumulation()), and check
+  that both accumulations lead to the same homography.
+*/
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImagePoint.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomography.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIForwardAdditional.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIForwardCompositional.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIInverseCompositional.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Benchmark the mutual information template trackers.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Number of images of the synthetic sequence tracked\n\
+     by each tracker.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Smooth texture translated by (tu, tv)
+void texture(vpImage<unsigned char> &I, double tu, double tv)
+{
+  I.resize(240, 320);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double u = j - tu, v = i - tv;
+      double val = 128 + 60 * sin(u * 0.11) * cos(v * 0.07) + 40 * sin((u + v) * 0.05) + 20 * cos(u * 0.031 - v * 0.043);
+      I[i][j] = (unsigned char)std::max(0., std::min(255., val));
+    }
+  }
+}
+
+// Track the sequence with the joint histogram accumulated sequentially and in parallel
+template<class Tracker>
+bool benchmark(const std::string &name, const std::vector<vpImage<unsigned char> > &sequence)
+{
+  std::vector<vpImagePoint> v_ip;
+  v_ip.push_back(vpImagePoint(60, 80)); v_ip.push_back(vpImagePoint(60, 240)); v_ip.push_back(vpImagePoint(180, 240));
+  v_ip.push_back(vpImagePoint(60, 80)); v_ip.push_back(vpImagePoint(180, 240)); v_ip.push_back(vpImagePoint(180, 80));
+
+  vpTemplateTrackerWarpHomography warp, warp_parallel;
+  Tracker tracker(&warp), tracker_parallel(&warp_parallel);
+  Tracker *trackers[2] = { &tracker, &tracker_parallel };
+  for (unsigned int t = 0; t < 2; t++) {
+    trackers[t]->setSampling(2, 2);
+    trackers[t]->setIterationMax(30);
+    trackers[t]->initFromPoints(sequence[0], v_ip);
+  }
+  tracker_parallel.setUseParallelAccumulation(true);
+
+  double t_seq = 0., t_par = 0., max_error = 0.;
+  for (size_t k = 1; k < sequence.size(); k++) {
+    double t = vpTime::measureTimeMs();
+    tracker.track(sequence[k]);
+    t_seq += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    tracker_parallel.track(sequence[k]);
+    t_par += vpTime::measureTimeMs() - t;
+
+    max_error = std::max(max_error, (tracker.getp() - tracker_parallel.getp()).infinityNorm());
+  }
+
+  unsigned int nb_images = (unsigned int)sequence.size() - 1;
+  std::cout << name << ": sequential " << t_seq / nb_images << " ms, parallel " << t_par / nb_images
+            << " ms, speed-up " << (t_par > 0. ? t_seq / t_par : 0.) << ", max parameter difference "
+            << max_error << std::endl;
+
+  if (max_error > 1e-6) {
+    std::cerr << "The parallel accumulation leads to a different homography for " << name << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 5;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    // Use at least 2 threads to exercise the reduction of the per thread histograms
+    const unsigned int nb_threads = std::max(2u, vpThreadPool::getNumThreads());
+    vpThreadPool::setNumThreads(nb_threads);
+    std::cout << "Parallel accumulation with " << nb_threads << " threads" << std::endl;
+
+    // The texture moves by 0.5 pixel along u and -0.4 pixel along v between two images
+    std::vector<vpImage<unsigned char> > sequence(nb_iterations + 1);
+    for (unsigned int k = 0; k <= nb_iterations; k++)
+      texture(sequence[k], 0.5 * k, -0.4 * k);
+
+    if (! benchmark<vpTemplateTrackerMIInverseCompositional>("Inverse compositional", sequence))
+      return EXIT_FAILURE;
+    if (! benchmark<vpTemplateTrackerMIForwardCompositional>("Forward compositional", sequence))
+      return EXIT_FAILURE;
+    if (! benchmark<vpTemplateTrackerMIForwardAdditional>("Forward additional", sequence))
+      return EXIT_FAILURE;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -838,6 +838,16 @@ public:
     m_useMatchTrainToQuery = useMatchTrainToQuery;
   }
 
+  /*!
+    Set if the simulated views of the affine detection (see setUseAffineDetection()) must be processed in parallel
+    with vpThreadPool. The keypoints and descriptors are the same as with the sequential processing, in the same order.
+
+    \param useParallel : True to process the simulated views in parallel (the default), false otherwise
+  */
+  inline void setUseParallelAffineDetection(const bool useParallel) {
+    m_useParallelAffineDetection = useParallel;
+  }
+
   /*!
     Set the flag to choose between a percentage value of inliers for the cardinality of the consensus group
     or a minimum number.
@@ -968,17 +978,28 @@ private:
   //! because it reduces the number of possible false matches (by default it is the inverse because normally there are multiple
   //! train images of different views of the object)
   bool m_useMatchTrainToQuery;
+  //! If true, the simulated views of the affine detection are processed in parallel
+  bool m_useParallelAffineDetection;
   //! Flag set if a Ransac VVS pose estimation must be used.
   bool m_useRansacVVS;
   //! If true, keep only pairs of keypoints where each train keypoint is matched to a single query keypoint
   bool m_useSingleMatchFilter;
 
 
+  //! Processes the simulated views of detectExtractAffine() in parallel. Declared friend since nested
+  //! classes have no access to the private members of the enclosing class in C++98.
+  class vpAffineViewTask;
+  friend class vpAffineViewTask;
+
   void affineSkew(double tilt, double phi, cv::Mat& img, cv::Mat& mask, cv::Mat& Ai);
 
   double computePoseEstimationError(const std::vector<std::pair<cv::KeyPoint, cv::Point3f> > &matchKeyPoints,
                                     const vpCameraParameters &cam, const vpHomogeneousMatrix &cMo_est);
 
+  void detectExtractAffineView(const cv::Mat &img, const double tilt, const int phi,
+                               std::vector<cv::KeyPoint> &keypoints, cv::Mat &descriptors,
+                               vpImage<unsigned char> *affineI);
+
   void filterMatches();
 
   void init();
@@ -112,6 +112,8 @@ private:
   double ransacThreshold;
   double distanceToPlaneForCoplanarityTest;
   bool removeRansacDegeneratePoints;
+  //! If true, the RANSAC hypotheses are evaluated in parallel
+  bool ransacParallel;
 
 protected:
   double computeResidualDementhon(const vpHomogeneousMatrix &cMo) ;
@@ -178,6 +180,38 @@ public:
   unsigned int getRansacNbInliers() const { return (unsigned int) ransacInliers.size(); }
   std::vector<unsigned int> getRansacInlierIndex() const{ return ransacInlierIndex; }
   std::vector<vpPoint> getRansacInliers() const{ return ransacInliers; }
+
+  /*!
+    Get the flag that indicates if the RANSAC hypotheses are evaluated in parallel.
+
+    \return True if the parallel mode is used, false otherwise.
+
+    \sa setUseParallelRansac()
+  */
+  bool getUseParallelRansac() const {
+    return ransacParallel;
+  }
+
+  /*!
+    Set if the RANSAC hypotheses have to be evaluated in parallel with the
+    threads of vpThreadPool.
+
+    In this mode, each hypothesis draws its minimal sample set from its own
+    pseudo-random series, seeded with its trial number, and the inliers are
+    counted on a contiguous copy of the point coordinates. The hypotheses are
+    evaluated by batches and the number of trials is lowered according to the
+    ratio of outliers of the best consensus (see computeRansacIterations()).
+    The result is reproducible and does not depend on the number of threads,
+    but it differs from the one of the sequential mode.
+
+    \param parallel : True to evaluate the hypotheses in parallel, false otherwise (default).
+
+    \warning The pose check function passed to computePose() is then called
+    from several threads and must be thread safe.
+  */
+  void setUseParallelRansac(const bool parallel) {
+    ransacParallel = parallel;
+  }
   
   /*!
     Set if the covaraince matrix has to be computed in the Virtual Visual Servoing approach.
@@ -234,6 +268,8 @@ public:
     return vectorOfPoints;
   }
 
+  static int computeRansacIterations(double probability, double epsilon,
+                                     const int sampleSize=4, int maxIterations=2000);
   static void display(vpImage<unsigned char> &I, vpHomogeneousMatrix &cMo,
                       vpCameraParameters &cam, double size,
                       vpColor col=vpColor::none) ;
@@ -43,9 +43,87 @@
 
 #include <cmath>    // std::fabs
 #include <limits>   // numeric_limits
+#include <vector>
 
 #undef MAX
 #undef MIN
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Normal equations of the multi-image calibration. The rows of the
+// interaction matrix associated to the points of an image only depend on the
+// 6 parameters of the pose of this image and on the intrinsic parameters
+// shared by all the images. Only the blocks of each pose are stored, and the
+// intrinsic parameters are computed from the Schur complement of the pose
+// blocks, so that the memory and the cost are linear in the number of images
+// instead of the pseudo-inverse of the whole interaction matrix.
+class vpCalibrationNormalEquations
+{
+public:
+  vpCalibrationNormalEquations(unsigned int nbPose, unsigned int nbIntrinsic)
+    : m_U(nbPose), m_W(nbPose), m_g(nbPose), m_V(nbIntrinsic, nbIntrinsic, 0.), m_gc(nbIntrinsic, 0.)
+  {}
+
+  // Add the rows of the image p, Lo being the derivatives with respect to the
+  // pose and Lc with respect to the intrinsic parameters.
+  void addPose(unsigned int p, const vpMatrix &Lo, const vpMatrix &Lc, const vpColVector &error)
+  {
+    vpMatrix LoT = Lo.t();
+    vpMatrix LcT = Lc.t();
+    m_U[p] = LoT * Lo;
+    m_W[p] = LoT * Lc;
+    m_g[p] = LoT * error;
+    m_V += LcT * Lc;
+    m_gc += LcT * error;
+  }
+
+  // Least square solution e of L e = error, ordered as the columns of the
+  // interaction matrix: the 6 parameters of each pose, then the intrinsic
+  // parameters.
+  void solve(vpColVector &e) const
+  {
+    // Relative threshold on the singular values of the normal matrices. They
+    // are squared singular values, hence 1e-20 to mirror the former
+    // L.pseudoInverse(1e-10). It is not the same rank test: the pose blocks
+    // and the Schur complement do not have the singular values of L, so the
+    // rank decisions may differ on degenerate configurations. When all the
+    // blocks have full rank, both give the least squares solution.
+    const double svThreshold = 1e-20;
+    const unsigned int nbPose = (unsigned int)m_U.size();
+    const unsigned int nbIntrinsic = m_V.getRows();
+
+    std::vector<vpMatrix> Uinv(nbPose);
+    vpMatrix S = m_V;
+    vpColVector b = m_gc;
+    for (unsigned int p = 0; p < nbPose; p++) {
+      Uinv[p] = m_U[p].pseudoInverse(svThreshold);
+      vpMatrix WtUinv = m_W[p].t() * Uinv[p];
+      S -= WtUinv * m_W[p];
+      b -= WtUinv * m_g[p];
+    }
+
+    vpColVector ec = S.pseudoInverse(svThreshold) * b;
+
+    e.resize(6*nbPose + nbIntrinsic);
+    for (unsigned int p = 0; p < nbPose; p++) {
+      vpColVector ep = Uinv[p] * (m_g[p] - m_W[p] * ec);
+      for (unsigned int i = 0; i < 6; i++)
+        e[6*p + i] = ep[i];
+    }
+    for (unsigned int i = 0; i < nbIntrinsic; i++)
+      e[6*nbPose + i] = ec[i];
+  }
+
+private:
+  std::vector<vpMatrix> m_U;
+  std::vector<vpMatrix> m_W;
+  std::vector<vpColVector> m_g;
+  vpMatrix m_V;
+  vpColVector m_gc;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
  
 void
 vpCalibration::calibLagrange(vpCameraParameters &cam_est, vpHomogeneousMatrix &cMo_est)
@@ -373,9 +451,9 @@ vpCalibration::calibVVSMulti(std::vector<vpCalibration> &table_cal,
 {
   std::ios::fmtflags original_flags( std::cout.flags() );
   std::cout.precision(10);
-  unsigned int nbPoint[256]; //number of points by image
-  unsigned int nbPointTotal = 0; //total number of points
   unsigned int nbPose = (unsigned int)table_cal.size();
+  std::vector<unsigned int> nbPoint(nbPose); //number of points by image
+  unsigned int nbPointTotal = 0; //total number of points
   unsigned int nbPose6 = 6*nbPose;
 
   for (unsigned int i=0; i<nbPose ; i++)
@@ -474,15 +552,18 @@ vpCalibration::calibVVSMulti(std::vector<vpCalibration> &table_cal,
     error = P-Pd ;
     //r = r/nbPointTotal ;
 
-    vpMatrix L(nbPointTotal*2,nbPose6+4) ;
+    vpCalibrationNormalEquations normalEquations(nbPose, 4) ;
     curPoint = 0 ; //current point indice
     for (unsigned int p=0; p<nbPose ; p++)
     {
-      unsigned int q = 6*p;   
+      vpMatrix Lo(2*nbPoint[p], 6), Lc(2*nbPoint[p], 4) ;
+      vpColVector errorPose(2*nbPoint[p]) ;
       for (unsigned int i=0 ; i < nbPoint[p]; i++)
       {
         unsigned int curPoint2 = 2*curPoint;
         unsigned int curPoint21 = curPoint2 + 1;
+        unsigned int row2 = 2*i;
+        unsigned int row21 = row2 + 1;
 
         double x = cX[curPoint] ;
         double y = cY[curPoint] ;
@@ -496,43 +577,43 @@ vpCalibration::calibVVSMulti(std::vector<vpCalibration> &table_cal,
         //---------------
         {
           {
-            L[curPoint2][q] =  px * (-inv_z) ;
-            L[curPoint2][q+1] =  0 ;
-            L[curPoint2][q+2] =  px*(X*inv_z) ;
-            L[curPoint2][q+3] =  px*X*Y ;
-            L[curPoint2][q+4] =  -px*(1+X*X) ;
-            L[curPoint2][q+5] =  px*Y ;
+            Lo[row2][0] =  px * (-inv_z) ;
+            Lo[row2][1] =  0 ;
+            Lo[row2][2] =  px*(X*inv_z) ;
+            Lo[row2][3] =  px*X*Y ;
+            Lo[row2][4] =  -px*(1+X*X) ;
+            Lo[row2][5] =  px*Y ;
           }
           {
-            L[curPoint2][nbPose6]= 1 ;
-            L[curPoint2][nbPose6+1]= 0 ;
-            L[curPoint2][nbPose6+2]= X ;
-            L[curPoint2][nbPose6+3]= 0;
+            Lc[row2][0]= 1 ;
+            Lc[row2][1]= 0 ;
+            Lc[row2][2]= X ;
+            Lc[row2][3]= 0;
           }
           {
-            L[curPoint21][q] = 0 ;
-            L[curPoint21][q+1] = py*(-inv_z) ;
-            L[curPoint21][q+2] = py*(Y*inv_z) ;
-            L[curPoint21][q+3] = py* (1+Y*Y) ;
-            L[curPoint21][q+4] = -py*X*Y ;
-            L[curPoint21][q+5] = -py*X ;
+            Lo[row21][0] = 0 ;
+            Lo[row21][1] = py*(-inv_z) ;
+            Lo[row21][2] = py*(Y*inv_z) ;
+            Lo[row21][3] = py* (1+Y*Y) ;
+            Lo[row21][4] = -py*X*Y ;
+            Lo[row21][5] = -py*X ;
           }
           {
-            L[curPoint21][nbPose6]= 0 ;
-            L[curPoint21][nbPose6+1]= 1 ;
-            L[curPoint21][nbPose6+2]= 0;
-            L[curPoint21][nbPose6+3]= Y ;
+            Lc[row21][0]= 0 ;
+            Lc[row21][1]= 1 ;
+            Lc[row21][2]= 0;
+            Lc[row21][3]= Y ;
           }
 
         }
+        errorPose[row2] = error[curPoint2] ;
+        errorPose[row21] = error[curPoint21] ;
         curPoint++;
       }    // end interaction
+      normalEquations.addPose(p, Lo, Lc, errorPose) ;
     }
-    vpMatrix Lp ;
-    Lp = L.pseudoInverse(1e-10) ;
-
     vpColVector e ;
-    e = Lp*error ;
+    normalEquations.solve(e) ;
 
     vpColVector Tc, Tc_v(nbPose6) ;
     Tc = -e*gain ;
@@ -833,9 +914,9 @@ vpCalibration::calibVVSWithDistortionMulti(std::vector<vpCalibration> &table_cal
 {
   std::ios::fmtflags original_flags( std::cout.flags() );
   std::cout.precision(10);
-  unsigned int nbPoint[1024]; //number of points by image
-  unsigned int nbPointTotal = 0; //total number of points
   unsigned int nbPose = (unsigned int)table_cal.size();
+  std::vector<unsigned int> nbPoint(nbPose); //number of points by image
+  unsigned int nbPointTotal = 0; //total number of points
   unsigned int nbPose6 = 6*nbPose;
   for (unsigned int i=0; i<nbPose ; i++)
   {
@@ -914,7 +995,7 @@ vpCalibration::calibVVSWithDistortionMulti(std::vector<vpCalibration> &table_cal
     }
 
 
-    vpMatrix L(nbPointTotal*4,nbPose6+6) ;
+    vpCalibrationNormalEquations normalEquations(nbPose, 6) ;
     curPoint = 0 ; //current point indice
     double px = cam_est.get_px() ;
     double py = cam_est.get_py() ;
@@ -932,7 +1013,8 @@ vpCalibration::calibVVSWithDistortionMulti(std::vector<vpCalibration> &table_cal
     
     for (unsigned int p=0; p<nbPose ; p++)
     {
-      unsigned int q = 6*p;   
+      vpMatrix Lo(4*nbPoint[p], 6), Lc(4*nbPoint[p], 6) ;
+      vpColVector errorPose(4*nbPoint[p]) ;
       for (unsigned int i=0 ; i < nbPoint[p]; i++)
       {
         unsigned int curPoint4 = 4*curPoint;
@@ -988,91 +1070,87 @@ vpCalibration::calibVVSWithDistortionMulti(std::vector<vpCalibration> &table_cal
              vpMath::sqr(P[curPoint4+2]-Pd[curPoint4+2]) +
              vpMath::sqr(P[curPoint4+3]-Pd[curPoint4+3]))*0.5 ;
 
-        unsigned int curInd = curPoint4;
+        unsigned int row = 4*i;
         //---------------
         {
           {
-            L[curInd][q] =  px * (-inv_z) ;
-            L[curInd][q+1] =  0 ;
-            L[curInd][q+2] =  px*X*inv_z ;
-            L[curInd][q+3] =  px*X*Y ;
-            L[curInd][q+4] =  -px*(1+X2) ;
-            L[curInd][q+5] =  px*Y ;
+            Lo[row][0] =  px * (-inv_z) ;
+            Lo[row][1] =  0 ;
+            Lo[row][2] =  px*X*inv_z ;
+            Lo[row][3] =  px*X*Y ;
+            Lo[row][4] =  -px*(1+X2) ;
+            Lo[row][5] =  px*Y ;
           }
           {
-            L[curInd][nbPose6]= 1 + kr2du + k2du*xp02  ;
-            L[curInd][nbPose6+1]= k2du*up0*yp0*inv_py ;
-            L[curInd][nbPose6+2]= X + k2du*xp02*xp0 ;
-            L[curInd][nbPose6+3]= k2du*up0*yp02*inv_py ;
-            L[curInd][nbPose6+4] = -(up0)*(r2du) ;
-            L[curInd][nbPose6+5] = 0 ;
+            Lc[row][0]= 1 + kr2du + k2du*xp02  ;
+            Lc[row][1]= k2du*up0*yp0*inv_py ;
+            Lc[row][2]= X + k2du*xp02*xp0 ;
+            Lc[row][3]= k2du*up0*yp02*inv_py ;
+            Lc[row][4] = -(up0)*(r2du) ;
+            Lc[row][5] = 0 ;
           }
-            curInd++;     
+            row++;
           {
-            L[curInd][q] = 0 ;
-            L[curInd][q+1] = py*(-inv_z) ;
-            L[curInd][q+2] = py*Y*inv_z ;
-            L[curInd][q+3] = py* (1+Y2) ;
-            L[curInd][q+4] = -py*XY ;
-            L[curInd][q+5] = -py*X ;
+            Lo[row][0] = 0 ;
+            Lo[row][1] = py*(-inv_z) ;
+            Lo[row][2] = py*Y*inv_z ;
+            Lo[row][3] = py* (1+Y2) ;
+            Lo[row][4] = -py*XY ;
+            Lo[row][5] = -py*X ;
           }
           {
-            L[curInd][nbPose6]= k2du*xp0*vp0*inv_px ;
-            L[curInd][nbPose6+1]= 1 + kr2du + k2du*yp02;
-            L[curInd][nbPose6+2]= k2du*vp0*xp02*inv_px;
-            L[curInd][nbPose6+3]= Y + k2du*yp02*yp0;
-            L[curInd][nbPose6+4] = -vp0*r2du ;
-            L[curInd][nbPose6+5] = 0 ;
+            Lc[row][0]= k2du*xp0*vp0*inv_px ;
+            Lc[row][1]= 1 + kr2du + k2du*yp02;
+            Lc[row][2]= k2du*vp0*xp02*inv_px;
+            Lc[row][3]= Y + k2du*yp02*yp0;
+            Lc[row][4] = -vp0*r2du ;
+            Lc[row][5] = 0 ;
           }
-            curInd++;
+            row++;
   //---undistorted to distorted
           {
-            L[curInd][q] = Axx*(-inv_z) ;
-            L[curInd][q+1] = Axy*(-inv_z) ;
-            L[curInd][q+2] = Axx*(X*inv_z) + Axy*(Y*inv_z) ;
-            L[curInd][q+3] = Axx*X*Y +  Axy*(1+Y2);
-            L[curInd][q+4] = -Axx*(1+X2) - Axy*XY;
-            L[curInd][q+5] = Axx*Y -Axy*X;
+            Lo[row][0] = Axx*(-inv_z) ;
+            Lo[row][1] = Axy*(-inv_z) ;
+            Lo[row][2] = Axx*(X*inv_z) + Axy*(Y*inv_z) ;
+            Lo[row][3] = Axx*X*Y +  Axy*(1+Y2);
+            Lo[row][4] = -Axx*(1+X2) - Axy*XY;
+            Lo[row][5] = Axx*Y -Axy*X;
           }
           {
-            L[curInd][nbPose6]= 1 ;
-            L[curInd][nbPose6+1]= 0 ;
-            L[curInd][nbPose6+2]= X*kr2ud ;
-            L[curInd][nbPose6+3]= 0;
-            L[curInd][nbPose6+4] = 0 ;
-            L[curInd][nbPose6+5] = px*X*r2ud ;
+            Lc[row][0]= 1 ;
+            Lc[row][1]= 0 ;
+            Lc[row][2]= X*kr2ud ;
+            Lc[row][3]= 0;
+            Lc[row][4] = 0 ;
+            Lc[row][5] = px*X*r2ud ;
           }
-            curInd++;   
+            row++;
           {
-            L[curInd][q] = Ayx*(-inv_z) ;
-            L[curInd][q+1] = Ayy*(-inv_z) ;
-            L[curInd][q+2] = Ayx*(X*inv_z) + Ayy*(Y*inv_z) ;
-            L[curInd][q+3] = Ayx*XY + Ayy*(1+Y2) ;
-            L[curInd][q+4] = -Ayx*(1+X2) -Ayy*XY ;
-            L[curInd][q+5] = Ayx*Y -Ayy*X;
+            Lo[row][0] = Ayx*(-inv_z) ;
+            Lo[row][1] = Ayy*(-inv_z) ;
+            Lo[row][2] = Ayx*(X*inv_z) + Ayy*(Y*inv_z) ;
+            Lo[row][3] = Ayx*XY + Ayy*(1+Y2) ;
+            Lo[row][4] = -Ayx*(1+X2) -Ayy*XY ;
+            Lo[row][5] = Ayx*Y -Ayy*X;
           }
           {
-            L[curInd][nbPose6]= 0 ;
-            L[curInd][nbPose6+1]= 1;
-            L[curInd][nbPose6+2]= 0;
-            L[curInd][nbPose6+3]= Y*kr2ud ;
-            L[curInd][nbPose6+4] = 0 ;
-            L[curInd][nbPose6+5] = py*Y*r2ud ;
+            Lc[row][0]= 0 ;
+            Lc[row][1]= 1;
+            Lc[row][2]= 0;
+            Lc[row][3]= Y*kr2ud ;
+            Lc[row][4] = 0 ;
+            Lc[row][5] = py*Y*r2ud ;
           }
         }  // end interaction
+        for (unsigned int k = 0 ; k < 4 ; k++)
+          errorPose[4*i+k] = P[curPoint4+k]-Pd[curPoint4+k] ;
         curPoint++;
       }    // end interaction
+      normalEquations.addPose(p, Lo, Lc, errorPose) ;
     }
 
-    vpColVector error ;
-    error = P-Pd ;
-    //r = r/nbPointTotal ;
-
-    vpMatrix Lp ;
-    /*double rank =*/
-    L.pseudoInverse(Lp,1e-10) ;
     vpColVector e ;
-    e = Lp*error ;
+    normalEquations.solve(e) ;
     vpColVector Tc, Tc_v(6*nbPose) ;
     Tc = -e*gain ;
     for (unsigned int i = 0 ; i < 6*nbPose ; i++)
@@ -1333,7 +1411,7 @@ vpCalibration::calibVVSMulti(unsigned int nbPose,
 {
   std::ios::fmtflags original_flags( std::cout.flags() );
   std::cout.precision(10);
-  unsigned int nbPoint[256]; //number of points by image
+  std::vector<unsigned int> nbPoint(nbPose); //number of points by image
   unsigned int nbPointTotal = 0; //total number of points
 
   unsigned int nbPose6 = 6*nbPose;
@@ -1435,15 +1513,18 @@ vpCalibration::calibVVSMulti(unsigned int nbPose,
     error = P-Pd ;
     //r = r/nbPointTotal ;
 
-    vpMatrix L(nbPointTotal*2,nbPose6+4) ;
+    vpCalibrationNormalEquations normalEquations(nbPose, 4) ;
     curPoint = 0 ; //current point indice
     for (unsigned int p=0; p<nbPose ; p++)
     {
-      unsigned int q = 6*p;
+      vpMatrix Lo(2*nbPoint[p], 6), Lc(2*nbPoint[p], 4) ;
+      vpColVector errorPose(2*nbPoint[p]) ;
       for (unsigned int i=0 ; i < nbPoint[p]; i++)
       {
         unsigned int curPoint2 = 2*curPoint;
         unsigned int curPoint21 = curPoint2 + 1;
+        unsigned int row2 = 2*i;
+        unsigned int row21 = row2 + 1;
 
         double x = cX[curPoint] ;
         double y = cY[curPoint] ;
@@ -1457,43 +1538,43 @@ vpCalibration::calibVVSMulti(unsigned int nbPose,
         //---------------
         {
           {
-            L[curPoint2][q] =  px * (-inv_z) ;
-            L[curPoint2][q+1] =  0 ;
-            L[curPoint2][q+2] =  px*(X*inv_z) ;
-            L[curPoint2][q+3] =  px*X*Y ;
-            L[curPoint2][q+4] =  -px*(1+X*X) ;
-            L[curPoint2][q+5] =  px*Y ;
+            Lo[row2][0] =  px * (-inv_z) ;
+            Lo[row2][1] =  0 ;
+            Lo[row2][2] =  px*(X*inv_z) ;
+            Lo[row2][3] =  px*X*Y ;
+            Lo[row2][4] =  -px*(1+X*X) ;
+            Lo[row2][5] =  px*Y ;
           }
           {
-            L[curPoint2][nbPose6]= 1 ;
-            L[curPoint2][nbPose6+1]= 0 ;
-            L[curPoint2][nbPose6+2]= X ;
-            L[curPoint2][nbPose6+3]= 0;
+            Lc[row2][0]= 1 ;
+            Lc[row2][1]= 0 ;
+            Lc[row2][2]= X ;
+            Lc[row2][3]= 0;
           }
           {
-            L[curPoint21][q] = 0 ;
-            L[curPoint21][q+1] = py*(-inv_z) ;
-            L[curPoint21][q+2] = py*(Y*inv_z) ;
-            L[curPoint21][q+3] = py* (1+Y*Y) ;
-            L[curPoint21][q+4] = -py*X*Y ;
-            L[curPoint21][q+5] = -py*X ;
+            Lo[row21][0] = 0 ;
+            Lo[row21][1] = py*(-inv_z) ;
+            Lo[row21][2] = py*(Y*inv_z) ;
+            Lo[row21][3] = py* (1+Y*Y) ;
+            Lo[row21][4] = -py*X*Y ;
+            Lo[row21][5] = -py*X ;
           }
           {
-            L[curPoint21][nbPose6]= 0 ;
-            L[curPoint21][nbPose6+1]= 1 ;
-            L[curPoint21][nbPose6+2]= 0;
-            L[curPoint21][nbPose6+3]= Y ;
+            Lc[row21][0]= 0 ;
+            Lc[row21][1]= 1 ;
+            Lc[row21][2]= 0;
+            Lc[row21][3]= Y ;
           }
 
         }
+        errorPose[row2] = error[curPoint2] ;
+        errorPose[row21] = error[curPoint21] ;
         curPoint++;
       }    // end interaction
+      normalEquations.addPose(p, Lo, Lc, errorPose) ;
     }
-    vpMatrix Lp ;
-    Lp = L.pseudoInverse(1e-10) ;
-
     vpColVector e ;
-    e = Lp*error ;
+    normalEquations.solve(e) ;
 
     vpColVector Tc, Tc_v(nbPose6) ;
     Tc = -e*gain ;
@@ -1553,7 +1634,7 @@ vpCalibration::calibVVSWithDistortionMulti(
 {
   std::ios::fmtflags original_flags( std::cout.flags() );
   std::cout.precision(10);
-  unsigned int nbPoint[1024]; //number of points by image
+  std::vector<unsigned int> nbPoint(nbPose); //number of points by image
   unsigned int nbPointTotal = 0; //total number of points
 
   unsigned int nbPose6 = 6*nbPose;
@@ -1634,7 +1715,7 @@ vpCalibration::calibVVSWithDistortionMulti(
     }
 
 
-    vpMatrix L(nbPointTotal*4,nbPose6+6) ;
+    vpCalibrationNormalEquations normalEquations(nbPose, 6) ;
     curPoint = 0 ; //current point indice
     double px = cam_est.get_px() ;
     double py = cam_est.get_py() ;
@@ -1652,7 +1733,8 @@ vpCalibration::calibVVSWithDistortionMulti(
 
     for (unsigned int p=0; p<nbPose ; p++)
     {
-      unsigned int q = 6*p;
+      vpMatrix Lo(4*nbPoint[p], 6), Lc(4*nbPoint[p], 6) ;
+      vpColVector errorPose(4*nbPoint[p]) ;
       for (unsigned int i=0 ; i < nbPoint[p]; i++)
       {
         unsigned int curPoint4 = 4*curPoint;
@@ -1708,91 +1790,87 @@ vpCalibration::calibVVSWithDistortionMulti(
              vpMath::sqr(P[curPoint4+2]-Pd[curPoint4+2]) +
              vpMath::sqr(P[curPoint4+3]-Pd[curPoint4+3]))*0.5 ;
 
-        unsigned int curInd = curPoint4;
+        unsigned int row = 4*i;
         //---------------
         {
           {
-            L[curInd][q] =  px * (-inv_z) ;
-            L[curInd][q+1] =  0 ;
-            L[curInd][q+2] =  px*X*inv_z ;
-            L[curInd][q+3] =  px*X*Y ;
-            L[curInd][q+4] =  -px*(1+X2) ;
-            L[curInd][q+5] =  px*Y ;
+            Lo[row][0] =  px * (-inv_z) ;
+            Lo[row][1] =  0 ;
+            Lo[row][2] =  px*X*inv_z ;
+            Lo[row][3] =  px*X*Y ;
+            Lo[row][4] =  -px*(1+X2) ;
+            Lo[row][5] =  px*Y ;
           }
           {
-            L[curInd][nbPose6]= 1 + kr2du + k2du*xp02  ;
-            L[curInd][nbPose6+1]= k2du*up0*yp0*inv_py ;
-            L[curInd][nbPose6+2]= X + k2du*xp02*xp0 ;
-            L[curInd][nbPose6+3]= k2du*up0*yp02*inv_py ;
-            L[curInd][nbPose6+4] = -(up0)*(r2du) ;
-            L[curInd][nbPose6+5] = 0 ;
+            Lc[row][0]= 1 + kr2du + k2du*xp02  ;
+            Lc[row][1]= k2du*up0*yp0*inv_py ;
+            Lc[row][2]= X + k2du*xp02*xp0 ;
+            Lc[row][3]= k2du*up0*yp02*inv_py ;
+            Lc[row][4] = -(up0)*(r2du) ;
+            Lc[row][5] = 0 ;
           }
-            curInd++;
+            row++;
           {
-            L[curInd][q] = 0 ;
-            L[curInd][q+1] = py*(-inv_z) ;
-            L[curInd][q+2] = py*Y*inv_z ;
-            L[curInd][q+3] = py* (1+Y2) ;
-            L[curInd][q+4] = -py*XY ;
-            L[curInd][q+5] = -py*X ;
+            Lo[row][0] = 0 ;
+            Lo[row][1] = py*(-inv_z) ;
+            Lo[row][2] = py*Y*inv_z ;
+            Lo[row][3] = py* (1+Y2) ;
+            Lo[row][4] = -py*XY ;
+            Lo[row][5] = -py*X ;
           }
           {
-            L[curInd][nbPose6]= k2du*xp0*vp0*inv_px ;
-            L[curInd][nbPose6+1]= 1 + kr2du + k2du*yp02;
-            L[curInd][nbPose6+2]= k2du*vp0*xp02*inv_px;
-            L[curInd][nbPose6+3]= Y + k2du*yp02*yp0;
-            L[curInd][nbPose6+4] = -vp0*r2du ;
-            L[curInd][nbPose6+5] = 0 ;
+            Lc[row][0]= k2du*xp0*vp0*inv_px ;
+            Lc[row][1]= 1 + kr2du + k2du*yp02;
+            Lc[row][2]= k2du*vp0*xp02*inv_px;
+            Lc[row][3]= Y + k2du*yp02*yp0;
+            Lc[row][4] = -vp0*r2du ;
+            Lc[row][5] = 0 ;
           }
-            curInd++;
+            row++;
   //---undistorted to distorted
           {
-            L[curInd][q] = Axx*(-inv_z) ;
-            L[curInd][q+1] = Axy*(-inv_z) ;
-            L[curInd][q+2] = Axx*(X*inv_z) + Axy*(Y*inv_z) ;
-            L[curInd][q+3] = Axx*X*Y +  Axy*(1+Y2);
-            L[curInd][q+4] = -Axx*(1+X2) - Axy*XY;
-            L[curInd][q+5] = Axx*Y -Axy*X;
+            Lo[row][0] = Axx*(-inv_z) ;
+            Lo[row][1] = Axy*(-inv_z) ;
+            Lo[row][2] = Axx*(X*inv_z) + Axy*(Y*inv_z) ;
+            Lo[row][3] = Axx*X*Y +  Axy*(1+Y2);
+            Lo[row][4] = -Axx*(1+X2) - Axy*XY;
+            Lo[row][5] = Axx*Y -Axy*X;
           }
           {
-            L[curInd][nbPose6]= 1 ;
-            L[curInd][nbPose6+1]= 0 ;
-            L[curInd][nbPose6+2]= X*kr2ud ;
-            L[curInd][nbPose6+3]= 0;
-            L[curInd][nbPose6+4] = 0 ;
-            L[curInd][nbPose6+5] = px*X*r2ud ;
+            Lc[row][0]= 1 ;
+            Lc[row][1]= 0 ;
+            Lc[row][2]= X*kr2ud ;
+            Lc[row][3]= 0;
+            Lc[row][4] = 0 ;
+            Lc[row][5] = px*X*r2ud ;
           }
-            curInd++;
+            row++;
           {
-            L[curInd][q] = Ayx*(-inv_z) ;
-            L[curInd][q+1] = Ayy*(-inv_z) ;
-            L[curInd][q+2] = Ayx*(X*inv_z) + Ayy*(Y*inv_z) ;
-            L[curInd][q+3] = Ayx*XY + Ayy*(1+Y2) ;
-            L[curInd][q+4] = -Ayx*(1+X2) -Ayy*XY ;
-            L[curInd][q+5] = Ayx*Y -Ayy*X;
+            Lo[row][0] = Ayx*(-inv_z) ;
+            Lo[row][1] = Ayy*(-inv_z) ;
+            Lo[row][2] = Ayx*(X*inv_z) + Ayy*(Y*inv_z) ;
+            Lo[row][3] = Ayx*XY + Ayy*(1+Y2) ;
+            Lo[row][4] = -Ayx*(1+X2) -Ayy*XY ;
+            Lo[row][5] = Ayx*Y -Ayy*X;
           }
           {
-            L[curInd][nbPose6]= 0 ;
-            L[curInd][nbPose6+1]= 1;
-            L[curInd][nbPose6+2]= 0;
-            L[curInd][nbPose6+3]= Y*kr2ud ;
-            L[curInd][nbPose6+4] = 0 ;
-            L[curInd][nbPose6+5] = py*Y*r2ud ;
+            Lc[row][0]= 0 ;
+            Lc[row][1]= 1;
+            Lc[row][2]= 0;
+            Lc[row][3]= Y*kr2ud ;
+            Lc[row][4] = 0 ;
+            Lc[row][5] = py*Y*r2ud ;
           }
         }  // end interaction
+        for (unsigned int k = 0 ; k < 4 ; k++)
+          errorPose[4*i+k] = P[curPoint4+k]-Pd[curPoint4+k] ;
         curPoint++;
       }    // end interaction
+      normalEquations.addPose(p, Lo, Lc, errorPose) ;
     }
 
-    vpColVector error ;
-    error = P-Pd ;
-    //r = r/nbPointTotal ;
-
-    vpMatrix Lp ;
-    /*double rank =*/
-    L.pseudoInverse(Lp,1e-10) ;
     vpColVector e ;
-    e = Lp*error ;
+    normalEquations.solve(e) ;
     vpColVector Tc, Tc_v(6*nbPose) ;
     Tc = -e*gain ;
     for (unsigned int i = 0 ; i < 6*nbPose ; i++)
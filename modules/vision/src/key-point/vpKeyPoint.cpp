@@ -41,6 +41,7 @@
 
 #include <visp3/vision/vpKeyPoint.h>
 #include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpThreadPool.h>
 
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020101)
 
@@ -344,7 +345,8 @@ vpKeyPoint::vpKeyPoint(const std::string &detectorName, const std::string &extra
     m_useBruteForceCrossCheck(true),
     #endif
     m_useConsensusPercentage(false),
-    m_useKnn(false), m_useMatchTrainToQuery(false), m_useRansacVVS(true), m_useSingleMatchFilter(true)
+    m_useKnn(false), m_useMatchTrainToQuery(false), m_useParallelAffineDetection(true), m_useRansacVVS(true),
+    m_useSingleMatchFilter(true)
 {
   //Use k-nearest neighbors (knn) to retrieve the two best matches for a keypoint
   //So this is useful only for ratioDistanceThreshold method
@@ -383,7 +385,8 @@ vpKeyPoint::vpKeyPoint(const std::vector<std::string> &detectorNames, const std:
     m_useBruteForceCrossCheck(true),
     #endif
     m_useConsensusPercentage(false),
-    m_useKnn(false), m_useMatchTrainToQuery(false), m_useRansacVVS(true), m_useSingleMatchFilter(true)
+    m_useKnn(false), m_useMatchTrainToQuery(false), m_useParallelAffineDetection(true), m_useRansacVVS(true),
+    m_useSingleMatchFilter(true)
 {
   //Use k-nearest neighbors (knn) to retrieve the two best matches for a keypoint
   //So this is useful only for ratioDistanceThreshold method
@@ -3337,12 +3340,46 @@ bool vpKeyPoint::matchPointAndDetect(const vpImage<unsigned char> &I, const vpCa
   return isMatchOk;
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//Process a range of the simulated views of detectExtractAffine(). Each view
+//only writes its own keypoints, descriptors and image.
+class vpKeyPoint::vpAffineViewTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpAffineViewTask(vpKeyPoint &keyPoint, const cv::Mat &img, const std::vector<std::pair<double, int> > &listOfAffineParams,
+                   std::vector<std::vector<cv::KeyPoint> > &listOfKeypoints, std::vector<cv::Mat> &listOfDescriptors,
+                   std::vector<vpImage<unsigned char> > *listOfAffineI)
+    : m_keyPoint(keyPoint), m_img(img), m_listOfAffineParams(listOfAffineParams), m_listOfKeypoints(listOfKeypoints),
+      m_listOfDescriptors(listOfDescriptors), m_listOfAffineI(listOfAffineI)
+  {}
+
+  void run(unsigned int start, unsigned int end)
+  {
+    for (unsigned int cpt = start; cpt < end; cpt++) {
+      m_keyPoint.detectExtractAffineView(m_img, m_listOfAffineParams[cpt].first, m_listOfAffineParams[cpt].second,
+                                         m_listOfKeypoints[cpt], m_listOfDescriptors[cpt],
+                                         m_listOfAffineI != NULL ? &(*m_listOfAffineI)[cpt] : NULL);
+    }
+  }
+
+private:
+  vpKeyPoint &m_keyPoint;
+  const cv::Mat &m_img;
+  const std::vector<std::pair<double, int> > &m_listOfAffineParams;
+  std::vector<std::vector<cv::KeyPoint> > &m_listOfKeypoints;
+  std::vector<cv::Mat> &m_listOfDescriptors;
+  std::vector<vpImage<unsigned char> > *m_listOfAffineI;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
     Apply a set of affine transormations to the image, detect keypoints and
     reproject them into initial image coordinates.
     See http://www.ipol.im/pub/algo/my_affine_sift/ for the details.
     See https://github.com/Itseez/opencv/blob/master/samples/python2/asift.py for the Python implementation by Itseez
     and Matt Sheckells for the current implementation in C++.
+    The simulated views are processed in parallel with vpThreadPool, unless disabled with
+    setUseParallelAffineDetection(). The lists are ordered by simulated view in both cases.
     \param I : Input image
     \param listOfKeypoints : List of detected keypoints in the multiple images after affine transformations
     \param listOfDescriptors : Corresponding list of descriptors
@@ -3350,62 +3387,6 @@ bool vpKeyPoint::matchPointAndDetect(const vpImage<unsigned char> &I, const vpCa
  */
 void vpKeyPoint::detectExtractAffine(const vpImage<unsigned char> &I,std::vector<std::vector<cv::KeyPoint> >& listOfKeypoints,
     std::vector<cv::Mat>& listOfDescriptors, std::vector<vpImage<unsigned char> > *listOfAffineI) {
-#if 0
-  cv::Mat img;
-  vpImageConvert::convert(I, img);
-  listOfKeypoints.clear();
-  listOfDescriptors.clear();
-
-  for (int tl = 1; tl < 6; tl++) {
-    double t = pow(2, 0.5 * tl);
-    for (int phi = 0; phi < 180; phi += (int)(72.0 / t)) {
-      std::vector<cv::KeyPoint> keypoints;
-      cv::Mat descriptors;
-
-      cv::Mat timg, mask, Ai;
-      img.copyTo(timg);
-
-      affineSkew(t, phi, timg, mask, Ai);
-
-
-      if(listOfAffineI != NULL) {
-        cv::Mat img_disp;
-        bitwise_and(mask, timg, img_disp);
-        vpImage<unsigned char> tI;
-        vpImageConvert::convert(img_disp, tI);
-        listOfAffineI->push_back(tI);
-      }
-#if 0
-      cv::Mat img_disp;
-      cv::bitwise_and(mask, timg, img_disp);
-      cv::namedWindow( "Skew", cv::WINDOW_AUTOSIZE ); // Create a window for display.
-      cv::imshow( "Skew", img_disp );
-      cv::waitKey(0);
-#endif
-
-      for(std::map<std::string, cv::Ptr<cv::FeatureDetector> >::const_iterator it = m_detectors.begin();
-          it != m_detectors.end(); ++it) {
-        std::vector<cv::KeyPoint> kp;
-        it->second->detect(timg, kp, mask);
-        keypoints.insert(keypoints.end(), kp.begin(), kp.end());
-      }
-
-      double elapsedTime;
-      extract(timg, keypoints, descriptors, elapsedTime);
-
-      for(unsigned int i = 0; i < keypoints.size(); i++) {
-        cv::Point3f kpt(keypoints[i].pt.x, keypoints[i].pt.y, 1.f);
-        cv::Mat kpt_t = Ai * cv::Mat(kpt);
-        keypoints[i].pt.x = kpt_t.at<float>(0, 0);
-        keypoints[i].pt.y = kpt_t.at<float>(1, 0);
-      }
-
-      listOfKeypoints.push_back(keypoints);
-      listOfDescriptors.push_back(descriptors);
-    }
-  }
-
-#else
   cv::Mat img;
   vpImageConvert::convert(I, img);
 
@@ -3418,6 +3399,10 @@ void vpKeyPoint::detectExtractAffine(const vpImage<unsigned char> &I,std::vector
     }
   }
 
+  //Each simulated view has its own buffers, so that the result does not depend
+  //on the order the views are processed
+  listOfKeypoints.clear();
+  listOfDescriptors.clear();
   listOfKeypoints.resize(listOfAffineParams.size());
   listOfDescriptors.resize(listOfAffineParams.size());
 
@@ -3425,56 +3410,61 @@ void vpKeyPoint::detectExtractAffine(const vpImage<unsigned char> &I,std::vector
     listOfAffineI->resize(listOfAffineParams.size());
   }
 
-#ifdef VISP_HAVE_OPENMP
-  #pragma omp parallel for
-#endif
-  for(int cpt = 0; cpt < static_cast<int>(listOfAffineParams.size()); cpt++) {
-    std::vector<cv::KeyPoint> keypoints;
-    cv::Mat descriptors;
-
-    cv::Mat timg, mask, Ai;
-    img.copyTo(timg);
+  if(m_useParallelAffineDetection) {
+    vpAffineViewTask task(*this, img, listOfAffineParams, listOfKeypoints, listOfDescriptors, listOfAffineI);
+    vpThreadPool::parallel_for(0, (unsigned int) listOfAffineParams.size(), task, 1);
+  } else {
+    for(size_t cpt = 0; cpt < listOfAffineParams.size(); cpt++) {
+      detectExtractAffineView(img, listOfAffineParams[cpt].first, listOfAffineParams[cpt].second,
+                              listOfKeypoints[cpt], listOfDescriptors[cpt],
+                              listOfAffineI != NULL ? &(*listOfAffineI)[cpt] : NULL);
+    }
+  }
+}
 
-    affineSkew(listOfAffineParams[(size_t) cpt].first, listOfAffineParams[(size_t) cpt].second, timg, mask, Ai);
+/*!
+   Simulate one affine view of an image, detect the keypoints in this view, extract their descriptors and
+   reproject them into the initial image coordinates.
+
+   \param img : Input image.
+   \param tilt : Tilt of the simulated view.
+   \param phi : Rotation of the simulated view (in degree).
+   \param keypoints : Keypoints detected in the simulated view, in the initial image coordinates.
+   \param descriptors : Corresponding descriptors.
+   \param affineI : If not NULL, image of the simulated view.
+ */
+void vpKeyPoint::detectExtractAffineView(const cv::Mat &img, const double tilt, const int phi,
+                                         std::vector<cv::KeyPoint> &keypoints, cv::Mat &descriptors,
+                                         vpImage<unsigned char> *affineI) {
+  keypoints.clear();
 
+  cv::Mat timg, mask, Ai;
+  img.copyTo(timg);
 
-    if(listOfAffineI != NULL) {
-      cv::Mat img_disp;
-      bitwise_and(mask, timg, img_disp);
-      vpImage<unsigned char> tI;
-      vpImageConvert::convert(img_disp, tI);
-      (*listOfAffineI)[(size_t) cpt] = tI;
-    }
+  affineSkew(tilt, phi, timg, mask, Ai);
 
-#if 0
+  if(affineI != NULL) {
     cv::Mat img_disp;
-    cv::bitwise_and(mask, timg, img_disp);
-    cv::namedWindow( "Skew", cv::WINDOW_AUTOSIZE ); // Create a window for display.
-    cv::imshow( "Skew", img_disp );
-    cv::waitKey(0);
-#endif
-
-    for(std::map<std::string, cv::Ptr<cv::FeatureDetector> >::const_iterator it = m_detectors.begin();
-        it != m_detectors.end(); ++it) {
-      std::vector<cv::KeyPoint> kp;
-      it->second->detect(timg, kp, mask);
-      keypoints.insert(keypoints.end(), kp.begin(), kp.end());
-    }
+    bitwise_and(mask, timg, img_disp);
+    vpImageConvert::convert(img_disp, *affineI);
+  }
 
-    double elapsedTime;
-    extract(timg, keypoints, descriptors, elapsedTime);
+  for(std::map<std::string, cv::Ptr<cv::FeatureDetector> >::const_iterator it = m_detectors.begin();
+      it != m_detectors.end(); ++it) {
+    std::vector<cv::KeyPoint> kp;
+    it->second->detect(timg, kp, mask);
+    keypoints.insert(keypoints.end(), kp.begin(), kp.end());
+  }
 
-    for(size_t i = 0; i < keypoints.size(); i++) {
-      cv::Point3f kpt(keypoints[i].pt.x, keypoints[i].pt.y, 1.f);
-      cv::Mat kpt_t = Ai * cv::Mat(kpt);
-      keypoints[i].pt.x = kpt_t.at<float>(0, 0);
-      keypoints[i].pt.y = kpt_t.at<float>(1, 0);
-    }
+  double elapsedTime;
+  extract(timg, keypoints, descriptors, elapsedTime);
 
-    listOfKeypoints[(size_t) cpt] = keypoints;
-    listOfDescriptors[(size_t) cpt] = descriptors;
+  for(size_t i = 0; i < keypoints.size(); i++) {
+    cv::Point3f kpt(keypoints[i].pt.x, keypoints[i].pt.y, 1.f);
+    cv::Mat kpt_t = Ai * cv::Mat(kpt);
+    keypoints[i].pt.x = kpt_t.at<float>(0, 0);
+    keypoints[i].pt.y = kpt_t.at<float>(1, 0);
   }
-#endif
 }
 
 /*!
@@ -3503,7 +3493,8 @@ void vpKeyPoint::reset() {
 #endif
   m_useConsensusPercentage = false;
   m_useKnn = true; //as m_filterType == ratioDistanceThreshold
-  m_useMatchTrainToQuery = false; m_useRansacVVS = true; m_useSingleMatchFilter = true;
+  m_useMatchTrainToQuery = false; m_useParallelAffineDetection = true; m_useRansacVVS = true;
+  m_useSingleMatchFilter = true;
 
   m_detectorNames.push_back("ORB");
   m_extractorNames.push_back("ORB");
@@ -38,6 +38,7 @@
  *****************************************************************************/
 
 
+
 /*!
   \file vpPoseRansac.cpp
   \brief function used to estimate a pose using the Ransac algorithm
@@ -56,18 +57,301 @@
 #include <visp3/core/vpRansac.h>
 #include <visp3/core/vpTime.h>
 #include <visp3/core/vpList.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/vision/vpPoseException.h>
 #include <visp3/core/vpMath.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
 #define eps 1e-6
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+  // Number of hypotheses evaluated between two checks of the stopping
+  // criteria in the parallel mode. It does not depend on the number of
+  // threads so that the result is the same whatever this number is.
+  const unsigned int ransacBatchSize = 64;
+  // Probability to draw at least one outlier free sample used to adapt the
+  // number of trials in the parallel mode.
+  const double ransacProbability = 0.99;
+  // Seed of the pseudo-random series of the parallel mode.
+  const unsigned int ransacSeed = 0;
+
+  // Point coordinates stored in contiguous arrays for the inlier scoring
+  struct vpRansacPointSet
+  {
+    std::vector<double> oX, oY, oZ, x, y;
+
+    void push_back(const vpPoint &pt)
+    {
+      oX.push_back(pt.get_oX());
+      oY.push_back(pt.get_oY());
+      oZ.push_back(pt.get_oZ());
+      x.push_back(pt.get_x());
+      y.push_back(pt.get_y());
+    }
+
+    unsigned int size() const { return (unsigned int)x.size(); }
+  };
+
+  // Park and Miller minimal standard generator. Contrary to vpUniRand, its
+  // state is not shared so that each hypothesis has its own series.
+  class vpRansacRandom
+  {
+  public:
+    vpRansacRandom(unsigned int seed, unsigned int trial)
+    {
+      // Hash the seed and the trial number to decorrelate successive series
+      unsigned int h = seed ^ (trial * 0x9E3779B9u);
+      h ^= h >> 16; h *= 0x85EBCA6Bu;
+      h ^= h >> 13; h *= 0xC2B2AE35u;
+      h ^= h >> 16;
+      m_x = (long)(h % 2147483646u) + 1;
+    }
+
+    unsigned int operator()(unsigned int n)
+    {
+      const long a = 16807, m = 2147483647, q = 127773, r = 2836;
+      long k = m_x / q;
+      m_x = a * (m_x - k * q) - k * r;
+      if (m_x < 0)
+        m_x += m;
+      return (unsigned int)m_x % n;
+    }
+
+  private:
+    long m_x;
+  };
+
+  /*
+    Count the points whose reprojection error with cMo is below threshold and
+    optionally fill consensus with their index. The computations are done in the
+    same order than vpPoint::track() so that the result does not depend on the
+    SSE2 path.
+  */
+  unsigned int countRansacInliers(const vpRansacPointSet &pts, const vpHomogeneousMatrix &cMo,
+                                  const double threshold, std::vector<unsigned int> *consensus)
+  {
+    const unsigned int n = pts.size();
+    const double *oX = &pts.oX[0], *oY = &pts.oY[0], *oZ = &pts.oZ[0];
+    const double *x = &pts.x[0], *y = &pts.y[0];
+    unsigned int nbInliers = 0;
+    unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+    const __m128d r00 = _mm_set1_pd(cMo[0][0]), r01 = _mm_set1_pd(cMo[0][1]), r02 = _mm_set1_pd(cMo[0][2]), t0 = _mm_set1_pd(cMo[0][3]);
+    const __m128d r10 = _mm_set1_pd(cMo[1][0]), r11 = _mm_set1_pd(cMo[1][1]), r12 = _mm_set1_pd(cMo[1][2]), t1 = _mm_set1_pd(cMo[1][3]);
+    const __m128d r20 = _mm_set1_pd(cMo[2][0]), r21 = _mm_set1_pd(cMo[2][1]), r22 = _mm_set1_pd(cMo[2][2]), t2 = _mm_set1_pd(cMo[2][3]);
+    const __m128d thr = _mm_set1_pd(threshold);
+    for (; i + 2 <= n; i += 2) {
+      const __m128d X = _mm_loadu_pd(oX + i), Y = _mm_loadu_pd(oY + i), Z = _mm_loadu_pd(oZ + i);
+      const __m128d cX = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(r00, X), _mm_mul_pd(r01, Y)), _mm_mul_pd(r02, Z)), t0);
+      const __m128d cY = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(r10, X), _mm_mul_pd(r11, Y)), _mm_mul_pd(r12, Z)), t1);
+      const __m128d cZ = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(r20, X), _mm_mul_pd(r21, Y)), _mm_mul_pd(r22, Z)), t2);
+      const __m128d dx = _mm_sub_pd(_mm_div_pd(cX, cZ), _mm_loadu_pd(x + i));
+      const __m128d dy = _mm_sub_pd(_mm_div_pd(cY, cZ), _mm_loadu_pd(y + i));
+      const __m128d error = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+      const int mask = _mm_movemask_pd(_mm_cmplt_pd(error, thr));
+      if (mask) {
+        if (mask & 1) {
+          nbInliers++;
+          if (consensus) consensus->push_back(i);
+        }
+        if (mask & 2) {
+          nbInliers++;
+          if (consensus) consensus->push_back(i + 1);
+        }
+      }
+    }
+#endif
+
+    for (; i < n; i++) {
+      const double cX = cMo[0][0]*oX[i] + cMo[0][1]*oY[i] + cMo[0][2]*oZ[i] + cMo[0][3];
+      const double cY = cMo[1][0]*oX[i] + cMo[1][1]*oY[i] + cMo[1][2]*oZ[i] + cMo[1][3];
+      const double cZ = cMo[2][0]*oX[i] + cMo[2][1]*oY[i] + cMo[2][2]*oZ[i] + cMo[2][3];
+      const double d = vpMath::sqr(cX / cZ - x[i]) + vpMath::sqr(cY / cZ - y[i]);
+      if (sqrt(d) < threshold) {
+        nbInliers++;
+        if (consensus) consensus->push_back(i);
+      }
+    }
+
+    return nbInliers;
+  }
+
+  /*
+    Compute the pose from the minimal sample set with Lagrange and Dementhon
+    and keep the one with the lowest residual. Return false if both failed.
+  */
+  bool computeMinimalPose(vpPose &poseMin, const unsigned int nbMinRandom, vpHomogeneousMatrix &cMo, double &r)
+  {
+    vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
+
+    //Flags set if pose computation is OK
+    bool is_valid_lagrange = false;
+    bool is_valid_dementhon = false;
+
+    //Set maximum value for residuals
+    double r_lagrange = DBL_MAX;
+    double r_dementhon = DBL_MAX;
+
+    try {
+      poseMin.computePose(vpPose::LAGRANGE, cMo_lagrange);
+      r_lagrange = poseMin.computeResidual(cMo_lagrange);
+      is_valid_lagrange = true;
+    } catch(/*vpException &e*/...) {
+//      std::cerr << e.what() << std::endl;
+    }
+
+    try {
+      poseMin.computePose(vpPose::DEMENTHON, cMo_dementhon);
+      r_dementhon = poseMin.computeResidual(cMo_dementhon);
+      is_valid_dementhon = true;
+    } catch(/*vpException &e*/...) {
+//      std::cerr << e.what() << std::endl;
+    }
+
+    //If residual returned is not a number (NAN), set valid to false
+    if(vpMath::isNaN(r_lagrange)) {
+      is_valid_lagrange = false;
+      r_lagrange = DBL_MAX;
+    }
+
+    if(vpMath::isNaN(r_dementhon)) {
+      is_valid_dementhon = false;
+      r_dementhon = DBL_MAX;
+    }
+
+    if(! (is_valid_lagrange || is_valid_dementhon))
+      return false;
+
+    if (r_lagrange < r_dementhon) {
+      r = r_lagrange;
+      cMo = cMo_lagrange;
+    }
+    else {
+      r = r_dementhon;
+      cMo = cMo_dementhon;
+    }
+    r = sqrt(r) / (double) nbMinRandom;
+
+    return true;
+  }
+
+  // Evaluate a range of hypotheses, each one with its own pseudo-random series
+  class vpRansacHypothesisTask : public vpThreadPool::vpRangeTask
+  {
+  public:
+    vpRansacHypothesisTask(const std::vector<vpPoint> &points, const vpRansacPointSet &pts,
+                           const unsigned int nbMinRandom, const double threshold,
+                           bool (*func)(vpHomogeneousMatrix *))
+      : nbInliers(ransacBatchSize), poses(ransacBatchSize), m_points(points), m_pts(pts),
+        m_nbMinRandom(nbMinRandom), m_threshold(threshold), m_func(func), m_firstTrial(0)
+    {
+    }
+
+    void setFirstTrial(unsigned int firstTrial) { m_firstTrial = firstTrial; }
+
+    void run(unsigned int start, unsigned int end)
+    {
+      const unsigned int size = m_pts.size();
+      std::vector<unsigned int> sample(m_nbMinRandom);
+
+      for (unsigned int k = start; k < end; k++) {
+        nbInliers[k] = 0;
+
+        vpRansacRandom random(ransacSeed, m_firstTrial + k);
+        vpPose poseMin;
+        for (unsigned int i = 0; i < m_nbMinRandom; i++) {
+          bool used = true;
+          while (used) {
+            sample[i] = random(size);
+            used = (std::find(sample.begin(), sample.begin() + i, sample[i]) != sample.begin() + i);
+          }
+          poseMin.addPoint(m_points[sample[i]]);
+        }
+
+        vpHomogeneousMatrix cMo;
+        double r;
+        if (! computeMinimalPose(poseMin, m_nbMinRandom, cMo, r))
+          continue;
+
+        //Filter the pose using some criterion (orientation angles, translations, etc.)
+        if (m_func != NULL && ! m_func(&cMo))
+          continue;
+
+        if (r < m_threshold) {
+          nbInliers[k] = countRansacInliers(m_pts, cMo, m_threshold, NULL);
+          poses[k] = cMo;
+        }
+      }
+    }
+
+    std::vector<unsigned int> nbInliers;
+    std::vector<vpHomogeneousMatrix> poses;
+
+  private:
+    const std::vector<vpPoint> &m_points;
+    const vpRansacPointSet &m_pts;
+    unsigned int m_nbMinRandom;
+    double m_threshold;
+    bool (*m_func)(vpHomogeneousMatrix *);
+    unsigned int m_firstTrial;
+  };
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Compute the number of RANSAC trials needed to draw, with a given probability,
+  at least one sample set free of outliers.
+
+  \param probability : Probability to draw at least one sample set without
+  outlier, in [0, 1[ (typically 0.99).
+  \param epsilon : Ratio of outliers in the data, in [0, 1].
+  \param sampleSize : Size of the minimal sample set.
+  \param maxIterations : Upper bound of the returned number of trials.
+  \return The number of trials, between 1 and \e maxIterations.
+
+  \sa setUseParallelRansac()
+*/
+int vpPose::computeRansacIterations(double probability, double epsilon, const int sampleSize, int maxIterations)
+{
+  if (probability < 0.0 || probability >= 1.0 || epsilon < 0.0 || epsilon > 1.0) {
+    throw vpException(vpException::badValue, "The probability must be in [0, 1[ and the ratio of outliers in [0, 1].");
+  }
+  if (maxIterations < 1) {
+    maxIterations = 1;
+  }
+
+  // Probability that a sample set is free of outliers
+  double w = pow(1.0 - epsilon, (double) sampleSize);
+  if (w <= std::numeric_limits<double>::epsilon()) {
+    return maxIterations;
+  }
+  if (w >= 1.0) {
+    return 1;
+  }
+
+  double nbIterations = ceil(log(1.0 - probability) / log(1.0 - w));
+  if (nbIterations >= (double) maxIterations) {
+    return maxIterations;
+  }
+
+  return nbIterations < 1.0 ? 1 : (int) nbIterations;
+}
 
 /*! 
   Compute the pose using the Ransac approach. 
  
   \param cMo : Computed pose
   \param func : Pointer to a function that takes in parameter a vpHomogeneousMatrix
-  and returns true if the pose check is OK or false otherwise
+  and returns true if the pose check is OK or false otherwise. When the parallel mode
+  is enabled with setUseParallelRansac(), this function is called from several threads
+  and must be thread safe.
   \return True if we found at least 4 points with a reprojection error below ransacThreshold.
 */
 bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMatrix *))
@@ -75,15 +359,9 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
   ransacInliers.clear();
   ransacInlierIndex.clear();
 
-  srand(0); //Fix seed here so we will have the same pseudo-random series at each run.
   std::vector<unsigned int> best_consensus;
-  std::vector<unsigned int> cur_consensus;
-  std::vector<unsigned int> cur_outliers;
-  std::vector<unsigned int> cur_randoms;
-  int nbTrials = 0;
   unsigned int nbMinRandom = 4 ;
   unsigned int nbInliers = 0;
-  double r, r_lagrange, r_dementhon;
 
   vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
 
@@ -94,19 +372,21 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
   }
 
   //Remove potential degenerate points
-  std::list<vpPoint> listOfUniquePoints;
+  std::vector<vpPoint> listOfUniquePoints;
+  vpRansacPointSet uniquePoints;
   std::map<size_t, size_t> mapOfUniquePointIndex;
+  listOfUniquePoints.reserve(listP.size());
   size_t index_pt = 0;
   for(std::list<vpPoint>::const_iterator it1 = listP.begin(); it1 != listP.end(); ++it1, index_pt++) {
-    vpPoint ptdeg = *it1;
+    const vpPoint &ptdeg = *it1;
+    const double x = ptdeg.get_x(), y = ptdeg.get_y();
+    const double oX = ptdeg.get_oX(), oY = ptdeg.get_oY(), oZ = ptdeg.get_oZ();
 
     bool degenerate = false;
-    for(std::list<vpPoint>::const_iterator it2 = listOfUniquePoints.begin(); it2 != listOfUniquePoints.end(); ++it2) {
-      vpPoint pt = *it2;
-
-      if( ((fabs(pt.get_x() - ptdeg.get_x()) < 1e-6) && (fabs(pt.get_y() - ptdeg.get_y()) < 1e-6))  ||
-          ((fabs(pt.get_oX() - ptdeg.get_oX()) < 1e-6) && (fabs(pt.get_oY() - ptdeg.get_oY()) < 1e-6) &&
-              (fabs(pt.get_oZ() - ptdeg.get_oZ()) < 1e-6))) {
+    for(unsigned int i = 0; i < uniquePoints.size(); i++) {
+      if( ((fabs(uniquePoints.x[i] - x) < 1e-6) && (fabs(uniquePoints.y[i] - y) < 1e-6))  ||
+          ((fabs(uniquePoints.oX[i] - oX) < 1e-6) && (fabs(uniquePoints.oY[i] - oY) < 1e-6) &&
+              (fabs(uniquePoints.oZ[i] - oZ) < 1e-6))) {
         degenerate = true;
         break;
       }
@@ -114,6 +394,7 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
 
     if(!degenerate) {
       listOfUniquePoints.push_back(ptdeg);
+      uniquePoints.push_back(ptdeg);
       mapOfUniquePointIndex[listOfUniquePoints.size()-1] = index_pt;
     }
   }
@@ -127,235 +408,136 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
 
   if(removeRansacDegeneratePoints) {
     //Remove duplicate points in listP
-    listP = listOfUniquePoints;
+    listP.assign(listOfUniquePoints.begin(), listOfUniquePoints.end());
   }
 
 
   bool foundSolution = false;
-  
-  while (nbTrials < ransacMaxTrials && nbInliers < (unsigned)ransacNbInlierConsensus)
-  {
-    //Hold the list of the index of the inliers (points in the consensus set)
-    cur_consensus.clear();
-
-    //Use a temporary variable because if not, the cMo passed in parameters will be modified when
-    // we compute the pose for the minimal sample sets but if the pose is not correct when we pass
-    // a function pointer we do not want to modify the cMo passed in parameters
-    vpHomogeneousMatrix cMo_tmp;
-    cur_outliers.clear();
-    cur_randoms.clear();
-    
-    //Vector of used points, initialized at false for all points
-    std::vector<bool> usedPt(size, false);
-    
-    vpPose poseMin;
-    for(unsigned int i = 0; i < nbMinRandom;)
-    {
-      if((size_t) std::count(usedPt.begin(), usedPt.end(), true) == usedPt.size()) {
-        //All points was picked once, break otherwise we stay in an infinite loop
-        break;
+
+  if (ransacParallel) {
+    // Hypotheses are evaluated by batches dispatched on the thread pool. Each
+    // hypothesis draws its sample set from its own series seeded with its
+    // trial number, and the best one is the first with the largest consensus,
+    // so that the result does not depend on the number of threads.
+    vpRansacHypothesisTask task(listOfUniquePoints, uniquePoints, nbMinRandom, ransacThreshold, func);
+    vpHomogeneousMatrix best_cMo;
+    unsigned int nbTrials = 0;
+    unsigned int maxTrials = (unsigned int) std::max(ransacMaxTrials, 0);
+
+    while (nbTrials < maxTrials && nbInliers < ransacNbInlierConsensus) {
+      unsigned int nbHypotheses = std::min(ransacBatchSize, maxTrials - nbTrials);
+      task.setFirstTrial(nbTrials);
+      vpThreadPool::parallel_for(0, nbHypotheses, task, 4);
+
+      for (unsigned int k = 0; k < nbHypotheses; k++) {
+        if (task.nbInliers[k] > nbInliers) {
+          nbInliers = task.nbInliers[k];
+          best_cMo = task.poses[k];
+          foundSolution = true;
+        }
       }
+      nbTrials += nbHypotheses;
 
-      //Pick a point randomly
-      unsigned int r_ = (unsigned int) rand() % size;
-      while(usedPt[r_]) {
-        //If already picked, pick another point randomly
-        r_ = (unsigned int) rand() % size;
+      // Adapt the number of trials to the ratio of outliers of the best consensus
+      if (nbInliers > 0) {
+        double epsilon = 1.0 - (double) nbInliers / (double) size;
+        maxTrials = std::min(maxTrials, (unsigned int) computeRansacIterations(ransacProbability, epsilon, (int) nbMinRandom, (int) maxTrials));
       }
-      //Mark this point as already picked
-      usedPt[r_] = true;
-      
-      std::list<vpPoint>::const_iterator iter = listOfUniquePoints.begin();
-      std::advance(iter, r_);
-      vpPoint pt = *iter;
-      
-      poseMin.addPoint(pt);
-      cur_randoms.push_back(r_);
-      //Increment the number of points picked
-      i++;
-
-//      bool degenerate = false;
-//      for(std::list<vpPoint>::const_iterator it = poseMin.listP.begin(); it != poseMin.listP.end(); ++it){
-//        vpPoint ptdeg = *it;
-//        if( ((fabs(pt.get_x() - ptdeg.get_x()) < 1e-6) && (fabs(pt.get_y() - ptdeg.get_y()) < 1e-6))  ||
-//            ((fabs(pt.get_oX() - ptdeg.get_oX()) < 1e-6) && (fabs(pt.get_oY() - ptdeg.get_oY()) < 1e-6) && (fabs(pt.get_oZ() - ptdeg.get_oZ()) < 1e-6))){
-//          degenerate = true;
-//          break;
-//        }
-//      }
-//      if(!degenerate) {
-//        poseMin.addPoint(pt);
-//        cur_randoms.push_back(r_);
-//        //Increment the number of points picked
-//        i++;
-//      }
     }
 
-    if(poseMin.npt < nbMinRandom) {
-      nbTrials++;
-      continue;
+    if (foundSolution) {
+      cMo = best_cMo;
+      countRansacInliers(uniquePoints, best_cMo, ransacThreshold, &best_consensus);
     }
+  }
+  else {
+    srand(0); //Fix seed here so we will have the same pseudo-random series at each run.
+    std::vector<unsigned int> cur_consensus;
+    int nbTrials = 0;
+    double r;
 
-    //Flags set if pose computation is OK
-    bool is_valid_lagrange = false;
-    bool is_valid_dementhon = false;
+    while (nbTrials < ransacMaxTrials && nbInliers < (unsigned)ransacNbInlierConsensus)
+    {
+      //Use a temporary variable because if not, the cMo passed in parameters will be modified when
+      // we compute the pose for the minimal sample sets but if the pose is not correct when we pass
+      // a function pointer we do not want to modify the cMo passed in parameters
+      vpHomogeneousMatrix cMo_tmp;
 
-    //Set maximum value for residuals
-    r_lagrange = DBL_MAX;
-    r_dementhon = DBL_MAX;
+      //Vector of used points, initialized at false for all points
+      std::vector<bool> usedPt(size, false);
 
-    try {
-      poseMin.computePose(vpPose::LAGRANGE, cMo_lagrange);
-      r_lagrange = poseMin.computeResidual(cMo_lagrange);
-      is_valid_lagrange = true;
-    } catch(/*vpException &e*/...) {
-//      std::cerr << e.what() << std::endl;
-    }
-
-    try {
-      poseMin.computePose(vpPose::DEMENTHON, cMo_dementhon);
-      r_dementhon = poseMin.computeResidual(cMo_dementhon);
-      is_valid_dementhon = true;
-    } catch(/*vpException &e*/...) {
-//      std::cerr << e.what() << std::endl;
-    }
-
-    //If residual returned is not a number (NAN), set valid to false
-    if(vpMath::isNaN(r_lagrange)) {
-      is_valid_lagrange = false;
-      r_lagrange = DBL_MAX;
-    }
+      vpPose poseMin;
+      for(unsigned int i = 0; i < nbMinRandom;)
+      {
+        if((size_t) std::count(usedPt.begin(), usedPt.end(), true) == usedPt.size()) {
+          //All points was picked once, break otherwise we stay in an infinite loop
+          break;
+        }
 
-    if(vpMath::isNaN(r_dementhon)) {
-      is_valid_dementhon = false;
-      r_dementhon = DBL_MAX;
-    }
+        //Pick a point randomly
+        unsigned int r_ = (unsigned int) rand() % size;
+        while(usedPt[r_]) {
+          //If already picked, pick another point randomly
+          r_ = (unsigned int) rand() % size;
+        }
+        //Mark this point as already picked
+        usedPt[r_] = true;
 
-    //If at least one pose computation is OK,
-    //we can continue, otherwise pick another random set
-    if(is_valid_lagrange || is_valid_dementhon) {
-      if (r_lagrange < r_dementhon) {
-        r = r_lagrange;
-//        cMo = cMo_lagrange;
-        cMo_tmp = cMo_lagrange;
+        poseMin.addPoint(listOfUniquePoints[r_]);
+        //Increment the number of points picked
+        i++;
       }
-      else {
-        r = r_dementhon;
-//        cMo = cMo_dementhon;
-        cMo_tmp = cMo_dementhon;
+
+      if(poseMin.npt < nbMinRandom) {
+        nbTrials++;
+        continue;
       }
-      r = sqrt(r) / (double) nbMinRandom;
 
-      //Filter the pose using some criterion (orientation angles, translations, etc.)
-      bool isPoseValid = true;
-      if(func != NULL) {
-        isPoseValid = func(&cMo_tmp);
-        if(isPoseValid) {
+      //If at least one pose computation is OK,
+      //we can continue, otherwise pick another random set
+      if(computeMinimalPose(poseMin, nbMinRandom, cMo_tmp, r)) {
+        //Filter the pose using some criterion (orientation angles, translations, etc.)
+        bool isPoseValid = true;
+        if(func != NULL) {
+          isPoseValid = func(&cMo_tmp);
+          if(isPoseValid) {
+            cMo = cMo_tmp;
+          }
+        } else {
+          //No post filtering on pose, so copy cMo_temp to cMo
           cMo = cMo_tmp;
         }
-      } else {
-        //No post filtering on pose, so copy cMo_temp to cMo
-        cMo = cMo_tmp;
-      }
 
-      if (isPoseValid && r < ransacThreshold)
-      {
-        unsigned int nbInliersCur = 0;
-        unsigned int iter = 0;
-        for (std::list<vpPoint>::const_iterator it = listOfUniquePoints.begin(); it != listOfUniquePoints.end(); ++it)
+        if (isPoseValid && r < ransacThreshold)
         {
-          vpPoint pt = *it;
-          vpPoint p(pt) ;
-          p.track(cMo) ;
-
-          double d = vpMath::sqr(p.get_x() - pt.get_x()) + vpMath::sqr(p.get_y() - pt.get_y()) ;
-          double error = sqrt(d) ;
-          if(error < ransacThreshold) {
-            // the point is considered as inlier if the error is below the threshold
-            nbInliersCur++;
-            cur_consensus.push_back(iter);
-
-//            // But, we need also to check if it is not a degenerate point
-//            bool degenerate = false;
-//
-//            for(unsigned int it_inlier_index = 0; it_inlier_index< cur_consensus.size(); it_inlier_index++){
-//              std::list<vpPoint>::const_iterator it_point = listP.begin();
-//              std::advance(it_point, cur_consensus[it_inlier_index]);
-//              pt = *it_point;
-//
-//              vpPoint ptdeg = *it;
-//              if( ((fabs(pt.get_x() - ptdeg.get_x()) < 1e-6) && (fabs(pt.get_y() - ptdeg.get_y()) < 1e-6))  ||
-//                  ((fabs(pt.get_oX() - ptdeg.get_oX()) < 1e-6) && (fabs(pt.get_oY() - ptdeg.get_oY()) < 1e-6)
-//                      && (fabs(pt.get_oZ() - ptdeg.get_oZ()) < 1e-6))){
-//                degenerate = true;
-//                break;
-//              }
-//            }
-//
-//            if(!degenerate) {
-//              nbInliersCur++;
-//              cur_consensus.push_back(iter);
-//            }
-//            else {
-//              cur_outliers.push_back(iter);
-//            }
-          }
-          else {
-            cur_outliers.push_back(iter);
+          // A point is considered as inlier if its reprojection error is below the threshold
+          cur_consensus.clear();
+          unsigned int nbInliersCur = countRansacInliers(uniquePoints, cMo, ransacThreshold, &cur_consensus);
+
+          if(nbInliersCur > nbInliers)
+          {
+            foundSolution = true;
+            best_consensus = cur_consensus;
+            nbInliers = nbInliersCur;
           }
 
-          iter++;
-        }
+          nbTrials++;
 
-        if(nbInliersCur > nbInliers)
-        {
-          foundSolution = true;
-          best_consensus = cur_consensus;
-          nbInliers = nbInliersCur;
+          if(nbTrials >= ransacMaxTrials) {
+//            vpERROR_TRACE("Ransac reached the maximum number of trials");
+            foundSolution = true;
+          }
         }
-
-        nbTrials++;
-        
-        if(nbTrials >= ransacMaxTrials) {
-//          vpERROR_TRACE("Ransac reached the maximum number of trials");
-          foundSolution = true;
+        else {
+          nbTrials++;
         }
-      }
-      else {
+      } else {
         nbTrials++;
-
-        if(nbTrials >= ransacMaxTrials) {
-//          vpERROR_TRACE("Ransac reached the maximum number of trials");
-        }
-      }
-    } else {
-      nbTrials++;
-
-      if(nbTrials >= ransacMaxTrials) {
-//        vpERROR_TRACE("Ransac reached the maximum number of trials");
       }
     }
   }
     
   if(foundSolution) {
-//    std::cout << "Nombre d'inliers " << nbInliers << std::endl ;
-    
-    //Display the random picked points
-    /*
-    std::cout << "Randoms : "; 
-    for(unsigned int i = 0 ; i < cur_randoms.size() ; i++)
-      std::cout << cur_randoms[i] << " ";
-    std::cout << std::endl;
-    */
-    
-    //Display the outliers
-    /*
-    std::cout << "Outliers : "; 
-    for(unsigned int i = 0 ; i < cur_outliers.size() ; i++)
-      std::cout << cur_outliers[i] << " ";
-    std::cout << std::endl;
-    */
-    
     //Even if the cardinality of the best consensus set is inferior to ransacNbInlierConsensus,
     //we want to refine the solution with data in best_consensus and return this pose.
     //This is an approach used for example in p118 in Multiple View Geometry in Computer Vision, Hartley, R.~I. and Zisserman, A.
@@ -365,10 +547,8 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
       vpPose pose ;
       for(unsigned i = 0 ; i < best_consensus.size(); i++)
       {
-        std::list<vpPoint>::const_iterator iter = listOfUniquePoints.begin();
-        std::advance(iter, best_consensus[i]);
-        vpPoint pt = *iter;
-      
+        const vpPoint &pt = listOfUniquePoints[best_consensus[i]];
+
         pose.addPoint(pt) ;
         ransacInliers.push_back(pt);
       }
@@ -388,8 +568,8 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
       bool is_valid_dementhon = false;
 
       //Set maximum value for residuals
-      r_lagrange = DBL_MAX;
-      r_dementhon = DBL_MAX;
+      double r_lagrange = DBL_MAX;
+      double r_dementhon = DBL_MAX;
 
       try {
         pose.computePose(vpPose::LAGRANGE, cMo_lagrange);
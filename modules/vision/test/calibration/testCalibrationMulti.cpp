@@ -0,0 +1,236 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the multi-image calibration with a dense pseudo-inverse solver.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testCalibrationMulti.cpp
+
+  \brief Calibrate a camera from 3, 10 and 30 synthetic views of a grid with
+  vpCalibration::computeCalibrationMulti(), and check that the intrinsic
+  parameters and the poses are the ones of the virtual visual servoing that
+  pseudo-inverts the whole interaction matrix of all the views.
+*/
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpGaussRand.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpMeterPixelConversion.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/vision/vpCalibration.h>
+#include <visp3/vision/vpPose.h>
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <cmath>
+
+namespace {
+// Points of a view: coordinates in the grid frame and in the image
+struct vpView
+{
+  std::vector<vpPoint> points;
+  std::vector<vpImagePoint> ips;
+};
+
+// Initial pose of a view, computed as in vpCalibration::computeCalibrationMulti()
+vpHomogeneousMatrix initPose(const vpView &view, const vpCameraParameters &cam)
+{
+  vpPose pose;
+  for (size_t i = 0; i < view.points.size(); i++) {
+    vpPoint P(view.points[i].get_oX(), view.points[i].get_oY(), view.points[i].get_oZ());
+    double x = 0, y = 0;
+    vpPixelMeterConversion::convertPoint(cam, view.ips[i], x, y);
+    P.set_x(x);
+    P.set_y(y);
+    pose.addPoint(P);
+  }
+  vpHomogeneousMatrix cMo_lagrange, cMo_dementhon, cMo;
+  pose.computePose(vpPose::LAGRANGE, cMo_lagrange);
+  double residual_lagrange = pose.computeResidual(cMo_lagrange);
+  pose.computePose(vpPose::DEMENTHON, cMo_dementhon);
+  double residual_dementhon = pose.computeResidual(cMo_dementhon);
+  cMo = (residual_lagrange < residual_dementhon) ? cMo_lagrange : cMo_dementhon;
+  pose.computePose(vpPose::VIRTUAL_VS, cMo);
+  return cMo;
+}
+
+// Virtual visual servoing on all the views, solved with the pseudo-inverse of
+// the whole interaction matrix as vpCalibration did before the Schur complement
+void calibVVSMultiDense(const std::vector<vpView> &views, std::vector<vpHomogeneousMatrix> &cMo,
+                        vpCameraParameters &cam)
+{
+  const double threshold = 1e-10;
+  const unsigned int nbIterMax = 4000;
+  const unsigned int nbPose = (unsigned int)views.size(), nbPose6 = 6*nbPose;
+  unsigned int nbPointTotal = 0;
+  for (unsigned int p = 0; p < nbPose; p++)
+    nbPointTotal += (unsigned int)views[p].points.size();
+
+  unsigned int iter = 0;
+  double residu_1 = 1e12, r = 1e12-1;
+  while (vpMath::equal(residu_1, r, threshold) == false && iter < nbIterMax) {
+    iter++;
+    residu_1 = r;
+    double px = cam.get_px(), py = cam.get_py(), u0 = cam.get_u0(), v0 = cam.get_v0();
+
+    r = 0;
+    vpColVector error(2*nbPointTotal);
+    vpMatrix L(2*nbPointTotal, nbPose6+4);
+    unsigned int row = 0;
+    for (unsigned int p = 0; p < nbPose; p++) {
+      for (size_t i = 0; i < views[p].points.size(); i++, row += 2) {
+        const vpPoint &P = views[p].points[i];
+        double cP[3];
+        for (unsigned int k = 0; k < 3; k++)
+          cP[k] = cMo[p][k][0]*P.get_oX() + cMo[p][k][1]*P.get_oY() + cMo[p][k][2]*P.get_oZ() + cMo[p][k][3];
+        double inv_z = 1 / cP[2];
+        double X = cP[0] * inv_z, Y = cP[1] * inv_z;
+
+        error[row] = X*px + u0 - views[p].ips[i].get_u();
+        error[row+1] = Y*py + v0 - views[p].ips[i].get_v();
+        r += vpMath::sqr(error[row]) + vpMath::sqr(error[row+1]);
+
+        L[row][6*p] = px * (-inv_z);
+        L[row][6*p+2] = px * (X*inv_z);
+        L[row][6*p+3] = px * X*Y;
+        L[row][6*p+4] = -px * (1+X*X);
+        L[row][6*p+5] = px * Y;
+        L[row][nbPose6] = 1;
+        L[row][nbPose6+2] = X;
+
+        L[row+1][6*p+1] = py * (-inv_z);
+        L[row+1][6*p+2] = py * (Y*inv_z);
+        L[row+1][6*p+3] = py * (1+Y*Y);
+        L[row+1][6*p+4] = -py * X*Y;
+        L[row+1][6*p+5] = -py * X;
+        L[row+1][nbPose6+1] = 1;
+        L[row+1][nbPose6+3] = Y;
+      }
+    }
+
+    vpColVector Tc = -(L.pseudoInverse(1e-10) * error) * vpCalibration::getLambda();
+    cam.initPersProjWithoutDistortion(px+Tc[nbPose6+2], py+Tc[nbPose6+3], u0+Tc[nbPose6], v0+Tc[nbPose6+1]);
+    for (unsigned int p = 0; p < nbPose; p++) {
+      vpColVector v(6);
+      for (unsigned int i = 0; i < 6; i++)
+        v[i] = Tc[6*p + i];
+      cMo[p] = vpExponentialMap::direct(v, 1).inverse() * cMo[p];
+    }
+  }
+}
+
+double relativeDifference(double a, double b)
+{
+  return std::fabs(a - b) / std::max(std::fabs(a), std::fabs(b));
+}
+}
+
+int main()
+{
+  try {
+    const vpCameraParameters cam_true(600, 610, 322, 238);
+    const vpCameraParameters cam_init(550, 550, 320, 240);
+    vpGaussRand noise(0.2, 0, 1234);
+
+    unsigned int nbViews[] = {3, 10, 30};
+    for (unsigned int n = 0; n < 3; n++) {
+      // Views of a 8x6 grid with 3 cm squares
+      std::vector<vpView> views(nbViews[n]);
+      std::vector<vpCalibration> table_cal(nbViews[n]);
+      for (unsigned int p = 0; p < nbViews[n]; p++) {
+        vpHomogeneousMatrix cMo(0.02 * sin(1.7*p), 0.02 * cos(1.3*p), 0.45 + 0.05 * (p % 4),
+                                vpMath::rad(25 * sin(0.9*p + 1)), vpMath::rad(25 * cos(1.1*p)), vpMath::rad(7. * p));
+        table_cal[p].init();
+        for (unsigned int i = 0; i < 6; i++) {
+          for (unsigned int j = 0; j < 8; j++) {
+            vpPoint P((j - 3.5) * 0.03, (i - 2.5) * 0.03, 0);
+            P.project(cMo);
+            vpImagePoint ip;
+            vpMeterPixelConversion::convertPoint(cam_true, P.get_x(), P.get_y(), ip);
+            ip.set_u(ip.get_u() + noise());
+            ip.set_v(ip.get_v() + noise());
+
+            views[p].points.push_back(P);
+            views[p].ips.push_back(ip);
+            table_cal[p].addPoint(P.get_oX(), P.get_oY(), P.get_oZ(), ip);
+          }
+        }
+      }
+
+      double t = vpTime::measureTimeMs();
+      vpCameraParameters cam = cam_init;
+      double error;
+      vpCalibration::computeCalibrationMulti(vpCalibration::CALIB_VIRTUAL_VS, table_cal, cam, error, false);
+      t = vpTime::measureTimeMs() - t;
+
+      double t_dense = vpTime::measureTimeMs();
+      vpCameraParameters cam_dense = cam_init;
+      std::vector<vpHomogeneousMatrix> cMo_dense(nbViews[n]);
+      for (unsigned int p = 0; p < nbViews[n]; p++)
+        cMo_dense[p] = initPose(views[p], cam_init);
+      calibVVSMultiDense(views, cMo_dense, cam_dense);
+      t_dense = vpTime::measureTimeMs() - t_dense;
+
+      double diff_cam = std::max(std::max(relativeDifference(cam.get_px(), cam_dense.get_px()),
+                                          relativeDifference(cam.get_py(), cam_dense.get_py())),
+                                 std::max(relativeDifference(cam.get_u0(), cam_dense.get_u0()),
+                                          relativeDifference(cam.get_v0(), cam_dense.get_v0())));
+      double diff_pose = 0;
+      for (unsigned int p = 0; p < nbViews[n]; p++) {
+        for (unsigned int i = 0; i < 3; i++)
+          for (unsigned int j = 0; j < 4; j++)
+            diff_pose = std::max(diff_pose, std::fabs(table_cal[p].cMo[i][j] - cMo_dense[p][i][j]));
+      }
+
+      std::cout << nbViews[n] << " views: px " << cam.get_px() << " py " << cam.get_py() << " u0 " << cam.get_u0()
+                << " v0 " << cam.get_v0() << ", relative difference " << diff_cam << " on the intrinsics and "
+                << diff_pose << " on the poses, " << t << " ms instead of " << t_dense << " ms" << std::endl;
+      if (diff_cam > 1e-10 || diff_pose > 1e-10) {
+        std::cerr << "The calibration differs from the dense solution with " << nbViews[n] << " views" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
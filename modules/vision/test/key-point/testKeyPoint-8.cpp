@@ -0,0 +1,150 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the parallel affine detection of vpKeyPoint.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testKeyPoint-8.cpp
+
+  \brief Detect and extract the keypoints of the simulated affine views of a
+  synthetic image with vpKeyPoint::detectExtractAffine(), with the views
+  processed in parallel and sequentially, and check that the keypoints and
+  their descriptors are identical and in the same order.
+*/
+
+#include <iostream>
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020301)
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/vision/vpKeyPoint.h>
+
+#include <cstring>
+#include <vector>
+#include <stdlib.h>
+
+namespace {
+// Textured image made of random rectangles
+void buildImage(vpImage<unsigned char> &I)
+{
+  I = 128;
+  srand(0);
+  for (unsigned int n = 0; n < 150; n++) {
+    unsigned int i0 = (unsigned int)rand() % I.getHeight(), j0 = (unsigned int)rand() % I.getWidth();
+    unsigned int h = 5 + (unsigned int)rand() % 40, w = 5 + (unsigned int)rand() % 40;
+    unsigned char value = (unsigned char)(rand() % 256);
+    for (unsigned int i = i0; i < i0 + h && i < I.getHeight(); i++)
+      for (unsigned int j = j0; j < j0 + w && j < I.getWidth(); j++)
+        I[i][j] = value;
+  }
+}
+
+bool sameKeyPoints(const std::vector<cv::KeyPoint> &a, const std::vector<cv::KeyPoint> &b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (size_t k = 0; k < a.size(); k++) {
+    if (a[k].pt.x != b[k].pt.x || a[k].pt.y != b[k].pt.y || a[k].size != b[k].size || a[k].angle != b[k].angle
+        || a[k].response != b[k].response || a[k].octave != b[k].octave || a[k].class_id != b[k].class_id)
+      return false;
+  }
+  return true;
+}
+
+bool sameDescriptors(const cv::Mat &a, const cv::Mat &b)
+{
+  if (a.rows != b.rows || a.cols != b.cols || a.type() != b.type())
+    return false;
+  for (int i = 0; i < a.rows; i++) {
+    if (memcmp(a.ptr(i), b.ptr(i), a.cols * a.elemSize()) != 0)
+      return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpImage<unsigned char> I(240, 320);
+    buildImage(I);
+    vpThreadPool::setNumThreads(4);
+
+    vpKeyPoint keyPoints("ORB", "ORB", "BruteForce-Hamming");
+    std::vector<std::vector<cv::KeyPoint> > listOfKeypoints[2];
+    std::vector<cv::Mat> listOfDescriptors[2];
+    for (unsigned int k = 0; k < 2; k++) {
+      keyPoints.setUseParallelAffineDetection(k == 0);
+      keyPoints.detectExtractAffine(I, listOfKeypoints[k], listOfDescriptors[k]);
+    }
+
+    if (listOfKeypoints[0].size() != listOfKeypoints[1].size()
+        || listOfDescriptors[0].size() != listOfDescriptors[1].size()) {
+      std::cerr << "The number of simulated views differs" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    size_t nbKeyPoints = 0;
+    for (size_t v = 0; v < listOfKeypoints[0].size(); v++) {
+      if (! sameKeyPoints(listOfKeypoints[0][v], listOfKeypoints[1][v])
+          || ! sameDescriptors(listOfDescriptors[0][v], listOfDescriptors[1][v])) {
+        std::cerr << "The keypoints of the simulated view " << v << " differ" << std::endl;
+        return EXIT_FAILURE;
+      }
+      nbKeyPoints += listOfKeypoints[0][v].size();
+    }
+
+    std::cout << nbKeyPoints << " keypoints in " << listOfKeypoints[0].size() << " simulated views" << std::endl;
+    if (nbKeyPoints == 0) {
+      std::cerr << "No keypoint detected" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+#else
+int main() {
+  std::cerr << "You need OpenCV library." << std::endl;
+
+  return 0;
+}
+
+#endif
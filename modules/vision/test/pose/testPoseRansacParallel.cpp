@@ -0,0 +1,184 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the sequential and the parallel RANSAC pose estimation.
+ *
+ *****************************************************************************/
+
+#include <visp3/vision/vpPose.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+/*!
+  \example testPoseRansacParallel.cpp
+
+  Compute the pose of a cloud of 2000 points with 40% of outliers using the
+  sequential and the parallel RANSAC methods, and check that the parallel one
+  gives the same result whatever the number of threads.
+*/
+
+namespace
+{
+  double random(double min, double max)
+  {
+    return min + (max - min) * (double)rand() / (double)RAND_MAX;
+  }
+
+  bool samePoses(const vpHomogeneousMatrix &M1, const vpHomogeneousMatrix &M2)
+  {
+    for (unsigned int i = 0; i < 4; i++)
+      for (unsigned int j = 0; j < 4; j++)
+        if (std::fabs(M1[i][j] - M2[i][j]) > 0.)
+          return false;
+    return true;
+  }
+
+  bool computeRansac(const std::vector<vpPoint> &points, bool parallel, vpHomogeneousMatrix &cMo,
+                     std::vector<unsigned int> &inliers, double &t)
+  {
+    vpPose pose;
+    for (size_t i = 0; i < points.size(); i++)
+      pose.addPoint(points[i]);
+
+    pose.setRansacNbInliersToReachConsensus((unsigned int)(0.55 * points.size()));
+    pose.setRansacThreshold(0.001);
+    pose.setRansacMaxTrials(1000);
+    pose.setUseParallelRansac(parallel);
+
+    t = vpTime::measureTimeMs();
+    bool found = pose.computePose(vpPose::RANSAC, cMo);
+    t = vpTime::measureTimeMs() - t;
+    inliers = pose.getRansacInlierIndex();
+    return found;
+  }
+}
+
+int main()
+{
+  try {
+    if (vpPose::computeRansacIterations(0.99, 0.5, 4, 1000) != 72 ||
+        vpPose::computeRansacIterations(0.99, 0.0, 4, 1000) != 1 ||
+        vpPose::computeRansacIterations(0.99, 1.0, 4, 1000) != 1000) {
+      std::cerr << "Bad number of RANSAC iterations" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    srand(0);
+    vpHomogeneousMatrix cMo_truth(0.05, -0.02, 1.0, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(30));
+
+    const unsigned int nbPoints = 2000;
+    std::vector<vpPoint> points, points_truth;
+    std::vector<bool> outliers(nbPoints, false);
+    for (unsigned int i = 0; i < nbPoints; i++) {
+      vpPoint pt(random(-0.2, 0.2), random(-0.2, 0.2), random(-0.1, 0.1));
+      pt.project(cMo_truth);
+      points_truth.push_back(pt);
+
+      if (i % 5 < 2) {
+        // 40% of outliers
+        pt.set_x(pt.get_x() + random(-0.05, 0.05));
+        pt.set_y(pt.get_y() + random(-0.05, 0.05));
+        outliers[i] = true;
+      }
+      else {
+        pt.set_x(pt.get_x() + random(-0.0002, 0.0002));
+        pt.set_y(pt.get_y() + random(-0.0002, 0.0002));
+      }
+      points.push_back(pt);
+    }
+
+    vpPose pose_truth;
+    for (size_t i = 0; i < points_truth.size(); i++)
+      pose_truth.addPoint(points_truth[i]);
+
+    vpHomogeneousMatrix cMo_sequential;
+    std::vector<unsigned int> inliers_sequential;
+    double t_sequential;
+    if (! computeRansac(points, false, cMo_sequential, inliers_sequential, t_sequential)) {
+      std::cerr << "The sequential RANSAC failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "Sequential RANSAC: " << inliers_sequential.size() << " inliers in " << t_sequential
+              << " ms, residual " << pose_truth.computeResidual(cMo_sequential) << std::endl;
+
+    unsigned int nbThreads = vpThreadPool::getNumThreads();
+    unsigned int threads[3] = {1, 2, 4};
+    vpHomogeneousMatrix cMo_reference;
+    std::vector<unsigned int> inliers_reference;
+    for (unsigned int n = 0; n < 3; n++) {
+      vpThreadPool::setNumThreads(threads[n]);
+
+      vpHomogeneousMatrix cMo;
+      std::vector<unsigned int> inliers;
+      double t;
+      if (! computeRansac(points, true, cMo, inliers, t)) {
+        std::cerr << "The parallel RANSAC failed with " << threads[n] << " threads" << std::endl;
+        return EXIT_FAILURE;
+      }
+      double residual = pose_truth.computeResidual(cMo);
+      std::cout << "Parallel RANSAC with " << threads[n] << " threads: " << inliers.size() << " inliers in "
+                << t << " ms, residual " << residual << std::endl;
+
+      unsigned int nbFalseInliers = 0;
+      for (size_t i = 0; i < inliers.size(); i++)
+        if (outliers[inliers[i]])
+          nbFalseInliers++;
+      if (residual > 0.001 || nbFalseInliers > 0) {
+        std::cerr << "The pose is bad estimated" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      if (n == 0) {
+        cMo_reference = cMo;
+        inliers_reference = inliers;
+      }
+      else if (inliers != inliers_reference || ! samePoses(cMo, cMo_reference)) {
+        std::cerr << "The result depends on the number of threads" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    vpThreadPool::setNumThreads(nbThreads);
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
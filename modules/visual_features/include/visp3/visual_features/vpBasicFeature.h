@@ -138,6 +138,8 @@ public:
   unsigned int getDimension(const unsigned int select=FEATURE_ALL) const;
   //! Compute the interaction matrix from a subset of the possible features.
   virtual vpMatrix interaction(const unsigned int select = FEATURE_ALL) = 0;
+  // Write the interaction matrix in the rows of an existing matrix.
+  virtual unsigned int fillInteraction(const unsigned int select, vpMatrix &L, const unsigned int row);
   //! Return element \e i in the state vector  (usage : x = s[i] )
   virtual inline double operator[](const unsigned int i) const {  return s[i]; }
   vpBasicFeature &operator=(const vpBasicFeature &f) ;
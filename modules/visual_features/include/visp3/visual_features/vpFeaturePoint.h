@@ -210,6 +210,8 @@ public:
   //! Compute the error between a visual features and zero
   vpColVector error(const unsigned int select = FEATURE_ALL)  ;
 
+  unsigned int fillInteraction(const unsigned int select, vpMatrix &L, const unsigned int row);
+
   double get_x()  const ;
 
   double get_y()   const ;
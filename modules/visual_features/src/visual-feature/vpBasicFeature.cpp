@@ -39,6 +39,9 @@
 
 
 #include <visp3/visual_features/vpBasicFeature.h>
+#include <visp3/visual_features/vpFeatureException.h>
+
+#include <string.h>
 
 const unsigned int vpBasicFeature::FEATURE_LINE [32] =
     {
@@ -125,6 +128,49 @@ vpBasicFeature::getDimension(unsigned int select) const
     return dim ;
 }
 
+/*!
+  Write the interaction matrix related to a subset of the possible features
+  in the rows of \e L, starting at row \e row.
+
+  This allows to stack the interaction matrices of several features without
+  building an intermediate matrix for each of them, as done in
+  vpServo::computeInteractionMatrix(). \e L is only resized (keeping its
+  content) if it has not enough rows; its remaining rows are left unchanged.
+
+  The default implementation copies the matrix returned by interaction().
+  Features that are used in high rate control loops, like vpFeaturePoint,
+  redefine this function to write their rows directly in \e L.
+
+  \param select : Selection of a subset of the possible features.
+  \param L : Matrix that contains the stacked interaction matrices.
+  \param row : Index of the first row of \e L to update.
+
+  \return The number of rows written in \e L.
+
+  \exception vpFeatureException::sizeMismatchError : If \e L is not empty
+  and has not the same number of columns than the interaction matrix.
+*/
+unsigned int
+vpBasicFeature::fillInteraction(const unsigned int select, vpMatrix &L, const unsigned int row)
+{
+  vpMatrix Ls = interaction(select);
+  unsigned int nrows = Ls.getRows();
+  unsigned int ncols = Ls.getCols();
+
+  if (L.getRows() != 0 && L.getCols() != ncols) {
+    throw(vpFeatureException(vpFeatureException::sizeMismatchError,
+                             "Cannot stack a %d columns interaction matrix in a %d columns matrix",
+                             ncols, L.getCols()));
+  }
+  if (row + nrows > L.getRows() || L.getCols() != ncols)
+    L.resize(row + nrows, ncols, false);
+
+  for (unsigned int i = 0; i < nrows; i++)
+    memcpy(L[row + i], Ls[i], ncols*sizeof(double));
+
+  return nrows;
+}
+
 //! Get the feature vector  \f$\bf s\f$.
 vpColVector
 vpBasicFeature::get_s(const unsigned int select) const
@@ -245,6 +245,38 @@ vpFeaturePoint::interaction(const unsigned int select)
 
   L.resize(0,6) ;
 
+  fillInteraction(select, L, 0) ;
+
+  return L ;
+}
+
+/*!
+
+  Write the interaction matrix \f$ L \f$ related to a subset of the point
+  features \f$ x \f$ and \f$ y \f$ in the rows of an existing matrix,
+  without intermediate allocation. This function is used by vpServo to
+  stack the interaction matrices of the features of a task.
+
+  \param select : Selection of a subset of the possible point features
+  (see interaction()).
+  \param L : Matrix with 6 columns in which the interaction matrix is
+  written. Its number of rows is increased if needed.
+  \param row : Index of the row of \e L where the first row of the
+  interaction matrix is written.
+
+  \return The number of rows written in \e L, 0, 1 or 2.
+
+  \sa interaction()
+*/
+unsigned int
+vpFeaturePoint::fillInteraction(const unsigned int select, vpMatrix &L, const unsigned int row)
+{
+  if (L.getRows() != 0 && L.getCols() != 6) {
+    throw(vpFeatureException(vpFeatureException::sizeMismatchError,
+                             "Cannot stack a point feature interaction matrix in a %d columns matrix",
+                             L.getCols()));
+  }
+
   if (deallocate == vpBasicFeature::user)
   {
     for (unsigned int i = 0; i < nbParameters; i++)
@@ -291,34 +323,37 @@ vpFeaturePoint::interaction(const unsigned int select)
 			     "Point Z coordinates is null")) ;
   }
 
-  if (vpFeaturePoint::selectX() & select )
-  {
-    vpMatrix Lx(1,6) ; Lx = 0;
+  unsigned int nrows = 0;
+  if (vpFeaturePoint::selectX() & select) nrows++;
+  if (vpFeaturePoint::selectY() & select) nrows++;
 
-    Lx[0][0] = -1/Z_  ;
-    Lx[0][1] = 0 ;
-    Lx[0][2] = x_/Z_ ;
-    Lx[0][3] = x_*y_ ;
-    Lx[0][4] = -(1+x_*x_) ;
-    Lx[0][5] = y_ ;
+  if (row + nrows > L.getRows() || L.getCols() != 6)
+    L.resize(row + nrows, 6, false);
+  if (nrows == 0)
+    return 0;
 
-    L = vpMatrix::stack(L,Lx) ;
+  double *Lr = L[row];
+  if (vpFeaturePoint::selectX() & select )
+  {
+    Lr[0] = -1/Z_  ;
+    Lr[1] = 0 ;
+    Lr[2] = x_/Z_ ;
+    Lr[3] = x_*y_ ;
+    Lr[4] = -(1+x_*x_) ;
+    Lr[5] = y_ ;
+    Lr += 6;
   }
 
   if (vpFeaturePoint::selectY() & select )
   {
-    vpMatrix Ly(1,6) ; Ly = 0;
-
-    Ly[0][0] = 0 ;
-    Ly[0][1]  = -1/Z_ ;
-    Ly[0][2] = y_/Z_ ;
-    Ly[0][3] = 1+y_*y_ ;
-    Ly[0][4] = -x_*y_ ;
-    Ly[0][5] = -x_ ;
-
-    L = vpMatrix::stack(L,Ly) ;
+    Lr[0] = 0 ;
+    Lr[1]  = -1/Z_ ;
+    Lr[2] = y_/Z_ ;
+    Lr[3] = 1+y_*y_ ;
+    Lr[4] = -x_*y_ ;
+    Lr[5] = -x_ ;
   }
-  return L ;
+  return nrows ;
 }
 
 
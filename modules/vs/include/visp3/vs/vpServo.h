@@ -426,6 +426,28 @@ public:
     A recommended value is 4.
   */
   void setMu(double mu_){this->mu=mu_;}
+  /*!
+    Enable or disable the warm started computation of the pseudo inverse of the task Jacobian.
+
+    By default the pseudo inverse \f${\bf J}_1^+\f$ used in computeControlLaw() is obtained from a
+    singular value decomposition at each iteration. When the task Jacobian is full rank and only
+    changes slowly from one iteration to the next, which is the case in high rate servo loops,
+    \f$({\bf J}_1^\top {\bf J}_1)^{-1}\f$ can rather be refined from the value given by the
+    previous pseudo inverse with a few Newton-Schulz iterations, and
+    \f${\bf J}_1^+ = ({\bf J}_1^\top {\bf J}_1)^{-1} {\bf J}_1^\top\f$.
+
+    The decomposition is still used at the first iteration, when the task dimension changes,
+    when the Jacobian is not full rank, when the previous pseudo inverse is too far from the new
+    one for the iterations to converge quickly, or when the Jacobian becomes badly conditioned.
+    Since the singular values are only computed by the decomposition, the content of the singular
+    value vector is not updated by the warm started iterations.
+
+    This option is only used when the pseudo inverse is selected with setInteractionMatrixType().
+
+    \param warmStart : true to enable the warm started computation, false to always use the
+    singular value decomposition (default).
+  */
+  void setPseudoInverseWarmStart(const bool warmStart) { this->pseudoInverseWarmStart = warmStart; }
   //  Choice of the visual servoing control law
   void setServo(const vpServoType &servo_type) ;
 
@@ -481,6 +503,8 @@ public:
    */
   void computeProjectionOperators();
 
+  bool updatePseudoInverse();
+
   public:
   //! Interaction matrix
   vpMatrix L ;
@@ -576,6 +600,12 @@ public:
   bool taskWasKilled;
   //! Force the interaction matrix computation even if it is already done.
   bool forceInteractionMatrixComputation;
+  //! Refine the previous pseudo inverse of the task Jacobian rather than computing a new decomposition.
+  bool pseudoInverseWarmStart;
+  //! Interaction matrix computed from the desired features when the mean interaction matrix is used.
+  vpMatrix Lstar;
+  //! Work matrices used to refine the pseudo inverse of the task Jacobian.
+  vpMatrix J1tJ1, J1tJ1inv, J1tJ1err, J1tJ1tmp, J1ptmp;
 
   //! Projection operators \f$\bf WpW\f$.
   vpMatrix WpW ;
@@ -71,7 +71,8 @@ vpServo::vpServo()
     interactionMatrixType(DESIRED), inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false),
     cVf(), init_cVf(false), fVe(), init_fVe(false), eJe(), init_eJe(false), fJe(), init_fJe(false),
     errorComputed(false), interactionMatrixComputed(false), dim_task(0), taskWasKilled(false),
-    forceInteractionMatrixComputation(false), WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(),
+    forceInteractionMatrixComputation(false), pseudoInverseWarmStart(false), Lstar(),
+    J1tJ1(), J1tJ1inv(), J1tJ1err(), J1tJ1tmp(), J1ptmp(), WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(),
     iscJcIdentity(true), cJc(6,6)
 {
   cJc.eye();
@@ -96,7 +97,8 @@ vpServo::vpServo(vpServoType servo_type)
     interactionMatrixType(DESIRED), inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false),
     cVf(), init_cVf(false), fVe(), init_fVe(false), eJe(), init_eJe(false), fJe(), init_fJe(false),
     errorComputed(false), interactionMatrixComputed(false), dim_task(0), taskWasKilled(false),
-    forceInteractionMatrixComputation(false), WpW(), I_WpW(), P(), sv(), mu(4), e1_initial(),
+    forceInteractionMatrixComputation(false), pseudoInverseWarmStart(false), Lstar(),
+    J1tJ1(), J1tJ1inv(), J1tJ1err(), J1tJ1tmp(), J1ptmp(), WpW(), I_WpW(), P(), sv(), mu(4), e1_initial(),
     iscJcIdentity(true), cJc(6,6)
 {
   cJc.eye();
@@ -168,6 +170,7 @@ void vpServo::init()
   taskWasKilled = false;
 
   forceInteractionMatrixComputation = false;
+  pseudoInverseWarmStart = false;
 
   rankJ1 = 0;
 }
@@ -600,32 +603,13 @@ static void computeInteractionMatrixFromList  (const std::list<vpBasicFeature *>
                            "feature list empty, cannot compute Ls")) ;
   }
 
-  /* The matrix dimension is not known before the affectation loop.
-   * It thus should be allocated on the flight, in the loop.
-   * The first assumption is that the size has not changed. A double
-   * reallocation (realloc(dim*2)) is done if necessary. In particular,
-   * [log_2(dim)+1] reallocations are done for the first matrix computation.
-   * If the allocated size is too large, a correction is done after the loop.
-   * The algorithmic cost is linear in affectation, logarithmic in allocation
-   * numbers and linear in allocation size.
+  /* Each feature writes its rows directly in L with
+   * vpBasicFeature::fillInteraction(), L being only enlarged when a
+   * feature does not fit in. Since L keeps its size from one iteration
+   * to the next, no memory is allocated as long as the task dimension
+   * does not change. If the task became smaller, L is shrunk after the
+   * loop.
    */
-
-  /* First assumption: matrix dimensions have not changed. If 0, they are
-   * initialized to dim 1.*/
-  unsigned int rowL = L.getRows();
-  const unsigned int colL = 6;
-  if (0 == rowL) {
-    rowL = 1;
-    L .resize(rowL, colL);
-  }
-
-  /* vectTmp is used to store the return values of functions get_s() and
-   * error(). */
-  vpMatrix matrixTmp;
-
-  /* The cursor are the number of the next case of the vector array to
-   * be affected. A memory reallocation should be done when cursor
-   * is out of the vector-array range.*/
   unsigned int cursorL = 0;
 
   std::list<vpBasicFeature *>::const_iterator it;
@@ -633,27 +617,11 @@ static void computeInteractionMatrixFromList  (const std::list<vpBasicFeature *>
 
   for (it = featureList.begin(), it_select = featureSelectionList.begin(); it != featureList.end(); ++it, ++it_select)
   {
-    /* Get s. */
-    matrixTmp = (*it)->interaction( *it_select );
-    unsigned int rowMatrixTmp = matrixTmp .getRows();
-    unsigned int colMatrixTmp = matrixTmp .getCols();
-
-    /* Check the matrix L size, and realloc if needed. */
-    while (rowMatrixTmp + cursorL > rowL) {
-      rowL *= 2;
-      L.resize (rowL,colL,false);
-      vpDEBUG_TRACE(15,"Realloc!");
-    }
-
-    /* Copy the temporarily matrix into L. */
-    for (unsigned int k = 0; k < rowMatrixTmp; ++k, ++cursorL) {
-      for (unsigned int j = 0; j <  colMatrixTmp; ++j) {
-        L[cursorL][j] = matrixTmp[k][j];
-      }
-    }
+    cursorL += (*it)->fillInteraction(*it_select, L, cursorL);
   }
 
-  L.resize (cursorL,colL,false);
+  if ((cursorL != L.getRows()) || (L.getCols() != 6))
+    L.resize (cursorL,6,false);
 
   return ;
 }
@@ -710,7 +678,6 @@ vpMatrix vpServo::computeInteractionMatrix()
       break ;
     case MEAN:
     {
-      vpMatrix Lstar (L.getRows(), L.getCols());
       try
       {
         computeInteractionMatrixFromList(this ->featureList,
@@ -722,7 +689,8 @@ vpMatrix vpServo::computeInteractionMatrix()
       {
         throw ;
       }
-      L = (L+Lstar)/2;
+      L += Lstar;
+      L *= 0.5;
 
       dim_task = L.getRows() ;
       interactionMatrixComputed = true ;
@@ -1025,9 +993,11 @@ vpColVector vpServo::computeControlLaw()
 
     if (inversionType==PSEUDO_INVERSE)
     {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t) ;
+      if (! (pseudoInverseWarmStart && updatePseudoInverse())) {
+        rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t) ;
 
-      imageComputed = true ;
+        imageComputed = true ;
+      }
     }
     else
       J1p = J1.t() ;
@@ -1181,9 +1151,11 @@ vpColVector vpServo::computeControlLaw(double t)
 
     if (inversionType==PSEUDO_INVERSE)
     {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t) ;
+      if (! (pseudoInverseWarmStart && updatePseudoInverse())) {
+        rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t) ;
 
-      imageComputed = true ;
+        imageComputed = true ;
+      }
     }
     else
       J1p = J1.t() ;
@@ -1344,9 +1316,11 @@ vpColVector vpServo::computeControlLaw(double t, const vpColVector &e_dot_init)
 
     if (inversionType==PSEUDO_INVERSE)
     {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t) ;
+      if (! (pseudoInverseWarmStart && updatePseudoInverse())) {
+        rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t) ;
 
-      imageComputed = true ;
+        imageComputed = true ;
+      }
     }
     else
       J1p = J1.t() ;
@@ -1432,21 +1406,108 @@ void vpServo::computeProjectionOperators()
   else
     sig = 0.0;
 
-  vpMatrix J1t = J1.transpose();
-
-  double pp = (error.t() * (J1 * J1t) * error);
+  // With a = J1^T e, e^T J1 J1^T e = a^T a and J1^T e e^T J1 = a a^T. This avoids
+  // to build (dim_task x dim_task) matrices.
+  vpColVector J1te(n);
+  for (unsigned int i = 0; i < J1.getRows(); i++) {
+    const double *J1i = J1[i];
+    for (unsigned int j = 0; j < n; j++)
+      J1te[j] += J1i[j] * error[i];
+  }
 
-  vpMatrix  ee_t(n,n);
-  ee_t =  error * error.t();
+  double pp = J1te.sumSquare();
 
   vpMatrix P_norm_e(n,n);
-  P_norm_e = I - (1.0 / pp ) * J1t * ee_t * J1;
+  for (unsigned int i = 0; i < n; i++)
+    for (unsigned int j = 0; j < n; j++)
+      P_norm_e[i][j] = I[i][j] - (1.0 / pp) * J1te[i] * J1te[j];
 
   P = sig * P_norm_e + (1 - sig) * I_WpW;
 
   return;
 }
 
+/* Newton-Schulz iterations X <- (I + E) X with E = I - X A, that converge
+ * quadratically (E is squared at each iteration) to a left inverse of A
+ * when X is close enough to it. Return true when the Frobenius norm of E
+ * falls under the tolerance, false if the iterations do not converge fast
+ * enough.
+ */
+static bool refineLeftInverse(vpMatrix &X, const vpMatrix &A, const double tolerance,
+                              vpMatrix &E, vpMatrix &tmp)
+{
+  const unsigned int nbMaxIterations = 6;
+  double maxResidual = 0.5;
+  for (unsigned int k = 0; k < nbMaxIterations; k++) {
+    vpMatrix::mult2Matrices(X, A, E);
+    E *= -1.;
+    for (unsigned int i = 0; i < E.getRows(); i++)
+      E[i][i] += 1.;
+
+    double residual = sqrt(E.sumSquare());
+    if (residual < tolerance)
+      return true;
+    if (residual > maxResidual)
+      return false;
+
+    vpMatrix::mult2Matrices(E, X, tmp);
+    X += tmp;
+    maxResidual = residual;
+  }
+  return false;
+}
+
+/*!
+  Update the pseudo inverse \f${\bf J}_1^+\f$ of the task Jacobian from its value at the previous
+  iteration (see setPseudoInverseWarmStart()).
+
+  The previous pseudo inverse is first refined with Newton-Schulz iterations into a left inverse
+  \f$\bf X\f$ of the new Jacobian. \f${\bf X}{\bf X}^\top\f$ is then close to
+  \f${\bf M} = ({\bf J}_1^\top {\bf J}_1)^{-1}\f$ and is refined the same way, which leads to
+  \f${\bf J}_1^+ = {\bf M} {\bf J}_1^\top\f$ since \f${\bf J}_1\f$ is full column rank.
+
+  \return true if J1p was updated, false if the singular value decomposition has to be used
+  because the previous pseudo inverse is not usable, the iterations did not converge, or
+  \f${\bf J}_1\f$ is badly conditioned.
+*/
+bool vpServo::updatePseudoInverse()
+{
+  unsigned int m = J1.getRows();
+  unsigned int n = J1.getCols();
+
+  if ((m < n) || (rankJ1 != n) || (J1p.getRows() != n) || (J1p.getCols() != m))
+    return false;
+
+  if (! refineLeftInverse(J1p, J1, 1e-8, J1tJ1err, J1ptmp))
+    return false;
+
+  J1p.AAt(J1tJ1inv);
+  J1.AtA(J1tJ1);
+  if (! refineLeftInverse(J1tJ1inv, J1tJ1, 1e-10, J1tJ1err, J1tJ1tmp))
+    return false;
+
+  // Same rank test as the decomposition that considers singular values lower than
+  // 1e-6 times the largest one as null: cond(J1^T J1) is bounded by the product of
+  // the Frobenius norms.
+  if (sqrt(J1tJ1.sumSquare() * J1tJ1inv.sumSquare()) > 1e12)
+    return false;
+
+  // J1p = M J1^T
+  for (unsigned int i = 0; i < n; i++) {
+    const double *Mi = J1tJ1inv[i];
+    double *J1pi = J1p[i];
+    for (unsigned int j = 0; j < m; j++) {
+      const double *J1j = J1[j];
+      double sum = 0.;
+      for (unsigned int k = 0; k < n; k++)
+        sum += Mi[k] * J1j[k];
+      J1pi[j] = sum;
+    }
+  }
+
+  return true;
+}
+
 /*!
   Compute and return the secondary task vector according to the classic projection operator \f${\bf I-W^+W}\f$ (see equation(7) in the paper \cite Marchand05b)
   or the new large projection operator (see equation(24) in the paper \cite Marey:2010).
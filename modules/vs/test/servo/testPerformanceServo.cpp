@@ -0,0 +1,284 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the visual servoing control law computation.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceServo.cpp
+
+  \brief Measure the latency of vpServo::computeControlLaw() for an image-based
+  visual servoing task built from 4 up to 256 points, with the pseudo inverse of
+  the task Jacobian computed by a singular value decomposition at each
+  iteration or warm started from the previous iteration (see
+  vpServo::setPseudoInverseWarmStart()). Check also that the interaction matrix
+  assembled by vpServo is the stack of the interaction matrices of the features
+  and that both pseudo inverse computations lead to the same velocities.
+*/
+
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/io/vpParseArgv.h>
+#include <visp3/visual_features/vpFeatureBuilder.h>
+#include <visp3/visual_features/vpFeaturePoint.h>
+#include <visp3/vs/vpServo.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdi:h"
+
+void usage(const char *name, const char *badparam, unsigned int nb_iterations);
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations);
+
+/*!
+
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param nb_iterations : Number of iterations.
+
+ */
+void usage(const char *name, const char *badparam, unsigned int nb_iterations)
+{
+  fprintf(stdout, "\n\
+Benchmark the computation of the visual servoing control law.\n\
+\n\
+SYNOPSIS\n\
+  %s [-i <number of iterations>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <number of iterations>                            %u\n\
+     Number of iterations of the servo loop simulated\n\
+     for each task size.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nb_iterations);
+
+  if (badparam) {
+    fprintf(stderr, "ERROR: \n" );
+    fprintf(stderr, "\nBad parameter [%s]\n", badparam);
+  }
+}
+
+/*!
+
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param nb_iterations : Number of iterations.
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nb_iterations)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i': nb_iterations = (unsigned int)atoi(optarg_); break;
+    case 'h': usage(argv[0], NULL, nb_iterations); return false; break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, nb_iterations); return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nb_iterations);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Interaction matrix stacked from the matrices returned by vpBasicFeature::interaction()
+vpMatrix stackInteractionMatrices(std::vector<vpFeaturePoint> &s, unsigned int select_last)
+{
+  vpMatrix L;
+  for (size_t i = 0; i < s.size(); i++)
+    L = vpMatrix::stack(L, s[i].interaction(i + 1 == s.size() ? select_last : (unsigned int)vpBasicFeature::FEATURE_ALL));
+  return L;
+}
+
+// Large projection operator as computed from its definition
+vpMatrix largeProjectionOperator(const vpMatrix &J1, const vpColVector &e, const vpMatrix &I_WpW)
+{
+  unsigned int n = J1.getCols();
+  vpMatrix I;
+  I.eye(n);
+  vpMatrix J1t = J1.t();
+  double pp = e.t() * (J1 * J1t) * e;
+  vpMatrix P_norm_e = I - (1.0 / pp) * J1t * (e * e.t()) * J1;
+
+  double norm_e = e.euclideanNorm();
+  double sig = 0.;
+  if (norm_e > 0.7)
+    sig = 1.;
+  else if (norm_e >= 0.1)
+    sig = 1.0 / (1.0 + exp(-12.0 * ((norm_e - 0.1) / 0.6) + 6.0));
+  return sig * P_norm_e + (1 - sig) * I_WpW;
+}
+
+double maxError(const vpMatrix &A, const vpMatrix &B)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols())
+    return 1e10;
+  double err = 0.;
+  for (unsigned int i = 0; i < A.getRows(); i++)
+    for (unsigned int j = 0; j < A.getCols(); j++)
+      err = std::max(err, std::fabs(A[i][j] - B[i][j]));
+  return err;
+}
+
+int main(int argc, const char ** argv)
+{
+  try {
+    unsigned int nb_iterations = 1000;
+
+    // Read the command line options
+    if (getOptions(argc, argv, nb_iterations) == false) {
+      exit (-1);
+    }
+
+    const double dt = 0.001; // 1 kHz servo loop
+    vpHomogeneousMatrix cdMo(0, 0, 0.75, 0, 0, 0);
+
+    unsigned int nb_points[4] = {4, 16, 64, 256};
+    for (unsigned int n = 0; n < 4; n++) {
+      // Points on a grid in the plane Z=0 of the object frame
+      unsigned int side = (unsigned int)sqrt((double)nb_points[n]);
+      std::vector<vpPoint> P(nb_points[n]);
+      for (unsigned int i = 0; i < nb_points[n]; i++) {
+        P[i].setWorldCoordinates(-0.1 + 0.2 * (i % side) / (side - 1), -0.1 + 0.2 * (i / side) / (side - 1), 0);
+      }
+
+      vpHomogeneousMatrix cMo(0.05, -0.04, 0.9, vpMath::rad(5), vpMath::rad(-8), vpMath::rad(20));
+
+      std::vector<vpFeaturePoint> s(nb_points[n]), s_star(nb_points[n]);
+      for (unsigned int i = 0; i < nb_points[n]; i++) {
+        P[i].track(cdMo);
+        vpFeatureBuilder::create(s_star[i], P[i]);
+        P[i].track(cMo);
+        vpFeatureBuilder::create(s[i], P[i]);
+      }
+
+      // Same task, with the pseudo inverse computed by SVD or warm started.
+      // Only the x coordinate of the last point is used to test a task with an odd dimension.
+      vpServo task, task_warm;
+      vpServo *tasks[2] = { &task, &task_warm };
+      for (unsigned int t = 0; t < 2; t++) {
+        tasks[t]->setServo(vpServo::EYEINHAND_CAMERA);
+        tasks[t]->setInteractionMatrixType(vpServo::CURRENT);
+        tasks[t]->setLambda(0.5);
+        for (unsigned int i = 0; i + 1 < nb_points[n]; i++)
+          tasks[t]->addFeature(s[i], s_star[i]);
+        tasks[t]->addFeature(s[nb_points[n] - 1], s_star[nb_points[n] - 1], vpFeaturePoint::selectX());
+      }
+      task_warm.setPseudoInverseWarmStart(true);
+
+      double t_svd = 0., t_warm = 0., max_error = 0.;
+      for (unsigned int iter = 0; iter < nb_iterations; iter++) {
+        double t = vpTime::measureTimeMs();
+        vpColVector v = task.computeControlLaw();
+        t_svd += vpTime::measureTimeMs() - t;
+
+        t = vpTime::measureTimeMs();
+        vpColVector v_warm = task_warm.computeControlLaw();
+        t_warm += vpTime::measureTimeMs() - t;
+
+        if (iter == 0) {
+          vpMatrix L = stackInteractionMatrices(s, vpFeaturePoint::selectX());
+          if (maxError(L, task.L) > 0) {
+            std::cerr << "Bad interaction matrix for " << nb_points[n] << " points" << std::endl;
+            return EXIT_FAILURE;
+          }
+          vpMatrix P = largeProjectionOperator(task.getTaskJacobian(), task.error, task.getI_WpW());
+          if (maxError(P, task.getLargeP()) > 1e-10) {
+            std::cerr << "Bad large projection operator for " << nb_points[n] << " points" << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+
+        max_error = std::max(max_error, (v - v_warm).infinityNorm() / std::max(v.infinityNorm(), 1e-6));
+
+        // Move the camera and update the current features
+        cMo = vpExponentialMap::direct(v, dt).inverse() * cMo;
+        for (unsigned int i = 0; i < nb_points[n]; i++) {
+          P[i].track(cMo);
+          vpFeatureBuilder::create(s[i], P[i]);
+        }
+      }
+
+      std::cout << nb_points[n] << " points: control law with SVD " << 1000. * t_svd / nb_iterations
+                << " us, warm started " << 1000. * t_warm / nb_iterations << " us, speed-up "
+                << (t_warm > 0. ? t_svd / t_warm : 0.) << ", max relative velocity difference "
+                << max_error << std::endl;
+
+      if (max_error > 1e-8) {
+        std::cerr << "The warm started pseudo inverse leads to different velocities for "
+                  << nb_points[n] << " points" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      task.kill();
+      task_warm.kill();
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}